@@ -0,0 +1,237 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  FDAI ball benchmark: times the software ball renderer (src_sys/fdaiball.h)
+  with and without its frame cache, and compares the frames it draws.
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  Usage:	FDAIBallBench [options] FDAI_Ball.dds
+
+		--frames=N	Frames per run (default 600).
+		--att=x,y,z	Attitude in degrees for --out and --ref (default 0,0,0).
+		--out=F		Write the frame at --att to F, as a PPM.
+		--ref=F		Compare the frame at --att with the PPM F, for
+				instance a capture of the old OpenGL ball.
+
+		Each run reports the time per frame drawn, the time per frame
+		through the cache, and how far the frames are from the exact
+		ones (library atan2, attitude not quantized).
+
+  Build:	cl /O2 /EHsc FDAIBallBench.cpp, or g++ -O2 -o FDAIBallBench FDAIBallBench.cpp
+
+  **************************************************************************/
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1300 ) // Microsoft Visual Studio Version 2003 and higher
+#define _CRT_SECURE_NO_DEPRECATE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "../../src_sys/fdaiball.h"
+
+#define RAD (3.14159265358979323846 / 180.0)
+
+struct Diff
+{
+	Diff() : total(0), max(0), pixels(0), count(0) {}
+
+	void Add(const unsigned int *a, const unsigned int *b)
+	{
+		for (int i = 0; i < FDAIBALL_SIZE * FDAIBALL_SIZE; i++)
+		{
+			int worst = 0;
+			for (int shift = 0; shift < 24; shift += 8)
+			{
+				int d = abs((int)((a[i] >> shift) & 255) - (int)((b[i] >> shift) & 255));
+				total += d;
+				if (d > worst) worst = d;
+			}
+			if (worst > max) max = worst;
+			if (worst > 16) pixels++;
+		}
+		count++;
+	}
+
+	void Print(const char *what)
+	{
+		printf("  %-22s mean %5.2f  max %3d  %6.3f%% of pixels off by more than 16\n", what,
+			count ? total / (3.0 * FDAIBALL_SIZE * FDAIBALL_SIZE * count) : 0.0, max,
+			count ? 100.0 * pixels / ((double)FDAIBALL_SIZE * FDAIBALL_SIZE * count) : 0.0);
+	}
+
+	double total;
+	int max;
+	long pixels, count;
+};
+
+static double Now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//
+// One run: the ball follows an attitude profile, given as a start and a rate per frame in degrees.
+//
+
+static void Run(FDAIBall &ball, const char *name, int frames, double x0, double y0, double z0, double dx, double dy, double dz)
+{
+	std::vector<unsigned int> frame(FDAIBALL_SIZE * FDAIBALL_SIZE), exact(FDAIBALL_SIZE * FDAIBALL_SIZE);
+	Diff cached, fast;
+	double t, drawn, through;
+	int i;
+
+	t = Now();
+	for (i = 0; i < frames; i++)
+		ball.Render((x0 + dx * i) * RAD, (y0 + dy * i) * RAD, (z0 + dz * i) * RAD, &frame[0]);
+	drawn = (Now() - t) / frames;
+
+	ball.Flush();
+	ball.hits = ball.misses = 0;
+	t = Now();
+	for (i = 0; i < frames; i++)
+		ball.Frame((x0 + dx * i) * RAD, (y0 + dy * i) * RAD, (z0 + dz * i) * RAD);
+	through = (Now() - t) / frames;
+
+	printf("%s: drawn %.3f ms, cached %.3f ms per frame, %lu of %d from the cache\n", name, drawn * 1000.0, through * 1000.0, ball.hits, frames);
+
+	// Every 10th frame against the exact one
+	for (i = 0; i < frames; i += 10)
+	{
+		double x = (x0 + dx * i) * RAD, y = (y0 + dy * i) * RAD, z = (z0 + dz * i) * RAD;
+		ball.Render(x, y, z, &exact[0], true);
+		ball.Render(x, y, z, &frame[0]);
+		fast.Add(&frame[0], &exact[0]);
+		cached.Add(ball.Frame(x, y, z), &exact[0]);
+	}
+	fast.Print("fast atan2:");
+	cached.Print("fast atan2 and cache:");
+}
+
+static bool WritePPM(const char *filename, const unsigned int *frame)
+{
+	FILE *f = fopen(filename, "wb");
+	if (!f)
+		return false;
+	fprintf(f, "P6\n%d %d\n255\n", FDAIBALL_SIZE, FDAIBALL_SIZE);
+	for (int i = 0; i < FDAIBALL_SIZE * FDAIBALL_SIZE; i++)
+	{
+		unsigned char rgb[3] = { (unsigned char)(frame[i] >> 16), (unsigned char)(frame[i] >> 8), (unsigned char)frame[i] };
+		fwrite(rgb, 1, 3, f);
+	}
+	fclose(f);
+	return true;
+}
+
+static bool ReadPPM(const char *filename, std::vector<unsigned int> &frame)
+{
+	FILE *f = fopen(filename, "rb");
+	int w, h, maxval;
+	if (!f)
+		return false;
+	if (fscanf(f, "P6 %d %d %d", &w, &h, &maxval) != 3 || w != FDAIBALL_SIZE || h != FDAIBALL_SIZE || maxval != 255)
+	{
+		fclose(f);
+		return false;
+	}
+	fgetc(f);
+	frame.resize(w * h);
+	for (int i = 0; i < w * h; i++)
+	{
+		unsigned char rgb[3];
+		if (fread(rgb, 1, 3, f) != 3)
+		{
+			fclose(f);
+			return false;
+		}
+		frame[i] = (rgb[0] << 16) | (rgb[1] << 8) | rgb[2];
+	}
+	fclose(f);
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	int frames = 600;
+	double ax = 0, ay = 0, az = 0;
+	const char *texture = NULL, *out = NULL, *ref = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (sscanf(argv[i], "--frames=%d", &frames) == 1)
+			;
+		else if (sscanf(argv[i], "--att=%lf,%lf,%lf", &ax, &ay, &az) == 3)
+			;
+		else if (!strncmp(argv[i], "--out=", 6))
+			out = argv[i] + 6;
+		else if (!strncmp(argv[i], "--ref=", 6))
+			ref = argv[i] + 6;
+		else if (argv[i][0] == '-')
+		{
+			fprintf(stderr, "Unknown option %s\n", argv[i]);
+			return 1;
+		}
+		else
+			texture = argv[i];
+	}
+	if (!texture || frames < 10)
+	{
+		fprintf(stderr, "Usage: FDAIBallBench [--frames=N] [--att=x,y,z] [--out=F.ppm] [--ref=F.ppm] FDAI_Ball.dds\n");
+		return 1;
+	}
+
+	FDAIBall ball;
+	if (!ball.LoadTexture(texture))
+	{
+		fprintf(stderr, "Cannot load %s\n", texture);
+		return 1;
+	}
+
+	Run(ball, "Stationary", frames, 10.0, 20.0, 30.0, 0.0, 0.0, 0.0);
+	Run(ball, "Slow roll, 0.05 deg/frame", frames, 10.0, 20.0, 30.0, 0.0, 0.05, 0.0);
+	Run(ball, "Slewing, 1 deg/frame", frames, 10.0, 20.0, 30.0, 1.0, 0.5, 1.0);
+
+	std::vector<unsigned int> frame(FDAIBALL_SIZE * FDAIBALL_SIZE);
+	ball.Render(ax * RAD, ay * RAD, az * RAD, &frame[0], true);
+	if (out)
+	{
+		if (!WritePPM(out, &frame[0]))
+		{
+			fprintf(stderr, "Cannot write %s\n", out);
+			return 1;
+		}
+		printf("Frame at %g, %g, %g written to %s\n", ax, ay, az, out);
+	}
+	if (ref)
+	{
+		std::vector<unsigned int> reference;
+		if (!ReadPPM(ref, reference))
+		{
+			fprintf(stderr, "Cannot read %s, or it is not a %dx%d PPM\n", ref, FDAIBALL_SIZE, FDAIBALL_SIZE);
+			return 1;
+		}
+		Diff diff;
+		diff.Add(&frame[0], &reference[0]);
+		printf("Against %s:\n", ref);
+		diff.Print("exact frame:");
+	}
+	return 0;
+}
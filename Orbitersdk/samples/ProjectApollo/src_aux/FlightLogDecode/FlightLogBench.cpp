@@ -0,0 +1,186 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  Flight log benchmark: measures the frame time of a simulated vessel
+  that logs every frame, with the log off, with fprintf() and fflush()
+  per line as the LVDC did, and through the FlightLog as text and as
+  binary.
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  Usage:	FlightLogBench [options]
+
+		--frames=N	Frames per run (default 600).
+		--fps=F		Frame rate (default 60).
+		--lines=N	Log lines per frame (default 355, every fprintf() in
+				LVDC::TimeStep at full verbosity).
+		--work=US	Time the vessel spends on its own per frame
+				(default 2000 us).
+
+		Each run prints the mean, 99th percentile and longest frame
+		time, what logging added to the mean, and the records the
+		FlightLog dropped. The logs are written to the current
+		directory and deleted afterwards.
+
+  Build:	cl /O2 /EHsc FlightLogBench.cpp, or
+		g++ -O2 -pthread -o FlightLogBench FlightLogBench.cpp
+
+  **************************************************************************/
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1300 ) // Microsoft Visual Studio Version 2003 and higher
+#define _CRT_SECURE_NO_DEPRECATE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "../../src_sys/flightlog.h"
+
+#define MODE_OFF		0
+#define MODE_FPRINTF	1
+#define MODE_TEXT		2
+#define MODE_BINARY		3
+
+static double Now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//
+// Stands in for the rest of the vessel's timestep.
+//
+
+static double Work(double seconds)
+{
+	double end = Now() + seconds, x = 1.0;
+	while (Now() < end)
+	{
+		for (int i = 0; i < 100; i++)
+			x = sqrt(x + i);
+	}
+	return x;
+}
+
+static void Run(int mode, int frames, double fps, int lines, double work, double &offmean)
+{
+	static const char *names[] = { "Off", "fprintf + fflush", "FlightLog text", "FlightLog binary" };
+	const char *logname = "FlightLogBench.txt";
+
+	FILE *f = NULL;
+	FlightLogFile log;
+	int timebase = 4;
+	double t = 0, sink = 0;
+
+	if (mode == MODE_FPRINTF)
+	{
+		f = fopen(logname, "w+");
+	}
+	else
+	{
+		FlightLogSetChannels(mode == MODE_OFF ? 0 : (mode == MODE_BINARY ? FLIGHTLOG_LVDC | FLIGHTLOG_BINARY : FLIGHTLOG_LVDC));
+		log.Open(FLIGHTLOG_LVDC, logname);
+		log.SetClock(&timebase, &t);
+	}
+
+	std::vector<double> times;
+	double next = Now();
+
+	for (int n = 0; n < frames; n++)
+	{
+		double start = Now();
+		sink += Work(work);
+
+		for (int i = 0; i < lines; i++)
+		{
+			t = n / fps + i * 1e-6;
+			if (f)
+			{
+				fprintf(f, "[TB%d+%f] IGM: Tt_3 %f T_2 %f dT_3 %f phase %d\r\n", timebase, t, 341.2 - t, 112.6 + i, 0.1 * i, i & 3);
+				fflush(f);
+			}
+			else
+			{
+				log.Printf("[TB%d+%f] IGM: Tt_3 %f T_2 %f dT_3 %f phase %d\r\n", timebase, t, 341.2 - t, 112.6 + i, 0.1 * i, i & 3);
+			}
+		}
+		times.push_back(Now() - start);
+
+		//
+		// Wait for the next frame, which is when the flusher gets to run in Orbiter too.
+		//
+		next += 1.0 / fps;
+		while (Now() < next)
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+	}
+
+	unsigned int dropped = log.GetDropped();
+	if (f)
+		fclose(f);
+	else
+		log.Close();
+	remove(logname);
+	remove("FlightLogBench.flog");
+
+	double mean = 0;
+	for (size_t i = 0; i < times.size(); i++)
+		mean += times[i];
+	mean /= times.size();
+	std::sort(times.begin(), times.end());
+	if (mode == MODE_OFF)
+		offmean = mean;
+
+	printf("%-18s frame mean %7.3f ms  99%% %7.3f ms  max %7.3f ms  logging %+7.3f ms  dropped %u\n", names[mode],
+		mean * 1e3, times[times.size() * 99 / 100] * 1e3, times.back() * 1e3, (mean - offmean) * 1e3, dropped);
+	if (sink < 0)
+		printf("%g\n", sink);
+}
+
+int main(int argc, char *argv[])
+{
+	int frames = 600, lines = 355;
+	double fps = 60.0, work = 2000.0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (sscanf(argv[i], "--frames=%d", &frames) == 1)
+			;
+		else if (sscanf(argv[i], "--fps=%lf", &fps) == 1)
+			;
+		else if (sscanf(argv[i], "--lines=%d", &lines) == 1)
+			;
+		else if (sscanf(argv[i], "--work=%lf", &work) == 1)
+			;
+		else
+		{
+			fprintf(stderr, "Usage: FlightLogBench [--frames=N] [--fps=F] [--lines=N] [--work=US]\n");
+			return 1;
+		}
+	}
+	if (frames < 1 || fps <= 0)
+		return 1;
+
+	printf("%d frames at %g fps, %d lines and %g us of work per frame\n", frames, fps, lines, work);
+
+	double offmean = 0;
+	for (int mode = MODE_OFF; mode <= MODE_BINARY; mode++)
+		Run(mode, frames, fps, lines, work * 1e-6, offmean);
+	return 0;
+}
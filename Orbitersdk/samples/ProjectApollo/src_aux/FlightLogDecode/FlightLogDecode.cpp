@@ -0,0 +1,179 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  Flight log decoder: makes the text logs from the binary .flog files
+  the FlightLog (src_sys/flightlog.h) writes with FLIGHTLOG_BINARY set.
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  Usage:	FlightLogDecode [-t] log.flog [out.txt]
+
+		Writes the text log to out.txt, or by default to the name the log
+		had before (e.g. lvlog.txt) next to the .flog file. Use - to write
+		to stdout. With -t every line starts with the timebase and time of
+		its record.
+
+  Build:	cl /EHsc FlightLogDecode.cpp, or g++ -O2 -o FlightLogDecode FlightLogDecode.cpp
+
+  **************************************************************************/
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1300 ) // Microsoft Visual Studio Version 2003 and higher
+#define _CRT_SECURE_NO_DEPRECATE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <map>
+
+#include "../../src_sys/flightlog.h"
+
+template <typename T> static bool Read(FILE *f, T &v)
+{
+	return fread(&v, sizeof(v), 1, f) == 1;
+}
+
+static bool ReadString(FILE *f, std::string &s, size_t len)
+{
+	s.resize(len);
+	return len == 0 || fread(&s[0], 1, len, f) == len;
+}
+
+int main(int argc, char *argv[])
+{
+	bool times = false;
+	const char *in = NULL, *outname = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-t"))
+			times = true;
+		else if (!in)
+			in = argv[i];
+		else if (!outname)
+			outname = argv[i];
+	}
+	if (!in)
+	{
+		fprintf(stderr, "Usage: FlightLogDecode [-t] log.flog [out.txt]\n");
+		return 1;
+	}
+
+	FILE *f = fopen(in, "rb");
+	if (!f)
+	{
+		fprintf(stderr, "Cannot open %s\n", in);
+		return 1;
+	}
+
+	char magic[8];
+	unsigned int channel;
+	unsigned short len;
+	std::string name;
+	if (fread(magic, 1, 8, f) != 8 || memcmp(magic, FLIGHTLOG_MAGIC, 8) ||
+		!Read(f, channel) || !Read(f, len) || !ReadString(f, name, len))
+	{
+		fprintf(stderr, "%s is not a flight log\n", in);
+		fclose(f);
+		return 1;
+	}
+
+	//
+	// By default the text log goes where the old log was written, next to the binary one.
+	//
+	std::string path;
+	if (outname)
+	{
+		path = outname;
+	}
+	else
+	{
+		path = in;
+		size_t slash = path.find_last_of("/\\");
+		path = (slash == std::string::npos) ? name : path.substr(0, slash + 1) + name;
+	}
+
+	FILE *out = (path == "-") ? stdout : fopen(path.c_str(), "w");
+	if (!out)
+	{
+		fprintf(stderr, "Cannot write %s\n", path.c_str());
+		fclose(f);
+		return 1;
+	}
+
+	std::map<unsigned short, std::string> formats;
+	FlightLogRecord r;
+	std::string text;
+	long records = 0;
+	unsigned int dropped = 0;
+	bool complete = false;
+	int kind;
+
+	while ((kind = fgetc(f)) != EOF)
+	{
+		unsigned short id;
+
+		if (kind == 'F')
+		{
+			std::string fmt;
+			if (!Read(f, id) || !Read(f, len) || !ReadString(f, fmt, len)) break;
+			formats[id] = fmt;
+		}
+		else if (kind == 'R')
+		{
+			int i;
+
+			if (!Read(f, id) || !Read(f, r.t) || !Read(f, r.timebase) || !Read(f, r.n) || r.n > FLIGHTLOG_MAXFIELDS) break;
+			for (i = 0; i < r.n; i++)
+			{
+				if (!Read(f, r.types[i]) || !Read(f, r.fields[i])) break;
+			}
+			if (i < r.n || !Read(f, r.textlen) || r.textlen > FLIGHTLOG_TEXT || !ReadString(f, text, r.textlen)) break;
+			memcpy(r.text, text.data(), r.textlen);
+
+			if (times)
+				fprintf(out, "[TB%d+%f] ", r.timebase, r.t);
+			FlightLogFormat(out, formats[id].c_str(), r);
+			records++;
+		}
+		else if (kind == 'E')
+		{
+			complete = Read(f, dropped);
+			break;
+		}
+		else
+		{
+			fprintf(stderr, "Bad entry in %s after %ld records\n", in, records);
+			break;
+		}
+	}
+
+	fclose(f);
+	if (dropped)
+		fprintf(out, "*** %u records dropped, the flight log could not keep up ***\n", dropped);
+	if (out != stdout)
+	{
+		fclose(out);
+		fprintf(stderr, "%ld records written to %s\n", records, path.c_str());
+	}
+	if (dropped)
+		fprintf(stderr, "%u records were dropped while logging\n", dropped);
+	if (!complete)
+		fprintf(stderr, "%s has no end, the log was not closed\n", in);
+	return 0;
+}
@@ -0,0 +1,603 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  PanelSDK benchmark: runs the CSM systems config (SaturnSystems.cfg)
+  headless, times the hydraulics, and times the pipe transfers both
+  through GetFlow() + Flow() and through FlowTo(). Can also time how long
+  a vessel takes to build its systems and look them up by name, and check
+  the electrical load-flow pass.
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  Usage:	PanelSDKBench [options] SaturnSystems.cfg
+
+		--hours=H	Simulated time (default 2).
+		--step=S	Time step in seconds (default 0.05).
+		--load=W	Power drawn from the bus named by --bus (default 800).
+		--bus=NAME	Default DC_A.
+		--implicit	Use the implicit hydraulic solver.
+		--transfers=N	Rounds over all pipes for the transfer timing
+				(default 20000, 0 to skip it).
+		--startup=N	Only time the systems start-up, for N vessels.
+		--electric	Only run the electrical check.
+		--flows=FILE	Write the mass each pipe moved over the run.
+		--compare=FILE	Compare the mass each pipe moved with a file
+				written by --flows.
+
+		The run prints the state of the main tanks, the time spent in
+		the hydraulics per step and a hash over every tank's
+		composition, heat and mass. The hash must not change when a
+		change to the PanelSDK is meant to give the same results.
+
+		--flows and --compare are for soak tests of the hydraulic
+		solvers: write the flows of the explicit solver at a small step,
+		then compare the explicit and the implicit solver at larger
+		steps with them (see make soak). The comparison lists every
+		pipe which moved more than 1 kg and is more than 2% off.
+
+		The transfer timing moves a tiny amount through every pipe and
+		back again, so the tanks stay where they were.
+
+		The start-up timing builds the config once per vessel, adds
+		400 electrical objects the way the vessel code does through
+		PanelSDK::AddElectrical, and then looks up every object by
+		name, which is what GetPointerByString does for each panel
+		switch and connector.
+
+		The electrical check feeds INV_1 from BATTERY_A and BATTERY_B
+		through a merge, draws --load from the merge and an AC load
+		from INV_1 which steps from 300 W to 600 W half way through,
+		and runs with the load-flow pass off and on. Each run prints
+		the merge voltage around the step, the battery energy used and
+		the time per E_system refresh. Each is run again with half of
+		the AC load drawn through a second merge: the battery energy
+		used must not change, as the inverter's efficiency only
+		depends on its whole load.
+
+  Build:	make (on case-sensitive file systems the Makefile adds the
+		lower-case header names the PanelSDK sources use), or
+		cl /O2 /EHsc /Istub /I..\..\src_sys\PanelSDK\Internals PanelSDKBench.cpp
+		with the PanelSDK sources listed in the Makefile.
+
+  **************************************************************************/
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1300 ) // Microsoft Visual Studio Version 2003 and higher
+#define _CRT_SECURE_NO_DEPRECATE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "hsystems.h"
+#include "esystems.h"
+
+static FILE *config_file;
+static char config_line[275];
+
+//
+// What BUILD.CPP provides to the parsers in the spacecraft modules.
+//
+
+char* ReadConfigLine()
+{
+	if (!fgets(config_line, 255, config_file))
+		return NULL;
+
+	config_line[strcspn(config_line, "\r\n")] = 0;
+	char *p;
+	for (p = config_line; *p; p++)
+	{
+		if (*p == '\t') *p = ' ';
+		if (*p == '#') *p = 0;
+	}
+	for (p = config_line; *p; p++)
+		if (*p != ' ') return p;
+	return config_line;
+}
+
+void BuildError(int err)
+{
+	fprintf(stderr, "Config error %d\n", err);
+}
+
+int Compare(char* ln, char* trg)
+{
+	return ln && !strnicmp(ln, trg, strlen(trg));
+}
+
+static double Now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void Hash(unsigned long long &hash, const void *data, size_t size)
+{
+	const unsigned char *b = (const unsigned char *)data;
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ b[i]) * 1099511628211ULL;
+}
+
+//
+// Builds the hydraulic and electrical systems from a config file.
+//
+
+static bool LoadSystems(const char *config, VESSEL *vessel, Thermal_engine *&T, H_system *&H, E_system *&E)
+{
+	config_file = fopen(config, "r");
+	if (!config_file)
+	{
+		fprintf(stderr, "Cannot open %s\n", config);
+		return false;
+	}
+
+	T = new Thermal_engine;
+	H = new H_system;
+	E = new E_system;
+	T->v = vessel;
+	H->P_thermal = T;
+	E->P_thermal = T;
+	E->P_hydraulics = H;
+
+	char *line;
+	while ((line = ReadConfigLine()) != NULL)
+	{
+		if (Compare(line, "<HYDRAULIC>"))
+			H->Build();
+		else if (Compare(line, "<ELECTRIC>"))
+			E->Build();
+	}
+	fclose(config_file);
+	return true;
+}
+
+//
+// Stands in for the vessel's PowerMerge (src_sys/powersource.cpp), which
+// needs the rest of the PanelSDK: shares its load between two feeds by
+// their voltage, in the load-flow pass when that's on.
+//
+
+class BenchMerge : public e_object
+{
+public:
+	BenchMerge(const char *i_name, e_object *a, e_object *b) : BusA(a), BusB(b) { strcpy(name, i_name); };
+
+	double Voltage()
+	{
+		double VoltsA = BusA ? BusA->Voltage() : 0.0;
+		double VoltsB = BusB ? BusB->Voltage() : 0.0;
+
+		if (VoltsA != 0 && VoltsB != 0) return (VoltsA + VoltsB) / 2.0;
+		return VoltsA + VoltsB;
+	};
+
+	void DrawPower(double watts)
+	{
+		power_load += watts;
+		if (load_flow)
+			pending_load += watts;
+		else
+			ShareLoad(watts);
+	};
+
+	bool DefersLoad() { return true; };
+
+	bool PassOnLoad()
+	{
+		if (pending_load == 0.0)
+			return false;
+
+		double watts = pending_load;
+		pending_load = 0.0;
+		ShareLoad(watts);
+		return true;
+	};
+
+protected:
+	void ShareLoad(double watts)
+	{
+		double VoltsA = BusA ? BusA->Voltage() : 0.0;
+		double VoltsB = BusB ? BusB->Voltage() : 0.0;
+		double Volts = VoltsA + VoltsB;
+
+		if (Volts > 0.0) {
+			if (BusA)
+				BusA->DrawPower(watts * VoltsA / Volts);
+			if (BusB)
+				BusB->DrawPower(watts * VoltsB / Volts);
+		}
+	};
+
+	e_object *BusA;
+	e_object *BusB;
+};
+
+static bool ElectricRun(const char *config, double hours, double step, double load, bool loadFlow, bool split, double &used)
+{
+	VESSEL vessel;
+	Thermal_engine *T;
+	H_system *H;
+	E_system *E;
+
+	if (!LoadSystems(config, &vessel, T, H, E))
+		return false;
+
+	Battery *batA = (Battery *)E->GetSystemByName((char *)"BATTERY_A");
+	Battery *batB = (Battery *)E->GetSystemByName((char *)"BATTERY_B");
+	ACInverter *inverter = (ACInverter *)E->GetSystemByName((char *)"INV_1");
+	if (!batA || !batB || !inverter)
+	{
+		fprintf(stderr, "BATTERY_A, BATTERY_B or INV_1 missing from the config\n");
+		return false;
+	}
+
+	BenchMerge *dcMerge = new BenchMerge("BENCHDCMERGE", batA, batB);
+	BenchMerge *acMerge = new BenchMerge("BENCHACMERGE", inverter, NULL);
+	E->AddSystem(dcMerge);
+	E->AddSystem(acMerge);
+	inverter->connect(dcMerge);
+	E->SetLoadFlow(loadFlow);
+
+	long steps = (long)(hours * 3600.0 / step);
+	double volts[5] = { 0 }, electric = 0;
+
+	for (long s = 0; s < steps; s++)
+	{
+		double ac = (s < steps / 2) ? 300.0 : 600.0;
+
+		dcMerge->DrawPower(load);
+		if (split)
+		{
+			inverter->DrawPower(ac / 2.0);
+			acMerge->DrawPower(ac / 2.0);
+		}
+		else
+			inverter->DrawPower(ac);
+
+		T->Radiative(step);
+		H->Refresh(step);
+		double t = Now();
+		E->Refresh(step);
+		electric += Now() - t;
+
+		long k = s - steps / 2 + 1;
+		if (k >= 0 && k < 5)
+			volts[k] = dcMerge->Voltage();
+	}
+
+	used = (batA->max_power - batA->power) + (batB->max_power - batB->power);
+
+	printf("Load flow %-3s %-22s V %7.3f | %7.3f %7.3f %7.3f %7.3f  used %10.3f kJ  %.2f us per refresh\n", loadFlow ? "on" : "off",
+		split ? "AC split over a merge:" : "AC on INV_1:", volts[0], volts[1], volts[2], volts[3], volts[4], used / 1e3, steps ? electric / steps * 1e6 : 0.0);
+
+	delete E;
+	delete H;
+	delete T;
+	return true;
+}
+
+static int Electric(const char *config, double hours, double step, double load)
+{
+	int failed = 0;
+
+	printf("Merge voltage before the AC step | the 4 steps after it\n");
+	for (int loadFlow = 0; loadFlow < 2; loadFlow++)
+	{
+		double direct, split;
+
+		if (!ElectricRun(config, hours, step, load, loadFlow != 0, false, direct) ||
+			!ElectricRun(config, hours, step, load, loadFlow != 0, true, split))
+			return 1;
+
+		if (split != direct)
+		{
+			fprintf(stderr, "Load flow %s: splitting the AC load changed the energy used by %g J\n", loadFlow ? "on" : "off", split - direct);
+			failed++;
+		}
+	}
+	return failed ? 1 : 0;
+}
+
+static int Startup(const char *config, int vessels)
+{
+	double build = 0, lookup = 0;
+	int objects = 0, missing = 0;
+
+	for (int v = 0; v < vessels; v++)
+	{
+		VESSEL vessel;
+		Thermal_engine *T;
+		H_system *H;
+		E_system *E;
+
+		double t = Now();
+		if (!LoadSystems(config, &vessel, T, H, E))
+			return 1;
+		for (int i = 0; i < 400; i++)
+		{
+			e_object *e = new e_object;
+			sprintf(e->name, "BENCHOBJECT%03d", i);
+			E->AddSystem(e);
+		}
+		build += Now() - t;
+
+		t = Now();
+		objects = 0;
+		ship_system *systems[] = { H, E };
+		for (int k = 0; k < 2; k++)
+		{
+			for (ship_object *runner = systems[k]->List.next; runner; runner = runner->next)
+			{
+				if (!runner->name[0])
+					continue;
+				if (!systems[k]->GetSystemByName(runner->name))
+					missing++;
+				objects++;
+			}
+		}
+		lookup += Now() - t;
+
+		delete E;
+		delete H;
+		delete T;
+	}
+
+	printf("Start-up, %d vessels: build %.3f ms, lookup of %d objects %.3f ms, total %.3f ms per vessel\n",
+		vessels, build / vessels * 1e3, objects, lookup / vessels * 1e3, (build + lookup) / vessels * 1e3);
+	if (missing)
+	{
+		fprintf(stderr, "%d lookups failed\n", missing);
+		return 1;
+	}
+	return 0;
+}
+
+static std::vector<h_Pipe *> Pipes(H_system *H)
+{
+	std::vector<h_Pipe *> pipes;
+	for (ship_object *runner = H->List.next; runner; runner = runner->next)
+	{
+		h_Pipe *pipe = dynamic_cast<h_Pipe *>(runner);
+		if (pipe)
+			pipes.push_back(pipe);
+	}
+	return pipes;
+}
+
+static void WriteFlows(const char *file, const std::vector<h_Pipe *> &pipes, const std::vector<double> &moved)
+{
+	FILE *f = fopen(file, "w");
+	if (!f)
+	{
+		fprintf(stderr, "Cannot write %s\n", file);
+		return;
+	}
+	for (size_t k = 0; k < pipes.size(); k++)
+	{
+		h_Pipe *pipe = pipes[k];
+		fprintf(f, "%d %s %s %s %d %.3f\n", (int)k, pipe->in ? pipe->in->parent->name : "-", pipe->out ? pipe->out->parent->name : "-",
+			pipe->name[0] ? pipe->name : "-", pipe->type, moved[k]);
+	}
+	fclose(f);
+}
+
+static int CompareFlows(const char *file, const std::vector<h_Pipe *> &pipes, const std::vector<double> &moved)
+{
+	FILE *f = fopen(file, "r");
+	if (!f)
+	{
+		fprintf(stderr, "Cannot open %s\n", file);
+		return 1;
+	}
+
+	char line[512], in[100], out[100], name[100];
+	int k, type, off = 0;
+	double ref, worst = 0;
+
+	while (fgets(line, sizeof(line), f))
+	{
+		if (sscanf(line, "%d %99s %99s %99s %d %lf", &k, in, out, name, &type, &ref) != 6 || k < 0 || k >= (int)pipes.size())
+			continue;
+
+		// Moved mass is in grams
+		if (fabs(ref) < 1000.0)
+			continue;
+
+		double dev = (moved[k] - ref) / fabs(ref);
+		if (fabs(dev) > fabs(worst))
+			worst = dev;
+		if (fabs(dev) > 0.02)
+		{
+			printf("Pipe %2d %-24s -> %-24s %12.1f g, reference %12.1f g (%+.1f%%)\n", k, in, out, moved[k], ref, dev * 100.0);
+			off++;
+		}
+	}
+	fclose(f);
+
+	printf("%d pipes more than 2%% off %s, largest deviation %+.2f%%\n", off, file, worst * 100.0);
+	return 0;
+}
+
+static void Transfers(H_system *H, int rounds)
+{
+	std::vector<h_Pipe *> pipes;
+	for (ship_object *runner = H->List.next; runner; runner = runner->next)
+	{
+		h_Pipe *pipe = dynamic_cast<h_Pipe *>(runner);
+		if (pipe && pipe->in && pipe->out && pipe->type != 3)
+			pipes.push_back(pipe);
+	}
+	if (pipes.empty())
+		return;
+
+	const double dPdT = 1e-6;
+	double sink = 0;
+
+	for (int run = 0; run < 3; run++)
+	{
+		for (int inPlace = 0; inPlace < 2; inPlace++)
+		{
+			double t = Now();
+			for (int n = 0; n < rounds; n++)
+			{
+				for (size_t k = 0; k < pipes.size(); k++)
+				{
+					h_Pipe *pipe = pipes[k];
+					if (inPlace)
+					{
+						sink += pipe->in->FlowTo(pipe->out, dPdT);
+						sink += pipe->out->FlowTo(pipe->in, dPdT);
+					}
+					else
+					{
+						h_volume there = pipe->in->GetFlow(dPdT);
+						sink += there.GetMass();
+						pipe->out->Flow(there);
+						h_volume back = pipe->out->GetFlow(dPdT);
+						sink += back.GetMass();
+						pipe->in->Flow(back);
+					}
+				}
+			}
+			t = Now() - t;
+			printf("%-16s %6.1f ns per pipe transfer (%d pipes)\n", inPlace ? "FlowTo:" : "GetFlow + Flow:",
+				t / rounds / pipes.size() / 2.0 * 1e9, (int)pipes.size());
+		}
+	}
+	if (sink < 0)
+		printf("%g\n", sink);
+}
+
+int main(int argc, char *argv[])
+{
+	double hours = 2.0, step = 0.05, load = 800.0;
+	int transfers = 20000, startup = 0;
+	bool implicit = false, electric = false;
+	const char *bus = "DC_A", *config = NULL, *flows = NULL, *compare = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (sscanf(argv[i], "--hours=%lf", &hours) == 1)
+			;
+		else if (sscanf(argv[i], "--step=%lf", &step) == 1)
+			;
+		else if (sscanf(argv[i], "--load=%lf", &load) == 1)
+			;
+		else if (sscanf(argv[i], "--transfers=%d", &transfers) == 1)
+			;
+		else if (sscanf(argv[i], "--startup=%d", &startup) == 1)
+			;
+		else if (!strncmp(argv[i], "--bus=", 6))
+			bus = argv[i] + 6;
+		else if (!strcmp(argv[i], "--implicit"))
+			implicit = true;
+		else if (!strcmp(argv[i], "--electric"))
+			electric = true;
+		else if (!strncmp(argv[i], "--flows=", 8))
+			flows = argv[i] + 8;
+		else if (!strncmp(argv[i], "--compare=", 10))
+			compare = argv[i] + 10;
+		else if (argv[i][0] == '-')
+		{
+			fprintf(stderr, "Unknown option %s\n", argv[i]);
+			return 1;
+		}
+		else
+			config = argv[i];
+	}
+	if (!config || step <= 0)
+	{
+		fprintf(stderr, "Usage: PanelSDKBench [--hours=H] [--step=S] [--load=W] [--bus=NAME] [--implicit] [--transfers=N] [--startup=N] [--electric] [--flows=FILE] [--compare=FILE] SaturnSystems.cfg\n");
+		return 1;
+	}
+
+	if (startup > 0)
+		return Startup(config, startup);
+	if (electric)
+		return Electric(config, hours, step, load);
+
+	VESSEL vessel;
+	Thermal_engine *T;
+	H_system *H;
+	E_system *E;
+
+	if (!LoadSystems(config, &vessel, T, H, E))
+		return 1;
+	H->SetImplicit(implicit);
+
+	e_object *source = (e_object *)E->GetPointerByString((char *)bus);
+	long steps = (long)(hours * 3600.0 / step);
+	double t = Now(), hydraulics = 0;
+
+	std::vector<h_Pipe *> pipes;
+	std::vector<double> moved;
+	if (flows || compare)
+	{
+		pipes = Pipes(H);
+		moved.resize(pipes.size(), 0.0);
+	}
+
+	for (long s = 0; s < steps; s++)
+	{
+		if (source)
+			source->DrawPower(load);
+		T->Radiative(step);
+		double h = Now();
+		H->Refresh(step);
+		hydraulics += Now() - h;
+		E->Refresh(step);
+
+		for (size_t k = 0; k < pipes.size(); k++)
+			moved[k] += pipes[k]->flow * step;
+	}
+	t = Now() - t;
+
+	const char *tanks[] = { "O2TANK1", "H2TANK1", "O2SURGETANK", "CABIN", "SUITCIRCUIT", "PRIMGLYCOLACCUMULATOR", "POTABLEH2OTANK", "WASTEH2OTANK", NULL };
+	for (int i = 0; tanks[i]; i++)
+	{
+		h_Tank *tank = (h_Tank *)H->GetSystemByName((char *)tanks[i]);
+		if (tank)
+			printf("%-22s P %12.1f  T %8.2f  m %12.1f\n", tanks[i], tank->space.Press, tank->space.Temp, tank->space.GetMass());
+	}
+
+	unsigned long long hash = 1469598103934665603ULL;
+	for (ship_object *runner = H->List.next; runner; runner = runner->next)
+	{
+		h_Tank *tank = dynamic_cast<h_Tank *>(runner);
+		if (tank)
+		{
+			Hash(hash, tank->space.composition, sizeof(tank->space.composition));
+			Hash(hash, &tank->space.Q, sizeof(tank->space.Q));
+			Hash(hash, &tank->mass, sizeof(tank->mass));
+		}
+	}
+	printf("State hash %016llx\n", hash);
+	printf("%s solver, %ld steps of %g s: %.3f s, hydraulics %.1f us per step\n", implicit ? "Implicit" : "Explicit",
+		steps, step, t, steps ? hydraulics / steps * 1e6 : 0.0);
+
+	if (flows)
+		WriteFlows(flows, pipes, moved);
+	if (compare && CompareFlows(compare, pipes, moved))
+		return 1;
+
+	if (transfers > 0)
+		Transfers(H, transfers);
+	return 0;
+}
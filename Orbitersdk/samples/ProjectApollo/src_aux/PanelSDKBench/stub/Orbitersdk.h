@@ -0,0 +1,82 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  Just enough of the Orbiter API for PanelSDKBench to link the PanelSDK
+  hydraulic, electric and thermal systems without Orbiter. The vessel sits
+  in a fixed place in space; nothing that uses it is timed.
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  **************************************************************************/
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef _MSC_VER
+#include <strings.h>
+#define stricmp strcasecmp
+#define strnicmp strncasecmp
+#define __max(a,b) ((a)>(b)?(a):(b))
+#define __min(a,b) ((a)<(b)?(a):(b))
+#endif
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+typedef void *FILEHANDLE;
+typedef void *OBJHANDLE;
+typedef void *PROPELLANT_HANDLE;
+typedef void *THRUSTER_HANDLE;
+
+union VECTOR3
+{
+	double data[3];
+	struct { double x, y, z; };
+};
+
+inline VECTOR3 _V(double x, double y, double z) { VECTOR3 v; v.x = x; v.y = y; v.z = z; return v; }
+
+class VESSEL
+{
+public:
+	VESSEL() : EmptyMass(0) {}
+	OBJHANDLE GetGravityRef() { return 0; }
+	void GetGlobalPos(VECTOR3 &v) { v = _V(1.4e11, 5e10, 2e10); }
+	void GetRelativePos(OBJHANDLE, VECTOR3 &v) { v = _V(1e7, 0, 0); }
+	void Global2Local(const VECTOR3 &, VECTOR3 &v) { v = _V(1, 0, 0); }
+	double GetEmptyMass() { return EmptyMass; }
+	void SetEmptyMass(double m) { EmptyMass = m; }
+	double GetAtmPressure() { return 0; }
+	double GetPropellantMass(PROPELLANT_HANDLE) { return 0; }
+	void SetPropellantMass(PROPELLANT_HANDLE, double) {}
+	THRUSTER_HANDLE CreateThruster(VECTOR3, VECTOR3, double, PROPELLANT_HANDLE, double) { return 0; }
+	void AddExhaust(THRUSTER_HANDLE, double, double) {}
+	void SetThrusterLevel(THRUSTER_HANDLE, double) {}
+
+private:
+	double EmptyMass;
+};
+
+inline bool oapiReadScenario_nextline(FILEHANDLE, char *&line) { static char end[] = "</X>"; line = end; return false; }
+inline void oapiWriteScenario_string(FILEHANDLE, const char *, const char *) {}
+inline double oapiGetSize(OBJHANDLE) { return 6.4e6; }
+inline void oapiGetObjectName(OBJHANDLE, char *name, int) { strcpy(name, "Earth"); }
+inline char *oapiDebugString() { static char buffer[256]; return buffer; }
@@ -377,7 +377,8 @@ BOOL CALLBACK ProjectApolloConfigurator::DlgProcFrame (HWND hWnd, UINT uMsg, WPA
 				if (sscanf(buffer, "%i", &i) == 1) {
 					gParams.Saturn_MaxTimeAcceleration = i;
 				} else {
-					gParams.Saturn_MaxTimeAcceleration = 100;
+					// The IMU spreads a frame over sub-steps shorter than the DAP cycle up to about this
+					gParams.Saturn_MaxTimeAcceleration = 300;
 				}
 				if (SendDlgItemMessage (gParams.hDlgTabs[3], IDC_CHECK_MULTITHREAD, BM_GETCHECK, 0, 0) == BST_CHECKED) {
 					gParams.Saturn_MultiThread = 1;
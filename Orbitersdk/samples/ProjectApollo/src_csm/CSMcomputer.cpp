@@ -147,9 +147,7 @@ CSMcomputer::CSMcomputer(SoundLib &s, DSKY &display, DSKY &display2, IMU &im, Pa
 CSMcomputer::~CSMcomputer()
 
 {
-	//
-	// Nothing for now.
-	//
+	StopThread();
 }
 
 void CSMcomputer::SetMissionInfo(int MissionNo, int RealismValue, char *OtherVessel)
@@ -2684,38 +2682,44 @@ void CSMcomputer::Prog59Pressed(int R1, int R2, int R3)
 
 void CSMcomputer::agcTimestep(double simt, double simdt)
 {
-	// Do single timesteps to maintain sync with telemetry engine
+	// Step in batches that end where the telemetry engine needs a step, to maintain sync
 	SingleTimestepPrep(simt, simdt);        // Setup
 	if (LastCycled == 0) {					// Use simdt as difference if new run
 		LastCycled = (simt - simdt); 
 		sat->pcm.last_update = LastCycled;
 	}	  
 	double ThisTime = LastCycled;			// Save here
+	double pcm_update = sat->pcm.last_update;
 	
 	long cycles = (long)((simt - LastCycled) / 0.00001171875);	// Get number of CPU cycles to do
 	LastCycled += (0.00001171875 * cycles);						// Preserve the remainder
 	long x = 0; 
 	while(x < cycles) {
-		SingleTimestep();
-		ThisTime += 0.00001171875;								// Add time
-		if((ThisTime - sat->pcm.last_update) > 0.00015625) {	// If a step is needed
-			sat->pcm.TimeStep(ThisTime);						// do it
+		// Run up to the cycle where the next telemetry step is needed, or to an output channel change
+		long n = (long)ceil((0.00015625 - (ThisTime - pcm_update)) / 0.00001171875);
+		if (n < 1) n = 1;
+		if (n > cycles - x) n = cycles - x;
+		n = agc_engine_run(&vagc, n);
+		ThisTime += 0.00001171875 * n;							// Add time
+		if((ThisTime - pcm_update) > 0.00015625) {				// If a step is needed
+			if (PipelineQueuing) {
+				// Pipelined, the step is done after the systems timestep, in whole words as the PCM does
+				QueueTelemetry(ThisTime);
+				pcm_update += floor((ThisTime - pcm_update) / 0.00015625) * 0.00015625;
+			}
+			else {
+				sat->pcm.TimeStep(ThisTime);					// do it
+				pcm_update = sat->pcm.last_update;
+			}
 		}
-		x++;
+		x += n;
 	}
 }
 
-void CSMcomputer::Run ()
-	{
-		while(true)
-		{
-			timeStepEvent.Wait();
-			{
-				Lock lock(agcCycleMutex);
-				agcTimestep(thread_simt,thread_simdt);
-			}
-		}
-	};
+void CSMcomputer::PipelineTelemetry(double t)
+{
+	sat->pcm.TimeStep(t);
+}
 
 
 void CSMcomputer::Timestep(double simt, double simdt)
@@ -2917,7 +2921,9 @@ void CSMcomputer::Timestep(double simt, double simdt)
 		// If MultiThread is enabled and the simulation is accellerated, the run vAGC in the AGC Thread,
 		// otherwise run in main thread. at x1 acceleration, it is better to run vAGC totally synchronized
 		//
-		if(sat->IsMultiThread && oapiGetTimeAcceleration() > 1.0)
+		if (PipelineStep)
+			PipelineHandoff(simt, simdt);
+		else if(sat->IsMultiThread && oapiGetTimeAcceleration() > 1.0)
 		{
 			
 			Lock lock(agcCycleMutex);
@@ -271,7 +271,6 @@ public:
 	void WriteMemory(unsigned int loc, int val);
 
 	void Timestep(double simt, double simdt);
-	void Run() ;
 	void agcTimestep(double simt, double simdt);
 
 	//
@@ -343,6 +342,7 @@ public:
 protected:
 
 	void DisplayNounData(int noun);
+	void PipelineTelemetry(double t);
 	void ProgPressed(int R1, int R2, int R3);
 
 	///
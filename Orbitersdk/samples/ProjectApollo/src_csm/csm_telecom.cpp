@@ -671,8 +671,91 @@ bool PCM::registerSocket(SOCKET sock)
 	return true;
 }
 // PCM SYSTEM
+
+// Telemetry snapshot. measure() runs for every word of every frame, up to 128 times
+// a frame at HBR, and most words only need one value out of a Saturn status structure.
+// The status data only changes when the Saturn systems are stepped, so each group is
+// collected at most once per Orbiter timestep, the first time a word asks for it.
+// With the yaAGC the PCM is stepped once per HBR word, so this can't be tied to
+// PCM::TimeStep.
+
+#define SNAP_ATMOS			0x00000001
+#define SNAP_ECSWATER		0x00000002
+#define SNAP_PRIMECS		0x00000004
+#define SNAP_SECECS			0x00000008
+#define SNAP_TANKPRESS		0x00000010
+#define SNAP_TANKQUANT		0x00000020
+#define SNAP_MAINBUS		0x00000040
+#define SNAP_BATBUS			0x00000080
+#define SNAP_BATTERY		0x00000100
+#define SNAP_SPS			0x00000200
+#define SNAP_PYRO			0x00000400
+#define SNAP_SECS			0x00000800
+#define SNAP_FUELCELL		0x00001000	// 3 bits, one per fuel cell
+#define SNAP_ACBUS			0x00008000	// 2 bits, one per AC bus
+#define SNAP_RCS			0x00020000	// 6 bits, RCS_SM_QUAD_A to RCS_CM_RING_2
+
+struct PCMSnapshot {
+	Saturn *sat;
+	double time;					// Orbiter simulation time of this snapshot
+	unsigned int valid;				// SNAP_* groups collected this timestep
+
+	AtmosStatus atm;
+	ECSWaterStatus ws;
+	PrimECSCoolingStatus pcs;
+	SecECSCoolingStatus scs;
+	TankPressures smTankPress;
+	TankQuantities tankQuantities;
+	MainBusStatus mainBusStatus;
+	BatteryBusStatus batBusStat;
+	BatteryStatus batteryStatus;
+	SPSStatus spsStatus;
+	PyroStatus pyroStatus;
+	SECSStatus secsStatus;
+	FuelCellStatus fcStatus[3];
+	ACBusStatus acStat[2];
+	RCSStatus rcsStatus[6];
+
+	bool Fetch(unsigned int group) {
+		if (valid & group) return false;
+		valid |= group;
+		return true;
+	}
+
+	AtmosStatus *Atmos() { if (Fetch(SNAP_ATMOS)) sat->GetAtmosStatus(atm); return &atm; }
+	ECSWaterStatus *ECSWater() { if (Fetch(SNAP_ECSWATER)) sat->GetECSWaterStatus(ws); return &ws; }
+	PrimECSCoolingStatus *PrimECSCooling() { if (Fetch(SNAP_PRIMECS)) sat->GetPrimECSCoolingStatus(pcs); return &pcs; }
+	SecECSCoolingStatus *SecECSCooling() { if (Fetch(SNAP_SECECS)) sat->GetSecECSCoolingStatus(scs); return &scs; }
+	TankPressures *TankPress() { if (Fetch(SNAP_TANKPRESS)) sat->GetTankPressures(smTankPress); return &smTankPress; }
+	TankQuantities *TankQuant() { if (Fetch(SNAP_TANKQUANT)) sat->GetTankQuantities(tankQuantities); return &tankQuantities; }
+	MainBusStatus *MainBus() { if (Fetch(SNAP_MAINBUS)) sat->GetMainBusStatus(mainBusStatus); return &mainBusStatus; }
+	BatteryBusStatus *BatteryBus() { if (Fetch(SNAP_BATBUS)) sat->GetBatteryBusStatus(batBusStat); return &batBusStat; }
+	BatteryStatus *Battery() { if (Fetch(SNAP_BATTERY)) sat->GetBatteryStatus(batteryStatus); return &batteryStatus; }
+	SPSStatus *SPS() { if (Fetch(SNAP_SPS)) sat->GetSPSStatus(spsStatus); return &spsStatus; }
+	PyroStatus *Pyro() { if (Fetch(SNAP_PYRO)) sat->GetPyroStatus(pyroStatus); return &pyroStatus; }
+	SECSStatus *SECS() { if (Fetch(SNAP_SECS)) sat->GetSECSStatus(secsStatus); return &secsStatus; }
+
+	// Fuel cells and AC buses are numbered from 1, RCS systems from 0.
+	FuelCellStatus *FuelCell(int index) {
+		if (Fetch(SNAP_FUELCELL << (index - 1))) sat->GetFuelCellStatus(index, fcStatus[index - 1]);
+		return &fcStatus[index - 1];
+	}
+	ACBusStatus *ACBus(int busno) {
+		if (Fetch(SNAP_ACBUS << (busno - 1))) sat->GetACBusStatus(acStat[busno - 1], busno);
+		return &acStat[busno - 1];
+	}
+	RCSStatus *RCS(int index) {
+		if (Fetch(SNAP_RCS << index)) sat->GetRCSStatus(index, rcsStatus[index]);
+		return &rcsStatus[index];
+	}
+};
+
 PCM::PCM(){
 	sat = NULL;
+	snap = new PCMSnapshot;
+	snap->sat = NULL;
+	snap->time = -1;
+	snap->valid = 0;
 	conn_state = 0;
 	uplink_state = 0; rx_offset = 0; 
 	mcc_size = 0; mcc_offset = 0;
@@ -680,10 +763,25 @@ PCM::PCM(){
 	last_update = 0;
 	last_rx = 0;
 	pcm_rate_override = 0;
+	downlink_policy = PCM_DOWNLINK_FULL;
+	tx_offset = 0;
+	tx_size = 0;
+	tx_skip = false;
+	tx_overflow = false;
+	tx_frames = 0;
+	tx_dropped = 0;
+	tx_lost = 0;
+}
+
+PCM::~PCM(){
+	delete snap;
 }
 
 void PCM::Init(Saturn *vessel){
 	sat = vessel;
+	snap->sat = vessel;
+	snap->time = -1;
+	snap->valid = 0;
 	conn_state = 0;
 	uplink_state = 0; rx_offset = 0;
 	mcc_size = 0; mcc_offset = 0;
@@ -692,6 +790,13 @@ void PCM::Init(Saturn *vessel){
 	last_rx = 0;
 	word_addr = 0;
 	pcm_rate_override = 0;
+	tx_offset = 0;
+	tx_size = 0;
+	tx_skip = false;
+	tx_overflow = false;
+	tx_frames = 0;
+	tx_dropped = 0;
+	tx_lost = 0;
 	int iResult = WSAStartup( MAKEWORD(2,2), &wsaData );
 	if ( iResult != NO_ERROR ){
 		sprintf(wsk_emsg,"TELECOM: Error at WSAStartup()");
@@ -796,35 +901,140 @@ void PCM::TimeStep(double simt){
 	}
 	*/
 
+	// Status data is collected again once per Orbiter timestep
+	if (snap->time != oapiGetSimTime()) {
+		snap->time = oapiGetSimTime();
+		snap->valid = 0;
+	}
+
 	// Generate PCM datastream
+	bool hbr;
 	if(pcm_rate_override == 1 || (pcm_rate_override == 0 && sat->PCMBitRateSwitch.GetState() == TOGGLESWITCH_DOWN)){
-		tx_size = (int)((simt - last_update) / 0.005);
-		// sprintf(oapiDebugString(),"Need to send %d bytes",tx_size);
-		if(tx_size > 0){
-			last_update = simt;
-			if(tx_size < 1024){
-				tx_offset = 0;
-				while(tx_offset < tx_size){
-					generate_stream_lbr();
-					tx_offset++;
+		hbr = false;
+	}
+	else if(pcm_rate_override == 2 || (pcm_rate_override == 0 && sat->PCMBitRateSwitch.GetState() == TOGGLESWITCH_UP)){
+		hbr = true;
+	}
+	else{
+		return;
+	}
+	int words_per_frame = hbr ? 128 : 40;
+	double word_time = hbr ? 0.00015625 : 0.005;
+
+	// Start over after a jump in mission time, e.g. a scenario load
+	if(simt < last_update || simt - last_update > 600.0){
+		last_update = simt;
+		return;
+	}
+	int words = (int)((simt - last_update) / word_time);
+	// sprintf(oapiDebugString(),"Need to send %d bytes",words);
+	if(words < 1){
+		return;
+	}
+	// Keep the remainder, so the stream runs at the real bit rate
+	double t = last_update;
+	last_update += words * word_time;
+
+	// Nobody to send it to, so only step the word and frame counters through.
+	// A frame that is under way when a client connects is left out.
+	if(conn_state != 2){
+		tx_size = 0;
+		tx_skip = true;
+		while(words > 0){
+			next_word(hbr);
+			words--;
+		}
+		perform_io(simt);
+		return;
+	}
+
+	while(words > 0){
+		t += word_time;
+		if(word_addr == 0){
+			start_frame(t, words_per_frame, word_time);
+		}
+		if(!tx_skip && tx_size >= PCM_RING_SIZE){
+			tx_skip = true; // Ring buffer overflow, lose the rest of the frame
+			tx_overflow = true;
+		}
+		if(!tx_skip){
+			if(hbr){
+				generate_stream_hbr();
+			}else{
+				generate_stream_lbr();
+			}
+			tx_offset = (tx_offset + 1) & (PCM_RING_SIZE - 1);
+			tx_size++;
+		}
+		next_word(hbr);
+		if(word_addr == 0){
+			if(tx_skip){
+				tx_dropped++;
+				if(tx_overflow){
+					tx_lost++;
 				}
-				perform_io(simt);
+			}else{
+				tx_frames++;
 			}
 		}
-		return; // Don't waste time checking for HBR
+		words--;
 	}
-	if(pcm_rate_override == 2 || (pcm_rate_override == 0 && sat->PCMBitRateSwitch.GetState() == TOGGLESWITCH_UP)){
-		tx_size = (int)((simt - last_update) / 0.00015625);
-		// sprintf(oapiDebugString(),"Need to send %d bytes",tx_size);
-		if(tx_size > 0){
-			last_update = simt;
-			if(tx_size < 1024){
-				tx_offset = 0;
-				while(tx_offset < tx_size){
-					generate_stream_hbr();
-					tx_offset++;
-				}			
-				perform_io(simt);
+	perform_io(simt);
+}
+
+// Decide if the frame starting at time t goes into the downlink. Frames that are
+// left out are still counted through, so the frame counters stay in sequence.
+void PCM::start_frame(double t, int words_per_frame, double word_time){
+	double frame_time = words_per_frame * word_time;
+	int n;
+
+	tx_overflow = false;
+	switch(downlink_policy){
+		case PCM_DOWNLINK_DECIMATE:
+			// One frame in every n at n times time acceleration
+			n = (int)ceil(oapiGetTimeAcceleration());
+			tx_skip = (n > 1 && ((tx_frames + tx_dropped) % n) != 0);
+			break;
+		case PCM_DOWNLINK_LATEST:
+			// Only the frame that is in progress at the end of this timestep
+			tx_skip = (t - word_time + frame_time <= sat->GetMissionTime());
+			break;
+		default:
+			tx_skip = false;
+			break;
+	}
+	// Only start a frame if all of it fits into the ring buffer
+	if(PCM_RING_SIZE - tx_size < words_per_frame){
+		tx_skip = true;
+		tx_overflow = true;
+	}
+}
+
+// Step to the next word of the frame format
+void PCM::next_word(bool hbr){
+	word_addr++;
+	if(hbr){
+		if(word_addr > 127){
+			word_addr = 0;
+			frame_addr++;
+			if(frame_addr > 49){
+				frame_addr = 0;
+			}
+			frame_count++;
+			if(frame_count > 4){
+				frame_count = 0;
+			}
+		}
+	}else{
+		if(word_addr > 39){
+			word_addr = 0;
+			frame_addr++;
+			if(frame_addr > 4){
+				frame_addr = 0;
+			}
+			frame_count++;
+			if(frame_count > 5){
+				frame_count = 0;
 			}
 		}
 	}
@@ -849,22 +1059,22 @@ unsigned char PCM::scale_data(double data, double low, double high){
 
 // Fetch a telemetry data item from its channel code
 unsigned char PCM::measure(int channel, int type, int ccode){
-	// Status structures.
-	AtmosStatus atm;
-	ECSWaterStatus ws;
-	PrimECSCoolingStatus pcs;
-	SecECSCoolingStatus scs;
-	TankPressures smTankPress;
-	TankQuantities tankQuantities;
-	ACBusStatus acStat;
-	MainBusStatus mainBusStatus;
-	BatteryBusStatus batBusStat;
-	BatteryStatus batteryStatus;
-	SPSStatus spsStatus;
-	FuelCellStatus fcStatus;
-	PyroStatus pyroStatus;
-	SECSStatus secsStatus;
-	RCSStatus rcsStatus;
+	// Status structures, from the telemetry snapshot.
+	AtmosStatus *atm;
+	ECSWaterStatus *ws;
+	PrimECSCoolingStatus *pcs;
+	SecECSCoolingStatus *scs;
+	TankPressures *smTankPress;
+	TankQuantities *tankQuantities;
+	ACBusStatus *acStat;
+	MainBusStatus *mainBusStatus;
+	BatteryBusStatus *batBusStat;
+	BatteryStatus *batteryStatus;
+	SPSStatus *spsStatus;
+	FuelCellStatus *fcStatus;
+	PyroStatus *pyroStatus;
+	SECSStatus *secsStatus;
+	RCSStatus *rcsStatus;
 
 	switch(type){
 		case TLM_A:  // ANALOG
@@ -876,73 +1086,73 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 2:			// UNKNOWN - HBR ONLY
 							return(0);
 						case 3:			// CO2 PARTIAL PRESS
-							sat->GetAtmosStatus(atm);
-							return(scale_data(atm.CabinCO2MMHG,0,30));
+							atm = snap->Atmos();
+							return(scale_data(atm->CabinCO2MMHG,0,30));
 						case 4:			// GLY EVAP BACK PRESS
 							return(scale_data(0,0.05,0.25));
 						case 5:			// UNKNOWN - HBR ONLY
 							return(0);
 						case 6:			// CABIN PRESS
-							sat->GetAtmosStatus(atm);
-							return(scale_data(atm.CabinPressurePSI,0,17));
+							atm = snap->Atmos();
+							return(scale_data(atm->CabinPressurePSI,0,17));
 						case 7:			// UNKNOWN - HBR ONLY
 							return(0);
 						case 8:			// SEC EVAP OUT STEAM PRESS
-							sat->GetSecECSCoolingStatus(scs);
-							return(scale_data(scs.EvaporatorSteamPressurePSI,0.05,0.25));
+							scs = snap->SecECSCooling();
+							return(scale_data(scs->EvaporatorSteamPressurePSI,0.05,0.25));
 						case 9:			// WASTE H20 QTY
-							sat->GetECSWaterStatus(ws);
-							return(scale_data(ws.WasteH2oTankQuantityPercent,0,100)); 
+							ws = snap->ECSWater();
+							return(scale_data(ws->WasteH2oTankQuantityPercent,0,100)); 
 
 						case 10:		// SPS VLV ACT PRESS PRI
 							return(scale_data(0,0,5000));
 						case 11:		// SPS VLV ACT PRESS SEC
 							return(scale_data(0,0,5000));
 						case 12:		// GLY EVAP OUT TEMP
-							sat->GetPrimECSCoolingStatus(pcs);
-							return(scale_data(pcs.EvaporatorOutletTempF,25,75));
+							pcs = snap->PrimECSCooling();
+							return(scale_data(pcs->EvaporatorOutletTempF,25,75));
 						case 13:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 14:		// ENG CHAMBER PRESS
-							sat->GetSPSStatus( spsStatus );
-							return(scale_data(spsStatus.chamberPressurePSI, 0, 150));
+							spsStatus = snap->SPS();
+							return(scale_data(spsStatus->chamberPressurePSI, 0, 150));
 						case 15:		// ECS RAD OUT TEMP
-							sat->GetPrimECSCoolingStatus(pcs);
-							return(scale_data(pcs.RadiatorOutletTempF,-50,100));
+							pcs = snap->PrimECSCooling();
+							return(scale_data(pcs->RadiatorOutletTempF,-50,100));
 						case 16:		// HE TK TEMP
 							return(scale_data(0,-100,200));
 						case 17:		// SM ENG PKG B TEMP
-							sat->GetRCSStatus( RCS_SM_QUAD_B, rcsStatus );
-							return(scale_data(rcsStatus.PackageTempF, 0, 300));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_B);
+							return(scale_data(rcsStatus->PackageTempF, 0, 300));
 						case 18:		// CM HE TK A PRESS
-							sat->GetRCSStatus( RCS_CM_RING_1, rcsStatus );
-							return(scale_data(rcsStatus.HeliumPressurePSI, 0, 5000));
+							rcsStatus = snap->RCS(RCS_CM_RING_1);
+							return(scale_data(rcsStatus->HeliumPressurePSI, 0, 5000));
 						case 19:		// SM ENG PKG C TEMP
-							sat->GetRCSStatus( RCS_SM_QUAD_C, rcsStatus );
-							return(scale_data(rcsStatus.PackageTempF, 0, 300));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_C);
+							return(scale_data(rcsStatus->PackageTempF, 0, 300));
 
 						case 20:		// SM ENG PKG D TEMP
-							sat->GetRCSStatus( RCS_SM_QUAD_D, rcsStatus );
-							return(scale_data(rcsStatus.PackageTempF, 0, 300));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_D);
+							return(scale_data(rcsStatus->PackageTempF, 0, 300));
 						case 21:		// CM HE TK B PRESS
-							sat->GetRCSStatus( RCS_CM_RING_2, rcsStatus );
-							return(scale_data(rcsStatus.HeliumPressurePSI, 0, 5000));
+							rcsStatus = snap->RCS(RCS_CM_RING_2);
+							return(scale_data(rcsStatus->HeliumPressurePSI, 0, 5000));
 
 						case 22:		// DOCKING PROBE TEMP
 							return(scale_data(0,-100,300));
 						case 23:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 24:		// SM HE TK A PRESS
-							sat->GetRCSStatus( RCS_SM_QUAD_A, rcsStatus );
-							return(scale_data(rcsStatus.HeliumPressurePSI, 0, 5000));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_A);
+							return(scale_data(rcsStatus->HeliumPressurePSI, 0, 5000));
 
 						case 25:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 26:		// OX TK 1 QTY -TOTAL AUX
 							return(scale_data(0,0,50));
 						case 27:		// SM HE TK B PRESS
-							sat->GetRCSStatus( RCS_SM_QUAD_B, rcsStatus );
-							return(scale_data(rcsStatus.HeliumPressurePSI, 0, 5000));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_B);
+							return(scale_data(rcsStatus->HeliumPressurePSI, 0, 5000));
 
 						case 28:		// OX TK 2 QTY
 							return(scale_data(0,0,60));
@@ -950,46 +1160,46 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 							return(scale_data(0,0,50));
 
 						case 30:		// SM HE TK C PRESS
-							sat->GetRCSStatus( RCS_SM_QUAD_C, rcsStatus );
-							return(scale_data(rcsStatus.HeliumPressurePSI, 0, 5000));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_C);
+							return(scale_data(rcsStatus->HeliumPressurePSI, 0, 5000));
 
 						case 31:		// FU TK 2 QTY
 							return(scale_data(0,0,60));
 						case 32:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 33:		// SM HE TK D PRESS
-							sat->GetRCSStatus( RCS_SM_QUAD_D, rcsStatus );
-							return(scale_data(rcsStatus.HeliumPressurePSI, 0, 5000));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_D);
+							return(scale_data(rcsStatus->HeliumPressurePSI, 0, 5000));
 
 						case 34:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 35:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 36:		// H2 TK 1 PRESS
-							sat->GetTankPressures( smTankPress );
-							return(scale_data(smTankPress.H2Tank1PressurePSI, 0, 350));
+							smTankPress = snap->TankPress();
+							return(scale_data(smTankPress->H2Tank1PressurePSI, 0, 350));
 						case 37:		// SPS VLV BODY TEMP
 							return(scale_data(0,0,200));
 						case 38:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 39:		// H2 TK 2 PRESS
-							sat->GetTankPressures( smTankPress );
-							return(scale_data(smTankPress.H2Tank2PressurePSI, 0, 350));
+							smTankPress = snap->TankPress();
+							return(scale_data(smTankPress->H2Tank2PressurePSI, 0, 350));
 
 						case 40:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 41:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 42:		// O2 TK 2 QTY
-							sat->GetTankQuantities( tankQuantities );
-							return(scale_data(tankQuantities.O2Tank2Quantity * 100.0, 0, 100));
+							tankQuantities = snap->TankQuant();
+							return(scale_data(tankQuantities->O2Tank2Quantity * 100.0, 0, 100));
 						case 43:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 44:		// OX LINE 1 TEMP
 							return(scale_data(0,0,200));
 						case 45:		// SUIT AIR HX OUT TEMP
-							sat->GetAtmosStatus( atm );
-							return(scale_data(atm.SuitTempF, 20, 95));
+							atm = snap->Atmos();
+							return(scale_data(atm->SuitTempF, 20, 95));
 						case 46:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 47:		// SPS INJECTOR FLANGE TEMP 1
@@ -1002,8 +1212,8 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 50:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 51:		// FC 1 COND EXH TEMP
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data( fcStatus.CondenserTempF, 145, 250));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data( fcStatus->CondenserTempF, 145, 250));
 						case 52:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 53:		// UNKNOWN - HBR ONLY
@@ -1034,37 +1244,37 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 65:		// SIDE HS BOND LOC 1 TEMP
 							return(scale_data(0,-260,600));
 						case 66:		// O2 TK 2 PRESS
-							sat->GetTankPressures( smTankPress );
-							return(scale_data(smTankPress.O2Tank2PressurePSI, 50, 1050));
+							smTankPress = snap->TankPress();
+							return(scale_data(smTankPress->O2Tank2PressurePSI, 50, 1050));
 						case 67:		// FC 3 RAD IN TEMP
 							return(scale_data(0,-50,300));
 						case 68:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 69:		// FC 3 COND EXH TEMP
-							sat->GetFuelCellStatus( 3, fcStatus );
-							return(scale_data(fcStatus.CondenserTempF, 145, 250));
+							fcStatus = snap->FuelCell(3);
+							return(scale_data(fcStatus->CondenserTempF, 145, 250));
 
 						case 70:		// SIDE HS BOND LOC 2 TEMP
 							return(scale_data(0,-260,600));
 						case 71:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 72:		// FC 1 SKIN TEMP
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data(fcStatus.TempF, 80, 550));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data(fcStatus->TempF, 80, 550));
 						case 73:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 74:		// SIDE HS BOND LOC 3 TEMP
 							return(scale_data(0,-260,600));
 						case 75:		// FC 2 SKIN TEMP
-							sat->GetFuelCellStatus( 2, fcStatus );
-							return(scale_data(fcStatus.TempF, 80, 550));
+							fcStatus = snap->FuelCell(2);
+							return(scale_data(fcStatus->TempF, 80, 550));
 						case 76:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 77:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 78:		// FC 3 SKIN TEMP
-							sat->GetFuelCellStatus( 3, fcStatus );
-							return(scale_data(fcStatus.TempF, 80, 550));
+							fcStatus = snap->FuelCell(3);
+							return(scale_data(fcStatus->TempF, 80, 550));
 						case 79:		// SIDE HS BOND LOC 4 TEMP
 							return(scale_data(0,-260,600));
 
@@ -1077,23 +1287,23 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 83:		// PIPA +120 VDC
 							return(scale_data(0,85,135));
 						case 84:		// CABIN TEMP
-							sat->GetAtmosStatus(atm);
-							return(scale_data(atm.CabinTempF, 40, 125));
+							atm = snap->Atmos();
+							return(scale_data(atm->CabinTempF, 40, 125));
 						case 85:		// 3.2 KHz 28V SUPPLY
 							return(scale_data(0,0,31.1));
 						case 86:		// INVERTER 1 TEMP
 							return(scale_data(0,32,248));
 						case 87:		// SEC RAD IN TEMP
-							sat->GetSecECSCoolingStatus(scs);
-							return(scale_data(scs.RadiatorInletTempF, 55, 120));
+							scs = snap->SecECSCooling();
+							return(scale_data(scs->RadiatorInletTempF, 55, 120));
 						case 88:		// INVERTER 2 TEMP
 							return(scale_data(0,32,248));
 						case 89:		// INVERTER 3 TEMP
 							return(scale_data(0,32,248));
 
 						case 90:		// SEC RAD OUT TEMP
-							sat->GetSecECSCoolingStatus(scs);
-							return(scale_data(scs.RadiatorOutletTempF, 30, 70));
+							scs = snap->SecECSCooling();
+							return(scale_data(scs->RadiatorOutletTempF, 30, 70));
 						case 91:		// IMU 28 VAC 800Hz
 							return(scale_data(0,0,31.1));
 						case 92:		// UNKNOWN - HBR ONLY
@@ -1149,16 +1359,16 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 116:		// SCI EXP #11
 							return(scale_data(0,0,100));
 						case 117:		// SPS FU FEED LINE TEMP
-							sat->GetSPSStatus(spsStatus);
-							return(scale_data(spsStatus.PropellantLineTempF,0,200));
+							spsStatus = snap->SPS();
+							return(scale_data(spsStatus->PropellantLineTempF,0,200));
 						case 118:		// SCI EXP #12
 							return(scale_data(0,0,100));
 						case 119:		// SCI EXP #13
 							return(scale_data(0,0,100));
 
 						case 120:		// SPS OX FEED LINE TEMP
-							sat->GetSPSStatus(spsStatus);
-							return(scale_data(spsStatus.OxidizerLineTempF,0,200));
+							spsStatus = snap->SPS();
+							return(scale_data(spsStatus->OxidizerLineTempF,0,200));
 						case 121:		// SCI EXP #14
 							return(scale_data(0,0,100));
 						case 122:		// SCI EXP #15
@@ -1170,35 +1380,35 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 125:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 126:		// FC 1 RAD OUT TEMP
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data(fcStatus.RadiatorTempOutF, -50, 300));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data(fcStatus->RadiatorTempOutF, -50, 300));
 						case 127:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 128:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 129:		// FC 2 RAD OUT TEMP
-							sat->GetFuelCellStatus( 2, fcStatus );
-							return(scale_data(fcStatus.RadiatorTempOutF, -50, 300));
+							fcStatus = snap->FuelCell(2);
+							return(scale_data(fcStatus->RadiatorTempOutF, -50, 300));
 
 						case 130:		// FC 1 RAD IN TEMP
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data(fcStatus.RadiatorTempInF, -50, 300));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data(fcStatus->RadiatorTempInF, -50, 300));
 						case 131:		// FC 1 RAD IN TEMP
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data(fcStatus.RadiatorTempInF, -50, 300));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data(fcStatus->RadiatorTempInF, -50, 300));
 						case 132:		// FC 3 RAD OUT TEMP
-							sat->GetFuelCellStatus( 3, fcStatus );
-							return(scale_data(fcStatus.RadiatorTempOutF, -50, 300));
+							fcStatus = snap->FuelCell(3);
+							return(scale_data(fcStatus->RadiatorTempOutF, -50, 300));
 						case 133:		// GLY EVAP OUT STEAM TEMP
-							sat->GetPrimECSCoolingStatus(pcs);
-							return(scale_data(pcs.EvaporatorOutletTempF,20,95));
+							pcs = snap->PrimECSCooling();
+							return(scale_data(pcs->EvaporatorOutletTempF,20,95));
 						case 134:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 135:		// URINE DUMP NOZZLE TEMP
 							return(scale_data(0,0,100));
 						case 136:		// SM ENG PKG A TEMP
-							sat->GetRCSStatus( RCS_SM_QUAD_A, rcsStatus );
-							return(scale_data(rcsStatus.PackageTempF, 0, 300));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_A);
+							return(scale_data(rcsStatus->PackageTempF, 0, 300));
 
 						case 137:		// BAY 3 OX TK SURFACE TEMP
 							return(scale_data(0,-100,200));
@@ -1216,23 +1426,23 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 143:		// OX LINE ENTRY SUMP TK TEMP
 							return(scale_data(0,-100,200));
 						case 144:		// H2 TK 2 QTY
-							sat->GetTankQuantities( tankQuantities );
-							return(scale_data(tankQuantities.H2Tank2Quantity * 100.0, 0, 100));
+							tankQuantities = snap->TankQuant();
+							return(scale_data(tankQuantities->H2Tank2Quantity * 100.0, 0, 100));
 						case 145:		// FU LINE ENTRY SUMP TK TEMP
 							return(scale_data(0,-100,200));
 						case 146:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 147:		// O2 TK 1 QTY
-							sat->GetTankQuantities( tankQuantities );
-							return(scale_data(tankQuantities.O2Tank1Quantity * 100.0, 0, 100));
+							tankQuantities = snap->TankQuant();
+							return(scale_data(tankQuantities->O2Tank1Quantity * 100.0, 0, 100));
 						case 148:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 149:		// DOSIMETER RATE
 							return(scale_data(0,0,5));
 
 						case 150:		// O2 TK 1 PRESS
-							sat->GetTankPressures( smTankPress );
-							return(scale_data(smTankPress.O2Tank1PressurePSI, 50, 1050));
+							smTankPress = snap->TankPress();
+							return(scale_data(smTankPress->O2Tank1PressurePSI, 50, 1050));
 
 						default:
 							sprintf(sat->debugString(),"MEASURE: UNKNOWN 10-A-%d",ccode);
@@ -1242,31 +1452,31 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 				case 11: // S11A
 					switch(ccode){
 						case 1:			// SUIT MANF ABS PRESS
-							sat->GetAtmosStatus(atm);
-							return(scale_data(atm.SuitPressurePSI, 0, 17));
+							atm = snap->Atmos();
+							return(scale_data(atm->SuitPressurePSI, 0, 17));
 						case 2:			// SUIT COMP DELTA P
-							sat->GetAtmosStatus(atm);
+							atm = snap->Atmos();
 							// Suit compressor pressure difference
-							return(scale_data(atm.SuitPressurePSI - atm.SuitReturnPressurePSI, 0, 1));
+							return(scale_data(atm->SuitPressurePSI - atm->SuitReturnPressurePSI, 0, 1));
 						case 3:			// GLY PUMP OUT PRESS
 							return(scale_data(0,0,60));
 						case 4:			// ECS SURGE TANK PRESS
-							sat->GetTankPressures( smTankPress );
-							return(scale_data(smTankPress.O2SurgeTankPressurePSI, 50, 1050));
+							smTankPress = snap->TankPress();
+							return(scale_data(smTankPress->O2SurgeTankPressurePSI, 50, 1050));
 						case 5:			// PYRO BUS B VOLTS
-							sat->GetPyroStatus( pyroStatus );
-							return(scale_data(pyroStatus.BusBVoltage, 0, 40 ));
+							pyroStatus = snap->Pyro();
+							return(scale_data(pyroStatus->BusBVoltage, 0, 40 ));
 						case 6:			// LES LOGIC BUS B VOLTS
-							sat->GetSECSStatus( secsStatus );
-							return(scale_data( secsStatus.BusBVoltage, 0, 40 ));
+							secsStatus = snap->SECS();
+							return(scale_data( secsStatus->BusBVoltage, 0, 40 ));
 						case 7:			// UNKNOWN - HBR ONLY
 							return(0);
 						case 8:			// LES LOGIC BUS A VOLTS
-							sat->GetSECSStatus( secsStatus );
-							return(scale_data( secsStatus.BusBVoltage, 0, 40 ));
+							secsStatus = snap->SECS();
+							return(scale_data( secsStatus->BusBVoltage, 0, 40 ));
 						case 9:			// PYRO BUS A VOLTS
-							sat->GetSECSStatus( secsStatus );
-							return(scale_data( secsStatus.BusAVoltage, 0, 40 ));
+							secsStatus = snap->SECS();
+							return(scale_data( secsStatus->BusAVoltage, 0, 40 ));
 
 						case 10:		// SPS HE TK PRESS
 							return(scale_data(sat->GetSPSPropellant()->GetHeliumPressurePSI(), 0, 5000));
@@ -1296,21 +1506,21 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 22:		// CM HE MANIF 2 PRESS
 							return(scale_data(0,0,400));
 						case 23:		// SM OX MANF A PRESS
-							sat->GetRCSStatus( RCS_SM_QUAD_A, rcsStatus );
-							return(scale_data(rcsStatus.PropellantPressurePSI, 0, 300));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_A);
+							return(scale_data(rcsStatus->PropellantPressurePSI, 0, 300));
 						case 24:		// SM OX MANF B PRESS
-							sat->GetRCSStatus( RCS_SM_QUAD_B, rcsStatus );
-							return(scale_data(rcsStatus.PropellantPressurePSI, 0, 300));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_B);
+							return(scale_data(rcsStatus->PropellantPressurePSI, 0, 300));
 						case 25:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 26:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 27:		// SM OX MANF C PRESS
-							sat->GetRCSStatus( RCS_SM_QUAD_C, rcsStatus );
-							return(scale_data(rcsStatus.PropellantPressurePSI,0,300));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_C);
+							return(scale_data(rcsStatus->PropellantPressurePSI,0,300));
 						case 28:		// SM OX MANF D PRESS
-							sat->GetRCSStatus( RCS_SM_QUAD_D, rcsStatus );
-							return(scale_data(rcsStatus.PropellantPressurePSI, 0, 300));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_D);
+							return(scale_data(rcsStatus->PropellantPressurePSI, 0, 300));
 						case 29:		// FC 1 N2 PRESS
 							return(scale_data(0,0,75));
 
@@ -1329,8 +1539,8 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 36:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 37:		// SUIT-CABIN DELTA PRESS
-							sat->GetAtmosStatus( atm );
-							return(scale_data((atm.SuitPressureMMHG - atm.CabinPressureMMHG) / 25.4, -5, 5));
+							atm = snap->Atmos();
+							return(scale_data((atm->SuitPressureMMHG - atm->CabinPressureMMHG) / 25.4, -5, 5));
 						case 38:		// ALPHA CT RATE CHAN 1
 							return(scale_data(0,0.1,10000));
 						case 39:		// SM HE MANF A PRESS
@@ -1370,14 +1580,14 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 55:		// O2 SUPPLY MANF PRESS
 							return(scale_data(0,0,150));
 						case 56:		// AC BUS 2 PH A VOLTS
-							sat->GetACBusStatus( acStat, 2 );
-							return(scale_data(acStat.Phase1Voltage, 0, 150));
+							acStat = snap->ACBus(2);
+							return(scale_data(acStat->Phase1Voltage, 0, 150));
 						case 57:		// MAIN BUS A VOLTS
-							sat->GetMainBusStatus( mainBusStatus );
-							return(scale_data(mainBusStatus.MainBusAVoltage, 0, 45));
+							mainBusStatus = snap->MainBus();
+							return(scale_data(mainBusStatus->MainBusAVoltage, 0, 45));
 						case 58:		// MAIN BUS B VOLTS
-							sat->GetMainBusStatus( mainBusStatus );
-							return(scale_data(mainBusStatus.MainBusBVoltage, 0, 45));
+							mainBusStatus = snap->MainBus();
+							return(scale_data(mainBusStatus->MainBusBVoltage, 0, 45));
 						case 59:		// IG 1X RSVR OUT COS
 							return(scale_data(0,130,50));
 
@@ -1396,63 +1606,63 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 66:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 67:		// FC 1 O2 PRESS
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data(fcStatus.O2PressurePSI, 0, 75));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data(fcStatus->O2PressurePSI, 0, 75));
 						case 68:		// FC 2 O2 PRESS
-							sat->GetFuelCellStatus( 2, fcStatus );
-							return(scale_data(fcStatus.O2PressurePSI, 0, 75));
+							fcStatus = snap->FuelCell(2);
+							return(scale_data(fcStatus->O2PressurePSI, 0, 75));
 						case 69:		// FC 3 O2 PRESS
-							sat->GetFuelCellStatus( 3, fcStatus );
-							return(scale_data(fcStatus.O2PressurePSI, 0, 75));
+							fcStatus = snap->FuelCell(3);
+							return(scale_data(fcStatus->O2PressurePSI, 0, 75));
 
 						case 70:		// FC 1 H2 PRESS
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data(fcStatus.H2PressurePSI, 0, 75));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data(fcStatus->H2PressurePSI, 0, 75));
 						case 71:		// FC 2 H2 PRESS
-							sat->GetFuelCellStatus( 2, fcStatus );
-							return(scale_data(fcStatus.H2PressurePSI, 0, 75));
+							fcStatus = snap->FuelCell(2);
+							return(scale_data(fcStatus->H2PressurePSI, 0, 75));
 						case 72:		// FC 3 H2 PRESS
-							sat->GetFuelCellStatus( 3, fcStatus );
-							return(scale_data(fcStatus.H2PressurePSI, 0, 75));
+							fcStatus = snap->FuelCell(3);
+							return(scale_data(fcStatus->H2PressurePSI, 0, 75));
 						case 73:		// BAT CHARGER AMPS
-							sat->GetBatteryStatus( batteryStatus );
-							return(scale_data(batteryStatus.BatteryChargerCurrent, 0, 5));
+							batteryStatus = snap->Battery();
+							return(scale_data(batteryStatus->BatteryChargerCurrent, 0, 5));
 						case 74:		// BAT A CUR
-							sat->GetBatteryStatus( batteryStatus );
-							return(scale_data( batteryStatus.BatteryACurrent, 0, 100));
+							batteryStatus = snap->Battery();
+							return(scale_data( batteryStatus->BatteryACurrent, 0, 100));
 						case 75:		// BAT RELAY BUS VOLTS
-							sat->GetBatteryBusStatus(batBusStat);
-							return(scale_data(batBusStat.BatteryRelayBusVoltage,0,45));
+							batBusStat = snap->BatteryBus();
+							return(scale_data(batBusStat->BatteryRelayBusVoltage,0,45));
 						case 76:		// FC 1 CUR
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data(fcStatus.Current, 0, 100));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data(fcStatus->Current, 0, 100));
 						case 77:		// FC 1 H2 FLOW
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data(fcStatus.H2FlowLBH, 0, 0.2));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data(fcStatus->H2FlowLBH, 0, 0.2));
 						case 78:		// FC 2 H2 FLOW
-							sat->GetFuelCellStatus( 2, fcStatus );
-							return(scale_data(fcStatus.H2FlowLBH, 0, 0.2));
+							fcStatus = snap->FuelCell(2);
+							return(scale_data(fcStatus->H2FlowLBH, 0, 0.2));
 						case 79:		// FC 3 H2 FLOW
-							sat->GetFuelCellStatus( 3, fcStatus );
-							return(scale_data(fcStatus.H2FlowLBH, 0, 0.2));
+							fcStatus = snap->FuelCell(3);
+							return(scale_data(fcStatus->H2FlowLBH, 0, 0.2));
 
 						case 80:		// FC 1 O2 FLOW
-							sat->GetFuelCellStatus( 1, fcStatus );
-							return(scale_data(fcStatus.O2FlowLBH, 0, 1.6));
+							fcStatus = snap->FuelCell(1);
+							return(scale_data(fcStatus->O2FlowLBH, 0, 1.6));
 						case 81:		// FC 2 O2 FLOW
-							sat->GetFuelCellStatus( 2, fcStatus );
-							return(scale_data(fcStatus.O2FlowLBH, 0, 1.6));
+							fcStatus = snap->FuelCell(2);
+							return(scale_data(fcStatus->O2FlowLBH, 0, 1.6));
 						case 82:		// FC 3 O2 FLOW
-							sat->GetFuelCellStatus( 3, fcStatus );
-							return(scale_data(fcStatus.O2FlowLBH, 0, 1.6));
+							fcStatus = snap->FuelCell(3);
+							return(scale_data(fcStatus->O2FlowLBH, 0, 1.6));
 						case 83:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 84:		// FC 2 CUR
-							sat->GetFuelCellStatus( 2, fcStatus );
-							return(scale_data(fcStatus.Current, 0, 100));
+							fcStatus = snap->FuelCell(2);
+							return(scale_data(fcStatus->Current, 0, 100));
 						case 85:		// FC 3 CUR
-							sat->GetFuelCellStatus( 3, fcStatus );
-							return(scale_data(fcStatus.Current, 0, 100));
+							fcStatus = snap->FuelCell(3);
+							return(scale_data(fcStatus->Current, 0, 100));
 						case 86:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 87:		// PRI GLY FLOW RATE
@@ -1465,13 +1675,13 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 90:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 91:		// BAT BUS A VOLTS
-							sat->GetBatteryBusStatus( batBusStat );
-							return(scale_data(batBusStat.BatBusAVoltage, 0, 45));
+							batBusStat = snap->BatteryBus();
+							return(scale_data(batBusStat->BatBusAVoltage, 0, 45));
 						case 92:		// SM FU MANF A PRESS
 							return(scale_data(0,0,400));
 						case 93:		// BAT BUS B VOLTS
-							sat->GetBatteryBusStatus( batBusStat );
-							return(scale_data(batBusStat.BatBusBVoltage, 0, 45));
+							batBusStat = snap->BatteryBus();
+							return(scale_data(batBusStat->BatBusBVoltage, 0, 45));
 						case 94:		// SM FU MANF B PRESS
 							return(scale_data(0,0,400));
 						case 95:		// UNKNOWN - HBR ONLY
@@ -1504,12 +1714,12 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 108:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 109:		// BAT B CUR
-							sat->GetBatteryStatus( batteryStatus );
-							return(scale_data(batteryStatus.BatteryBCurrent, 0, 100));
+							batteryStatus = snap->Battery();
+							return(scale_data(batteryStatus->BatteryBCurrent, 0, 100));
 
 						case 110:		// BAT C CUR
-							sat->GetBatteryStatus( batteryStatus );
-							return(scale_data(batteryStatus.BatteryCCurrent, 0, 100));
+							batteryStatus = snap->Battery();
+							return(scale_data(batteryStatus->BatteryCCurrent, 0, 100));
 						case 111:		// SM FU MANF C PRESS
 							return(scale_data(0,0,400));
 						case 112:		// SM FU MANF D PRESS
@@ -1525,8 +1735,8 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 117:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 118:		// SEC EVAP OUT LIQ TEMP
-							sat->GetSecECSCoolingStatus(scs);
-							return(scale_data(scs.EvaporatorOutletTempF, 25, 75));
+							scs = snap->SecECSCooling();
+							return(scale_data(scs->EvaporatorOutletTempF, 25, 75));
 						case 119:		// SENSOR EXCITATION 5V
 							return(scale_data(0,0,9));
 
@@ -1549,8 +1759,8 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 128:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 129:		// SEC GLY ACCUM QTY
-							sat->GetSecECSCoolingStatus(scs);
-							return(scale_data(scs.AccumulatorQuantityPercent, 0, 100));
+							scs = snap->SecECSCooling();
+							return(scale_data(scs->AccumulatorQuantityPercent, 0, 100));
 
 						case 130:		// SM HE MANF D PRESS
 							return(scale_data(0,0,400));
@@ -1588,8 +1798,8 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 146:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 147:		// AC BUS 1 PH A VOLTS
-							sat->GetACBusStatus( acStat, 1 );
-							return(scale_data(acStat.Phase1Voltage, 0, 150));
+							acStat = snap->ACBus(1);
+							return(scale_data(acStat->Phase1Voltage, 0, 150));
 						case 148:		// SCE POS SUPPLY VOLTS
 							return(scale_data(0,0,30));
 						case 149:		// UNKNOWN - HBR ONLY
@@ -1606,12 +1816,12 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 154:		// SCE NEG SUPPLY VOLTS
 							return(scale_data(0, -30, 0));
 						case 155:		// CM HE TK A TEMP
-							sat->GetRCSStatus( RCS_CM_RING_1, rcsStatus );
-							return(scale_data(rcsStatus.HeliumTempF, 0, 300));
+							rcsStatus = snap->RCS(RCS_CM_RING_1);
+							return(scale_data(rcsStatus->HeliumTempF, 0, 300));
 
 						case 156:		// CM HE TK B TEMP
-							sat->GetRCSStatus( RCS_CM_RING_2, rcsStatus );
-							return(scale_data(rcsStatus.HeliumTempF, 0, 300));
+							rcsStatus = snap->RCS(RCS_CM_RING_2);
+							return(scale_data(rcsStatus->HeliumTempF, 0, 300));
 
 						case 157:		// SEC GLY PUMP OUT PRESS
 							return(scale_data(0,0,60));
@@ -1627,17 +1837,17 @@ unsigned char PCM::measure(int channel, int type, int ccode){
 						case 162:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 163:		// SM HE TK A TEMP
-							sat->GetRCSStatus( RCS_SM_QUAD_A, rcsStatus );
-							return(scale_data(rcsStatus.HeliumTempF, 0, 100));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_A);
+							return(scale_data(rcsStatus->HeliumTempF, 0, 100));
 						case 164:		// SM HE TK B TEMP
-							sat->GetRCSStatus( RCS_SM_QUAD_B, rcsStatus );
-							return(scale_data(rcsStatus.HeliumTempF, 0, 100));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_B);
+							return(scale_data(rcsStatus->HeliumTempF, 0, 100));
 						case 165:		// SM HE TK C TEMP
-							sat->GetRCSStatus( RCS_SM_QUAD_C, rcsStatus );
-							return(scale_data(rcsStatus.HeliumTempF, 0, 100));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_C);
+							return(scale_data(rcsStatus->HeliumTempF, 0, 100));
 						case 166:		// SM HE TK D TEMP
-							sat->GetRCSStatus( RCS_SM_QUAD_D, rcsStatus );
-							return(scale_data(rcsStatus.HeliumTempF, 0, 100));
+							rcsStatus = snap->RCS(RCS_SM_QUAD_D);
+							return(scale_data(rcsStatus->HeliumTempF, 0, 100));
 						case 167:		// UNKNOWN - HBR ONLY
 							return(0);
 						case 168:		// UNKNOWN - HBR ONLY
@@ -2553,18 +2763,6 @@ void PCM::generate_stream_lbr(){
 			tx_data[tx_offset] = 0;
 			break;
 	}
-	word_addr++;
-	if(word_addr > 39){
-		word_addr = 0;
-		frame_addr++;
-		if(frame_addr > 4){
-			frame_addr = 0;
-		}
-		frame_count++;
-		if(frame_count > 5){
-			frame_count = 0;
-		}
-	}
 }
 
 void PCM::generate_stream_hbr(){
@@ -3644,18 +3842,6 @@ void PCM::generate_stream_hbr(){
 			tx_data[tx_offset] = 0;
 			break;
 	}
-	word_addr++;
-	if(word_addr > 127){
-		word_addr = 0;
-		frame_addr++;
-		if(frame_addr > 49){
-			frame_addr = 0;
-		}
-		frame_count++;
-		if(frame_count > 4){
-			frame_count = 0;
-		}
-	}
 }
 
 void PCM::perform_io(double simt){
@@ -3697,34 +3883,9 @@ void PCM::perform_io(double simt){
 			// Otherwise loop and try again.
 			break;
 		case 2: // CONNECTED			
-			int bytesSent,bytesRecv;
-
-			bytesSent = send(AcceptSocket, (char *)tx_data, tx_size, 0 );
-			if(bytesSent == SOCKET_ERROR){
-				long errnumber = WSAGetLastError();
-				switch(errnumber){
-					// KNOWN CODES that we can ignore
-					case 10035: // Operation Would Block
-						// We can ignore this entirely. It's not an error.
-						break;
+			int bytesRecv;
 
-					case 10038: // Socket isn't a socket
-					case 10053: // Software caused connection abort
-					case 10054: // Connection reset by peer
-						closesocket(AcceptSocket);
-						conn_state = 1; // Accept another
-						uplink_state = 0; rx_offset = 0;
-						break;
-
-					default:           // If unknown
-						wsk_error = 1; // do this
-						sprintf(wsk_emsg,"TELECOM: send() failed: %ld",errnumber);
-						closesocket(AcceptSocket);
-						conn_state = 1; // Accept another
-						uplink_state = 0; rx_offset = 0;
-						break;					
-				}
-			}
+			// The downlink goes out in SendDownlink, at the end of the Orbiter timestep
 			// Should we recieve?
 			if ((fabs(simt - last_rx) / 0.005) < 1 || sat->agc.IsUpruptActive()) {			
 				return; // No
@@ -3798,6 +3959,63 @@ void PCM::perform_io(double simt){
 	}
 }
 
+// Called once at the end of each Orbiter timestep, after the last TimeStep of
+// it, so the words generated in a timestep go out in that timestep.
+void PCM::SendDownlink(){
+	if(conn_state != 2 || tx_size == 0){
+		return;
+	}
+	if(send_downlink() == SOCKET_ERROR){
+		long errnumber = WSAGetLastError();
+		switch(errnumber){
+			// KNOWN CODES that we can ignore
+			case 10035: // Operation Would Block
+				// We can ignore this entirely. It's not an error.
+				break;
+
+			case 10038: // Socket isn't a socket
+			case 10053: // Software caused connection abort
+			case 10054: // Connection reset by peer
+				closesocket(AcceptSocket);
+				conn_state = 1; // Accept another
+				uplink_state = 0; rx_offset = 0;
+				break;
+
+			default:           // If unknown
+				wsk_error = 1; // do this
+				sprintf(wsk_emsg,"TELECOM: send() failed: %ld",errnumber);
+				closesocket(AcceptSocket);
+				conn_state = 1; // Accept another
+				uplink_state = 0; rx_offset = 0;
+				break;					
+		}
+	}
+}
+
+// Send as much of the ring buffer as the socket takes. It's nonblocking, so
+// whatever is left stays queued for the next timestep.
+int PCM::send_downlink(){
+	int total = 0;
+
+	while(tx_size > 0){
+		int tail = (tx_offset - tx_size) & (PCM_RING_SIZE - 1);
+		int len = PCM_RING_SIZE - tail;
+		if(len > tx_size){
+			len = tx_size;
+		}
+		int bytesSent = send(AcceptSocket, (char *)(tx_data + tail), len, 0);
+		if(bytesSent == SOCKET_ERROR){
+			return SOCKET_ERROR;
+		}
+		tx_size -= bytesSent;
+		total += bytesSent;
+		if(bytesSent < len){
+			break;
+		}
+	}
+	return total;
+}
+
 // Handle data moved to buffer from either the socket or mcc buffer
 void PCM::handle_uplink() {
 	switch (uplink_state) {
@@ -176,6 +176,13 @@
 #define TLM_E	4
 #define TLM_SRC 5
 
+// PCM downlink policy, for when the client can't take the stream at time acceleration
+#define PCM_DOWNLINK_FULL		0	// Every frame, as long as the ring buffer has room
+#define PCM_DOWNLINK_DECIMATE	1	// Whole frames at the real-time bit rate
+#define PCM_DOWNLINK_LATEST		2	// Only the latest frame of each timestep
+
+#define PCM_RING_SIZE			65536	// Downlink ring buffer, about 10 seconds at HBR
+
 // DS20060326 Telecommunications system objects
 class Saturn;
 
@@ -282,13 +289,17 @@ protected:
 	double lastEventTime;				/// Last event time.
 };
 
+struct PCMSnapshot;
+
 // PCM system
 class PCM {
 public:		
 	PCM();                          // Cons
+	~PCM();                         // Destructor
 	void Init(Saturn *vessel);	    // Initialization
 	void TimeStep(double simt);     // TimeStep
 	void SystemTimestep(double simdt); // System Timestep (consume power)
+	void SendDownlink();            // Send what this Orbiter timestep queued, at its end
 
 	// Winsock2
 	WSADATA wsaData;				// Winsock subsystem data
@@ -301,6 +312,9 @@ public:
 	void handle_uplink();	// Handle incoming data
 	void generate_stream_lbr();     // Generate LBR datastream
 	void generate_stream_hbr();     // Same for HBR datastream
+	void start_frame(double t, int words_per_frame, double word_time); // Apply the downlink policy to a new frame
+	void next_word(bool hbr);       // Advance word and frame addresses
+	int send_downlink();            // Send the ring buffer to the socket
 	unsigned char scale_data(double data, double low, double high); // Scale data for PCM transmission
 	unsigned char measure(int channel, int type, int ccode);
 
@@ -314,15 +328,22 @@ public:
 	int word_addr;                  // Word address of outgoing packet
 	int frame_addr;                 // Frame address
 	int frame_count;				// Frame counter
-	int tx_size;                    // Number of words to send
-	int tx_offset;                  // Offset to use
+	int tx_size;                    // Number of words waiting in the ring buffer
+	int tx_offset;                  // Ring buffer offset of the next word
 	int rx_offset;					// RX offset to use
 	int mcc_offset;					// RX offset into MCC data block
 	int mcc_size;					// Size of MCC data block
 	int pcm_rate_override;          // Downtelemetry rate override
-	unsigned char tx_data[1024];    // Characters to be transmitted
+	int downlink_policy;            // PCM_DOWNLINK_*
+	bool tx_skip;                   // Current frame is left out of the downlink
+	bool tx_overflow;               // Current frame is left out because the ring buffer is full
+	unsigned long tx_frames;        // Frames put into the downlink
+	unsigned long tx_dropped;       // Frames left out by the policy or a full ring buffer
+	unsigned long tx_lost;          // Of those, frames lost because the client didn't keep up
+	unsigned char tx_data[PCM_RING_SIZE]; // Characters to be transmitted
 	unsigned char rx_data[1024];    // Characters recieved
 	unsigned char mcc_data[1024];	// MCC-provided incoming data
+	PCMSnapshot *snap;				// Status data for the telemetry words
 
 	bool registerSocket(SOCKET sock);
 
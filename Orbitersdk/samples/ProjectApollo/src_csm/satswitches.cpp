@@ -1078,6 +1078,13 @@ void SaturnEcsGlycolPumpsSwitch::LoadState(char *line)
 	CheckPump();
 }
 
+void SaturnEcsGlycolPumpsSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	RotationalSwitch::LoadCheckpoint(cp);
+	CheckPump();
+}
+
 void SaturnEcsGlycolPumpsSwitch::CheckPump()
 
 {
@@ -1195,6 +1202,13 @@ void BMAGPowerRotationalSwitch::LoadState(char *line)
 	CheckBMAGPowerState();
 }
 
+void BMAGPowerRotationalSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	RotationalSwitch::LoadCheckpoint(cp);
+	CheckBMAGPowerState();
+}
+
 
 void SaturnSPSPercentMeter::Init(SURFHANDLE blackFontSurf, SURFHANDLE whiteFontSurf, SwitchRow &row, Saturn *s)
 
@@ -1652,6 +1666,13 @@ void FDAIPowerRotationalSwitch::LoadState(char *line)
 	CheckFDAIPowerState();
 }
 
+void FDAIPowerRotationalSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	RotationalSwitch::LoadCheckpoint(cp);
+	CheckFDAIPowerState();
+}
+
 
 //
 // CMACInverterSwitch allows you to connect the CM AC inverters to the CM AC busses.
@@ -1819,6 +1840,13 @@ void CMACInverterSwitch::LoadState(char *line)
 	UpdateSourceState();
 }
 
+void CMACInverterSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	ToggleSwitch::LoadCheckpoint(cp);
+	UpdateSourceState();
+}
+
 
 /*bool SaturnSCContSwitch::CheckMouseClick(int event, int mx, int my) 
 
@@ -2137,6 +2165,18 @@ void SaturnCabinPressureReliefLever::LoadState(char *line) {
 	}
 }
 
+void SaturnCabinPressureReliefLever::SaveCheckpoint(Checkpoint &cp) {
+
+	ThumbwheelSwitch::SaveCheckpoint(cp);
+	cp.Put(guardState);
+}
+
+void SaturnCabinPressureReliefLever::LoadCheckpoint(Checkpoint &cp) {
+
+	ThumbwheelSwitch::LoadCheckpoint(cp);
+	cp.Get(guardState);
+}
+
 
 void OpticsHandcontrollerSwitch::Init(int xp, int yp, int w, int h, SURFHANDLE surf, SURFHANDLE bsurf, SwitchRow &row, Saturn *s) {
 
@@ -2435,6 +2475,18 @@ void OrdealRotationalSwitch::LoadState(char *line) {
 	}
 }
 
+void OrdealRotationalSwitch::SaveCheckpoint(Checkpoint &cp) {
+
+	RotationalSwitch::SaveCheckpoint(cp);
+	cp.Put(value);
+}
+
+void OrdealRotationalSwitch::LoadCheckpoint(Checkpoint &cp) {
+
+	RotationalSwitch::LoadCheckpoint(cp);
+	cp.Get(value);
+}
+
 double SaturnHighGainAntennaPitchMeter::QueryValue(){
 	if (Sat->hga.IsPowered())
 	{
@@ -408,6 +408,7 @@ public:
 			  CircuitBrakerSwitch* ac2a, CircuitBrakerSwitch* ac2b, CircuitBrakerSwitch* ac2c);
 	virtual bool SwitchTo(int newValue);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 
 protected:
 	void CheckPump();
@@ -521,6 +522,7 @@ public:
 
 	virtual bool SwitchTo(int newValue);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 
 protected:
 	void CheckBMAGPowerState();
@@ -645,6 +647,7 @@ public:
 
 	virtual bool SwitchTo(int newValue);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 
 protected:
 	void CheckFDAIPowerState();
@@ -664,6 +667,7 @@ public:
 	void Init(int xp, int yp, int w, int h, SURFHANDLE surf, SURFHANDLE bsurf, SwitchRow &row,int bus,int inv,Saturn *ship);
 	virtual bool SwitchTo(int newState, bool dontspring = true);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 	virtual void UpdateSourceState();
 
 protected:
@@ -829,6 +833,8 @@ public:
 	bool CheckMouseClick(int event, int mx, int my);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(char *line);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	virtual bool SwitchTo(int newState);
 
 protected:
@@ -902,6 +908,8 @@ public:
 	virtual bool CheckMouseClick(int event, int mx, int my);
 	virtual void SaveState(FILEHANDLE scn);
 	virtual void LoadState(char *line);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	int GetValue() { return value; }
 
 protected:
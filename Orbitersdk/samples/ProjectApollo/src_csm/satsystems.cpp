@@ -514,10 +514,19 @@ void Saturn::SystemsTimestep(double simt, double simdt, double mjd) {
 	else if (stage >= PRELAUNCH_STAGE) {
 
 		//
-		// Timestep the internal systems, there can be multiple systems timesteps in one Orbiter timestep
+		// Timestep the internal systems, there can be multiple systems timesteps in one Orbiter timestep.
+		// When pipelined, the AGC runs on its own thread meanwhile, and its output channels and
+		// telemetry are passed on in FinishTimestep.
 		//
 
-		SystemsInternalTimestep(simdt);
+		if (agc.IsPipelined()) {
+			agc.StartTimestep(MissionTime, simdt);
+			SystemsInternalTimestep(simdt);
+			agc.FinishTimestep();
+			CheckpointTimestep();
+		}
+		else
+			SystemsInternalTimestep(simdt);
 
 		//
 		// Do the "normal" Orbiter timestep, some devices are done in clbkPostStep
@@ -525,7 +534,13 @@ void Saturn::SystemsTimestep(double simt, double simdt, double mjd) {
 
 		dsky.Timestep(MissionTime);
 		dsky2.Timestep(MissionTime);
-		agc.Timestep(MissionTime, simdt);
+		if (!agc.IsPipelined()) {
+			agc.Timestep(MissionTime, simdt);
+
+			// With MultiThread and time acceleration the AGC may still be running on its thread
+			if (!IsMultiThread || oapiGetTimeAcceleration() <= 1.0)
+				CheckpointTimestep();
+		}
 		optics.TimeStep(simdt);
 
 		//
@@ -1147,8 +1162,8 @@ void Saturn::SystemsInternalTimestep(double simdt)
 {
 	TRACESETUP("Saturn::SystemsInternalTimestep");
 
-	double mintFactor = __max(simdt / 100.0, 0.5);
-	double tFactor = __min(mintFactor, simdt);
+	double frame = simdt;
+	double tFactor = __min(Panelsdk.GetSubstep(frame), simdt);
 	while (simdt > 0) {
 
 		// Each timestep is passed to the SPSDK
@@ -1195,9 +1210,10 @@ void Saturn::SystemsInternalTimestep(double simdt)
 		CabinFansSystemTimestep();
 
 		simdt -= tFactor;
-		tFactor = __min(mintFactor, simdt);
+		tFactor = __min(Panelsdk.GetSubstep(frame), simdt);
 		TRACE("Internal timestep done");
 	}
+	Panelsdk.EndTimestep();
 }
 
 void Saturn::JoystickTimestep()
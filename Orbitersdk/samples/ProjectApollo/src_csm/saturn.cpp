@@ -685,6 +685,7 @@ void Saturn::initSaturn()
 	FovExternal = 0;
 	FovSave = 0;
 	FovSaveExternal = 0;
+	maxTimeAcceleration = 0;
 
 	//
 	// Save the last view offset set.
@@ -1282,10 +1283,187 @@ void Saturn::clbkPostStep (double simt, double simdt, double mjd)
 	MainPanel.timestep(MissionTime);
 	checkControl.timestep(MissionTime,eventControl);
 
+	// All of this timestep's telemetry has been generated by now
+	pcm.SendDownlink();
+
 	sprintf(buffer, "End time(0) %lld", time(0)); 
 	TRACE(buffer);
 }
 
+void Saturn::CheckpointTimestep()
+
+{
+	//
+	// Staging changes the vessel, so the checkpoints from before it are no use.
+	//
+
+	if (Checkpoints.Count() > 0 && Checkpoints.Newest(0)->Stage != stage)
+		Checkpoints.Clear();
+	if (!GenericFirstTimestep && Checkpoints.Due(MissionTime))
+		SaveCheckpoint(Checkpoints.Add());
+}
+
+void Saturn::SaveCheckpoint(Checkpoint &cp)
+
+{
+	int i, n;
+	VESSELSTATUS2 vs;
+
+	cp.Clear();
+	cp.Time = MissionTime;
+	cp.Stage = stage;
+	cp.Mark(stage);
+
+	//
+	// Vessel state, without the fuel, thruster and docking lists.
+	//
+
+	memset(&vs, 0, sizeof(vs));
+	vs.version = 2;
+	vs.flag = 0;
+	GetStatusEx(&vs);
+	cp.Put(vs);
+
+	n = GetPropellantCount();
+	cp.Mark(n);
+	for (i = 0; i < n; i++)
+		cp.Put(GetPropellantMass(GetPropellantHandleByIndex(i)));
+
+	cp.Put(MissionTime);
+	cp.Put(NextMissionEventTime);
+	cp.Put(LastMissionEventTime);
+	cp.Put(StageState);
+	cp.Put(systemsState);
+	cp.Put(lastSystemsMissionTime);
+	cp.Put(MissionTimerDisplay.GetTime());
+	cp.Put(EventTimerDisplay.GetTime());
+
+	Panelsdk.SaveCheckpoint(cp);
+	agc.SaveCheckpoint(cp);
+	imu.SaveCheckpoint(cp);
+	PSH.SaveCheckpoint(cp);
+
+	if (stage < CSM_LEM_STAGE) {
+		iu.SaveCheckpoint(cp);
+		SaveLVDCCheckpoint(cp);
+	}
+}
+
+bool Saturn::LoadCheckpoint(Checkpoint &cp)
+
+{
+	if (cp.Empty() || cp.Stage != stage)
+		return false;
+
+	//
+	// Keep the state as it is now, to go back to if the checkpoint turns out not
+	// to fit part way through the systems.
+	//
+
+	SaveCheckpoint(CheckpointRollback);
+	if (RestoreCheckpoint(cp))
+		return true;
+
+	RestoreCheckpoint(CheckpointRollback);
+	return false;
+}
+
+bool Saturn::RestoreCheckpoint(Checkpoint &cp)
+
+{
+	int i, n;
+	double m, mtd, etd;
+	double missionTime, nextMissionEventTime, lastMissionEventTime, lastSystemsTime;
+	int stageState, sysState;
+	VESSELSTATUS2 vs;
+	std::vector<double> propellant;
+
+	cp.Rewind();
+	if (!cp.Check(stage))
+		return false;
+
+	//
+	// The vessel state and times are read first, but only set once the systems
+	// have all been restored.
+	//
+
+	cp.Get(vs);
+	vs.flag = 0;
+	vs.nfuel = 0;
+	vs.fuel = NULL;
+	vs.nthruster = 0;
+	vs.thruster = NULL;
+	vs.ndockinfo = 0;
+	vs.dockinfo = NULL;
+
+	n = GetPropellantCount();
+	if (!cp.Check(n))
+		return false;
+	for (i = 0; i < n; i++) {
+		if (cp.Get(m))
+			propellant.push_back(m);
+	}
+
+	cp.Get(missionTime);
+	cp.Get(nextMissionEventTime);
+	cp.Get(lastMissionEventTime);
+	cp.Get(stageState);
+	cp.Get(sysState);
+	cp.Get(lastSystemsTime);
+	cp.Get(mtd);
+	cp.Get(etd);
+	if (cp.Failed())
+		return false;
+
+	Panelsdk.LoadCheckpoint(cp);
+	agc.LoadCheckpoint(cp);
+	imu.LoadCheckpoint(cp);
+	PSH.LoadCheckpoint(cp);
+
+	if (stage < CSM_LEM_STAGE) {
+		iu.LoadCheckpoint(cp);
+		LoadLVDCCheckpoint(cp);
+	}
+
+	if (cp.Failed() || !cp.AtEnd())
+		return false;
+
+	DefSetStateEx(&vs);
+	for (i = 0; i < n; i++)
+		SetPropellantMass(GetPropellantHandleByIndex(i), propellant[i]);
+
+	MissionTime = missionTime;
+	NextMissionEventTime = nextMissionEventTime;
+	LastMissionEventTime = lastMissionEventTime;
+	StageState = stageState;
+	systemsState = sysState;
+	lastSystemsMissionTime = lastSystemsTime;
+	MissionTimerDisplay.SetTime(mtd);
+	EventTimerDisplay.SetTime(etd);
+	return true;
+}
+
+bool Saturn::RewindCheckpoint()
+
+{
+	Checkpoint *cp;
+	int back;
+
+	for (back = 0; (cp = Checkpoints.Newest(back)) != NULL; back++) {
+		if (cp->Time <= MissionTime - 1.0)
+			break;
+	}
+	if (cp == NULL || !LoadCheckpoint(*cp))
+		return false;
+
+	//
+	// Keep the one we went back to, so that rewinding again right away goes further back.
+	//
+
+	Checkpoints.Drop(back);
+	return true;
+}
+
 void Saturn::clbkSaveState(FILEHANDLE scn)
 
 {
@@ -1320,6 +1498,11 @@ void Saturn::clbkSaveState(FILEHANDLE scn)
 		oapiWriteScenario_int (scn, "REALISM", Realism);
 	}
 
+	if (Checkpoints.Enabled()) {
+		sprintf(str, "%d %.1f", Checkpoints.Size(), Checkpoints.Interval);
+		oapiWriteScenario_string (scn, "CHECKPOINTS", str);
+	}
+
 	if (buildstatus < 6) {
 		oapiWriteScenario_int (scn, "BUILDSTATUS", buildstatus);
 	}
@@ -1992,6 +2175,12 @@ bool Saturn::ProcessConfigFileLine(FILEHANDLE scn, char *line)
 	else if (!strnicmp (line, "REALISM", 7)) {
 		sscanf (line+7, "%d", &Realism);
 	}
+	else if (!strnicmp (line, "CHECKPOINTS", 11)) {
+		int count = 0;
+		double interval = 0;
+		sscanf (line+11, "%d %lf", &count, &interval);
+		Checkpoints.SetSize(count, interval);
+	}
 	else if (!strnicmp (line, "APOLLONO", 8)) {
 		sscanf (line+8, "%d", &ApolloNo);
 	}
@@ -2342,6 +2531,19 @@ bool Saturn::ProcessConfigFileLine(FILEHANDLE scn, char *line)
 			sscanf (line+11, "%d", &value);
 			IsMultiThread=(value>0)?true:false;
 		}
+		else if (!strnicmp (line, "AGCPIPELINE", 11)) {
+			int value;
+			sscanf (line+11, "%d", &value);
+			agc.PipelineMode = value;
+		}
+		else if (!strnicmp (line, "FLIGHTLOG", 9)) {
+			int value;
+			sscanf (line+9, "%d", &value);
+			FlightLogSetChannels(value);
+		}
+		else if (!strnicmp (line, "PCMDOWNLINK", 11)) {
+			sscanf (line+11, "%d", &pcm.downlink_policy);
+		}
 
 		else if (!strnicmp(line, "NOHGA", 5)) {
 			//
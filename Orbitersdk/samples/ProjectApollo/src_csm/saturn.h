@@ -914,6 +914,36 @@ public:
 	///
 	int GetSystemsState() { return systemsState; };
 
+	///
+	/// Take an in-memory checkpoint of the state the simulation of the spacecraft
+	/// depends on: the vessel state and propellant, the PanelSDK systems, the AGC, IMU,
+	/// panel switches and, before CSM/LV separation, the IU and LVDC. It's much quicker
+	/// than saving a scenario, but only meaningful to this vessel in this session.
+	/// \brief Save the spacecraft state to a checkpoint.
+	/// \param cp Checkpoint to save to.
+	///
+	void SaveCheckpoint(Checkpoint &cp);
+
+	///
+	/// \brief Restore the spacecraft state from a checkpoint.
+	/// \param cp Checkpoint to restore.
+	/// \return False if the checkpoint was taken at another stage or doesn't match the vessel,
+	/// in which case the vessel is left as it was.
+	///
+	bool LoadCheckpoint(Checkpoint &cp);
+
+	///
+	/// Step back to the newest periodic checkpoint at least a second older than the
+	/// current mission time, and drop any newer ones.
+	///
+	/// Not bound to a key yet: Orbiter's time goes on, but MissionTime and the AGC clock
+	/// go back with the checkpoint and aren't re-based to it, so the AGC and the RTCC
+	/// would no longer agree with the world about the time.
+	/// \brief Rewind to the last checkpoint.
+	/// \return True if there was a checkpoint to rewind to.
+	///
+	bool RewindCheckpoint();
+
 
 	///
 	/// \brief Get the Apollo mission number
@@ -3403,6 +3433,30 @@ protected:
 	bool firstSystemsTimeStepDone;
 	double lastSystemsMissionTime;
 
+	///
+	/// Checkpoints taken every so often for rewinding, set up by the CHECKPOINTS
+	/// scenario line. Off by default.
+	/// \brief Periodic checkpoints.
+	///
+	CheckpointRing Checkpoints;
+
+	///
+	/// \brief The state before a restore, put back if the restore fails.
+	///
+	Checkpoint CheckpointRollback;
+
+	///
+	/// \brief Take the periodic checkpoint if it's due. Called where the AGC is done with
+	/// its timestep, so saving the AGC doesn't wait for it.
+	///
+	void CheckpointTimestep();
+
+	///
+	/// \brief Restore a checkpoint, setting the vessel state only if all of it fits.
+	/// \return False if it didn't, in which case some of the systems may have been restored.
+	///
+	bool RestoreCheckpoint(Checkpoint &cp);
+
 	//
 	// Stage masses: should really be saved, but probably aren't at the
 	// moment.
@@ -4131,6 +4185,8 @@ protected:
 	virtual void SaveVehicleStats(FILEHANDLE scn) = 0;
 	virtual void SaveLVDC(FILEHANDLE scn) = 0;
 	virtual void LoadLVDC(FILEHANDLE scn) = 0;
+	virtual void SaveLVDCCheckpoint(Checkpoint &cp) = 0;
+	virtual void LoadLVDCCheckpoint(Checkpoint &cp) = 0;
 
 	void GetScenarioState (FILEHANDLE scn, void *status);
 	bool ProcessConfigFileLine (FILEHANDLE scn, char *line);
@@ -45,12 +45,6 @@
 #include "mcc.h"
 #include "rtcc.h"
 
-// This is a threadenwerfer. It werfs threaden.
-static DWORD WINAPI MCC_Trampoline(LPVOID ptr){	
-	MCC *mcc = (MCC *)ptr;
-	return(mcc->subThread());
-}
-
 // SCENARIO FILE MACROLOGY
 #define SAVE_BOOL(KEY,VALUE) oapiWriteScenario_int(scn, KEY, VALUE)
 #define SAVE_INT(KEY,VALUE) oapiWriteScenario_int(scn, KEY, VALUE)
@@ -77,6 +71,7 @@ MCC::MCC(){
 	MT_Enabled = false;
 	AbortMode = 0;
 	LastAOSUpdate=0;
+	PCMLost = 0;
 	// Reset ground stations
 	int x=0;
 	while(x<MAX_GROUND_STATION){
@@ -131,6 +126,7 @@ void MCC::Init(Saturn *vs){
 	
 	// GROUND TRACKING INITIALIZATION
 	LastAOSUpdate=0;
+	PCMLost = 0;
 
 	// Load ground station information.
 	// Later this can be made dynamic, but this will work for now.
@@ -559,6 +555,9 @@ void MCC::TimeStep(double simdt){
 	int x=0,y=0,z=0;				// Scratch
 	char buf[MAX_MSGSIZE];			// More Scratch
 
+	// Pick up finished calculations before the mission state checks for them
+	jobs.Poll();
+
 	/* AOS DETERMINATION */
 	
 	if(GT_Enabled == true){
@@ -664,6 +663,13 @@ void MCC::TimeStep(double simdt){
 				}
 				x++;
 			}
+
+			// Telemetry lost because the downlink client didn't keep up
+			if (cm->pcm.tx_lost > PCMLost) {
+				sprintf(buf, "TELEMETRY: %lu FRAMES LOST", cm->pcm.tx_lost - PCMLost);
+				addMessage(buf);
+			}
+			PCMLost = cm->pcm.tx_lost;
 		}
 	}
 
@@ -1853,8 +1859,7 @@ int MCC::CM_uplink_buffer() {
 // Subthread Entry Point
 int MCC::subThread(){
 	int Result = 0;
-	subThreadStatus = 2; // Running
-	
+
 	if (subThreadMode == 0)
 	{
 		Sleep(5000); // Waste 5 seconds
@@ -1867,30 +1872,38 @@ int MCC::subThread(){
 	}
 	else if (MissionType == MTP_C)
 	{
-		OBJHANDLE ves = oapiGetVesselByName("AS-205-S4BSTG");
-		if (ves != NULL)
-		{
-			rtcc->calcParams.tgt = oapiGetVesselInterface(ves); // Should be user-programmable later
-		}
 		subThreadMacro(subThreadType, subThreadMode);
 		Result = 0; // Done
 	}
-	subThreadStatus = Result;
-	// Printing messages from the subthread is not safe, but this is just for testing.
-	addMessage("Thread Completed");
-	return(0);
+	return(Result);
 }
 
 // Subthread initiation
 int MCC::startSubthread(int fcn, int type){
+	// The mission sequence waits for each update, so only one runs at a time
 	if(subThreadStatus < 1){
-		// Punt thread
+		std::vector<VesselSnapshot> snapshots;
+
 		subThreadMode = fcn;
 		subThreadType = type;
 		subThreadStatus = 1; // Busy
-		DWORD id = 0;
-		HANDLE h = CreateThread(NULL, 0, MCC_Trampoline, this, 0, &id);
-		if(h != NULL){ CloseHandle(h); }
+		if (MissionType == MTP_C)
+		{
+			OBJHANDLE ves = oapiGetVesselByName("AS-205-S4BSTG");
+			if (ves != NULL)
+			{
+				rtcc->calcParams.tgt = oapiGetVesselInterface(ves); // Should be user-programmable later
+			}
+		}
+		// The calculation uses the state of the vessels and the bodies as it is now, see RTCCSnapshotScope
+		std::shared_ptr<const OrbMech::BodySnapshot> bodies = OrbMech::TakeBodySnapshot(oapiGetSimMJD());
+		snapshots.push_back(rtcc->TakeSnapshot(rtcc->calcParams.src));
+		if (rtcc->calcParams.tgt)
+		{
+			snapshots.push_back(rtcc->TakeSnapshot(rtcc->calcParams.tgt));
+		}
+		jobs.Submit(JOB_LANE_LONG, fcn, type, [this, snapshots, bodies](Job &) { RTCCSnapshotScope scope(snapshots); OrbMech::BodySnapshotScope bodyscope(bodies.get()); return subThread(); },
+			[this](Job &job) { subThreadStatus = job.result; addMessage("Thread Completed"); });
 		addMessage("Thread Started");
 	}else{
 		addMessage("Thread Busy");
@@ -23,6 +23,8 @@
 
 #if !defined(_PA_MCC_H)
 #define _PA_MCC_H
+
+#include "jobqueue.h"
 // Save file strings
 #define MCC_START_STRING	"MCC_BEGIN"
 #define MCC_END_STRING	    "MCC_END"
@@ -629,10 +631,12 @@ public:
 	int subThreadMode;										// What should the subthread do?
 	int subThreadType;										// What type of subthread?
 	int subThreadStatus;									// 0 = done/not busy, 1 = busy, negative = done with error
+	JobQueue jobs;											// Runs the subthread
 
 	// GROUND TRACKING NETWORK
 	struct GroundStation GroundStations[MAX_GROUND_STATION]; // Ground Station Array
 	double LastAOSUpdate;									// Last update to AOS data
+	unsigned long PCMLost;									// Telemetry frames lost, as last reported
 	double CM_Position[3];                                  // CM's position and altitude
 	double CM_Prev_Position[3];                             // CM's previous position and altitude
 	double CM_MoonPosition[3];                              // CM's position and altitude relative to the Moon
@@ -44,6 +44,8 @@ See http://nassp.sourceforge.net/license/ for more details.
 #include "../src_rtccmfd/OrbMech.h"
 #include "../src_rtccmfd/EntryCalculations.h"
 #include "rtcc.h"
+#include "jobqueue.h"
+#include <algorithm>
 
 // SCENARIO FILE MACROLOGY
 #define SAVE_BOOL(KEY,VALUE) oapiWriteScenario_int(scn, KEY, VALUE)
@@ -66,6 +68,7 @@ RTCC::RTCC()
 	SplashLatitude = 0.0;
 	SplashLongitude = 0.0;
 	DeltaV_LVLH = _V(0.0, 0.0, 0.0);
+	calcParams.tgt = NULL;
 	calcParams.EI = 0.0;
 	calcParams.LOI = 0.0;
 	calcParams.TEI = 0.0;
@@ -406,7 +409,7 @@ bool RTCC::CalculationMTP_C_PRIME(int fcn, LPVOID &pad, char * upString, char *
 				double P30TIG_LOI, tcut;
 				VECTOR3 dV_LVLH_LOI;
 
-				sv.mass = calcParams.src->GetMass();
+				sv.mass = GetVesselMass(calcParams.src);
 
 				opt2.csmlmdocked = false;
 				opt2.GETbase = GETbase;
@@ -432,7 +435,7 @@ bool RTCC::CalculationMTP_C_PRIME(int fcn, LPVOID &pad, char * upString, char *
 				REFSMMAT = REFSMMATCalc(&refsopt);
 			}
 
-			engopt = SPSRCSDecision(calcParams.src->GetThrusterMax0(calcParams.src->GetGroupThruster(THGROUP_MAIN, 0)) / calcParams.src->GetMass(), dV_LVLH);
+			engopt = SPSRCSDecision(GetEngineThrust(calcParams.src, THGROUP_MAIN) / GetVesselMass(calcParams.src), dV_LVLH);
 
 			manopt.dV_LVLH = dV_LVLH;
 			manopt.engopt = engopt;
@@ -1028,7 +1031,7 @@ bool RTCC::CalculationMTP_C_PRIME(int fcn, LPVOID &pad, char * upString, char *
 		else
 		{
 
-			engopt = SPSRCSDecision(calcParams.src->GetThrusterMax0(calcParams.src->GetGroupThruster(THGROUP_MAIN, 0)) / calcParams.src->GetMass(), res.dV_LVLH);
+			engopt = SPSRCSDecision(GetEngineThrust(calcParams.src, THGROUP_MAIN) / GetVesselMass(calcParams.src), res.dV_LVLH);
 
 			if (fcn == 203 || fcn == 206)
 			{
@@ -1329,7 +1332,7 @@ bool RTCC::CalculationMTP_C(int fcn, LPVOID &pad, char * upString, char * upDesc
 		}
 		else
 		{
-			engopt = SPSRCSDecision(calcParams.src->GetThrusterMax0(calcParams.src->GetGroupThruster(THGROUP_MAIN, 0)) / calcParams.src->GetMass(), dV_LVLH);
+			engopt = SPSRCSDecision(GetEngineThrust(calcParams.src, THGROUP_MAIN) / GetVesselMass(calcParams.src), dV_LVLH);
 			opt.GETbase = getGETBase();
 			opt.vessel = calcParams.src;
 			opt.TIG = P30TIG;
@@ -1456,7 +1459,7 @@ bool RTCC::CalculationMTP_C(int fcn, LPVOID &pad, char * upString, char * upDesc
 		}
 		else
 		{
-			engopt = SPSRCSDecision(calcParams.src->GetThrusterMax0(calcParams.src->GetGroupThruster(THGROUP_MAIN, 0)) / calcParams.src->GetMass(), dV_LVLH);
+			engopt = SPSRCSDecision(GetEngineThrust(calcParams.src, THGROUP_MAIN) / GetVesselMass(calcParams.src), dV_LVLH);
 
 			opt.GETbase = getGETBase();
 			opt.vessel = calcParams.src;
@@ -1885,9 +1888,9 @@ bool RTCC::CalculationMTP_C(int fcn, LPVOID &pad, char * upString, char * upDesc
 		SV sv;
 
 		GETbase = getGETBase();
-		F = calcParams.src->GetThrusterMax0(calcParams.src->GetGroupThruster(THGROUP_MAIN, 0));
+		F = GetEngineThrust(calcParams.src, THGROUP_MAIN);
 		t_burn = 0.5;
-		m = calcParams.src->GetMass();
+		m = GetVesselMass(calcParams.src);
 		dv = F / m*t_burn;
 		gravref = AGCGravityRef(calcParams.src);
 
@@ -2220,9 +2223,9 @@ bool RTCC::CalculationMTP_C(int fcn, LPVOID &pad, char * upString, char * upDesc
 		SV sv;
 
 		GETbase = getGETBase();
-		F = calcParams.src->GetThrusterMax0(calcParams.src->GetGroupThruster(THGROUP_MAIN, 0));
+		F = GetEngineThrust(calcParams.src, THGROUP_MAIN);
 		t_burn = 0.5;
-		m = calcParams.src->GetMass();
+		m = GetVesselMass(calcParams.src);
 		dv = F / m*t_burn;
 		gravref = AGCGravityRef(calcParams.src);
 
@@ -2640,7 +2643,7 @@ bool RTCC::CalculationMTP_C(int fcn, LPVOID &pad, char * upString, char * upDesc
 		P27Opt opt;
 
 		opt.GETbase = getGETBase();
-		opt.SVGET = (oapiGetSimMJD() - opt.GETbase)*24.0*3600.0;
+		opt.SVGET = (StateVectorCalc(calcParams.src).MJD - opt.GETbase)*24.0*3600.0;
 		opt.navcheckGET = opt.SVGET + 30 * 60;
 		opt.vessel = calcParams.src;
 
@@ -2660,7 +2663,7 @@ void RTCC::AP7BlockData(AP7BLKOpt *opt, AP7BLK &pad)
 
 	char weather[10] = "GOOD";
 
-	v_e = calcParams.src->GetThrusterIsp0(calcParams.src->GetGroupThruster(THGROUP_MAIN, 0));
+	v_e = GetEngineIsp(calcParams.src, THGROUP_MAIN);
 
 	entopt.vessel = calcParams.src;
 	entopt.GETbase = getGETBase();
@@ -2678,7 +2681,7 @@ void RTCC::AP7BlockData(AP7BLKOpt *opt, AP7BLK &pad)
 
 		EntryTargeting(&entopt, &res);
 
-		m1 = calcParams.src->GetMass()*exp(-length(res.dV_LVLH) / v_e);
+		m1 = GetVesselMass(calcParams.src)*exp(-length(res.dV_LVLH) / v_e);
 		Vc = length(res.dV_LVLH)*cos(-2.15*RAD)*cos(0.95*RAD);// -60832.18 / m1;
 
 		sprintf(pad.Area[i], opt->area[i]);
@@ -2761,9 +2764,11 @@ void RTCC::EntryTargeting(EntryOpt *opt, EntryResults *res)
 
 	entry = new Entry(sv.R, sv.V, sv.MJD, sv.gravref, opt->GETbase, opt->TIGguess, opt->ReA, opt->lng, opt->type, opt->Range, opt->nominal, opt->entrylongmanual);
 
-	while (!stop)
+	int iter = 0;
+	while (!stop && !JobCancelled())
 	{
 		stop = entry->EntryIter();
+		JobProgress(++iter);
 	}
 
 	res->dV_LVLH = entry->Entry_DV;
@@ -2827,7 +2832,7 @@ void RTCC::LambertTargeting(LambertMan *lambert, VECTOR3 &dV_LVLH, double &P30TI
 
 	gravref = AGCGravityRef(lambert->vessel);
 
-	if (gravref == oapiGetObjectByName("Earth"))	//Hardcoded: Always prograde for Earth, always retrograde for Moon
+	if (gravref == OrbMech::GetObjectByName("Earth"))	//Hardcoded: Always prograde for Earth, always retrograde for Moon
 	{
 		prograde = true;
 	}
@@ -2836,13 +2841,10 @@ void RTCC::LambertTargeting(LambertMan *lambert, VECTOR3 &dV_LVLH, double &P30TI
 		prograde = false;
 	}
 
-	lambert->vessel->GetRelativePos(gravref, RA0_orb);
-	lambert->vessel->GetRelativeVel(gravref, VA0_orb);
-	lambert->target->GetRelativePos(gravref, RP0_orb);
-	lambert->target->GetRelativeVel(gravref, VP0_orb);
-	SVMJD = oapiGetSimMJD();
+	GetVesselState(lambert->target, gravref, RP0_orb, VP0_orb, SVMJD);
+	GetVesselState(lambert->vessel, gravref, RA0_orb, VA0_orb, SVMJD);
 
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 
 	RA0 = _V(RA0_orb.x, RA0_orb.z, RA0_orb.y);
 	VA0 = _V(VA0_orb.x, VA0_orb.z, VA0_orb.y);
@@ -2925,7 +2927,7 @@ void RTCC::LambertTargeting(LambertMan *lambert, VECTOR3 &dV_LVLH, double &P30TI
 		{
 			LMmass = 0.0;
 		}
-		mass = lambert->vessel->GetMass();
+		mass = GetVesselMass(lambert->vessel);
 
 		SV sv_tig;
 
@@ -3033,8 +3035,8 @@ void RTCC::AP11LMManeuverPAD(AP11LMManPADOpt *opt, AP11LMMNV &pad)
 	//Engine parameters. TODO: Add APS
 	if (opt->engopt == 0)
 	{
-		v_e = opt->vessel->GetThrusterIsp0(opt->vessel->GetGroupThruster(THGROUP_HOVER, 0));
-		F = opt->vessel->GetThrusterMax0(opt->vessel->GetGroupThruster(THGROUP_HOVER, 0));
+		v_e = GetEngineIsp(opt->vessel, THGROUP_HOVER);
+		F = GetEngineThrust(opt->vessel, THGROUP_HOVER);
 	}
 	else
 	{
@@ -3048,11 +3050,11 @@ void RTCC::AP11LMManeuverPAD(AP11LMManPADOpt *opt, AP11LMMNV &pad)
 	//Execute maneuver, output state vector at cutoff
 	sv2 = ExecuteManeuver(opt->vessel, opt->GETbase, opt->TIG, opt->dV_LVLH, sv1, CSMmass, Q_Xx, V_G, F, v_e);
 
-	mu = GGRAV*oapiGetMass(sv1.gravref);
+	mu = GGRAV*OrbMech::GetMass(sv1.gravref);
 
 	OrbMech::periapo(sv2.R, sv2.V, mu, apo, peri);
-	ManPADApo = apo - oapiGetSize(sv2.gravref);
-	ManPADPeri = peri - oapiGetSize(sv2.gravref);
+	ManPADApo = apo - OrbMech::GetSize(sv2.gravref);
+	ManPADPeri = peri - OrbMech::GetSize(sv2.gravref);
 
 	X_B = unit(V_G);
 	if (opt->engopt == 2)
@@ -3103,7 +3105,7 @@ void RTCC::AP11LMManeuverPAD(AP11LMManPADOpt *opt, AP11LMMNV &pad)
 
 	OrbMech::oneclickcoast(sv1.R, sv1.V, sv1.MJD, opt->sxtstardtime*60.0, Rsxt, Vsxt, sv1.gravref, sv1.gravref);
 
-	OrbMech::coascheckstar(opt->REFSMMAT, _V(OrbMech::round(IMUangles.x*DEG)*RAD, OrbMech::round(IMUangles.y*DEG)*RAD, OrbMech::round(IMUangles.z*DEG)*RAD), Rsxt, oapiGetSize(sv1.gravref), ManCOASstaroct, ManBSSpitch, ManBSSXPos);
+	OrbMech::coascheckstar(opt->REFSMMAT, _V(OrbMech::round(IMUangles.x*DEG)*RAD, OrbMech::round(IMUangles.y*DEG)*RAD, OrbMech::round(IMUangles.z*DEG)*RAD), Rsxt, OrbMech::GetSize(sv1.gravref), ManCOASstaroct, ManBSSpitch, ManBSSXPos);
 	
 	pad.Att = _V(OrbMech::imulimit(FDAIangles.x*DEG), OrbMech::imulimit(FDAIangles.y*DEG), OrbMech::imulimit(FDAIangles.z*DEG));
 	pad.BSSStar = ManCOASstaroct;
@@ -3166,7 +3168,7 @@ void RTCC::AP11ManeuverPAD(AP11ManPADOpt *opt, AP11MNV &pad)
 	//Execute maneuver, output state vector at cutoff
 	sv2 = ExecuteManeuver(opt->vessel, opt->GETbase, opt->TIG, opt->dV_LVLH, sv1, LMmass, Q_Xx, V_G, F, v_e);
 
-	mu = GGRAV*oapiGetMass(sv1.gravref);
+	mu = GGRAV*OrbMech::GetMass(sv1.gravref);
 
 	if (opt->HeadsUp)
 	{
@@ -3178,8 +3180,8 @@ void RTCC::AP11ManeuverPAD(AP11ManPADOpt *opt, AP11MNV &pad)
 	}
 
 	OrbMech::periapo(sv2.R, sv2.V, mu, apo, peri);
-	ManPADApo = apo - oapiGetSize(sv2.gravref);
-	ManPADPeri = peri - oapiGetSize(sv2.gravref);
+	ManPADApo = apo - OrbMech::GetSize(sv2.gravref);
+	ManPADPeri = peri - OrbMech::GetSize(sv2.gravref);
 
 	if (opt->engopt == 0)
 	{
@@ -3231,15 +3233,15 @@ void RTCC::AP11ManeuverPAD(AP11ManPADOpt *opt, AP11MNV &pad)
 	IMUangles = OrbMech::CALCGAR(opt->REFSMMAT, mul(OrbMech::transpose_matrix(M), M_R));
 	//sprintf(oapiDebugString(), "%f, %f, %f", IMUangles.x*DEG, IMUangles.y*DEG, IMUangles.z*DEG);
 
-	GDCangles = OrbMech::backupgdcalignment(opt->REFSMMAT, sv1.R, oapiGetSize(sv1.gravref), GDCset);
+	GDCangles = OrbMech::backupgdcalignment(opt->REFSMMAT, sv1.R, OrbMech::GetSize(sv1.gravref), GDCset);
 
 	VECTOR3 Rsxt, Vsxt;
 
 	OrbMech::oneclickcoast(sv1.R, sv1.V, sv1.MJD, opt->sxtstardtime*60.0, Rsxt, Vsxt, sv1.gravref, sv1.gravref);
 
-	OrbMech::checkstar(opt->REFSMMAT, _V(OrbMech::round(IMUangles.x*DEG)*RAD, OrbMech::round(IMUangles.y*DEG)*RAD, OrbMech::round(IMUangles.z*DEG)*RAD), Rsxt, oapiGetSize(sv1.gravref), Manstaroct, Mantrunnion, Manshaft);
+	OrbMech::checkstar(opt->REFSMMAT, _V(OrbMech::round(IMUangles.x*DEG)*RAD, OrbMech::round(IMUangles.y*DEG)*RAD, OrbMech::round(IMUangles.z*DEG)*RAD), Rsxt, OrbMech::GetSize(sv1.gravref), Manstaroct, Mantrunnion, Manshaft);
 
-	OrbMech::coascheckstar(opt->REFSMMAT, _V(OrbMech::round(IMUangles.x*DEG)*RAD, OrbMech::round(IMUangles.y*DEG)*RAD, OrbMech::round(IMUangles.z*DEG)*RAD), Rsxt, oapiGetSize(sv1.gravref), ManCOASstaroct, ManBSSpitch, ManBSSXPos);
+	OrbMech::coascheckstar(opt->REFSMMAT, _V(OrbMech::round(IMUangles.x*DEG)*RAD, OrbMech::round(IMUangles.y*DEG)*RAD, OrbMech::round(IMUangles.z*DEG)*RAD), Rsxt, OrbMech::GetSize(sv1.gravref), ManCOASstaroct, ManBSSpitch, ManBSSXPos);
 
 	pad.Att = _V(OrbMech::imulimit(IMUangles.x*DEG), OrbMech::imulimit(IMUangles.y*DEG), OrbMech::imulimit(IMUangles.z*DEG));
 	pad.BSSStar = ManCOASstaroct;
@@ -3339,7 +3341,7 @@ void RTCC::AP7ManeuverPAD(AP7ManPADOpt *opt, AP7MNV &pad)
 	//Execute maneuver, output state vector at cutoff
 	sv2 = ExecuteManeuver(opt->vessel, opt->GETbase, opt->TIG, opt->dV_LVLH, sv1, LMmass, Q_Xx, V_G, F, v_e);
 
-	mu = GGRAV*oapiGetMass(sv1.gravref);
+	mu = GGRAV*OrbMech::GetMass(sv1.gravref);
 
 	if (opt->HeadsUp)
 	{
@@ -3351,12 +3353,12 @@ void RTCC::AP7ManeuverPAD(AP7ManPADOpt *opt, AP7MNV &pad)
 	}
 
 	OrbMech::periapo(sv2.R, sv2.V, mu, apo, peri);
-	ManPADApo = apo - oapiGetSize(sv2.gravref);
-	ManPADPeri = peri - oapiGetSize(sv2.gravref);
+	ManPADApo = apo - OrbMech::GetSize(sv2.gravref);
+	ManPADPeri = peri - OrbMech::GetSize(sv2.gravref);
 
-	pad.Weight = opt->vessel->GetMass() / 0.45359237;
+	pad.Weight = GetVesselMass(opt->vessel) / 0.45359237;
 
-	pad.burntime = v_e / F *opt->vessel->GetMass()*(1.0 - exp(-length(opt->dV_LVLH) / v_e));
+	pad.burntime = v_e / F *GetVesselMass(opt->vessel)*(1.0 - exp(-length(opt->dV_LVLH) / v_e));
 
 	if (opt->engopt == 0)
 	{
@@ -3410,7 +3412,7 @@ void RTCC::AP7ManeuverPAD(AP7ManPADOpt *opt, AP7MNV &pad)
 
 	OrbMech::oneclickcoast(sv1.R, sv1.V, sv1.MJD, opt->sxtstardtime, Rsxt, Vsxt, sv1.gravref, sv1.gravref);
 
-	OrbMech::checkstar(opt->REFSMMAT, _V(round(Att.x*DEG)*RAD, round(Att.y*DEG)*RAD, round(Att.z*DEG)*RAD), Rsxt, oapiGetSize(sv1.gravref), pad.Star, pad.Trun, pad.Shaft);
+	OrbMech::checkstar(opt->REFSMMAT, _V(round(Att.x*DEG)*RAD, round(Att.y*DEG)*RAD, round(Att.z*DEG)*RAD), Rsxt, OrbMech::GetSize(sv1.gravref), pad.Star, pad.Trun, pad.Shaft);
 
 	if (opt->navcheckGET != 0.0)
 	{
@@ -3450,13 +3452,10 @@ void RTCC::AP7TPIPAD(AP7TPIPADOpt *opt, AP7TPI &pad)
 
 	gravref = AGCGravityRef(opt->vessel);
 
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 
-	opt->vessel->GetRelativePos(gravref, R_A);
-	opt->vessel->GetRelativeVel(gravref, V_A);
-	opt->target->GetRelativePos(gravref, R_P);
-	opt->target->GetRelativeVel(gravref, V_P);
-	SVMJD = oapiGetSimMJD();
+	GetVesselState(opt->target, gravref, R_P, V_P, SVMJD);
+	GetVesselState(opt->vessel, gravref, R_A, V_A, SVMJD);
 
 	dt = opt->TIG - (SVMJD - opt->GETbase) * 24.0 * 60.0 * 60.0;
 
@@ -3486,7 +3485,7 @@ void RTCC::AP7TPIPAD(AP7TPIPADOpt *opt, AP7TPI &pad)
 	//TPIPAD_dH = abs(length(RP3) - length(RA3));
 	double mass, F;
 
-	mass = opt->vessel->GetMass();
+	mass = GetVesselMass(opt->vessel);
 	F = 200.0 * 4.448222;
 	TPIPAD_BT = _V(abs(0.5*TPIPAD_dV_LOS.x), abs(TPIPAD_dV_LOS.y), abs(TPIPAD_dV_LOS.z))*mass / F;
 
@@ -3564,11 +3563,9 @@ void RTCC::EarthOrbitEntry(EarthEntryPADOpt *opt, AP7ENT &pad)
 	double ALFATRIM = -20.0*RAD;
 
 	gravref = AGCGravityRef(opt->vessel);
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 
-	opt->vessel->GetRelativePos(gravref, R_A);
-	opt->vessel->GetRelativeVel(gravref, V_A);
-	SVMJD = oapiGetSimMJD();
+	GetVesselState(opt->vessel, gravref, R_A, V_A, SVMJD);
 	GET = (SVMJD - opt->GETbase)*24.0*3600.0;
 
 	R0B = _V(R_A.x, R_A.z, R_A.y);
@@ -3581,8 +3578,8 @@ void RTCC::EarthOrbitEntry(EarthEntryPADOpt *opt, AP7ENT &pad)
 		{
 		double F, m_cut;
 
-		F = opt->vessel->GetThrusterMax0(opt->vessel->GetGroupThruster(THGROUP_MAIN, 0));
-		v_e = opt->vessel->GetThrusterIsp0(opt->vessel->GetGroupThruster(THGROUP_MAIN, 0));
+		F = GetEngineThrust(opt->vessel, THGROUP_MAIN);
+		v_e = GetEngineIsp(opt->vessel, THGROUP_MAIN);
 
 		dt = opt->P30TIG - (SVMJD - opt->GETbase) * 24.0 * 60.0 * 60.0;
 		OrbMech::oneclickcoast(R0B, V0B, SVMJD, dt, R1B, V1B, gravref, gravref);
@@ -3592,15 +3589,15 @@ void RTCC::EarthOrbitEntry(EarthEntryPADOpt *opt, AP7ENT &pad)
 		UX = crossp(UY, UZ);
 
 		DV_P = UX*opt->dV_LVLH.x + UZ*opt->dV_LVLH.z;
-		theta_T = length(crossp(R1B, V1B))*length(opt->dV_LVLH)*opt->vessel->GetMass() / OrbMech::power(length(R1B), 2.0) / 92100.0;
+		theta_T = length(crossp(R1B, V1B))*length(opt->dV_LVLH)*GetVesselMass(opt->vessel) / OrbMech::power(length(R1B), 2.0) / 92100.0;
 		DV_C = (unit(DV_P)*cos(theta_T / 2.0) + unit(crossp(DV_P, UY))*sin(theta_T / 2.0))*length(DV_P);
 		V_G = DV_C + UY*opt->dV_LVLH.y;
 		//opt->vessel->GetGroupThruster(THGROUP_MAIN, 0),
-		OrbMech::poweredflight(R1B, V1B, SVMJD + dt / 24.0 / 3600.0, gravref, F, v_e, opt->vessel->GetMass(), V_G, R2B, V2B, m_cut, t_go);
+		OrbMech::poweredflight(R1B, V1B, SVMJD + dt / 24.0 / 3600.0, gravref, F, v_e, GetVesselMass(opt->vessel), V_G, R2B, V2B, m_cut, t_go);
 
-		dt2 = OrbMech::time_radius_integ(R2B, V2B, SVMJD + (dt + t_go) / 3600.0 / 24.0, oapiGetSize(gravref) + EIAlt, -1, gravref, gravref, REI, VEI);
-		dt3 = OrbMech::time_radius_integ(REI, VEI, SVMJD + (dt + t_go + dt2) / 3600.0 / 24.0, oapiGetSize(gravref) + 300000.0*0.3048, -1, gravref, gravref, R300K, V300K);
-		dt4 = OrbMech::time_radius_integ(R300K, V300K, SVMJD + (dt + t_go + dt2 + dt3) / 3600.0 / 24.0, oapiGetSize(gravref) + EMSAlt, -1, gravref, gravref, R05G, V05G);
+		dt2 = OrbMech::time_radius_integ(R2B, V2B, SVMJD + (dt + t_go) / 3600.0 / 24.0, OrbMech::GetSize(gravref) + EIAlt, -1, gravref, gravref, REI, VEI);
+		dt3 = OrbMech::time_radius_integ(REI, VEI, SVMJD + (dt + t_go + dt2) / 3600.0 / 24.0, OrbMech::GetSize(gravref) + 300000.0*0.3048, -1, gravref, gravref, R300K, V300K);
+		dt4 = OrbMech::time_radius_integ(R300K, V300K, SVMJD + (dt + t_go + dt2 + dt3) / 3600.0 / 24.0, OrbMech::GetSize(gravref) + EMSAlt, -1, gravref, gravref, R05G, V05G);
 
 		entry = new Entry(gravref, 0);
 		entry->Reentry(REI, VEI, SVMJD + (dt + t_go + dt2) / 3600.0 / 24.0);
@@ -3619,7 +3616,7 @@ void RTCC::EarthOrbitEntry(EarthEntryPADOpt *opt, AP7ENT &pad)
 		M_R = _M(UXD.x, UXD.y, UXD.z, UYD.x, UYD.y, UYD.z, UZD.x, UZD.y, UZD.z);
 		EIangles = OrbMech::CALCGAR(opt->REFSMMAT, M_R);
 
-		m1 = opt->vessel->GetMass()*exp(-length(opt->dV_LVLH) / v_e);
+		m1 = GetVesselMass(opt->vessel)*exp(-length(opt->dV_LVLH) / v_e);
 
 		double WIE, WT, theta_rad, LSMJD;
 		VECTOR3 RTE, UTR, urh, URT0, URT, R_LS, R_P;
@@ -3667,9 +3664,9 @@ void RTCC::EarthOrbitEntry(EarthEntryPADOpt *opt, AP7ENT &pad)
 		MATRIX3 Rot2;
 
 		dt = opt->P30TIG - (SVMJD - opt->GETbase) * 24.0 * 60.0 * 60.0;
-		dt2 = OrbMech::time_radius_integ(R0B, V0B, SVMJD, oapiGetSize(gravref) + EIAlt, -1, gravref, gravref, REI, VEI);
-		dt3 = OrbMech::time_radius_integ(REI, VEI, SVMJD + dt2 / 24.0 / 3600.0, oapiGetSize(gravref) + 300000.0*0.3048, -1, gravref, gravref, R300K, V300K);
-		dt4 = OrbMech::time_radius_integ(R300K, V300K, SVMJD + (dt2 + dt3) / 24.0 / 3600.0, oapiGetSize(gravref) + EMSAlt, -1, gravref, gravref, R05G, V05G);
+		dt2 = OrbMech::time_radius_integ(R0B, V0B, SVMJD, OrbMech::GetSize(gravref) + EIAlt, -1, gravref, gravref, REI, VEI);
+		dt3 = OrbMech::time_radius_integ(REI, VEI, SVMJD + dt2 / 24.0 / 3600.0, OrbMech::GetSize(gravref) + 300000.0*0.3048, -1, gravref, gravref, R300K, V300K);
+		dt4 = OrbMech::time_radius_integ(R300K, V300K, SVMJD + (dt2 + dt3) / 24.0 / 3600.0, OrbMech::GetSize(gravref) + EMSAlt, -1, gravref, gravref, R05G, V05G);
 
 		UX = unit(-V05G);
 		UY = unit(crossp(UX, -R05G));
@@ -3748,15 +3745,13 @@ void RTCC::LunarEntryPAD(LunarEntryPADOpt *opt, AP11ENT &pad)
 	Entry *entry;
 
 	gravref = AGCGravityRef(opt->vessel);
-	hEarth = oapiGetObjectByName("Earth");
+	hEarth = OrbMech::GetObjectByName("Earth");
 
 	EIAlt = 400000.0*0.3048;
 	Alt300K = 300000.0*0.3048;
 	EMSAlt = 297431.0*0.3048;
 
-	opt->vessel->GetRelativePos(gravref, R_A);
-	opt->vessel->GetRelativeVel(gravref, V_A);
-	SVMJD = oapiGetSimMJD();
+	GetVesselState(opt->vessel, gravref, R_A, V_A, SVMJD);
 
 	R0B = _V(R_A.x, R_A.z, R_A.y);
 	V0B = _V(V_A.x, V_A.z, V_A.y);
@@ -3765,7 +3760,7 @@ void RTCC::LunarEntryPAD(LunarEntryPADOpt *opt, AP11ENT &pad)
 	sv0.MJD = SVMJD;
 	sv0.R = R0B;
 	sv0.V = V0B;
-	sv0.mass = opt->vessel->GetMass();
+	sv0.mass = GetVesselMass(opt->vessel);
 
 	if (opt->direct || length(opt->dV_LVLH) == 0.0)	//Check against a DV of 0
 	{
@@ -3776,7 +3771,7 @@ void RTCC::LunarEntryPAD(LunarEntryPADOpt *opt, AP11ENT &pad)
 		sv1 = ExecuteManeuver(opt->vessel, opt->GETbase, opt->P30TIG, opt->dV_LVLH, sv0, 0);
 	}
 
-	dt = OrbMech::time_radius_integ(sv1.R, sv1.V, sv1.MJD, oapiGetSize(hEarth) + EIAlt, -1, sv1.gravref, hEarth, svEI.R, svEI.V);
+	dt = OrbMech::time_radius_integ(sv1.R, sv1.V, sv1.MJD, OrbMech::GetSize(hEarth) + EIAlt, -1, sv1.gravref, hEarth, svEI.R, svEI.V);
 	svEI.gravref = hEarth;
 	svEI.mass = sv1.mass;
 	svEI.MJD = sv1.MJD + dt / 24.0 / 3600.0;
@@ -3788,12 +3783,12 @@ void RTCC::LunarEntryPAD(LunarEntryPADOpt *opt, AP11ENT &pad)
 
 	delete entry;
 
-	dt2 = OrbMech::time_radius_integ(svEI.R, svEI.V, svEI.MJD, oapiGetSize(hEarth) + Alt300K, -1, hEarth, hEarth, sv300K.R, sv300K.V);
+	dt2 = OrbMech::time_radius_integ(svEI.R, svEI.V, svEI.MJD, OrbMech::GetSize(hEarth) + Alt300K, -1, hEarth, hEarth, sv300K.R, sv300K.V);
 	sv300K.gravref = hEarth;
 	sv300K.mass = svEI.mass;
 	sv300K.MJD = svEI.MJD + dt2 / 24.0 / 3600.0;
 
-	dt3 = OrbMech::time_radius_integ(sv300K.R, sv300K.V, sv300K.MJD, oapiGetSize(hEarth) + EMSAlt, -1, hEarth, hEarth, sv05G.R, sv05G.V);
+	dt3 = OrbMech::time_radius_integ(sv300K.R, sv300K.V, sv300K.MJD, OrbMech::GetSize(hEarth) + EMSAlt, -1, hEarth, hEarth, sv05G.R, sv05G.V);
 	sv05G.gravref = hEarth;
 	sv05G.mass = sv300K.mass;
 	sv05G.MJD = sv300K.MJD + dt3 / 24.0 / 3600.0;
@@ -3870,13 +3865,13 @@ void RTCC::LunarEntryPAD(LunarEntryPADOpt *opt, AP11ENT &pad)
 
 	double Entrytrunnion, Entryshaft, EntryBSSpitch, EntryBSSXPos;
 	int Entrystaroct, EntryCOASstaroct;
-	OrbMech::checkstar(opt->REFSMMAT, _V(OrbMech::round(EIangles.x*DEG)*RAD, OrbMech::round(EIangles.y*DEG)*RAD, OrbMech::round(EIangles.z*DEG)*RAD), svSxtCheck.R, oapiGetSize(hEarth), Entrystaroct, Entrytrunnion, Entryshaft);
-	OrbMech::coascheckstar(opt->REFSMMAT, _V(OrbMech::round(EIangles.x*DEG)*RAD, OrbMech::round(EIangles.y*DEG)*RAD, OrbMech::round(EIangles.z*DEG)*RAD), svSxtCheck.R, oapiGetSize(hEarth), EntryCOASstaroct, EntryBSSpitch, EntryBSSXPos);
+	OrbMech::checkstar(opt->REFSMMAT, _V(OrbMech::round(EIangles.x*DEG)*RAD, OrbMech::round(EIangles.y*DEG)*RAD, OrbMech::round(EIangles.z*DEG)*RAD), svSxtCheck.R, OrbMech::GetSize(hEarth), Entrystaroct, Entrytrunnion, Entryshaft);
+	OrbMech::coascheckstar(opt->REFSMMAT, _V(OrbMech::round(EIangles.x*DEG)*RAD, OrbMech::round(EIangles.y*DEG)*RAD, OrbMech::round(EIangles.z*DEG)*RAD), svSxtCheck.R, OrbMech::GetSize(hEarth), EntryCOASstaroct, EntryBSSpitch, EntryBSSXPos);
 
 	double horang, coastang, IGA, cosIGA, sinIGA;
 	VECTOR3 X_NB, Y_NB, Z_NB, X_SM, Y_SM, Z_SM, A_MG;
 
-	horang = asin(oapiGetSize(gravref) / length(svHorCheck.R));
+	horang = asin(OrbMech::GetSize(gravref) / length(svHorCheck.R));
 	coastang = dotp(unit(svEI.R), unit(svHorCheck.R));
 
 	Z_NB = unit(-svEI.R);
@@ -3993,7 +3988,7 @@ void RTCC::navcheck(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE gravref, double
 	u = unit(Requ);
 	sinl = u.z;
 
-	if (gravref == oapiGetObjectByName("Earth"))
+	if (gravref == OrbMech::GetObjectByName("Earth"))
 	{
 		gamma = b*b / a / a;
 	}
@@ -4001,7 +3996,7 @@ void RTCC::navcheck(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE gravref, double
 	{
 		gamma = 1;
 	}
-	r_0 = oapiGetSize(gravref);
+	r_0 = OrbMech::GetSize(gravref);
 
 	lat = atan(u.z/(gamma*sqrt(u.x*u.x + u.y*u.y)));
 	lng = atan2(u.y, u.x);
@@ -4017,15 +4012,13 @@ SV RTCC::StateVectorCalc(VESSEL *vessel, double SVMJD)
 
 	gravref = AGCGravityRef(vessel);
 
-	vessel->GetRelativePos(gravref, R);
-	vessel->GetRelativeVel(gravref, V);
-	sv.MJD = oapiGetSimMJD();
+	GetVesselState(vessel, gravref, R, V, sv.MJD);
 
 	sv.R = _V(R.x, R.z, R.y);
 	sv.V = _V(V.x, V.z, V.y);
 
 	sv.gravref = gravref;
-	sv.mass = vessel->GetMass();
+	sv.mass = GetVesselMass(vessel);
 
 	if (SVMJD != 0.0)
 	{
@@ -4044,12 +4037,18 @@ OBJHANDLE RTCC::AGCGravityRef(VESSEL *vessel)
 {
 	OBJHANDLE gravref;
 	VECTOR3 rsph;
+	const VesselSnapshot *snap = GetSnapshot(vessel);
+
+	if (snap)
+	{
+		return snap->gravref;
+	}
 
-	gravref = oapiGetObjectByName("Moon");
+	gravref = OrbMech::GetObjectByName("Moon");
 	vessel->GetRelativePos(gravref, rsph);
 	if (length(rsph) > 64373760.0)
 	{
-		gravref = oapiGetObjectByName("Earth");
+		gravref = OrbMech::GetObjectByName("Earth");
 	}
 	return gravref;
 }
@@ -4072,7 +4071,7 @@ MATRIX3 RTCC::REFSMMATCalc(REFSMMATOpt *opt)
 	SV sv0, sv2;
 	THGROUP_TYPE th_main;
 
-	if (opt->vessel->GetGroupThruster(THGROUP_MAIN, 0) == NULL)
+	if (!HasMainThruster(opt->vessel))
 	{
 		th_main = THGROUP_HOVER;
 	}
@@ -4083,21 +4082,19 @@ MATRIX3 RTCC::REFSMMATCalc(REFSMMATOpt *opt)
 
 	gravref = AGCGravityRef(opt->vessel);
 
-	hMoon = oapiGetObjectByName("Moon");
-	hEarth = oapiGetObjectByName("Earth");
+	hMoon = OrbMech::GetObjectByName("Moon");
+	hEarth = OrbMech::GetObjectByName("Earth");
 
-	opt->vessel->GetRelativePos(gravref, R_A);
-	opt->vessel->GetRelativeVel(gravref, V_A);
-	SVMJD = oapiGetSimMJD();
+	GetVesselState(opt->vessel, gravref, R_A, V_A, SVMJD);
 
 	R_A = _V(R_A.x, R_A.z, R_A.y);
 	V_A = _V(V_A.x, V_A.z, V_A.y);
 
-	F = opt->vessel->GetThrusterMax0(opt->vessel->GetGroupThruster(th_main, 0));
-	v_e = opt->vessel->GetThrusterIsp0(opt->vessel->GetGroupThruster(th_main, 0));
+	F = GetEngineThrust(opt->vessel, th_main);
+	v_e = GetEngineIsp(opt->vessel, th_main);
 
 	sv0.gravref = gravref;
-	sv0.mass = opt->vessel->GetMass();
+	sv0.mass = GetVesselMass(opt->vessel);
 	sv0.MJD = SVMJD;
 	sv0.R = R_A;
 	sv0.V = V_A;
@@ -4134,7 +4131,7 @@ MATRIX3 RTCC::REFSMMATCalc(REFSMMATOpt *opt)
 
 		R_P = unit(_V(cos(opt->LSLng)*cos(opt->LSLat), sin(opt->LSLat), sin(opt->LSLng)*cos(opt->LSLat)));
 
-		Rot2 = OrbMech::GetRotationMatrix(oapiGetObjectByName("Moon"), LSMJD);
+		Rot2 = OrbMech::GetRotationMatrix(OrbMech::GetObjectByName("Moon"), LSMJD);
 
 		R_LS = mul(Rot2, R_P);
 		R_LS = _V(R_LS.x, R_LS.z, R_LS.y);
@@ -4160,9 +4157,9 @@ MATRIX3 RTCC::REFSMMATCalc(REFSMMATOpt *opt)
 
 		PTCMJD = opt->REFSMMATTime / 24.0 / 3600.0 + opt->GETbase;
 
-		CELBODY *cMoon = oapiGetCelbodyInterface(hMoon);
+		CELBODY *cMoon = OrbMech::GetCelbodyInterface(hMoon);
 
-		cMoon->clbkEphemeris(PTCMJD, EPHEM_TRUEPOS, MoonPos);
+		OrbMech::Ephemeris(cMoon, PTCMJD, EPHEM_TRUEPOS, MoonPos);
 
 		R_ME = -_V(MoonPos[0], MoonPos[1], MoonPos[2]);
 
@@ -4189,14 +4186,14 @@ MATRIX3 RTCC::REFSMMATCalc(REFSMMATOpt *opt)
 			double t_p, mu;
 			SV sv3;
 
-			mu = GGRAV*oapiGetMass(hMoon);
+			mu = GGRAV*OrbMech::GetMass(hMoon);
 			t_p = OrbMech::period(sv2.R, sv2.V, mu);
 			OrbMech::oneclickcoast(sv2.R, sv2.V, sv2.MJD, 1.5*t_p, sv3.R, sv3.V, sv2.gravref, hMoon);
 			sv3.gravref = hMoon;
 			sv3.mass = sv2.mass;
 			sv3.MJD = sv2.MJD + 1.5*t_p / 24.0 / 3600.0;
 
-			OrbMech::time_radius_integ(sv3.R, sv3.V, sv3.MJD, oapiGetSize(hMoon) + 60.0*1852.0, -1, hMoon, hMoon, sv4.R, sv4.V);
+			OrbMech::time_radius_integ(sv3.R, sv3.V, sv3.MJD, OrbMech::GetSize(hMoon) + 60.0*1852.0, -1, hMoon, hMoon, sv4.R, sv4.V);
 		}
 		else if (opt->REFSMMATopt == 0 || opt->REFSMMATopt == 1)
 		{
@@ -4205,7 +4202,7 @@ MATRIX3 RTCC::REFSMMATCalc(REFSMMATOpt *opt)
 		}
 		else
 		{
-			dt = OrbMech::time_radius_integ(sv2.R, sv2.V, sv2.MJD, oapiGetSize(hEarth) + 400000.0*0.3048, -1, sv2.gravref, hEarth, sv4.R, sv4.V);
+			dt = OrbMech::time_radius_integ(sv2.R, sv2.V, sv2.MJD, OrbMech::GetSize(hEarth) + 400000.0*0.3048, -1, sv2.gravref, hEarth, sv4.R, sv4.V);
 		}
 
 		UY = unit(crossp(sv4.V, sv4.R));
@@ -4222,7 +4219,7 @@ MATRIX3 RTCC::REFSMMATCalc(REFSMMATOpt *opt)
 			DV_P = UX*opt->dV_LVLH.x + UZ*opt->dV_LVLH.z;
 			if (length(DV_P) != 0.0)
 			{
-				theta_T = length(crossp(sv4.R, sv4.V))*length(opt->dV_LVLH)*opt->vessel->GetMass() / OrbMech::power(length(sv4.R), 2.0) / 92100.0;
+				theta_T = length(crossp(sv4.R, sv4.V))*length(opt->dV_LVLH)*GetVesselMass(opt->vessel) / OrbMech::power(length(sv4.R), 2.0) / 92100.0;
 				DV_C = (unit(DV_P)*cos(theta_T / 2.0) + unit(crossp(DV_P, UY))*sin(theta_T / 2.0))*length(DV_P);
 				V_G = DV_C + UY*opt->dV_LVLH.y;
 			}
@@ -4316,7 +4313,7 @@ MATRIX3 RTCC::REFSMMATCalc(REFSMMATOpt *opt)
 double RTCC::CDHcalc(CDHOpt *opt, VECTOR3 &dV_LVLH, double &P30TIG)			//Calculates the required DV vector of a coelliptic burn
 {
 	double mu;
-	double SVMJD, SVtime, dt, dt2, c1, c2, theta, SW, dh_CDH, VPV, dt2_apo, CDHtime_cor, mass;
+	double SVMJD, dt, dt2, c1, c2, theta, SW, dh_CDH, VPV, dt2_apo, CDHtime_cor, mass;
 	VECTOR3 RA0_orb, VA0_orb, RP0_orb, VP0_orb;
 	VECTOR3 RA0, VA0, RP0, VP0, RA2_alt, VA2_alt, V_A2_apo, CDHdeltaV;
 	VECTOR3 u, RPC, VPC, i, j, k;
@@ -4328,15 +4325,12 @@ double RTCC::CDHcalc(CDHOpt *opt, VECTOR3 &dV_LVLH, double &P30TIG)			//Calculat
 
 	gravref = AGCGravityRef(opt->vessel);
 
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 
 	//DH_met = DH*1852.0;							//Calculates the desired delta height of the coellitpic orbit in metric units
 
-	opt->vessel->GetRelativePos(gravref, RA0_orb);	//vessel position vector
-	opt->vessel->GetRelativeVel(gravref, VA0_orb);	//vessel velocity vector
-	opt->target->GetRelativePos(gravref, RP0_orb);	//target position vector
-	opt->target->GetRelativeVel(gravref, VP0_orb);	//target velocity vector
-	SVtime = oapiGetSimTime();					//The time mark of the state vectors
+	GetVesselState(opt->target, gravref, RP0_orb, VP0_orb, SVMJD);	//target position and velocity vector
+	GetVesselState(opt->vessel, gravref, RA0_orb, VA0_orb, SVMJD);	//vessel position and velocity vector, and the time mark of the state vectors
 
 	//oapiGetPlanetObliquityMatrix(gravref, &obli);
 
@@ -4350,9 +4344,7 @@ double RTCC::CDHcalc(CDHOpt *opt, VECTOR3 &dV_LVLH, double &P30TIG)			//Calculat
 	RP0 = _V(RP0_orb.x, RP0_orb.z, RP0_orb.y);
 	VP0 = _V(VP0_orb.x, VP0_orb.z, VP0_orb.y);
 
-	SVMJD = oapiTime2MJD(SVtime);				//Calculates the MJD of the state vector
-
-	mass = opt->vessel->GetMass();
+	mass = GetVesselMass(opt->vessel);
 
 	if (opt->CDHtimemode == 0)
 	{
@@ -4485,11 +4477,8 @@ double RTCC::lambertelev(VESSEL* vessel, VESSEL* target, double GETbase, double
 
 	gravref = AGCGravityRef(vessel);
 
-	vessel->GetRelativePos(gravref, RA0_orb);
-	vessel->GetRelativeVel(gravref, VA0_orb);
-	target->GetRelativePos(gravref, RP0_orb);
-	target->GetRelativeVel(gravref, VP0_orb);
-	SVMJD = oapiGetSimMJD();
+	GetVesselState(target, gravref, RP0_orb, VP0_orb, SVMJD);
+	GetVesselState(vessel, gravref, RA0_orb, VA0_orb, SVMJD);
 
 	RA0 = _V(RA0_orb.x, RA0_orb.z, RA0_orb.y);
 	VA0 = _V(VA0_orb.x, VA0_orb.z, VA0_orb.y);
@@ -4508,7 +4497,7 @@ void RTCC::DOITargeting(DOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG)
 	MATRIX3 Q_Xx;
 	OBJHANDLE hMoon, gravref;
 
-	hMoon = oapiGetObjectByName("Moon");
+	hMoon = OrbMech::GetObjectByName("Moon");
 
 	if (opt->useSV)
 	{
@@ -4521,12 +4510,10 @@ void RTCC::DOITargeting(DOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG)
 	else
 	{
 		gravref = AGCGravityRef(opt->vessel);
-		opt->vessel->GetRelativePos(gravref, R_A);
-		opt->vessel->GetRelativeVel(gravref, V_A);
-		SVMJD = oapiGetSimMJD();
+		GetVesselState(opt->vessel, gravref, R_A, V_A, SVMJD);
 		R0B = _V(R_A.x, R_A.z, R_A.y);
 		V0B = _V(V_A.x, V_A.z, V_A.y);
-		CSMmass = opt->vessel->GetMass();
+		CSMmass = GetVesselMass(opt->vessel);
 	}
 
 	GET = (SVMJD - opt->GETbase)*24.0*3600.0;
@@ -4542,11 +4529,11 @@ void RTCC::DOITargeting(DOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG)
 	mass = LMmass + CSMmass;
 
 
-	R_LSA = _V(cos(opt->lng)*cos(opt->lat), sin(opt->lng)*cos(opt->lat), sin(opt->lat))*(oapiGetSize(hMoon) + opt->alt);
+	R_LSA = _V(cos(opt->lng)*cos(opt->lat), sin(opt->lng)*cos(opt->lat), sin(opt->lat))*(OrbMech::GetSize(hMoon) + opt->alt);
 	h_DP = 50000.0*0.3048;
 	theta_F = 15.0*RAD;
 	t_F = 718.0;
-	mu = GGRAV*oapiGetMass(hMoon);
+	mu = GGRAV*OrbMech::GetMass(hMoon);
 	OrbMech::LunarLandingPrediction(R0B, V0B, GET, opt->EarliestGET, R_LSA, h_DP, theta_F, t_F, hMoon, opt->GETbase, mu, t_DOI, t_PDI, t_L, DV_DOI, CR);
 
 	OrbMech::oneclickcoast(R0B, V0B, SVMJD, t_DOI - GET, RA2, VA2, hMoon, hMoon);
@@ -4579,7 +4566,7 @@ void RTCC::LOITargeting(LOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &
 	VECTOR3 R_A, V_A, R0B, V0B;
 	OBJHANDLE hMoon, gravref;
 
-	hMoon = oapiGetObjectByName("Moon");
+	hMoon = OrbMech::GetObjectByName("Moon");
 
 	if (opt->useSV)
 	{
@@ -4592,12 +4579,10 @@ void RTCC::LOITargeting(LOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &
 	else
 	{
 		gravref = AGCGravityRef(opt->vessel);
-		opt->vessel->GetRelativePos(gravref, R_A);
-		opt->vessel->GetRelativeVel(gravref, V_A);
-		SVMJD = oapiGetSimMJD();
+		GetVesselState(opt->vessel, gravref, R_A, V_A, SVMJD);
 		R0B = _V(R_A.x, R_A.z, R_A.y);
 		V0B = _V(V_A.x, V_A.z, V_A.y);
-		CSMmass = opt->vessel->GetMass();
+		CSMmass = GetVesselMass(opt->vessel);
 	}
 
 	GET = (SVMJD - opt->GETbase)*24.0*3600.0;
@@ -4628,7 +4613,7 @@ void RTCC::LOITargeting(LOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &
 
 		R_peri = mul(Rot2, R_P);
 		//R_peri = unit(mul(Rot, _V(R_peri.x, R_peri.z, R_peri.y)))*(oapiGetSize(hMoon) + opt->h_peri);
-		R_peri = unit(_V(R_peri.x, R_peri.z, R_peri.y))*(oapiGetSize(hMoon) + opt->h_peri);
+		R_peri = unit(_V(R_peri.x, R_peri.z, R_peri.y))*(OrbMech::GetSize(hMoon) + opt->h_peri);
 
 		dt1 = opt->MCCGET - (SVMJD - opt->GETbase) * 24.0 * 60.0 * 60.0;
 		dt2 = opt->PeriGET - opt->MCCGET;
@@ -4676,8 +4661,8 @@ void RTCC::LOITargeting(LOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &
 		VECTOR3 RA2, VA2, U_H, U_hor, VA2_apo, DVX, i, j, k;
 		MATRIX3 Q_Xx;
 
-		mu = GGRAV*oapiGetMass(hMoon);
-		a = oapiGetSize(hMoon) + opt->h_peri;
+		mu = GGRAV*OrbMech::GetMass(hMoon);
+		a = OrbMech::GetSize(hMoon) + opt->h_peri;
 
 		//double t_period;
 		//VECTOR3 RA1, VA1;
@@ -4726,7 +4711,7 @@ void RTCC::LOITargeting(LOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &
 		double TIGMJD, PeriMJD, dt1, dt2, mu_E, mu_M, TIGguess, dTIG;
 		VECTOR3 R_P, R_peri, RA1, VA1, VA1_apo, i, j, k, V_peri, RA2, R_m, V_m, DVX;
 		MATRIX3 Rot2, Q_Xx;
-		OBJHANDLE hEarth = oapiGetObjectByName("Earth");
+		OBJHANDLE hEarth = OrbMech::GetObjectByName("Earth");
 
 		double *MoonPos;
 		CELBODY *cMoon;
@@ -4735,9 +4720,9 @@ void RTCC::LOITargeting(LOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &
 		VECTOR3 R_I_star, delta_I_star, delta_I_star_dot;
 		R_I_star = delta_I_star = delta_I_star_dot = _V(0.0, 0.0, 0.0);
 
-		cMoon = oapiGetCelbodyInterface(hMoon);
-		mu_E = GGRAV*oapiGetMass(hEarth);
-		mu_M = GGRAV*oapiGetMass(hMoon);
+		cMoon = OrbMech::GetCelbodyInterface(hMoon);
+		mu_E = GGRAV*OrbMech::GetMass(hEarth);
+		mu_M = GGRAV*OrbMech::GetMass(hMoon);
 
 		PeriMJD = opt->PeriGET / 24.0 / 3600.0 + opt->GETbase;
 		R_P = unit(_V(cos(opt->lng)*cos(opt->lat), sin(opt->lat), sin(opt->lng)*cos(opt->lat)));
@@ -4745,9 +4730,9 @@ void RTCC::LOITargeting(LOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &
 
 		R_peri = mul(Rot2, R_P);
 		//R_peri = unit(mul(Rot, _V(R_peri.x, R_peri.z, R_peri.y)))*(oapiGetSize(hMoon) + opt->h_peri);
-		R_peri = unit(_V(R_peri.x, R_peri.z, R_peri.y))*(oapiGetSize(hMoon) + opt->h_peri);
+		R_peri = unit(_V(R_peri.x, R_peri.z, R_peri.y))*(OrbMech::GetSize(hMoon) + opt->h_peri);
 
-		cMoon->clbkEphemeris(PeriMJD, EPHEM_TRUEPOS | EPHEM_TRUEVEL, MoonPos);
+		OrbMech::Ephemeris(cMoon, PeriMJD, EPHEM_TRUEPOS | EPHEM_TRUEVEL, MoonPos);
 		//R_m = mul(Rot, _V(MoonPos[0], MoonPos[2], MoonPos[1]));
 		//V_m = mul(Rot, _V(MoonPos[3], MoonPos[5], MoonPos[4]));
 		R_m = _V(MoonPos[0], MoonPos[2], MoonPos[1]);
@@ -4760,12 +4745,12 @@ void RTCC::LOITargeting(LOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &
 		double TIGvar[3], dv[3];
 		VECTOR3 Llambda, R2_cor, V2_cor, dVLVLH; double t_slip, f_T, isp, boil, m1, m0, TIG, mcut;
 
-		f_T = opt->vessel->GetThrusterMax0(opt->vessel->GetGroupThruster(THGROUP_MAIN, 0));
-		isp = opt->vessel->GetThrusterIsp0(opt->vessel->GetGroupThruster(THGROUP_MAIN, 0));
+		f_T = GetEngineThrust(opt->vessel, THGROUP_MAIN);
+		isp = GetEngineIsp(opt->vessel, THGROUP_MAIN);
 		boil = (1.0 - 0.99998193) / 10.0;
-		m0 = opt->vessel->GetEmptyMass();
+		m0 = GetVesselEmptyMass(opt->vessel);
 
-		while (abs(dTIG) > 0.01)
+		while (abs(dTIG) > 0.01 && !JobCancelled())
 		{
 			TIGMJD = TIGguess / 24.0 / 3600.0 + opt->GETbase;
 			dt1 = TIGguess - (SVMJD - opt->GETbase) * 24.0 * 60.0 * 60.0;
@@ -4773,7 +4758,7 @@ void RTCC::LOITargeting(LOIMan *opt, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &
 			OrbMech::oneclickcoast(R0B, V0B, SVMJD, dt1, RA1, VA1, gravref, hEarth);
 
 			//Initial trajectory, only accurate to 1000 meters
-			V_peri = OrbMech::ThreeBodyLambert(PeriMJD, TIGMJD, R_peri, V_m, RA1, R_m, V_m, 24.0*oapiGetSize(hEarth), mu_E, mu_M, R_I_star, delta_I_star, delta_I_star_dot);
+			V_peri = OrbMech::ThreeBodyLambert(PeriMJD, TIGMJD, R_peri, V_m, RA1, R_m, V_m, 24.0*OrbMech::GetSize(hEarth), mu_E, mu_M, R_I_star, delta_I_star, delta_I_star_dot);
 			//OrbMech::oneclickcoast(R_peri, V_peri, PeriMJD, -dt2, RA2, VA1_apo, hMoon, hEarth);
 
 			//Precise backwards targeting
@@ -4841,7 +4826,7 @@ void RTCC::OrbitAdjustCalc(OrbAdjOpt *opt, VECTOR3 &dV_LVLH, double &P30TIG)
 	MATRIX3 obli, Q_Xx;
 	VECTOR3 VXvec[4], DVXvec[4];
 
-	mu = GGRAV*oapiGetMass(opt->gravref);									//Standard gravitational parameter GM
+	mu = GGRAV*OrbMech::GetMass(opt->gravref);									//Standard gravitational parameter GM
 
 	SPSMJD = opt->GETbase + opt->SPSGET / 24.0 / 60.0 / 60.0;					//The MJD of the maneuver
 	obli = OrbMech::GetObliquityMatrix(opt->gravref, SPSMJD);
@@ -4855,10 +4840,8 @@ void RTCC::OrbitAdjustCalc(OrbAdjOpt *opt, VECTOR3 &dV_LVLH, double &P30TIG)
 	}
 	else
 	{
-		opt->vessel->GetRelativePos(opt->gravref, RPOS);				//The current position vecotr of the vessel in the ecliptic frame
-		opt->vessel->GetRelativeVel(opt->gravref, RVEL);				//The current velocity vector of the vessel in the ecliptic frame
-		SVMJD = oapiGetSimMJD();										//The time mark for this state vector
-		CSMmass = opt->vessel->GetMass();
+		GetVesselState(opt->vessel, opt->gravref, RPOS, RVEL, SVMJD);	//The current position and velocity vector of the vessel in the ecliptic frame, and the time mark for this state vector
+		CSMmass = GetVesselMass(opt->vessel);
 
 		Requ = _V(RPOS.x, RPOS.z, RPOS.y);
 		Vequ = _V(RVEL.x, RVEL.z, RVEL.y);
@@ -4876,13 +4859,13 @@ void RTCC::OrbitAdjustCalc(OrbAdjOpt *opt, VECTOR3 &dV_LVLH, double &P30TIG)
 	R3 = _V(R3.x, R3.z, R3.y);
 	V3 = _V(V3.x, V3.z, V3.y);
 
-	if (opt->gravref == oapiGetObjectByName("Earth"))
+	if (opt->gravref == OrbMech::GetObjectByName("Earth"))
 	{
 		R_E = 6373338.0;// OrbMech::fischer_ellipsoid(R2);				//The radius of the Earth according to the AGC. This is the radius at launch?
 	}
 	else
 	{
-		R_E = oapiGetSize(opt->gravref);
+		R_E = OrbMech::GetSize(opt->gravref);
 	}
 
 	//OrbMech::local_to_equ(R2, r, phi, lambda);							//Calculates the radius, latitude and longitude of the maneuver position
@@ -5009,17 +4992,15 @@ void RTCC::TLI_PAD(TLIPADOpt* opt, TLIPAD &pad)
 
 	sv0.gravref = AGCGravityRef(opt->vessel);
 
-	opt->vessel->GetRelativePos(sv0.gravref, R_A);
-	opt->vessel->GetRelativeVel(sv0.gravref, V_A);
-	SVMJD = oapiGetSimMJD();
+	GetVesselState(opt->vessel, sv0.gravref, R_A, V_A, SVMJD);
 
 	dt = opt->TIG - (SVMJD - opt->GETbase) * 24.0 * 60.0 * 60.0;
 
 	R0 = _V(R_A.x, R_A.z, R_A.y);
 	V0 = _V(V_A.x, V_A.z, V_A.y);
 
-	m0 = opt->vessel->GetEmptyMass();
-	mass = opt->vessel->GetMass();
+	m0 = GetVesselEmptyMass(opt->vessel);
+	mass = GetVesselMass(opt->vessel);
 
 	sv0.MJD = SVMJD;
 	sv0.R = R0;
@@ -5062,13 +5043,13 @@ void RTCC::TLI_PAD(TLIPADOpt* opt, TLIPAD &pad)
 		UZ = unit(-sv1.R);
 		UX = crossp(UY, UZ);
 
-		v_e = opt->vessel->GetThrusterIsp0(opt->vessel->GetGroupThruster(THGROUP_MAIN, 0));
-		F = opt->vessel->GetThrusterMax0(opt->vessel->GetGroupThruster(THGROUP_MAIN, 0));
+		v_e = GetEngineIsp(opt->vessel, THGROUP_MAIN);
+		F = GetEngineThrust(opt->vessel, THGROUP_MAIN);
 
 		DV_P = UX*opt->dV_LVLH.x + UZ*opt->dV_LVLH.z;
 		if (length(DV_P) != 0.0)
 		{
-			theta_T = length(crossp(sv1.R, sv1.V))*length(opt->dV_LVLH)*opt->vessel->GetMass() / OrbMech::power(length(sv1.R), 2.0) / F;
+			theta_T = length(crossp(sv1.R, sv1.V))*length(opt->dV_LVLH)*GetVesselMass(opt->vessel) / OrbMech::power(length(sv1.R), 2.0) / F;
 			DV_C = (unit(DV_P)*cos(theta_T / 2.0) + unit(crossp(DV_P, UY))*sin(theta_T / 2.0))*length(DV_P);
 			V_G = DV_C + UY*opt->dV_LVLH.y;
 		}
@@ -5518,28 +5499,20 @@ SV RTCC::ExecuteManeuver(VESSEL* vessel, double GETbase, double P30TIG, VECTOR3
 	VECTOR3 UX, UY, UZ, DV, DV_P, V_G, DV_C;
 	SV sv2, sv3;
 
-	if (vessel->GetGroupThruster(THGROUP_MAIN, 0))
+	if (F == 0.0 || isp == 0.0)
 	{
-		if (F == 0.0)
-		{
-			F = vessel->GetThrusterMax0(vessel->GetGroupThruster(THGROUP_MAIN, 0));
-		}
+		double f_T, v_e;
+
+		GetThrusterParameters(vessel, f_T, v_e);
 
-		if (isp == 0.0)
-		{
-			isp = vessel->GetThrusterIsp0(vessel->GetGroupThruster(THGROUP_MAIN, 0));
-		}
-	}
-	else
-	{
 		if (F == 0.0)
 		{
-			F = vessel->GetThrusterMax0(vessel->GetGroupThruster(THGROUP_HOVER, 0));
+			F = f_T;
 		}
 
 		if (isp == 0.0)
 		{
-			isp = vessel->GetThrusterIsp0(vessel->GetGroupThruster(THGROUP_HOVER, 0));
+			isp = v_e;
 		}
 	}
 
@@ -5590,28 +5563,20 @@ SV RTCC::ExecuteManeuver(VESSEL* vessel, double GETbase, double P30TIG, VECTOR3
 	VECTOR3 UX, UY, UZ, DV, DV_P, DV_C;
 	SV sv2, sv3;
 
-	if (vessel->GetGroupThruster(THGROUP_MAIN, 0))
+	if (F == 0.0 || isp == 0.0)
 	{
-		if (F == 0.0)
-		{
-			F = vessel->GetThrusterMax0(vessel->GetGroupThruster(THGROUP_MAIN, 0));
-		}
+		double f_T, v_e;
+
+		GetThrusterParameters(vessel, f_T, v_e);
 
-		if (isp == 0.0)
-		{
-			isp = vessel->GetThrusterIsp0(vessel->GetGroupThruster(THGROUP_MAIN, 0));
-		}
-	}
-	else
-	{
 		if (F == 0.0)
 		{
-			F = vessel->GetThrusterMax0(vessel->GetGroupThruster(THGROUP_HOVER, 0));
+			F = f_T;
 		}
 
 		if (isp == 0.0)
 		{
-			isp = vessel->GetThrusterIsp0(vessel->GetGroupThruster(THGROUP_HOVER, 0));
+			isp = v_e;
 		}
 	}
 
@@ -5654,12 +5619,12 @@ void RTCC::TEITargeting(TEIOpt *opt, EntryResults *res)//VECTOR3 &dV_LVLH, doubl
 	VECTOR3 Llambda, R_cor, V_cor, i, j, k;
 	double t_slip, SVMJD;
 	MATRIX3 Q_Xx;
-	OBJHANDLE hEarth = oapiGetObjectByName("Earth");
-	OBJHANDLE hMoon = oapiGetObjectByName("Moon");
+	OBJHANDLE hEarth = OrbMech::GetObjectByName("Earth");
+	OBJHANDLE hMoon = OrbMech::GetObjectByName("Moon");
 	OBJHANDLE gravref = AGCGravityRef(opt->vessel);
 
 	EMSAlt = 297431.0*0.3048;
-	mu_E = GGRAV*oapiGetMass(hEarth);
+	mu_E = GGRAV*OrbMech::GetMass(hEarth);
 
 	if (opt->useSV)
 	{
@@ -5672,13 +5637,11 @@ void RTCC::TEITargeting(TEIOpt *opt, EntryResults *res)//VECTOR3 &dV_LVLH, doubl
 	else
 	{
 		gravref = AGCGravityRef(opt->vessel);
-		opt->vessel->GetRelativePos(gravref, R_A);
-		opt->vessel->GetRelativeVel(gravref, V_A);
-		SVMJD = oapiGetSimMJD();
+		GetVesselState(opt->vessel, gravref, R_A, V_A, SVMJD);
 		R0M = _V(R_A.x, R_A.z, R_A.y);
 		V0M = _V(V_A.x, V_A.z, V_A.y);
 
-		CSMmass = opt->vessel->GetMass();
+		CSMmass = GetVesselMass(opt->vessel);
 	}
 
 
@@ -5694,12 +5657,14 @@ void RTCC::TEITargeting(TEIOpt *opt, EntryResults *res)//VECTOR3 &dV_LVLH, doubl
 
 	teicalc = new TEI(R0M, V0M, SVMJD, gravref, MJDguess, opt->EntryLng, opt->entrylongmanual, opt->returnspeed, opt->TEItype, opt->RevsTillTEI);
 
-	while (!endi)
+	int iter = 0;
+	while (!endi && !JobCancelled())
 	{
 		endi = teicalc->TEIiter();
+		JobProgress(++iter);
 	}
 
-	dt22 = OrbMech::time_radius(teicalc->R_EI, teicalc->V_EI, oapiGetSize(hEarth) + EMSAlt, -1, mu_E);
+	dt22 = OrbMech::time_radius(teicalc->R_EI, teicalc->V_EI, OrbMech::GetSize(hEarth) + EMSAlt, -1, mu_E);
 	OrbMech::rv_from_r0v0(teicalc->R_EI, teicalc->V_EI, dt22, R05G, V05G, mu_E); //Entry Interface to 0.05g
 
 	res->latitude = teicalc->EntryLatcor;
@@ -5745,6 +5710,178 @@ void RTCC::TEITargeting(TEIOpt *opt, EntryResults *res)//VECTOR3 &dV_LVLH, doubl
 	delete teicalc;
 }
 
+void RTCC::EntryScan(EntryOpt *opt, std::vector<EntryScanResult> &table)
+{
+	EntryScanResult c;
+	SV sv;
+	int zone, nom;
+
+	if (opt->useSV)
+	{
+		sv = opt->RV_MCC;
+	}
+	else
+	{
+		sv = StateVectorCalc(opt->vessel);
+	}
+
+	table.clear();
+
+	//Deorbit has the minimum DV and the 31.7 line solution for every landing area
+	for (zone = 0;zone < 5;zone++)
+	{
+		if (opt->entrylongmanual && zone > 0) break;
+		for (nom = 0;nom < 2;nom++)
+		{
+			if (opt->type != RTCC_ENTRY_DEORBIT && nom > 0) break;
+
+			c.landingzone = opt->entrylongmanual ? -1 : zone;
+			c.nominal = nom == 1;
+			table.push_back(c);
+		}
+	}
+
+	ScanParallel(table, [&](EntryScanResult &res)
+	{
+		Entry entry(sv.R, sv.V, sv.MJD, sv.gravref, opt->GETbase, opt->TIGguess, opt->ReA, res.landingzone < 0 ? opt->lng : (double)res.landingzone, opt->type, opt->Range, res.nominal, res.landingzone < 0);
+		bool stop = false;
+		int iter = 0;
+
+		while (!stop && iter < RTCC_SCAN_MAXITER && !JobCancelled())
+		{
+			stop = entry.EntryIter();
+			iter++;
+		}
+		if (!stop) return;
+
+		res.dv = length(entry.Entry_DV);
+		res.P30TIG = entry.EntryTIGcor;
+		res.GET400K = entry.t2;
+		res.latitude = entry.EntryLatcor;
+		res.longitude = entry.EntryLngcor;
+		res.ReA = entry.EntryAng;
+		res.precision = entry.precision;
+	});
+}
+
+void RTCC::TEIScan(TEIOpt *opt, std::vector<EntryScanResult> &table)
+{
+	EntryScanResult c;
+	SV sv;
+	double MJDguess, T_P;
+	int revs, rev, zone, speed;
+	OBJHANDLE hMoon = OrbMech::GetObjectByName("Moon");
+
+	if (opt->useSV)
+	{
+		sv = opt->RV_MCC;
+	}
+	else
+	{
+		sv = StateVectorCalc(opt->vessel);
+	}
+
+	if (opt->TIGguess == 0.0)
+	{
+		MJDguess = sv.MJD;
+	}
+	else
+	{
+		MJDguess = opt->GETbase + opt->TIGguess / 24.0 / 3600.0;
+	}
+
+	//Flyby and PC+2 have a fixed TIG, so there is only one rev to look at
+	if (opt->TEItype == 0)
+	{
+		revs = RTCC_SCAN_TEI_REVS;
+		T_P = OrbMech::period(sv.R, sv.V, GGRAV*OrbMech::GetMass(hMoon));
+	}
+	else
+	{
+		revs = 1;
+		T_P = 0.0;
+	}
+
+	table.clear();
+
+	for (rev = 0;rev < revs;rev++)
+	{
+		for (zone = 0;zone < 5;zone++)
+		{
+			if (opt->entrylongmanual && zone > 0) break;
+			for (speed = 0;speed < 3;speed++)
+			{
+				c.rev = rev;
+				c.landingzone = opt->entrylongmanual ? -1 : zone;
+				c.returnspeed = speed;
+				table.push_back(c);
+			}
+		}
+	}
+
+	ScanParallel(table, [&](EntryScanResult &res)
+	{
+		TEI teicalc(sv.R, sv.V, sv.MJD, sv.gravref, MJDguess + T_P*(double)res.rev / 24.0 / 3600.0, res.landingzone < 0 ? opt->EntryLng : (double)res.landingzone, res.landingzone < 0, res.returnspeed, opt->TEItype, 0);
+		bool endi = false;
+		int iter = 0;
+
+		while (!endi && iter < RTCC_SCAN_MAXITER && !JobCancelled())
+		{
+			endi = teicalc.TEIiter();
+			iter++;
+		}
+		if (!endi) return;
+
+		res.dv = length(teicalc.Entry_DV);
+		res.P30TIG = (teicalc.TIG - opt->GETbase)*24.0*3600.0;
+		res.GET400K = (teicalc.EIMJD - opt->GETbase)*24.0*3600.0;
+		res.latitude = teicalc.EntryLatcor;
+		res.longitude = teicalc.EntryLngcor;
+		res.ReA = teicalc.EntryAng;
+		res.precision = teicalc.precision;
+	});
+}
+
+//Calculates the options of a scan on all cores and ranks them by DV. Every thread takes the next
+//option until none are left, so the result doesn't depend on which thread did which option.
+//The helpers use the body snapshot of the caller, so they don't call Orbiter for the Earth and the Moon either.
+void RTCC::ScanParallel(std::vector<EntryScanResult> &table, std::function<void(EntryScanResult &)> calc)
+{
+	std::atomic<int> next(0), done(0);
+	std::vector<std::thread> threads;
+	Job *job = CurrentJob();
+	const OrbMech::BodySnapshot *bodies = OrbMech::CurrentBodySnapshot();
+	int n = (int)table.size();
+	int nthreads = (int)std::thread::hardware_concurrency();
+
+	auto worker = [&]()
+	{
+		int i;
+		while ((i = next++) < n && !JobCancelled())
+		{
+			calc(table[i]);
+			JobProgress(++done);
+		}
+	};
+
+	//The helpers share the caller's job, so cancelling it stops all of them
+	for (int t = 1;t < nthreads && t < n;t++)
+	{
+		threads.push_back(std::thread([&]() { CurrentJob() = job; OrbMech::BodySnapshotScope scope(bodies); worker(); }));
+	}
+	worker();
+	for (size_t t = 0;t < threads.size();t++)
+	{
+		threads[t].join();
+	}
+
+	std::stable_sort(table.begin(), table.end(), [](const EntryScanResult &a, const EntryScanResult &b)
+	{
+		if (a.precision == 9 || b.precision == 9) return a.precision != 9 && b.precision == 9;
+		return a.dv < b.dv;
+	});
+}
+
 SV RTCC::coast(SV sv0, double dt)
 {
 	SV sv1;
@@ -5829,16 +5966,14 @@ void RTCC::LVDCTLIPredict(LVDCTLIparam lvdc, VESSEL* vessel, double GETbase, VEC
 
 	//Constants
 	gravref = AGCGravityRef(vessel);
-	mu_E = GGRAV*oapiGetMass(gravref);
+	mu_E = GGRAV*OrbMech::GetMass(gravref);
 	boil = (1.0 - 0.99998193) / 10.0;
 
 	//State Vector
-	modf(oapiGetSimMJD(), &day);
+	GetVesselState(vessel, gravref, R_A, V_A, SVMJD);
+	modf(SVMJD, &day);
 	MJD_GRR = day + lvdc.T_L / 24.0 / 3600.0;
 	mat = OrbMech::Orbiter2PACSS13(MJD_GRR, 28.6082888*RAD, -80.6041140*RAD, lvdc.Azimuth);
-	vessel->GetRelativePos(gravref, R_A);
-	vessel->GetRelativeVel(gravref, V_A);
-	SVMJD = oapiGetSimMJD();
 	R0 = _V(R_A.x, R_A.z, R_A.y);
 	V0 = _V(V_A.x, V_A.z, V_A.y);
 
@@ -5909,10 +6044,10 @@ void RTCC::LVDCTLIPredict(LVDCTLIparam lvdc, VESSEL* vessel, double GETbase, VEC
 	VECTOR3 Pos4, PosXEZ, DotXEZ, ddotG_act, DDotXEZ_G;
 	MATRIX3 MX_phi_T, MX_K;
 
-	Fs = vessel->GetThrusterMax0(vessel->GetGroupThruster(THGROUP_MAIN, 0));
-	V_ex = vessel->GetThrusterIsp0(vessel->GetGroupThruster(THGROUP_MAIN, 0));
-	mass = vessel->GetMass();
-	m0 = vessel->GetEmptyMass();
+	Fs = GetEngineThrust(vessel, THGROUP_MAIN);
+	V_ex = GetEngineIsp(vessel, THGROUP_MAIN);
+	mass = GetVesselMass(vessel);
+	m0 = GetVesselEmptyMass(vessel);
 	dt1 = dt + (MJD_TST - SVMJD) * 24.0 * 3600.0;
 	m1 = (mass - m0)*exp(-boil*dt1);
 
@@ -6019,7 +6154,7 @@ void RTCC::FiniteBurntimeCompensation(VESSEL *vessel, SV sv, double attachedMass
 
 	sv_out.gravref = sv.gravref;
 
-	if (vessel->GetGroupThruster(THGROUP_MAIN, 0))
+	if (HasMainThruster(vessel))
 	{
 		GetThrusterParameters(vessel, f_T, isp);
 
@@ -6056,7 +6191,7 @@ void RTCC::FiniteBurntimeCompensation(VESSEL *vessel, SV sv, double attachedMass
 	double f_T, isp, F_average, MJD, mass;
 	VECTOR3 R, V;
 
-	if (vessel->GetGroupThruster(THGROUP_MAIN, 0))	//Criterion: If no main thruster group, it's a LEM.
+	if (HasMainThruster(vessel))	//Criterion: If no main thruster group, it's a LEM.
 	{
 		GetThrusterParameters(vessel, f_T, isp);
 
@@ -6078,15 +6213,15 @@ void RTCC::FiniteBurntimeCompensation(VESSEL *vessel, SV sv, double attachedMass
 void RTCC::GetThrusterParameters(VESSEL *vessel, double &f_T, double &isp)
 {
 	//If there is no main thruster group, then it will select the hover thruster group. Relevant for LM.
-	if (vessel->GetGroupThruster(THGROUP_MAIN, 0))
+	if (HasMainThruster(vessel))
 	{
-		f_T = vessel->GetThrusterMax0(vessel->GetGroupThruster(THGROUP_MAIN, 0));
-		isp = vessel->GetThrusterIsp0(vessel->GetGroupThruster(THGROUP_MAIN, 0));
+		f_T = GetEngineThrust(vessel, THGROUP_MAIN);
+		isp = GetEngineIsp(vessel, THGROUP_MAIN);
 	}
 	else
 	{
-		f_T = vessel->GetThrusterMax0(vessel->GetGroupThruster(THGROUP_HOVER, 0));
-		isp = vessel->GetThrusterIsp0(vessel->GetGroupThruster(THGROUP_HOVER, 0));
+		f_T = GetEngineThrust(vessel, THGROUP_HOVER);
+		isp = GetEngineIsp(vessel, THGROUP_HOVER);
 	}
 }
 
@@ -6101,6 +6236,12 @@ double RTCC::GetDockedVesselMass(VESSEL *vessel)
 	OBJHANDLE hLM;
 	VESSEL *lm;
 	double LMmass;
+	const VesselSnapshot *snap = GetSnapshot(vessel);
+
+	if (snap)
+	{
+		return snap->dockedmass;
+	}
 
 	if (vessel->DockingStatus(0) == 1)
 	{
@@ -6117,6 +6258,147 @@ double RTCC::GetDockedVesselMass(VESSEL *vessel)
 	return LMmass;
 }
 
+//Vessel snapshots of the calculation running on this thread, NULL if the RTCC calls the vessels
+static thread_local const std::vector<VesselSnapshot> *CurrentSnapshots = NULL;
+
+RTCCSnapshotScope::RTCCSnapshotScope(const std::vector<VesselSnapshot> &snapshots)
+{
+	previous = CurrentSnapshots;
+	CurrentSnapshots = &snapshots;
+}
+
+RTCCSnapshotScope::~RTCCSnapshotScope()
+{
+	CurrentSnapshots = previous;
+}
+
+VesselSnapshot RTCC::TakeSnapshot(VESSEL *vessel)
+{
+	VesselSnapshot snap;
+	THRUSTER_HANDLE th;
+
+	snap.vessel = vessel;
+	snap.MJD = oapiGetSimMJD();
+	snap.gravref = AGCGravityRef(vessel);
+	snap.hEarth = oapiGetObjectByName("Earth");
+	snap.hMoon = oapiGetObjectByName("Moon");
+
+	vessel->GetRelativePos(snap.hEarth, snap.R_Earth);
+	vessel->GetRelativeVel(snap.hEarth, snap.V_Earth);
+	vessel->GetRelativePos(snap.hMoon, snap.R_Moon);
+	vessel->GetRelativeVel(snap.hMoon, snap.V_Moon);
+
+	snap.mass = vessel->GetMass();
+	snap.emptymass = vessel->GetEmptyMass();
+	snap.dockedmass = GetDockedVesselMass(vessel);
+
+	th = vessel->GetGroupThruster(THGROUP_MAIN, 0);
+	if (th)
+	{
+		snap.hasmain = true;
+		snap.F_main = vessel->GetThrusterMax0(th);
+		snap.isp_main = vessel->GetThrusterIsp0(th);
+	}
+	th = vessel->GetGroupThruster(THGROUP_HOVER, 0);
+	if (th)
+	{
+		snap.F_hover = vessel->GetThrusterMax0(th);
+		snap.isp_hover = vessel->GetThrusterIsp0(th);
+	}
+
+	return snap;
+}
+
+const VesselSnapshot *RTCC::GetSnapshot(VESSEL *vessel)
+{
+	if (CurrentSnapshots)
+	{
+		for (size_t i = 0;i < CurrentSnapshots->size();i++)
+		{
+			if ((*CurrentSnapshots)[i].vessel == vessel)
+			{
+				return &(*CurrentSnapshots)[i];
+			}
+		}
+	}
+	return NULL;
+}
+
+void RTCC::GetVesselState(VESSEL *vessel, OBJHANDLE gravref, VECTOR3 &R, VECTOR3 &V, double &MJD)
+{
+	//OUTPUT:
+	//R, V: position and velocity relative to gravref, in the Orbiter frame like VESSEL::GetRelativePos
+	//MJD: time mark of the state vector
+
+	const VesselSnapshot *snap = GetSnapshot(vessel);
+
+	if (snap && gravref == snap->hEarth)
+	{
+		R = snap->R_Earth;
+		V = snap->V_Earth;
+		MJD = snap->MJD;
+	}
+	else if (snap && gravref == snap->hMoon)
+	{
+		R = snap->R_Moon;
+		V = snap->V_Moon;
+		MJD = snap->MJD;
+	}
+	else
+	{
+		vessel->GetRelativePos(gravref, R);
+		vessel->GetRelativeVel(gravref, V);
+		MJD = oapiGetSimMJD();
+	}
+}
+
+double RTCC::GetVesselMass(VESSEL *vessel)
+{
+	const VesselSnapshot *snap = GetSnapshot(vessel);
+
+	return snap ? snap->mass : vessel->GetMass();
+}
+
+double RTCC::GetVesselEmptyMass(VESSEL *vessel)
+{
+	const VesselSnapshot *snap = GetSnapshot(vessel);
+
+	return snap ? snap->emptymass : vessel->GetEmptyMass();
+}
+
+bool RTCC::HasMainThruster(VESSEL *vessel)
+{
+	const VesselSnapshot *snap = GetSnapshot(vessel);
+
+	return snap ? snap->hasmain : vessel->GetGroupThruster(THGROUP_MAIN, 0) != NULL;
+}
+
+double RTCC::GetEngineThrust(VESSEL *vessel, THGROUP_TYPE thgroup)
+{
+	//thgroup: THGROUP_MAIN or THGROUP_HOVER
+
+	const VesselSnapshot *snap = GetSnapshot(vessel);
+
+	if (snap)
+	{
+		return thgroup == THGROUP_MAIN ? snap->F_main : snap->F_hover;
+	}
+	return vessel->GetThrusterMax0(vessel->GetGroupThruster(thgroup, 0));
+}
+
+double RTCC::GetEngineIsp(VESSEL *vessel, THGROUP_TYPE thgroup)
+{
+	//thgroup: THGROUP_MAIN or THGROUP_HOVER
+
+	const VesselSnapshot *snap = GetSnapshot(vessel);
+
+	if (snap)
+	{
+		return thgroup == THGROUP_MAIN ? snap->isp_main : snap->isp_hover;
+	}
+	return vessel->GetThrusterIsp0(vessel->GetGroupThruster(thgroup, 0));
+}
+
 double RTCC::PericynthionTime(VESSEL *vessel)
 {
 	OBJHANDLE gravref;
@@ -6126,10 +6408,8 @@ double RTCC::PericynthionTime(VESSEL *vessel)
 	GETbase = getGETBase();
 	gravref = AGCGravityRef(vessel);
 
-	mu = GGRAV*oapiGetMass(gravref);
-	vessel->GetRelativePos(gravref, R_A);
-	vessel->GetRelativeVel(gravref, V_A);
-	SVMJD = oapiGetSimMJD();
+	mu = GGRAV*OrbMech::GetMass(gravref);
+	GetVesselState(vessel, gravref, R_A, V_A, SVMJD);
 	R0 = _V(R_A.x, R_A.z, R_A.y);
 	V0 = _V(V_A.x, V_A.z, V_A.y);
 
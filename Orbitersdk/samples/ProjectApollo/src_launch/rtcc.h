@@ -23,6 +23,10 @@ See http://nassp.sourceforge.net/license/ for more details.
 
 #if !defined(_PA_RTCC_H)
 #define _PA_RTCC_H
+
+#include <vector>
+#include <functional>
+
 #define RTCC_START_STRING	"RTCC_BEGIN"
 #define RTCC_END_STRING	    "RTCC_END"
 
@@ -43,6 +47,9 @@ See http://nassp.sourceforge.net/license/ for more details.
 #define RTCC_ENTRY_MINDV 0
 #define RTCC_ENTRY_NOMINAL 1
 
+#define RTCC_SCAN_TEI_REVS 4		//Revolutions scanned for TEI options
+#define RTCC_SCAN_MAXITER 1000		//Iterations before an option is given up
+
 const double LaunchMJD[11] = {//Launch MJD of Apollo missions
 	40140.62691,
 	40211.535417,
@@ -66,6 +73,35 @@ struct SV
 	double mass = 0.0;
 };
 
+//What the RTCC reads from a vessel, taken on the simulation thread with RTCC::TakeSnapshot() when a
+//calculation is queued. While an RTCCSnapshotScope is installed on the worker thread, the RTCC uses it
+//instead of calling the vessel.
+struct VesselSnapshot
+{
+	VESSEL *vessel = NULL;
+	double MJD = 0.0;				//Simulation MJD the snapshot was taken at
+	OBJHANDLE gravref = NULL;		//AGCGravityRef()
+	OBJHANDLE hEarth = NULL, hMoon = NULL;
+	VECTOR3 R_Earth = _V(0, 0, 0), V_Earth = _V(0, 0, 0);	//Relative to the Earth, Orbiter frame
+	VECTOR3 R_Moon = _V(0, 0, 0), V_Moon = _V(0, 0, 0);	//Relative to the Moon, Orbiter frame
+	double mass = 0.0;
+	double emptymass = 0.0;
+	double dockedmass = 0.0;		//GetDockedVesselMass()
+	bool hasmain = false;			//Has a main thruster group. If not, it's a LEM.
+	double F_main = 0.0, isp_main = 0.0;
+	double F_hover = 0.0, isp_hover = 0.0;
+};
+
+//Makes the RTCC use the snapshots instead of the vessels on this thread, until it goes out of scope
+class RTCCSnapshotScope
+{
+public:
+	RTCCSnapshotScope(const std::vector<VesselSnapshot> &snapshots);
+	~RTCCSnapshotScope();
+protected:
+	const std::vector<VesselSnapshot> *previous;
+};
+
 struct LambertMan //Data for Lambert targeting
 {
 	VESSEL* vessel; //Vessel executing the burn
@@ -179,6 +215,21 @@ struct TEIOpt
 	bool entrylongmanual = true; //Targeting a landing zone or a manual landing longitude
 };
 
+//One option of an entry or TEI scan, impulsive
+struct EntryScanResult
+{
+	double dv = 0.0;		//Total DV
+	double P30TIG = 0.0;	//GET of ignition
+	double GET400K = 0.0;	//GET of entry interface
+	double latitude = 0.0, longitude = 0.0;	//Splashdown coordinates
+	double ReA = 0.0;		//Reentry angle
+	int landingzone = -1;	//Landing zone, -1 for manual longitude
+	int returnspeed = 1;	//0 = slow return, 1 = normal return, 2 = fast return
+	int rev = 0;			//Revolutions until TEI
+	bool nominal = false;	//Deorbit on the 31.7 line
+	int precision = 9;		//As EntryResults, 9 = iteration failed
+};
+
 struct REFSMMATOpt
 {
 	VESSEL* vessel; //vessel
@@ -386,6 +437,8 @@ public:
 	void AP11LMManeuverPAD(AP11LMManPADOpt *opt, AP11LMMNV &pad);
 	void AP11ManeuverPAD(AP11ManPADOpt *opt, AP11MNV &pad);
 	void TEITargeting(TEIOpt *opt, EntryResults *res);//VECTOR3 &dV_LVLH, double &P30TIG, double &latitude, double &longitude, double &GET05G, double &RTGO, double &VIO, double &EntryAngcor);
+	void EntryScan(EntryOpt *opt, std::vector<EntryScanResult> &table);	//All landing zones, ranked by DV
+	void TEIScan(TEIOpt *opt, std::vector<EntryScanResult> &table);		//All revs, landing zones and return speeds, ranked by DV
 	SevenParameterUpdate TLICutoffToLVDCParameters(VECTOR3 R_TLI, VECTOR3 V_TLI, double P30TIG, double TB5, double mu, double T_RG);
 	void LVDCTLIPredict(LVDCTLIparam lvdc, VESSEL* vessel, double GETbase, VECTOR3 &dV_LVLH, double &P30TIG, VECTOR3 &R_TLI, VECTOR3 &V_TLI, double &T_TLI);
 	void LMThrottleProgram(double F, double v_e, double mass, double dV_LVLH, double &F_average, double &ManPADBurnTime, double &bt_var, int &step);
@@ -393,6 +446,7 @@ public:
 	void FiniteBurntimeCompensation(VESSEL *vessel, SV sv, double attachedMass, VECTOR3 DV, VECTOR3 &DV_imp, double &t_slip, SV &sv_out);
 	void GetThrusterParameters(VESSEL *vessel, double &f_T, double &isp);
 	double GetDockedVesselMass(VESSEL *vessel);
+	VesselSnapshot TakeSnapshot(VESSEL *vessel);			//Only on the simulation thread
 
 	void SaveState(FILEHANDLE scn);							// Save state
 	void LoadState(FILEHANDLE scn);							// Load state
@@ -401,9 +455,17 @@ public:
 	struct calculationParameters calcParams;
 private:
 	void AP7ManeuverPAD(AP7ManPADOpt *opt, AP7MNV &pad);
+	void ScanParallel(std::vector<EntryScanResult> &table, std::function<void(EntryScanResult &)> calc);
 	MATRIX3 GetREFSMMATfromAGC(double AGCEpoch);
 	void navcheck(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE gravref, double &lat, double &lng, double &alt);
 	SV StateVectorCalc(VESSEL *vessel, double SVMJD = 0.0);
+	const VesselSnapshot *GetSnapshot(VESSEL *vessel);
+	void GetVesselState(VESSEL *vessel, OBJHANDLE gravref, VECTOR3 &R, VECTOR3 &V, double &MJD);
+	double GetVesselMass(VESSEL *vessel);
+	double GetVesselEmptyMass(VESSEL *vessel);
+	bool HasMainThruster(VESSEL *vessel);
+	double GetEngineThrust(VESSEL *vessel, THGROUP_TYPE thgroup);
+	double GetEngineIsp(VESSEL *vessel, THGROUP_TYPE thgroup);
 	double getGETBase();
 	void AP7BlockData(AP7BLKOpt *opt, AP7BLK &pad);
 	void AP11BlockData(AP11BLKOpt *opt, P37PAD &pad);
@@ -1257,6 +1257,9 @@ void LEM::clbkLoadStateEx (FILEHANDLE scn, void *vs)
 		else if (!strnicmp(line, IMU_START_STRING, sizeof(IMU_START_STRING))) {
 			imu.LoadState(scn);
 		}
+		else if (!strnicmp(line, AEA_START_STRING, sizeof(AEA_START_STRING))) {
+			aea.LoadState(scn, AEA_END_STRING);
+		}
 		else if (!strnicmp (line, "ECA_1A_START",sizeof("ECA_1A_START"))) {
 			ECA_1a.LoadState(scn,"ECA_1A_END");
 		}
@@ -1510,6 +1513,16 @@ bool LEM::ProcessConfigFileLine(FILEHANDLE scn, char *line)
 		sscanf (line+11, "%d", &value);
 		isMultiThread=(value>0)?true:false;
 	}
+	else if (!strnicmp (line, "AGCPIPELINE", 11)) {
+		int value;
+		sscanf (line+11, "%d", &value);
+		agc.PipelineMode = value;
+	}
+	else if (!strnicmp (line, "FLIGHTLOG", 9)) {
+		int value;
+		sscanf (line+9, "%d", &value);
+		FlightLogSetChannels(value);
+	}
 	else if (!strnicmp (line, "JOYSTICK_RHC", 12)) {
 		sscanf (line + 12, "%i", &rhc_id);
 		if(rhc_id > 1){ rhc_id = 1; } // Be paranoid
@@ -1636,6 +1649,7 @@ void LEM::clbkSaveState (FILEHANDLE scn)
 	dsky.SaveState(scn, DSKY_START_STRING, DSKY_END_STRING);
 	agc.SaveState(scn);
 	imu.SaveState(scn);
+	aea.SaveState(scn, AEA_START_STRING, AEA_END_STRING);
 
 	//
 	// Save the Panel SDK state.
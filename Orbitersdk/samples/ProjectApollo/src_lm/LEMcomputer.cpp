@@ -93,9 +93,7 @@ LEMcomputer::LEMcomputer(SoundLib &s, DSKY &display, IMU &im, PanelSDK &p) : Apo
 LEMcomputer::~LEMcomputer()
 
 {
-	//
-	// Nothing for now.
-	//
+	StopThread();
 }
 
 //
@@ -808,18 +806,6 @@ void LEMcomputer::agcTimestep(double simt, double simdt)
 	GenericTimestep(simt, simdt);
 }
 
-void LEMcomputer::Run ()
-{
-	while(true)
-	{
-		timeStepEvent.Wait();
-		{
-			Lock lock(agcCycleMutex);
-			agcTimestep(thread_simt,thread_simdt);
-		}
-	}
-};
-
 
 void LEMcomputer::Timestep(double simt, double simdt)
 
@@ -881,7 +867,9 @@ void LEMcomputer::Timestep(double simt, double simdt)
 		// If MultiThread is enabled and the simulation is accellerated, the run vAGC in the AGC Thread,
 		// otherwise run in main thread. at x1 acceleration, it is better to run vAGC totally synchronized
 		//
-		if(lem->isMultiThread && oapiGetTimeAcceleration() > 1.0){
+		if (PipelineStep) {
+			PipelineHandoff(simt, simdt);
+		}else if(lem->isMultiThread && oapiGetTimeAcceleration() > 1.0){
 			Lock lock(agcCycleMutex);
 			thread_simt = simt;
 			thread_simdt = simdt;
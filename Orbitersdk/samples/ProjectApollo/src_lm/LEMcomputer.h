@@ -133,7 +133,6 @@ public:
 	int GetProgRunning();
 
 	void Timestep(double simt, double simdt);
-	void Run() ;
 	void agcTimestep(double simt, double simdt);
 
 
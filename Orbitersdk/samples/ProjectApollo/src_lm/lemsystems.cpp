@@ -1316,14 +1316,23 @@ void LEM::SystemsTimestep(double simt, double simdt)
 	// Each timestep is passed to the SPSDK
 	// to perform internal computations on the 
 	// systems.
-	Panelsdk.Timestep(simt);
+	// When pipelined, the AGC runs on its own thread meanwhile, and its
+	// output channels are passed on in FinishTimestep.
+	if (SystemsInitialized >= 4 && agc.IsPipelined()) {
+		agc.StartTimestep(MissionTime, simdt);
+		Panelsdk.Timestep(simt);
+		agc.FinishTimestep();
+	}
+	else
+		Panelsdk.Timestep(simt);
 
 	// Wait for systems init.
 	// This takes 4 timesteps.
 	if(SystemsInitialized < 4){ SystemsInitialized++; return; }
 
 	// After that come all other systems simesteps	
-	agc.Timestep(MissionTime, simdt);						// Do work
+	if (!agc.IsPipelined())
+		agc.Timestep(MissionTime, simdt);					// Do work
 	agc.SystemTimestep(simdt);								// Draw power
 	dsky.Timestep(MissionTime);								// Do work
 	dsky.SystemTimestep(simdt);								// This can draw power now.
@@ -107,22 +107,171 @@ void LEM_ASA::LoadState(FILEHANDLE scn,char *end_str){
 // Abort Electronics Assembly
 LEM_AEA::LEM_AEA(){
 	lem = NULL;	
+	CycleResidual = 0;
+	Powered = false;
+
+	memset(&vags, 0, sizeof(vags));
+
+	int err = aea_engine_init(&vags, "Config/ProjectApollo/FP6.bin", NULL);
+	Loaded = (err == 0);
+	if (!Loaded) {
+		char buffer[256];
+		sprintf(buffer, "ProjectApollo: cannot load AEA flight program Config/ProjectApollo/FP6.bin (error %d)", err);
+		oapiWriteLog(buffer);
+	}
 }
 
 void LEM_AEA::Init(LEM *s){
 	lem = s;
 }
 
+bool LEM_AEA::IsPowered(){
+	if (lem == NULL) { return false; }
+	return (lem->SCS_AEA_CB.Voltage() > 25.0 && lem->AGSOperateSwitch.GetState() == THREEPOSSWITCH_UP);
+}
+
 void LEM_AEA::TimeStep(double simdt){
-	if(lem == NULL){ return; }
+	if(lem == NULL || !Loaded){ return; }
+
+	if (!IsPowered()) {
+		Powered = false;
+		return;
+	}
+
+	if (!Powered) {
+		// Memory survives a power cycle, the flight program restarts at 06000.
+		vags.ProgramCounter = 06000;
+		vags.Halt = 0;
+		vags.Next20msSignal = vags.CycleCounter + AEA_PER_SECOND / 50;
+		CycleResidual = 0;
+		Powered = true;
+	}
+
+	//
+	// Run this timestep's worth of AEA cycles in one batch. The last instruction
+	// may run past the budget, and that is taken off the next timestep.
+	//
+
+	CycleResidual += simdt * AEA_PER_SECOND;
+	if (CycleResidual >= 1.0)
+		CycleResidual -= aea_engine_run(&vags, (int)CycleResidual);
+}
+
+void LEM_AEA::DedaKey(int key, bool pressed){
+	if (!IsPowered()) { return; }
+	aea_engine_deda_key(&vags, key, pressed ? 1 : 0);
+}
+
+void LEM_AEA::DedaShift(const int *chars, int count){
+	if (!IsPowered()) { return; }
+	aea_engine_deda_shift(&vags, chars, count);
+}
+
+bool LEM_AEA::ReadOutput(int &type, int &data){
+	return aea_engine_read_output(&vags, &type, &data) != 0;
 }
 
 void LEM_AEA::SaveState(FILEHANDLE scn,char *start_str,char *end_str){
+	char fname[32], str[32];
+	int i;
+
+	oapiWriteLine(scn, start_str);
+	oapiWriteScenario_int(scn, "POWERED", Powered ? 1 : 0);
+	oapiWriteScenario_int(scn, "PC", vags.ProgramCounter);
+	oapiWriteScenario_int(scn, "A", vags.Accumulator);
+	oapiWriteScenario_int(scn, "Q", vags.Quotient);
+	oapiWriteScenario_int(scn, "INDEX", vags.Index);
+	oapiWriteScenario_int(scn, "OVERFLOW", vags.Overflow);
+	oapiWriteScenario_int(scn, "HALT", vags.Halt);
+	sprintf(str, "%llu", (unsigned long long) vags.CycleCounter);
+	oapiWriteScenario_string(scn, "CYCLECOUNTER", str);
+	sprintf(str, "%llu", (unsigned long long) vags.Next20msSignal);
+	oapiWriteScenario_string(scn, "NEXT20MS", str);
+
+	//
+	// Write out any non-zero erasable memory, and the i/o registers.
+	//
+
+	for (i = 0; i < 04000; i++) {
+		if (vags.Memory[i] != 0) {
+			sprintf(fname, "MEM%04o", i);
+			sprintf(str, "%o", vags.Memory[i]);
+			oapiWriteScenario_string(scn, fname, str);
+		}
+	}
+	for (i = 0; i < NUM_IO; i++) {
+		sprintf(fname, "INPORT%02d", i);
+		sprintf(str, "%o", vags.InputPorts[i]);
+		oapiWriteScenario_string(scn, fname, str);
+		sprintf(fname, "OUTPORT%02d", i);
+		sprintf(str, "%o", vags.OutputPorts[i]);
+		oapiWriteScenario_string(scn, fname, str);
+	}
 
+	oapiWriteLine(scn, end_str);
 }
 
 void LEM_AEA::LoadState(FILEHANDLE scn,char *end_str){
-
+	char *line;
+	int val, num;
+	unsigned long long cycles;
+	bool memory = false;
+
+	while (oapiReadScenario_nextline(scn, line)) {
+		if (!strnicmp(line, end_str, strlen(end_str)))
+			break;
+
+		if (!strnicmp(line, "POWERED", 7)) {
+			sscanf(line + 7, "%d", &val);
+			Powered = (val != 0);
+		}
+		else if (!strnicmp(line, "PC", 2)) {
+			sscanf(line + 2, "%d", &vags.ProgramCounter);
+		}
+		else if (!strnicmp(line, "A ", 2)) {
+			sscanf(line + 1, "%d", &vags.Accumulator);
+		}
+		else if (!strnicmp(line, "Q ", 2)) {
+			sscanf(line + 1, "%d", &vags.Quotient);
+		}
+		else if (!strnicmp(line, "INDEX", 5)) {
+			sscanf(line + 5, "%d", &vags.Index);
+		}
+		else if (!strnicmp(line, "OVERFLOW", 8)) {
+			sscanf(line + 8, "%d", &vags.Overflow);
+		}
+		else if (!strnicmp(line, "HALT", 4)) {
+			sscanf(line + 4, "%d", &vags.Halt);
+		}
+		else if (!strnicmp(line, "CYCLECOUNTER", 12)) {
+			sscanf(line + 12, "%llu", &cycles);
+			vags.CycleCounter = cycles;
+		}
+		else if (!strnicmp(line, "NEXT20MS", 8)) {
+			sscanf(line + 8, "%llu", &cycles);
+			vags.Next20msSignal = cycles;
+		}
+		else if (!strnicmp(line, "MEM", 3)) {
+			// Only non-zero words are saved, so clear the erasable memory first.
+			if (!memory) {
+				memset(vags.Memory, 0, 04000 * sizeof(vags.Memory[0]));
+				memory = true;
+			}
+			sscanf(line + 3, "%o %o", &num, &val);
+			if (num >= 0 && num < 04000)
+				vags.Memory[num] = val & 0777777;
+		}
+		else if (!strnicmp(line, "INPORT", 6)) {
+			sscanf(line + 6, "%d %o", &num, &val);
+			if (num >= 0 && num < NUM_IO)
+				vags.InputPorts[num] = val & 0777777;
+		}
+		else if (!strnicmp(line, "OUTPORT", 7)) {
+			sscanf(line + 7, "%d %o", &num, &val);
+			if (num >= 0 && num < NUM_IO)
+				vags.OutputPorts[num] = val & 0777777;
+		}
+	}
 }
 
 // Data Entry and Display Assembly
@@ -130,6 +279,9 @@ void LEM_AEA::LoadState(FILEHANDLE scn,char *end_str){
 LEM_DEDA::LEM_DEDA(LEM *lm, SoundLib &s,LEM_AEA &computer, int IOChannel) :  lem(lm), soundlib(s), ags(computer)
 
 {
+	HeldKey = 0;
+	HeldKeyTime = 0;
+	HeldKeyReleased = false;
 	Reset();
 	ResetKeyDown();
 	KeyCodeIOChannel = IOChannel;
@@ -158,6 +310,44 @@ void LEM_DEDA::TimeStep(double simdt){
 		FirstTimeStep = false;
 	    soundlib.LoadSound(Sclick, BUTTON_SOUND);
 	}
+
+	//
+	// Let go of CLR or HOLD once the AEA has had time to see it.
+	//
+
+	if (HeldKey) {
+		HeldKeyTime += simdt;
+		if (HeldKeyReleased && HeldKeyTime >= 0.1) {
+			ags.DedaKey(HeldKey, false);
+			HeldKey = 0;
+		}
+	}
+
+	//
+	// Pick up the characters the AEA has shifted out: three address digits,
+	// the sign and five data digits.
+	//
+
+	int type, data;
+
+	while (ags.ReadOutput(type, data)) {
+		if (type != 027)
+			continue;
+
+		ShiftChars[ShiftCount++] = (data >> 13) & 017;
+		if (ShiftCount < 9)
+			continue;
+
+		ShiftCount = 0;
+		if (Held || !IsPowered())
+			continue;
+
+		for (int i = 0; i < 3; i++)
+			Adr[i] = ValueChar(ShiftChars[i]);
+		Data[0] = ((ShiftChars[3] & 1) == DEDA_MINUS) ? '-' : '+';
+		for (int i = 1; i < 6; i++)
+			Data[i] = ValueChar(ShiftChars[i + 3]);
+	}
 }
 
 void LEM_DEDA::SaveState(FILEHANDLE scn,char *start_str,char *end_str){
@@ -182,6 +372,7 @@ void LEM_DEDA::Reset()
 	SegmentsLit = 0;
 	State = 0;
 	Held = false;
+	ShiftCount = 0;
 
 	strcpy (Adr, ThreeSpace);
 	strcpy (Data, SixSpace);
@@ -514,7 +705,8 @@ void LEM_DEDA::ProcessKeyPress(int mx, int my)
 	if (mx > 2+4*44 && mx < 43+4*44) {
 		if (my > 1 && my < 43) {
 			KeyDown_Clear = true;
-//			ClearPressed();
+			if (IsPowered())
+				PressKey(DEDA_KEY_CLR);
 		}
 		if (my > 44 && my < 88) {
 			KeyDown_ReadOut = true;
@@ -540,6 +732,7 @@ void LEM_DEDA::ProcessKeyRelease(int mx, int my)
 			ClearPressed();
 		}
 	}
+	ReleaseKey();
 	ResetKeyDown();
 }
 
@@ -549,6 +742,36 @@ void LEM_DEDA::SendKeyCode(int val)
 	//agc.SetInputChannel(KeyCodeIOChannel, val);
 }
 
+//
+// CLR and HOLD go to the AEA as discretes, for as long as they are held down.
+//
+
+void LEM_DEDA::PressKey(int key)
+
+{
+	if (HeldKey)
+		ags.DedaKey(HeldKey, false);
+
+	ags.DedaKey(key, true);
+	HeldKey = key;
+	HeldKeyTime = 0;
+	HeldKeyReleased = false;
+}
+
+void LEM_DEDA::ReleaseKey()
+
+{
+	HeldKeyReleased = true;
+}
+
+char LEM_DEDA::ValueChar(unsigned val)
+
+{
+	if (val <= 9)
+		return '0' + val;
+	return ' ';
+}
+
 void LEM_DEDA::KeyRel()
 
 {
@@ -558,8 +781,16 @@ void LEM_DEDA::KeyRel()
 void LEM_DEDA::EnterPressed()
 
 {
-	if (State == 9)
-		SendKeyCode(28);
+	if (State == 9) {
+		int chars[9];
+
+		for (int i = 0; i < 3; i++)
+			chars[i] = Adr[i] - '0';
+		chars[3] = (Data[0] == '-') ? DEDA_MINUS : DEDA_PLUS;
+		for (int i = 1; i < 6; i++)
+			chars[i + 3] = Data[i] - '0';
+		ags.DedaShift(chars, 9);
+	}
 	else
 		SetOprErr(true);
 
@@ -597,7 +828,11 @@ void LEM_DEDA::ReadOutPressed()
 
 {
 	if (State == 3){
-		SendKeyCode(18);
+		int chars[3];
+
+		for (int i = 0; i < 3; i++)
+			chars[i] = Adr[i] - '0';
+		ags.DedaShift(chars, 3);
 	} else 
 		SetOprErr(true);
 
@@ -608,7 +843,7 @@ void LEM_DEDA::HoldPressed()
 
 {
 	if (State == 3 || State == 9){
-		SendKeyCode(18);
+		PressKey(DEDA_KEY_HOLD);
 	} else 
 		SetOprErr(true);
 
@@ -22,6 +22,8 @@
 
   **************************************************************************/
 
+#include "yaAGS/aea_engine.h"
+
 // ABORT SENSOR ASSEMBLY (ASA)
 class LEM_ASA{
 public:
@@ -44,7 +46,23 @@ public:
 	void SaveState(FILEHANDLE scn, char *start_str, char *end_str);
 	void LoadState(FILEHANDLE scn, char *end_str);
 	void TimeStep(double simdt);
+	bool IsPowered();
+
+	//
+	// DEDA interface. Key presses and shift register data are queued for the
+	// AEA to pick up as it runs, and the DEDA picks up what the AEA shifts out.
+	//
+
+	void DedaKey(int key, bool pressed);
+	void DedaShift(const int *chars, int count);
+	bool ReadOutput(int &type, int &data);
+
 	LEM *lem;					// Pointer at LEM
+protected:
+	ags_t vags;					// yaAGS state
+	double CycleResidual;		// AEA cycles owed to, or run ahead of, the simulation
+	bool Powered;				// Running on the last timestep
+	bool Loaded;				// Flight program loaded, the AEA doesn't run without it
 };
 
 // DATA ENTRY and DISPLAY ASSEMBLY (DEDA)
@@ -205,10 +223,29 @@ protected:
 
 	bool FirstTimeStep;
 
+	//
+	// CLR or HOLD key held down for the AEA, and for how long. The flight
+	// program polls the keys every 40 ms, so a short click is stretched.
+	//
+
+	int HeldKey;
+	double HeldKeyTime;
+	bool HeldKeyReleased;
+
+	//
+	// Characters the AEA has shifted out since the last full display.
+	//
+
+	int ShiftCount;
+	int ShiftChars[9];
+
 	//
 	// Local helper functions.
 	//
 
+	void PressKey(int key);
+	void ReleaseKey();
+
 	char ValueChar(unsigned val);
 	void ResetKeyDown();
 	void SendKeyCode(int val);
@@ -225,6 +262,9 @@ protected:
 // Strings for state saving.
 //
 
+#define AEA_START_STRING	"AEA_BEGIN"
+#define AEA_END_STRING		"AEA_END"
+
 #define DEDA_START_STRING	"DEDA_BEGIN"
 #define DEDA_END_STRING		"DEDA_END"
 
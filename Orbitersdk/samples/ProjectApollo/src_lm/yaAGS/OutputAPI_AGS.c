@@ -37,6 +37,8 @@
   Contact:	Ron Burkey <info@sandroid.org>
   Reference:	http://www.ibiblio.org/apollo/index.html
   Mods:		06/07/05 RSB.	Began.
+  		NASSP: the packets go through the i/o queues in ags_t
+				instead of sockets.
 */
 
 #include <errno.h>
@@ -50,178 +52,125 @@ typedef unsigned short uint16_t;
 #include "aea_engine.h"
 
 // When we detect the pressing of the READ OUT or ENTR key, we don't immediately
-// pass it along to the CPU.  Instead, we interact with yaDEDA to buffer the
-// 3 or 9 nibbles of shift-register data, and only THEN to we pass the READ OUT
+// pass it along to the CPU.  Instead, we buffer the 3 or 9 nibbles of
+// shift-register data from the DEDA, and only THEN to we pass the READ OUT
 // or ENTR keypress to the CPU.  When the CPU subsequently requests the 
 // data with DEDA Shift In requests, we dole out the data from the buffer rather
-// than passing the requests along to yaDEDA.  This behavior is needed to account
+// than passing the requests along to the DEDA.  This behavior is needed to account
 // for the fact that the flight software assumes that the shift-register data
 // will be available 80 microseconds after requesting it.  We can't meet this
-// timing constraint without buffering the data.
-int DedaBuffer[9], DedaBufferCount = 0, DedaBufferWanted = 0,
-  DedaBufferReadout = 0, DedaBufferDefault = 0;
+// timing constraint without buffering the data.  The buffer is in ags_t, so
+// that every AEA has its own.
 
 //-----------------------------------------------------------------------------
-// Function for broadcasting "output channel" data to all connected clients of
-// yaAGS.
+// Function for passing "output channel" data to the peripherals.
 
 void
-ChannelOutputAGS (int Type, int Data)
+ChannelOutputAGS (ags_t * State, int Type, int Data)
 {
-	//
-	// This will need to pass the data to the NASSP code.
-	//
+  aea_engine_put_output (State, Type, Data);
 }
 
 //----------------------------------------------------------------------------
 // Function for fetching yaAGS input-channel data into the State structure's
-// input-channel buffer.
+// input-channel buffer.  We process at most one packet per instruction cycle.
 
 int 
 ChannelInputAGS (ags_t * State)
 {
-	//
-	// This will need to accept data from the NASSP code and pass it through to Virtual
-	// AGS.
-	//
-#if 0
-  static int SocketInterlace = 0;
-  int i, j, k;
-  unsigned char c;
-  Client_t *Client;
-  int Mask;
-  
-  //We use SocketInterlace to slow down the number
-  // of polls of the sockets.
-  if (SocketInterlace > 0)
-    SocketInterlace--;
-  else
+  int j, k, Mask, Type, Data;
+
+  if (!aea_engine_get_input (State, &Type, &Data))
+    return (0);
+
+  switch (Type)
     {
-      SocketInterlace = SocketInterlaceReload;
-      for (i = 0, Client = Clients; i < MAX_CLIENTS; i++, Client++)
-	if (Client->Socket != -1)
-	  {
-	    // We arbitrarily adopt the rule that we'll process at most one
-	    // packet per client per instruction cycle.
-	    for (j = Client->Size; j < 4; j++)
-	      {
-		k = recv (Client->Socket, &c, 1, 0);
-		if (k == 0 || k == -1)
-		  break;
-		Client->Packet[Client->Size++] = c;
-	      }
-	    // Process a received packet.
-	    if (Client->Size >= 4)
-	      {
-		int Type, Data;
-		//printf ("Received from %d: %02X %02X %02X %02X\n",
-		//	i, Client->Packet[0], Client->Packet[1],
-		//	Client->Packet[2], Client->Packet[3]);
-		if (!ParseIoPacketAGS (Client->Packet, &Type, &Data))
-		  switch (Type)
-		    {
-		    case 000:		// PGNS theta integrator.
-		    case 001:		// PGNS phi integrator.
-		    case 002:		// PGNS psi integrator.
-		      j = IO_2001 + Type;
-		      if (Data == 0)
-		        State->InputPorts[j] = 0;
-		      else	
-		        {
-		          State->InputPorts[j] += SignExtendAGS (Data) * 4;
-			  State->InputPorts[j] &= 0377774;
-			}
-		      break;
-		    case 005:		// discrete input word 2.
-		      // If the READ OUT or ENTR keys are active,
-		      // we must intercept them and buffer the 
-		      // associated data before letting the CPU
-		      // know about it.
-		      k = ((Data & 0777) << 9);
-		      j = (Data & k) | ~k;
-		      if (0 == (j & 04000))		// ENTR?
-		        {
-			  DedaBufferCount = 0;	// Prepare to collect data.
-			  DedaBufferWanted = 9;
-			  Data |= 04000;	// Reset the ENTR key.
-			  // Request DEDA shift data.
-			  ChannelOutputAGS (040, State->OutputPorts[IO_ODISCRETES] & ~010);
-			}
-		      else if (0 == (j & 02000))	// READ OUT?
-		        {
-			  DedaBufferCount = 0;	// Prepare to collect data.
-			  DedaBufferWanted = 3;
-			  Data |= 02000;	// Reset the READ OUT key.
-			  // Request DEDA shift data.
-			  ChannelOutputAGS (040, State->OutputPorts[IO_ODISCRETES] & ~010);
-			}
-		      // Yes, it is supposed to fall through here.		
-		    case 004:		// Discrete input word 1.
-		      j = IO_2020 + (Type - 4);
-		      Mask = ((Data & 0777) << 9);
-		      State->InputPorts[j] &= ~Mask;
-		      State->InputPorts[j] |= (Data & Mask);
-		      break;
-		    case 007:		// DEDA.
-		      // If we are buffering this input, we have to intercept it.
-		      if (DedaBufferWanted)
-		        {
-			  if (DedaBufferCount < DedaBufferWanted)
-			    {
-			      DedaBuffer[DedaBufferCount++] = (Data & 0360000);  
-			      if (DedaBufferCount < DedaBufferWanted)
-			        {
-				  // Request more DEDA shift data.
-				  ChannelOutputAGS (040, State->OutputPorts[IO_ODISCRETES] & ~010);
-				}
-			      else
-				{
-				  // The data is all buffered.  We can tell the
-				  // CPU that the ENTR or READ OUT key was pressed.
-				  //printf ("Buffered from DEDA: CLR");
-				  //for (j = 0; j < DedaBufferWanted; j++)
-				  //  printf (" %02o", DedaBuffer[j] >> 13);
-				  DedaBufferReadout = -1;
-				  if (DedaBufferWanted == 3)
-				    {
-				      State->InputPorts[IO_2040] &= ~02000;	// READ OUT
-				      //printf (" READOUT\n");
-				    }
-				  else
-				    {
-				      State->InputPorts[IO_2040] &= ~04000;	// ENTR.
-				      //printf (" ENTR\n");
-				    }
-				}
-			    }
-			}
-		      break;
-		    case 011:		// delta-integral-q counter
-		    case 012:		// delta-integral-r counter
-		    case 013:		// delta-integral-p counter
-		      j = IO_6002 + (Type - 011);
-   	              State->InputPorts[j] += SignExtendAGS (Data) * 0100;
-		      State->InputPorts[j] &= 0377700;
-		      break;
-		    case 014:		// delta-Vx counter.
-		    case 015:		// delta-Vy counter.
-		    case 016:		// delta-Vz counter.
-		      j = IO_6020 + (Type - 014);
-   	              State->InputPorts[j] += SignExtendAGS (Data) * 0100;
-		      State->InputPorts[j] &= 0377700;
-		      break;
-		    case 017:		// downlink telemetry
-		      State->InputPorts[IO_6200] = Data;
-		      // Make the Downlink Telemetry Stop bit active.
-		      State->InputPorts[IO_2020] &= ~0200000;
-		      break;
-		    }
-		Client->Size = 0;
-	      }
-	  }
+    case 000:		// PGNS theta integrator.
+    case 001:		// PGNS phi integrator.
+    case 002:		// PGNS psi integrator.
+      j = IO_2001 + Type;
+      if (Data == 0)
+	State->InputPorts[j] = 0;
+      else	
+	{
+	  State->InputPorts[j] += SignExtendAGS (Data) * 4;
+	  State->InputPorts[j] &= 0377774;
+	}
+      break;
+    case 005:		// discrete input word 2.
+      // If the READ OUT or ENTR keys are active,
+      // we must intercept them and buffer the 
+      // associated data before letting the CPU
+      // know about it.
+      k = ((Data & 0777) << 9);
+      j = (Data & k) | ~k;
+      if (0 == (j & 04000))		// ENTR?
+	{
+	  State->DedaBufferCount = 0;	// Prepare to collect data.
+	  State->DedaBufferWanted = 9;
+	  Data |= 04000;	// Reset the ENTR key.
+	  // Request DEDA shift data.
+	  ChannelOutputAGS (State, 040, State->OutputPorts[IO_ODISCRETES] & ~010);
+	}
+      else if (0 == (j & 02000))	// READ OUT?
+	{
+	  State->DedaBufferCount = 0;	// Prepare to collect data.
+	  State->DedaBufferWanted = 3;
+	  Data |= 02000;	// Reset the READ OUT key.
+	  // Request DEDA shift data.
+	  ChannelOutputAGS (State, 040, State->OutputPorts[IO_ODISCRETES] & ~010);
+	}
+      // Yes, it is supposed to fall through here.		
+    case 004:		// Discrete input word 1.
+      j = IO_2020 + (Type - 4);
+      Mask = ((Data & 0777) << 9);
+      State->InputPorts[j] &= ~Mask;
+      State->InputPorts[j] |= (Data & Mask);
+      break;
+    case 007:		// DEDA.
+      // If we are buffering this input, we have to intercept it.
+      if (State->DedaBufferWanted)
+	{
+	  if (State->DedaBufferCount < State->DedaBufferWanted)
+	    {
+	      State->DedaBuffer[State->DedaBufferCount++] = (Data & 0360000);  
+	      if (State->DedaBufferCount < State->DedaBufferWanted)
+		{
+		  // Request more DEDA shift data.
+		  ChannelOutputAGS (State, 040, State->OutputPorts[IO_ODISCRETES] & ~010);
+		}
+	      else
+		{
+		  // The data is all buffered.  We can tell the
+		  // CPU that the ENTR or READ OUT key was pressed.
+		  State->DedaBufferReadout = -1;
+		  if (State->DedaBufferWanted == 3)
+		    State->InputPorts[IO_2040] &= ~02000;	// READ OUT
+		  else
+		    State->InputPorts[IO_2040] &= ~04000;	// ENTR.
+		}
+	    }
+	}
+      break;
+    case 011:		// delta-integral-q counter
+    case 012:		// delta-integral-r counter
+    case 013:		// delta-integral-p counter
+      j = IO_6002 + (Type - 011);
+      State->InputPorts[j] += SignExtendAGS (Data) * 0100;
+      State->InputPorts[j] &= 0377700;
+      break;
+    case 014:		// delta-Vx counter.
+    case 015:		// delta-Vy counter.
+    case 016:		// delta-Vz counter.
+      j = IO_6020 + (Type - 014);
+      State->InputPorts[j] += SignExtendAGS (Data) * 0100;
+      State->InputPorts[j] &= 0377700;
+      break;
+    case 017:		// downlink telemetry
+      State->InputPorts[IO_6200] = Data;
+      // Make the Downlink Telemetry Stop bit active.
+      State->InputPorts[IO_2020] &= ~0200000;
+      break;
     }
-#endif
-  return (0);
+  return (1);
 }
-
-
@@ -0,0 +1,335 @@
+/*
+  This file is part of Project Apollo - NASSP.
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  Filename:	aea_bench.c
+  Purpose:	Headless, batch-mode runner for the yaAGS engine, the AEA
+		counterpart of agc_bench.  Loads one or more flight program
+		images, runs them for a given number of simulated seconds in
+		frames the way LEM_AEA::TimeStep does, and reports engine
+		throughput and wall time per simulated second.  The final
+		state hash is printed so that changes to aea_engine can be
+		checked for bit-exact behaviour against a previous build.
+  Compiler:	GNU gcc, or MSVC.
+  Usage:	aea_bench [options] program.bin [program.bin ...]
+
+		--seconds=N	Simulated seconds per program (default 60).
+		--fps=N		Frames per simulated second (default 50).
+		--runs=N	Repeat each program N times, report the best run.
+		--single	Call aea_engine once per instruction instead of
+				running frames through aea_engine_run.
+		--verify	Run each program both ways and check that the
+				final states are bit-identical.
+		--readout=A	Key CLR after one second, then octal address
+				A and READ OUT, and print what the DEDA shows
+				at the end.
+		--quiet		Only print the summary line per program.
+*/
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1300 ) // Microsoft Visual Studio Version 2003 and higher
+#define _CRT_SECURE_NO_DEPRECATE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include "aea_engine.h"
+
+static ags_t State;
+
+// Output activity, folded into the state hash and counted.
+static uint64_t OutputHash;
+static uint64_t OutputCount;
+
+// The DEDA display, as shifted out by the CPU: address, sign, five digits.
+static int Deda[9], DedaCount;
+
+// Non-zero to step the engine with aea_engine rather than aea_engine_run.
+static int SingleStep = 0;
+
+// Address for --readout, or -1.
+static int Readout = -1;
+
+#ifndef WIN32
+void
+UnblockSocket (int SocketNum)
+{
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Timing.
+
+static double
+WallClock (void)
+{
+#ifdef WIN32
+  LARGE_INTEGER Freq, Count;
+  QueryPerformanceFrequency (&Freq);
+  QueryPerformanceCounter (&Count);
+  return ((double) Count.QuadPart / (double) Freq.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (ts.tv_sec + 1e-9 * ts.tv_nsec);
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Empty the output queue, as LEM_DEDA::TimeStep does once per frame.
+
+static void
+DrainOutputs (void)
+{
+  int Type, Data, i;
+  uint64_t Word;
+  while (aea_engine_read_output (&State, &Type, &Data))
+    {
+      Word = ((uint64_t) (Type & 0777) << 18) | (Data & 0777777);
+      for (i = 0; i < 4; i++)
+	{
+	  OutputHash ^= (Word >> (8 * i)) & 0xFF;
+	  OutputHash *= 0x100000001B3ULL;
+	}
+      OutputCount++;
+      if (Type == 027)
+	{
+	  Deda[DedaCount % 9] = (Data >> 13) & 017;
+	  DedaCount++;
+	}
+    }
+}
+
+//----------------------------------------------------------------------------
+// State hash:  FNV-1a over memory, the i/o registers, the CPU registers,
+// the cycle counter and the output activity.
+
+static uint64_t
+StateHash (void)
+{
+  const unsigned char *p;
+  uint64_t Hash = 0xCBF29CE484222325ULL;
+  size_t i;
+  p = (const unsigned char *) State.Memory;
+  for (i = 0; i < sizeof (State.Memory); i++)
+    Hash = (Hash ^ p[i]) * 0x100000001B3ULL;
+  p = (const unsigned char *) State.InputPorts;
+  for (i = 0; i < sizeof (State.InputPorts); i++)
+    Hash = (Hash ^ p[i]) * 0x100000001B3ULL;
+  p = (const unsigned char *) State.OutputPorts;
+  for (i = 0; i < sizeof (State.OutputPorts); i++)
+    Hash = (Hash ^ p[i]) * 0x100000001B3ULL;
+  Hash = (Hash ^ State.ProgramCounter) * 0x100000001B3ULL;
+  Hash = (Hash ^ State.Accumulator) * 0x100000001B3ULL;
+  Hash = (Hash ^ State.Quotient) * 0x100000001B3ULL;
+  Hash = (Hash ^ State.Index) * 0x100000001B3ULL;
+  Hash = (Hash ^ State.CycleCounter) * 0x100000001B3ULL;
+  Hash = (Hash ^ OutputHash) * 0x100000001B3ULL;
+  return (Hash);
+}
+
+//----------------------------------------------------------------------------
+// Run one program for the given number of simulated seconds.
+
+typedef struct {
+  double Wall;
+  double MinFrame, MaxFrame;
+  uint64_t Cycles;
+  uint64_t Halted;
+  uint64_t Hash;
+} RunResult_t;
+
+static int
+RunProgram (const char *RomImage, int Seconds, int Fps, RunResult_t *Result)
+{
+  int Frame, Used, Budget, Chars[3], i;
+  double Start, FrameStart, Now, Residual = 0;
+  uint64_t Halted = 0;
+
+  memset (&State, 0, sizeof (State));
+  OutputHash = 0xCBF29CE484222325ULL;
+  OutputCount = 0;
+  DedaCount = 0;
+  if (0 != (i = aea_engine_init (&State, RomImage, NULL)))
+    {
+      fprintf (stderr, "Cannot load program \"%s\" (error %d).\n", RomImage, i);
+      return (1);
+    }
+
+  Result->MinFrame = 1e30;
+  Result->MaxFrame = 0;
+  Start = WallClock ();
+  for (Frame = 0; Frame < Seconds * Fps; Frame++)
+    {
+      // CLR is held for 100 ms.  The flight program only looks at the keys
+      // it has latched a few times a second, so READ OUT follows a second
+      // later, as it would at the hands of a crew member.
+      if (Readout >= 0 && Frame == Fps)
+	aea_engine_deda_key (&State, DEDA_KEY_CLR, 1);
+      if (Readout >= 0 && Frame == Fps + Fps / 10)
+	aea_engine_deda_key (&State, DEDA_KEY_CLR, 0);
+      if (Readout >= 0 && Frame == 2 * Fps)
+	{
+	  Chars[0] = (Readout >> 6) & 7;
+	  Chars[1] = (Readout >> 3) & 7;
+	  Chars[2] = Readout & 7;
+	  aea_engine_deda_shift (&State, Chars, 3);
+	}
+
+      FrameStart = WallClock ();
+      Residual += (double) AEA_PER_SECOND / Fps;
+      Budget = (int) Residual;
+      if (SingleStep)
+	{
+	  for (Used = 0; Used < Budget;)
+	    {
+	      if (State.Halt && State.CycleCounter < State.Next20msSignal)
+		Halted += 10;
+	      Used += aea_engine (&State);
+	    }
+	}
+      else
+	Used = aea_engine_run (&State, Budget);
+      Residual -= Used;
+      DrainOutputs ();
+
+      Now = WallClock ();
+      if (Now - FrameStart < Result->MinFrame)
+	Result->MinFrame = Now - FrameStart;
+      if (Now - FrameStart > Result->MaxFrame)
+	Result->MaxFrame = Now - FrameStart;
+    }
+  Result->Wall = WallClock () - Start;
+  Result->Cycles = State.CycleCounter;
+  Result->Halted = Halted;
+  Result->Hash = StateHash ();
+  return (0);
+}
+
+static char
+DedaChar (int Position, int c)
+{
+  if (Position == 3)
+    return ((c & 1) == DEDA_MINUS ? '-' : '+');
+  if (c <= 9)
+    return ('0' + c);
+  return (' ');
+}
+
+int
+main (int argc, char *argv[])
+{
+  int i, Run, Seconds = 60, Fps = 50, Runs = 1, Quiet = 0, Verify = 0, NumPrograms = 0;
+  RunResult_t Result, Best;
+
+  memset (&Best, 0, sizeof (Best));
+  for (i = 1; i < argc; i++)
+    {
+      if (1 == sscanf (argv[i], "--seconds=%d", &Seconds))
+        continue;
+      if (1 == sscanf (argv[i], "--fps=%d", &Fps))
+        continue;
+      if (1 == sscanf (argv[i], "--runs=%d", &Runs))
+        continue;
+      if (1 == sscanf (argv[i], "--readout=%o", &Readout))
+        continue;
+      if (!strcmp (argv[i], "--quiet"))
+        Quiet = 1;
+      else if (!strcmp (argv[i], "--single"))
+        SingleStep = 1;
+      else if (!strcmp (argv[i], "--verify"))
+        Verify = 1;
+      else if (argv[i][0] == '-')
+        {
+	  fprintf (stderr, "Unknown option \"%s\".\n", argv[i]);
+	  return (1);
+	}
+      else
+        NumPrograms++;
+    }
+  if (NumPrograms == 0 || Seconds <= 0 || Fps <= 0 || Runs <= 0)
+    {
+      fprintf (stderr, "Usage: aea_bench [--seconds=N] [--fps=N] [--runs=N] "
+               "[--single] [--verify] [--readout=A] [--quiet] program.bin ...\n");
+      return (1);
+    }
+
+  for (i = 1; i < argc; i++)
+    {
+      if (argv[i][0] == '-')
+        continue;
+      for (Run = 0; Run < Runs; Run++)
+        {
+	  if (RunProgram (argv[i], Seconds, Fps, &Result))
+	    return (1);
+	  if (Run == 0 || Result.Wall < Best.Wall)
+	    Best = Result;
+	  if (Run > 0 && Result.Hash != Best.Hash)
+	    {
+	      fprintf (stderr, "%s: state hash differs between runs!\n", argv[i]);
+	      return (2);
+	    }
+	}
+      if (Verify)
+        {
+	  uint64_t Hash = Best.Hash;
+	  SingleStep = !SingleStep;
+	  if (RunProgram (argv[i], Seconds, Fps, &Result))
+	    return (1);
+	  SingleStep = !SingleStep;
+	  if (SingleStep)
+	    Best.Halted = Result.Halted;
+	  if (Result.Hash != Hash)
+	    {
+	      fprintf (stderr, "%s: aea_engine_run and aea_engine disagree "
+	               "(%016llx vs. %016llx)!\n", argv[i],
+		       (unsigned long long) Hash, (unsigned long long) Result.Hash);
+	      return (2);
+	    }
+	}
+      printf ("%s: %d s simulated, %.3f s wall, %.1fx real time, hash %016llx\n",
+	      argv[i], Seconds, Best.Wall, Seconds / Best.Wall,
+	      (unsigned long long) Best.Hash);
+      if (!Quiet)
+        {
+	  printf ("  Wall time per %d Hz frame: min %.1f us, avg %.1f us, max %.1f us\n",
+		  Fps, 1e6 * Best.MinFrame, 1e6 * Best.Wall / (Seconds * Fps),
+		  1e6 * Best.MaxFrame);
+	  printf ("  Outputs: %llu, %u dropped\n", (unsigned long long) OutputCount,
+		  State.OutputQueue.Dropped);
+	  if (Best.Halted)
+	    printf ("  Time waiting in DLY: %.1f%%\n", 100.0 * Best.Halted / Best.Cycles);
+	  if (Readout >= 0)
+	    {
+	      int k, Start = DedaCount >= 9 ? DedaCount - 9 : 0;
+	      printf ("  DEDA after READ OUT %03o: \"", Readout);
+	      for (k = Start; k < DedaCount; k++)
+		{
+		  putchar (DedaChar (k - Start, Deda[k % 9]));
+		  if (k - Start == 2)
+		    putchar (' ');
+		}
+	      printf ("\" (%d characters shifted out)\n", DedaCount);
+	    }
+	}
+    }
+  return (0);
+}
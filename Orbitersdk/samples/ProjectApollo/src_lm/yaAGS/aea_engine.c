@@ -52,6 +52,8 @@
 				(finally) with what I think is a correct 
 				implementation.
 		2005-08-22 RSB	"unsigned long long" replaced by uint64_t.
+				NASSP: aea_engine_run and the i/o queues
+				for the in-process peripherals.
   
   The scans of the original AGS/AEA technical documentation can be found
   at the website listed above.  Also at that site you can find the source code
@@ -109,7 +111,7 @@ static const int InstructionTiming[32] = {
 // own weird and wacky version.
 //
 
-#if _MSC_VER > 1200
+#if !defined(_MSC_VER) || _MSC_VER > 1200
 static const int64_t CONST64_1 = ~0377777777777LL;
 static const int64_t CONST64_2 = 0177777777777LL;
 static const int64_t CONST64_3 = 1LL;
@@ -279,28 +281,25 @@ PutLongAccumulator (ags_t *State, int64_t lli)
 //----------------------------------------------------------------------------
 // This function is used to get buffered DEDA shift-register data.  
 
-extern int DedaBuffer[9], DedaBufferCount, DedaBufferWanted,
-  DedaBufferReadout, DedaBufferDefault;
-
 static int
 FetchDedaShift (ags_t *State)
 {
   // Return the buffered data, if we have any.
-  if (!DedaBufferWanted || DedaBufferCount < DedaBufferWanted || 
-      DedaBufferReadout >= DedaBufferWanted || DedaBufferReadout < 0)
-    DedaBufferWanted = DedaBufferCount = DedaBufferReadout = 0;
+  if (!State->DedaBufferWanted || State->DedaBufferCount < State->DedaBufferWanted || 
+      State->DedaBufferReadout >= State->DedaBufferWanted || State->DedaBufferReadout < 0)
+    State->DedaBufferWanted = State->DedaBufferCount = State->DedaBufferReadout = 0;
   else 
     {
-      DedaBufferDefault = DedaBuffer[DedaBufferReadout];
-      if (DedaBufferReadout + 1 == DedaBufferWanted)
-        DedaBufferWanted = DedaBufferCount = DedaBufferReadout = 0;
+      State->DedaBufferDefault = State->DedaBuffer[State->DedaBufferReadout];
+      if (State->DedaBufferReadout + 1 == State->DedaBufferWanted)
+        State->DedaBufferWanted = State->DedaBufferCount = State->DedaBufferReadout = 0;
   // Tell the CPU that the ENTR or READ OUT key has been released.
-  if (DedaBufferWanted == 3)
+  if (State->DedaBufferWanted == 3)
     State->InputPorts[IO_2040] |= 02000;
-  else if (DedaBufferWanted == 9)
+  else if (State->DedaBufferWanted == 9)
     State->InputPorts[IO_2040] |= 04000;
     }
-  return (DedaBufferDefault);
+  return (State->DedaBufferDefault);
 }
 
 //-----------------------------------------------------------------------------
@@ -318,22 +317,22 @@ Output (ags_t *State, int AddressField, int Value)
 	switch (Address) 
 	  {
 	  case 02001:		// sin theta
-	    ChannelOutputAGS (020, State->OutputPorts[IO_2001] = (Value & 0777400));
+	    ChannelOutputAGS (State, 020, State->OutputPorts[IO_2001] = (Value & 0777400));
 	    break;
 	  case 02002:		// cos theta
-	    ChannelOutputAGS (021, State->OutputPorts[IO_2002] = (Value & 0777400));
+	    ChannelOutputAGS (State, 021, State->OutputPorts[IO_2002] = (Value & 0777400));
 	    break;
 	  case 02004:		// sin phi
-	    ChannelOutputAGS (022, State->OutputPorts[IO_2004] = (Value & 0777400));
+	    ChannelOutputAGS (State, 022, State->OutputPorts[IO_2004] = (Value & 0777400));
 	    break;
 	  case 02010:		// cos phi
-	    ChannelOutputAGS (023, State->OutputPorts[IO_2010] = (Value & 0777400));
+	    ChannelOutputAGS (State, 023, State->OutputPorts[IO_2010] = (Value & 0777400));
 	    break;
 	  case 02020:		// sin psi
-	    ChannelOutputAGS (024, State->OutputPorts[IO_2020] = (Value & 0777400));
+	    ChannelOutputAGS (State, 024, State->OutputPorts[IO_2020] = (Value & 0777400));
 	    break;
 	  case 02040:		// cos psi
-	    ChannelOutputAGS (025, State->OutputPorts[IO_2040] = (Value & 0777400));
+	    ChannelOutputAGS (State, 025, State->OutputPorts[IO_2040] = (Value & 0777400));
 	    break;
 	  case 02200:		// DEDA
 	    // We don't actually complete the operation until the DEDA-shift-out
@@ -351,13 +350,13 @@ Output (ags_t *State, int AddressField, int Value)
 	    break;
 	  case 02500:		// DEDA shift in discrete set
 	    // NewDiscreteOutputs &= ~010;
-	    DedaBufferReadout++;
+	    State->DedaBufferReadout++;
 	    //printf ("CPU issued DEDA Shift In.\n");
 	    break;
 	  case 02600:		// DEDA shift out discrete set
 	    // We don't actually change this bit at all.  Instead, we transmit
 	    // the DEDA shift register.
-	    ChannelOutputAGS (027, State->OutputPorts[IO_2200]);
+	    ChannelOutputAGS (State, 027, State->OutputPorts[IO_2200]);
 	    break;
 	  case 03010:		// ripple carry inhibit reset.
 	    NewDiscreteOutputs |= 01;
@@ -366,29 +365,29 @@ Output (ags_t *State, int AddressField, int Value)
 	    NewDiscreteOutputs |= 06;
 	    break;
 	  case 06001:		// Ex
-	    ChannelOutputAGS (030, State->OutputPorts[IO_6001] = (Value & 0777400));
+	    ChannelOutputAGS (State, 030, State->OutputPorts[IO_6001] = (Value & 0777400));
 	    break;
 	  case 06002:		// Ey
-	    ChannelOutputAGS (031, State->OutputPorts[IO_6002] = (Value & 0777400));
+	    ChannelOutputAGS (State, 031, State->OutputPorts[IO_6002] = (Value & 0777400));
 	    break;
 	  case 06004:		// Ez
-	    ChannelOutputAGS (032, State->OutputPorts[IO_6004] = (Value & 0777400));
+	    ChannelOutputAGS (State, 032, State->OutputPorts[IO_6004] = (Value & 0777400));
 	    break;
 	  case 06010:		// altitude / altitude-rate 
-	    ChannelOutputAGS (033, State->OutputPorts[IO_6010] = (Value & 0777770));
+	    ChannelOutputAGS (State, 033, State->OutputPorts[IO_6010] = (Value & 0777770));
 	    break;
 	  case 06020:		// lateral velocity
-	    ChannelOutputAGS (034, State->OutputPorts[IO_6020] = (Value & 0777000));
+	    ChannelOutputAGS (State, 034, State->OutputPorts[IO_6020] = (Value & 0777000));
 	    break;
 	  case 06100:		// output telemetry word 2
 	    State->OutputPorts[IO_6100] = Value;
-	    ChannelOutputAGS (036, Value);
+	    ChannelOutputAGS (State, 036, Value);
 	    State->InputPorts[IO_2020] &= ~0200000;	// set output telemetry stop.
 	    break;
 	  case 06200:		// output telemetry word 1
 	    State->OutputPorts[IO_6200] = Value;
 	    State->InputPorts[IO_2020] |= 0200000;	// reset Output Telemetry stop.
-	    ChannelOutputAGS (037, Value);
+	    ChannelOutputAGS (State, 037, Value);
 	    break;
 	  case 06401:		// GSE discrete 4 set.
 	    NewDiscreteOutputs &= ~040;
@@ -434,7 +433,7 @@ Output (ags_t *State, int AddressField, int Value)
   if (NewDiscreteOutputs != State->OutputPorts[IO_ODISCRETES])
     {
       State->OutputPorts[IO_ODISCRETES] = NewDiscreteOutputs;
-      ChannelOutputAGS (040, NewDiscreteOutputs);
+      ChannelOutputAGS (State, 040, NewDiscreteOutputs);
     }
 }
 
@@ -1081,3 +1080,142 @@ aea_engine (ags_t * State)
   Count += MicrosecondsThisInstruction;
   return (MicrosecondsThisInstruction);
 }
+
+//-----------------------------------------------------------------------------
+// Execute instructions for up to Cycles "microseconds".  While the CPU waits
+// in a DLY for the next 20 ms. signal, the time is skipped in the same
+// 10-microsecond steps aea_engine would take, so the result is the same as
+// calling aea_engine over and over.  Returns the time used, which can be a
+// little more than Cycles.
+
+int
+aea_engine_run (ags_t * State, int Cycles)
+{
+  int n = 0, k, Left;
+  while (n < Cycles)
+    {
+      if (State->Halt && State->CycleCounter < State->Next20msSignal)
+        {
+	  k = (int) ((State->Next20msSignal - State->CycleCounter + 9) / 10);
+	  Left = (Cycles - n + 9) / 10;
+	  if (k > Left)
+	    k = Left;
+	  State->CycleCounter += 10 * k;
+	  n += 10 * k;
+	}
+      else
+        n += aea_engine (State);
+    }
+  return (n);
+}
+
+//-----------------------------------------------------------------------------
+// The i/o queues.  Each has one producer and one consumer thread.  The
+// barrier keeps the packet writes ahead of the index update that publishes
+// them; x86 keeps stores in order, so on MSVC a compiler barrier is all
+// that's needed.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define QUEUE_BARRIER() _ReadWriteBarrier ()
+#else
+#define QUEUE_BARRIER() __sync_synchronize ()
+#endif
+
+static int
+QueuePut (AeaQueue_t *Queue, int Type, int Data)
+{
+  unsigned Head = Queue->Head;
+  AeaPacket_t *Packet;
+  if (Head - Queue->Tail >= AEA_QUEUE_SIZE)
+    {
+      Queue->Dropped++;
+      return (0);
+    }
+  Packet = &Queue->Packets[Head & (AEA_QUEUE_SIZE - 1)];
+  Packet->Type = Type;
+  Packet->Data = Data;
+  QUEUE_BARRIER ();
+  Queue->Head = Head + 1;
+  return (1);
+}
+
+static int
+QueueGet (AeaQueue_t *Queue, int *Type, int *Data)
+{
+  unsigned Tail = Queue->Tail;
+  AeaPacket_t *Packet;
+  if (Tail == Queue->Head)
+    return (0);
+  QUEUE_BARRIER ();
+  Packet = &Queue->Packets[Tail & (AEA_QUEUE_SIZE - 1)];
+  *Type = Packet->Type;
+  *Data = Packet->Data;
+  QUEUE_BARRIER ();
+  Queue->Tail = Tail + 1;
+  return (1);
+}
+
+// Queue a packet for the CPU, which takes one per instruction.  Returns 1 on
+// success, or 0 if the queue is full.
+
+int
+aea_engine_queue_input (ags_t * State, int Type, int Data)
+{
+  return (QueuePut (&State->InputQueue, Type, Data));
+}
+
+// Get the next packet output by the CPU.  Returns 0 if there is none.  The
+// latest value of each output register is in State->OutputPorts as well.
+
+int
+aea_engine_read_output (ags_t * State, int *Type, int *Data)
+{
+  return (QueueGet (&State->OutputQueue, Type, Data));
+}
+
+// Used by ChannelOutputAGS and ChannelInputAGS.
+
+int
+aea_engine_put_output (ags_t * State, int Type, int Data)
+{
+  return (QueuePut (&State->OutputQueue, Type, Data));
+}
+
+int
+aea_engine_get_input (ags_t * State, int *Type, int *Data)
+{
+  return (QueueGet (&State->InputQueue, Type, Data));
+}
+
+// Press or release CLR or HOLD on the DEDA.  The flight program polls the
+// keys every 40 ms, so a key has to be held at least that long to be seen;
+// it ignores READ OUT and ENTR until it has seen CLR.  Returns 1 on success,
+// or 0 if there's no room in the queue.
+
+int
+aea_engine_deda_key (ags_t * State, int Key, int Pressed)
+{
+  return (QueuePut (&State->InputQueue, 005, Key | (Pressed ? 0 : (Key << 9))));
+}
+
+// Press ENTR (Count 9: address, sign and five digits) or READ OUT (Count 3:
+// address) on the DEDA, with the characters the DEDA holds.  The DEDA would
+// shift them out one at a time as the CPU asks for them; here they are all
+// queued up front, and buffered by ChannelInputAGS.  Returns 1 on success, or
+// 0 if there's no room in the queue.
+
+int
+aea_engine_deda_shift (ags_t * State, const int *Chars, int Count)
+{
+  int i;
+  if (Count != 9 && Count != 3)
+    return (0);
+  if (State->InputQueue.Head - State->InputQueue.Tail + Count + 1 > AEA_QUEUE_SIZE)
+    return (0);
+  // Discrete input word 2, with the key bit cleared and its mask bit set.
+  QueuePut (&State->InputQueue, 005, (Count == 9) ? DEDA_KEY_ENTR : DEDA_KEY_READOUT);
+  for (i = 0; i < Count; i++)
+    QueuePut (&State->InputQueue, 007, (Chars[i] & 017) << 13);
+  return (1);
+}
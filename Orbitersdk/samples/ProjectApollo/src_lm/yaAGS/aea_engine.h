@@ -30,6 +30,8 @@
 		2005-08-13 RSB	Added the extern "C" stuff, as well as
 				the ags_clientdata field in ags_t.
 		2005-08-22 RSB	"unsigned long long" replaced by uint64_t.
+				NASSP: DEDA buffer moved into ags_t, i/o
+				queues and aea_engine_run added.
 */
 
 #ifndef AEA_ENGINE_H
@@ -71,12 +73,47 @@ enum RegOffset_t {
 
 #define MAX_AGS_BACKTRACES 50
 
+// Size of each of the i/o queues between the CPU and its peripherals.  Must
+// be a power of 2.
+#define AEA_QUEUE_SIZE 1024
+
+// The sign of a DEDA data word is shifted in and out as a character of its
+// own, ahead of the five digits.  The flight program only looks at its
+// lowest bit.
+#define DEDA_PLUS 0
+#define DEDA_MINUS 1
+
+// DEDA keys, as mask bits of a discrete input word 2 (type 005) packet.  The
+// key itself is bit 9 higher, and is 0 while the key is pressed.
+#define DEDA_KEY_READOUT 002
+#define DEDA_KEY_ENTR 004
+#define DEDA_KEY_HOLD 010
+#define DEDA_KEY_CLR 020
+
 // Time between checks for --debug keystrokes.
 #define KEYSTROKE_CHECK_AGS (sysconf (_SC_CLK_TCK) / 4)
 
 //---------------------------------------------------------------------------
 // Data types.
 
+// An i/o packet, as it was sent over the yaAGS sockets: the channel type and
+// its data.
+typedef struct
+{
+  int Type;
+  int Data;
+} AeaPacket_t;
+
+// Single-producer/single-consumer packet queue.  The producer only advances
+// Head, the consumer only advances Tail, so no lock is needed between them.
+typedef struct
+{
+  AeaPacket_t Packets[AEA_QUEUE_SIZE];
+  volatile unsigned Head;
+  volatile unsigned Tail;
+  unsigned Dropped;		// Packets lost because the queue was full.
+} AeaQueue_t;
+
 // Each instance of the AGS/AEA CPU simulation has a data structure of type ags_t
 // that contains the CPU's internal states, the complete memory space, and any
 // other little handy items needed to track execution by the CPU.
@@ -104,6 +141,13 @@ typedef struct
   // integration squad wants.  The Virtual AGC code proper doesn't use it
   // in any way.
   void *ags_clientdata;
+  // DEDA shift register data, buffered until the CPU shifts it in.
+  int DedaBuffer[9];
+  int DedaBufferCount, DedaBufferWanted, DedaBufferReadout, DedaBufferDefault;
+  // Packets from the peripherals to the CPU (aea_engine_queue_input), and
+  // from the CPU to the peripherals (aea_engine_read_output).
+  AeaQueue_t InputQueue;
+  AeaQueue_t OutputQueue;
 } ags_t;
 
 #ifdef AEA_ENGINE_C
@@ -124,9 +168,16 @@ extern clock_t RealTimeAGS, RealTimeOffsetAGS, LastRealTimeAGS, NextKeycheckAGS;
 // Function prototypes.
 
 int aea_engine (ags_t * State);
+int aea_engine_run (ags_t * State, int Cycles);
+int aea_engine_queue_input (ags_t * State, int Type, int Data);
+int aea_engine_read_output (ags_t * State, int *Type, int *Data);
+int aea_engine_deda_key (ags_t * State, int Key, int Pressed);
+int aea_engine_deda_shift (ags_t * State, const int *Chars, int Count);
+int aea_engine_put_output (ags_t * State, int Type, int Data);
+int aea_engine_get_input (ags_t * State, int *Type, int *Data);
 int aea_engine_init (ags_t * State, const char *RomImage, const char *CoreDump);
 void MakeCoreDumpAGS (ags_t * State, const char *CoreDump);
-void ChannelOutputAGS (int Type, int Data);
+void ChannelOutputAGS (ags_t * State, int Type, int Data);
 int ChannelInputAGS (ags_t * State);
 void DebuggerHookAGS (ags_t *State);
 void UpdateAeaPeripheralConnect (void *AeaState, Client_t *Client);
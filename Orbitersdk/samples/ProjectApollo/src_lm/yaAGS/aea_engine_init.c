@@ -27,6 +27,7 @@
   				file.
 		2005-06-02 RSB	Added Accumulator, Index registers.
 		2005-06-04 RSB	Added 20 ms. timing signal.
+				NASSP: clear the DEDA buffer and i/o queues.
 */
 #if defined(_MSC_VER) && (_MSC_VER >= 1300 ) // Microsoft Visual Studio Version 2003 and higher
 #define _CRT_SECURE_NO_DEPRECATE 
@@ -121,6 +122,11 @@ aea_engine_init (ags_t * State, const char *RomImage, const char *CoreDump)
   State->Quotient = 0;
   State->Index = 0;
   State->Overflow = 0;
+  State->Halt = 0;
+  State->DedaBufferCount = State->DedaBufferWanted = 0;
+  State->DedaBufferReadout = State->DedaBufferDefault = 0;
+  State->InputQueue.Head = State->InputQueue.Tail = State->InputQueue.Dropped = 0;
+  State->OutputQueue.Head = State->OutputQueue.Tail = State->OutputQueue.Dropped = 0;
   // The discrete outputs and inputs.
   State->OutputPorts[IO_ODISCRETES] = 0777777;
   State->InputPorts[IO_2020] = 0777777;
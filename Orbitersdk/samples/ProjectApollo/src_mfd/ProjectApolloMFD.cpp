@@ -1400,6 +1400,19 @@ void ProjectApolloMFD::Update (HDC hDC)
 	//Draw Telemetry
 	else if (screen == PROG_TELE) {
 		SetTextAlign (hDC, TA_LEFT);
+		ApolloGuidance *agc = NULL;
+		if (saturn) agc = &saturn->agc;
+		else if (lem) agc = &lem->agc;
+		if (saturn) {
+			TextOut(hDC, (int) (width * 0.1), (int) (height * 0.20), "FDAI Paint:", 11);
+			sprintf(buffer, "%.3f / %.3f ms", saturn->fdaiLeft.GetPaintTime() * 1000.0, saturn->fdaiRight.GetPaintTime() * 1000.0);
+			TextOut(hDC, (int) (width * 0.6), (int) (height * 0.20), buffer, strlen(buffer));
+		}
+		if (agc && agc->IsPipelined()) {
+			TextOut(hDC, (int) (width * 0.1), (int) (height * 0.25), "AGC Pipeline:", 13);
+			sprintf(buffer, "%.2f of %.2f ms", agc->PipelineSaved * 1000.0, agc->PipelineAGCTime * 1000.0);
+			TextOut(hDC, (int) (width * 0.6), (int) (height * 0.25), buffer, strlen(buffer));
+		}
 		sprintf(buffer, "Telemetry: %s", debugWinsock);
 		TextOut(hDC, (int) (width * 0.1), (int) (height * 0.30), "Telemetry:", 10);
 		TextOut(hDC, (int) (width * 0.6), (int) (height * 0.30), debugWinsock, strlen(debugWinsock));
@@ -1417,6 +1430,11 @@ void ProjectApolloMFD::Update (HDC hDC)
 		} else {
 			TextOut(hDC, (int) (width * 0.6), (int) (height * 0.35), "N/A", 3);
 		}
+		if (saturn) {
+			TextOut(hDC, (int) (width * 0.1), (int) (height * 0.40), "PCM Frames:", 11);
+			sprintf(buffer, "%lu (%lu out, %lu lost)", saturn->pcm.tx_frames, saturn->pcm.tx_dropped, saturn->pcm.tx_lost);
+			TextOut(hDC, (int) (width * 0.6), (int) (height * 0.40), buffer, strlen(buffer));
+		}
 		if (g_Data.hasError) {
 			if (saturn && saturn->GetIMFDClient()->IsBurnDataValid()) {
 				IMFD_BURN_DATA bd = saturn->GetIMFDClient()->GetBurnData();				
@@ -17,11 +17,6 @@ static char debugString[100];
 static char debugStringBuffer[100];
 static char debugWinsock[100];
 
-static DWORD WINAPI RTCCMFD_Trampoline(LPVOID ptr) {
-	ARCore *core = (ARCore *)ptr;
-	return(core->subThread());
-}
-
 ARCore::ARCore(VESSEL* v)
 {
 	T1 = 0;	
@@ -215,6 +210,7 @@ ARCore::ARCore(VESSEL* v)
 	returnspeed = 1;
 	TEItype = 0;
 	TEIfail = false;
+	entryscanview = false;
 	entrynominal = 1;
 	entryrange = 0.0;
 	EntryRTGO = 0.0;
@@ -311,7 +307,6 @@ ARCore::ARCore(VESSEL* v)
 	R_TLI = _V(0, 0, 0);
 	V_TLI = _V(0, 0, 0);
 
-	subThreadMode = 0;
 	subThreadStatus = 0;
 
 	LmkLat = 0;
@@ -356,6 +351,8 @@ ARCore::ARCore(VESSEL* v)
 
 void ARCore::MinorCycle(double SimT, double SimDT, double mjd)
 {
+	jobs.Poll();
+
 	if (g_Data.connStatus > 0 && g_Data.uplinkBuffer.size() > 0) {
 		if (SimT > g_Data.uplinkBufferSimt + 0.05) {
 			unsigned char data = g_Data.uplinkBuffer.front();
@@ -484,6 +481,37 @@ void ARCore::TEICalc()
 	startSubthread(11);
 }
 
+void ARCore::EntryScanCalc()
+{
+	entryscanview = true;
+	startSubthread(12);
+}
+
+void ARCore::EntryScanSelect(int option)
+{
+	if (option < 1 || option > (int)entryscan.size() || entryscan[option - 1].precision == 9)
+	{
+		return;
+	}
+
+	// Start the normal calculation from the chosen option
+	EntryScanResult &c = entryscan[option - 1];
+	EntryTIG = c.P30TIG;
+	if (c.landingzone >= 0)
+	{
+		landingzone = c.landingzone;
+	}
+	if (entrycalcmode == 3)
+	{
+		returnspeed = c.returnspeed;
+	}
+	else
+	{
+		entrynominal = c.nominal;
+	}
+	entryscanview = false;
+}
+
 void ARCore::CDHcalc()			//Calculates the required DV vector of a coelliptic burn
 {
 	startSubthread(2);
@@ -1137,32 +1165,81 @@ void ARCore::VecPointCalc()
 }
 
 int ARCore::startSubthread(int fcn) {
-	if (subThreadStatus < 1) {
-		// Punt thread
-		subThreadMode = fcn;
-		subThreadStatus = 1; // Busy
-		DWORD id = 0;
-		HANDLE h = CreateThread(NULL, 0, RTCCMFD_Trampoline, this, 0, &id);
-		if (h != NULL) { CloseHandle(h); }
+	std::function<int()> run;
+	std::function<void()> apply;
+	int lane;
+
+	// Iterative targeting goes in the long lane, so PADs can still be calculated while it runs.
+	// Starting a calculation again replaces the one that is queued or running.
+	switch (fcn) {
+	case 1:		//Lambert Targeting
+	case 5:		//LOI Targeting
+	case 7:		//Entry Targeting
+	case 10:	//DOI Targeting
+	case 11:	//TEI Targeting
+	case 12:	//Entry/TEI Scan
+		lane = JOB_LANE_LONG;
+		break;
+	default:
+		lane = JOB_LANE_SHORT;
+		break;
 	}
-	else {
-		return(-1);
+
+	// The calculation gets its own copy of the inputs now, and its results are only stored
+	// by subThreadDone() on this thread, so jobs running in both lanes never share ARCore state.
+	// The state of the vessels and the bodies is read now as well, so the RTCC doesn't call Orbiter from the worker.
+	std::vector<VesselSnapshot> snapshots;
+	std::shared_ptr<const OrbMech::BodySnapshot> bodies = OrbMech::TakeBodySnapshot(oapiGetSimMJD());
+
+	subThread(fcn, run, apply);
+	snapshots.push_back(rtcc->TakeSnapshot(vessel));
+	if (target)
+	{
+		snapshots.push_back(rtcc->TakeSnapshot(target));
 	}
+	jobs.Submit(lane, fcn, 0, [run, snapshots, bodies](Job &job) { RTCCSnapshotScope scope(snapshots); OrbMech::BodySnapshotScope bodyscope(bodies.get()); return run ? run() : 0; }, [this, apply](Job &job) { subThreadDone(job, apply); });
+	subThreadStatus = jobs.Pending();
 	return(0);
 }
 
-int ARCore::subThread()
+void ARCore::subThreadDone(Job &job, const std::function<void()> &apply)
 {
-	int Result = 0;
-	subThreadStatus = 2; // Running
-	switch (subThreadMode) {
+	int pending = jobs.Pending();
+
+	// A cancelled job has been replaced by a newer one, so its results are dropped.
+	if (!job.Cancelled() && apply)
+	{
+		apply();
+	}
+
+	if (pending > 0)
+	{
+		subThreadStatus = pending;
+	}
+	else if (!job.Cancelled())
+	{
+		subThreadStatus = job.result;
+	}
+	else
+	{
+		subThreadStatus = 0;
+	}
+}
+
+void ARCore::subThread(int fcn, std::function<int()> &run, std::function<void()> &apply)
+{
+	switch (fcn) {
 	case 0: // Test
-		Sleep(5000); // Waste 5 seconds
-		Result = 0;  // Success (negative = error)
+		run = []() {
+			Sleep(5000); // Waste 5 seconds
+			return 0;  // Success (negative = error)
+		};
 		break;
 	case 1: //Lambert Targeting
 	{
 		LambertMan opt;
+		std::shared_ptr<ManeuverSolution> sol = std::make_shared<ManeuverSolution>();
+
 		opt.axis = !lambertmultiaxis;
 		opt.GETbase = GETbase;
 		opt.impulsive = RTCC_NONIMPULSIVE;
@@ -1182,16 +1259,24 @@ int ARCore::subThread()
 		{
 			opt.csmlmdocked = true;
 		}
-		rtcc->LambertTargeting(&opt, dV_LVLH, P30TIG);
-		LambertdeltaV = dV_LVLH;
 
-		Result = 0;
+		run = [=]() mutable {
+			rtcc->LambertTargeting(&opt, sol->dV_LVLH, sol->P30TIG);
+			return 0;
+		};
+		apply = [=]() {
+			dV_LVLH = sol->dV_LVLH;
+			P30TIG = sol->P30TIG;
+			LambertdeltaV = dV_LVLH;
+		};
 	}
 	break;
 	case 2:	//CDH Targeting
 	{
-		double dH_CDH;
 		CDHOpt opt;
+		std::shared_ptr<ManeuverSolution> sol = std::make_shared<ManeuverSolution>();
+		std::shared_ptr<double> dH_CDH = std::make_shared<double>(0.0);
+		int mode = CDHtimemode;
 
 		opt.CDHtimemode = CDHtimemode;
 		opt.DH = DH*1852.0;
@@ -1201,22 +1286,28 @@ int ARCore::subThread()
 		opt.vessel = vessel;
 		opt.TIG = CDHtime;
 
-		dH_CDH = rtcc->CDHcalc(&opt, CDHdeltaV, CDHtime_cor);
-
-		if (CDHtimemode == 0)
-		{
-			DH = dH_CDH / 1852.0;
-		}
+		run = [=]() mutable {
+			*dH_CDH = rtcc->CDHcalc(&opt, sol->dV_LVLH, sol->P30TIG);
+			return 0;
+		};
+		apply = [=]() {
+			CDHdeltaV = sol->dV_LVLH;
+			CDHtime_cor = sol->P30TIG;
 
-		P30TIG = CDHtime_cor;
-		dV_LVLH = CDHdeltaV;
+			if (mode == 0)
+			{
+				DH = *dH_CDH / 1852.0;
+			}
 
-		Result = 0;
+			P30TIG = CDHtime_cor;
+			dV_LVLH = CDHdeltaV;
+		};
 	}
 	break;
 	case 3:	//Orbital Adjustment Targeting
 	{
 		OrbAdjOpt opt;
+		std::shared_ptr<ManeuverSolution> sol = std::make_shared<ManeuverSolution>();
 
 		opt.GETbase = GETbase;
 		opt.gravref = gravref;
@@ -1236,17 +1327,23 @@ int ARCore::subThread()
 			opt.csmlmdocked = true;
 		}
 
-		rtcc->OrbitAdjustCalc(&opt, OrbAdjDVX, P30TIG);
-
-		dV_LVLH = OrbAdjDVX;
-
-		Result = 0;
+		run = [=]() mutable {
+			rtcc->OrbitAdjustCalc(&opt, sol->dV_LVLH, sol->P30TIG);
+			return 0;
+		};
+		apply = [=]() {
+			OrbAdjDVX = sol->dV_LVLH;
+			P30TIG = sol->P30TIG;
+			dV_LVLH = OrbAdjDVX;
+		};
 	}
 	break;
 	case 4:	//REFSMMAT Calculation
 	{
-		MATRIX3 a;
 		REFSMMATOpt opt;
+		std::shared_ptr<REFSMMATSolution> sol = std::make_shared<REFSMMATSolution>();
+		double epoch = AGCEpoch;
+		int upl = REFSMMATupl, type = vesseltype, refsopt = REFSMMATopt;
 
 		opt.dV_LVLH = dV_LVLH;
 		opt.dV_LVLH2 = LOI_dV_LVLH;
@@ -1261,64 +1358,75 @@ int ARCore::subThread()
 		opt.REFSMMATTime = REFSMMATTime;
 		opt.vessel = vessel;
 
-		REFSMMAT = rtcc->REFSMMATCalc(&opt);
+		run = [=]() mutable {
+			MATRIX3 a;
+			int *oct = sol->oct;
 
-		//sprintf(oapiDebugString(), "%f, %f, %f, %f, %f, %f, %f, %f, %f", REFSMMAT.m11, REFSMMAT.m12, REFSMMAT.m13, REFSMMAT.m21, REFSMMAT.m22, REFSMMAT.m23, REFSMMAT.m31, REFSMMAT.m32, REFSMMAT.m33);
+			sol->REFSMMAT = rtcc->REFSMMATCalc(&opt);
 
-		a = mul(REFSMMAT, OrbMech::transpose_matrix(OrbMech::J2000EclToBRCS(AGCEpoch)));
+			//sprintf(oapiDebugString(), "%f, %f, %f, %f, %f, %f, %f, %f, %f", REFSMMAT.m11, REFSMMAT.m12, REFSMMAT.m13, REFSMMAT.m21, REFSMMAT.m22, REFSMMAT.m23, REFSMMAT.m31, REFSMMAT.m32, REFSMMAT.m33);
 
-		if (REFSMMATupl == 0)
-		{
-			if (vesseltype < 2)
-			{
-				REFSMMAToct[1] = 306;
-			}
-			else
-			{
-				REFSMMAToct[1] = 3606;
-			}
-		}
-		else
-		{
-			if (vesseltype < 2)
+			a = mul(sol->REFSMMAT, OrbMech::transpose_matrix(OrbMech::J2000EclToBRCS(epoch)));
+
+			if (upl == 0)
 			{
-				REFSMMAToct[1] = 1735;
+				if (type < 2)
+				{
+					oct[1] = 306;
+				}
+				else
+				{
+					oct[1] = 3606;
+				}
 			}
 			else
 			{
-				REFSMMAToct[1] = 1733;
+				if (type < 2)
+				{
+					oct[1] = 1735;
+				}
+				else
+				{
+					oct[1] = 1733;
+				}
 			}
-		}
 
-		REFSMMAToct[0] = 24;
-		REFSMMAToct[2] = OrbMech::DoubleToBuffer(a.m11, 1, 1);
-		REFSMMAToct[3] = OrbMech::DoubleToBuffer(a.m11, 1, 0);
-		REFSMMAToct[4] = OrbMech::DoubleToBuffer(a.m12, 1, 1);
-		REFSMMAToct[5] = OrbMech::DoubleToBuffer(a.m12, 1, 0);
-		REFSMMAToct[6] = OrbMech::DoubleToBuffer(a.m13, 1, 1);
-		REFSMMAToct[7] = OrbMech::DoubleToBuffer(a.m13, 1, 0);
-		REFSMMAToct[8] = OrbMech::DoubleToBuffer(a.m21, 1, 1);
-		REFSMMAToct[9] = OrbMech::DoubleToBuffer(a.m21, 1, 0);
-		REFSMMAToct[10] = OrbMech::DoubleToBuffer(a.m22, 1, 1);
-		REFSMMAToct[11] = OrbMech::DoubleToBuffer(a.m22, 1, 0);
-		REFSMMAToct[12] = OrbMech::DoubleToBuffer(a.m23, 1, 1);
-		REFSMMAToct[13] = OrbMech::DoubleToBuffer(a.m23, 1, 0);
-		REFSMMAToct[14] = OrbMech::DoubleToBuffer(a.m31, 1, 1);
-		REFSMMAToct[15] = OrbMech::DoubleToBuffer(a.m31, 1, 0);
-		REFSMMAToct[16] = OrbMech::DoubleToBuffer(a.m32, 1, 1);
-		REFSMMAToct[17] = OrbMech::DoubleToBuffer(a.m32, 1, 0);
-		REFSMMAToct[18] = OrbMech::DoubleToBuffer(a.m33, 1, 1);
-		REFSMMAToct[19] = OrbMech::DoubleToBuffer(a.m33, 1, 0);
-
-		REFSMMATcur = REFSMMATopt;
-
-		Result = 0;
+			oct[0] = 24;
+			oct[2] = OrbMech::DoubleToBuffer(a.m11, 1, 1);
+			oct[3] = OrbMech::DoubleToBuffer(a.m11, 1, 0);
+			oct[4] = OrbMech::DoubleToBuffer(a.m12, 1, 1);
+			oct[5] = OrbMech::DoubleToBuffer(a.m12, 1, 0);
+			oct[6] = OrbMech::DoubleToBuffer(a.m13, 1, 1);
+			oct[7] = OrbMech::DoubleToBuffer(a.m13, 1, 0);
+			oct[8] = OrbMech::DoubleToBuffer(a.m21, 1, 1);
+			oct[9] = OrbMech::DoubleToBuffer(a.m21, 1, 0);
+			oct[10] = OrbMech::DoubleToBuffer(a.m22, 1, 1);
+			oct[11] = OrbMech::DoubleToBuffer(a.m22, 1, 0);
+			oct[12] = OrbMech::DoubleToBuffer(a.m23, 1, 1);
+			oct[13] = OrbMech::DoubleToBuffer(a.m23, 1, 0);
+			oct[14] = OrbMech::DoubleToBuffer(a.m31, 1, 1);
+			oct[15] = OrbMech::DoubleToBuffer(a.m31, 1, 0);
+			oct[16] = OrbMech::DoubleToBuffer(a.m32, 1, 1);
+			oct[17] = OrbMech::DoubleToBuffer(a.m32, 1, 0);
+			oct[18] = OrbMech::DoubleToBuffer(a.m33, 1, 1);
+			oct[19] = OrbMech::DoubleToBuffer(a.m33, 1, 0);
+			return 0;
+		};
+		apply = [=]() {
+			REFSMMAT = sol->REFSMMAT;
+			memcpy(REFSMMAToct, sol->oct, sizeof(REFSMMAToct));
+			REFSMMATcur = refsopt;
+		};
 	}
 	break;
 	case 5: //LOI Targeting
 	{
 		LOIMan opt;
-		double MJDcut;
+		std::shared_ptr<LOISolution> sol = std::make_shared<LOISolution>();
+		int man = LOImaneuver;
+		OBJHANDLE hMoon, gref = gravref;
+		VECTOR3 R_A, V_A, dV_TLCC = TLCC_dV_LVLH;
+		double SVMJD, mass, TIG_TLCC = TLCC_TIG, base = GETbase;
 
 		opt.GETbase = GETbase;
 		opt.h_apo = LOIapo;
@@ -1341,60 +1449,75 @@ int ARCore::subThread()
 			opt.csmlmdocked = true;
 		}
 
-		if (LOImaneuver == 0 || LOImaneuver == 4)
-		{
-			rtcc->LOITargeting(&opt, TLCC_dV_LVLH, TLCC_TIG, R_TLI, V_TLI, MJDcut);
-			P30TIG = TLCC_TIG;
-			dV_LVLH = TLCC_dV_LVLH;
-		}
-		else if (LOImaneuver == 1)
-		{
-			OBJHANDLE hMoon;
-			VECTOR3 R_A, V_A, R0B, V0B, UX, UY, UZ, DV, V2;
-			double SVMJD;
-			//MATRIX3 Rot;
-			SV RV1;
+		//The LOI after a midcourse correction starts from the state vector now
+		hMoon = oapiGetObjectByName("Moon");
+		vessel->GetRelativePos(gravref, R_A);
+		vessel->GetRelativeVel(gravref, V_A);
+		SVMJD = oapiGetSimMJD();
+		mass = vessel->GetMass();
 
-			hMoon = oapiGetObjectByName("Moon");
+		run = [=]() mutable {
+			double MJDcut;
 
-			vessel->GetRelativePos(gravref, R_A);
-			vessel->GetRelativeVel(gravref, V_A);
-			SVMJD = oapiGetSimMJD();
-			R0B = _V(R_A.x, R_A.z, R_A.y);
-			V0B = _V(V_A.x, V_A.z, V_A.y);
+			if (man == 1)
+			{
+				VECTOR3 R0B, V0B, UX, UY, UZ, DV, V2;
+				//MATRIX3 Rot;
+				SV RV1;
 
-			OrbMech::oneclickcoast(R0B, V0B, SVMJD, TLCC_TIG - (SVMJD - GETbase)*24.0*3600.0, RV1.R, RV1.V, gravref, hMoon);
-			RV1.gravref = hMoon;
-			RV1.MJD = GETbase + TLCC_TIG / 24.0 / 3600.0;
-			RV1.mass = vessel->GetMass();
-			opt.useSV = true;
+				R0B = _V(R_A.x, R_A.z, R_A.y);
+				V0B = _V(V_A.x, V_A.z, V_A.y);
 
-			UY = unit(crossp(RV1.V, RV1.R));
-			UZ = unit(-RV1.R);
-			UX = crossp(UY, UZ);
+				OrbMech::oneclickcoast(R0B, V0B, SVMJD, TIG_TLCC - (SVMJD - base)*24.0*3600.0, RV1.R, RV1.V, gref, hMoon);
+				RV1.gravref = hMoon;
+				RV1.MJD = base + TIG_TLCC / 24.0 / 3600.0;
+				RV1.mass = mass;
+				opt.useSV = true;
 
-			DV = UX*TLCC_dV_LVLH.x + UY*TLCC_dV_LVLH.y + UZ*TLCC_dV_LVLH.z;
-			V2 = RV1.V + DV;
+				UY = unit(crossp(RV1.V, RV1.R));
+				UZ = unit(-RV1.R);
+				UX = crossp(UY, UZ);
 
-			opt.RV_MCC = RV1;
-			opt.RV_MCC.V = V2;
+				DV = UX*dV_TLCC.x + UY*dV_TLCC.y + UZ*dV_TLCC.z;
+				V2 = RV1.V + DV;
 
-			rtcc->LOITargeting(&opt, LOI_dV_LVLH, LOI_TIG, R_TLI, V_TLI, MJDcut);
-		}
-		else
-		{
-			rtcc->LOITargeting(&opt, LOI_dV_LVLH, LOI_TIG, R_TLI, V_TLI, MJDcut);
-			P30TIG = LOI_TIG;
-			dV_LVLH = LOI_dV_LVLH;
-		}
+				opt.RV_MCC = RV1;
+				opt.RV_MCC.V = V2;
+			}
+
+			rtcc->LOITargeting(&opt, sol->dV_LVLH, sol->P30TIG, sol->R_TLI, sol->V_TLI, MJDcut);
+			return 0;
+		};
+		apply = [=]() {
+			R_TLI = sol->R_TLI;
+			V_TLI = sol->V_TLI;
 
-		Result = 0;
+			if (man == 0 || man == 4)
+			{
+				TLCC_dV_LVLH = sol->dV_LVLH;
+				TLCC_TIG = sol->P30TIG;
+				P30TIG = TLCC_TIG;
+				dV_LVLH = TLCC_dV_LVLH;
+			}
+			else if (man == 1)
+			{
+				LOI_dV_LVLH = sol->dV_LVLH;
+				LOI_TIG = sol->P30TIG;
+			}
+			else
+			{
+				LOI_dV_LVLH = sol->dV_LVLH;
+				LOI_TIG = sol->P30TIG;
+				P30TIG = LOI_TIG;
+				dV_LVLH = LOI_dV_LVLH;
+			}
+		};
 	}
 	break;
 	case 6: //TPI PAD
 	{
 		AP7TPIPADOpt opt;
-		AP7TPI pad;
+		std::shared_ptr<AP7TPI> pad = std::make_shared<AP7TPI>();
 
 		opt.dV_LVLH = dV_LVLH;
 		opt.GETbase = GETbase;
@@ -1402,24 +1525,26 @@ int ARCore::subThread()
 		opt.vessel = vessel;
 		opt.TIG = P30TIG;
 
-		rtcc->AP7TPIPAD(&opt, pad);
-
-		TPIPAD_AZ = pad.AZ;
-		TPIPAD_BT = pad.Backup_bT;
-		TPIPAD_ddH = pad.dH_Max;
-		TPIPAD_dH = pad.dH_TPI;
-		TPIPAD_dV_LOS = pad.Backup_dV;
-		TPIPAD_ELmin5 = pad.EL;
-		TPIPAD_R = pad.R;
-		TPIPAD_Rdot = pad.Rdot;
-
-		Result = 0;
+		run = [=]() mutable {
+			rtcc->AP7TPIPAD(&opt, *pad);
+			return 0;
+		};
+		apply = [=]() {
+			TPIPAD_AZ = pad->AZ;
+			TPIPAD_BT = pad->Backup_bT;
+			TPIPAD_ddH = pad->dH_Max;
+			TPIPAD_dH = pad->dH_TPI;
+			TPIPAD_dV_LOS = pad->Backup_dV;
+			TPIPAD_ELmin5 = pad->EL;
+			TPIPAD_R = pad->R;
+			TPIPAD_Rdot = pad->Rdot;
+		};
 	}
 	break;
 	case 7:	//Entry Targeting
 	{
 		EntryOpt opt;
-		EntryResults res;
+		std::shared_ptr<EntryResults> res = std::make_shared<EntryResults>();
 
 		if (vesseltype == 0 || vesseltype == 2)
 		{
@@ -1459,25 +1584,20 @@ int ARCore::subThread()
 			opt.Range = 0;
 		}
 
-		rtcc->EntryTargeting(&opt, &res);
-
-		Entry_DV = res.dV_LVLH;
-		EntryTIGcor = res.P30TIG;
-		EntryLatcor = res.latitude;
-		EntryLngcor = res.longitude;
-		P37GET400K = res.GET05G;
-		EntryRTGO = res.RTGO;
-		EntryAngcor = res.ReA;
-		P30TIG = EntryTIGcor;
-		dV_LVLH = Entry_DV;
-		entryprecision = res.precision;
-
-		Result = 0;
+		run = [=]() mutable {
+			rtcc->EntryTargeting(&opt, res.get());
+			return 0;
+		};
+		apply = [=]() {
+			ApplyEntryResults(*res);
+		};
 	}
 	break;
 	case 8: //TLI PAD
 	{
 		TLIPADOpt opt;
+		std::shared_ptr<TLIPAD> pad = std::make_shared<TLIPAD>();
+
 		opt.dV_LVLH = dV_LVLH;
 		opt.GETbase = GETbase;
 		opt.REFSMMAT = REFSMMAT;
@@ -1485,8 +1605,14 @@ int ARCore::subThread()
 		opt.vessel = vessel;
 		opt.uselvdc = false;
 		opt.SeparationAttitude = _V(0.0*RAD, -120.0*RAD, 0.0);
-		rtcc->TLI_PAD(&opt, tlipad);
-		Result = 0;
+
+		run = [=]() mutable {
+			rtcc->TLI_PAD(&opt, *pad);
+			return 0;
+		};
+		apply = [=]() {
+			tlipad = *pad;
+		};
 	}
 	break;
 	case 9: //Maneuver PAD
@@ -1494,6 +1620,7 @@ int ARCore::subThread()
 		if (vesseltype < 2)
 		{
 			AP11ManPADOpt opt;
+			std::shared_ptr<AP11MNV> pad = std::make_shared<AP11MNV>();
 
 			opt.dV_LVLH = dV_LVLH;
 			opt.engopt = ManPADSPS;
@@ -1505,11 +1632,18 @@ int ARCore::subThread()
 			opt.vessel = vessel;
 			opt.vesseltype = vesseltype;
 
-			rtcc->AP11ManeuverPAD(&opt, manpad);
+			run = [=]() mutable {
+				rtcc->AP11ManeuverPAD(&opt, *pad);
+				return 0;
+			};
+			apply = [=]() {
+				manpad = *pad;
+			};
 		}
 		else
 		{
 			AP11LMManPADOpt opt;
+			std::shared_ptr<AP11LMMNV> pad = std::make_shared<AP11LMMNV>();
 
 			opt.dV_LVLH = dV_LVLH;
 			opt.engopt = ManPADSPS;
@@ -1520,15 +1654,20 @@ int ARCore::subThread()
 			opt.vessel = vessel;
 			opt.vesseltype = vesseltype;
 
-			rtcc->AP11LMManeuverPAD(&opt, lmmanpad);
+			run = [=]() mutable {
+				rtcc->AP11LMManeuverPAD(&opt, *pad);
+				return 0;
+			};
+			apply = [=]() {
+				lmmanpad = *pad;
+			};
 		}
-
-		Result = 0;
 	}
 	break;
 	case 10:	//DOI Targeting
 	{
 		DOIMan opt;
+		std::shared_ptr<ManeuverSolution> sol = std::make_shared<ManeuverSolution>();
 
 		if (vesseltype == 0 || vesseltype == 2)
 		{
@@ -1545,21 +1684,22 @@ int ARCore::subThread()
 		opt.alt = LOIperi;
 		opt.vessel = vessel;
 
-		rtcc->DOITargeting(&opt, LOI_dV_LVLH, LOI_TIG);
-
-		P30TIG = LOI_TIG;
-		dV_LVLH = LOI_dV_LVLH;
-
-		Result = 0;
+		run = [=]() mutable {
+			rtcc->DOITargeting(&opt, sol->dV_LVLH, sol->P30TIG);
+			return 0;
+		};
+		apply = [=]() {
+			LOI_dV_LVLH = sol->dV_LVLH;
+			LOI_TIG = sol->P30TIG;
+			P30TIG = LOI_TIG;
+			dV_LVLH = LOI_dV_LVLH;
+		};
 	}
 	break;
 	case 11: //TEI Targeting
 	{
 		TEIOpt opt;
-		EntryResults res;
-		double SVMJD;
-
-		SVMJD = oapiGetSimMJD();
+		std::shared_ptr<EntryResults> res = std::make_shared<EntryResults>();
 
 		entryprecision = 1;
 
@@ -1596,26 +1736,88 @@ int ARCore::subThread()
 		opt.vessel = vessel;
 		opt.entrylongmanual = entrylongmanual;
 
-		rtcc->TEITargeting(&opt, &res);//Entry_DV, EntryTIGcor, EntryLatcor, EntryLngcor, P37GET400K, EntryRTGO, EntryVIO, EntryAngcor);
-
-		Entry_DV = res.dV_LVLH;
-		EntryTIGcor = res.P30TIG;
-		EntryLatcor = res.latitude;
-		EntryLngcor = res.longitude;
-		P37GET400K = res.GET05G;
-		EntryRTGO = res.RTGO;
-		EntryAngcor = res.ReA;
-		P30TIG = EntryTIGcor;
-		dV_LVLH = Entry_DV;
-		entryprecision = res.precision;
-		
-		Result = 0;
+		run = [=]() mutable {
+			rtcc->TEITargeting(&opt, res.get());//Entry_DV, EntryTIGcor, EntryLatcor, EntryLngcor, P37GET400K, EntryRTGO, EntryVIO, EntryAngcor);
+			return 0;
+		};
+		apply = [=]() {
+			ApplyEntryResults(*res);
+		};
 	}
 	break;
+	case 12: //Entry/TEI Scan
+	{
+		std::shared_ptr<std::vector<EntryScanResult> > table = std::make_shared<std::vector<EntryScanResult> >();
+		bool docked;
+
+		if (vesseltype == 0 || vesseltype == 2)
+		{
+			docked = false;
+		}
+		else
+		{
+			docked = true;
+		}
+
+		if (entrycalcmode == 3)
+		{
+			TEIOpt opt;
+
+			opt.csmlmdocked = docked;
+			opt.EntryLng = entrylongmanual ? EntryLng : 0.0;
+			opt.entrylongmanual = entrylongmanual;
+			opt.GETbase = GETbase;
+			opt.returnspeed = returnspeed;
+			opt.TEItype = TEItype;
+			opt.TIGguess = (TEItype == 2) ? 0.0 : EntryTIG;
+			opt.vessel = vessel;
+
+			run = [=]() mutable {
+				rtcc->TEIScan(&opt, *table);
+				return 0;
+			};
+		}
+		else
+		{
+			EntryOpt opt;
+
+			opt.csmlmdocked = docked;
+			opt.entrylongmanual = entrylongmanual;
+			opt.GETbase = GETbase;
+			opt.impulsive = RTCC_IMPULSIVE;
+			opt.lng = entrylongmanual ? EntryLng : 0.0;
+			opt.nominal = entrynominal;
+			opt.Range = 0;
+			opt.ReA = EntryAng;
+			opt.TIGguess = EntryTIG;
+			opt.type = entrycritical;
+			opt.vessel = vessel;
+
+			run = [=]() mutable {
+				rtcc->EntryScan(&opt, *table);
+				return 0;
+			};
+		}
+		apply = [=]() {
+			entryscan.swap(*table);
+		};
 	}
-	subThreadStatus = Result;
-	// Printing messages from the subthread is not safe, but this is just for testing.
-	return(0);
+	break;
+	}
+}
+
+void ARCore::ApplyEntryResults(const EntryResults &res)
+{
+	Entry_DV = res.dV_LVLH;
+	EntryTIGcor = res.P30TIG;
+	EntryLatcor = res.latitude;
+	EntryLngcor = res.longitude;
+	P37GET400K = res.GET05G;
+	EntryRTGO = res.RTGO;
+	EntryAngcor = res.ReA;
+	P30TIG = EntryTIGcor;
+	dV_LVLH = Entry_DV;
+	entryprecision = res.precision;
 }
 
 void ARCore::StartIMFDRequest() {
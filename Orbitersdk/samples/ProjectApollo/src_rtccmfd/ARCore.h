@@ -15,7 +15,10 @@
 #include "saturn.h"
 #include "mcc.h"
 #include "rtcc.h"
+#include "jobqueue.h"
 #include <queue>
+#include <memory>
+#include <functional>
 
 struct ApolloRTCCMFDData {  // global data storage
 	int connStatus;
@@ -29,6 +32,23 @@ struct ApolloRTCCMFDData {  // global data storage
 	Saturn *progVessel;
 };
 
+// Results of a calculation, filled in by the job and stored by ARCore::subThreadDone()
+struct ManeuverSolution {
+	VECTOR3 dV_LVLH;
+	double P30TIG;
+};
+
+struct LOISolution {
+	VECTOR3 dV_LVLH;
+	double P30TIG;
+	VECTOR3 R_TLI, V_TLI;
+};
+
+struct REFSMMATSolution {
+	MATRIX3 REFSMMAT;
+	int oct[20];
+};
+
 class ARCore {
 public:
 	ARCore(VESSEL* v);
@@ -41,6 +61,8 @@ public:
 	void LmkCalc();
 	void TEICalc();
 	void EntryCalc();
+	void EntryScanCalc();
+	void EntryScanSelect(int option);
 	void EntryUpdateCalc();
 	void StateVectorCalc();
 	void VecPointCalc();
@@ -65,13 +87,15 @@ public:
 	void MapUpdate();
 
 	int startSubthread(int fcn);
-	int subThread();
+	void subThread(int fcn, std::function<int()> &run, std::function<void()> &apply);
+	void subThreadDone(Job &job, const std::function<void()> &apply);
+	void ApplyEntryResults(const EntryResults &res);
 	void StartIMFDRequest();
 	void StopIMFDRequest();
 
 	// SUBTHREAD MANAGEMENT
-	int subThreadMode;										// What should the subthread do?
-	int subThreadStatus;									// 0 = done/not busy, 1 = busy, negative = done with error
+	JobQueue jobs;											// Calculations queued or running
+	int subThreadStatus;									// 0 = done/not busy, >0 = jobs busy, negative = done with error
 
 	RTCC* rtcc;
 	ApolloRTCCMFDData g_Data;
@@ -147,6 +171,8 @@ public:
 	int returnspeed; //0 = slow return, 1 = normal return, 2 = fast return
 	int TEItype;	//0 = TEI, 1 = Flyby, 2 = PC+2
 	bool TEIfail;
+	std::vector<EntryScanResult> entryscan;	//Ranked options of the last entry or TEI scan
+	bool entryscanview;	//Show the scan table instead of the single solution
 
 	//STATE VECTOR PAGE
 	bool SVSlot;
@@ -657,7 +657,65 @@ bool ApolloRTCCMFD::Update (oapi::Sketchpad *skp)
 	}
 	else if (screen == 6)
 	{
-		if (G->entrycalcmode == 0)
+		if (G->entryscanview && (G->entrycalcmode == 0 || G->entrycalcmode == 3))
+		{
+			char GETbuff[64], Opt[16];
+			const char *zones[] = { "MPL", "EPL", "AOL", "IOL", "WPL" };
+			const char *speeds[] = { "S", "N", "F" };
+			int row = 0;
+
+			if (G->entrycalcmode == 3)
+			{
+				skp->Text(5 * W / 8, (int)(0.5 * H / 14), "TEI Options", 11);
+			}
+			else
+			{
+				skp->Text(5 * W / 8, (int)(0.5 * H / 14), "Entry Options", 13);
+			}
+
+			if (G->subThreadStatus > 0)
+			{
+				skp->Text(1 * W / 8, 2 * H / 14, "Calculating...", 14);
+			}
+
+			skp->Text(1 * W / 32, 3 * H / 14, " #   DVT      400K   LAT    LNG OPT", 35);
+
+			for (unsigned i = 0;i < G->entryscan.size() && row < 10;i++)
+			{
+				EntryScanResult &c = G->entryscan[i];
+
+				if (c.precision == 9)
+				{
+					continue;
+				}
+
+				const char *zone = c.landingzone < 0 ? "MAN" : zones[c.landingzone];
+				if (G->entrycalcmode == 3)
+				{
+					sprintf(Opt, "%s %s%d", zone, speeds[c.returnspeed], c.rev);
+				}
+				else if (G->entrycritical == 0)
+				{
+					sprintf(Opt, "%s %s", zone, c.nominal ? "N" : "M");
+				}
+				else
+				{
+					sprintf(Opt, "%s", zone);
+				}
+
+				GET_Display(GETbuff, c.GET400K);
+				GETbuff[9] = '\0';	//Without " GET"
+				sprintf(Buffer, "%2d %5.0f %s %+5.1f %+6.1f %s", (int)i + 1, c.dv / 0.3048, GETbuff, c.latitude*DEG, c.longitude*DEG, Opt);
+				skp->Text(1 * W / 32, (4 + row) * H / 14, Buffer, strlen(Buffer));
+				row++;
+			}
+
+			if (row == 0 && G->subThreadStatus <= 0)
+			{
+				skp->Text(1 * W / 8, 4 * H / 14, "No solution", 11);
+			}
+		}
+		else if (G->entrycalcmode == 0)
 		{
 			skp->Text(6 * W / 8,(int)(0.5 * H / 14), "Entry", 5);
 
@@ -2414,7 +2472,12 @@ void ApolloRTCCMFD::set_CDHtime(double CDHtime)
 
 void ApolloRTCCMFD::EntryTimeDialogue()
 {
-	if (!(G->TEItype == 2 && G->entrycalcmode == 3))
+	if (G->entryscanview && (G->entrycalcmode == 0 || G->entrycalcmode == 3))
+	{
+		bool EntryScanInput(void *id, char *str, void *data);
+		oapiOpenInputBox("Choose the option:", EntryScanInput, 0, 20, (void*)this);
+	}
+	else if (!(G->TEItype == 2 && G->entrycalcmode == 3))
 	{
 		bool EntryGETInput(void *id, char *str, void *data);
 		oapiOpenInputBox("Choose the GET (Format: hhh:mm:ss)", EntryGETInput, 0, 20, (void*)this);
@@ -2439,6 +2502,38 @@ void ApolloRTCCMFD::set_EntryTime(double time)
 	this->G->EntryTIG = time;
 }
 
+bool EntryScanInput(void *id, char *str, void *data)
+{
+	if (strlen(str)<20)
+	{
+		((ApolloRTCCMFD*)data)->set_EntryScanOption(atoi(str));
+		return true;
+	}
+	return false;
+}
+
+void ApolloRTCCMFD::set_EntryScanOption(int option)
+{
+	G->EntryScanSelect(option);
+}
+
+void ApolloRTCCMFD::menuEntryScan()
+{
+	if (G->entrycalcmode != 0 && G->entrycalcmode != 3)
+	{
+		return;
+	}
+
+	if (G->entryscanview)
+	{
+		G->entryscanview = false;
+	}
+	else if (!(G->entrycalcmode == 3 && G->TEIfail))
+	{
+		G->EntryScanCalc();
+	}
+}
+
 void ApolloRTCCMFD::EntryAngDialogue()
 {
 	if (G->entrycalcmode != 3)
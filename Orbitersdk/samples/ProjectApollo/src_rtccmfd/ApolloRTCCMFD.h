@@ -112,6 +112,8 @@ public:
 	void set_entryang(double ang);
 	void EntryTimeDialogue();
 	void set_EntryTime(double time);
+	void set_EntryScanOption(int option);
+	void menuEntryScan();
 	void set_entrylat(double lat);
 	void EntryLatDialogue();
 	void set_entrylng(double lng);
@@ -219,7 +219,7 @@ ApolloRTCCMFDButtons::ApolloRTCCMFDButtons()
 
 		{ "Calculate Entry", 0, 'C' },
 		{ "Calculation Mode", 0, 'M' },
-		{ "", 0, ' ' },
+		{ "Scan all options", 0, 'S' },
 		{ "Entry Range", 0, 'R' },
 		{ "Uplink to AGC", 0, 'U' },
 		{ "Back to main menu", 0, 'B' },
@@ -236,7 +236,7 @@ ApolloRTCCMFDButtons::ApolloRTCCMFDButtons()
 
 	RegisterFunction("CLC", OAPI_KEY_C, &ApolloRTCCMFD::menuEntryCalc);
 	RegisterFunction("MOD", OAPI_KEY_V, &ApolloRTCCMFD::CycleEntryOpt);
-	RegisterFunction("", OAPI_KEY_Q, &ApolloRTCCMFD::menuVoid);
+	RegisterFunction("SCN", OAPI_KEY_S, &ApolloRTCCMFD::menuEntryScan);
 	RegisterFunction("RAN", OAPI_KEY_R, &ApolloRTCCMFD::EntryRangeDialogue);
 	RegisterFunction("UPL", OAPI_KEY_U, &ApolloRTCCMFD::menuEntryUpload);
 	RegisterFunction("BCK", OAPI_KEY_B, &ApolloRTCCMFD::menuSetMenu);
@@ -40,11 +40,11 @@ Entry::Entry(VECTOR3 R0B, VECTOR3 V0B, double mjd, OBJHANDLE gravref, double GET
 
 	EntryInterface = 400000.0 * 0.3048;
 
-	hEarth = oapiGetObjectByName("Earth");
+	hEarth = OrbMech::GetObjectByName("Earth");
 
-	RCON = oapiGetSize(hEarth) + EntryInterface;
+	RCON = OrbMech::GetSize(hEarth) + EntryInterface;
 	RD = RCON;
-	mu = GGRAV*oapiGetMass(hEarth);
+	mu = GGRAV*OrbMech::GetMass(hEarth);
 
 	EntryTIGcor = EntryTIG;
 
@@ -92,7 +92,7 @@ Entry::Entry(VECTOR3 R0B, VECTOR3 V0B, double mjd, OBJHANDLE gravref, double GET
 		rangeiter = 2;
 	}
 
-	R_E = oapiGetSize(hEarth);
+	R_E = OrbMech::GetSize(hEarth);
 	earthorbitangle = (-31.7 - 2.15)*RAD;
 
 	if (critical == 0)
@@ -115,10 +115,10 @@ Entry::Entry(OBJHANDLE gravref, int critical)
 	double EntryInterface;
 	EntryInterface = 400000.0 * 0.3048;
 
-	hEarth = oapiGetObjectByName("Earth");
-	mu = GGRAV*oapiGetMass(hEarth);
+	hEarth = OrbMech::GetObjectByName("Earth");
+	mu = GGRAV*OrbMech::GetMass(hEarth);
 
-	RCON = oapiGetSize(hEarth) + EntryInterface;
+	RCON = OrbMech::GetSize(hEarth) + EntryInterface;
 
 	if (critical == 0)
 	{
@@ -385,7 +385,7 @@ void Entry::precisioniter(VECTOR3 R1B, VECTOR3 V1B, double t1, double &t21, doub
 
 	n1 = 0;
 	n2 = 0;
-	RCON = oapiGetSize(hEarth) + EntryInterface;
+	RCON = OrbMech::GetSize(hEarth) + EntryInterface;
 	RD = RCON;
 	R_ERR = 1000.0;
 	x2_err = 1.0;
@@ -1671,11 +1671,11 @@ void Entry::EntryUpdateCalc()
 	VECTOR3 R05G, V05G;
 	double dt22;
 
-	hEarth = oapiGetObjectByName("Earth");
+	hEarth = OrbMech::GetObjectByName("Earth");
 
 	EntryInterface = 400000.0 * 0.3048;
-	RCON = oapiGetSize(hEarth) + EntryInterface;
-	mu = GGRAV*oapiGetMass(hEarth);
+	RCON = OrbMech::GetSize(hEarth) + EntryInterface;
+	mu = GGRAV*OrbMech::GetMass(hEarth);
 
 	dt2 = OrbMech::time_radius_integ(R0B, V0B, mjd, RCON, -1, gravref, hEarth, REI, VEI);
 
@@ -1920,11 +1920,11 @@ OBJHANDLE Entry::AGCGravityRef(VESSEL *vessel)
 	OBJHANDLE gravref;
 	VECTOR3 rsph;
 
-	gravref = oapiGetObjectByName("Moon");
+	gravref = OrbMech::GetObjectByName("Moon");
 	vessel->GetRelativePos(gravref, rsph);
 	if (length(rsph) > 64373760.0)
 	{
-		gravref = oapiGetObjectByName("Earth");
+		gravref = OrbMech::GetObjectByName("Earth");
 	}
 	return gravref;
 }
@@ -1936,8 +1936,8 @@ TEI::TEI(VECTOR3 R0M, VECTOR3 V0M, double mjd0, OBJHANDLE gravref, double MJDgue
 
 	this->EntryLng = EntryLng;
 
-	hMoon = oapiGetObjectByName("Moon");
-	hEarth = oapiGetObjectByName("Earth");
+	hMoon = OrbMech::GetObjectByName("Moon");
+	hEarth = OrbMech::GetObjectByName("Earth");
 	this->entrylongmanual = entrylongmanual;
 
 	if (entrylongmanual)
@@ -1953,10 +1953,10 @@ TEI::TEI(VECTOR3 R0M, VECTOR3 V0M, double mjd0, OBJHANDLE gravref, double MJDgue
 	this->mjd0 = mjd0;
 
 	EntryInterface = 400000.0 * 0.3048;
-	RCON = oapiGetSize(hEarth) + EntryInterface;
-	mu_E = GGRAV*oapiGetMass(hEarth);
-	mu_M = GGRAV*oapiGetMass(hMoon);
-	//r_s = 24.0*oapiGetSize(hEarth);//64373760.0;//14.0*oapiGetSize(hEarth);
+	RCON = OrbMech::GetSize(hEarth) + EntryInterface;
+	mu_E = GGRAV*OrbMech::GetMass(hEarth);
+	mu_M = GGRAV*OrbMech::GetMass(hMoon);
+	//r_s = 24.0*OrbMech::GetSize(hEarth);//64373760.0;//14.0*OrbMech::GetSize(hEarth);
 
 	if (TEItype == 0)
 	{
@@ -2032,7 +2032,7 @@ TEI::TEI(VECTOR3 R0M, VECTOR3 V0M, double mjd0, OBJHANDLE gravref, double MJDgue
 		DT_TEI_EI -= 24.0*3600.0;
 	}
 
-	cMoon = oapiGetCelbodyInterface(hMoon);
+	cMoon = OrbMech::GetCelbodyInterface(hMoon);
 	ii = 0;
 	jj = 0;
 	dTIG = 30.0;
@@ -2176,13 +2176,12 @@ VECTOR3 TEI::ThreeBodyAbort(double t_I, double t_EI, VECTOR3 R_I, VECTOR3 V_I, d
 	VECTOR3 R_I_star, delta_I_star, delta_I_star_dot, R_I_sstar, V_I_sstar, V_I_star, R_S, R_I_star_apo, R_E_apo, V_E_apo, V_I_apo;
 	VECTOR3 dV_I_sstar, R_m, V_m;
 	double t_S, tol, dt_S, r_s;
-	double *MoonPos;
-	r_s = 24.0*oapiGetSize(hEarth);//64373760.0;//14.0*oapiGetSize(hEarth);
+	double MoonPos[6];
+	r_s = 24.0*OrbMech::GetSize(hEarth);//64373760.0;//14.0*OrbMech::GetSize(hEarth);
 
 	tol = 20.0;
 
-	MoonPos = new double[12];
-	cMoon->clbkEphemeris(t_I, EPHEM_TRUEPOS | EPHEM_TRUEVEL, MoonPos);
+	OrbMech::GetMoonEphemeris(t_I, MoonPos);
 
 	R_m = _V(MoonPos[0], MoonPos[2], MoonPos[1]);
 	V_m = _V(MoonPos[3], MoonPos[5], MoonPos[4]);
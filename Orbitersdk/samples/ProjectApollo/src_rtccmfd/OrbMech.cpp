@@ -1,5 +1,7 @@
 #include "OrbMech.h"
+#include "jobqueue.h"
 #include <limits>
+#include <vector>
 
 inline double acosh(double z) { return log(z + sqrt(z + 1.0)*sqrt(z - 1.0)); }
 inline double atanh(double z){ return 0.5*log(1.0 + z) - 0.5*log(1.0 - z); }
@@ -162,15 +164,15 @@ double fischer_ellipsoid(VECTOR3 R)		//Used in the AGC to calculate the radius o
 /*OrbMech::OrbMech(VESSEL *v, OBJHANDLE gravref)
 {
 	vessel = v;
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 	this->gravref = gravref;
-	this->JCoeffCount = oapiGetPlanetJCoeffCount(gravref);
+	this->JCoeffCount = OrbMech::GetPlanetJCoeffCount(gravref);
 	this->JCoeff = new double[JCoeffCount];
 	for (int i = 0; i < JCoeffCount; i++)
 	{
-		JCoeff[i] = oapiGetPlanetJCoeff(gravref, i);
+		JCoeff[i] = OrbMech::GetPlanetJCoeff(gravref, i);
 	}
-	this->R_b = oapiGetSize(gravref);
+	this->R_b = OrbMech::GetSize(gravref);
 }*/
 
 void rv_from_r0v0_ta(VECTOR3 R0, VECTOR3 V0, double dt, VECTOR3 &R1, VECTOR3 &V1, double mu)
@@ -464,11 +466,11 @@ void rv_from_r0v0_obla(VECTOR3 R1, VECTOR3 V1, double MJD, double dt, VECTOR3 &R
 	VECTOR3 R1_equ, V1_equ, R2_equ, V2_equ;
 	double h, e, Omega_0, i, omega_0, theta0, a, T, n, E_0, t_0, t_f, n_p, t_n, M_n, E_n, theta_n, Omega_dot, omega_dot, Omega_n, omega_n,mu,JCoeff;
 
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 
-	if (oapiGetPlanetJCoeffCount(gravref) > 0)
+	if (OrbMech::GetPlanetJCoeffCount(gravref) > 0)
 	{
-		JCoeff = oapiGetPlanetJCoeff(gravref, 0);
+		JCoeff = OrbMech::GetPlanetJCoeff(gravref, 0);
 	}
 
 	Rot = GetObliquityMatrix(gravref, MJD);
@@ -500,8 +502,8 @@ void rv_from_r0v0_obla(VECTOR3 R1, VECTOR3 V1, double MJD, double dt, VECTOR3 &R
 		theta_n += 2 * PI;
 	}
 
-	Omega_dot = -(3.0 / 2.0 * sqrt(mu)*JCoeff * OrbMech::power(oapiGetSize(gravref), 2.0) / (OrbMech::power(1.0 - OrbMech::power(e, 2.0), 2.0) * OrbMech::power(a, 7.0 / 2.0)))*cos(i);
-	omega_dot = -(3.0 / 2.0 * sqrt(mu)*JCoeff * OrbMech::power(oapiGetSize(gravref), 2.0) / (OrbMech::power(1.0 - OrbMech::power(e, 2.0), 2.0) * OrbMech::power(a, 7.0 / 2.0)))*(5.0 / 2.0 * sin(i)*sin(i) - 2.0);
+	Omega_dot = -(3.0 / 2.0 * sqrt(mu)*JCoeff * OrbMech::power(OrbMech::GetSize(gravref), 2.0) / (OrbMech::power(1.0 - OrbMech::power(e, 2.0), 2.0) * OrbMech::power(a, 7.0 / 2.0)))*cos(i);
+	omega_dot = -(3.0 / 2.0 * sqrt(mu)*JCoeff * OrbMech::power(OrbMech::GetSize(gravref), 2.0) / (OrbMech::power(1.0 - OrbMech::power(e, 2.0), 2.0) * OrbMech::power(a, 7.0 / 2.0)))*(5.0 / 2.0 * sin(i)*sin(i) - 2.0);
 
 	Omega_n = Omega_0 + Omega_dot*dt;
 	omega_n = omega_0 + omega_dot*dt;
@@ -762,7 +764,7 @@ VECTOR3 elegant_lambert(VECTOR3 R1, VECTOR3 V1, VECTOR3 R2, double dt, int N, bo
 	//Low Energy
 	x = 1.0 + 4.0 * l;
 
-	while (abs(ratio) > tol && nMax >= n)
+	while (abs(ratio) > tol && nMax >= n && !JobCancelled())
 	{
 		n = n + 1;
 		if (N == 0)
@@ -810,7 +812,7 @@ VECTOR3 elegant_lambert(VECTOR3 R1, VECTOR3 V1, VECTOR3 R2, double dt, int N, bo
 
 	ratio = 1;
 	n = 0;
-	while (abs(ratio) > tol && nMax >= n)
+	while (abs(ratio) > tol && nMax >= n && !JobCancelled())
 	{
 		n = n + 1;
 		h1 = (l + x)*(1.0 + 2.0 * x + l) / (2.0 * (l - OrbMech::power(x, 2.0)));
@@ -869,8 +871,8 @@ VECTOR3 ThreeBodyLambert(double t_I, double t_E, VECTOR3 R_I, VECTOR3 V_init, VE
 	OBJHANDLE hMoon, hEarth;
 	//R_I_star, delta_I_star, delta_I_star_dot, 
 
-	hMoon = oapiGetObjectByName("Moon");
-	hEarth = oapiGetObjectByName("Earth");
+	hMoon = OrbMech::GetObjectByName("Moon");
+	hEarth = OrbMech::GetObjectByName("Earth");
 
 	tol = 1000.0;
 
@@ -1108,7 +1110,7 @@ VECTOR3 Vinti(VECTOR3 R1, VECTOR3 V1, VECTOR3 R2, double mjd0, double dt, int N,
 	MATRIX3 T2;
 	OBJHANDLE hEarth;
 
-	hEarth = oapiGetObjectByName("Earth");
+	hEarth = OrbMech::GetObjectByName("Earth");
 
 	h = 10e-3;
 	rho = 0.5;
@@ -1119,7 +1121,7 @@ VECTOR3 Vinti(VECTOR3 R1, VECTOR3 V1, VECTOR3 R2, double mjd0, double dt, int N,
 	nMax = 100;
 	nMax2 = 10;
 
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 
 	double hvec[4] = { h / 2, -h / 2, rho*h / 2, -rho*h / 2 };
 
@@ -1170,7 +1172,7 @@ VECTOR3 Vinti(VECTOR3 R1, VECTOR3 V1, VECTOR3 R2, double mjd0, double dt, int N,
 		rv_from_r0v0_obla(R1, V1_star, mjd0, dt, R2_star, V2_star, gravref);
 		dr2 = R2 - R2_star;
 
-		while (length(dr2) > error3 && nMax2 >= n)
+		while (length(dr2) > error3 && nMax2 >= n && !JobCancelled())
 		{
 			n += 1;
 			for (int i = 0; i < 4; i++)
@@ -1209,7 +1211,7 @@ VECTOR3 Vinti(VECTOR3 R1, VECTOR3 V1, VECTOR3 R2, double mjd0, double dt, int N,
 	oneclickcoast(R1, V1_star, mjd0, dt, R2_star, V2_star, gravin, gravout);
 	dr2 = R2 - R2_star;
 
-	while (length(dr2) > error2 && nMax >= n)
+	while (length(dr2) > error2 && nMax >= n && !JobCancelled())
 	{
 		n += 1;
 		for (int i = 0; i < 4; i++)
@@ -1259,7 +1261,7 @@ double NSRsecant(VECTOR3 RA, VECTOR3 VA, VECTOR3 RP, VECTOR3 VP, double mjd0, do
 
 	stop = false;
 
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 
 	//rv_from_r0v0(RA, VA, x, RA2, VA2, mu);
 	//rv_from_r0v0(RP, VP, x, RP2, VP2, mu);
@@ -1308,7 +1310,7 @@ MATRIX3 GetRotationMatrix(OBJHANDLE plan, double t)
 	double t0, T_p, L_0, e_rel, phi_0, T_s, e_ref, L_ref, L_rel, phi;
 	MATRIX3 Rot1, Rot2, R_ref, Rot3, Rot4, R_rel, R_rot, R, Rot;
 
-	if (plan == oapiGetObjectByName("Earth"))
+	if (plan == OrbMech::GetObjectByName("Earth"))
 	{
 		t0 = 51544.5;								//LAN_MJD, MJD of the LAN in the "beginning"
 		T_p = -9413040.4;							//Precession Period
@@ -1319,7 +1321,7 @@ MATRIX3 GetRotationMatrix(OBJHANDLE plan, double t)
 		e_ref = 0;									//Precession Obliquity
 		L_ref = 0;									//Precession LAN
 	}
-	else if (plan == oapiGetObjectByName("Moon"))
+	else if (plan == OrbMech::GetObjectByName("Moon"))
 	{
 		t0 = 51544.5;							//LAN_MJD, MJD of the LAN in the "beginning"
 		T_p = -6793.468728092782;				//Precession Period
@@ -1361,7 +1363,7 @@ MATRIX3 Orbiter2PACSS13(double mjd, double lat, double lng, double azi)
 	MATRIX3 Rot1, Rot2, Rot3, Rot4;
 	VECTOR3 R_P, UX10, UY10, UZ10;
 
-	hEarth = oapiGetObjectByName("Earth");
+	hEarth = OrbMech::GetObjectByName("Earth");
 
 	Rot1 = GetRotationMatrix(hEarth, mjd);
 	Rot2 = _M(1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0, 0.0);
@@ -1382,7 +1384,7 @@ double GetPlanetCurrentRotation(OBJHANDLE plan, double t)
 	MATRIX3 Rot1, Rot2, R_ref, Rot3, Rot4, Rot5, Rot6, R_rel, R_rot, Rot, R_ecl, R_off;
 	VECTOR3 s;
 
-	if (plan == oapiGetObjectByName("Earth"))
+	if (plan == OrbMech::GetObjectByName("Earth"))
 	{
 		t0 = 51544.5;								//LAN_MJD, MJD of the LAN in the "beginning"
 		T_p = -9413040.4;							//Precession Period
@@ -1393,7 +1395,7 @@ double GetPlanetCurrentRotation(OBJHANDLE plan, double t)
 		e_ref = 0;									//Precession Obliquity
 		L_ref = 0;									//Precession LAN
 	}
-	else if (plan == oapiGetObjectByName("Moon"))
+	else if (plan == OrbMech::GetObjectByName("Moon"))
 	{
 		t0 = 51544.5;							//LAN_MJD, MJD of the LAN in the "beginning"
 		T_p = -6793.468728092782;				//Precession Period
@@ -1486,8 +1488,8 @@ double findelev_gs(VECTOR3 R_A0, VECTOR3 V_A0, VECTOR3 R_gs, double mjd0, double
 	dt_max = 150.0;
 	dt_0 = 0;
 
-	w_A = PI2 / oapiGetPlanetPeriod(gravref);
-	if (gravref == oapiGetObjectByName("Moon"))
+	w_A = PI2 / OrbMech::GetPlanetPeriod(gravref);
+	if (gravref == OrbMech::GetObjectByName("Moon"))
 	{
 		w_A *= -1.0;
 	}
@@ -1581,7 +1583,7 @@ double findelev_gs(VECTOR3 R_A0, VECTOR3 V_A0, VECTOR3 R_gs, double mjd0, double
 	{
 		theta_0 = -theta_0;
 	}
-	if (gravref == oapiGetObjectByName("Moon"))
+	if (gravref == OrbMech::GetObjectByName("Moon"))
 	{
 		theta_0 *= -1.0;
 	}
@@ -1733,7 +1735,7 @@ double time_radius_integ(VECTOR3 R, VECTOR3 V, double mjd0, double r, double s,
 	double dt1, sing, cosg, x2PRE, dt21,beta12,beta4,RF,phi4,dt21apo,beta13,dt2,beta14,mu;
 	VECTOR3 N, R0out, V0out;
 
-	mu = GGRAV*oapiGetMass(gravout);
+	mu = GGRAV*OrbMech::GetMass(gravout);
 	beta12 = 1.0;
 	dt21apo = 100000000.0;
 	dt2 = 0.0;
@@ -1806,8 +1808,8 @@ void orbitmidnight(VECTOR3 R, VECTOR3 V, VECTOR3 sun, OBJHANDLE planet, bool nig
 		swit = 1.0;
 	}
 	tol = 1e-6;
-	mu = GGRAV*oapiGetMass(planet);
-	R_E = oapiGetSize(planet);
+	mu = GGRAV*OrbMech::GetMass(planet);
+	R_E = OrbMech::GetSize(planet);
 
 	coe = coe_from_sv(R, V, mu);
 
@@ -1862,8 +1864,8 @@ void umbra(VECTOR3 R, VECTOR3 V, VECTOR3 sun, OBJHANDLE planet, bool rise, doubl
 	int j;
 
 	tol = 1e-6;
-	mu = GGRAV*oapiGetMass(planet);
-	R_E = oapiGetSize(planet);
+	mu = GGRAV*OrbMech::GetMass(planet);
+	R_E = OrbMech::GetSize(planet);
 	f = 1;
 
 	coe = coe_from_sv(R, V, mu);
@@ -2094,10 +2096,10 @@ double P29TimeOfLongitude(VECTOR3 R0, VECTOR3 V0, double MJD, OBJHANDLE gravref,
 	int n, s_G;
 	OBJHANDLE hEarth;
 
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 	n = 0;
 	eps_phi = 0.0001*RAD;
-	hEarth = oapiGetObjectByName("Earth");
+	hEarth = OrbMech::GetObjectByName("Earth");
 	absphidminphi = 1.0;
 
 	U_Z = _V(0.0, 1.0, 0.0);
@@ -2236,10 +2238,10 @@ bool groundstation(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE planet, double la
 	dt_max = 100.0;
 	nmax = 100;
 	dt_old = 1;
-	R_E = oapiGetSize(planet);
-	mu = GGRAV*oapiGetMass(planet);
+	R_E = OrbMech::GetSize(planet);
+	mu = GGRAV*OrbMech::GetMass(planet);
 	rev = 0.0;
-	T_p = oapiGetPlanetPeriod(planet);
+	T_p = OrbMech::GetPlanetPeriod(planet);
 
 	while (abs(dt_old - dt) > 0.5 && nn <= nmax)
 	{
@@ -2310,8 +2312,8 @@ bool gslineofsight(VECTOR3 R, VECTOR3 V, VECTOR3 sun, OBJHANDLE planet, bool ris
 		fact = 1.0;
 	}
 
-	R_E = oapiGetSize(planet);
-	mu = GGRAV*oapiGetMass(planet);
+	R_E = OrbMech::GetSize(planet);
+	mu = GGRAV*OrbMech::GetMass(planet);
 
 	coe = coe_from_sv(R, V, mu);
 
@@ -2387,7 +2389,7 @@ bool vesselinLOS(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE planet)
 	bool los;
 
 	Rot = GetRotationMatrix(planet, MJD);
-	R_E = oapiGetSize(planet);
+	R_E = OrbMech::GetSize(planet);
 
 	for (int i = 0; i < NUMBEROFGROUNDSTATIONS; i++)
 	{
@@ -2419,14 +2421,14 @@ double sunrise(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE planet, OBJHANDLE pla
 
 
 
-	mu = GGRAV*oapiGetMass(planet);
+	mu = GGRAV*OrbMech::GetMass(planet);
 
-	hEarth = oapiGetObjectByName("Earth");
-	hMoon = oapiGetObjectByName("Moon");
-	hSun = oapiGetObjectByName("Sun");
+	hEarth = OrbMech::GetObjectByName("Earth");
+	hMoon = OrbMech::GetObjectByName("Moon");
+	hSun = OrbMech::GetObjectByName("Sun");
 
-	CELBODY *cPlan = oapiGetCelbodyInterface(planet);
-	//CELBODY *cSun = oapiGetCelbodyInterface(hSun);
+	CELBODY *cPlan = OrbMech::GetCelbodyInterface(planet);
+	//CELBODY *cSun = OrbMech::GetCelbodyInterface(hSun);
 
 	OELEMENTS coe;
 	double h, e, theta0, a, T, n, E_0, t_0, E_1, dt, t_f, dt_alt;
@@ -2438,8 +2440,8 @@ double sunrise(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE planet, OBJHANDLE pla
 	{
 		if (planet == hMoon && planet2 == hSun)
 		{
-			CELBODY *cEarth = oapiGetCelbodyInterface(hEarth);
-			options = cPlan->clbkEphemeris(MJD + dt / 24.0 / 3600.0, EPHEM_TRUEPOS, PlanPos);
+			CELBODY *cEarth = OrbMech::GetCelbodyInterface(hEarth);
+			options = OrbMech::Ephemeris(cPlan, MJD + dt / 24.0 / 3600.0, EPHEM_TRUEPOS, PlanPos);
 			if (options & EPHEM_POLAR)
 			{
 				R_EM = Polar2Cartesian(PlanPos[2] * AU, PlanPos[1], PlanPos[0]);
@@ -2449,7 +2451,7 @@ double sunrise(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE planet, OBJHANDLE pla
 				R_EM = _V(PlanPos[0], PlanPos[2], PlanPos[1]);
 				//R_ES = -mul(Rot, _V(EarthVec.x, EarthVec.z, EarthVec.y));
 			}
-			options = cEarth->clbkEphemeris(MJD + dt / 24.0 / 3600.0, EPHEM_TRUEPOS, PlanPos);
+			options = OrbMech::Ephemeris(cEarth, MJD + dt / 24.0 / 3600.0, EPHEM_TRUEPOS, PlanPos);
 			if (options & EPHEM_POLAR)
 			{
 				R_SE = Polar2Cartesian(PlanPos[2] * AU, PlanPos[1], PlanPos[0]);
@@ -2463,7 +2465,7 @@ double sunrise(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE planet, OBJHANDLE pla
 		}
 		else
 		{
-			options = cPlan->clbkEphemeris(MJD + dt / 24.0 / 3600.0, EPHEM_TRUEPOS, PlanPos);
+			options = OrbMech::Ephemeris(cPlan, MJD + dt / 24.0 / 3600.0, EPHEM_TRUEPOS, PlanPos);
 
 			if (options & EPHEM_POLAR)
 			{
@@ -2831,7 +2833,7 @@ void local_to_equ(VECTOR3 R, double &r, double &phi, double &lambda)
 	//VESSEL* vessel;
 	//VECTOR3 Recl;
 
-	//gravref = oapiGetObjectByName("Earth");
+	//gravref = OrbMech::GetObjectByName("Earth");
 	//vessel = oapiGetFocusInterface();
 	//vessel->GetRelativePos(gravref, Recl);
 
@@ -2879,7 +2881,7 @@ MATRIX3 GetObliquityMatrix(OBJHANDLE plan, double t)
 	MATRIX3 Rot1, Rot2, Rot3, Rot4, Rot5, Rot6, R_ref, R_rel, R_rot, Rot;
 	VECTOR3 s;
 
-	if (plan == oapiGetObjectByName("Earth"))
+	if (plan == OrbMech::GetObjectByName("Earth"))
 	{
 		t0 = 51544.5;								//LAN_MJD, MJD of the LAN in the "beginning"
 		T_p = -9413040.4;							//Precession Period
@@ -2890,7 +2892,7 @@ MATRIX3 GetObliquityMatrix(OBJHANDLE plan, double t)
 		e_ref = 0;									//Precession Obliquity
 		L_ref = 0;									//Precession LAN
 	}
-	else if (plan == oapiGetObjectByName("Moon"))
+	else if (plan == OrbMech::GetObjectByName("Moon"))
 	{
 		t0 = 51544.5;							//LAN_MJD, MJD of the LAN in the "beginning"
 		T_p = -6793.468728092782;				//Precession Period
@@ -3400,7 +3402,7 @@ MATRIX3 LaunchREFSMMAT(double lat, double lng, double mjd, double A_Z)
 	MATRIX3 Rot1;
 	OBJHANDLE hEarth;
 
-	hEarth = oapiGetObjectByName("Earth");
+	hEarth = OrbMech::GetObjectByName("Earth");
 	Rot1 = GetRotationMatrix(hEarth, mjd);
 	R_P = unit(_V(cos(lng)*cos(lat), sin(lng)*cos(lat), sin(lat)));
 	g_p = -unit(R_P);
@@ -3500,7 +3502,7 @@ void xaxislambert(VECTOR3 RA1, VECTOR3 VA1, VECTOR3 RP2off, double dt2, int N, b
 	r1 = length(RPP1);
 	r2 = length(RPP2);
 
-	while (abs(f2)>0.01 && nmax >= n)
+	while (abs(f2)>0.01 && nmax >= n && !JobCancelled())
 	{
 		dVLV1 = mul(Q_Xx, VAP1 - VA1);
 		dVLV2 = mul(Q_Xx, VAP2 - VA1);
@@ -3529,7 +3531,7 @@ void xaxislambert(VECTOR3 RA1, VECTOR3 VA1, VECTOR3 RP2off, double dt2, int N, b
 	dV = length(V_G);
 	U_TD = unit(V_G);
 
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 
 	v_ex = vessel->GetThrusterIsp0(thruster);
 	f_T = vessel->GetThrusterMax0(thruster);
@@ -3606,14 +3608,14 @@ VECTOR3 gravityroutine(VECTOR3 R, OBJHANDLE gravref, double mjd0)
 	VECTOR3 U_R, U_Z, g;
 	double rr, mu;
 
-	hEarth = oapiGetObjectByName("Earth");
+	hEarth = OrbMech::GetObjectByName("Earth");
 	U_R = unit(R);
 	MATRIX3 obli_E = OrbMech::GetObliquityMatrix(hEarth, mjd0);
 	U_Z = mul(obli_E, _V(0, 1, 0));
 	U_Z = _V(U_Z.x, U_Z.z, U_Z.y);
 
 	rr = dotp(R, R);
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 
 	if (gravref == hEarth)
 	{
@@ -3621,8 +3623,8 @@ VECTOR3 gravityroutine(VECTOR3 R, OBJHANDLE gravref, double mjd0)
 		VECTOR3 g_b;
 
 		costheta = dotp(U_R, U_Z);
-		R_E = oapiGetSize(hEarth);
-		J2E = oapiGetPlanetJCoeff(hEarth, 0);
+		R_E = OrbMech::GetSize(hEarth);
+		J2E = OrbMech::GetPlanetJCoeff(hEarth, 0);
 		g_b = -(U_R*(1.0 - 5.0*costheta*costheta) + U_Z*2.0*costheta)*mu / rr*3.0 / 2.0*J2E*power(R_E, 2.0) / rr;
 		g = -U_R*mu / rr + g_b;
 	}
@@ -3643,7 +3645,7 @@ void impulsive(VECTOR3 R, VECTOR3 V, double MJD, OBJHANDLE gravref, double f_T,
 	t_slip = 0;
 	t_slip_old = 1;
 	dt_go = 1;
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 	V_go = DV;
 	R_ref = R;
 	V_ref = V + DV;
@@ -3725,7 +3727,7 @@ double findlatitude(VECTOR3 R, VECTOR3 V, double mjd, OBJHANDLE gravref, double
 	i = 0;
 	dt = 0.0;
 	ddt = 1.0;
-	mu = GGRAV*oapiGetMass(gravref);
+	mu = GGRAV*OrbMech::GetMass(gravref);
 	Tguess = PI2 / sqrt(mu)*OrbMech::power(length(R0), 1.5);
 	Rot = GetObliquityMatrix(gravref, mjd);
 	if (up)
@@ -3923,24 +3925,530 @@ double quadratic(double *T, double *DV)
 	return x;
 }
 
+//Moon ephemeris from Chebyshev fits over half day segments. The celbody ephemeris of the Moon is the
+//most expensive part of a coast integration step, and the RTCC asks for the same few days of it over
+//and over, so each segment is only fitted once per session and saved to disk for the next one.
+
+#define MOONEPH_ORDER 12
+#define MOONEPH_SEGMENT 0.5
+#define MOONEPH_SLOTS 1024
+#define MOONEPH_FILE "ProjectApollo Moon Ephemeris.dat"
+#define MOONEPH_VERSION 1
+
+#define EARTHEPH_SEGMENT 2.0				//The Earth ephemeris of a body snapshot is fitted over two day segments
+
+struct EphemerisSegment
+{
+	int index;								//MJD / segment length at the segment start, -1 if unused
+	double c[6][MOONEPH_ORDER];				//Coefficients for position and velocity
+};
+
+//Fits the ephemeris of a body over a segment, returns the options of the ephemeris. The longitude of a
+//polar ephemeris is unwrapped, so it doesn't jump by 2 pi inside the segment.
+static int FitEphemeris(CELBODY *cBody, int index, double segment, EphemerisSegment &seg)
+{
+	double f[MOONEPH_ORDER][6], Pos[12], x, sum;
+	int i, j, k, options = 0;
+
+	//Sample at the Chebyshev nodes of the segment
+	for (k = 0; k < MOONEPH_ORDER; k++)
+	{
+		x = cos(PI*(k + 0.5) / MOONEPH_ORDER);
+		options = cBody->clbkEphemeris((index + 0.5*(x + 1.0))*segment, EPHEM_TRUEPOS | EPHEM_TRUEVEL, Pos);
+		for (i = 0; i < 6; i++)
+		{
+			f[k][i] = Pos[i];
+		}
+		if ((options & EPHEM_POLAR) && k > 0)
+		{
+			f[k][0] += PI2*floor((f[k - 1][0] - f[k][0]) / PI2 + 0.5);
+		}
+	}
+	for (i = 0; i < 6; i++)
+	{
+		for (j = 0; j < MOONEPH_ORDER; j++)
+		{
+			sum = 0.0;
+			for (k = 0; k < MOONEPH_ORDER; k++)
+			{
+				sum += f[k][i] * cos(PI*j*(k + 0.5) / MOONEPH_ORDER);
+			}
+			seg.c[i][j] = 2.0*sum / MOONEPH_ORDER;
+		}
+		seg.c[i][0] *= 0.5;
+	}
+	seg.index = index;
+	return options;
+}
+
+//Position and velocity at x in [-1, 1] over the segment
+static void EvaluateEphemeris(const EphemerisSegment &seg, double x, double *Pos)
+{
+	double b0, b1, b2;
+
+	//Clenshaw recurrence
+	for (int i = 0; i < 6; i++)
+	{
+		b1 = b2 = 0.0;
+		for (int j = MOONEPH_ORDER - 1; j > 0; j--)
+		{
+			b0 = seg.c[i][j] + 2.0*x*b1 - b2;
+			b2 = b1;
+			b1 = b0;
+		}
+		Pos[i] = seg.c[i][0] + x*b1 - b2;
+	}
+}
+
+class MoonEphemerisCache
+{
+public:
+	MoonEphemerisCache();
+	~MoonEphemerisCache();
+	void Get(double MJD, double *MoonPos);
+	void GetSegment(int index, EphemerisSegment &seg);
+private:
+	void Load();
+	void Save(const EphemerisSegment &seg);
+
+	CRITICAL_SECTION lock;					//Guards slots and loaded
+	CRITICAL_SECTION filelock;				//Guards the file and saved, taken before lock
+	EphemerisSegment *slots;
+	bool loaded;
+	int saved;								//Segments in the file
+};
+
+static MoonEphemerisCache MoonEphemeris;
+
+MoonEphemerisCache::MoonEphemerisCache()
+{
+	InitializeCriticalSection(&lock);
+	InitializeCriticalSection(&filelock);
+	slots = NULL;
+	loaded = false;
+	saved = 0;
+}
+
+MoonEphemerisCache::~MoonEphemerisCache()
+{
+	delete[] slots;
+	DeleteCriticalSection(&filelock);
+	DeleteCriticalSection(&lock);
+}
+
+void MoonEphemerisCache::Get(double MJD, double *MoonPos)
+{
+	EphemerisSegment seg;
+	double s;
+	int index;
+
+	s = MJD / MOONEPH_SEGMENT;
+	index = (int)floor(s);
+	GetSegment(index, seg);
+	EvaluateEphemeris(seg, 2.0*(s - index) - 1.0, MoonPos);
+}
+
+void MoonEphemerisCache::GetSegment(int index, EphemerisSegment &seg)
+{
+	bool fit = false;
+
+	EnterCriticalSection(&lock);
+	if (!loaded)
+	{
+		LeaveCriticalSection(&lock);
+		Load();
+		EnterCriticalSection(&lock);
+	}
+	EphemerisSegment &slot = slots[index & (MOONEPH_SLOTS - 1)];
+	if (slot.index != index)
+	{
+		FitEphemeris(OrbMech::GetCelbodyInterface(OrbMech::GetObjectByName("Moon")), index, MOONEPH_SEGMENT, slot);
+		fit = true;
+	}
+	seg = slot;
+	LeaveCriticalSection(&lock);
+
+	//Written without holding the table, so the other threads don't wait for the disk
+	if (fit)
+	{
+		Save(seg);
+	}
+}
+
+void MoonEphemerisCache::Load()
+{
+	FILE *file;
+	EphemerisSegment seg, *table;
+	int header[3];
+	int i, count = 0;
+	bool valid = false;
+
+	EnterCriticalSection(&filelock);
+	EnterCriticalSection(&lock);
+	if (loaded)
+	{
+		//Another thread got here first
+		LeaveCriticalSection(&lock);
+		LeaveCriticalSection(&filelock);
+		return;
+	}
+	LeaveCriticalSection(&lock);
+
+	table = new EphemerisSegment[MOONEPH_SLOTS];
+	for (i = 0; i < MOONEPH_SLOTS; i++)
+	{
+		table[i].index = -1;
+	}
+
+	file = fopen(MOONEPH_FILE, "rb");
+	if (file != NULL)
+	{
+		if (fread(header, sizeof(header), 1, file) == 1 && header[0] == MOONEPH_VERSION && header[1] == MOONEPH_ORDER && header[2] == (int)(MOONEPH_SEGMENT * 1440.0))
+		{
+			valid = true;
+			while (fread(&seg, sizeof(seg), 1, file) == 1)
+			{
+				table[seg.index & (MOONEPH_SLOTS - 1)] = seg;
+				count++;
+			}
+		}
+		fclose(file);
+
+		//Spot check the saved fits against the current Moon ephemeris, in case its configuration has changed
+		for (i = 0; i < MOONEPH_SLOTS && valid; i++)
+		{
+			if (table[i].index >= 0)
+			{
+				double MoonPos[12], CachedPos[6];
+				CELBODY *cMoon = OrbMech::GetCelbodyInterface(OrbMech::GetObjectByName("Moon"));
+
+				cMoon->clbkEphemeris((table[i].index + 0.5)*MOONEPH_SEGMENT, EPHEM_TRUEPOS | EPHEM_TRUEVEL, MoonPos);
+				EvaluateEphemeris(table[i], 0.0, CachedPos);
+				valid = length(_V(MoonPos[0] - CachedPos[0], MoonPos[1] - CachedPos[1], MoonPos[2] - CachedPos[2])) < 100.0;
+				break;
+			}
+		}
+		if (!valid)
+		{
+			for (i = 0; i < MOONEPH_SLOTS; i++)
+			{
+				table[i].index = -1;
+			}
+			count = 0;
+			remove(MOONEPH_FILE);
+		}
+	}
+	saved = count;
+
+	EnterCriticalSection(&lock);
+	slots = table;
+	loaded = true;
+	LeaveCriticalSection(&lock);
+	LeaveCriticalSection(&filelock);
+}
+
+void MoonEphemerisCache::Save(const EphemerisSegment &seg)
+{
+	FILE *file;
+	int header[3];
+	int i;
+
+	header[0] = MOONEPH_VERSION;
+	header[1] = MOONEPH_ORDER;
+	header[2] = (int)(MOONEPH_SEGMENT * 1440.0);
+
+	EnterCriticalSection(&filelock);
+	if (saved < MOONEPH_SLOTS)
+	{
+		file = fopen(MOONEPH_FILE, "ab");
+		if (file != NULL)
+		{
+			if (ftell(file) == 0)
+			{
+				fwrite(header, sizeof(header), 1, file);
+			}
+			fwrite(&seg, sizeof(seg), 1, file);
+			fclose(file);
+			saved++;
+		}
+	}
+	else
+	{
+		//The file holds as many segments as the table by now, the rest are refits of segments that
+		//dropped out of it. So write it again with just what's in the table, which keeps it at that size.
+		EphemerisSegment *table = new EphemerisSegment[MOONEPH_SLOTS];
+
+		EnterCriticalSection(&lock);
+		memcpy(table, slots, MOONEPH_SLOTS * sizeof(EphemerisSegment));
+		LeaveCriticalSection(&lock);
+
+		file = fopen(MOONEPH_FILE, "wb");
+		if (file != NULL)
+		{
+			fwrite(header, sizeof(header), 1, file);
+			saved = 0;
+			for (i = 0; i < MOONEPH_SLOTS; i++)
+			{
+				if (table[i].index >= 0)
+				{
+					fwrite(&table[i], sizeof(EphemerisSegment), 1, file);
+					saved++;
+				}
+			}
+			fclose(file);
+		}
+		delete[] table;
+	}
+	LeaveCriticalSection(&filelock);
+}
+
+//Body snapshots. The RTCC runs its calculations on a worker thread, and entry and TEI scans on several at
+//once, while the simulation thread keeps going, and the Orbiter API isn't known to be thread safe. So a
+//calculation gets everything it needs about the bodies from a snapshot taken when it was queued.
+
+struct BodySnapshotBody
+{
+	const char *name;
+	OBJHANDLE handle;
+	CELBODY *cbody;
+	bool planet;							//Has a rotation period and J coefficients
+	double mass, size, period;
+	std::vector<double> jcoeff;
+};
+
+struct BodySnapshotTable
+{
+	CELBODY *cbody;
+	int options;							//Returned by the ephemeris of the body
+	int first;								//Index of the first segment
+	double segment;							//Segment length in days
+	std::vector<EphemerisSegment> segments;
+};
+
+struct BodySnapshot
+{
+	BodySnapshotBody bodies[3];				//Sun, Earth, Moon
+	BodySnapshotTable earth, moon;
+};
+
+static thread_local const BodySnapshot *CurrentBodies = NULL;
+
+static bool EvaluateTable(const BodySnapshotTable &table, double MJD, double *Pos)
+{
+	double s = MJD / table.segment;
+	int index = (int)floor(s);
+
+	if (table.cbody == NULL || index < table.first || index >= table.first + (int)table.segments.size())
+	{
+		return false;
+	}
+	EvaluateEphemeris(table.segments[index - table.first], 2.0*(s - index) - 1.0, Pos);
+	return true;
+}
+
+static const BodySnapshotBody *GetSnapshotBody(OBJHANDLE hObj)
+{
+	if (CurrentBodies && hObj)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			if (CurrentBodies->bodies[i].handle == hObj)
+			{
+				return &CurrentBodies->bodies[i];
+			}
+		}
+	}
+	return NULL;
+}
+
+std::shared_ptr<const BodySnapshot> TakeBodySnapshot(double MJD)
+{
+	const char *names[3] = { "Sun", "Earth", "Moon" };
+	std::shared_ptr<BodySnapshot> snapshot = std::make_shared<BodySnapshot>();
+	int first, last, i, j;
+
+	for (i = 0; i < 3; i++)
+	{
+		BodySnapshotBody &body = snapshot->bodies[i];
+
+		body.name = names[i];
+		body.handle = oapiGetObjectByName((char *)names[i]);
+		body.cbody = body.handle ? oapiGetCelbodyInterface(body.handle) : NULL;
+		body.planet = i > 0 && body.handle != NULL;
+		body.mass = body.handle ? oapiGetMass(body.handle) : 0.0;
+		body.size = body.handle ? oapiGetSize(body.handle) : 0.0;
+		body.period = body.planet ? oapiGetPlanetPeriod(body.handle) : 0.0;
+		if (body.planet)
+		{
+			body.jcoeff.resize(oapiGetPlanetJCoeffCount(body.handle));
+			for (j = 0; j < (int)body.jcoeff.size(); j++)
+			{
+				body.jcoeff[j] = oapiGetPlanetJCoeff(body.handle, j);
+			}
+		}
+	}
+
+	//The Moon comes from the cache, so it's the same ephemeris as without a snapshot
+	BodySnapshotTable &moon = snapshot->moon;
+	moon.cbody = snapshot->bodies[2].cbody;
+	moon.segment = MOONEPH_SEGMENT;
+	moon.first = (int)floor((MJD - 1.0) / MOONEPH_SEGMENT);
+	moon.options = 0;
+	if (moon.cbody)
+	{
+		double MoonPos[12];
+
+		moon.options = moon.cbody->clbkEphemeris(MJD, EPHEM_TRUEPOS | EPHEM_TRUEVEL, MoonPos);
+		last = (int)floor((MJD + BODYSNAPSHOT_DAYS) / MOONEPH_SEGMENT);
+		moon.segments.resize(last - moon.first + 1);
+		for (j = 0; j < (int)moon.segments.size(); j++)
+		{
+			MoonEphemeris.GetSegment(moon.first + j, moon.segments[j]);
+		}
+	}
+
+	BodySnapshotTable &earth = snapshot->earth;
+	earth.cbody = snapshot->bodies[1].cbody;
+	earth.segment = EARTHEPH_SEGMENT;
+	earth.first = first = (int)floor((MJD - 1.0) / EARTHEPH_SEGMENT);
+	earth.options = 0;
+	if (earth.cbody)
+	{
+		last = (int)floor((MJD + BODYSNAPSHOT_DAYS) / EARTHEPH_SEGMENT);
+		earth.segments.resize(last - first + 1);
+		for (j = 0; j < (int)earth.segments.size(); j++)
+		{
+			earth.options = FitEphemeris(earth.cbody, first + j, EARTHEPH_SEGMENT, earth.segments[j]);
+		}
+	}
+
+	return snapshot;
+}
+
+const BodySnapshot *CurrentBodySnapshot()
+{
+	return CurrentBodies;
+}
+
+BodySnapshotScope::BodySnapshotScope(const BodySnapshot *snapshot)
+{
+	previous = CurrentBodies;
+	CurrentBodies = snapshot;
+}
+
+BodySnapshotScope::~BodySnapshotScope()
+{
+	CurrentBodies = previous;
+}
+
+void GetMoonEphemeris(double MJD, double *MoonPos)
+{
+	if (CurrentBodies && EvaluateTable(CurrentBodies->moon, MJD, MoonPos))
+	{
+		return;
+	}
+	MoonEphemeris.Get(MJD, MoonPos);
+}
+
+OBJHANDLE GetObjectByName(char *name)
+{
+	if (CurrentBodies)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			if (CurrentBodies->bodies[i].handle && !stricmp(CurrentBodies->bodies[i].name, name))
+			{
+				return CurrentBodies->bodies[i].handle;
+			}
+		}
+	}
+	return oapiGetObjectByName(name);
+}
+
+double GetMass(OBJHANDLE hObj)
+{
+	const BodySnapshotBody *body = GetSnapshotBody(hObj);
+	return body ? body->mass : oapiGetMass(hObj);
+}
+
+double GetSize(OBJHANDLE hObj)
+{
+	const BodySnapshotBody *body = GetSnapshotBody(hObj);
+	return body ? body->size : oapiGetSize(hObj);
+}
+
+DWORD GetPlanetJCoeffCount(OBJHANDLE hPlanet)
+{
+	const BodySnapshotBody *body = GetSnapshotBody(hPlanet);
+	return (body && body->planet) ? (DWORD)body->jcoeff.size() : oapiGetPlanetJCoeffCount(hPlanet);
+}
+
+double GetPlanetJCoeff(OBJHANDLE hPlanet, DWORD n)
+{
+	const BodySnapshotBody *body = GetSnapshotBody(hPlanet);
+	return (body && body->planet && n < body->jcoeff.size()) ? body->jcoeff[n] : oapiGetPlanetJCoeff(hPlanet, n);
+}
+
+double GetPlanetPeriod(OBJHANDLE hPlanet)
+{
+	const BodySnapshotBody *body = GetSnapshotBody(hPlanet);
+	return (body && body->planet) ? body->period : oapiGetPlanetPeriod(hPlanet);
+}
+
+CELBODY *GetCelbodyInterface(OBJHANDLE hBody)
+{
+	const BodySnapshotBody *body = GetSnapshotBody(hBody);
+	return body ? body->cbody : oapiGetCelbodyInterface(hBody);
+}
+
+int Ephemeris(CELBODY *cBody, double mjd, int req, double *ret)
+{
+	double Pos[6];
+	int i;
+
+	if (CurrentBodies && (req & ~(EPHEM_TRUEPOS | EPHEM_TRUEVEL)) == 0)
+	{
+		const BodySnapshotTable *table = NULL;
+
+		if (cBody == CurrentBodies->earth.cbody)
+		{
+			table = &CurrentBodies->earth;
+		}
+		else if (cBody == CurrentBodies->moon.cbody)
+		{
+			table = &CurrentBodies->moon;
+		}
+		if (table && EvaluateTable(*table, mjd, Pos))
+		{
+			for (i = 0; i < 3; i++)
+			{
+				if (req & EPHEM_TRUEPOS) ret[i] = Pos[i];
+				if (req & EPHEM_TRUEVEL) ret[i + 3] = Pos[i + 3];
+			}
+			return table->options & (req | EPHEM_POLAR);
+		}
+	}
+	return cBody->clbkEphemeris(mjd, req, ret);
+}
+
 }
 
 CoastIntegrator::CoastIntegrator(VECTOR3 R00, VECTOR3 V00, double mjd0, double deltat, OBJHANDLE planet, OBJHANDLE outplanet)
 {
-	hMoon = oapiGetObjectByName("Moon");
-	hEarth = oapiGetObjectByName("Earth");
+	hMoon = OrbMech::GetObjectByName("Moon");
+	hEarth = OrbMech::GetObjectByName("Earth");
 	this->planet = planet;
 	this->outplanet = outplanet;
 
 	K = 0.3;
 	dt_lim = 4000;
-	R_E = oapiGetSize(planet);
-	mu = oapiGetMass(planet)*GGRAV;
-	jcount = oapiGetPlanetJCoeffCount(planet);
+	R_E = OrbMech::GetSize(planet);
+	mu = OrbMech::GetMass(planet)*GGRAV;
+	jcount = OrbMech::GetPlanetJCoeffCount(planet);
 	JCoeff = new double[jcount];
 	for (int i = 0; i < jcount; i++)
 	{
-		JCoeff[i] = oapiGetPlanetJCoeff(planet, i);
+		JCoeff[i] = OrbMech::GetPlanetJCoeff(planet, i);
 	}
 
 	this->R00 = R00;
@@ -3961,7 +4469,7 @@ CoastIntegrator::CoastIntegrator(VECTOR3 R00, VECTOR3 V00, double mjd0, double d
 	{
 		r_MP = 7178165.0;
 		r_dP = 80467200.0;
-		mu_Q = GGRAV*oapiGetMass(hMoon);
+		mu_Q = GGRAV*OrbMech::GetMass(hMoon);
 		rect1 = 0.75*OrbMech::power(2.0, 22.0);
 		rect2 = 0.75*OrbMech::power(2.0, 3.0);
 		P = 0;
@@ -3970,13 +4478,13 @@ CoastIntegrator::CoastIntegrator(VECTOR3 R00, VECTOR3 V00, double mjd0, double d
 	{
 		r_MP = 2538090.0;
 		r_dP = 16093440.0;
-		mu_Q = GGRAV*oapiGetMass(hEarth);
+		mu_Q = GGRAV*OrbMech::GetMass(hEarth);
 		rect1 = 0.75*OrbMech::power(2.0, 18.0);
 		rect2 = 0.75*OrbMech::power(2.0, -1.0);
 		P = 1;
 	}
-	hSun = oapiGetObjectByName("Sun");
-	mu_S = GGRAV*oapiGetMass(hSun);
+	hSun = OrbMech::GetObjectByName("Sun");
+	mu_S = GGRAV*OrbMech::GetMass(hSun);
 
 	MATRIX3 obli_E = OrbMech::GetObliquityMatrix(hEarth, mjd0);
 	U_Z_E = mul(obli_E, _V(0, 1, 0));
@@ -3986,20 +4494,19 @@ CoastIntegrator::CoastIntegrator(VECTOR3 R00, VECTOR3 V00, double mjd0, double d
 	U_Z_M = mul(obli_M, _V(0, 1, 0));
 	U_Z_M = _V(U_Z_M.x, U_Z_M.z, U_Z_M.y);
 
-	cMoon = oapiGetCelbodyInterface(hMoon);
-	cEarth = oapiGetCelbodyInterface(hEarth);
-	cSun = oapiGetCelbodyInterface(hSun);
+	cMoon = OrbMech::GetCelbodyInterface(hMoon);
+	cEarth = OrbMech::GetCelbodyInterface(hEarth);
+	cSun = OrbMech::GetCelbodyInterface(hSun);
 
 	R_QC = R0;
 	r_SPH = 64373760.0;
 
 	B = 1;
 
-	double *EarthPos;
-	EarthPos = new double[12];
+	double EarthPos[12];
 	VECTOR3 EarthVec, EarthVecVel;
 
-	cEarth->clbkEphemeris(mjd0 + t_F/2.0/24.0/3600.0, EPHEM_TRUEPOS | EPHEM_TRUEVEL, EarthPos);
+	OrbMech::Ephemeris(cEarth, mjd0 + t_F/2.0/24.0/3600.0, EPHEM_TRUEPOS | EPHEM_TRUEVEL, EarthPos);
 
 	EarthVec = OrbMech::Polar2Cartesian(EarthPos[2] * AU, EarthPos[1], EarthPos[0]);
 	EarthVecVel = OrbMech::Polar2CartesianVel(EarthPos[2] * AU, EarthPos[1], EarthPos[0], EarthPos[5] * AU, EarthPos[4], EarthPos[3]);
@@ -4008,6 +4515,11 @@ CoastIntegrator::CoastIntegrator(VECTOR3 R00, VECTOR3 V00, double mjd0, double d
 	W_ES = length(crossp(R_ES0, V_ES0) / OrbMech::power(length(R_ES0), 2.0));
 }
 
+CoastIntegrator::~CoastIntegrator()
+{
+	delete[] JCoeff;
+}
+
 bool CoastIntegrator::iteration()
 {
 	double rr, dt_max, dt, h, x_apo, gamma, s, alpha_N, x_t, Y, r_qc;
@@ -4035,13 +4547,11 @@ bool CoastIntegrator::iteration()
 		{
 			if (rr > r_SPH)
 			{
-				double MJD, *MoonPos;
+				double MJD, MoonPos[6];
 				VECTOR3 R_EM, V_PQ;
 
-				MoonPos = new double[12];
-
 				MJD = mjd0 + t / 86400.0;
-				cMoon->clbkEphemeris(MJD, EPHEM_TRUEPOS | EPHEM_TRUEVEL, MoonPos);
+				OrbMech::GetMoonEphemeris(MJD, MoonPos);
 
 				if (B == 1)
 				{
@@ -4053,18 +4563,19 @@ bool CoastIntegrator::iteration()
 				V_CON = V_CON - V_PQ;
 				planet = hEarth;
 
-				R_E = oapiGetSize(planet);
-				mu = oapiGetMass(planet)*GGRAV;
-				jcount = oapiGetPlanetJCoeffCount(planet);
+				R_E = OrbMech::GetSize(planet);
+				mu = OrbMech::GetMass(planet)*GGRAV;
+				jcount = OrbMech::GetPlanetJCoeffCount(planet);
+				delete[] JCoeff;
 				JCoeff = new double[jcount];
 				for (int i = 0; i < jcount; i++)
 				{
-					JCoeff[i] = oapiGetPlanetJCoeff(planet, i);
+					JCoeff[i] = OrbMech::GetPlanetJCoeff(planet, i);
 				}
 
 				r_MP = 7178165.0;
 				r_dP = 80467200.0;
-				mu_Q = GGRAV*oapiGetMass(hMoon);
+				mu_Q = GGRAV*OrbMech::GetMass(hMoon);
 				rect1 = 0.75*OrbMech::power(2.0, 22.0);
 				rect2 = 0.75*OrbMech::power(2.0, 3.0);
 				P = 0;
@@ -4080,13 +4591,11 @@ bool CoastIntegrator::iteration()
 		}
 		else
 		{
-			double MJD, *MoonPos;
+			double MJD, MoonPos[6];
 			VECTOR3 R_EM, V_PQ;
 
-			MoonPos = new double[12];
-
 			MJD = mjd0 + t / 86400.0;
-			cMoon->clbkEphemeris(MJD, EPHEM_TRUEPOS | EPHEM_TRUEVEL, MoonPos);
+			OrbMech::GetMoonEphemeris(MJD, MoonPos);
 
 			if (B == 1)
 			{
@@ -4101,18 +4610,19 @@ bool CoastIntegrator::iteration()
 				V_CON = V_CON - V_PQ;
 				planet = hMoon;
 
-				R_E = oapiGetSize(planet);
-				mu = oapiGetMass(planet)*GGRAV;
-				jcount = oapiGetPlanetJCoeffCount(planet);
+				R_E = OrbMech::GetSize(planet);
+				mu = OrbMech::GetMass(planet)*GGRAV;
+				jcount = OrbMech::GetPlanetJCoeffCount(planet);
+				delete[] JCoeff;
 				JCoeff = new double[jcount];
 				for (int i = 0; i < jcount; i++)
 				{
-					JCoeff[i] = oapiGetPlanetJCoeff(planet, i);
+					JCoeff[i] = OrbMech::GetPlanetJCoeff(planet, i);
 				}
 
 				r_MP = 2538090.0;
 				r_dP = 16093440.0;
-				mu_Q = GGRAV*oapiGetMass(hEarth);
+				mu_Q = GGRAV*OrbMech::GetMass(hEarth);
 				rect1 = 0.75*OrbMech::power(2.0, 18.0);
 				rect2 = 0.75*OrbMech::power(2.0, -1.0);
 				P = 1;
@@ -4181,13 +4691,11 @@ bool CoastIntegrator::iteration()
 		}
 		else if (planet != outplanet)
 		{
-			double MJD, *MoonPos;
+			double MJD, MoonPos[6];
 			VECTOR3 R_EM, V_PQ, V_EM;
 
-			MoonPos = new double[12];
-
 			MJD = mjd0 + t / 86400.0;
-			cMoon->clbkEphemeris(MJD, EPHEM_TRUEPOS | EPHEM_TRUEVEL, MoonPos);
+			OrbMech::GetMoonEphemeris(MJD, MoonPos);
 
 			R_EM = _V(MoonPos[0], MoonPos[2], MoonPos[1]);
 			V_EM = _V(MoonPos[3], MoonPos[5], MoonPos[4]);
@@ -4270,12 +4778,11 @@ VECTOR3 CoastIntegrator::adfunc(VECTOR3 R)
 	{
 		double q_Q, q_S, MJD;
 		VECTOR3 R_SC, R_PS, R_EM, R_ES, V_ES;
-		double *MoonPos;
-		MoonPos = new double[12];
+		double MoonPos[6];
 
 		MJD = mjd0 + t / 86400.0;
 
-		cMoon->clbkEphemeris(MJD, EPHEM_TRUEPOS, MoonPos);
+		OrbMech::GetMoonEphemeris(MJD, MoonPos);
 		SolarEphemeris(t - t_F/2.0, R_ES, V_ES);
 		R_EM = _V(MoonPos[0], MoonPos[2], MoonPos[1]);
 
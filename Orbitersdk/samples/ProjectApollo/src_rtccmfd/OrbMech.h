@@ -2,6 +2,9 @@
 #define _ORBMECH_H
 
 #include "Orbitersdk.h"
+#include <memory>
+
+#define BODYSNAPSHOT_DAYS 16.0	//Days after the snapshot MJD the ephemerides cover
 
 const VECTOR3 navstars[37] = { _V(0.87325707, 0.222717753, 0.433380771),
 _V(0.933983515, 0.0421048982, -0.354826677),
@@ -102,6 +105,7 @@ class CoastIntegrator
 {
 public:
 	CoastIntegrator(VECTOR3 R0, VECTOR3 V0, double mjd0, double dt, OBJHANDLE planet, OBJHANDLE outplanet);
+	~CoastIntegrator();
 	bool iteration();
 
 	VECTOR3 R2, V2;
@@ -160,6 +164,32 @@ namespace OrbMech {
 	double time_radius(VECTOR3 R, VECTOR3 V, double r, double s, double mu);
 	double time_radius_integ(VECTOR3 R, VECTOR3 V, double mjd0, double r, double s, OBJHANDLE gravref, OBJHANDLE gravout, VECTOR3 &RPRE, VECTOR3 &VPRE);
 	MATRIX3 GetRotationMatrix(OBJHANDLE plan, double t);
+	//Moon position and velocity relative to the Earth, laid out like clbkEphemeris with EPHEM_TRUEPOS | EPHEM_TRUEVEL
+	void GetMoonEphemeris(double MJD, double *MoonPos);
+	//Everything the calculations need from Orbiter about the Sun, the Earth and the Moon: handles, constants,
+	//and the Earth and Moon ephemerides from a day before MJD to BODYSNAPSHOT_DAYS after it. Only take it on
+	//the simulation thread. Install it with BodySnapshotScope on the threads running a calculation, then the
+	//calls below use it instead of the Orbiter API.
+	struct BodySnapshot;
+	std::shared_ptr<const BodySnapshot> TakeBodySnapshot(double MJD);
+	const BodySnapshot *CurrentBodySnapshot();
+	class BodySnapshotScope
+	{
+	public:
+		BodySnapshotScope(const BodySnapshot *snapshot);
+		~BodySnapshotScope();
+	private:
+		const BodySnapshot *previous;
+	};
+	//Orbiter API calls, answered from the body snapshot of this thread if it has one
+	OBJHANDLE GetObjectByName(char *name);
+	double GetMass(OBJHANDLE hObj);
+	double GetSize(OBJHANDLE hObj);
+	DWORD GetPlanetJCoeffCount(OBJHANDLE hPlanet);
+	double GetPlanetJCoeff(OBJHANDLE hPlanet, DWORD n);
+	double GetPlanetPeriod(OBJHANDLE hPlanet);
+	CELBODY *GetCelbodyInterface(OBJHANDLE hBody);
+	int Ephemeris(CELBODY *cBody, double mjd, int req, double *ret);
 	//MATRIX3 GetRotationMatrix2(OBJHANDLE plan, double t);
 	MATRIX3 Orbiter2PACSS13(double mjd, double lat, double lng, double azi);
 	void PACSS4_from_coe(OELEMENTS coe, double mu, VECTOR3 &R, VECTOR3 &V);
@@ -46,6 +46,7 @@
 #include "s1b.h"
 #include "../src_rtccmfd/OrbMech.h"
 #include "LVDC.h"
+#include "PanelSDK/Checkpoint.h"
 
 //#define _CRT_SECURE_CPP_OVERLOAD_STANDARD_NAMES 1
 
@@ -333,12 +334,10 @@ LVDC1B::LVDC1B(){
 void LVDC1B::init(Saturn* own){
 	if(Initialized == true){ 
 		if(owner == own){
-			fprintf(lvlog,"init called after init, ignored\r\n");
-			fflush(lvlog);
+			lvlog.Printf("init called after init, ignored\r\n");
 			return;
 		}else{
-			fprintf(lvlog,"init called after init with new owner, proceeding\r\n");
-			fflush(lvlog);
+			lvlog.Printf("init called after init with new owner, proceeding\r\n");
 		}
 	}
 	owner = own;
@@ -555,9 +554,8 @@ void LVDC1B::init(Saturn* own){
 	LVDC_EI_On = false;
 	S1B_Sep_Time = 0;
 	CountPIPA = false;
-	if(!Initialized){ lvlog = fopen("lvlog1b.txt","w+"); } // Don't reopen the log if it's already open
-	fprintf(lvlog,"init complete\r\n");
-	fflush(lvlog);
+	if(!Initialized){ lvlog.Open(FLIGHTLOG_LVDC, "lvlog1b.txt"); lvlog.SetClock(&LVDC_Timebase, &LVDC_TB_ETime); } // Don't reopen the log if it's already open
+	lvlog.Printf("init complete\r\n");
 	Initialized = true;
 }
 	
@@ -792,7 +790,7 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 				// Done by low-level sensor.
 				if (owner->stage == LAUNCH_STAGE_ONE && owner->GetFuelMass() <= 0){
 					// For S1C thruster calibration
-					fprintf(lvlog,"[T+%f] S1C OECO - Thrust %f N @ Alt %f\r\n\r\n",
+					lvlog.Printf("[T+%f] S1C OECO - Thrust %f N @ Alt %f\r\n\r\n",
 						owner->MissionTime,owner->GetThrusterMax(owner->th_main[0]),owner->GetAltitude());
 
 					// Move hidden S1B
@@ -832,7 +830,7 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 				}
 				if(LVDC_TB_ETime > 311.5 && MRS == false){
 					// MR Shift
-					fprintf(lvlog,"[TB%d+%f] MR Shift\r\n",LVDC_Timebase,LVDC_TB_ETime);
+					lvlog.Printf("[TB%d+%f] MR Shift\r\n",LVDC_Timebase,LVDC_TB_ETime);
 					// sprintf(oapiDebugString(),"LVDC: EMR SHIFT"); LVDC_GP_PC = 30; break;
 					owner->SwitchSelector(23);
 					MRS = true;
@@ -855,11 +853,11 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 							owner->SetThrusterLevel(owner->th_main[0], 0);
 						}
 					}
-					fprintf(lvlog,"S4B CUTOFF: Time %f Thrust %f\r\n",LVDC_TB_ETime,owner->GetThrusterLevel(owner->th_main[0]));
+					lvlog.Printf("S4B CUTOFF: Time %f Thrust %f\r\n",LVDC_TB_ETime,owner->GetThrusterLevel(owner->th_main[0]));
 				}
 				if (LVDC_TB_ETime >= 10 && LVDC_EI_On == true){
 					owner->SetStage(STAGE_ORBIT_SIVB);
-					fprintf(lvlog,"[TB%d+%f] Set STAGE_ORBIT_SIVB\r\n",LVDC_Timebase,LVDC_TB_ETime);
+					lvlog.Printf("[TB%d+%f] Set STAGE_ORBIT_SIVB\r\n",LVDC_Timebase,LVDC_TB_ETime);
 					LVDC_EI_On = false;
 				}
 				if(LVDC_TB_ETime > 100){
@@ -947,16 +945,16 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 		lvrg.Timestep(simdt);								// and RG
 		CurrentAttitude = lvimu.GetTotalAttitude();			// Get current attitude
 		/*
-		if (lvimu.Operate) { fprintf(lvlog, "IMU: Operate\r\n"); }else{ fprintf(lvlog, "ERROR: IMU: NO-Operate\r\n"); }
-		if (lvimu.TurnedOn) { fprintf(lvlog, "IMU: Turned On\r\n"); }else{ fprintf(lvlog, "ERROR: IMU: Turned OFF\r\n"); }
-		if (lvimu.ZeroIMUCDUFlag) { fprintf(lvlog, "IMU: ERROR: Zero-IMU-CDU-Flag\r\n"); }
-		if (lvimu.CoarseAlignEnableFlag) { fprintf(lvlog, "IMU: ERROR: Coarse-Align-Enable-Flag\r\n"); }
-		if (lvimu.Caged) { fprintf(lvlog, "IMU: ERROR: Caged\r\n"); }
+		if (lvimu.Operate) { lvlog.Printf("IMU: Operate\r\n"); }else{ lvlog.Printf("ERROR: IMU: NO-Operate\r\n"); }
+		if (lvimu.TurnedOn) { lvlog.Printf("IMU: Turned On\r\n"); }else{ lvlog.Printf("ERROR: IMU: Turned OFF\r\n"); }
+		if (lvimu.ZeroIMUCDUFlag) { lvlog.Printf("IMU: ERROR: Zero-IMU-CDU-Flag\r\n"); }
+		if (lvimu.CoarseAlignEnableFlag) { lvlog.Printf("IMU: ERROR: Coarse-Align-Enable-Flag\r\n"); }
+		if (lvimu.Caged) { lvlog.Printf("IMU: ERROR: Caged\r\n"); }
 		*/
 		AttRate = lvrg.GetRates();							// Get rates	
 		//This is the actual LVDC code & logic; has to be independent from any of the above events
 		if(LVDC_GRR && GRR_init == false){			
-			fprintf(lvlog,"[T%f] GRR received!\r\n",owner->MissionTime);
+			lvlog.Printf("[T%f] GRR received!\r\n",owner->MissionTime);
 
 			// Initial Position & Velocity
 			MATRIX3 rot;
@@ -966,46 +964,46 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 			oapiGetPlanetObliquityMatrix(oapiGetGbodyByName("Earth"),&rot);
 			PosS = tmul(rot,PosS);
 			Dot0 = tmul(rot,Dot0);
-			fprintf(lvlog,"EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
-			fprintf(lvlog,"EarthRel Velocity: %f %f %f \r\n",Dot0.x,Dot0.y,Dot0.z);
+			lvlog.Printf("EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
+			lvlog.Printf("EarthRel Velocity: %f %f %f \r\n",Dot0.x,Dot0.y,Dot0.z);
 			double rad      = sqrt  (PosS.x*PosS.x + PosS.y*PosS.y + PosS.z*PosS.z);
 			phi_lng    = atan2 (PosS.z, PosS.x);
 			phi_lat    = asin  (PosS.y/rad);
 			cos_phi_L = cos(phi_lat);
 			sin_phi_L = sin(phi_lat);
-			fprintf(lvlog, "Latitude = %f, Longitude = %f\r\n", phi_lat*DEG, phi_lng*DEG);
-			fprintf(lvlog, "cos_phi_l = %f, sin_phi_l = %f\r\n", cos_phi_L, sin_phi_L);
+			lvlog.Printf("Latitude = %f, Longitude = %f\r\n", phi_lat*DEG, phi_lng*DEG);
+			lvlog.Printf("cos_phi_l = %f, sin_phi_l = %f\r\n", cos_phi_L, sin_phi_L);
 			rot.m11 = cos(phi_lng); rot.m12 = 0; rot.m13 = sin(phi_lng);
 			rot.m21 = 0; rot.m22 = 1; rot.m23 = 0;
 			rot.m31 = -sin(phi_lng); rot.m32 = 0; rot.m33 = cos(phi_lng);
 			PosS = mul(rot,PosS);
 			Dot0 = mul(rot,Dot0);
-			fprintf(lvlog,"Rot:longitude\r\n");
-			fprintf(lvlog,"EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
-			fprintf(lvlog,"EarthRel Velocity: %f %f %f \r\n",Dot0.x,Dot0.y,Dot0.z);
+			lvlog.Printf("Rot:longitude\r\n");
+			lvlog.Printf("EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
+			lvlog.Printf("EarthRel Velocity: %f %f %f \r\n",Dot0.x,Dot0.y,Dot0.z);
 			rot.m11 = cos(-phi_lat); rot.m12 = -sin(-phi_lat); rot.m13 = 0;
 			rot.m21 = sin(-phi_lat); rot.m22 = cos(-phi_lat); rot.m23 = 0;
 			rot.m31 = 0; rot.m32 = 0; rot.m33 = 1;
 			PosS = mul(rot,PosS);
 			Dot0 = mul(rot,Dot0);
-			fprintf(lvlog,"Rot:latitude\r\n");
-			fprintf(lvlog,"EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
-			fprintf(lvlog,"EarthRel Velocity: %f %f %f \r\n",Dot0.x,Dot0.y,Dot0.z);
+			lvlog.Printf("Rot:latitude\r\n");
+			lvlog.Printf("EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
+			lvlog.Printf("EarthRel Velocity: %f %f %f \r\n",Dot0.x,Dot0.y,Dot0.z);
 			
 			// Time into launch window = launch time from midnight - reference time of launch from midnight
 			// azimuth = coeff. of azimuth polynomial * time into launch window
 
 			// preset to fixed value to be independent from any external stuff
 			Azimuth = 72.0;
-			fprintf(lvlog,"Azimuth = %f\r\n",Azimuth);
+			lvlog.Printf("Azimuth = %f\r\n",Azimuth);
 			rot.m11 = 1; rot.m12 = 0; rot.m13 = 0;
 			rot.m21 = 0; rot.m22 = cos((90-Azimuth)*RAD); rot.m23 = -sin((90-Azimuth)*RAD);
 			rot.m31 = 0; rot.m32 = sin((90-Azimuth)*RAD); rot.m33 = cos((90-Azimuth)*RAD);
 			PosS = mul(rot,PosS);
 			Dot0 = mul(rot,Dot0);
-			fprintf(lvlog,"Rot:azimuth\r\n");
-			fprintf(lvlog,"EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
-			fprintf(lvlog,"EarthRel Velocity: %f %f %f \r\n",Dot0.x,Dot0.y,Dot0.z);
+			lvlog.Printf("Rot:azimuth\r\n");
+			lvlog.Printf("EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
+			lvlog.Printf("EarthRel Velocity: %f %f %f \r\n",Dot0.x,Dot0.y,Dot0.z);
 			PosS.y = -PosS.y;
 			Dot0.y = -Dot0.y;
 			// Azo and Azs are used to scale the polys below. These numbers are from Apollo 11.
@@ -1027,7 +1025,7 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 			}
 			// Let's cheat a little. (Apollo 7)
 			Inclination = 31.605;
-			fprintf(lvlog,"Inclination = %f\r\n",Inclination);
+			lvlog.Printf("Inclination = %f\r\n",Inclination);
 
 			if(theta_N_op == true){
 				// CALCULATE DESCENDING NODAL ANGLE FROM AZIMUTH
@@ -1044,31 +1042,31 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 			
 			// Cheat a little more. (Apollo 7)
 			DescNodeAngle = 119.0; 
-			fprintf(lvlog,"DescNodeAngle = %f\r\n",DescNodeAngle);
+			lvlog.Printf("DescNodeAngle = %f\r\n",DescNodeAngle);
 
 			// Need to make those into radians
 			Azimuth *= RAD;
 			Inclination *= RAD;
 			DescNodeAngle *= RAD;
 
-			fprintf(lvlog,"Rad Convert: Az / Inc / DNA = %f %f %f\r\n",Azimuth,Inclination,DescNodeAngle);
+			lvlog.Printf("Rad Convert: Az / Inc / DNA = %f %f %f\r\n",Azimuth,Inclination,DescNodeAngle);
 
 			if (TerminalConditions == false)
 			{
 				// p is the semi-latus rectum of the desired terminal ellipse.
 				p = (mu / C_3)*(pow(e, 2) - 1);
-				fprintf(lvlog, "p = %f, mu = %f, e2 = %f, mu/C_3 = %f\r\n", p, mu, pow(e, 2), mu / C_3);
+				lvlog.Printf("p = %f, mu = %f, e2 = %f, mu/C_3 = %f\r\n", p, mu, pow(e, 2), mu / C_3);
 
 				// K_5 is the IGM terminal velocity constant
 				K_5 = sqrt(mu / p);
-				fprintf(lvlog, "K_5 = %f\r\n", K_5);
+				lvlog.Printf("K_5 = %f\r\n", K_5);
 
 				R_T = p / (1 + (e*(cos(f))));
 				V_T = K_5*sqrt((1 + ((2 * e)*(cos(f))) + pow(e, 2)));
 				gamma_T = atan((e*(sin(f))) / (1 + (e*(cos(f)))));
 				G_T = -mu / pow(R_T, 2);
 			}
-			fprintf(lvlog,"R_T = %f (Expecting 6,563,366), V_T = %f (Expecting 7793.0429), gamma_T = %f\r\n",R_T,V_T,gamma_T);
+			lvlog.Printf("R_T = %f (Expecting 6,563,366), V_T = %f (Expecting 7793.0429), gamma_T = %f\r\n",R_T,V_T,gamma_T);
 
 			// G MATRIX CALCULATION
 			MX_A.m11 = cos_phi_L;  MX_A.m12 = sin_phi_L*sin(Azimuth); MX_A.m13 = -(sin_phi_L*cos(Azimuth));
@@ -1095,7 +1093,7 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 			lvimu.ZeroPIPACounters();
 			sinceLastIGM = 0;
 			GRR_init = true;
-			fprintf(lvlog,"Initialization completed.\r\n\r\n");
+			lvlog.Printf("Initialization completed.\r\n\r\n");
 			goto minorloop;
 		}
 		// various clocks the LVDC needs...
@@ -1107,7 +1105,7 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 		IGMInterval = sinceLastIGM;
 		sinceLastIGM = 0;
 		IGMCycle++;				// For debugging
-		fprintf(lvlog,"[%d+%f] *** Major Loop %d ***\r\n",LVDC_Timebase,LVDC_TB_ETime,IGMCycle);
+		lvlog.Printf("[%d+%f] *** Major Loop %d ***\r\n",LVDC_Timebase,LVDC_TB_ETime,IGMCycle);
 		//powered flight nav
 		if(LVDC_GRR == true){
 			if(poweredflight == true){
@@ -1138,25 +1136,25 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 			DotM_last = DotM_act;
 			DotG_last = DotG_act;
 			ddotG_last = ddotG_act;
-			fprintf(lvlog,"Navigation \r\n");
-			fprintf(lvlog,"Inertial Attitude: %f %f %f \r\n",CurrentAttitude.x*DEG,CurrentAttitude.y*DEG,CurrentAttitude.z*DEG);
-			fprintf(lvlog,"DotM: %f %f %f \r\n", DotM_act.x,DotM_act.y,DotM_act.z);
-			fprintf(lvlog,"Gravity velocity: %f %f %f \r\n", DotG_act.x,DotG_act.y,DotG_act.z);
-			fprintf(lvlog,"EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
-			fprintf(lvlog,"EarthRel Velocity: %f %f %f \r\n",DotS.x,DotS.y,DotS.z);
-			fprintf(lvlog,"Sensed Acceleration: %f \r\n",Fm);	
-			fprintf(lvlog,"Gravity Acceleration: %f \r\n",CG);	
-			fprintf(lvlog,"Total Velocity: %f \r\n",V);
-			fprintf(lvlog,"Dist. from Earth's Center: %f \r\n",R);
-			fprintf(lvlog,"S: %f \r\n",S);
-			fprintf(lvlog,"P: %f \r\n",P);
+			lvlog.Printf("Navigation \r\n");
+			lvlog.Printf("Inertial Attitude: %f %f %f \r\n",CurrentAttitude.x*DEG,CurrentAttitude.y*DEG,CurrentAttitude.z*DEG);
+			lvlog.Printf("DotM: %f %f %f \r\n", DotM_act.x,DotM_act.y,DotM_act.z);
+			lvlog.Printf("Gravity velocity: %f %f %f \r\n", DotG_act.x,DotG_act.y,DotG_act.z);
+			lvlog.Printf("EarthRel Position: %f %f %f \r\n",PosS.x,PosS.y,PosS.z);
+			lvlog.Printf("EarthRel Velocity: %f %f %f \r\n",DotS.x,DotS.y,DotS.z);
+			lvlog.Printf("Sensed Acceleration: %f \r\n",Fm);	
+			lvlog.Printf("Gravity Acceleration: %f \r\n",CG);	
+			lvlog.Printf("Total Velocity: %f \r\n",V);
+			lvlog.Printf("Dist. from Earth's Center: %f \r\n",R);
+			lvlog.Printf("S: %f \r\n",S);
+			lvlog.Printf("P: %f \r\n",P);
 			lvimu.ZeroPIPACounters();
 		}
 		if(liftoff == false){//liftoff not received; initial roll command for FCC
 			CommandedAttitude.x =  (360-100)*RAD + Azimuth;
 			CommandedAttitude.y =  0;
 			CommandedAttitude.z =  0;
-			fprintf(lvlog,"[%d+%f] Initial roll command: %f\r\n",LVDC_Timebase,LVDC_TB_ETime,CommandedAttitude.x*DEG);
+			lvlog.Printf("[%d+%f] Initial roll command: %f\r\n",LVDC_Timebase,LVDC_TB_ETime,CommandedAttitude.x*DEG);
 			goto minorloop;
 		}
 		if(BOOST == false){//i.e. we're either in orbit or boosting out of orbit
@@ -1172,7 +1170,7 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 				//S1B engine out interrupt handling
 				T_EO1 = 1;
 				t_fail = t_clock;
-				fprintf(lvlog,"[%d+%f] S1B engine out interrupt received! t_fail = %f\r\n",LVDC_Timebase,LVDC_TB_ETime,t_fail);
+				lvlog.Printf("[%d+%f] S1B engine out interrupt received! t_fail = %f\r\n",LVDC_Timebase,LVDC_TB_ETime,t_fail);
 			}
 			if(t_clock > t_1){
 				//roll/pitch program
@@ -1185,12 +1183,12 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 					if(t_5 < t_clock){ dT_F = 0; }
 					t_6 = t_clock + dT_F;
 					T_ar = T_ar + (0.25*(T_ar - t_fail));
-					fprintf(lvlog,"[%d+%f] Freeze time recalculated! t_6 = %f T_ar = %f\r\n",LVDC_Timebase,LVDC_TB_ETime,t_6,T_ar);
+					lvlog.Printf("[%d+%f] Freeze time recalculated! t_6 = %f T_ar = %f\r\n",LVDC_Timebase,LVDC_TB_ETime,t_6,T_ar);
 				}
 				if(t_clock >= t_6){
 					if (t_clock > T_ar){
 						//time for pitch freeze?
-						fprintf(lvlog,"[%d+%f] Pitch freeze! \r\n",LVDC_Timebase,LVDC_TB_ETime);
+						lvlog.Printf("[%d+%f] Pitch freeze! \r\n",LVDC_Timebase,LVDC_TB_ETime);
 						CommandedAttitude.y = PCommandedAttitude.y;
 						CommandedAttitude.x = 360 * RAD;
 						CommandedAttitude.z = 0;
@@ -1210,7 +1208,7 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 						CommandedAttitude.y = cmd * RAD;
 						CommandedAttitude.x = 360 * RAD;
 						CommandedAttitude.z = 0;
-						fprintf(lvlog,"[%d+%f] Roll/pitch programm %f \r\n",LVDC_Timebase,LVDC_TB_ETime,cmd);
+						lvlog.Printf("[%d+%f] Roll/pitch programm %f \r\n",LVDC_Timebase,LVDC_TB_ETime,cmd);
 						goto limittest;
 					}
 				}else{
@@ -1229,138 +1227,138 @@ void LVDC1B::TimeStep(double simt, double simdt) {
 		}
 		if(HSL == false){		
 			// If we are not in the high-speed loop
-			fprintf(lvlog,"HSL False\r\n");
+			lvlog.Printf("HSL False\r\n");
 			// IGM STAGE LOGIC
 			if(MRS == true){
-				fprintf(lvlog,"Post-MRS\n");
+				lvlog.Printf("Post-MRS\n");
 				if(t_B1 <= t_B3){
 					tau2 = V_ex2/Fm;
-					fprintf(lvlog,"Normal Tau: tau2 = %f, F/m = %f, m = %f \r\n",tau2,Fm,owner->GetMass());
+					lvlog.Printf("Normal Tau: tau2 = %f, F/m = %f, m = %f \r\n",tau2,Fm,owner->GetMass());
 				}else{
 					// This is the "ARTIFICIAL TAU" code.
 					t_B3 += dt_c; 
 					tau2 = tau2+(T_1*(dotM_1/dotM_2));
-					fprintf(lvlog,"Art. Tau: tau2 = %f, T_1 = %f, dotM_1 = %f dotM_2 = %f \r\n",tau2,T_1,dotM_1,dotM_2);
-					fprintf(lvlog,"Diff: %f \r\n",(tau2-(V_ex2/Fm)));
+					lvlog.Printf("Art. Tau: tau2 = %f, T_1 = %f, dotM_1 = %f dotM_2 = %f \r\n",tau2,T_1,dotM_1,dotM_2);
+					lvlog.Printf("Diff: %f \r\n",(tau2-(V_ex2/Fm)));
 					T_2 = T_2+T_1*(dotM_1/dotM_2);
 					T_1 = 0;
-					fprintf(lvlog,"T_1 = 0\r\nT_2 = %f, dotM_1 = %f, dotM_2 = %f \r\n",T_2,dotM_1,dotM_2);
+					lvlog.Printf("T_1 = 0\r\nT_2 = %f, dotM_1 = %f, dotM_2 = %f \r\n",T_2,dotM_1,dotM_2);
 				}					
 			}else{
-				fprintf(lvlog,"Pre-MRS\n");
+				lvlog.Printf("Pre-MRS\n");
 				if(T_1 < 0){	// If we're out of first-stage IGM time
 					// Artificial Tau
 					tau2 = tau2+(T_1*(dotM_1/dotM_2));
-					fprintf(lvlog,"Art. Tau: tau2 = %f, T_1 = %f, dotM_1 = %f, dotM_2 = %f \r\n",tau2,T_1,dotM_1,dotM_2);
+					lvlog.Printf("Art. Tau: tau2 = %f, T_1 = %f, dotM_1 = %f, dotM_2 = %f \r\n",tau2,T_1,dotM_1,dotM_2);
 					T_2 = T_2+T_1*(dotM_1/dotM_2);
 					T_1 = 0;
-					fprintf(lvlog,"T_2 = %f, T_1 = %f, dotM_1 = %f, dotM_2 = %f \r\n",T_2,T_1,dotM_1,dotM_2);		
+					lvlog.Printf("T_2 = %f, T_1 = %f, dotM_1 = %f, dotM_2 = %f \r\n",T_2,T_1,dotM_1,dotM_2);		
 				}else{															
 					tau1 = V_ex1/Fm; 
-					fprintf(lvlog,"Normal Tau: tau1 = %f, F/m = %f m = %f\r\n",tau1,Fm, owner->GetMass());
+					lvlog.Printf("Normal Tau: tau1 = %f, F/m = %f m = %f\r\n",tau1,Fm, owner->GetMass());
 				}
 			}
-			fprintf(lvlog,"--- STAGE INTEGRAL LOGIC ---\r\n");
+			lvlog.Printf("--- STAGE INTEGRAL LOGIC ---\r\n");
 			// CHI-TILDE LOGIC
 			// STAGE INTEGRAL CALCULATIONS				
 			Pos4 = mul(MX_G,PosS);
-			fprintf(lvlog,"Pos4 = %f, %f, %f\r\n",Pos4.x,Pos4.y,Pos4.z);
-			fprintf(lvlog,"T_1 = %f,T_2 = %f\r\n",T_1,T_2);
+			lvlog.Printf("Pos4 = %f, %f, %f\r\n",Pos4.x,Pos4.y,Pos4.z);
+			lvlog.Printf("T_1 = %f,T_2 = %f\r\n",T_1,T_2);
 			L_1 = V_ex1 * log(tau1 / (tau1-T_1));
 			J_1 = (L_1 * tau1) - (V_ex1 * T_1);
 			S_1 = (L_1 * T_1) - J_1;
 			Q_1 = (S_1 * tau1) - ((V_ex1 * pow(T_1,2)) / 2);
 			P_1 = (J_1 * tau1) - ((V_ex1 * pow(T_1,2)) / 2);
 			U_1 = (Q_1 * tau1) - ((V_ex1 * pow(T_1,3)) / 6);
-			fprintf(lvlog,"L_1 = %f, J_1 = %f, S_1 = %f, Q_1 = %f, P_1 = %f, U_1 = %f\r\n",L_1,J_1,S_1,Q_1,P_1,U_1);
+			lvlog.Printf("L_1 = %f, J_1 = %f, S_1 = %f, Q_1 = %f, P_1 = %f, U_1 = %f\r\n",L_1,J_1,S_1,Q_1,P_1,U_1);
 
 			Lt_2 = V_ex2 * log(tau2 / (tau2-Tt_2));
-			fprintf(lvlog,"Lt_2 = %f, tau2 = %f, Tt_2 = %f\r\n",Lt_2,tau2,Tt_2);
+			lvlog.Printf("Lt_2 = %f, tau2 = %f, Tt_2 = %f\r\n",Lt_2,tau2,Tt_2);
 
 			Jt_2 = (Lt_2 * tau2) - (V_ex2 * Tt_2);
-			fprintf(lvlog,"Jt_2 = %f",Jt_2);
+			lvlog.Printf("Jt_2 = %f",Jt_2);
 			Lt_Y = (L_1 + Lt_2);
-			fprintf(lvlog,", Lt_Y = %f\r\n",Lt_Y);
+			lvlog.Printf(", Lt_Y = %f\r\n",Lt_Y);
 
 			// SELECT RANGE OPTION				
 gtupdate:	// Target of jump from further down
-			fprintf(lvlog,"--- GT UPDATE ---\r\n");
+			lvlog.Printf("--- GT UPDATE ---\r\n");
 
 			// RANGE ANGLE 1
-			fprintf(lvlog,"RANGE ANGLE\r\n");
+			lvlog.Printf("RANGE ANGLE\r\n");
 			d2 = (V * Tt_T) - Jt_2 + (Lt_Y * Tt_2) - (ROV / V_ex2) * 
 				((tau1 - T_1) * L_1 + (tau2 - Tt_2) * Lt_2) *
 				(Lt_Y + V - V_T);
 			phi_T = ((atan2(Pos4.z,Pos4.x))+(((1/R_T)*(S_1+d2))*(cos(gamma_T))));
-			fprintf(lvlog,"V = %f, d2 = %f, phi_T = %f\r\n",V,d2,phi_T);				
+			lvlog.Printf("V = %f, d2 = %f, phi_T = %f\r\n",V,d2,phi_T);				
 
 			// FREEZE TERMINAL CONDITIONS TEST
 			if(!(Tt_T <= eps_3)){
 				// UPDATE TERMINAL CONDITIONS
-				fprintf(lvlog,"UPDATE TERMINAL CONDITIONS\r\n");
+				lvlog.Printf("UPDATE TERMINAL CONDITIONS\r\n");
 				f = phi_T + alpha_D;
 				R_T = p/(1+((e*(cos(f)))));
-				fprintf(lvlog,"f = %f, R_T = %f\r\n",f,R_T);
+				lvlog.Printf("f = %f, R_T = %f\r\n",f,R_T);
 				V_T = K_5 * pow(1+((2*e)*(cos(f)))+pow(e,2),0.5);
 				gamma_T = atan((e*(sin(f)))/(1+(e*(cos(f)))));
 				G_T = -mu/pow(R_T,2);
-				fprintf(lvlog,"V_T = %f, gamma_T = %f, G_T = %f\r\n",V_T,gamma_T,G_T);
+				lvlog.Printf("V_T = %f, gamma_T = %f, G_T = %f\r\n",V_T,gamma_T,G_T);
 			}
 
 			// UNROTATED TERMINAL CONDITIONS
-			fprintf(lvlog,"UNROTATED TERMINAL CONDITIONS\r\n");
+			lvlog.Printf("UNROTATED TERMINAL CONDITIONS\r\n");
 			xi_T = R_T;					
 			dot_zeta_T = V_T * (cos(gamma_T));
 			dot_xi_T = V_T * (sin(gamma_T));
 			ddot_zeta_GT = 0;
 			ddot_xi_GT = G_T;
-			fprintf(lvlog,"xi_T = %f, dot_zeta_T = %f, dot_xi_T = %f\r\n",xi_T,dot_zeta_T,dot_xi_T);
-			fprintf(lvlog,"ddot_zeta_GT = %f, ddot_xi_GT = %f\r\n",ddot_zeta_GT,ddot_xi_GT);
+			lvlog.Printf("xi_T = %f, dot_zeta_T = %f, dot_xi_T = %f\r\n",xi_T,dot_zeta_T,dot_xi_T);
+			lvlog.Printf("ddot_zeta_GT = %f, ddot_xi_GT = %f\r\n",ddot_zeta_GT,ddot_xi_GT);
 				
 			// ROTATION TO TERMINAL COORDINATES
-			fprintf(lvlog,"--- ROTATION TO TERMINAL COORDINATES ---\r\n");
+			lvlog.Printf("--- ROTATION TO TERMINAL COORDINATES ---\r\n");
 			// This is the last time PosS is referred to.
 			MX_phi_T.m11 = (cos(phi_T));    MX_phi_T.m12 = 0; MX_phi_T.m13 = ((sin(phi_T)));
 			MX_phi_T.m21 = 0;               MX_phi_T.m22 = 1; MX_phi_T.m23 = 0;
 			MX_phi_T.m31 = (-sin(phi_T)); MX_phi_T.m32 = 0; MX_phi_T.m33 = (cos(phi_T));
-			fprintf(lvlog,"MX_phi_T R1 = %f %f %f\r\n",MX_phi_T.m11,MX_phi_T.m12,MX_phi_T.m13);
-			fprintf(lvlog,"MX_phi_T R2 = %f %f %f\r\n",MX_phi_T.m21,MX_phi_T.m22,MX_phi_T.m23);
-			fprintf(lvlog,"MX_phi_T R3 = %f %f %f\r\n",MX_phi_T.m31,MX_phi_T.m32,MX_phi_T.m33);
+			lvlog.Printf("MX_phi_T R1 = %f %f %f\r\n",MX_phi_T.m11,MX_phi_T.m12,MX_phi_T.m13);
+			lvlog.Printf("MX_phi_T R2 = %f %f %f\r\n",MX_phi_T.m21,MX_phi_T.m22,MX_phi_T.m23);
+			lvlog.Printf("MX_phi_T R3 = %f %f %f\r\n",MX_phi_T.m31,MX_phi_T.m32,MX_phi_T.m33);
 
 			MX_K = mul(MX_phi_T,MX_G);
-			fprintf(lvlog,"MX_K R1 = %f %f %f\r\n",MX_K.m11,MX_K.m12,MX_K.m13);
-			fprintf(lvlog,"MX_K R2 = %f %f %f\r\n",MX_K.m21,MX_K.m22,MX_K.m23);
-			fprintf(lvlog,"MX_K R3 = %f %f %f\r\n",MX_K.m31,MX_K.m32,MX_K.m33);
+			lvlog.Printf("MX_K R1 = %f %f %f\r\n",MX_K.m11,MX_K.m12,MX_K.m13);
+			lvlog.Printf("MX_K R2 = %f %f %f\r\n",MX_K.m21,MX_K.m22,MX_K.m23);
+			lvlog.Printf("MX_K R3 = %f %f %f\r\n",MX_K.m31,MX_K.m32,MX_K.m33);
 
 			PosXEZ = mul(MX_K,PosS);
 			DotXEZ = mul(MX_K,DotS);	
-			fprintf(lvlog,"PosXEZ = %f %f %f\r\n",PosXEZ.x,PosXEZ.y,PosXEZ.z);
-			fprintf(lvlog,"DotXEZ = %f %f %f\r\n",DotXEZ.x,DotXEZ.y,DotXEZ.z);
+			lvlog.Printf("PosXEZ = %f %f %f\r\n",PosXEZ.x,PosXEZ.y,PosXEZ.z);
+			lvlog.Printf("DotXEZ = %f %f %f\r\n",DotXEZ.x,DotXEZ.y,DotXEZ.z);
 
 			VECTOR3 RTT_T1,RTT_T2;
 			RTT_T1.x = ddot_xi_GT; RTT_T1.y = 0;        RTT_T1.z = ddot_zeta_GT;
 			RTT_T2 = ddotG_act;
-			fprintf(lvlog,"RTT_T1 = %f %f %f\r\n",RTT_T1.x,RTT_T1.y,RTT_T1.z);
-			fprintf(lvlog,"RTT_T2 = %f %f %f\r\n",RTT_T2.x,RTT_T2.y,RTT_T2.z);
+			lvlog.Printf("RTT_T1 = %f %f %f\r\n",RTT_T1.x,RTT_T1.y,RTT_T1.z);
+			lvlog.Printf("RTT_T2 = %f %f %f\r\n",RTT_T2.x,RTT_T2.y,RTT_T2.z);
 
 			RTT_T2 = mul(MX_K,RTT_T2);
-			fprintf(lvlog,"RTT_T2 (mul) = %f %f %f\r\n",RTT_T2.x,RTT_T2.y,RTT_T2.z);
+			lvlog.Printf("RTT_T2 (mul) = %f %f %f\r\n",RTT_T2.x,RTT_T2.y,RTT_T2.z);
 
 			RTT_T1 = RTT_T1+RTT_T2;	  
-			fprintf(lvlog,"RTT_T1 (add) = %f %f %f\r\n",RTT_T1.x,RTT_T1.y,RTT_T1.z);
+			lvlog.Printf("RTT_T1 (add) = %f %f %f\r\n",RTT_T1.x,RTT_T1.y,RTT_T1.z);
 
 			ddot_xi_G   = 0.5*RTT_T1.x;
 			ddot_eta_G  = 0.5*RTT_T1.y;
 			ddot_zeta_G = 0.5*RTT_T1.z;
-			fprintf(lvlog,"ddot_XEZ_G = %f %f %f\r\n",ddot_xi_G,ddot_eta_G,ddot_zeta_G);
+			lvlog.Printf("ddot_XEZ_G = %f %f %f\r\n",ddot_xi_G,ddot_eta_G,ddot_zeta_G);
 
 			// ESTIMATED TIME-TO-GO
-			fprintf(lvlog,"--- ESTIMATED TIME-TO-GO ---\r\n");
+			lvlog.Printf("--- ESTIMATED TIME-TO-GO ---\r\n");
 
 			dot_dxit   = dot_xi_T - DotXEZ.x - (ddot_xi_G*Tt_T);
 			dot_detat  = -DotXEZ.y - (ddot_eta_G * Tt_T);
 			dot_dzetat = dot_zeta_T - DotXEZ.z - (ddot_zeta_G * Tt_T);
-			fprintf(lvlog,"dot_XEZt = %f %f %f\r\n",dot_dxit,dot_detat,dot_dzetat);
+			lvlog.Printf("dot_XEZt = %f %f %f\r\n",dot_dxit,dot_detat,dot_dzetat);
 			dV = pow((pow(dot_dxit,2)+pow(dot_detat,2)+pow(dot_dzetat,2)),0.5);
 			dL_2 = (((pow(dot_dxit,2)+pow(dot_detat,2)+pow(dot_dzetat,2))/Lt_Y)-Lt_Y)/2;
 			// if(dL_3 < 0){ sprintf(oapiDebugString(),"Est TTG: dL_3 %f (X/E/Z %f %f %f) @ Cycle %d (TB%d+%f)",dL_3,dot_dxit,dot_detat,dot_dzetat,IGMCycle,LVDC_Timebase,LVDC_TB_ETime);
@@ -1369,30 +1367,30 @@ gtupdate:	// Target of jump from further down
 			dT_2 = (dL_2*(tau2-Tt_2))/V_ex2;
 			T_2 = Tt_2 + dT_2;
 			T_T = Tt_T + dT_2;
-			fprintf(lvlog,"dV = %f, dL_2 = %f, dT_2 = %f, T_2 = %f, T_T = %f\r\n",dV,dL_2,dT_2,T_2,T_T);
+			lvlog.Printf("dV = %f, dL_2 = %f, dT_2 = %f, T_2 = %f, T_T = %f\r\n",dV,dL_2,dT_2,T_2,T_T);
 
 			// TARGET PARAMETER UPDATE
 			if(!(UP > 0)){	
-				fprintf(lvlog,"--- TARGET PARAMETER UPDATE ---\r\n");
+				lvlog.Printf("--- TARGET PARAMETER UPDATE ---\r\n");
 				UP = 1; 
 				Tt_2 = T_2;
 				Tt_T = T_T;
-				fprintf(lvlog,"UP = 1, Tt_2 = %f, Tt_T = %f\r\n",Tt_2,Tt_T);
+				lvlog.Printf("UP = 1, Tt_2 = %f, Tt_T = %f\r\n",Tt_2,Tt_T);
 				Lt_2 = Lt_2 + dL_2;
 				Lt_Y = Lt_Y + dL_2;
 				Jt_2 = Jt_2 + (dL_2*T_2);
-				fprintf(lvlog,"Lt_2 = %f, Lt_Y = %f, Jt_2 = %f\r\n",Lt_2,Lt_Y,Jt_2);
+				lvlog.Printf("Lt_2 = %f, Lt_Y = %f, Jt_2 = %f\r\n",Lt_2,Lt_Y,Jt_2);
 
 				// NOTE: This is perfectly valid. Just because Dijkstra and Wirth think otherwise
 				// does not mean it's gospel. I shouldn't have to defend my choice of instructions
 				// because a bunch of people read the title of the paper with no context and take
 				// it as a direct revelation from God with no further study into the issue.
-				fprintf(lvlog,"RECYCLE\r\n");
+				lvlog.Printf("RECYCLE\r\n");
 				goto gtupdate; // Recycle. 
 			}
 
 			// tchi_y AND tchi_p CALCULATIONS
-			fprintf(lvlog,"--- tchi_y/p CALCULATION ---\r\n");
+			lvlog.Printf("--- tchi_y/p CALCULATION ---\r\n");
 
 			L_2 = Lt_2 + dL_2;
 			J_2 = Jt_2 + (dL_2*T_2);
@@ -1400,14 +1398,14 @@ gtupdate:	// Target of jump from further down
 			Q_2 = (S_2*tau2)-((V_ex2*pow(T_2,2))/2);
 			P_2 = (J_2*(tau2+(2*T_2)))-((V_ex2*pow(T_2,2))/2);
 			U_2 = (Q_2*(tau2+(2*T_2)))-((V_ex2*pow(T_2,3))/6);
-			fprintf(lvlog,"L_2 = %f, J_2 = %f, S_2 = %f, Q_2 = %f, P_2 = %f, U_2 = %f\r\n",L_2,J_2,S_2,Q_2,P_2,U_2);
+			lvlog.Printf("L_2 = %f, J_2 = %f, S_2 = %f, Q_2 = %f, P_2 = %f, U_2 = %f\r\n",L_2,J_2,S_2,Q_2,P_2,U_2);
 
 			// This is where velocity-to-be-gained is generated.
 
 			dot_dxi   = dot_dxit   - (ddot_xi_G   * dT_2);
 			dot_deta  = dot_detat  - (ddot_eta_G  * dT_2);
 			dot_dzeta = dot_dzetat - (ddot_zeta_G * dT_2);
-			fprintf(lvlog,"dot_dXEZ = %f %f %f\r\n",dot_dxi,dot_deta,dot_dzeta);
+			lvlog.Printf("dot_dXEZ = %f %f %f\r\n",dot_dxi,dot_deta,dot_dzeta);
 
 				
 	//		sprintf(oapiDebugString(),".dxi = %f | .deta %f | .dzeta %f | dT3 %f",
@@ -1419,12 +1417,12 @@ gtupdate:	// Target of jump from further down
 			tchi_y = atan2(dot_deta,pow(pow(dot_dxi,2)+pow(dot_dzeta,2),0.5));
 			tchi_p = atan2(dot_dxi,dot_dzeta);				
 			UP = -1;
-			fprintf(lvlog,"L_Y = %f, tchi_y = %f, tchi_p = %f, UP = -1\r\n",L_Y,tchi_y,tchi_p);
+			lvlog.Printf("L_Y = %f, tchi_y = %f, tchi_p = %f, UP = -1\r\n",L_Y,tchi_y,tchi_p);
 
 			// *** END OF CHI-TILDE LOGIC ***
 			// Is it time for chi-tilde mode?
 			if(Tt_T <= eps_2){
-				fprintf(lvlog,"CHI BAR STEERING ON, REMOVE ALTITUDE CONSTRAINS (K_1-4 = 0)\r\n");
+				lvlog.Printf("CHI BAR STEERING ON, REMOVE ALTITUDE CONSTRAINS (K_1-4 = 0)\r\n");
 				// Yes
 				// Go to the test that we would be testing if HSL was true
 				K_1 = 0; K_2 = 0; K_3 = 0; K_4 = 0;
@@ -1434,75 +1432,75 @@ gtupdate:	// Target of jump from further down
 			}else{
 				// No.
 				// YAW STEERING PARAMETERS
-				fprintf(lvlog,"--- YAW STEERING PARAMETERS ---\r\n");
+				lvlog.Printf("--- YAW STEERING PARAMETERS ---\r\n");
 
 				J_Y = J_1 + J_2 + (L_2*T_2);
 				S_Y = S_1 - J_2 + (L_Y*T_2);
 				Q_Y = Q_1 + Q_2 + (S_2*T_2) + ((T_2)*J_1);
 				K_Y = L_Y/J_Y;
 				D_Y = S_Y - (K_Y*Q_Y);
-				fprintf(lvlog,"J_Y = %f, S_Y = %f, Q_Y = %f, K_Y = %f, D_Y = %f\r\n",J_Y,S_Y,Q_Y,K_Y,D_Y);
+				lvlog.Printf("J_Y = %f, S_Y = %f, Q_Y = %f, K_Y = %f, D_Y = %f\r\n",J_Y,S_Y,Q_Y,K_Y,D_Y);
 
 				deta = PosXEZ.y + (DotXEZ.y*T_T) + ((ddot_eta_G*pow(T_T,2))/2) + (S_Y*(sin(tchi_y)));
 				K_3 = deta/(D_Y*(cos(tchi_y)));
 				K_4 = K_Y*K_3;
-				fprintf(lvlog,"deta = %f, K_3 = %f, K_4 = %f\r\n",deta,K_3,K_4);
+				lvlog.Printf("deta = %f, K_3 = %f, K_4 = %f\r\n",deta,K_3,K_4);
 
 				// PITCH STEERING PARAMETERS
-				fprintf(lvlog,"--- PITCH STEERING PARAMETERS ---\r\n");
+				lvlog.Printf("--- PITCH STEERING PARAMETERS ---\r\n");
 
 				L_P = L_Y*cos(tchi_y);
 				C_2 = cos(tchi_y)+(K_3*sin(tchi_y));
 				C_4 = K_4*sin(tchi_y);
 				J_P = (J_Y*C_2) - (C_4*(P_1+P_2+(pow(T_2,2)*L_2)));
-				fprintf(lvlog,"L_P = %f, C_2 = %f, C_4 = %f, J_P = %f\r\n",L_P,C_2,C_4,J_P);
+				lvlog.Printf("L_P = %f, C_2 = %f, C_4 = %f, J_P = %f\r\n",L_P,C_2,C_4,J_P);
 
 				S_P = (S_Y*C_2) - (C_4*Q_Y);
 				Q_P = (Q_Y*C_2) - (C_4*(U_1+U_2+(pow(T_2,2)*S_2)+((T_2)*P_1)));
 				K_P = L_P/J_P;
 				D_P = S_P - (K_P*Q_P);
-				fprintf(lvlog,"S_P = %f, Q_P = %f, K_P = %f, D_P = %f\r\n",S_P,Q_P,K_P,D_P);
+				lvlog.Printf("S_P = %f, Q_P = %f, K_P = %f, D_P = %f\r\n",S_P,Q_P,K_P,D_P);
 
 				dxi = PosXEZ.x - xi_T + (DotXEZ.x*T_T) + ((ddot_xi_G*pow(T_T,2))/2) + (S_P*(sin(tchi_p)));
 				K_1 = dxi/(D_P*cos(tchi_p));
 				K_2 = K_P*K_1;
-				fprintf(lvlog,"dxi = %f, K_1 = %f, K_2 = %f, cos(tchi_p) = %f\r\n",dxi,K_1,K_2,cos(tchi_p));
+				lvlog.Printf("dxi = %f, K_1 = %f, K_2 = %f, cos(tchi_p) = %f\r\n",dxi,K_1,K_2,cos(tchi_p));
 			}
 		}else{
 hsl:		// HIGH-SPEED LOOP ENTRY				
 			// CUTOFF VELOCITY EQUATIONS
-			fprintf(lvlog,"--- CUTOFF VELOCITY EQUATIONS ---\r\n");
+			lvlog.Printf("--- CUTOFF VELOCITY EQUATIONS ---\r\n");
 			V_0 = V_1;
 			V_1 = V_2;
 			//V_2 = 0.5 * (V+(pow(V_1,2)/V));
 			V_2 = V;
 			dtt_1 = dtt_2;
 			dtt_2 = dt_c;					
-			fprintf(lvlog,"V = %f, Tt_t = %f\r\n",V,Tt_T);
-			fprintf(lvlog,"V = %f, V_0 = %f, V_1 = %f, V_2 = %f, dtt_1 = %f, dtt_2 = %f\r\n",V,V_0,V_1,V_2,dtt_1,dtt_2);
+			lvlog.Printf("V = %f, Tt_t = %f\r\n",V,Tt_T);
+			lvlog.Printf("V = %f, V_0 = %f, V_1 = %f, V_2 = %f, dtt_1 = %f, dtt_2 = %f\r\n",V,V_0,V_1,V_2,dtt_1,dtt_2);
 			if(Tt_T <= eps_4 && V + V_TC >= V_T){
-				fprintf(lvlog,"--- HI SPEED LOOP ---\r\n");
+				lvlog.Printf("--- HI SPEED LOOP ---\r\n");
 				// TGO CALCULATION
-				fprintf(lvlog,"--- TGO CALCULATION ---\r\n");
+				lvlog.Printf("--- TGO CALCULATION ---\r\n");
 				if(GATE5 == false){
-					fprintf(lvlog,"CHI FREEZE\r\n");
+					lvlog.Printf("CHI FREEZE\r\n");
 					// CHI FREEZE
 					tchi_y = tchi_y_last;
 					tchi_p = tchi_p_last;
 					HSL = true;
 					GATE5 = true;
 					T_GO = T_2;
-					fprintf(lvlog,"HSL = true, GATE5 = true, T_GO = %f\r\n",T_GO);
+					lvlog.Printf("HSL = true, GATE5 = true, T_GO = %f\r\n",T_GO);
 				}
 					
 				// TGO DETERMINATION
-				fprintf(lvlog,"--- TGO DETERMINATION ---\r\n");
+				lvlog.Printf("--- TGO DETERMINATION ---\r\n");
 
 				a_2 = (((V_2-V_1)*dtt_1)-((V_1-V_0)*dtt_2))/(dtt_2*dtt_1*(dtt_2+dtt_1));
 				a_1 = ((V_2-V_1)/dtt_2)+(a_2*dtt_2);
 				T_GO = ((V_T-dV_B)-V_2)/(a_1+a_2*T_GO);
 				T_CO = TAS+T_GO;
-				fprintf(lvlog,"a_2 = %f, a_1 = %f, T_GO = %f, T_CO = %f, V_T = %f\r\n",a_2,a_1,T_GO,T_CO,V_T);
+				lvlog.Printf("a_2 = %f, a_1 = %f, T_GO = %f, T_CO = %f, V_T = %f\r\n",a_2,a_1,T_GO,T_CO,V_T);
 
 				// Done, go to navigation
 				//sprintf(oapiDebugString(),"TB%d+%f | CP/Y %f %f | -HSL- TGO %f",
@@ -1513,7 +1511,7 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 			// End of HSL
 		}
 		// GUIDANCE TIME UPDATE
-		fprintf(lvlog,"--- GUIDANCE TIME UPDATE ---\r\n");
+		lvlog.Printf("--- GUIDANCE TIME UPDATE ---\r\n");
 
 		if(BOOST){
 			if(MRS == false){
@@ -1523,23 +1521,23 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 					T_2 = T_2 - dt_c;
 				}else{
 					// Here if t_B1 is bigger.
-					fprintf(lvlog,"t_B1 = %f, t_B3 = %f\r\n",t_B1,t_B3);
+					lvlog.Printf("t_B1 = %f, t_B3 = %f\r\n",t_B1,t_B3);
 					T_1 = (((dotM_1*(t_B3-t_B1))-(dotM_2*t_B3))*dt)/(dotM_1*t_B1);
 				}
 			}
 		}
-		fprintf(lvlog,"T_1 = %f, T_2 = %f, dt_c = %f\r\n",T_1,T_2,dt_c);
+		lvlog.Printf("T_1 = %f, T_2 = %f, dt_c = %f\r\n",T_1,T_2,dt_c);
 		Tt_2 = T_2;
 		Tt_T = T_1+Tt_2;
-		fprintf(lvlog,"Tt_2 = %f, Tt_T = %f\r\n",Tt_2,Tt_T);
+		lvlog.Printf("Tt_2 = %f, Tt_T = %f\r\n",Tt_2,Tt_T);
 	
 		// IGM STEERING ANGLES
-		fprintf(lvlog,"--- IGM STEERING ANGLES ---\r\n");
+		lvlog.Printf("--- IGM STEERING ANGLES ---\r\n");
 
 		//sprintf(oapiDebugString(),"IGM: K_1 %f K_2 %f K_3 %f K_4 %f",K_1,K_2,K_3,K_4);
 		Xtt_y = ((tchi_y) - K_3 + (K_4 * t));
 		Xtt_p = ((tchi_p) - K_1 + (K_2 * t));
-		fprintf(lvlog,"Xtt_y = %f, Xtt_p = %f\r\n",Xtt_y,Xtt_p);
+		lvlog.Printf("Xtt_y = %f, Xtt_p = %f\r\n",Xtt_y,Xtt_p);
 
 		// -- COMPUTE INVERSE OF [K] --
 		// Get Determinate
@@ -1547,7 +1545,7 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 					- MX_K.m12 * ((MX_K.m21*MX_K.m33) - (MX_K.m31*MX_K.m23))
 					+ MX_K.m13 * ((MX_K.m21*MX_K.m32) - (MX_K.m31*MX_K.m22));
 		// If the determinate is less than 0.0005, this is invalid.
-		fprintf(lvlog,"det = %f (LESS THAN 0.0005 IS INVALID)\r\n",det);
+		lvlog.Printf("det = %f (LESS THAN 0.0005 IS INVALID)\r\n",det);
 
 		MATRIX3 MX_Ki; // TEMPORARY: Inverse of [K]
 		MX_Ki.m11 =   ((MX_K.m22*MX_K.m33) - (MX_K.m23*MX_K.m32))  / det;
@@ -1559,30 +1557,30 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 		MX_Ki.m31 =   ((MX_K.m21*MX_K.m32) - (MX_K.m22*MX_K.m31))  / det;
 		MX_Ki.m32 =   ((MX_K.m12*MX_K.m31) - (MX_K.m11*MX_K.m32))  / det;
 		MX_Ki.m33 =   ((MX_K.m11*MX_K.m22) - (MX_K.m12*MX_K.m21))  / det;
-		fprintf(lvlog,"MX_Ki R1 = %f %f %f\r\n",MX_Ki.m11,MX_Ki.m12,MX_Ki.m13);
-		fprintf(lvlog,"MX_Ki R2 = %f %f %f\r\n",MX_Ki.m21,MX_Ki.m22,MX_Ki.m23);
-		fprintf(lvlog,"MX_Ki R3 = %f %f %f\r\n",MX_Ki.m31,MX_Ki.m32,MX_Ki.m33);
+		lvlog.Printf("MX_Ki R1 = %f %f %f\r\n",MX_Ki.m11,MX_Ki.m12,MX_Ki.m13);
+		lvlog.Printf("MX_Ki R2 = %f %f %f\r\n",MX_Ki.m21,MX_Ki.m22,MX_Ki.m23);
+		lvlog.Printf("MX_Ki R3 = %f %f %f\r\n",MX_Ki.m31,MX_Ki.m32,MX_Ki.m33);
 
 		// Done
 		VECTOR3 VT; 
 		VT.x = (sin(Xtt_p)*cos(Xtt_y));
 		VT.y = (sin(Xtt_y));
 		VT.z = (cos(Xtt_p)*cos(Xtt_y));
-		fprintf(lvlog,"VT (set) = %f %f %f\r\n",VT.x,VT.y,VT.z);
+		lvlog.Printf("VT (set) = %f %f %f\r\n",VT.x,VT.y,VT.z);
 
 		VT = mul(MX_Ki,VT);
-		fprintf(lvlog,"VT (mul) = %f %f %f\r\n",VT.x,VT.y,VT.z);
+		lvlog.Printf("VT (mul) = %f %f %f\r\n",VT.x,VT.y,VT.z);
 
 		X_S1 = VT.x;
 		X_S2 = VT.y;
 		X_S3 = VT.z;
-		fprintf(lvlog,"X_S1-3 = %f %f %f\r\n",X_S1,X_S2,X_S3);
+		lvlog.Printf("X_S1-3 = %f %f %f\r\n",X_S1,X_S2,X_S3);
 
 		// FINALLY - COMMANDS!
 		X_Zi = asin(X_S2);			// Yaw
 		X_Yi = atan2(-X_S3,X_S1);	// Pitch
-		fprintf(lvlog,"*** COMMAND ISSUED ***\r\n");
-		fprintf(lvlog,"PITCH = %f, YAW = %f\r\n\r\n",X_Yi*DEG,X_Zi*DEG);
+		lvlog.Printf("*** COMMAND ISSUED ***\r\n");
+		lvlog.Printf("PITCH = %f, YAW = %f\r\n\r\n",X_Yi*DEG,X_Zi*DEG);
 			
 		// IGM is supposed to generate attitude directly.
 		CommandedAttitude.x = 360 * RAD;    // ROLL
@@ -1592,43 +1590,43 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 
 orbitalguidance: //orbital guidance logic;
 
-		fprintf(lvlog,"*** ORBITAL GUIDANCE ***\r\n");
+		lvlog.Printf("*** ORBITAL GUIDANCE ***\r\n");
 		if(TAS-TA3 < 0){ //time for maneuver after CSM sep		
 			if(TAS-TA1 > 0){ //1st maneuver to -20 pitch LVLH prior to CSM sep
 				if(TAS-TA2 > 0){ //time for attitude hold
 					if(INH2){
 						alpha_1 = -20 * RAD; //if INH2: maintain orb rate
 						CommandedAttitude.x = 180 * RAD;
-						fprintf(lvlog,"inhibit attitude hold, maintain pitchdown\r\n");
+						lvlog.Printf("inhibit attitude hold, maintain pitchdown\r\n");
 						goto orbatt;
 					}else{
 						CommandedAttitude = PCommandedAttitude; //hold attitude for CSM sep
-						fprintf(lvlog,"Attitude hold\r\n");
+						lvlog.Printf("Attitude hold\r\n");
 						goto minorloop;
 					}
 				}else{
 					if(INH1){
 						alpha_1 = 0 * RAD; //if INH1: no pitchdown
 						CommandedAttitude.x = 360 * RAD;
-						fprintf(lvlog,"inhibit pitchdown");
+						lvlog.Printf("inhibit pitchdown");
 						goto orbatt;
 					}else{
 						alpha_1 = -20 * RAD; //from GRR +9780 till GRR+10275
 						CommandedAttitude.x = 360 * RAD;
-						fprintf(lvlog,"pitchdown");
+						lvlog.Printf("pitchdown");
 						goto orbatt;
 					}
 				}
 			}else{
 				alpha_1 = 360 * RAD; //from TB4+20 till GRR +9780 0
 				CommandedAttitude.x = 360 * RAD;
-				fprintf(lvlog,"TB4+20\r\n");
+				lvlog.Printf("TB4+20\r\n");
 				goto orbatt;
 			}						
 		}else{
 			alpha_1 = 180 * RAD; //tail forward
 			CommandedAttitude.x = 180 * RAD; //heads up
-			fprintf(lvlog,"post sep attitude\r\n");
+			lvlog.Printf("post sep attitude\r\n");
 			goto orbatt;
 		}
 
@@ -1657,21 +1655,21 @@ orbatt: Pos4 = mul(MX_G,PosS); //here we compute the steering angles...
 		VT1.x = (cos_chi_Yit * cos_chi_Zit);
 		VT1.y = (sin_chi_Zit);
 		VT1.z = (-sin_chi_Yit * cos_chi_Zit);
-		fprintf(lvlog,"VT (set) = %f %f %f\r\n",VT1.x,VT1.y,VT1.z);
+		lvlog.Printf("VT (set) = %f %f %f\r\n",VT1.x,VT1.y,VT1.z);
 
 		VT1 = mul(MX_Gi,VT1);
-		fprintf(lvlog,"VT (mul) = %f %f %f\r\n",VT1.x,VT1.y,VT1.z);
+		lvlog.Printf("VT (mul) = %f %f %f\r\n",VT1.x,VT1.y,VT1.z);
 
 		X_S1 = VT1.x;
 		X_S2 = VT1.y;
 		X_S3 = VT1.z;
-		fprintf(lvlog,"X_S1-3 = %f %f %f\r\n",X_S1,X_S2,X_S3);
+		lvlog.Printf("X_S1-3 = %f %f %f\r\n",X_S1,X_S2,X_S3);
 
 		// COMMANDS
 		X_Zi = asin(X_S2);			// Yaw
 		X_Yi = atan2(-X_S3,X_S1);	// Pitch
-		fprintf(lvlog,"*** COMMAND ISSUED ***\r\n");
-		fprintf(lvlog,"PITCH = %f, YAW = %f\r\n\r\n",X_Yi*DEG,X_Zi*DEG);
+		lvlog.Printf("*** COMMAND ISSUED ***\r\n");
+		lvlog.Printf("PITCH = %f, YAW = %f\r\n\r\n",X_Yi*DEG,X_Zi*DEG);
 		CommandedAttitude.y = X_Yi; // PITCH
 		CommandedAttitude.z = X_Zi; // YAW;				
 
@@ -1717,7 +1715,7 @@ minorloop: //minor loop;
 			BOOST = false;
 			LVDC_Timebase = 4;
 			LVDC_TB_ETime = 0;
-			fprintf(lvlog,"SIVB CUTOFF! TAS = %f \r\n",TAS);
+			lvlog.Printf("SIVB CUTOFF! TAS = %f \r\n",TAS);
 		};
 		//calculate delta attitude
 		DeltaAtt.x = fmod((CurrentAttitude.x - CommandedAttitude.x + TWO_PI),TWO_PI);
@@ -2301,8 +2299,7 @@ void LVDC1B::LoadState(FILEHANDLE scn){
 	int tmp = 0; // Used in boolean type loader
 
 	if(Initialized){
-		fprintf(lvlog,"LoadState() called\r\n");
-		fflush(lvlog);
+		lvlog.Printf("LoadState() called\r\n");
 	}
 	while (oapiReadScenario_nextline (scn, line)) {
 		if (!strnicmp(line, LVDC_END_STRING, sizeof(LVDC_END_STRING))){
@@ -2659,21 +2656,33 @@ void LVDC1B::LoadState(FILEHANDLE scn){
 	}	
 	if(oapiReadScenario_nextline (scn, line)){
 		if (!strnicmp(line, LVIMU_START_STRING, sizeof(LVIMU_START_STRING))) {
-			// fprintf(lvlog, "LVIMU LoadState() called\r\n");
+			// lvlog.Printf("LVIMU LoadState() called\r\n");
 			// fflush(lvlog);
 			lvimu.LoadState(scn);
 			/*
-			if(lvimu.Initialized) { fprintf(lvlog, "LVIMU Initialized\r\n"); }
-			if(lvimu.Operate){ fprintf(lvlog, "LVIMU Operate\r\n"); }
-			if(lvimu.Caged) { fprintf(lvlog, "LVIMU Caged\r\n"); }			
-			if(lvimu.TurnedOn) { fprintf(lvlog, "LVIMU Turned On\r\n"); }
-			fflush(lvlog);
+			if(lvimu.Initialized) { lvlog.Printf("LVIMU Initialized\r\n"); }
+			if(lvimu.Operate){ lvlog.Printf("LVIMU Operate\r\n"); }
+			if(lvimu.Caged) { lvlog.Printf("LVIMU Caged\r\n"); }			
+			if(lvimu.TurnedOn) { lvlog.Printf("LVIMU Turned On\r\n"); }
 			*/
 		}
 	}
 	return;
 }
 
+void LVDC1B::SaveCheckpoint(Checkpoint &cp) {
+	cp.Put(Initialized);
+	CHECKPOINT_RANGE(LVDC1B, LVDC_Stop, eps_ymr);
+	cp.PutRange(LVDC_Stop, eps_ymr);
+	lvimu.SaveCheckpoint(cp);
+}
+
+void LVDC1B::LoadCheckpoint(Checkpoint &cp) {
+	cp.Get(Initialized);
+	cp.GetRange(LVDC_Stop, eps_ymr);
+	lvimu.LoadCheckpoint(cp);
+}
+
 // ***************************
 // DS20150720 LVDC++ ON WHEELS
 // ***************************
@@ -3078,12 +3087,10 @@ void LVDC::Init(Saturn* vs){
 	if(vs == NULL){ return; }				// Bail
 	if(Initialized == true){ 
 		if(owner == vs){
-			fprintf(lvlog,"init called after init, ignored\r\n");
-			fflush(lvlog);
+			lvlog.Printf("init called after init, ignored\r\n");
 			return;
 		}else{
-			fprintf(lvlog,"init called after init with new owner, proceeding\r\n");
-			fflush(lvlog);
+			lvlog.Printf("init called after init with new owner, proceeding\r\n");
 		}
 	}
 	owner = vs;								// Our ship
@@ -3414,9 +3421,8 @@ void LVDC::Init(Saturn* vs){
 	LVDC_EI_On = false;
 	S1_Sep_Time = 0;
 	CountPIPA = false;
-	if(!Initialized){ lvlog = fopen("lvlog.txt","w+"); }
-	fprintf(lvlog,"init complete\r\n");
-	fflush(lvlog);
+	if(!Initialized){ lvlog.Open(FLIGHTLOG_LVDC, "lvlog.txt"); lvlog.SetClock(&LVDC_Timebase, &LVDC_TB_ETime); }
+	lvlog.Printf("init complete\r\n");
 	Initialized = true;
 }
 
@@ -4074,8 +4080,7 @@ void LVDC::LoadState(FILEHANDLE scn){
 	char *line;	
 	int tmp=0; // for bool loader
 	if(Initialized){
-		fprintf(lvlog,"LoadState() called\r\n");
-		fflush(lvlog);
+		lvlog.Printf("LoadState() called\r\n");
 	}
 	while (oapiReadScenario_nextline (scn, line)) {
 		if (!strnicmp(line, LVDC_END_STRING, sizeof(LVDC_END_STRING))){
@@ -4746,6 +4751,19 @@ void LVDC::LoadState(FILEHANDLE scn){
 	return;
 }
 
+void LVDC::SaveCheckpoint(Checkpoint &cp) {
+	cp.Put(Initialized);
+	CHECKPOINT_RANGE(LVDC, LVDC_Timebase, eps_ymr);
+	cp.PutRange(LVDC_Timebase, eps_ymr);
+	lvimu.SaveCheckpoint(cp);
+}
+
+void LVDC::LoadCheckpoint(Checkpoint &cp) {
+	cp.Get(Initialized);
+	cp.GetRange(LVDC_Timebase, eps_ymr);
+	lvimu.LoadCheckpoint(cp);
+}
+
 void LVDC::TimeStep(double simt, double simdt) {
 	if(owner == NULL){ return; }
 	if (owner->stage < PRELAUNCH_STAGE) { return; }
@@ -4945,7 +4963,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 				// Apollo 8 cut off at 32877, Apollo 11 cut off at 31995.
 				if (owner->stage == LAUNCH_STAGE_ONE && owner->GetFuelMass() <= 0){
 					// For S1B/C thruster calibration
-					fprintf(lvlog,"[T+%f] S1 OECO - Thrust %f N @ Alt %f\r\n\r\n",owner->MissionTime,owner->GetThrusterMax(owner->th_main[0]),owner->GetAltitude());
+					lvlog.Printf("[T+%f] S1 OECO - Thrust %f N @ Alt %f\r\n\r\n",owner->MissionTime,owner->GetThrusterMax(owner->th_main[0]),owner->GetAltitude());
 					owner->SwitchSelector(17);
 					// Set timer
 					S1_Sep_Time = owner->MissionTime;
@@ -4993,7 +5011,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 			
 				// MR Shift
 				if(LVDC_TB_ETime > 284.4 && owner->stage == LAUNCH_STAGE_TWO_ISTG_JET && MRS == false){
-					fprintf(lvlog,"[TB%d+%f] MR Shift\r\n",LVDC_Timebase,LVDC_TB_ETime);
+					lvlog.Printf("[TB%d+%f] MR Shift\r\n",LVDC_Timebase,LVDC_TB_ETime);
 					// sprintf(oapiDebugString(),"LVDC: EMR SHIFT"); LVDC_GP_PC = 30; break;
 					owner->SwitchSelector(23);
 					MRS = true;
@@ -5003,7 +5021,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 				if(MRS == true){
 					double oetl = owner->GetThrusterLevel(owner->th_main[0])+owner->GetThrusterLevel(owner->th_main[1])+owner->GetThrusterLevel(owner->th_main[2])+owner->GetThrusterLevel(owner->th_main[3]);
 					if(oetl == 0){
-						fprintf(lvlog,"[MT %f] TB4 Start\r\n",simt);
+						lvlog.Printf("[MT %f] TB4 Start\r\n",simt);
 						// S2 OECO, start TB4
 						owner->SetThrusterGroupLevel(owner->thg_main, 0);
 						S2_BURNOUT = true;
@@ -5033,7 +5051,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 				// S2 STAGE SEP
 				if (LVDC_TB_ETime > 0.8 && owner->stage <= LAUNCH_STAGE_TWO_ISTG_JET) {
 					// S2ShutS.done(); No CECO on AP8
-					fprintf(lvlog,"[%d+%f] S2/S4B STAGING\r\n",LVDC_Timebase,LVDC_TB_ETime);
+					lvlog.Printf("[%d+%f] S2/S4B STAGING\r\n",LVDC_Timebase,LVDC_TB_ETime);
 					owner->SPUShiftS.done(); // Make sure it's done
 					owner->ClearEngineIndicators();
 					owner->SeparateStage(LAUNCH_STAGE_SIVB);
@@ -5061,7 +5079,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 					TB5 = TAS;//-simdt;
 					LVDC_Timebase = 5;
 					LVDC_TB_ETime = 0;
-					fprintf(lvlog, "SIVB CUTOFF! TAS = %f \r\n", TAS);
+					lvlog.Printf("SIVB CUTOFF! TAS = %f \r\n", TAS);
 				}
 
 				// CSM/LV separation
@@ -5089,7 +5107,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 							owner->SetThrusterLevel(owner->th_main[0], 0);
 						}
 					}
-					fprintf(lvlog,"S4B CUTOFF: Time %f Thrust %f\r\n",LVDC_TB_ETime,owner->GetThrusterLevel(owner->th_main[0]));
+					lvlog.Printf("S4B CUTOFF: Time %f Thrust %f\r\n",LVDC_TB_ETime,owner->GetThrusterLevel(owner->th_main[0]));
 				}
 
 				if (LVDC_TB_ETime >= 10 && LVDC_EI_On == true){
@@ -5154,7 +5172,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 				}	
 				if (LVDC_TB_ETime >= T_RG && S4B_REIGN == false) {
 					owner->SetThrusterGroupLevel(owner->thg_main, ((LVDC_TB_ETime - 578.6)*0.53)); //Engine ignites at MR 4.5 and throttles up
-					fprintf(lvlog, "S4B IGNITION: Time %f Thrust %f\r\n", LVDC_TB_ETime, owner->GetThrusterLevel(owner->th_main[0]));
+					lvlog.Printf("S4B IGNITION: Time %f Thrust %f\r\n", LVDC_TB_ETime, owner->GetThrusterLevel(owner->th_main[0]));
 				}
 				if(LVDC_TB_ETime>=580.3 && S4B_REIGN==false)
 				{
@@ -5174,7 +5192,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 					TB7 = TAS;//-simdt;
 					LVDC_Timebase = 7;
 					LVDC_TB_ETime = 0;
-					fprintf(lvlog, "SIVB CUTOFF! TAS = %f \r\n", TAS);
+					lvlog.Printf("SIVB CUTOFF! TAS = %f \r\n", TAS);
 					owner->TLI_Ended();
 				}
 				break;
@@ -5196,7 +5214,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 							owner->SetThrusterLevel(owner->th_main[0], 0);
 						}
 					}
-					fprintf(lvlog, "S4B CUTOFF: Time %f Thrust %f\r\n", LVDC_TB_ETime, owner->GetThrusterLevel(owner->th_main[0]));
+					lvlog.Printf("S4B CUTOFF: Time %f Thrust %f\r\n", LVDC_TB_ETime, owner->GetThrusterLevel(owner->th_main[0]));
 				}
 				if (LVDC_TB_ETime >= 10 && LVDC_EI_On == true) {
 					LVDC_EI_On = false;
@@ -5222,7 +5240,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 		//This is the actual LVDC code & logic; has to be independent from any of the above events
 		if(LVDC_GRR && init == false)
 		{
-			fprintf(lvlog,"[T%f] GRR received!\r\n",owner->MissionTime);
+			lvlog.Printf("[T%f] GRR received!\r\n",owner->MissionTime);
 
 			// Initial Position & Velocity from Apollo 9 operational trajectory
 			/*PosS.x = 6373324.5;
@@ -5245,7 +5263,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 			t_D = T_L - T_LO;
 			//t_D = TABLE15.target[tgt_index].t_D;
 
-			fprintf(lvlog, "Time into launch window = %f\r\n", t_D);
+			lvlog.Printf("Time into launch window = %f\r\n", t_D);
 
 			//Azimuth determination
 			if (t_DS0 <= t_D && t_D < t_DS1)
@@ -5285,22 +5303,22 @@ void LVDC::TimeStep(double simt, double simdt) {
 
 			// preset to fixed value to be independent from any external stuff
 			// Azimuth = 72.124;
-			fprintf(lvlog,"Azimuth = %f\r\n",Azimuth);
+			lvlog.Printf("Azimuth = %f\r\n",Azimuth);
 
 			// Let's cheat a little. (Apollo 8)
 			//Inclination = 32.5031;
-			fprintf(lvlog,"Inclination = %f\r\n",Inclination);
+			lvlog.Printf("Inclination = %f\r\n",Inclination);
 
 			// Cheat a little more. (Apollo 8)
 			// DescNodeAngle = 123.004; 
-			fprintf(lvlog,"DescNodeAngle = %f\r\n", theta_N);
+			lvlog.Printf("DescNodeAngle = %f\r\n", theta_N);
 
 			// Need to make those into radians
 			Azimuth *= RAD;
 			Inclination *= RAD;
 			theta_N *= RAD;
 
-			fprintf(lvlog,"Rad Convert: Az / Inc / DNA = %f %f %f\r\n",Azimuth,Inclination, theta_N);
+			lvlog.Printf("Rad Convert: Az / Inc / DNA = %f %f %f\r\n",Azimuth,Inclination, theta_N);
 
 			if (TerminalConditions == false)
 			{
@@ -5315,18 +5333,18 @@ void LVDC::TimeStep(double simt, double simdt) {
 
 				// p is the semi-latus rectum of the desired terminal ellipse.
 				p = (mu / C_3)*(pow(e, 2) - 1);
-				fprintf(lvlog, "p = %f, mu = %f, e2 = %f, mu/C_3 = %f\r\n", p, mu, pow(e, 2), mu / C_3);
+				lvlog.Printf("p = %f, mu = %f, e2 = %f, mu/C_3 = %f\r\n", p, mu, pow(e, 2), mu / C_3);
 
 				// K_5 is the IGM terminal velocity constant
 				K_5 = sqrt(mu / p);
-				fprintf(lvlog, "K_5 = %f\r\n", K_5);
+				lvlog.Printf("K_5 = %f\r\n", K_5);
 
 				R_T = p / (1 + e*cos(f));
 				V_T = K_5*sqrt((1 + 2 * e*cos(f) + pow(e, 2)));
 				gamma_T = atan2((e*(sin(f))), (1 + (e*(cos(f)))));
 				G_T = -mu / pow(R_T, 2);
 			}
-			fprintf(lvlog,"R_T = %f (Expecting 6,563,366), V_T = %f (Expecting 7793.0429), gamma_T = %f\r\n",R_T,V_T,gamma_T);
+			lvlog.Printf("R_T = %f (Expecting 6,563,366), V_T = %f (Expecting 7793.0429), gamma_T = %f\r\n",R_T,V_T,gamma_T);
 
 			// G MATRIX CALCULATION
 			MX_A.m11 = cos(phi_L);  MX_A.m12 = sin(phi_L)*sin(Azimuth); MX_A.m13 = -(sin(phi_L)*cos(Azimuth));
@@ -5343,7 +5361,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 			U_Z = tmul(MX_A, U_Z);
 			DotS = crossp(U_Z*omega_E, PosS);
 
-			fprintf(lvlog, "Initial Velocity = %f %f %f\r\n", DotS.x, DotS.y, DotS.z);
+			lvlog.Printf("Initial Velocity = %f %f %f\r\n", DotS.x, DotS.y, DotS.z);
 		
 			Y_u= -(PosS.x*MX_A.m21+PosS.y*MX_A.m22+PosS.z*MX_A.m23); //position component south of equator
 			R = pow(pow(PosS.x,2)+pow(PosS.y,2)+pow(PosS.z,2),0.5); //instantaneous distance from earth's center
@@ -5365,7 +5383,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 			lvimu.ZeroPIPACounters();
 			sinceLastCycle = 0;
 			init = true;
-			fprintf(lvlog, "Initialization completed.\r\n\r\n");
+			lvlog.Printf("Initialization completed.\r\n\r\n");
 			goto minorloop;
 		}
 		// various clocks the LVDC needs...
@@ -5412,7 +5430,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 				dt_c = sinceLastCycle;
 				sinceLastCycle = 0;
 				IGMCycle++;				// For debugging
-				fprintf(lvlog, "[%d+%f] *** Major Loop (powered) %d ***\r\n", LVDC_Timebase, LVDC_TB_ETime, IGMCycle);
+				lvlog.Printf("[%d+%f] *** Major Loop (powered) %d ***\r\n", LVDC_Timebase, LVDC_TB_ETime, IGMCycle);
 				//read the PIPA CDUs
 				DotM_act.x += (lvimu.CDURegisters[LVRegPIPAX]);
 				DotM_act.y += (lvimu.CDURegisters[LVRegPIPAY]);
@@ -5437,20 +5455,20 @@ void LVDC::TimeStep(double simt, double simdt) {
 
 				ddotM_act = ddotG_last; //For orbital nav initialization
 
-				fprintf(lvlog, "Powered Navigation \r\n");
-				fprintf(lvlog, "Inertial Attitude: %f %f %f \r\n", CurrentAttitude.x*DEG, CurrentAttitude.y*DEG, CurrentAttitude.z*DEG);
-				fprintf(lvlog, "DotM: %f %f %f \r\n", DotM_act.x, DotM_act.y, DotM_act.z);
-				fprintf(lvlog, "Accelerometer readings: %f %f %f\r\n",lvimu.CDURegisters[LVRegPIPAX], lvimu.CDURegisters[LVRegPIPAY], lvimu.CDURegisters[LVRegPIPAZ]);
-				fprintf(lvlog, "Gravity velocity: %f %f %f \r\n", DotG_act.x, DotG_act.y, DotG_act.z);
-				fprintf(lvlog, "EarthRel Position: %f %f %f \r\n", PosS.x, PosS.y, PosS.z);
-				fprintf(lvlog, "SV Accuracy: %f \r\n", SVCompare());
-				fprintf(lvlog, "EarthRel Velocity: %f %f %f \r\n", DotS.x, DotS.y, DotS.z);
-				fprintf(lvlog, "Sensed Acceleration: %f \r\n", Fm);
-				fprintf(lvlog, "Gravity Acceleration: %f \r\n", CG);
-				fprintf(lvlog, "Total Velocity: %f \r\n", V);
-				fprintf(lvlog, "Dist. from Earth's Center: %f \r\n", R);
-				fprintf(lvlog, "S: %f \r\n", S);
-				fprintf(lvlog, "P: %f \r\n", P);
+				lvlog.Printf("Powered Navigation \r\n");
+				lvlog.Printf("Inertial Attitude: %f %f %f \r\n", CurrentAttitude.x*DEG, CurrentAttitude.y*DEG, CurrentAttitude.z*DEG);
+				lvlog.Printf("DotM: %f %f %f \r\n", DotM_act.x, DotM_act.y, DotM_act.z);
+				lvlog.Printf("Accelerometer readings: %f %f %f\r\n",lvimu.CDURegisters[LVRegPIPAX], lvimu.CDURegisters[LVRegPIPAY], lvimu.CDURegisters[LVRegPIPAZ]);
+				lvlog.Printf("Gravity velocity: %f %f %f \r\n", DotG_act.x, DotG_act.y, DotG_act.z);
+				lvlog.Printf("EarthRel Position: %f %f %f \r\n", PosS.x, PosS.y, PosS.z);
+				lvlog.Printf("SV Accuracy: %f \r\n", SVCompare());
+				lvlog.Printf("EarthRel Velocity: %f %f %f \r\n", DotS.x, DotS.y, DotS.z);
+				lvlog.Printf("Sensed Acceleration: %f \r\n", Fm);
+				lvlog.Printf("Gravity Acceleration: %f \r\n", CG);
+				lvlog.Printf("Total Velocity: %f \r\n", V);
+				lvlog.Printf("Dist. from Earth's Center: %f \r\n", R);
+				lvlog.Printf("S: %f \r\n", S);
+				lvlog.Printf("P: %f \r\n", P);
 				lvimu.ZeroPIPACounters();
 			}
 			else
@@ -5469,7 +5487,7 @@ void LVDC::TimeStep(double simt, double simdt) {
 				dt_c = sinceLastCycle;
 				sinceLastCycle = 0.0;
 				OrbNavCycle++;		//For debugging
-				fprintf(lvlog, "[%d+%f] *** Major Loop (orbital) %d ***\r\n", LVDC_Timebase, LVDC_TB_ETime, OrbNavCycle);
+				lvlog.Printf("[%d+%f] *** Major Loop (orbital) %d ***\r\n", LVDC_Timebase, LVDC_TB_ETime, OrbNavCycle);
 				//4-second intermediate integration
 				PosS_4sec = PosS + DotS*dt_c / 2.0 + ddotM_act*dt_c*dt_c/8.0;
 				DotS_4sec = DotS + ddotM_act*dt_c / 2.0;
@@ -5573,18 +5591,18 @@ void LVDC::TimeStep(double simt, double simdt) {
 				DotG_last = DotS;
 				lvimu.ZeroPIPACounters();
 
-				fprintf(lvlog, "Orbital Navigation \r\n");
-				fprintf(lvlog, "Inertial Attitude: %f %f %f \r\n", CurrentAttitude.x*DEG, CurrentAttitude.y*DEG, CurrentAttitude.z*DEG);
-				fprintf(lvlog, "DDotM: %f %f %f \r\n", ddotM_act.x, ddotM_act.y, ddotM_act.z);
-				fprintf(lvlog, "EarthRel Position: %f %f %f \r\n", PosS.x, PosS.y, PosS.z);
-				fprintf(lvlog, "SV Accuracy: %f \r\n", SVCompare());
-				fprintf(lvlog, "EarthRel Velocity: %f %f %f \r\n", DotS.x, DotS.y, DotS.z);
-				fprintf(lvlog, "Drag Acceleration: %f \r\n", length(DDotS_D));
-				fprintf(lvlog, "Gravity Acceleration: %f \r\n", CG);
-				fprintf(lvlog, "Total Velocity: %f \r\n", V);
-				fprintf(lvlog, "Dist. from Earth's Center: %f \r\n", R);
-				fprintf(lvlog, "S: %f \r\n", S);
-				fprintf(lvlog, "P: %f \r\n", P);
+				lvlog.Printf("Orbital Navigation \r\n");
+				lvlog.Printf("Inertial Attitude: %f %f %f \r\n", CurrentAttitude.x*DEG, CurrentAttitude.y*DEG, CurrentAttitude.z*DEG);
+				lvlog.Printf("DDotM: %f %f %f \r\n", ddotM_act.x, ddotM_act.y, ddotM_act.z);
+				lvlog.Printf("EarthRel Position: %f %f %f \r\n", PosS.x, PosS.y, PosS.z);
+				lvlog.Printf("SV Accuracy: %f \r\n", SVCompare());
+				lvlog.Printf("EarthRel Velocity: %f %f %f \r\n", DotS.x, DotS.y, DotS.z);
+				lvlog.Printf("Drag Acceleration: %f \r\n", length(DDotS_D));
+				lvlog.Printf("Gravity Acceleration: %f \r\n", CG);
+				lvlog.Printf("Total Velocity: %f \r\n", V);
+				lvlog.Printf("Dist. from Earth's Center: %f \r\n", R);
+				lvlog.Printf("S: %f \r\n", S);
+				lvlog.Printf("P: %f \r\n", P);
 			}
 			
 		}
@@ -5594,7 +5612,7 @@ GuidanceLoop:
 			CommandedAttitude.y =  0;
 			CommandedAttitude.z =  0;
 			//Just clogs the lvlog
-			//fprintf(lvlog,"[%d+%f] Initial roll command: %f\r\n",LVDC_Timebase,LVDC_TB_ETime,CommandedAttitude.x*DEG);
+			//lvlog.Printf("[%d+%f] Initial roll command: %f\r\n",LVDC_Timebase,LVDC_TB_ETime,CommandedAttitude.x*DEG);
 			goto minorloop;
 		}
 		if(BOOST == false){//i.e. we're either in orbit or boosting out of orbit
@@ -5616,7 +5634,7 @@ GuidanceLoop:
 				ROV = ROVs;
 				//S4B_IGN = true;
 				GATE4 = true;
-				fprintf(lvlog,"[%d+%f] Direct stage interrupt received! Guidance update executed!\r\n",LVDC_Timebase,LVDC_TB_ETime);
+				lvlog.Printf("[%d+%f] Direct stage interrupt received! Guidance update executed!\r\n",LVDC_Timebase,LVDC_TB_ETime);
 			}
 			if(TAS-TB4A-TS4BS < 0){ goto minorloop; }else{ goto IGM; }						
 		}
@@ -5626,7 +5644,7 @@ GuidanceLoop:
 				// S1C engine out interrupt handling
 				T_EO1 = 1;
 				t_fail = t_clock;
-				fprintf(lvlog,"[%d+%f] S1C engine out interrupt received! t_fail = %f\r\n",LVDC_Timebase,LVDC_TB_ETime,t_fail);
+				lvlog.Printf("[%d+%f] S1C engine out interrupt received! t_fail = %f\r\n",LVDC_Timebase,LVDC_TB_ETime,t_fail);
 			}				
 			if((PosS.x - a) > 137 || t_clock > t_1){
 				//roll/pitch program
@@ -5639,7 +5657,7 @@ GuidanceLoop:
 					if (t_5 < t_clock){ dT_F = 0; }
 					t_6 = t_clock + dT_F;
 					T_ar = T_ar + (0.25*(T_ar - t_fail));
-					fprintf(lvlog,"[%d+%f] Freeze time recalculated! t_6 = %f T_ar = %f\r\n",LVDC_Timebase,LVDC_TB_ETime,t_6,T_ar);
+					lvlog.Printf("[%d+%f] Freeze time recalculated! t_6 = %f T_ar = %f\r\n",LVDC_Timebase,LVDC_TB_ETime,t_6,T_ar);
 				}
 				if (t_clock >= t_6){
 					if (t_clock > T_ar){
@@ -5654,10 +5672,10 @@ GuidanceLoop:
 							CommandedAttitude.y = PCommandedAttitude.y;
 							CommandedAttitude.x = 360 * RAD;
 							CommandedAttitude.z = 0;
-							fprintf(lvlog,"[%d+%f] Pre-IGM SII engine out interrupt received!\r\n",LVDC_Timebase,LVDC_TB_ETime);
+							lvlog.Printf("[%d+%f] Pre-IGM SII engine out interrupt received!\r\n",LVDC_Timebase,LVDC_TB_ETime);
 							goto minorloop;
 						}else{
-							fprintf(lvlog,"[%d+%f] Pitch freeze! \r\n",LVDC_Timebase,LVDC_TB_ETime);
+							lvlog.Printf("[%d+%f] Pitch freeze! \r\n",LVDC_Timebase,LVDC_TB_ETime);
 							CommandedAttitude.y = PCommandedAttitude.y;
 							CommandedAttitude.x = 360 * RAD;
 							CommandedAttitude.z = 0;
@@ -5678,7 +5696,7 @@ GuidanceLoop:
 						CommandedAttitude.y = cmd * RAD;
 						CommandedAttitude.x = 360 * RAD;
 						CommandedAttitude.z = 0;
-						fprintf(lvlog,"[%d+%f] Roll/pitch programm %f \r\n",LVDC_Timebase,LVDC_TB_ETime,cmd);
+						lvlog.Printf("[%d+%f] Roll/pitch programm %f \r\n",LVDC_Timebase,LVDC_TB_ETime,cmd);
 						goto minorloop;
 					}
 				}else{CommandedAttitude.y = PCommandedAttitude.y;
@@ -5688,7 +5706,7 @@ GuidanceLoop:
 				}
 			}else{
 				// S-IC yaw maneuver
-				fprintf(lvlog,"[%d+%f] Yaw maneuver\r\n",LVDC_Timebase,LVDC_TB_ETime);
+				lvlog.Printf("[%d+%f] Yaw maneuver\r\n",LVDC_Timebase,LVDC_TB_ETime);
 				if(1 <= t_clock && t_clock < 8.75){
 					//yaw command issued between t +1s and t+8.75s
 					CommandedAttitude.z = 1.25*RAD;
@@ -5703,20 +5721,20 @@ GuidanceLoop:
 		//end of pre igm
 IGM:	if(HSL == false){		
 			// We are not in the high-speed loop
-			fprintf(lvlog,"HSL False\r\n");
+			lvlog.Printf("HSL False\r\n");
 			// IGM STAGE LOGIC
 			if (S4B_REIGN)
 			{
-				fprintf(lvlog, "S-IVB 2nd BURN\n");
+				lvlog.Printf("S-IVB 2nd BURN\n");
 				if (MRS)
 				{
-					fprintf(lvlog, "MRS\r\n");
+					lvlog.Printf("MRS\r\n");
 					Tt_3 += T_2*(dotM_2 / dotM_3);
-					fprintf(lvlog, "Tt_3 = %f\r\n", Tt_3);
+					lvlog.Printf("Tt_3 = %f\r\n", Tt_3);
 					if(t_B2<=t_B4)
 					{goto relightentry1;}
 					t_B4 += dt_c;
-					fprintf(lvlog, "t_B4 = %f\r\n", t_B4);
+					lvlog.Printf("t_B4 = %f\r\n", t_B4);
 				}
 				else
 				{
@@ -5727,7 +5745,7 @@ IGM:	if(HSL == false){
 						{
 							MRS = true;
 							t_B2 = 0;
-							fprintf(lvlog, "MRS\r\n");
+							lvlog.Printf("MRS\r\n");
 						}
 					}
 					else
@@ -5743,44 +5761,44 @@ IGM:	if(HSL == false){
 					tau2 = tau2N + (V_ex2 * 1.0 / Fm - dt_c / 2.0 - tau2N)*pow(Ct / Ct_o, 4);
 					tau2N -= dt_c;
 					Ct += dt_c;
-					fprintf(lvlog, "Art. Tau Mode 2: tau2 = %f, tau2N = %f, Ct = %f, Diff = %f\r\n", tau2, tau2N, Ct, tau2 - V_ex2 / Fm);
+					lvlog.Printf("Art. Tau Mode 2: tau2 = %f, tau2N = %f, Ct = %f, Diff = %f\r\n", tau2, tau2N, Ct, tau2 - V_ex2 / Fm);
 					goto relightentry3;
 				}
 			}
 			if(S4B_IGN == true){
-				fprintf(lvlog,"S-IVB 1st BURN\n");
+				lvlog.Printf("S-IVB 1st BURN\n");
 				if (Ct >= Ct_o){
 					relightentry1:
 					tau3 = V_ex3/Fm;
-					fprintf(lvlog,"Normal Tau: tau3 = %f, F = %f, m = %f \r\n",tau3,owner->GetThrusterMax(owner->th_main[0])*owner->GetThrusterLevel(owner->th_main[0]),owner->GetMass());
+					lvlog.Printf("Normal Tau: tau3 = %f, F = %f, m = %f \r\n",tau3,owner->GetThrusterMax(owner->th_main[0])*owner->GetThrusterLevel(owner->th_main[0]),owner->GetMass());
 				}else{
 					tau3 = tau3N + (V_ex3/Fm - dt_c/2 - tau3N)*pow((Ct/Ct_o),4);
 					tau3N = tau3N - dt_c;
 					Ct = Ct + dt_c;
-					fprintf(lvlog,"Art. Tau Mode 3: tau3 = %f, tau3N = %f, Ct = %f, Diff = %f\r\n",tau3,tau3N,Ct,tau3-V_ex3/Fm);								
+					lvlog.Printf("Art. Tau Mode 3: tau3 = %f, tau3N = %f, Ct = %f, Diff = %f\r\n",tau3,tau3N,Ct,tau3-V_ex3/Fm);								
 				}
 				GATE = false; //end chi freeze
 				T_c = 0;
 				T_2 = 0;
 				T_1 = 0;
-				fprintf(lvlog,"GATE = false, T_c = 0, T_1 = 0, T_2 = 0\r\n");
+				lvlog.Printf("GATE = false, T_c = 0, T_1 = 0, T_2 = 0\r\n");
 				goto chitilde;
 			}
 			if(S2_BURNOUT == true){
-				fprintf(lvlog,"SII CUTOFF\n");
+				lvlog.Printf("SII CUTOFF\n");
 				if (T_c < 0){
 					//this prevents T_c from getting negative in case of late SIVB ignition
 					T_c = 0;
 					T_2 = 0;
 					T_1 = 0;
-					fprintf(lvlog,"T_c = 0, T_1 = 0, T_2 = 0\r\n");
+					lvlog.Printf("T_c = 0, T_1 = 0, T_2 = 0\r\n");
 					goto chitilde;
 				}else{
 					//chi freeze, kill the first two stage integrals
 					GATE = true;
 					T_2 = 0;
 					T_1 = 0;
-					fprintf(lvlog,"GATE = true, T_1 = 0, T_2 = 0\r\n");
+					lvlog.Printf("GATE = true, T_1 = 0, T_2 = 0\r\n");
 					goto chitilde;
 				}				
 			}
@@ -5791,67 +5809,67 @@ IGM:	if(HSL == false){
 				T_EO2 = 1;
 			}
 			if(MRS == true){
-				fprintf(lvlog,"Post-MRS\n");
+				lvlog.Printf("Post-MRS\n");
 				if(t_B1 <= t_B3){
 					relightentry2:
 					tau2 = V_ex2/Fm;
-					fprintf(lvlog,"Normal Tau: tau2 = %f, F/m = %f, m = %f \r\n",tau2,Fm,owner->GetMass());
+					lvlog.Printf("Normal Tau: tau2 = %f, F/m = %f, m = %f \r\n",tau2,Fm,owner->GetMass());
 				}else{
 					// This is the "ARTIFICIAL TAU" code.
 					t_B3 += dt_c; 
 					tau2 = tau2+(T_1*(dotM_1/dotM_2));
-					fprintf(lvlog,"Art. Tau: tau2 = %f, T_1 = %f, dotM_1 = %f dotM_2 = %f \r\n",tau2,T_1,dotM_1,dotM_2);
-					fprintf(lvlog,"Diff: %f \r\n",(tau2-V_ex2/Fm));
+					lvlog.Printf("Art. Tau: tau2 = %f, T_1 = %f, dotM_1 = %f dotM_2 = %f \r\n",tau2,T_1,dotM_1,dotM_2);
+					lvlog.Printf("Diff: %f \r\n",(tau2-V_ex2/Fm));
 				}
 				// This T_2 test is also tested after T_1 < 0 etc etc
 				relightentry3:
 				if(T_2 > 0){
 					T_2 = T_2+T_1*(dotM_1/dotM_2);
 					T_1 = 0;
-					fprintf(lvlog,"T_1 = 0\r\nT_2 = %f, dotM_1 = %f, dotM_2 = %f \r\n",T_2,dotM_1,dotM_2);
+					lvlog.Printf("T_1 = 0\r\nT_2 = %f, dotM_1 = %f, dotM_2 = %f \r\n",T_2,dotM_1,dotM_2);
 					// Go to CHI-TILDE LOGIC
 				}else{
 					T_2 = 0;
 					T_1 = 0;
-					fprintf(lvlog,"T_1 = 0, T_2 = 0\r\n");
+					lvlog.Printf("T_1 = 0, T_2 = 0\r\n");
 					// Go to CHI-TILDE LOGIC
 				}
 				if(T_2 < 11 && !S4B_REIGN){GATE = true;}//pre SIVB-staging chi-freeze
 			}else{
-				fprintf(lvlog,"Pre-MRS\n");
+				lvlog.Printf("Pre-MRS\n");
 				if(T_1 < 0){	
 					// If we're out of first-stage IGM time
 					// Artificial Tau
 					tau2 = tau2+(T_1*(dotM_1/dotM_2));
-					fprintf(lvlog,"Art. Tau: tau2 = %f, T_1 = %f, dotM_1 = %f, dotM_2 = %f \r\n",tau2,T_1,dotM_1,dotM_2);
+					lvlog.Printf("Art. Tau: tau2 = %f, T_1 = %f, dotM_1 = %f, dotM_2 = %f \r\n",tau2,T_1,dotM_1,dotM_2);
 					if(T_2 > 0){
 						T_2 = T_2+T_1*(dotM_1/dotM_2);
 						T_1 = 0;
-						fprintf(lvlog,"T_2 = %f, T_1 = %f, dotM_1 = %f, dotM_2 = %f \r\n",T_2,T_1,dotM_1,dotM_2);
+						lvlog.Printf("T_2 = %f, T_1 = %f, dotM_1 = %f, dotM_2 = %f \r\n",T_2,T_1,dotM_1,dotM_2);
 					}else{
 						T_2 = 0;
 						T_1 = 0;
-						fprintf(lvlog,"T_2 = 0\r\n");
+						lvlog.Printf("T_2 = 0\r\n");
 					}					
 				}else{															
 					tau1 = V_ex1/Fm; 
-					fprintf(lvlog,"Normal Tau: tau1 = %f, F/m = %f m = %f\r\n",tau1,Fm, owner->GetMass());
+					lvlog.Printf("Normal Tau: tau1 = %f, F/m = %f m = %f\r\n",tau1,Fm, owner->GetMass());
 				}
 			}
-			fprintf(lvlog,"--- STAGE INTEGRAL LOGIC ---\r\n");
+			lvlog.Printf("--- STAGE INTEGRAL LOGIC ---\r\n");
 
 			// CHI-TILDE LOGIC
 			// STAGE INTEGRAL CALCULATIONS				
 chitilde:	Pos4 = mul(MX_G,PosS);
-			fprintf(lvlog,"Pos4 = %f, %f, %f\r\n",Pos4.x,Pos4.y,Pos4.z);
-			fprintf(lvlog,"T_1 = %f,T_2 = %f\r\n",T_1,T_2);
+			lvlog.Printf("Pos4 = %f, %f, %f\r\n",Pos4.x,Pos4.y,Pos4.z);
+			lvlog.Printf("T_1 = %f,T_2 = %f\r\n",T_1,T_2);
 			L_1 = V_ex1 * log(tau1 / (tau1-T_1));
 			J_1 = (L_1 * tau1) - (V_ex1 * T_1);
 			S_1 = (L_1 * T_1) - J_1;
 			Q_1 = (S_1 * tau1) - ((V_ex1 * pow(T_1,2)) / 2);
 			P_1 = (J_1 * tau1) - ((V_ex1 * pow(T_1,2)) / 2);
 			U_1 = (Q_1 * tau1) - ((V_ex1 * pow(T_1,3)) / 6);
-			fprintf(lvlog,"L_1 = %f, J_1 = %f, S_1 = %f, Q_1 = %f, P_1 = %f, U_1 = %f\r\n",L_1,J_1,S_1,Q_1,P_1,U_1);
+			lvlog.Printf("L_1 = %f, J_1 = %f, S_1 = %f, Q_1 = %f, P_1 = %f, U_1 = %f\r\n",L_1,J_1,S_1,Q_1,P_1,U_1);
 
 			L_2 = V_ex2 * log(tau2 / (tau2-T_2));
 			J_2 = (L_2 * tau2) - (V_ex2 * T_2);
@@ -5859,7 +5877,7 @@ chitilde:	Pos4 = mul(MX_G,PosS);
 			Q_2 = (S_2 * tau2) - ((V_ex2 * pow(T_2,2)) / 2);
 			P_2 = (J_2 * tau2) - ((V_ex2 * pow(T_2,2)) / 2);
 			U_2 = (Q_2 * tau2) - ((V_ex2 * pow(T_2,3)) / 6);
-			fprintf(lvlog,"L_2 = %f, J_2 = %f, S_2 = %f, Q_2 = %f, P_2 = %f, U_2 = %f\r\n",L_2,J_2,S_2,Q_2,P_2,U_2);
+			lvlog.Printf("L_2 = %f, J_2 = %f, S_2 = %f, Q_2 = %f, P_2 = %f, U_2 = %f\r\n",L_2,J_2,S_2,Q_2,P_2,U_2);
 
 			L_12 = L_1 + L_2;
 			J_12 = J_1 + J_2 + (L_2 * T_1);
@@ -5867,23 +5885,23 @@ chitilde:	Pos4 = mul(MX_G,PosS);
 			Q_12 = Q_1 + Q_2 + (S_2 * T_1) + (J_1 * T_2);
 			P_12 = P_1 + P_2 + (T_1 * ((2 * J_2) + (L_2 * T_1)));
 			U_12 = U_1 + U_2 + (T_1 * ((2 * Q_2) + (S_2 * T_1))) + (T_2 * P_1);
-			fprintf(lvlog,"L_12 = %f, J_12 = %f, S_12 = %f, Q_12 = %f, P_12 = %f, U_12 = %f\r\n",L_12,J_12,S_12,Q_12,P_12,U_12);
+			lvlog.Printf("L_12 = %f, J_12 = %f, S_12 = %f, Q_12 = %f, P_12 = %f, U_12 = %f\r\n",L_12,J_12,S_12,Q_12,P_12,U_12);
 
 			Lt_3 = V_ex3 * log(tau3 / (tau3-Tt_3));
-			fprintf(lvlog,"Lt_3 = %f, tau3 = %f, Tt_3 = %f\r\n",Lt_3,tau3,Tt_3);
+			lvlog.Printf("Lt_3 = %f, tau3 = %f, Tt_3 = %f\r\n",Lt_3,tau3,Tt_3);
 
 			Jt_3 = (Lt_3 * tau3) - (V_ex3 * Tt_3);
-			fprintf(lvlog,"Jt_3 = %f",Jt_3);
+			lvlog.Printf("Jt_3 = %f",Jt_3);
 			Lt_Y = (L_12 + Lt_3);
-			fprintf(lvlog,", Lt_Y = %f\r\n",Lt_Y);
+			lvlog.Printf(", Lt_Y = %f\r\n",Lt_Y);
 
 			// SELECT RANGE OPTION				
 gtupdate:	// Target of jump from further down
-			fprintf(lvlog,"--- GT UPDATE ---\r\n");
+			lvlog.Printf("--- GT UPDATE ---\r\n");
 
 			if(Tt_T <= eps_1){
 				// RANGE ANGLE 2 (out-of orbit)
-				fprintf(lvlog,"RANGE ANGLE 2\r\n");
+				lvlog.Printf("RANGE ANGLE 2\r\n");
 				//sprintf(oapiDebugString(),"LVDC: RANGE ANGLE 2: %f %f",Tt_T,eps_1);
 				// LVDC_GP_PC = 30; // STOP
 				V = length(DotS);
@@ -5893,32 +5911,32 @@ gtupdate:	// Target of jump from further down
 				dot_phi_1 = (V*cos_gam)/R;
 				dot_phi_T = (V_T*cos(gamma_T))/R_T;
 				phi_T = atan2(Pos4.z,Pos4.x)+(((dot_phi_1+dot_phi_T)/2.0)*Tt_T);
-				fprintf(lvlog, "V = %f, dot_phi_1 = %f, dot_phi_T = %f, phi_T = %f\r\n", V, dot_phi_1, dot_phi_T, phi_T);
+				lvlog.Printf("V = %f, dot_phi_1 = %f, dot_phi_T = %f, phi_T = %f\r\n", V, dot_phi_1, dot_phi_T, phi_T);
 			}else{
 				// RANGE ANGLE 1 (into orbit)
-				fprintf(lvlog,"RANGE ANGLE 1\r\n");
+				lvlog.Printf("RANGE ANGLE 1\r\n");
 				d2 = (V * Tt_T) - Jt_3 + (Lt_Y * Tt_3) - (ROV / V_ex3) * 
 					((tau1 - T_1) * L_1 + (tau2 - T_2) * L_2 + (tau3 - Tt_3) * Lt_3) *
 					(Lt_Y + V - V_T);
 				phi_T = atan2(Pos4.z, Pos4.x) + (1.0 / R_T)*(S_12 + d2)*cos(gamma_T);
-				fprintf(lvlog,"V = %f, d2 = %f, phi_T = %f\r\n",V,d2,phi_T);
+				lvlog.Printf("V = %f, d2 = %f, phi_T = %f\r\n",V,d2,phi_T);
 			}
 			// FREEZE TERMINAL CONDITIONS TEST
 			if(!(Tt_T <= eps_3)){
 				// UPDATE TERMINAL CONDITIONS
-				fprintf(lvlog,"UPDATE TERMINAL CONDITIONS\r\n");
+				lvlog.Printf("UPDATE TERMINAL CONDITIONS\r\n");
 				f = phi_T + alpha_D;
 				R_T = p/(1+((e*(cos(f)))));
-				fprintf(lvlog, "f = %f, R_T = %f, phi_T = %f, alpha_D = %f\r\n", f, R_T, phi_T, alpha_D);
+				lvlog.Printf("f = %f, R_T = %f, phi_T = %f, alpha_D = %f\r\n", f, R_T, phi_T, alpha_D);
 				V_T = K_5 * pow(1+((2*e)*(cos(f)))+pow(e,2),0.5);
 				gamma_T = atan2((e*(sin(f))),(1+(e*(cos(f)))));
 				G_T = -mu/pow(R_T,2);
-				fprintf(lvlog,"V_T = %f, gamma_T = %f, G_T = %f\r\n",V_T,gamma_T,G_T);
+				lvlog.Printf("V_T = %f, gamma_T = %f, G_T = %f\r\n",V_T,gamma_T,G_T);
 			}
 			// ROT TEST
 			if(ROT){
 				// ROTATED TERMINAL CONDITIONS (out-of-orbit)
-				fprintf(lvlog,"ROTATED TERMINAL CONDITIONS\r\n");
+				lvlog.Printf("ROTATED TERMINAL CONDITIONS\r\n");
 				//sprintf(oapiDebugString(),"LVDC: ROTATED TERMINAL CNDS");
 				xi_T = R_T*cos(gamma_T);
 				dot_zeta_T = V_T;
@@ -5926,63 +5944,63 @@ gtupdate:	// Target of jump from further down
 				ddot_zeta_GT = G_T*sin(gamma_T);
 				ddot_xi_GT = G_T*cos(gamma_T);
 				phi_T = phi_T - gamma_T;
-				fprintf(lvlog, "xi_T = %f, dot_zeta_T = %f, dot_xi_T = %f\r\n", xi_T, dot_zeta_T, dot_xi_T);
-				fprintf(lvlog, "ddot_zeta_GT = %f, ddot_xi_GT = %f\r\n", ddot_zeta_GT, ddot_xi_GT);
+				lvlog.Printf("xi_T = %f, dot_zeta_T = %f, dot_xi_T = %f\r\n", xi_T, dot_zeta_T, dot_xi_T);
+				lvlog.Printf("ddot_zeta_GT = %f, ddot_xi_GT = %f\r\n", ddot_zeta_GT, ddot_xi_GT);
 
 				// LVDC_GP_PC = 30; // STOP
 			}else{
 				// UNROTATED TERMINAL CONDITIONS (into-orbit)
-				fprintf(lvlog,"UNROTATED TERMINAL CONDITIONS\r\n");
+				lvlog.Printf("UNROTATED TERMINAL CONDITIONS\r\n");
 				xi_T = R_T;					
 				dot_zeta_T = V_T * (cos(gamma_T));
 				dot_xi_T = V_T * (sin(gamma_T));
 				ddot_zeta_GT = 0;
 				ddot_xi_GT = G_T;
-				fprintf(lvlog,"xi_T = %f, dot_zeta_T = %f, dot_xi_T = %f\r\n",xi_T,dot_zeta_T,dot_xi_T);
-				fprintf(lvlog,"ddot_zeta_GT = %f, ddot_xi_GT = %f\r\n",ddot_zeta_GT,ddot_xi_GT);
+				lvlog.Printf("xi_T = %f, dot_zeta_T = %f, dot_xi_T = %f\r\n",xi_T,dot_zeta_T,dot_xi_T);
+				lvlog.Printf("ddot_zeta_GT = %f, ddot_xi_GT = %f\r\n",ddot_zeta_GT,ddot_xi_GT);
 			}
 			// ROTATION TO TERMINAL COORDINATES
-			fprintf(lvlog,"--- ROTATION TO TERMINAL COORDINATES ---\r\n");
+			lvlog.Printf("--- ROTATION TO TERMINAL COORDINATES ---\r\n");
 			// This is the last time PosS is referred to.
 			MX_phi_T.m11 = (cos(phi_T));    MX_phi_T.m12 = 0; MX_phi_T.m13 = ((sin(phi_T)));
 			MX_phi_T.m21 = 0;               MX_phi_T.m22 = 1; MX_phi_T.m23 = 0;
 			MX_phi_T.m31 = (-sin(phi_T)); MX_phi_T.m32 = 0; MX_phi_T.m33 = (cos(phi_T));
-			fprintf(lvlog,"MX_phi_T R1 = %f %f %f\r\n",MX_phi_T.m11,MX_phi_T.m12,MX_phi_T.m13);
-			fprintf(lvlog,"MX_phi_T R2 = %f %f %f\r\n",MX_phi_T.m21,MX_phi_T.m22,MX_phi_T.m23);
-			fprintf(lvlog,"MX_phi_T R3 = %f %f %f\r\n",MX_phi_T.m31,MX_phi_T.m32,MX_phi_T.m33);
+			lvlog.Printf("MX_phi_T R1 = %f %f %f\r\n",MX_phi_T.m11,MX_phi_T.m12,MX_phi_T.m13);
+			lvlog.Printf("MX_phi_T R2 = %f %f %f\r\n",MX_phi_T.m21,MX_phi_T.m22,MX_phi_T.m23);
+			lvlog.Printf("MX_phi_T R3 = %f %f %f\r\n",MX_phi_T.m31,MX_phi_T.m32,MX_phi_T.m33);
 
 			MX_K = mul(MX_phi_T,MX_G);
-			fprintf(lvlog,"MX_K R1 = %f %f %f\r\n",MX_K.m11,MX_K.m12,MX_K.m13);
-			fprintf(lvlog,"MX_K R2 = %f %f %f\r\n",MX_K.m21,MX_K.m22,MX_K.m23);
-			fprintf(lvlog,"MX_K R3 = %f %f %f\r\n",MX_K.m31,MX_K.m32,MX_K.m33);
+			lvlog.Printf("MX_K R1 = %f %f %f\r\n",MX_K.m11,MX_K.m12,MX_K.m13);
+			lvlog.Printf("MX_K R2 = %f %f %f\r\n",MX_K.m21,MX_K.m22,MX_K.m23);
+			lvlog.Printf("MX_K R3 = %f %f %f\r\n",MX_K.m31,MX_K.m32,MX_K.m33);
 
 			PosXEZ = mul(MX_K,PosS);
 			DotXEZ = mul(MX_K,DotS);	
-			fprintf(lvlog,"PosXEZ = %f %f %f\r\n",PosXEZ.x,PosXEZ.y,PosXEZ.z);
-			fprintf(lvlog,"DotXEZ = %f %f %f\r\n",DotXEZ.x,DotXEZ.y,DotXEZ.z);
+			lvlog.Printf("PosXEZ = %f %f %f\r\n",PosXEZ.x,PosXEZ.y,PosXEZ.z);
+			lvlog.Printf("DotXEZ = %f %f %f\r\n",DotXEZ.x,DotXEZ.y,DotXEZ.z);
 
 			VECTOR3 RTT_T1,RTT_T2;
 			RTT_T1.x = ddot_xi_GT; RTT_T1.y = 0;        RTT_T1.z = ddot_zeta_GT;
 			RTT_T2 = ddotG_act;
-			fprintf(lvlog,"RTT_T1 = %f %f %f\r\n",RTT_T1.x,RTT_T1.y,RTT_T1.z);
-			fprintf(lvlog,"RTT_T2 = %f %f %f\r\n",RTT_T2.x,RTT_T2.y,RTT_T2.z);
+			lvlog.Printf("RTT_T1 = %f %f %f\r\n",RTT_T1.x,RTT_T1.y,RTT_T1.z);
+			lvlog.Printf("RTT_T2 = %f %f %f\r\n",RTT_T2.x,RTT_T2.y,RTT_T2.z);
 
 			RTT_T2 = mul(MX_K,RTT_T2);
-			fprintf(lvlog,"RTT_T2 (mul) = %f %f %f\r\n",RTT_T2.x,RTT_T2.y,RTT_T2.z);
+			lvlog.Printf("RTT_T2 (mul) = %f %f %f\r\n",RTT_T2.x,RTT_T2.y,RTT_T2.z);
 
 			RTT_T1 = RTT_T1+RTT_T2;	  
-			fprintf(lvlog,"RTT_T1 (add) = %f %f %f\r\n",RTT_T1.x,RTT_T1.y,RTT_T1.z);
+			lvlog.Printf("RTT_T1 (add) = %f %f %f\r\n",RTT_T1.x,RTT_T1.y,RTT_T1.z);
 
 			DDotXEZ_G  = _V(0.5*RTT_T1.x, 0.5*RTT_T1.y, 0.5*RTT_T1.z);
-			fprintf(lvlog,"ddot_XEZ_G = %f %f %f\r\n", DDotXEZ_G.x, DDotXEZ_G.y, DDotXEZ_G.z);
+			lvlog.Printf("ddot_XEZ_G = %f %f %f\r\n", DDotXEZ_G.x, DDotXEZ_G.y, DDotXEZ_G.z);
 
 			// ESTIMATED TIME-TO-GO
-			fprintf(lvlog,"--- ESTIMATED TIME-TO-GO ---\r\n");
+			lvlog.Printf("--- ESTIMATED TIME-TO-GO ---\r\n");
 
 			dot_dxit   = dot_xi_T - DotXEZ.x - (DDotXEZ_G.x*Tt_T);
 			dot_detat  = -DotXEZ.y - (DDotXEZ_G.y * Tt_T);
 			dot_dzetat = dot_zeta_T - DotXEZ.z - (DDotXEZ_G.z * Tt_T);
-			fprintf(lvlog,"dot_XEZt = %f %f %f\r\n",dot_dxit,dot_detat,dot_dzetat);
+			lvlog.Printf("dot_XEZt = %f %f %f\r\n",dot_dxit,dot_detat,dot_dzetat);
 			dV = pow((pow(dot_dxit,2)+pow(dot_detat,2)+pow(dot_dzetat,2)),0.5);
 			dL_3 = (((pow(dot_dxit,2)+pow(dot_detat,2)+pow(dot_dzetat,2))/Lt_Y)-Lt_Y)/2;
 			// if(dL_3 < 0){ sprintf(oapiDebugString(),"Est TTG: dL_3 %f (X/E/Z %f %f %f) @ Cycle %d (TB%d+%f)",dL_3,dot_dxit,dot_detat,dot_dzetat,IGMCycle,LVDC_Timebase,LVDC_TB_ETime);
@@ -5991,30 +6009,30 @@ gtupdate:	// Target of jump from further down
 			dT_3 = (dL_3*(tau3-Tt_3))/V_ex3;
 			T_3 = Tt_3 + dT_3;
 			T_T = Tt_T + dT_3;
-			fprintf(lvlog,"dV = %f, dL_3 = %f, dT_3 = %f, T_3 = %f, T_T = %f\r\n",dV,dL_3,dT_3,T_3,T_T);
+			lvlog.Printf("dV = %f, dL_3 = %f, dT_3 = %f, T_3 = %f, T_T = %f\r\n",dV,dL_3,dT_3,T_3,T_T);
 
 			// TARGET PARAMETER UPDATE
 			if(!(UP > 0)){	
-				fprintf(lvlog,"--- TARGET PARAMETER UPDATE ---\r\n");
+				lvlog.Printf("--- TARGET PARAMETER UPDATE ---\r\n");
 				UP = 1; 
 				Tt_3 = T_3;
 				Tt_T = T_T;
-				fprintf(lvlog,"UP = 1, Tt_3 = %f, Tt_T = %f\r\n",Tt_3,Tt_T);
+				lvlog.Printf("UP = 1, Tt_3 = %f, Tt_T = %f\r\n",Tt_3,Tt_T);
 				Lt_3 = Lt_3 + dL_3;
 				Lt_Y = Lt_Y + dL_3;
 				Jt_3 = Jt_3 + (dL_3*T_3);
-				fprintf(lvlog,"Lt_3 = %f, Lt_Y = %f, Jt_3 = %f\r\n",Lt_3,Lt_Y,Jt_3);
+				lvlog.Printf("Lt_3 = %f, Lt_Y = %f, Jt_3 = %f\r\n",Lt_3,Lt_Y,Jt_3);
 
 				// NOTE: This is perfectly valid. Just because Dijkstra and Wirth think otherwise
 				// does not mean it's gospel. I shouldn't have to defend my choice of instructions
 				// because a bunch of people read the title of the paper with no context and take
 				// it as a direct revelation from God with no further study into the issue.
-				fprintf(lvlog,"RECYCLE\r\n");
+				lvlog.Printf("RECYCLE\r\n");
 				goto gtupdate; // Recycle. 
 			}
 
 			// tchi_y AND tchi_p CALCULATIONS
-			fprintf(lvlog,"--- tchi_y/p CALCULATION ---\r\n");
+			lvlog.Printf("--- tchi_y/p CALCULATION ---\r\n");
 
 			L_3 = Lt_3 + dL_3;
 			J_3 = Jt_3 + (dL_3*T_3);
@@ -6022,14 +6040,14 @@ gtupdate:	// Target of jump from further down
 			Q_3 = (S_3*tau3)-((V_ex3*pow(T_3,2))/2);
 			P_3 = (J_3*(tau3+(2*T_1c)))-((V_ex3*pow(T_3,2))/2);
 			U_3 = (Q_3*(tau3+(2*T_1c)))-((V_ex3*pow(T_3,3))/6);
-			fprintf(lvlog,"L_3 = %f, J_3 = %f, S_3 = %f, Q_3 = %f, P_3 = %f, U_3 = %f\r\n",L_3,J_3,S_3,Q_3,P_3,U_3);
+			lvlog.Printf("L_3 = %f, J_3 = %f, S_3 = %f, Q_3 = %f, P_3 = %f, U_3 = %f\r\n",L_3,J_3,S_3,Q_3,P_3,U_3);
 
 			// This is where velocity-to-be-gained is generated.
 
 			dot_dxi   = dot_dxit   - (DDotXEZ_G.x   * dT_3);
 			dot_deta  = dot_detat  - (DDotXEZ_G.y  * dT_3);
 			dot_dzeta = dot_dzetat - (DDotXEZ_G.z * dT_3);
-			fprintf(lvlog,"dot_dXEZ = %f %f %f\r\n",dot_dxi,dot_deta,dot_dzeta);
+			lvlog.Printf("dot_dXEZ = %f %f %f\r\n",dot_dxi,dot_deta,dot_dzeta);
 
 			//				sprintf(oapiDebugString(),".dxi = %f | .deta %f | .dzeta %f | dT3 %f",
 			//					dot_dxi,dot_deta,dot_dzeta,dT_3);
@@ -6040,12 +6058,12 @@ gtupdate:	// Target of jump from further down
 			tchi_y = atan2(dot_deta,pow(pow(dot_dxi,2)+pow(dot_dzeta,2),0.5));
 			tchi_p = atan2(dot_dxi,dot_dzeta);				
 			UP = -1;
-			fprintf(lvlog,"L_Y = %f, tchi_y = %f, tchi_p = %f, UP = -1\r\n",L_Y,tchi_y,tchi_p);
+			lvlog.Printf("L_Y = %f, tchi_y = %f, tchi_p = %f, UP = -1\r\n",L_Y,tchi_y,tchi_p);
 
 			// *** END OF CHI-TILDE LOGIC ***
 			// Is it time for chi-tilde mode?
 			if(Tt_T <= eps_2){
-				fprintf(lvlog,"CHI BAR STERRING ON, REMOVE ALTITUDE CONSTRAINS (K_1-4 = 0)\r\n");
+				lvlog.Printf("CHI BAR STERRING ON, REMOVE ALTITUDE CONSTRAINS (K_1-4 = 0)\r\n");
 				// Yes
 				// Go to the test that we would be testing if HSL was true
 				K_1 = 0; K_2 = 0; K_3 = 0; K_4 = 0;
@@ -6055,58 +6073,58 @@ gtupdate:	// Target of jump from further down
 			}else{
 				// No.
 				// YAW STEERING PARAMETERS
-				fprintf(lvlog,"--- YAW STEERING PARAMETERS ---\r\n");
+				lvlog.Printf("--- YAW STEERING PARAMETERS ---\r\n");
 
 				J_Y = J_12 + J_3 + (L_3*T_1c);
 				S_Y = S_12 - J_3 + (L_Y*T_3);
 				Q_Y = Q_12 + Q_3 + (S_3*T_1c) + ((T_c+T_3)*J_12);
 				K_Y = L_Y/J_Y;
 				D_Y = S_Y - (K_Y*Q_Y);
-				fprintf(lvlog,"J_Y = %f, S_Y = %f, Q_Y = %f, K_Y = %f, D_Y = %f\r\n",J_Y,S_Y,Q_Y,K_Y,D_Y);
+				lvlog.Printf("J_Y = %f, S_Y = %f, Q_Y = %f, K_Y = %f, D_Y = %f\r\n",J_Y,S_Y,Q_Y,K_Y,D_Y);
 
 				deta = PosXEZ.y + (DotXEZ.y*T_T) + ((DDotXEZ_G.y*pow(T_T,2))/2) + (S_Y*(sin(tchi_y)));
 				K_3 = deta/(D_Y*(cos(tchi_y)));
 				K_4 = K_Y*K_3;
-				fprintf(lvlog,"deta = %f, K_3 = %f, K_4 = %f\r\n",deta,K_3,K_4);
+				lvlog.Printf("deta = %f, K_3 = %f, K_4 = %f\r\n",deta,K_3,K_4);
 
 				// PITCH STEERING PARAMETERS
-				fprintf(lvlog,"--- PITCH STEERING PARAMETERS ---\r\n");
+				lvlog.Printf("--- PITCH STEERING PARAMETERS ---\r\n");
 
 				L_P = L_Y*cos(tchi_y);
 				C_2 = cos(tchi_y)+(K_3*sin(tchi_y));
 				C_4 = K_4*sin(tchi_y);
 				J_P = (J_Y*C_2) - (C_4*(P_12+P_3+(pow(T_1c,2)*L_3)));
-				fprintf(lvlog,"L_P = %f, C_2 = %f, C_4 = %f, J_P = %f\r\n",L_P,C_2,C_4,J_P);
+				lvlog.Printf("L_P = %f, C_2 = %f, C_4 = %f, J_P = %f\r\n",L_P,C_2,C_4,J_P);
 
 				S_P = (S_Y*C_2) - (C_4*Q_Y);
 				Q_P = (Q_Y*C_2) - (C_4*(U_12+U_3+(pow(T_1c,2)*S_3)+((T_3+T_c)*P_12)));
 				K_P = L_P/J_P;
 				D_P = S_P - (K_P*Q_P);
-				fprintf(lvlog,"S_P = %f, Q_P = %f, K_P = %f, D_P = %f\r\n",S_P,Q_P,K_P,D_P);
+				lvlog.Printf("S_P = %f, Q_P = %f, K_P = %f, D_P = %f\r\n",S_P,Q_P,K_P,D_P);
 
 				dxi = PosXEZ.x - xi_T + (DotXEZ.x*T_T) + ((DDotXEZ_G.x*pow(T_T,2))/2) + (S_P*(sin(tchi_p)));
 				K_1 = dxi/(D_P*cos(tchi_p));
 				K_2 = K_P*K_1;
-				fprintf(lvlog,"dxi = %f, K_1 = %f, K_2 = %f, cos(tchi_p) = %f\r\n",dxi,K_1,K_2,cos(tchi_p));
+				lvlog.Printf("dxi = %f, K_1 = %f, K_2 = %f, cos(tchi_p) = %f\r\n",dxi,K_1,K_2,cos(tchi_p));
 			}
 		}else{
 hsl:		// HIGH-SPEED LOOP ENTRY				
 			// CUTOFF VELOCITY EQUATIONS
-			fprintf(lvlog,"--- CUTOFF VELOCITY EQUATIONS ---\r\n");
+			lvlog.Printf("--- CUTOFF VELOCITY EQUATIONS ---\r\n");
 			V_0 = V_1;
 			V_1 = V_2;
 			//V_2 = 0.5 * (V+(pow(V_1,2)/V));
 			V_2 = V;
 			dtt_1 = dtt_2;
 			dtt_2 = dt_c;					
-			fprintf(lvlog,"V = %f, Tt_t = %f\r\n",V,Tt_T);
-			fprintf(lvlog,"V = %f, V_0 = %f, V_1 = %f, V_2 = %f, dtt_1 = %f, dtt_2 = %f\r\n",V,V_0,V_1,V_2,dtt_1,dtt_2);
+			lvlog.Printf("V = %f, Tt_t = %f\r\n",V,Tt_T);
+			lvlog.Printf("V = %f, V_0 = %f, V_1 = %f, V_2 = %f, dtt_1 = %f, dtt_2 = %f\r\n",V,V_0,V_1,V_2,dtt_1,dtt_2);
 			if(Tt_T <= eps_4 && V + V_TC >= V_T){
-				fprintf(lvlog,"--- HI SPEED LOOP ---\r\n");
+				lvlog.Printf("--- HI SPEED LOOP ---\r\n");
 				// TGO CALCULATION
-				fprintf(lvlog,"--- TGO CALCULATION ---\r\n");
+				lvlog.Printf("--- TGO CALCULATION ---\r\n");
 				if(GATE5 == false){
-					fprintf(lvlog,"CHI FREEZE\r\n");
+					lvlog.Printf("CHI FREEZE\r\n");
 					// CHI FREEZE
 					tchi_y = tchi_y_last;
 					tchi_p = tchi_p_last;
@@ -6114,10 +6132,10 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 					HSL = true;
 					GATE5 = true;
 					T_GO = T_3;
-					fprintf(lvlog,"HSL = true, GATE5 = true, T_GO = %f\r\n",T_GO);
+					lvlog.Printf("HSL = true, GATE5 = true, T_GO = %f\r\n",T_GO);
 				}
 				if(BOOST == true){
-					fprintf(lvlog,"BOOST-TO-ORBIT ACTIVE\r\n");
+					lvlog.Printf("BOOST-TO-ORBIT ACTIVE\r\n");
 					// dT_4 CALCULATION
 					if (LVDC_Timebase == 40)
 					{
@@ -6129,37 +6147,37 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 					}
 					dT_4 = TAS-t_3i-T_4N;
 					//dT_4 = t_3i - T_4N;
-					fprintf(lvlog,"t_3i = %f, dT_4 = %f\r\n",t_3i,dT_4);
+					lvlog.Printf("t_3i = %f, dT_4 = %f\r\n",t_3i,dT_4);
 					if(fabs(dT_4) <= dT_LIM){							
 						dTt_4 = dT_4;
 					}else{
-						fprintf(lvlog,"dTt_4 CLAMPED\r\n");
+						lvlog.Printf("dTt_4 CLAMPED\r\n");
 						dTt_4 = dT_LIM;
 					}
-					fprintf(lvlog,"dTt_4 = %f\r\n",dTt_4);
+					lvlog.Printf("dTt_4 = %f\r\n",dTt_4);
 				}else{
 					// TRANSLUNAR INJECTION VELOCITY
-					fprintf(lvlog,"TRANSLUNAR INJECTION\r\n");
+					lvlog.Printf("TRANSLUNAR INJECTION\r\n");
 					double dotR = dotp(PosS, DotS) / R;
 					R_T = R + dotR*(T_3 - dt);
 					V_T = sqrt(C_3 + 2.0*mu / R_T);
 					dV_B = dV_BR;
 					//sprintf(oapiDebugString(),"LVDC: HISPEED LOOP, TLI VELOCITY: %f %f %f %f %f",Tt_T,eps_4,V,V_TC,V_T);
-					fprintf(lvlog, "TLI VELOCITY: Tt_T: %f, eps_4: %f, V: %f, V_TC: %f, V_T: %f\r\n", Tt_T, eps_4, V, V_TC, V_T);
+					lvlog.Printf("TLI VELOCITY: Tt_T: %f, eps_4: %f, V: %f, V_TC: %f, V_T: %f\r\n", Tt_T, eps_4, V, V_TC, V_T);
 					// LVDC_GP_PC = 30; // STOP
 				}
 				// TGO DETERMINATION
-				fprintf(lvlog,"--- TGO DETERMINATION ---\r\n");
+				lvlog.Printf("--- TGO DETERMINATION ---\r\n");
 
 				a_2 = (((V_2-V_1)*dtt_1)-((V_1-V_0)*dtt_2))/(dtt_2*dtt_1*(dtt_2+dtt_1));
 				a_1 = ((V_2-V_1)/dtt_2)+(a_2*dtt_2);
 				T_GO = ((V_T-dV_B)-V_2)/(a_1+a_2*T_GO);
 				T_CO = TAS+T_GO;
-				fprintf(lvlog,"a_2 = %f, a_1 = %f, T_GO = %f, T_CO = %f, V_T = %f\r\n",a_2,a_1,T_GO,T_CO,V_T);
+				lvlog.Printf("a_2 = %f, a_1 = %f, T_GO = %f, T_CO = %f, V_T = %f\r\n",a_2,a_1,T_GO,T_CO,V_T);
 
 				// S4B CUTOFF?
 				if(S4B_IGN == false && (LVDC_Timebase < 6 || LVDC_Timebase == 40)){
-					fprintf(lvlog,"*** HSL EXIT SETTINGS ***\r\n");
+					lvlog.Printf("*** HSL EXIT SETTINGS ***\r\n");
 					GATE = false;
 					GATE5 = false;
 					Tt_T = 1000;
@@ -6169,7 +6187,7 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 				}
 				// S4B 2ND CUTOFF?
 				if(S4B_REIGN == false && (LVDC_Timebase >= 6 && LVDC_Timebase != 40)) {
-					fprintf(lvlog, "*** HSL EXIT SETTINGS ***\r\n");
+					lvlog.Printf("*** HSL EXIT SETTINGS ***\r\n");
 					GATE = false;
 					GATE5 = false;
 					Tt_T = 1000;
@@ -6184,7 +6202,7 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 			// End of high-speed loop
 		}
 		// GUIDANCE TIME UPDATE
-		fprintf(lvlog,"--- GUIDANCE TIME UPDATE ---\r\n");
+		lvlog.Printf("--- GUIDANCE TIME UPDATE ---\r\n");
 		if(BOOST){
 			if(S4B_IGN){
 				T_3 = T_3 - dt_c;
@@ -6199,16 +6217,16 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 							T_2 = T_2 - dt_c;
 						}else{
 							// Here if t_B1 is bigger.
-							fprintf(lvlog,"t_B1 = %f, t_B3 = %f\r\n",t_B1,t_B3);
+							lvlog.Printf("t_B1 = %f, t_B3 = %f\r\n",t_B1,t_B3);
 							T_1 = (((dotM_1*(t_B3-t_B1))-(dotM_2*t_B3))*dt)/(dotM_1*t_B1);
 						}
 					}
 				}
 			}
-			fprintf(lvlog,"T_1 = %f, T_2 = %f, T_3 = %f, T_c = %f dt_c = %f\r\n",T_1,T_2,T_3,T_c,dt_c);
+			lvlog.Printf("T_1 = %f, T_2 = %f, T_3 = %f, T_c = %f dt_c = %f\r\n",T_1,T_2,T_3,T_c,dt_c);
 		}else{
 			// MRS TEST
-			fprintf(lvlog,"MRS TEST\r\n");
+			lvlog.Printf("MRS TEST\r\n");
 			//sprintf(oapiDebugString(),"LVDC: MRS TEST");
 			if (MRS)
 			{
@@ -6225,26 +6243,26 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 			{
 				T_2 = T_2 - dt_c;
 			}
-			fprintf(lvlog, "T_2 = %f, T_3 = %f, dt_c = %f\r\n", T_2, T_3, dt_c);
+			lvlog.Printf("T_2 = %f, T_3 = %f, dt_c = %f\r\n", T_2, T_3, dt_c);
 			// LVDC_GP_PC = 30; // STOP
 		}
 		Tt_3 = T_3;
 		T_1c = T_1+T_2+T_c;			
 		Tt_T = T_1c+Tt_3;
-		fprintf(lvlog,"Tt_3 = %f, T_1c = %f, Tt_T = %f\r\n",Tt_3,T_1c,Tt_T);
+		lvlog.Printf("Tt_3 = %f, T_1c = %f, Tt_T = %f\r\n",Tt_3,T_1c,Tt_T);
 		if(GATE){
 			// FREEZE CHI
-			fprintf(lvlog,"Thru GATE; CHI FREEZE\r\n");
+			lvlog.Printf("Thru GATE; CHI FREEZE\r\n");
 			//sprintf(oapiDebugString(),"LVDC: CHI FREEZE");
 			goto minorloop;
 		}else{
 			// IGM STEERING ANGLES
-			fprintf(lvlog,"--- IGM STEERING ANGLES ---\r\n");
+			lvlog.Printf("--- IGM STEERING ANGLES ---\r\n");
 
 			//sprintf(oapiDebugString(),"IGM: K_1 %f K_2 %f K_3 %f K_4 %f",K_1,K_2,K_3,K_4);
 			Xtt_y = ((tchi_y) - K_3 + (K_4 * t));
 			Xtt_p = ((tchi_p) - K_1 + (K_2 * t));
-			fprintf(lvlog,"Xtt_y = %f, Xtt_p = %f\r\n",Xtt_y,Xtt_p);
+			lvlog.Printf("Xtt_y = %f, Xtt_p = %f\r\n",Xtt_y,Xtt_p);
 
 			// -- COMPUTE INVERSE OF [K] --
 			// Get Determinate
@@ -6252,7 +6270,7 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 						- MX_K.m12 * ((MX_K.m21*MX_K.m33) - (MX_K.m31*MX_K.m23))
 						+ MX_K.m13 * ((MX_K.m21*MX_K.m32) - (MX_K.m31*MX_K.m22));
 			// If the determinate is less than 0.0005, this is invalid.
-			fprintf(lvlog,"det = %f (LESS THAN 0.0005 IS INVALID)\r\n",det);
+			lvlog.Printf("det = %f (LESS THAN 0.0005 IS INVALID)\r\n",det);
 
 			MATRIX3 MX_Ki; // TEMPORARY: Inverse of [K]
 			MX_Ki.m11 =   ((MX_K.m22*MX_K.m33) - (MX_K.m23*MX_K.m32))  / det;
@@ -6264,30 +6282,30 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 			MX_Ki.m31 =   ((MX_K.m21*MX_K.m32) - (MX_K.m22*MX_K.m31))  / det;
 			MX_Ki.m32 =   ((MX_K.m12*MX_K.m31) - (MX_K.m11*MX_K.m32))  / det;
 			MX_Ki.m33 =   ((MX_K.m11*MX_K.m22) - (MX_K.m12*MX_K.m21))  / det;
-			fprintf(lvlog,"MX_Ki R1 = %f %f %f\r\n",MX_Ki.m11,MX_Ki.m12,MX_Ki.m13);
-			fprintf(lvlog,"MX_Ki R2 = %f %f %f\r\n",MX_Ki.m21,MX_Ki.m22,MX_Ki.m23);
-			fprintf(lvlog,"MX_Ki R3 = %f %f %f\r\n",MX_Ki.m31,MX_Ki.m32,MX_Ki.m33);
+			lvlog.Printf("MX_Ki R1 = %f %f %f\r\n",MX_Ki.m11,MX_Ki.m12,MX_Ki.m13);
+			lvlog.Printf("MX_Ki R2 = %f %f %f\r\n",MX_Ki.m21,MX_Ki.m22,MX_Ki.m23);
+			lvlog.Printf("MX_Ki R3 = %f %f %f\r\n",MX_Ki.m31,MX_Ki.m32,MX_Ki.m33);
 
 			// Done
 			VECTOR3 VT; 
 			VT.x = (sin(Xtt_p)*cos(Xtt_y));
 			VT.y = (sin(Xtt_y));
 			VT.z = (cos(Xtt_p)*cos(Xtt_y));
-			fprintf(lvlog,"VT (set) = %f %f %f\r\n",VT.x,VT.y,VT.z);
+			lvlog.Printf("VT (set) = %f %f %f\r\n",VT.x,VT.y,VT.z);
 
 			VT = mul(MX_Ki,VT);
-			fprintf(lvlog,"VT (mul) = %f %f %f\r\n",VT.x,VT.y,VT.z);
+			lvlog.Printf("VT (mul) = %f %f %f\r\n",VT.x,VT.y,VT.z);
 
 			X_S1 = VT.x;
 			X_S2 = VT.y;
 			X_S3 = VT.z;
-			fprintf(lvlog,"X_S1-3 = %f %f %f\r\n",X_S1,X_S2,X_S3);
+			lvlog.Printf("X_S1-3 = %f %f %f\r\n",X_S1,X_S2,X_S3);
 
 			// FINALLY - COMMANDS!
 			X_Zi = asin(X_S2);			// Yaw
 			X_Yi = atan2(-X_S3,X_S1);	// Pitch
-			fprintf(lvlog,"*** COMMAND ISSUED ***\r\n");
-			fprintf(lvlog,"PITCH = %f, YAW = %f\r\n\r\n",X_Yi*DEG,X_Zi*DEG);
+			lvlog.Printf("*** COMMAND ISSUED ***\r\n");
+			lvlog.Printf("PITCH = %f, YAW = %f\r\n\r\n",X_Yi*DEG,X_Zi*DEG);
 			// IGM is supposed to generate attitude directly.
 			CommandedAttitude.x = 360 * RAD;    // ROLL
 			CommandedAttitude.y = X_Yi; // PITCH
@@ -6297,7 +6315,7 @@ hsl:		// HIGH-SPEED LOOP ENTRY
 
 orbitalguidance: 
 		//orbital guidance logic
-		fprintf(lvlog,"*** ORBITAL GUIDANCE ***\r\n");
+		lvlog.Printf("*** ORBITAL GUIDANCE ***\r\n");
 		if(TAS-TB7<0){
 			if(TAS-TB6<0){
 				if(TAS-TB5-TA1 >= 0){
@@ -6306,24 +6324,24 @@ orbitalguidance:
 						if(INH2){
 							alpha_1 = 0 * RAD;
 							CommandedAttitude.x = 360 * RAD;
-							fprintf(lvlog, "inhibit attitude hold, maintain orbrate\r\n");
+							lvlog.Printf("inhibit attitude hold, maintain orbrate\r\n");
 							goto orbatt;
 						}else{
 							CommandedAttitude = ACommandedAttitude;
-							fprintf(lvlog, "Attitude hold\r\n");
+							lvlog.Printf("Attitude hold\r\n");
 							goto minorloop;
 						}
 					}else{
 						if(INH1){
 							alpha_1 = 0 * RAD;
 							CommandedAttitude.x = 360 * RAD;
-							fprintf(lvlog, "No pitch down, maintain orbrate\r\n");
+							lvlog.Printf("No pitch down, maintain orbrate\r\n");
 							goto orbatt;
 						}else{
 							alpha_1 = XLunarAttitude.y;
 							alpha_2 = XLunarAttitude.z;
 							CommandedAttitude.x = XLunarAttitude.x;
-							fprintf(lvlog, "Pitch down\r\n");
+							lvlog.Printf("Pitch down\r\n");
 							goto orbatt;
 						}
 					}
@@ -6355,7 +6373,7 @@ orbitalguidance:
 				{	
 					//attitude hold for T&D
 					CommandedAttitude = ACommandedAttitude;
-					fprintf(lvlog, "T&D attitude hold\r\n");
+					lvlog.Printf("T&D attitude hold\r\n");
 					goto minorloop;
 				}
 				else
@@ -6365,7 +6383,7 @@ orbitalguidance:
 					alpha_2 = XLunarAttitude.z;
 					CommandedAttitude.x = XLunarAttitude.x;
 					GATE6 = true;
-					fprintf(lvlog, "T&D attitude\r\n");
+					lvlog.Printf("T&D attitude\r\n");
 					goto orbatt;
 				}
 			}
@@ -6397,21 +6415,21 @@ orbatt: Pos4 = mul(MX_G,PosS); //here we compute the steering angles...
 		VT.x = (cos_chi_Yit * cos_chi_Zit);
 		VT.y = (sin_chi_Zit);
 		VT.z = (-sin_chi_Yit * cos_chi_Zit);
-		fprintf(lvlog,"VT (set) = %f %f %f\r\n",VT.x,VT.y,VT.z);
+		lvlog.Printf("VT (set) = %f %f %f\r\n",VT.x,VT.y,VT.z);
 
 		VT = mul(MX_Gi,VT);
-		fprintf(lvlog,"VT (mul) = %f %f %f\r\n",VT.x,VT.y,VT.z);
+		lvlog.Printf("VT (mul) = %f %f %f\r\n",VT.x,VT.y,VT.z);
 
 		X_S1 = VT.x;
 		X_S2 = VT.y;
 		X_S3 = VT.z;
-		fprintf(lvlog,"X_S1-3 = %f %f %f\r\n",X_S1,X_S2,X_S3);
+		lvlog.Printf("X_S1-3 = %f %f %f\r\n",X_S1,X_S2,X_S3);
 
 		// FINALLY - COMMANDS!
 		X_Zi = asin(X_S2);			// Yaw
 		X_Yi = atan2(-X_S3,X_S1);	// Pitch
-		fprintf(lvlog,"*** COMMAND ISSUED ***\r\n");
-		fprintf(lvlog,"PITCH = %f, YAW = %f\r\n\r\n",X_Yi*DEG,X_Zi*DEG);
+		lvlog.Printf("*** COMMAND ISSUED ***\r\n");
+		lvlog.Printf("PITCH = %f, YAW = %f\r\n\r\n",X_Yi*DEG,X_Zi*DEG);
 		CommandedAttitude.y = X_Yi; // PITCH
 		CommandedAttitude.z = X_Zi; // YAW;
 		ACommandedAttitude = CommandedAttitude;
@@ -6437,7 +6455,7 @@ restartprep:
 					{
 						tgt_index++;
 					}
-					fprintf(lvlog, "Target index = %d \r\n", tgt_index);
+					lvlog.Printf("Target index = %d \r\n", tgt_index);
 
 					double tdint0, tdint1;
 
@@ -6450,8 +6468,8 @@ restartprep:
 					cos_sigma = LinInter(tdint0, tdint1, TABLE15[1].target[tgt_index - 1].cos_sigma, TABLE15[1].target[tgt_index].cos_sigma, t_D);
 					e_N = LinInter(tdint0, tdint1, TABLE15[1].target[tgt_index - 1].e_N, TABLE15[1].target[tgt_index].e_N, t_D);
 
-					fprintf(lvlog, "Selected TLI Targeting Parameters (Second Opportunity): \r\n");
-					fprintf(lvlog, "RAS: %f, DEC: %f, C_3 = %f, cos_sigma = %f, e_N = %f \r\n", RAS*DEG, DEC*DEG, C_3, cos_sigma, e_N);
+					lvlog.Printf("Selected TLI Targeting Parameters (Second Opportunity): \r\n");
+					lvlog.Printf("RAS: %f, DEC: %f, C_3 = %f, cos_sigma = %f, e_N = %f \r\n", RAS*DEG, DEC*DEG, C_3, cos_sigma, e_N);
 
 					f = TABLE15[1].f*RAD;
 					beta = TABLE15[1].beta*RAD;
@@ -6470,7 +6488,7 @@ restartprep:
 					{
 						tgt_index++;
 					}
-					fprintf(lvlog, "Target index = %d \r\n", tgt_index);
+					lvlog.Printf("Target index = %d \r\n", tgt_index);
 
 					double tdint0, tdint1;
 
@@ -6483,8 +6501,8 @@ restartprep:
 					cos_sigma = LinInter(tdint0, tdint1, TABLE15[0].target[tgt_index - 1].cos_sigma, TABLE15[0].target[tgt_index].cos_sigma, t_D);
 					e_N = LinInter(tdint0, tdint1, TABLE15[0].target[tgt_index - 1].e_N, TABLE15[0].target[tgt_index].e_N, t_D);
 
-					fprintf(lvlog, "Selected TLI Targeting Parameters (First Opportunity): \r\n");
-					fprintf(lvlog, "RAS: %f, DEC: %f, C_3 = %f, cos_sigma = %f, e_N = %f \r\n", RAS*DEG, DEC*DEG, C_3, cos_sigma, e_N);
+					lvlog.Printf("Selected TLI Targeting Parameters (First Opportunity): \r\n");
+					lvlog.Printf("RAS: %f, DEC: %f, C_3 = %f, cos_sigma = %f, e_N = %f \r\n", RAS*DEG, DEC*DEG, C_3, cos_sigma, e_N);
 
 					f = TABLE15[0].f*RAD;
 					beta = TABLE15[0].beta*RAD;
@@ -6536,7 +6554,7 @@ restartprep:
 					f			True anomaly of transfer ellipse
 					*/
 
-					fprintf(lvlog, "7-parameter update: T_RP: %f, C_3: %f, Inc: %f, e: %f, alpha_D: %f, f: %f, theta_N: %f \r\n", T_RP, C_3, Inclination*DEG, e, alpha_D*DEG, f*DEG, theta_N*DEG);
+					lvlog.Printf("7-parameter update: T_RP: %f, C_3: %f, Inc: %f, e: %f, alpha_D: %f, f: %f, theta_N: %f \r\n", T_RP, C_3, Inclination*DEG, e, alpha_D*DEG, f*DEG, theta_N*DEG);
 
 					alpha_D_op = 0;
 					first_op = false;
@@ -6554,7 +6572,7 @@ restartprep:
 			
 			if (TAS - TB5 - T_ST < 0) //Sufficient time before S*T_P test?
 			{
-				fprintf(lvlog, "Time until first TB6 check = %f \r\n", TAS - TB5 - T_ST);
+				lvlog.Printf("Time until first TB6 check = %f \r\n", TAS - TB5 - T_ST);
 				goto orbitalguidance;
 			}
 
@@ -6635,7 +6653,7 @@ O3precalc:
 			alpha_D = TABLE15[1].target[tgt_index].alpha_D;
 		}
 
-		fprintf(lvlog, "Elliptic parameters: Inc: %f, e: %f, p: %f, theta_N: %f, alpha_D: %f, f: %f\r\n", Inclination*DEG, e, p, theta_N*DEG, alpha_D*DEG, f*DEG);
+		lvlog.Printf("Elliptic parameters: Inc: %f, e: %f, p: %f, theta_N: %f, alpha_D: %f, f: %f\r\n", Inclination*DEG, e, p, theta_N*DEG, alpha_D*DEG, f*DEG);
 
 	O3GMatrix:
 		MX_B = _M(cos(theta_N), 0, sin(theta_N), sin(theta_N)*sin(Inclination), cos(Inclination), -cos(theta_N)*sin(Inclination),
@@ -6647,7 +6665,7 @@ O3precalc:
 		gamma_T = atan((e*sin(f)) / (1.0 + cos(f)));
 		G_T = -mu / pow(R_T, 2);
 
-		fprintf(lvlog, "TLI Targets: R_T: %f, V_T: %f, gamma_T: %f, G_T: %f\r\n", R_T, V_T, gamma_T, G_T);
+		lvlog.Printf("TLI Targets: R_T: %f, V_T: %f, gamma_T: %f, G_T: %f\r\n", R_T, V_T, gamma_T, G_T);
 
 		//Update IGM parameters
 		Ct = 0.0;
@@ -6670,7 +6688,7 @@ O3precalc:
 		eps_4 = eps_4R;
 		tau3 = tau3R - dTt_4;
 
-		fprintf(lvlog, "Tt_3 = %f, dTt_4 = %f\r\n", Tt_3, dTt_4);
+		lvlog.Printf("Tt_3 = %f, dTt_4 = %f\r\n", Tt_3, dTt_4);
 
 		//Bypass further burn calculations
 
@@ -6685,7 +6703,7 @@ minorloop:
 			TB5 = TAS;//-simdt;
 			LVDC_Timebase = 5;
 			LVDC_TB_ETime = 0;
-			fprintf(lvlog,"SIVB CUTOFF! TAS = %f \r\n",TAS);
+			lvlog.Printf("SIVB CUTOFF! TAS = %f \r\n",TAS);
 		}
 		if (T_GO - sinceLastCycle <= 0 && HSL == true && S4B_REIGN == true) {
 			//Time for S4B cutoff? We need to check that here -IGM runs every 2 sec only, but cutoff has to be on the second			
@@ -6693,7 +6711,7 @@ minorloop:
 			TB7 = TAS;//-simdt;
 			LVDC_Timebase = 7;
 			LVDC_TB_ETime = 0;
-			fprintf(lvlog, "SIVB CUTOFF! TAS = %f \r\n", TAS);
+			lvlog.Printf("SIVB CUTOFF! TAS = %f \r\n", TAS);
 			owner->TLI_Ended();
 		}
 
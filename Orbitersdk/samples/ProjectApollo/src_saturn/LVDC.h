@@ -24,6 +24,7 @@
 
 #pragma once
 #include "LVIMU.h"
+#include "flightlog.h"
 class Saturn1b;
 
 /* *******************
@@ -44,6 +45,12 @@ public:
 	void SaveState(FILEHANDLE scn);
 	void LoadState(FILEHANDLE scn);
 
+	///
+	/// \brief Save the LVDC and LV IMU state to an in-memory checkpoint.
+	///
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
+
 	double SVCompare();
 	double LinInter(double x0, double x1, double y0, double y1, double x);
 	LVDCTLIparam GetTLIParams();
@@ -51,7 +58,7 @@ private:
 	Saturn* owner;									// Saturn LV
 	LVIMU lvimu;									// ST-124-M3 IMU (LV version)
 	LVRG lvrg;										// LV rate gyro package
-	FILE* lvlog;									// LV Log file
+	FlightLogFile lvlog;							// LV Log file
 	bool Initialized;								// Clobberness flag
 
 	int LVDC_Timebase;								// Time Base
@@ -429,9 +436,15 @@ public:
 	void TimeStep(double simt, double simdt);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(FILEHANDLE scn);
+
+	///
+	/// \brief Save the LVDC and LV IMU state to an in-memory checkpoint.
+	///
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 private:
 	bool Initialized;								// Clobberness flag
-	FILE* lvlog;									// LV Log file
+	FlightLogFile lvlog;							// LV Log file
 	Saturn* owner;
 	LVIMU lvimu;									// ST-124-M3 IMU (LV version)
 	LVRG lvrg;										// LV rate gyro package
@@ -35,6 +35,8 @@
 #define LVRegPIPAY 004
 #define LVRegPIPAZ 005
 
+class Checkpoint;
+
 ///
 /// \brief Saturn IMU simulation.
 /// \ingroup LVSystems
@@ -61,6 +63,12 @@ public:
 	void LoadState(FILEHANDLE scn);
 	void SaveState(FILEHANDLE scn);
 
+	///
+	/// \brief Save the IMU state to an in-memory checkpoint.
+	///
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
+
 	double CDURegisters[6]; // CDU output registers
 
 protected:
@@ -76,6 +76,12 @@ Saturn1b::~Saturn1b()
 
 {
 	ReleaseSurfaces();
+
+	// Closes the LVDC log
+	if (lvdc) {
+		delete lvdc;
+		lvdc = NULL;
+	}
 }
 
 //
@@ -823,6 +829,15 @@ void Saturn1b::LoadLVDC(FILEHANDLE scn){
 	}
 }
 
+void Saturn1b::SaveLVDCCheckpoint(Checkpoint &cp){
+	cp.Mark(use_lvdc && lvdc != NULL);
+	if (use_lvdc && lvdc != NULL){ lvdc->SaveCheckpoint(cp); }
+}
+
+void Saturn1b::LoadLVDCCheckpoint(Checkpoint &cp){
+	if (cp.Check(use_lvdc && lvdc != NULL) && use_lvdc && lvdc != NULL){ lvdc->LoadCheckpoint(cp); }
+}
+
 void Saturn1b::clbkLoadStateEx (FILEHANDLE scn, void *vs){
 	GetScenarioState(scn, vs);
 
@@ -99,6 +99,7 @@ SaturnV::SaturnV (OBJHANDLE hObj, int fmodel)
 	TRACESETUP("SaturnV");
 	
 	hMaster = hObj;
+	lvdc = NULL;
 	initSaturnV();
 }
 
@@ -210,6 +211,12 @@ SaturnV::~SaturnV()
 	TRACESETUP("~SaturnV");
 
 	ReleaseSurfaces();
+
+	// Closes the LVDC log
+	if (lvdc) {
+		delete lvdc;
+		lvdc = NULL;
+	}
 }
 
 void SaturnV::CalculateStageMass ()
@@ -1263,6 +1270,15 @@ void SaturnV::LoadLVDC(FILEHANDLE scn){
 	}
 }
 
+void SaturnV::SaveLVDCCheckpoint(Checkpoint &cp){
+	cp.Mark(use_lvdc && lvdc != NULL);
+	if (use_lvdc && lvdc != NULL){ lvdc->SaveCheckpoint(cp); }
+}
+
+void SaturnV::LoadLVDCCheckpoint(Checkpoint &cp){
+	if (cp.Check(use_lvdc && lvdc != NULL) && use_lvdc && lvdc != NULL){ lvdc->LoadCheckpoint(cp); }
+}
+
 void SaturnV::clbkLoadStateEx (FILEHANDLE scn, void *status)
 
 {
@@ -45,6 +45,7 @@
 #include "saturn.h"
 #include "sivb.h"
 #include "papi.h"
+#include "PanelSDK/Checkpoint.h"
 
 
 IU::IU()
@@ -1074,6 +1075,28 @@ void IU::LoadState(FILEHANDLE scn)
 	}
 }
 
+void IU::SaveCheckpoint(Checkpoint &cp)
+
+{
+	CHECKPOINT_RANGE(IU, TLIBurnState, FirstTimeStepDone);
+	cp.PutRange(TLIBurnState, FirstTimeStepDone);
+	cp.Put(MissionTime);
+	cp.Put(ExternalGNC);
+	CHECKPOINT_RANGE(IU, AttitudeHold, AttitudeToHold2);
+	cp.PutRange(AttitudeHold, AttitudeToHold2);
+	GNC.SaveCheckpoint(cp);
+}
+
+void IU::LoadCheckpoint(Checkpoint &cp)
+
+{
+	cp.GetRange(TLIBurnState, FirstTimeStepDone);
+	cp.Get(MissionTime);
+	cp.Get(ExternalGNC);
+	cp.GetRange(AttitudeHold, AttitudeToHold2);
+	GNC.LoadCheckpoint(cp);
+}
+
 void IU::ConnectToCSM(Connector *csmConnector)
 
 {
@@ -2365,3 +2388,14 @@ void IUGNC::LoadState(FILEHANDLE scn)
 		papiReadScenario_double(line, "CUTMJD", CutMJD); 
 	}
 }
+
+void IUGNC::SaveCheckpoint(Checkpoint &cp)
+{
+	CHECKPOINT_RANGE(IUGNC, _PIPA, CutMJD);
+	cp.PutRange(_PIPA, CutMJD);
+}
+
+void IUGNC::LoadCheckpoint(Checkpoint &cp)
+{
+	cp.GetRange(_PIPA, CutMJD);
+}
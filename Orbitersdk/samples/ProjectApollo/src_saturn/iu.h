@@ -27,6 +27,7 @@
 
 class SoundLib;
 class IU;
+class Checkpoint;
 
 ///
 /// \ingroup Connectors
@@ -235,6 +236,8 @@ public:
 
 	void LoadState(FILEHANDLE scn);
 	void SaveState(FILEHANDLE scn);
+	void LoadCheckpoint(Checkpoint &cp);
+	void SaveCheckpoint(Checkpoint &cp);
 
 private:
 
@@ -354,6 +357,12 @@ public:
 	void LoadState(FILEHANDLE scn);
 	void SaveState(FILEHANDLE scn);
 
+	///
+	/// \brief Save the IU and its guidance state to an in-memory checkpoint.
+	///
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
+
 protected:
 	bool SIVBStart();
 	void SIVBStop();
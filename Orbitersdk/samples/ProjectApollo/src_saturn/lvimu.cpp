@@ -34,6 +34,7 @@
 #include "nasspdefs.h"
 #include "LVIMU.h"
 #include "papi.h"
+#include "PanelSDK/Checkpoint.h"
 
 LVIMU::LVIMU()
 
@@ -618,6 +619,25 @@ void LVIMU::SaveState(FILEHANDLE scn)
 	oapiWriteLine(scn, LVIMU_END_STRING);
 }
 
+void LVIMU::SaveCheckpoint(Checkpoint &cp)
+
+{
+	cp.Put(CDURegisters);
+	cp.Put(ZeroIMUCDUFlag);
+	cp.Put(CoarseAlignEnableFlag);
+	CHECKPOINT_RANGE(LVIMU, Operate, LastTime);
+	cp.PutRange(Operate, LastTime);
+}
+
+void LVIMU::LoadCheckpoint(Checkpoint &cp)
+
+{
+	cp.Get(CDURegisters);
+	cp.Get(ZeroIMUCDUFlag);
+	cp.Get(CoarseAlignEnableFlag);
+	cp.GetRange(Operate, LastTime);
+}
+
 //
 // These probably don't need to be part of the LV IMU class, but I've put them there
 // for now to avoid touching the normal IMU in case I screw it up.
@@ -97,6 +97,8 @@ protected:
 	void CreateStageOne();
 	void SaveLVDC(FILEHANDLE scn);
 	void LoadLVDC(FILEHANDLE scn);
+	void SaveLVDCCheckpoint(Checkpoint &cp);
+	void LoadLVDCCheckpoint(Checkpoint &cp);
 	void SaveVehicleStats(FILEHANDLE scn);
 	void SeparateStage (int stage);
 	void DoFirstTimestep(double simt);
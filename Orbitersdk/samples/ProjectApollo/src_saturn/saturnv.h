@@ -142,6 +142,8 @@ protected:
 	void SaveVehicleStats(FILEHANDLE scn);
 	void SaveLVDC(FILEHANDLE scn);
 	void LoadLVDC(FILEHANDLE scn);
+	void SaveLVDCCheckpoint(Checkpoint &cp);
+	void LoadLVDCCheckpoint(Checkpoint &cp);
 
 	//
 	// Odds and ends.
@@ -36,7 +36,6 @@
 
 // helper functions
 HBITMAP RotateMemoryDC(HBITMAP hBmpSrc, HDC hdcSrc, int SrcX, int SrcY, float angle, HDC &hdcDst, int &dstX, int &dstY);
-void DrawTransparentBitmap(HDC hdc, HBITMAP hBitmap, short xStart, short yStart, COLORREF cTransparentColor);
 
 FDAI::FDAI() {
 
@@ -55,6 +54,21 @@ FDAI::FDAI() {
 	DCSource = NULL;
 	ACSource = NULL;
 	noAC = false;
+	paintTime = 0;
+
+	hDC2 = NULL;
+	hRC = NULL;
+	ballGL = false;
+	hDCBall = NULL;
+	hBmpBall = NULL;
+	hBmpBall_old = NULL;
+	ballBits = NULL;
+	ballAttitude = _V(0, 0, 0);
+	ballQuit = false;
+
+	hBmpRollSrc = NULL;
+	hDCRollAtlas = NULL;
+	hDCRollMask = NULL;
 }
 
 void FDAI::InitGL() {
@@ -153,16 +167,75 @@ void FDAI::InitGL() {
 	gluQuadricTexture(quadObj, GL_TRUE);
 	gluSphere(quadObj, 12, 24, 24);
 	glEndList();
-
-	init = 1;		//that's it. If we made it so far, we can use OpenGL
 }
 
 FDAI::~FDAI() {
 
 	if (init) {
+		{
+			Lock lock(ballMutex);
+			ballQuit = true;
+		}
+		ballEvent.Raise();
+		Kill();
+
+		SelectObject(hDCBall, hBmpBall_old);
+		DeleteObject(hBmpBall);
+		DeleteDC(hDCBall);
+		hDCBall = 0;
+	}
+	ReleaseRollAtlas();
+}
+
+//
+// Ball thread. The frame comes from the ball's cache when the attitude
+// hasn't moved much, and is drawn otherwise. If the software renderer
+// can't read the texture, the ball is rendered with OpenGL as before,
+// which is set up, used and released here only.
+//
+
+void FDAI::Run() {
+
+	const char *texture = LM_FDAI ? "Textures\\ProjectApollo\\FDAI_Ball_LM.dds" : "Textures\\ProjectApollo\\FDAI_Ball.dds";
+
+	ballGL = !ball.LoadTexture(texture);
+	if (ballGL) {
+		char buffer[256];
+		sprintf(buffer, "FDAI: Can't read %s as a 24-bit BMP, using OpenGL for the ball", texture);
+		oapiWriteLog(buffer);
+		InitGL();
+	}
+
+	while (true) {
+		ballEvent.Wait();
+
+		VECTOR3 attitude;
+		{
+			Lock lock(ballMutex);
+			if (ballQuit)
+				break;
+			attitude = ballAttitude;
+		}
+
+		if (ballGL) {
+			RenderBall(attitude);
+
+			Lock lock(ballMutex);
+			BitBlt(hDCBall, 0, 0, FDAIBALL_SIZE, FDAIBALL_SIZE, hDC2, 0, 0, SRCCOPY);
+			continue;
+		}
+
+		const unsigned int *frame = ball.Frame(attitude.x, attitude.y, attitude.z);
+
+		Lock lock(ballMutex);
+		GdiFlush();
+		memcpy(ballBits, frame, FDAIBALL_SIZE * FDAIBALL_SIZE * sizeof(unsigned int));
+	}
+
+	if (ballGL) {
 		gluDeleteQuadric(quadObj);
 		wglMakeCurrent(NULL, NULL);	//standard OpenGL release
-		BOOL ret = wglDeleteContext(hRC);
+		wglDeleteContext(hRC);
 		hRC = NULL;
 		SelectObject(hDC2, hBMP_old);//remember to delete DC and bitmap memory we created
 		DeleteObject(hBMP);
@@ -171,6 +244,79 @@ FDAI::~FDAI() {
 	}
 }
 
+//
+// The roll indicator is drawn from sprites rotated in advance, with a monochrome
+// mask for the transparent parts, so painting it is just two BitBlts.
+//
+
+void FDAI::BuildRollAtlas(HDC hDC, HBITMAP hBmpRoll) {
+
+	int width = FDAI_ROLL_COLUMNS * FDAI_ROLL_CELL;
+	int height = ((FDAI_ROLL_STEPS + FDAI_ROLL_COLUMNS - 1) / FDAI_ROLL_COLUMNS) * FDAI_ROLL_CELL;
+
+	ReleaseRollAtlas();
+	hBmpRollSrc = hBmpRoll;
+
+	hDCRollAtlas = CreateCompatibleDC(hDC);
+	hBmpRollAtlas = CreateCompatibleBitmap(hDC, width, height);
+	hBmpRollAtlas_old = (HBITMAP)SelectObject(hDCRollAtlas, hBmpRollAtlas);
+
+	RECT rt = { 0, 0, width, height };
+	HBRUSH brush = CreateSolidBrush(0x00FF00FF);
+	FillRect(hDCRollAtlas, &rt, brush);
+	DeleteObject(brush);
+
+	HDC hDCTemp = CreateCompatibleDC(hDC);
+	HBITMAP hBmpTemp = (HBITMAP)SelectObject(hDCTemp, hBmpRoll);
+
+	for (int i = 0; i < FDAI_ROLL_STEPS; i++) {
+		HDC hDCRotate;
+		int rotateX, rotateY;
+		HBITMAP hBmpRotate = RotateMemoryDC(hBmpRoll, hDCTemp, 20, 20, (float)(2.0 * PI * i / FDAI_ROLL_STEPS), hDCRotate, rotateX, rotateY);
+
+		if (rotateX > FDAI_ROLL_CELL) rotateX = FDAI_ROLL_CELL;
+		if (rotateY > FDAI_ROLL_CELL) rotateY = FDAI_ROLL_CELL;
+		BitBlt(hDCRollAtlas, (i % FDAI_ROLL_COLUMNS) * FDAI_ROLL_CELL, (i / FDAI_ROLL_COLUMNS) * FDAI_ROLL_CELL, rotateX, rotateY, hDCRotate, 0, 0, SRCCOPY);
+		rollW[i] = rotateX;
+		rollH[i] = rotateY;
+
+		DeleteDC(hDCRotate);
+		DeleteObject(hBmpRotate);
+	}
+
+	SelectObject(hDCTemp, hBmpTemp);
+	DeleteDC(hDCTemp);
+
+	// Mask is 1 where the atlas is magenta
+	hDCRollMask = CreateCompatibleDC(hDC);
+	hBmpRollMask = CreateBitmap(width, height, 1, 1, NULL);
+	hBmpRollMask_old = (HBITMAP)SelectObject(hDCRollMask, hBmpRollMask);
+	SetBkColor(hDCRollAtlas, 0x00FF00FF);
+	BitBlt(hDCRollMask, 0, 0, width, height, hDCRollAtlas, 0, 0, SRCCOPY);
+
+	// and the atlas is black there, to be ORed onto the panel
+	SetBkColor(hDCRollAtlas, RGB(0, 0, 0));
+	SetTextColor(hDCRollAtlas, RGB(255, 255, 255));
+	BitBlt(hDCRollAtlas, 0, 0, width, height, hDCRollMask, 0, 0, SRCAND);
+}
+
+void FDAI::ReleaseRollAtlas() {
+
+	if (hDCRollAtlas) {
+		SelectObject(hDCRollAtlas, hBmpRollAtlas_old);
+		DeleteObject(hBmpRollAtlas);
+		DeleteDC(hDCRollAtlas);
+		hDCRollAtlas = NULL;
+	}
+	if (hDCRollMask) {
+		SelectObject(hDCRollMask, hBmpRollMask_old);
+		DeleteObject(hBmpRollMask);
+		DeleteDC(hDCRollMask);
+		hDCRollMask = NULL;
+	}
+	hBmpRollSrc = NULL;
+}
+
 void FDAI::RegisterMe(int index, int x, int y) {
 
 	idx = index;
@@ -267,49 +413,79 @@ void FDAI::MoveBall() {
 		else
 			now.x += delta;
 	}
+}
+
+void FDAI::RenderBall(VECTOR3 attitude) {
 
 	glLoadIdentity();
 	gluLookAt(0.0, -35.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0);
 
 	glRotatef(90.0, 0.0, 1.0, 0.0);
 
-	glRotated(now.y / PI * 180.0, 0.0, 1.0, 0.0);	//attitude.x
-	glRotated(now.x / PI * 180.0, 1.0, 0.0, 0.0);	//attitude.z
-	glRotated(now.z / PI * 180.0, 0.0, 0.0, 1.0);	//attitude.y
+	glRotated(attitude.y / PI * 180.0, 0.0, 1.0, 0.0);	//attitude.x
+	glRotated(attitude.x / PI * 180.0, 1.0, 0.0, 0.0);	//attitude.z
+	glRotated(attitude.z / PI * 180.0, 0.0, 0.0, 1.0);	//attitude.y
+
+	glCallList(list_name);	//render
+	glFlush();
+	glFinish();
 }
 
 void FDAI::PaintMe(VECTOR3 attitude, int no_att, VECTOR3 rates, VECTOR3 errors, int ratescale, SURFHANDLE surf, SURFHANDLE hFDAI,
 	SURFHANDLE hFDAIRoll, SURFHANDLE hFDAIOff, SURFHANDLE hFDAINeedles, HBITMAP hBmpRoll, int smooth) {
 
-	if (!init) InitGL();
+	std::chrono::steady_clock::time_point paintStart = std::chrono::steady_clock::now();
+
+	HDC hDC = oapiGetDC(surf);
+
+	if (!init) {
+		// Start the ball thread, with a black ball until its first frame
+		BITMAPINFO bi;
+		memset(&bi, 0, sizeof(bi));
+		bi.bmiHeader.biSize = sizeof(bi.bmiHeader);
+		bi.bmiHeader.biWidth = FDAIBALL_SIZE;
+		bi.bmiHeader.biHeight = -FDAIBALL_SIZE;	// top row first, as the ball draws it
+		bi.bmiHeader.biPlanes = 1;
+		bi.bmiHeader.biBitCount = 32;
+		bi.bmiHeader.biCompression = BI_RGB;
+
+		void *bits;
+		hDCBall = CreateCompatibleDC(hDC);
+		hBmpBall = CreateDIBSection(hDCBall, &bi, DIB_RGB_COLORS, &bits, NULL, 0);
+		hBmpBall_old = (HBITMAP)SelectObject(hDCBall, hBmpBall);
+		ballBits = (unsigned int *)bits;
+		memset(ballBits, 0, FDAIBALL_SIZE * FDAIBALL_SIZE * sizeof(unsigned int));
+		init = 1;
+		thread.Resume();
+	}
+	if (hBmpRoll != hBmpRollSrc)
+		BuildRollAtlas(hDC, hBmpRoll);
 
 	SetAttitude(attitude);
 
-	// Don't do the OpenGL calculations every timestep
+	// Don't move the ball every timestep
 	if (smooth || lastPaintTime == -1 || ((length(now - target) > 0.005 || oapiGetSysTime() > lastPaintTime + 2.0) && oapiGetSysTime() > lastPaintTime + 0.1)) {
-		int ret = wglMakeCurrent(hDC2, hRC);
 		MoveBall();
-		glCallList(list_name);	//render
-		glFlush();
-		glFinish();
+		{
+			Lock lock(ballMutex);
+			ballAttitude = now;
+		}
+		ballEvent.Raise();
 
 		lastPaintTime = oapiGetSysTime();
 	}
 
-	HDC hDC = oapiGetDC(surf);
-	BitBlt(hDC, 43, 43, 150, 150, hDC2, 10, 10, SRCCOPY);//then we bitblt onto the panel.
+	{
+		Lock lock(ballMutex);
+		BitBlt(hDC, 43, 43, 150, 150, hDCBall, 10, 10, SRCCOPY);//then we bitblt onto the panel.
+	}
 
 	// roll indicator
-	HDC hDCRotate;
-	int rotateX, rotateY;
 	double angle = -target.y;
-
-	HDC hDCTemp = CreateCompatibleDC(hDC);
-	HBITMAP hBmpTemp = (HBITMAP)SelectObject(hDCTemp, hBmpRoll);
-
-	HBITMAP hBmpRotate = RotateMemoryDC(hBmpRoll, hDCTemp, 20, 20, (float)(PI - angle), hDCRotate, rotateX, rotateY);
-	HBITMAP hBmpXXX = CreateCompatibleBitmap(hDCRotate, rotateX, rotateY);
-	SelectObject(hDCRotate, hBmpXXX);
+	double rotate = fmod(PI - angle, 2.0 * PI);
+	if (rotate < 0) rotate += 2.0 * PI;
+	int step = ((int)(rotate / (2.0 * PI) * FDAI_ROLL_STEPS + 0.5)) % FDAI_ROLL_STEPS;
+	int rotateX = rollW[step], rotateY = rollH[step];
 
 	double radius = 62;
 	// Was + 93 and 92
@@ -317,13 +493,12 @@ void FDAI::PaintMe(VECTOR3 attitude, int no_att, VECTOR3 rates, VECTOR3 errors,
 	int targetY = ((int)(-cos(-angle) * radius)) + 122 - ((int)(rotateY / 2));
 	int targetZ = 0;
 
-	DrawTransparentBitmap(hDC, hBmpRotate, targetX, targetY, 0x00FF00FF);
-
-	DeleteObject(hBmpXXX);
-	DeleteObject(hBmpTemp);
-	DeleteObject(hBmpRotate);
-	DeleteDC(hDCTemp);
-	DeleteDC(hDCRotate);
+	COLORREF bkColor = SetBkColor(hDC, RGB(255, 255, 255));
+	COLORREF textColor = SetTextColor(hDC, RGB(0, 0, 0));
+	BitBlt(hDC, targetX, targetY, rotateX, rotateY, hDCRollMask, (step % FDAI_ROLL_COLUMNS) * FDAI_ROLL_CELL, (step / FDAI_ROLL_COLUMNS) * FDAI_ROLL_CELL, SRCAND);
+	BitBlt(hDC, targetX, targetY, rotateX, rotateY, hDCRollAtlas, (step % FDAI_ROLL_COLUMNS) * FDAI_ROLL_CELL, (step / FDAI_ROLL_COLUMNS) * FDAI_ROLL_CELL, SRCPAINT);
+	SetBkColor(hDC, bkColor);
+	SetTextColor(hDC, textColor);
 
 	oapiReleaseDC(surf, hDC);
 
@@ -462,6 +637,9 @@ void FDAI::PaintMe(VECTOR3 attitude, int no_att, VECTOR3 rates, VECTOR3 errors,
 	// Off-flag
 	if (!IsPowered() || no_att != 0)
 		oapiBlt(surf, hFDAIOff, 31, 100, 0, 0, 13, 30, SURF_PREDEF_CK);
+
+	double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - paintStart).count();
+	paintTime += (dt - paintTime) * 0.05;
 }
 
 void FDAI::Timestep(double simt, double simdt) {
@@ -528,107 +706,6 @@ int FDAI::LoadOGLBitmap(char *filename) {
 	return (num_texture);
 }
 
-void DrawTransparentBitmap(HDC hdc, HBITMAP hBitmap, short xStart,
-	short yStart, COLORREF cTransparentColor) {
-
-	BITMAP     bm;
-	COLORREF   cColor;
-	HBITMAP    bmAndBack, bmAndObject, bmAndMem, bmSave;
-	HBITMAP    bmBackOld, bmObjectOld, bmMemOld, bmSaveOld;
-	HDC        hdcMem, hdcBack, hdcObject, hdcTemp, hdcSave;
-	POINT      ptSize;
-
-	hdcTemp = CreateCompatibleDC(hdc);
-	SelectObject(hdcTemp, hBitmap);   // Select the bitmap
-
-	GetObject(hBitmap, sizeof(BITMAP), (LPSTR)&bm);
-	ptSize.x = bm.bmWidth;            // Get width of bitmap
-	ptSize.y = bm.bmHeight;           // Get height of bitmap
-	DPtoLP(hdcTemp, &ptSize, 1);      // Convert from device
-
-									  // to logical points
-
-	// Create some DCs to hold temporary data.
-	hdcBack = CreateCompatibleDC(hdc);
-	hdcObject = CreateCompatibleDC(hdc);
-	hdcMem = CreateCompatibleDC(hdc);
-	hdcSave = CreateCompatibleDC(hdc);
-
-	// Create a bitmap for each DC. DCs are required for a number of
-	// GDI functions.
-
-	// Monochrome DC
-	bmAndBack = CreateBitmap(ptSize.x, ptSize.y, 1, 1, NULL);
-
-	// Monochrome DC
-	bmAndObject = CreateBitmap(ptSize.x, ptSize.y, 1, 1, NULL);
-
-	bmAndMem = CreateCompatibleBitmap(hdc, ptSize.x, ptSize.y);
-	bmSave = CreateCompatibleBitmap(hdc, ptSize.x, ptSize.y);
-
-	// Each DC must select a bitmap object to store pixel data.
-	bmBackOld = (HBITMAP)SelectObject(hdcBack, bmAndBack);
-	bmObjectOld = (HBITMAP)SelectObject(hdcObject, bmAndObject);
-	bmMemOld = (HBITMAP)SelectObject(hdcMem, bmAndMem);
-	bmSaveOld = (HBITMAP)SelectObject(hdcSave, bmSave);
-
-	// Set proper mapping mode.
-	SetMapMode(hdcTemp, GetMapMode(hdc));
-
-	// Save the bitmap sent here, because it will be overwritten.
-	BitBlt(hdcSave, 0, 0, ptSize.x, ptSize.y, hdcTemp, 0, 0, SRCCOPY);
-
-	// Set the background color of the source DC to the color.
-	// contained in the parts of the bitmap that should be transparent
-	cColor = SetBkColor(hdcTemp, cTransparentColor);
-
-	// Create the object mask for the bitmap by performing a BitBlt
-	// from the source bitmap to a monochrome bitmap.
-	BitBlt(hdcObject, 0, 0, ptSize.x, ptSize.y, hdcTemp, 0, 0,
-		SRCCOPY);
-
-	// Set the background color of the source DC back to the original
-	// color.
-	SetBkColor(hdcTemp, cColor);
-
-	// Create the inverse of the object mask.
-	BitBlt(hdcBack, 0, 0, ptSize.x, ptSize.y, hdcObject, 0, 0,
-		NOTSRCCOPY);
-
-	// Copy the background of the main DC to the destination.
-	BitBlt(hdcMem, 0, 0, ptSize.x, ptSize.y, hdc, xStart, yStart,
-		SRCCOPY);
-
-	// Mask out the places where the bitmap will be placed.
-	BitBlt(hdcMem, 0, 0, ptSize.x, ptSize.y, hdcObject, 0, 0, SRCAND);
-
-	// Mask out the transparent colored pixels on the bitmap.
-	BitBlt(hdcTemp, 0, 0, ptSize.x, ptSize.y, hdcBack, 0, 0, SRCAND);
-
-	// XOR the bitmap with the background on the destination DC.
-	BitBlt(hdcMem, 0, 0, ptSize.x, ptSize.y, hdcTemp, 0, 0, SRCPAINT);
-
-	// Copy the destination to the screen.
-	BitBlt(hdc, xStart, yStart, ptSize.x, ptSize.y, hdcMem, 0, 0,
-		SRCCOPY);
-
-	// Place the original bitmap back into the bitmap sent here.
-	BitBlt(hdcTemp, 0, 0, ptSize.x, ptSize.y, hdcSave, 0, 0, SRCCOPY);
-
-	// Delete the memory bitmaps.
-	DeleteObject(SelectObject(hdcBack, bmBackOld));
-	DeleteObject(SelectObject(hdcObject, bmObjectOld));
-	DeleteObject(SelectObject(hdcMem, bmMemOld));
-	DeleteObject(SelectObject(hdcSave, bmSaveOld));
-
-	// Delete the memory DCs.
-	DeleteDC(hdcMem);
-	DeleteDC(hdcBack);
-	DeleteDC(hdcObject);
-	DeleteDC(hdcSave);
-	DeleteDC(hdcTemp);
-}
-
 // Helper function for getting the minimum of 4 floats
 float min4(float a, float b, float c, float d)
 {
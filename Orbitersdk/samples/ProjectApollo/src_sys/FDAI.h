@@ -27,8 +27,19 @@
 
 #include < GL\gl.h >                                
 #include < GL\glu.h >
+#include "thread.h"
+#include "fdaiball.h"
 
-class FDAI {
+#define FDAI_ROLL_STEPS		720		///< Roll indicator sprites, 0.5 degree steps
+#define FDAI_ROLL_CELL		32		///< Atlas cell size, fits the rotated 20x20 sprite
+#define FDAI_ROLL_COLUMNS	36		///< Atlas cells per row
+
+///
+/// The ball is drawn by a thread of its own, so the panel paint just copies the
+/// last frame it finished. It is drawn by FDAIBall, or with OpenGL if FDAIBall
+/// can't read the texture.
+///
+class FDAI : public Runnable {
 
 public:
 	FDAI();
@@ -48,28 +59,65 @@ public:
 	bool LM_FDAI;
 	void WireTo(e_object *dc) { DCSource = dc; noAC = true; };
 
+	///
+	/// \brief Time spent in PaintMe, seconds, averaged over the last 20 paints or so.
+	/// The Project Apollo MFD shows it for the CSM on its telemetry page.
+	///
+	double GetPaintTime() { return paintTime; };
+
 protected:
 	int ScrX;
 	int ScrY;			//coords on screen
 	int idx;			//index on the panel list 
 	int init;
-	int list_name; //we store the rendering into a display list
 	VECTOR3 now, target, lastRates, lastErrors;
 	double lastPaintTime;
 	bool newRegistered;
 
-	//some stuff for OpenGL
+	double paintTime;
+
+	// Software ball renderer, only used by the ball thread
+	FDAIBall ball;
+
+	//some stuff for OpenGL, only used by the ball thread if the software renderer can't be
+	bool ballGL;
+	int list_name; //we store the rendering into a display list
 	HDC hDC2;
 	HGLRC hRC;
 	HBITMAP hBMP;
 	HBITMAP hBMP_old;
 	GLUquadricObj *quadObj;
 
+	// Last ball frame, for the panel
+	HDC hDCBall;
+	HBITMAP hBmpBall;
+	HBITMAP hBmpBall_old;
+	unsigned int *ballBits;
+	Mutex ballMutex;
+	Event ballEvent;
+	VECTOR3 ballAttitude;	///< Attitude to render next
+	bool ballQuit;
+
+	// Pre-rotated roll indicators, and their transparency mask
+	HBITMAP hBmpRollSrc;
+	HDC hDCRollAtlas;
+	HBITMAP hBmpRollAtlas;
+	HBITMAP hBmpRollAtlas_old;
+	HDC hDCRollMask;
+	HBITMAP hBmpRollMask;
+	HBITMAP hBmpRollMask_old;
+	unsigned char rollW[FDAI_ROLL_STEPS];
+	unsigned char rollH[FDAI_ROLL_STEPS];
+
 	e_object *DCSource, *ACSource;
 	bool noAC;
 
 	void InitGL();
 	void MoveBall();
+	void RenderBall(VECTOR3 attitude);
+	void Run();
+	void BuildRollAtlas(HDC hDC, HBITMAP hBmpRoll);
+	void ReleaseRollAtlas();
 	void SetAttitude(VECTOR3 attitude);
 	int LoadOGLBitmap(char *filename);
 };
@@ -58,6 +58,12 @@ public:
 	void LoadState(FILEHANDLE scn);
 	void SaveState(FILEHANDLE scn);
 
+	///
+	/// \brief Save the gimbal and PIPA state to an in-memory checkpoint.
+	///
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
+
 protected:
 	
 	void DriveCDUX(int cducmd);
@@ -69,6 +75,7 @@ protected:
 	void DriveGimbalZ(double angle);
 	void DriveGimbal(int index, int RegCDU, double angle);
 	void PulsePIPA(int RegPIPA, int pulses);
+	void ScheduleFrame(MATRIX3 LastRotation, VECTOR3 accel, double deltaTime, uint64_t cycle);
 	void SetOrbiterAttitudeReference();
 	void DoZeroIMUCDUs();
 
@@ -82,6 +89,8 @@ protected:
 	void LogVector(char* message, VECTOR3 v);
 	void LogMessage(char* s);
 
+	FlightLogFile log;		///< IMU log, FLIGHTLOG_IMU
+
 	//
 	// Maths.
 	//
@@ -91,6 +100,9 @@ protected:
 	MATRIX3 getRotationMatrixZ(double angle);
 	VECTOR3 getRotationAnglesXZY(MATRIX3 m);
 	VECTOR3 getRotationAnglesZYX(MATRIX3 m);
+	MATRIX3 getOrbiterRotationMatrix(double x, double y, double z);
+	MATRIX3 slerpRotationMatrix(MATRIX3 a, MATRIX3 b, double s);
+	void GimbalAngles(MATRIX3 Rotation, MATRIX3 nav, double *angles);
 
 	double degToRad(double angle);
 	double radToDeg(double angle);
@@ -145,6 +157,8 @@ protected:
 	double pipaRate;	// PIPA pulse representation of speed change
 	double LastTime;	// in seconds
 
+	int CDUQueued;		// Frames until the CDU values ScheduleFrame() queued have surely been made
+
 	// Allow the MFD to touch our privates
 	friend class ProjectApolloMFD;
 };
@@ -156,4 +170,12 @@ protected:
 #define IMU_START_STRING	"IMU_BEGIN"
 #define IMU_END_STRING		"IMU_END"
 
+//
+// Sub-steps a frame's gimbal motion and PIPA pulses are spread over: one per
+// IMU_SUBSTEP seconds, at most IMU_MAX_SUBSTEPS.
+//
+
+#define IMU_SUBSTEP			0.005
+#define IMU_MAX_SUBSTEPS	128
+
 #endif
@@ -0,0 +1,258 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  In-memory vessel state checkpoints
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  **************************************************************************/
+
+#if !defined(_PA_CHECKPOINT_H)
+#define _PA_CHECKPOINT_H
+
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+///
+/// PutRange() copies every byte from one member to another, so each class that uses it
+/// checks the range where it saves it: first must be laid out before last. What lies in
+/// between must be plain data too, no pointers or objects that own memory.
+///
+#define CHECKPOINT_RANGE(cls, first, last) \
+	static_assert(offsetof(cls, first) <= offsetof(cls, last), #cls ": checkpoint range " #first " to " #last " is out of order")
+
+///
+/// \ingroup PanelSDK
+/// A binary snapshot of vessel state, held in memory. Each system writes its state
+/// with Put() and reads it back in the same order with Get(), so the format is only
+/// meaningful to the build and the vessel configuration that wrote it: the scenario
+/// file stays the format for anything kept or exchanged.
+///
+/// The buffer keeps its memory when cleared, so once a vessel has taken a checkpoint
+/// or two, taking another doesn't allocate.
+///
+/// Only the Saturn takes checkpoints so far. The LEM doesn't, so a docked LEM carries
+/// on from where it is when the CSM is restored.
+///
+/// \brief In-memory vessel state checkpoint.
+///
+class Checkpoint
+{
+public:
+	Checkpoint() : Time(0), Stage(0), used(0), pos(0), failed(false) {}
+
+	///
+	/// \brief Empty the checkpoint, keeping the memory for the next one.
+	///
+	void Clear() { used = 0; pos = 0; failed = false; }
+
+	///
+	/// \brief Go back to the start to read the checkpoint again.
+	///
+	void Rewind() { pos = 0; failed = false; }
+
+	size_t Size() const { return used; }
+	bool Empty() const { return used == 0; }
+
+	///
+	/// \brief Has all of the checkpoint been read back?
+	///
+	bool AtEnd() const { return pos == used; }
+
+	///
+	/// Set when a read runs past the end, or a Check() fails. Once set, reads don't
+	/// change anything more, but what was read before stays read: a vessel that
+	/// needs all or nothing keeps a checkpoint of its current state to go back to,
+	/// as Saturn::LoadCheckpoint does.
+	///
+	/// \brief Did reading the checkpoint go wrong?
+	///
+	bool Failed() const { return failed; }
+	void Fail() { failed = true; }
+
+	void Write(const void *p, size_t n)
+	{
+		if (used + n > data.size())
+			data.resize(used + n > 2 * data.size() ? used + n : 2 * data.size());
+		memcpy(&data[used], p, n);
+		used += n;
+	}
+
+	bool Read(void *p, size_t n)
+	{
+		if (failed || pos + n > used) {
+			failed = true;
+			return false;
+		}
+		memcpy(p, &data[pos], n);
+		pos += n;
+		return true;
+	}
+
+	template <class T> void Put(const T &v) { Write(&v, sizeof(T)); }
+	template <class T> bool Get(T &v) { return Read(&v, sizeof(T)); }
+
+	///
+	/// Members declared next to each other in the same access section of a class
+	/// are laid out in order, so a run of plain data can go in with one copy. Check
+	/// the range with CHECKPOINT_RANGE() next to the call.
+	///
+	/// \brief Write the members from first to last inclusive.
+	///
+	template <class T, class U> void PutRange(const T &first, const U &last)
+	{
+		static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_copyable<U>::value, "Checkpoint ranges must be plain data");
+		Write(&first, (const char *) (&last + 1) - (const char *) &first);
+	}
+
+	template <class T, class U> bool GetRange(T &first, U &last)
+	{
+		static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_copyable<U>::value, "Checkpoint ranges must be plain data");
+		return Read(&first, (char *) (&last + 1) - (char *) &first);
+	}
+
+	///
+	/// Put a count or marker in with Mark(), and Check() it on the way back. If it
+	/// doesn't match, the checkpoint was taken with a different set of objects, and
+	/// is marked as failed.
+	///
+	/// \brief Write a value to check when reading back.
+	///
+	void Mark(int v) { Put(v); }
+	bool Check(int v)
+	{
+		int m;
+		if (!Get(m) || m != v)
+			failed = true;
+		return !failed;
+	}
+
+	double Time;		///< Mission time the checkpoint was taken at
+	int Stage;			///< Vessel stage the checkpoint was taken at
+
+protected:
+	std::vector<char> data;
+	size_t used;
+	size_t pos;
+	bool failed;
+};
+
+///
+/// \ingroup PanelSDK
+/// A ring of checkpoints taken at regular intervals, for stepping back in time. Once
+/// the ring is full the oldest checkpoint is reused for the next one.
+///
+/// \brief Ring buffer of checkpoints.
+///
+class CheckpointRing
+{
+public:
+	CheckpointRing() : Interval(0), next(0), count(0) {}
+
+	///
+	/// \brief Set the number of checkpoints to keep, and the time between them.
+	/// \param n Number of checkpoints.
+	/// \param interval Mission time in seconds between checkpoints, 0 to take none.
+	///
+	void SetSize(int n, double interval)
+	{
+		slots.resize(n > 0 ? n : 0);
+		Interval = interval;
+		Clear();
+	}
+
+	///
+	/// \brief Throw away all the checkpoints, for example when the vessel stages.
+	///
+	void Clear() { next = 0; count = 0; }
+
+	int Count() const { return count; }
+	int Size() const { return (int) slots.size(); }
+	bool Enabled() const { return Interval > 0 && !slots.empty(); }
+
+	///
+	/// \brief Is it time for the next checkpoint?
+	/// \param t Mission time now.
+	///
+	bool Due(double t) const
+	{
+		if (!Enabled())
+			return false;
+		if (count == 0)
+			return true;
+		double last = Newest(0)->Time;
+		return (t >= last + Interval || t < last);
+	}
+
+	///
+	/// \brief Get an emptied checkpoint to fill in, reusing the oldest if the ring is full.
+	///
+	Checkpoint &Add()
+	{
+		Checkpoint &cp = slots[next];
+		cp.Clear();
+		next = (next + 1) % slots.size();
+		if (count < (int) slots.size())
+			count++;
+		return cp;
+	}
+
+	///
+	/// \brief Get a checkpoint, counting back from the newest.
+	/// \param back 0 for the newest, 1 for the one before that, and so on.
+	/// \return The checkpoint, or NULL if there aren't that many.
+	///
+	Checkpoint *Newest(int back)
+	{
+		if (back < 0 || back >= count)
+			return NULL;
+		return &slots[(next + slots.size() - 1 - back) % slots.size()];
+	}
+
+	const Checkpoint *Newest(int back) const
+	{
+		return const_cast<CheckpointRing *>(this)->Newest(back);
+	}
+
+	///
+	/// After stepping back to an older checkpoint, the newer ones no longer lead on
+	/// from it, so they are dropped and their slots reused first.
+	///
+	/// \brief Drop the newest checkpoints.
+	/// \param n Number to drop.
+	///
+	void Drop(int n)
+	{
+		if (slots.empty())
+			return;
+		if (n > count)
+			n = count;
+		next = (next + slots.size() - n) % slots.size();
+		count -= n;
+	}
+
+	double Interval;	///< Mission time in seconds between checkpoints
+
+protected:
+	std::vector<Checkpoint> slots;
+	int next;
+	int count;
+};
+
+#endif // _PA_CHECKPOINT_H
@@ -29,6 +29,8 @@
 #include "esystems.h"
 #include <math.h>
 #include <stdio.h>
+#include <algorithm>
+#include <vector>
 
 #define SP_MIN_DCVOLTAGE	20.0
 #define SP_MIN_ACVOLTAGE	100.0
@@ -40,6 +42,8 @@ e_object::e_object()
 	power_load = 0.0;
 	SRC = 0;
 	enabled = true;
+	load_flow = false;
+	pending_load = 0.0;
 
 	Volts = 0.0;
 	Amperes = 0.0;
@@ -78,6 +82,26 @@ void e_object::Load(char *line)
 {
 }
 
+void e_object::SaveCheckpoint(Checkpoint &cp)
+
+{
+	cp.Put(enabled);
+	cp.Put(Amperes);
+	cp.Put(Volts);
+	cp.Put(power_load);
+	cp.Put(pending_load);
+}
+
+void e_object::LoadCheckpoint(Checkpoint &cp)
+
+{
+	cp.Get(enabled);
+	cp.Get(Amperes);
+	cp.Get(Volts);
+	cp.Get(power_load);
+	cp.Get(pending_load);
+}
+
 double e_object::Voltage() 
 
 {
@@ -132,35 +156,240 @@ void e_object::UpdateFlow(double dt)
 E_system::E_system()
 {
 	List.next=NULL;
+	UpdateSRC=NULL;
+	LoadFlow = false;
+	Deferring = NULL;
+	DeferringPass = NULL;
+	DeferringCount = 0;
 }
 
 E_system::~E_system()
 
 {
+	if (UpdateSRC)
+		delete[] UpdateSRC;
+	if (Deferring)
+		delete[] Deferring;
+	if (DeferringPass)
+		delete[] DeferringPass;
+}
+
+void E_system::SetLoadFlow(bool on)
+
+{
+	LoadFlow = on;
+
+	//
+	// The objects pick the setting up when the update order is next built.
+	//
+	UpdateOrderValid = false;
+}
+
+//
+// Pass the pending loads on until there is nothing left, numbering the passes
+// from first. Objects for which HoldsLoad() is true are skipped unless held is
+// set. Returns the number of passes which passed anything on.
+//
+
+int E_system::PassOnLoads(bool held, int first)
+
+{
+	int i, pass;
+	bool passed = true;
+
+	//
+	// Load passed on to an object we have already been past in this pass is
+	// picked up in the next one. A loop in the wiring would never run out of
+	// load, so stop after as many passes as there are objects.
+	//
+	for (pass = 0; passed && pass < DeferringCount; pass++) {
+		passed = false;
+		for (i = 0; i < DeferringCount; i++) {
+			e_object *e = Deferring[i];
+
+			if (!held && e->HoldsLoad())
+				continue;
+
+			if (e->PassOnLoad()) {
+				DeferringPass[i] = first + pass;
+				passed = true;
+			}
+		}
+	}
+
+	return passed ? pass : pass - 1;
+}
+
+void E_system::PassOnLoads()
+
+{
+	int i;
+
+	//
+	// First everything but the inverters, so all of their AC load is in, then
+	// the inverters and whatever they feed. That way an inverter works out its
+	// efficiency once per timestep, for its whole load.
+	//
+	int passes = PassOnLoads(false, 1);
+	int heldPasses = PassOnLoads(true, passes + 1);
+
+	//
+	// Move the objects which got load from others after those, so next time
+	// it normally all goes through in one pass each time round. The order only
+	// changes when the wiring or the loads do.
+	//
+	if (passes > 1 || heldPasses > 1) {
+		for (i = 1; i < DeferringCount; i++) {
+			e_object *e = Deferring[i];
+			int p = DeferringPass[i];
+			int j = i;
+
+			while (j > 0 && DeferringPass[j - 1] > p) {
+				Deferring[j] = Deferring[j - 1];
+				DeferringPass[j] = DeferringPass[j - 1];
+				j--;
+			}
+			Deferring[j] = e;
+			DeferringPass[j] = p;
+		}
+	}
+
+	for (i = 0; i < DeferringCount; i++)
+		DeferringPass[i] = 0;
 }
 
 void E_system::Refresh(double dt)
 
 {
-	ship_object *runner;
+	int i;
+
+	CheckUpdateOrder();
+
+	if (LoadFlow)
+		PassOnLoads();
 
 	//
 	// First we go through all the systems zeroing their power-drain and updating
-	// voltage and current.
+	// voltage and current. Sources come first, so the buses and consumers see
+	// this timestep's voltages rather than last timestep's.
 	//
-	runner=List.next;
-	while (runner){ 
-		runner->UpdateFlow(dt);
-		runner=runner->next;
+	for (i = 0; i < UpdateCount; i++) {
+		e_object *e = (e_object *) UpdateOrder[i];
+		e->UpdateFlow(dt);
+
+		//
+		// If something was rewired, sort again on the next timestep.
+		//
+		if (e->SRC != UpdateSRC[i])
+			UpdateOrderValid = false;
 	}
 
 	//
 	// Then refresh them to allow the power drain to update.
 	//
-	runner=List.next;
-	while (runner){ 
-		runner->refresh(dt);
-		runner=runner->next;
+	for (i = 0; i < UpdateCount; i++)
+		UpdateOrder[i]->refresh(dt);
+}
+
+namespace {
+	struct UpdateEntry {
+		e_object *obj;
+		int depth;
+		int index;
+	};
+
+	bool UpdateEntryLess(const UpdateEntry &a, const UpdateEntry &b)
+	{
+		if (a.depth != b.depth)
+			return a.depth < b.depth;
+
+		//
+		// Same depth: keep the order they were loaded in, so every build
+		// updates them the same way.
+		//
+		return a.index < b.index;
+	}
+}
+
+void E_system::BuildUpdateOrder()
+
+{
+	int i;
+
+	ship_system::BuildUpdateOrder();
+
+	//
+	// Order the objects by how far they are down their SRC chain: true power
+	// sources first, then the buses they feed, then the consumers. The depth is
+	// capped in case the wiring loops back on itself.
+	//
+	std::vector<UpdateEntry> entries(UpdateCount);
+	for (i = 0; i < UpdateCount; i++) {
+		e_object *e = (e_object *) UpdateOrder[i];
+		int depth = 0;
+
+		while (e->SRC && depth <= UpdateCount) {
+			e = e->SRC;
+			depth++;
+		}
+
+		entries[i].obj = (e_object *) UpdateOrder[i];
+		entries[i].depth = depth;
+		entries[i].index = i;
+	}
+
+	std::stable_sort(entries.begin(), entries.end(), UpdateEntryLess);
+
+	if (UpdateSRC)
+		delete[] UpdateSRC;
+	UpdateSRC = UpdateCount ? new e_object*[UpdateCount] : NULL;
+
+	for (i = 0; i < UpdateCount; i++) {
+		UpdateOrder[i] = entries[i].obj;
+		UpdateSRC[i] = entries[i].obj->SRC;
+	}
+
+	//
+	// Collect the objects for the load-flow pass, consumer end first, as that is
+	// where the load comes from.
+	//
+	if (Deferring)
+		delete[] Deferring;
+	if (DeferringPass)
+		delete[] DeferringPass;
+	Deferring = NULL;
+	DeferringPass = NULL;
+	DeferringCount = 0;
+
+	for (i = 0; i < UpdateCount; i++) {
+		e_object *e = (e_object *) UpdateOrder[i];
+
+		//
+		// Hand on anything still pending if it's being turned off.
+		//
+		if (!LoadFlow)
+			e->PassOnLoad();
+
+		e->SetLoadFlow(LoadFlow);
+		if (LoadFlow && e->DefersLoad())
+			DeferringCount++;
+	}
+
+	if (DeferringCount) {
+		int n = 0;
+
+		Deferring = new e_object*[DeferringCount];
+		DeferringPass = new int[DeferringCount];
+
+		for (i = UpdateCount - 1; i >= 0; i--) {
+			e_object *e = (e_object *) UpdateOrder[i];
+
+			if (e->DefersLoad()) {
+				Deferring[n] = e;
+				DeferringPass[n] = 0;
+				n++;
+			}
+		}
 	}
 }
 
@@ -272,6 +501,18 @@ FCell::FCell(char *i_name, int i_status, vector3 i_pos, h_Valve *o2, h_Valve *h2
 	h2o_volume.Void();
 }
 
+void Socket::SaveCheckpoint(Checkpoint &cp)
+{
+	e_object::SaveCheckpoint(cp);
+	cp.Put(curent);
+}
+
+void Socket::LoadCheckpoint(Checkpoint &cp)
+{
+	e_object::LoadCheckpoint(cp);
+	cp.Get(curent);
+}
+
 void FCell::DrawPower(double watts) 
 
 {
@@ -501,6 +742,19 @@ void FCell::Save(FILEHANDLE scn)
 	oapiWriteScenario_string (scn, "    <FCELL> ", cbuf);
 }
 
+void FCell::SaveCheckpoint(Checkpoint &cp)
+{
+	e_object::SaveCheckpoint(cp);
+	CHECKPOINT_RANGE(FCell, H2_flow, tempTooLowCount);
+	cp.PutRange(H2_flow, tempTooLowCount);
+}
+
+void FCell::LoadCheckpoint(Checkpoint &cp)
+{
+	e_object::LoadCheckpoint(cp);
+	cp.GetRange(H2_flow, tempTooLowCount);
+}
+
 //
 //-------------------------------------- BATTERY ---------------------------------
 //
@@ -537,6 +791,8 @@ double Battery::Current()
 
 void Battery::UpdateFlow(double dt)
 {
+	double load = power_load;
+
 	power -= power_load * dt;
 
 	if (Volts > 0.0) 
@@ -553,8 +809,22 @@ void Battery::UpdateFlow(double dt)
 	else
 		Volts = max_voltage * 4.5 * power / max_power;
 
-	// Voltage drop because of load
-	Volts = (Volts - (Amperes * internal_resistance));
+	if (load_flow && Volts > 0.0) {
+		//
+		// The load-flow pass has given us this timestep's whole load, so solve
+		// V = E - I * R with I = P / V for the terminal voltage, rather than
+		// using the current from the last timestep's voltage. Past the most
+		// the battery can deliver, hold it at half the open-circuit voltage.
+		//
+		double d = Volts * Volts - 4.0 * load * internal_resistance;
+
+		Volts = (d > 0.0) ? (Volts + sqrt(d)) / 2.0 : Volts / 2.0;
+		Amperes = load / Volts;
+	}
+	else {
+		// Voltage drop because of load
+		Volts = (Volts - (Amperes * internal_resistance));
+	}
 
 	if (power < 0) { 
 		power = 0;
@@ -592,6 +862,18 @@ void Battery::Save(FILEHANDLE scn)
 	oapiWriteScenario_string (scn, "    <BATTERY> ", cbuf);
 }
 
+void Battery::SaveCheckpoint(Checkpoint &cp)
+{
+	e_object::SaveCheckpoint(cp);
+	cp.Put(power);
+}
+
+void Battery::LoadCheckpoint(Checkpoint &cp)
+{
+	e_object::LoadCheckpoint(cp);
+	cp.Get(power);
+}
+
 //-------------------------- TRANSDUCER BASE CLASS -------------------------------
 Transducer::Transducer(char *i_name, double minIn, double maxIn, double minOut, double maxOut)
 
@@ -897,6 +1179,8 @@ void ACInverter::DrawPower(double watts)
 	power_load += watts;
 
 	// Don't draw power here. We need to do this later based on total draw and input voltage.
+	if (load_flow)
+		pending_load += watts;
 
 //	if (SRC)
 //		SRC->DrawPower(watts * 1.10);
@@ -951,6 +1235,28 @@ void ACInverter::Save(FILEHANDLE scn)
 	oapiWriteScenario_string (scn, "    <INVERTER> ", cbuf);
 }
 
+void ACInverter::SaveCheckpoint(Checkpoint &cp)
+{
+	e_object::SaveCheckpoint(cp);
+	cp.Put(overload_tripped);
+	cp.Put(last_overload_check);
+	cp.Put(overload_check_time);
+	PhaseA.SaveCheckpoint(cp);
+	PhaseB.SaveCheckpoint(cp);
+	PhaseC.SaveCheckpoint(cp);
+}
+
+void ACInverter::LoadCheckpoint(Checkpoint &cp)
+{
+	e_object::LoadCheckpoint(cp);
+	cp.Get(overload_tripped);
+	cp.Get(last_overload_check);
+	cp.Get(overload_check_time);
+	PhaseA.LoadCheckpoint(cp);
+	PhaseB.LoadCheckpoint(cp);
+	PhaseC.LoadCheckpoint(cp);
+}
+
 double ACInverter::calc_epw_util(double maxw,int index,double SourceVoltage){
 	double epw_factor,watt_scale;
 	watt_scale = power_load/maxw;
@@ -994,6 +1300,46 @@ double ACInverter::get_epw(double base_epw_factor, double SourceVoltage){
 	return(70); // 70% eff above 1235 watts
 }
 
+double ACInverter::InputFactor(double SourceVoltage)
+
+{
+	if(SourceVoltage < 25){ SourceVoltage = 25; } // Regulate this back up to 25
+	if(SourceVoltage > 30){ SourceVoltage = 30; } // Regulate this back down to 30
+	
+	double base_epw_factor = (2.528-(0.144266667*(SourceVoltage - 25)));
+	// Calculate
+	double efactor = (get_epw(base_epw_factor,SourceVoltage)/100);
+	efactor = (1 - efactor)+1;
+
+	//sprintf(oapiDebugString(),"INV: LOAD %f WATT, IV %f VDC, EFFX %f",power_load,SourceVoltage,efactor);
+
+	return efactor;
+}
+
+//
+// In the load-flow pass, draw the DC for the AC load before our source
+// updates its flow, rather than a timestep later in UpdateFlow(). The pass
+// holds us back until all of the AC load is in (see HoldsLoad()), so the
+// efficiency is worked out once, for the whole load.
+//
+
+bool ACInverter::PassOnLoad()
+
+{
+	if (pending_load == 0.0)
+		return false;
+
+	if (SRC) {
+		double SourceVoltage = SRC->Voltage();
+
+		if (SourceVoltage >= 19)
+			SRC->DrawPower(pending_load * InputFactor(SourceVoltage));
+	}
+
+	pending_load = 0.0;
+	return true;
+}
+
 void ACInverter::UpdateFlow(double dt)
 
 {
@@ -1010,17 +1356,10 @@ void ACInverter::UpdateFlow(double dt)
 			power_load = 0.0;
 			return;
 		}
-		if(SourceVoltage < 25){ SourceVoltage = 25; } // Regulate this back up to 25
-		if(SourceVoltage > 30){ SourceVoltage = 30; } // Regulate this back down to 30
-		
-		double base_epw_factor = (2.528-(0.144266667*(SourceVoltage - 25)));
-		// Calculate
-		double efactor = (get_epw(base_epw_factor,SourceVoltage)/100);
-		efactor = (1 - efactor)+1;
-
-		//sprintf(oapiDebugString(),"INV: LOAD %f WATT, IV %f VDC, EFFX %f",power_load,SourceVoltage,efactor);
 
-		SRC->DrawPower(power_load * efactor);
+		// In the load-flow pass the DC has already been drawn.
+		if (!load_flow)
+			SRC->DrawPower(power_load * InputFactor(SourceVoltage));
 	}else{
 		// Cannot operate without a source of power.
 		PhaseA.UpdateFlow(dt);
@@ -1233,6 +1572,32 @@ void Cooling::Save(FILEHANDLE scn)
 	oapiWriteScenario_string (scn, "    </COOLING> ", "");
 }
 
+void Cooling::SaveCheckpoint(Checkpoint &cp)
+{
+	e_object::SaveCheckpoint(cp);
+	cp.Put(length);
+	cp.Put(bypassed);
+	cp.Put(coolant_temp);
+	cp.Put(h_pump);
+	cp.Put(min);
+	cp.Put(max);
+	cp.Put(pumping);
+	cp.Put(loaded);
+}
+
+void Cooling::LoadCheckpoint(Checkpoint &cp)
+{
+	e_object::LoadCheckpoint(cp);
+	cp.Get(length);
+	cp.Get(bypassed);
+	cp.Get(coolant_temp);
+	cp.Get(h_pump);
+	cp.Get(min);
+	cp.Get(max);
+	cp.Get(pumping);
+	cp.Get(loaded);
+}
+
 AtmRegen::AtmRegen(char *i_name, int i_pump, int i_pumpH2o, e_object *i_SRC, double i_fan_cap, h_Valve* in_v, h_Valve* out_v, h_Valve *i_H2Owaste) 
 
 {
@@ -1325,6 +1690,26 @@ void AtmRegen::Save(FILEHANDLE scn) {
 	oapiWriteScenario_string (scn, "    <ATMREGEN> ", cbuf);
 }
 
+void AtmRegen::SaveCheckpoint(Checkpoint &cp)
+{
+	e_object::SaveCheckpoint(cp);
+	cp.Put(h_pump);
+	cp.Put(h_pumpH2o);
+	cp.Put(pumping);
+	cp.Put(loaded);
+	cp.Put(co2removalrate);
+}
+
+void AtmRegen::LoadCheckpoint(Checkpoint &cp)
+{
+	e_object::LoadCheckpoint(cp);
+	cp.Get(h_pump);
+	cp.Get(h_pumpH2o);
+	cp.Get(pumping);
+	cp.Get(loaded);
+	cp.Get(co2removalrate);
+}
+
 Boiler::Boiler(char *i_name, int i_pump, e_object *i_src, double heat_watts, double electric_watts,
 		   int i_type, double i_valueMin, double i_valueMax, therm_obj *i_target) {
 
@@ -1416,6 +1801,26 @@ void Boiler::Save(FILEHANDLE scn)
 	oapiWriteScenario_string (scn, "    <BOILER> ", cbuf);
 }
 
+void Boiler::SaveCheckpoint(Checkpoint &cp)
+{
+	e_object::SaveCheckpoint(cp);
+	cp.Put(h_pump);
+	cp.Put(pumping);
+	cp.Put(loaded);
+	cp.Put(valueMin);
+	cp.Put(valueMax);
+}
+
+void Boiler::LoadCheckpoint(Checkpoint &cp)
+{
+	e_object::LoadCheckpoint(cp);
+	cp.Get(h_pump);
+	cp.Get(pumping);
+	cp.Get(loaded);
+	cp.Get(valueMin);
+	cp.Get(valueMax);
+}
+
 
 Pump::Pump(char *i_name, int i_pump, e_object *i_SRC, double i_fan_cap, double i_power, h_Valve* in_v, h_Valve* out_v) 
 
@@ -1455,8 +1860,7 @@ void Pump::refresh(double dt)
 	if (delta_p < 0)
 		delta_p = 0;
 
-	h_volume fanned = in->GetFlow(dt * delta_p);
-	out->Flow(fanned);
+	in->FlowTo(out, dt * delta_p);
 }
 
 void Pump::Load(char *line) 
@@ -1472,3 +1876,19 @@ void Pump::Save(FILEHANDLE scn) {
 	sprintf (cbuf, "%s %i %i %lf", name, h_pump, loaded, fan_cap);
 	oapiWriteScenario_string (scn, "    <PUMP> ", cbuf);
 }
+
+void Pump::SaveCheckpoint(Checkpoint &cp)
+{
+	e_object::SaveCheckpoint(cp);
+	cp.Put(h_pump);
+	cp.Put(pumping);
+	cp.Put(loaded);
+}
+
+void Pump::LoadCheckpoint(Checkpoint &cp)
+{
+	e_object::LoadCheckpoint(cp);
+	cp.Get(h_pump);
+	cp.Get(pumping);
+	cp.Get(loaded);
+}
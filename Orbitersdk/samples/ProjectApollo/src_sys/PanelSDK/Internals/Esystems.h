@@ -98,6 +98,16 @@ public:
 	///
 	virtual void Save(FILEHANDLE scn);
 
+	///
+	/// Derived classes with state of their own should call this first, to save the
+	/// voltage, current and load that every electrical object has.
+	///
+	/// \brief Save state to an in-memory checkpoint.
+	/// \param cp The checkpoint to write to.
+	///
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
+
 	virtual void* GetComponent(char *component_name);
 
 	///
@@ -161,6 +171,40 @@ public:
 	///
 	bool IsEnabled() { return enabled; };
 
+	///
+	/// Objects which split their load between several sources, or convert it before
+	/// passing it on (e.g. inverters), can leave that to the E_system's load-flow pass
+	/// rather than doing it on every DrawPower() call. They return true here, and while
+	/// the pass is on they only add the load to pending_load in DrawPower().
+	///
+	/// \brief Does this object take part in the load-flow pass?
+	/// \return True if it does.
+	///
+	virtual bool DefersLoad() { return false; };
+
+	///
+	/// \brief Pass the pending load on to our sources.
+	/// \return True if there was any load to pass on.
+	///
+	virtual bool PassOnLoad() { return false; };
+
+	///
+	/// Objects whose conversion depends on their total load (e.g. inverters, whose
+	/// efficiency does) return true here, and the load-flow pass only hands their load
+	/// on once nothing else is left to pass on, so it's all in by then.
+	///
+	/// \brief Does this object pass its load on after all the others?
+	///
+	virtual bool HoldsLoad() { return false; };
+
+	///
+	/// \brief Turn the load-flow pass on or off for this object.
+	///
+	/// Sources may also use this to tell that their load is complete when they
+	/// update their flow.
+	///
+	void SetLoadFlow(bool on) { load_flow = on; };
+
 protected:
 	///
 	/// \brief Is this object enabled?
@@ -170,6 +214,9 @@ protected:
     double Amperes; //status
 	double Volts;   //
 	double power_load;	//how much do we need to produce
+
+	bool load_flow;			//the E_system runs the load-flow pass, see DefersLoad()
+	double pending_load;	//load drawn since it was last passed on
 };
 
 class E_system : public ship_system {
@@ -194,6 +241,36 @@ public:
 	void Save(FILEHANDLE scn);
 	void Build();
 	void Refresh(double dt);
+
+	///
+	/// By default the power merges split every DrawPower() call between their
+	/// sources as it comes in, asking each source for its voltage every time, and
+	/// inverters only pass their load on to the DC side in UpdateFlow(), which is
+	/// after their source has already taken its own load for the timestep, so the
+	/// DC load of the AC buses is a timestep late. With the load-flow pass on, these
+	/// objects only note their load down, and at the start of each Refresh() the
+	/// E_system passes it all on down to the sources, repeating until there is
+	/// nothing left to pass on, before any source updates its flow.
+	///
+	/// \brief Pass the loads on once per timestep in the load-flow pass.
+	///
+	void SetLoadFlow(bool on);
+	bool IsLoadFlow() { return LoadFlow; };
+
+protected:
+	void BuildUpdateOrder();
+	void PassOnLoads();
+	int PassOnLoads(bool held, int first);
+
+	///
+	/// \brief SRC of each object in UpdateOrder when it was sorted, to spot rewiring.
+	///
+	e_object **UpdateSRC;
+
+	bool LoadFlow;
+	e_object **Deferring;		///< Objects for which DefersLoad() is true, in the order they are passed
+	int *DeferringPass;			///< Pass in which each of them last passed load on
+	int DeferringCount;
 };
 
 class Socket:public e_object
@@ -206,6 +283,8 @@ class Socket:public e_object
   void refresh(double dt);
   virtual void Load (char *line);
   virtual void Save (FILEHANDLE scn);
+  virtual void SaveCheckpoint(Checkpoint &cp);
+  virtual void LoadCheckpoint(Checkpoint &cp);
   virtual void* GetComponent(char *component_name);
   virtual void BroadcastDemision(ship_object * gonner);
 
@@ -244,8 +323,11 @@ public:
 	void Clogging(double dt);
 	void Load(char *line);
 	void Save(FILEHANDLE scn);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	void* GetComponent(char *component_name);
 	therm_obj* GetThermalInterface() { return (therm_obj*)this; };
+	int GetProbeState(double *state) { state[0] = Volts; state[1] = Temp; return 2; };
 	void UpdateFlow(double dt);
 };
 
@@ -264,11 +346,14 @@ public:
 	virtual void refresh(double dt);
     virtual void Load(char *line);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	void* GetComponent(char *component_name);
 	double Voltage() { return Volts; };
 	double Current();
 	double Capacity() { return power; };
 	virtual therm_obj* GetThermalInterface(){return (therm_obj*)this;};
+	virtual int GetProbeState(double *state) { state[0] = Volts; return 1; };
 
     double max_power; // in Watt * second
 	double power;   //in Watt * second
@@ -348,7 +433,12 @@ public:
 	void refresh(double dt);
 	void Load(char *line);
 	void Save(FILEHANDLE scn);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	void UpdateFlow(double dt);
+	bool DefersLoad() { return true; };
+	bool HoldsLoad() { return true; };
+	bool PassOnLoad();
 	double Current();
 	double Voltage();
 	void ResetOverload() { overload_tripped = false; overload_check_time = 0.0; };
@@ -364,6 +454,8 @@ public:
 	ACPhaseOutput PhaseC;
 
 protected:
+	double InputFactor(double SourceVoltage);	// DC watts drawn per AC watt of power_load
+
 	double ac_voltage;
 	bool overload_tripped;
 
@@ -398,6 +490,8 @@ public:
 	void* GetComponent(char *component_name);
 	virtual void Load(char *line, FILEHANDLE scn);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	virtual void BroadcastDemision(ship_object * gonner){if (SRC==gonner) {SRC=NULL;loaded=0;};};
 };
 
@@ -482,6 +576,8 @@ public:
 	virtual void refresh(double dt);
 	virtual void Load(char *line);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	void *GetComponent(char *component_name);
 	virtual void BroadcastDemision(ship_object * gonner){if (SRC==gonner) {SRC=NULL;loaded=0;};};
 
@@ -508,6 +604,8 @@ public:
 	virtual void refresh(double dt);
 	virtual void Load(char *line);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	void *GetComponent(char *component_name);
 	virtual void BroadcastDemision(ship_object * gonner){if (SRC == gonner) {SRC = NULL; loaded = 0;};};
 };
@@ -536,6 +634,8 @@ public:
 	virtual void refresh(double dt);
 	virtual void Load(char *line);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	virtual void *GetComponent(char *component_name);
 	virtual void BroadcastDemision(ship_object * gonner)
 		{if (SRC == gonner) {SRC = NULL; loaded = 0;};};
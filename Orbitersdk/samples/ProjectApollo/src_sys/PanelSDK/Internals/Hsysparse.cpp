@@ -324,6 +324,10 @@ void H_system::Build() {
 			Create_h_Evaporator(line);
 		else if(Compare(line,"<MIXINGPIPE>"))
 			Create_h_MixingPipe(line);
+		else if(Compare(line,"<IMPLICIT>"))
+			SetImplicit(true);
+		else if(Compare(line,"<ADAPTIVE>"))
+			SetAdaptive(true);
 
 		line = ReadConfigLine();
 	}
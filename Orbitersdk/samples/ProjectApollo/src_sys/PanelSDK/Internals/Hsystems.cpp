@@ -29,7 +29,10 @@
 #include "hsystems.h"
 #include "orbitersdk.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
 #include <math.h>
+#include <vector>
 //const float CONST_R=8.31904f/1000.0f;
 //const float TEMP_PRESS_RATIO=0.07;
 
@@ -69,6 +72,19 @@ ship_system::ship_system()
 
 {
 	List.next=NULL;
+	ListTail=&List;
+	UpdateOrder=NULL;
+	UpdateCount=0;
+	UpdateOrderValid=false;
+	NameIndex=NULL;
+	NameIndexSize=0;
+	NameCount=0;
+	NameIndexValid=false;
+	SortedNames=NULL;
+	SortedCount=0;
+	SortedNamesValid=false;
+	ProbeValues=NULL;
+	ProbesValid=false;
 }
 
 ship_system::~ship_system()
@@ -89,16 +105,34 @@ ship_system::~ship_system()
 		if (second_runner->deletable)
 			delete second_runner;
 	}
+	if (UpdateOrder)
+		delete[] UpdateOrder;
+	if (NameIndex)
+		delete[] NameIndex;
+	if (SortedNames)
+		delete[] SortedNames;
+	if (ProbeValues)
+		delete[] ProbeValues;
 };
 
 ship_object* ship_system::AddSystem(ship_object *object)
 { 
-	ship_object *runner;
-
-	runner=&List;
-	while (runner->next) runner=runner->next;
-	runner->next=object;
+	ListTail->next=object;
 	object->next=NULL;
+	ListTail=object;
+	UpdateOrderValid=false;
+	SortedNamesValid=false;
+
+	//
+	// Keep the name index at most half full, otherwise rebuild it bigger on
+	// the next lookup.
+	//
+	if (NameIndexValid) {
+		if (2 * (NameCount + 1) > NameIndexSize)
+			NameIndexValid=false;
+		else
+			IndexName(object);
+	}
 	return object;
 }
 
@@ -109,6 +143,11 @@ void ship_system::DeleteSystem(ship_object *object)
 	while ((object!=runner->next)&&(runner->next)) runner=runner->next;
 	if (object==runner->next) {
 		runner->next=object->next;
+		if (object==ListTail)
+			ListTail=runner;
+		UpdateOrderValid=false;
+		NameIndexValid=false;
+		SortedNamesValid=false;
 		BroadcastDemision(object);
 		if (object->deletable)
 			 delete object;
@@ -125,25 +164,240 @@ void ship_system::BroadcastDemision(ship_object * gonner)
  					}
 };
 void ship_system::Refresh(double dt)
-{ ship_object *runner;
- runner=List.next;
- while (runner){ runner->refresh(dt);
-				 runner=runner->next;}
+{
+	CheckUpdateOrder();
+
+	for (int i = 0; i < UpdateCount; i++)
+		UpdateOrder[i]->refresh(dt);
 };
 
+void ship_system::CheckUpdateOrder()
+
+{
+	if (UpdateOrderValid)
+		return;
+
+	if (UpdateOrder)
+		delete[] UpdateOrder;
+
+	UpdateCount = 0;
+	ship_object *runner = List.next;
+	while (runner) {
+		UpdateCount++;
+		runner = runner->next;
+	}
+
+	UpdateOrder = UpdateCount ? new ship_object*[UpdateCount] : NULL;
+	BuildUpdateOrder();
+	UpdateOrderValid = true;
+
+	if (ProbeValues)
+		delete[] ProbeValues;
+	ProbeValues = new double[2 * UpdateCount + 2];
+	ProbesValid = false;
+}
+
+double ship_system::MeasureChange()
+
+{
+	CheckUpdateOrder();
+
+	//
+	// The first call after the objects have changed only records the values.
+	//
+	double change = 0.0;
+	for (int i = 0; i < UpdateCount; i++) {
+		double state[2];
+		int n = UpdateOrder[i]->GetProbeState(state);
+
+		for (int j = 0; j < n; j++) {
+			double *last = &ProbeValues[2 * i + j];
+			if (ProbesValid) {
+				//
+				// Relative to the old value, but don't let values near
+				// zero (an unpowered source, an empty tank) blow it up.
+				//
+				double c = fabs(state[j] - *last) / __max(fabs(*last), 1.0);
+				if (c > change)
+					change = c;
+			}
+			*last = state[j];
+		}
+	}
+
+	ProbesValid = true;
+	return change;
+}
+
+void ship_system::BuildUpdateOrder()
+
+{
+	int i = 0;
+	ship_object *runner = List.next;
+	while (runner) {
+		UpdateOrder[i++] = runner;
+		runner = runner->next;
+	}
+}
+
+static unsigned int NameHash(const char *name)
+
+{
+	//
+	// FNV-1a, ignoring case to match stricmp().
+	//
+	unsigned int h = 2166136261u;
+	while (*name) {
+		h ^= (unsigned char) tolower((unsigned char) *name++);
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static int CompareNames(const void *a, const void *b)
+
+{
+	return stricmp((*(ship_object **) a)->name, (*(ship_object **) b)->name);
+}
+
+void ship_system::CheckNameIndex()
+
+{
+	if (NameIndexValid)
+		return;
+
+	int count = 0;
+	ship_object *runner = List.next;
+	while (runner) {
+		count++;
+		runner = runner->next;
+	}
+
+	int size = 64;
+	while (size < 2 * count)
+		size *= 2;
+
+	if (NameIndex)
+		delete[] NameIndex;
+	NameIndex = new ship_object*[size];
+	NameIndexSize = size;
+	NameCount = 0;
+	for (int i = 0; i < size; i++)
+		NameIndex[i] = NULL;
+
+	NameIndexValid = true;
+
+	runner = List.next;
+	while (runner) {
+		IndexName(runner);
+		runner = runner->next;
+	}
+}
+
+void ship_system::IndexName(ship_object *object)
+
+{
+	int h = NameHash(object->name) & (NameIndexSize - 1);
+
+	//
+	// If there are several objects with the same name, the first one in the
+	// list is the one GetSystemByName() has always returned.
+	//
+	ship_object *runner = NameIndex[h];
+	while (runner) {
+		if (!stricmp(runner->name, object->name))
+			return;
+		runner = runner->next_name;
+	}
+
+	object->next_name = NameIndex[h];
+	NameIndex[h] = object;
+	NameCount++;
+}
+
+ship_object* ship_system::FindIndexedName(char *r_name)
+
+{
+	ship_object *runner = NameIndex[NameHash(r_name) & (NameIndexSize - 1)];
+	while (runner) {
+		if (!stricmp(runner->name, r_name))
+			return runner;
+		runner = runner->next_name;
+	}
+	return NULL;
+}
+
+void ship_system::CheckSortedNames()
+
+{
+	if (SortedNamesValid)
+		return;
+
+	SortedCount = 0;
+	ship_object *runner = List.next;
+	while (runner) {
+		SortedCount++;
+		runner = runner->next;
+	}
+
+	if (SortedNames)
+		delete[] SortedNames;
+	SortedNames = SortedCount ? new ship_object*[SortedCount] : NULL;
+
+	int i = 0;
+	runner = List.next;
+	while (runner) {
+		SortedNames[i++] = runner;
+		runner = runner->next;
+	}
+
+	if (SortedCount)
+		qsort(SortedNames, SortedCount, sizeof(ship_object *), CompareNames);
+	SortedNamesValid = true;
+}
+
 ship_object* ship_system::GetSystemByName(char *r_name)
-{ship_object *runner;
- runner=List.next;
- while (runner){ if (!stricmp (runner->name, r_name)) return runner;
-				 runner=runner->next;}
-return NULL;
+{
+	CheckNameIndex();
+
+	ship_object *found = FindIndexedName(r_name);
+	if (found)
+		return found;
+
+	//
+	// Not in the index. Objects can be renamed after they've been added, so
+	// fall back to walking the list before giving up.
+	//
+	ship_object *runner = List.next;
+	while (runner) {
+		if (!stricmp(runner->name, r_name))
+			return runner;
+		runner = runner->next;
+	}
+	return NULL;
 };
+
 void ship_system::SetMaxStage(char *name, int stage)
 {
-ship_object *runner;
- runner=List.next;
- while (runner){ if (!strnicmp (runner->name, name,strlen(name)))runner->max_stage=stage;
-				 runner=runner->next;}
+	int len = strlen(name);
+
+	CheckSortedNames();
+
+	//
+	// Every name starting with 'name' is in one run of the sorted table, so
+	// find the start of it and walk to the end.
+	//
+	int lo = 0, hi = SortedCount;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (strnicmp(SortedNames[mid]->name, name, len) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	while (lo < SortedCount && !strnicmp(SortedNames[lo]->name, name, len))
+		SortedNames[lo++]->max_stage = stage;
 }
 void ship_system::ConfigStage(int stage)
 {ship_object *runner;
@@ -156,6 +410,474 @@ void ship_system::ConfigStage(int stage)
 				};
 }
 
+void ship_system::SaveCheckpoint(Checkpoint &cp)
+{
+	int count = 0;
+	ship_object *runner;
+
+	for (runner = List.next; runner; runner = runner->next)
+		count++;
+	cp.Mark(count);
+	for (runner = List.next; runner; runner = runner->next) {
+		runner->SaveCheckpoint(cp);
+
+		//not all thermal objects are in the thermal engine's list
+		therm_obj *t = runner->GetThermalInterface();
+		if (t) {
+			cp.Put(t->energy);
+			cp.Put(t->Temp);
+		}
+	}
+}
+
+void ship_system::LoadCheckpoint(Checkpoint &cp)
+{
+	int count = 0;
+	ship_object *runner;
+
+	for (runner = List.next; runner; runner = runner->next)
+		count++;
+	if (!cp.Check(count))
+		return;
+	for (runner = List.next; runner && !cp.Failed(); runner = runner->next) {
+		runner->LoadCheckpoint(cp);
+
+		therm_obj *t = runner->GetThermalInterface();
+		if (t) {
+			cp.Get(t->energy);
+			cp.Get(t->Temp);
+		}
+	}
+}
+
+//------------------------------- IMPLICIT PIPE SOLVER ------------------------------------
+
+//
+// The tanks the pipes connect are the nodes of a network, and the pipes its edges. Each
+// timestep the pressure of every node is linearized about its current state, p' = p + dm / C
+// with C from h_volume::GetCompliance(), and the flow through every open pipe about the
+// density of the tank it flows out of, f = g * (p'in - p'out). Backward Euler then gives one
+// equation per node,
+//
+//		C * p' + dt * (sum of f out of the node) = C * p
+//
+// which are solved for all the p' at once, and the pipes move the mass that flows at those.
+// Vents keep their pressure. The nodes fall apart into the separate loops of the vessel, and
+// each of those is small enough to be solved with a dense elimination. Which tanks and pipes
+// make up the groups only changes when objects are added, removed or disconnected, so that
+// is worked out once and kept until then.
+//
+
+class h_PipeNetwork
+{
+public:
+	h_PipeNetwork() { Valid = false; };
+
+	void Invalidate() { Valid = false; };
+	void Solve(ship_object **objects, int count, double dt);
+
+protected:
+	struct Node {
+		h_Tank *tank;
+		int group;			// -1 for a vent
+		int index;			// within the group
+		double p;			// pressure now (Pa)
+		double c;			// compliance (g/Pa), 0 to keep the pressure
+	};
+
+	struct Edge {
+		h_Pipe *pipe;
+		h_Valve *in;		// as when the network was built, to notice changes
+		h_Valve *out;
+		int a;				// node of in
+		int b;				// node of out
+		int dir;			// this timestep: 1 from in to out, -1 back, 0 no flow
+		bool capped;		// PREG with the inlet above P_max
+		double g;			// conductance (g/s/Pa)
+	};
+
+	struct Group {
+		int size;
+		int matrix;			// offset into Matrix, size * size entries
+		int first;			// offset into Rhs, size entries
+	};
+
+	void Build(ship_object **objects, int count);
+	int AddNode(h_Tank *tank);
+	int FindRoot(std::vector<int> &parent, int i);
+	void AddTerm(int row, int col, double value);
+	double NewPress(int node);
+	static void Eliminate(double *m, double *x, int n);
+
+	std::vector<Node> Nodes;
+	std::vector<Edge> Edges;
+	std::vector<Group> Groups;
+	std::vector<double> Matrix;
+	std::vector<double> Rhs;
+	bool Valid;
+};
+
+int h_PipeNetwork::AddNode(h_Tank *tank)
+
+{
+	for (int i = 0; i < (int) Nodes.size(); i++)
+		if (Nodes[i].tank == tank)
+			return i;
+
+	Node n;
+	n.tank = tank;
+	n.group = dynamic_cast<h_Vent *>(tank) ? -1 : 0;
+	n.index = 0;
+	n.p = 0;
+	n.c = 0;
+	Nodes.push_back(n);
+	return (int) Nodes.size() - 1;
+}
+
+int h_PipeNetwork::FindRoot(std::vector<int> &parent, int i)
+
+{
+	while (parent[i] != i)
+		i = parent[i] = parent[parent[i]];
+	return i;
+}
+
+void h_PipeNetwork::Build(ship_object **objects, int count)
+
+{
+	int i;
+
+	Nodes.clear();
+	Edges.clear();
+	Groups.clear();
+
+	//
+	// Pressure valves change tank volumes rather than move mass, so they're left to h_Pipe.
+	//
+	for (i = 0; i < count; i++) {
+		h_Pipe *pipe = dynamic_cast<h_Pipe *>(objects[i]);
+		if (!pipe || pipe->type == 3 || !pipe->in || !pipe->out)
+			continue;
+
+		Edge e;
+		e.pipe = pipe;
+		e.in = pipe->in;
+		e.out = pipe->out;
+		e.a = AddNode(pipe->in->parent);
+		e.b = AddNode(pipe->out->parent);
+		e.dir = 0;
+		e.capped = false;
+		e.g = 0;
+		Edges.push_back(e);
+	}
+
+	//
+	// Group the nodes that are connected other than through a vent.
+	//
+	std::vector<int> parent(Nodes.size());
+	for (i = 0; i < (int) Nodes.size(); i++)
+		parent[i] = i;
+
+	for (i = 0; i < (int) Edges.size(); i++) {
+		Edge &e = Edges[i];
+		if (Nodes[e.a].group >= 0 && Nodes[e.b].group >= 0)
+			parent[FindRoot(parent, e.a)] = FindRoot(parent, e.b);
+	}
+
+	std::vector<int> groupOf(Nodes.size(), -1);
+	int matrix = 0, first = 0;
+	for (i = 0; i < (int) Nodes.size(); i++) {
+		if (Nodes[i].group < 0)
+			continue;
+
+		int root = FindRoot(parent, i);
+		if (groupOf[root] < 0) {
+			Group g;
+			g.size = 0;
+			groupOf[root] = (int) Groups.size();
+			Groups.push_back(g);
+		}
+		Nodes[i].group = groupOf[root];
+		Nodes[i].index = Groups[Nodes[i].group].size++;
+	}
+
+	for (i = 0; i < (int) Groups.size(); i++) {
+		Groups[i].matrix = matrix;
+		Groups[i].first = first;
+		matrix += Groups[i].size * Groups[i].size;
+		first += Groups[i].size;
+	}
+	Matrix.resize(matrix);
+	Rhs.resize(first);
+
+	Valid = true;
+}
+
+void h_PipeNetwork::AddTerm(int row, int col, double value)
+
+{
+	//
+	// value * p'col into the equation of row. Nodes whose pressure is kept have
+	// no equation, and go to the right hand side as constants.
+	//
+	Node &r = Nodes[row];
+	if (r.group < 0 || r.c <= 0)
+		return;
+
+	Group &g = Groups[r.group];
+	Node &c = Nodes[col];
+	if (c.group == r.group && c.c > 0)
+		Matrix[g.matrix + r.index * g.size + c.index] += value;
+	else
+		Rhs[g.first + r.index] -= value * c.p;
+}
+
+double h_PipeNetwork::NewPress(int node)
+
+{
+	Node &n = Nodes[node];
+	if (n.group < 0 || n.c <= 0)
+		return n.p;
+	return Rhs[Groups[n.group].first + n.index];
+}
+
+void h_PipeNetwork::Eliminate(double *m, double *x, int n)
+
+{
+	//
+	// Gaussian elimination with partial pivoting, leaving the solution in x.
+	//
+	int i, j, k;
+
+	for (k = 0; k < n; k++) {
+		int pivot = k;
+		for (i = k + 1; i < n; i++)
+			if (fabs(m[i * n + k]) > fabs(m[pivot * n + k]))
+				pivot = i;
+
+		if (pivot != k) {
+			for (j = k; j < n; j++) {
+				double t = m[k * n + j];
+				m[k * n + j] = m[pivot * n + j];
+				m[pivot * n + j] = t;
+			}
+			double t = x[k];
+			x[k] = x[pivot];
+			x[pivot] = t;
+		}
+
+		double d = m[k * n + k];
+		if (d == 0)
+			continue;
+
+		for (i = k + 1; i < n; i++) {
+			double f = m[i * n + k] / d;
+			if (f == 0)
+				continue;
+			for (j = k + 1; j < n; j++)
+				m[i * n + j] -= f * m[k * n + j];
+			x[i] -= f * x[k];
+		}
+	}
+
+	for (k = n - 1; k >= 0; k--) {
+		double s = x[k];
+		for (j = k + 1; j < n; j++)
+			s -= m[k * n + j] * x[j];
+		x[k] = (m[k * n + k] != 0) ? s / m[k * n + k] : 0;
+	}
+}
+
+void h_PipeNetwork::Solve(ship_object **objects, int count, double dt)
+
+{
+	int i;
+
+	for (i = 0; Valid && i < (int) Edges.size(); i++)
+		if (Edges[i].pipe->in != Edges[i].in || Edges[i].pipe->out != Edges[i].out)
+			Valid = false;
+
+	if (!Valid)
+		Build(objects, count);
+
+	if (dt <= 0)
+		return;
+
+	for (i = 0; i < (int) Nodes.size(); i++) {
+		h_volume &space = Nodes[i].tank->space;
+		Nodes[i].p = space.Press;
+		Nodes[i].c = (space.Volume > 0) ? space.GetCompliance() : 0;
+	}
+
+	//
+	// Which way each pipe flows, decided the way h_Pipe::refresh() does.
+	//
+	for (i = 0; i < (int) Edges.size(); i++) {
+		Edge &e = Edges[i];
+		h_Pipe *pipe = e.pipe;
+
+		pipe->solved = true;
+		pipe->flow = 0;
+		e.dir = 0;
+		e.capped = false;
+		if (!e.in->open || !e.out->open)
+			continue;
+
+		double in_p = e.in->GetPress();
+		double out_p = e.out->GetPress();
+		double press = in_p;
+
+		if (pipe->type == 1) {	//PREG
+			e.capped = (in_p > pipe->P_max);
+			press = (e.capped ? pipe->P_max : in_p);
+
+		} else if (pipe->type == 2) {	//BURST
+			if (in_p - out_p > pipe->P_max) pipe->open = 1;
+			if (in_p - out_p < pipe->P_min) pipe->open = 0;
+			if (pipe->open == 0) continue;
+		}
+
+		h_Valve *from;
+		if (press > out_p) {
+			e.dir = 1;
+			from = e.in;
+		} else if (pipe->two_ways && out_p > in_p) {
+			e.dir = -1;
+			e.capped = false;
+			from = e.out;
+		} else
+			continue;
+
+		//
+		// h_volume::Break() moves the fraction vol / Volume of what the tank lets out.
+		//
+		h_volume &space = from->parent->space;
+		double mass = 0;
+		for (int j = 0; j < MAX_SUB; j++)
+			mass += space.composition[j].mass * from->parent->OUT_FLOW_MASK[j];
+
+		e.g = (space.Volume > 0) ? from->size / 1000.0 * mass / space.Volume : 0;
+		if (e.g <= 0)
+			e.dir = 0;
+	}
+
+	//
+	// Set up the equations and solve them, group by group.
+	//
+	for (i = 0; i < (int) Matrix.size(); i++)
+		Matrix[i] = 0;
+
+	for (i = 0; i < (int) Nodes.size(); i++) {
+		Node &n = Nodes[i];
+		if (n.group < 0)
+			continue;
+
+		Group &g = Groups[n.group];
+		if (n.c > 0) {
+			Matrix[g.matrix + n.index * g.size + n.index] = n.c;
+			Rhs[g.first + n.index] = n.c * n.p;
+		} else {
+			Matrix[g.matrix + n.index * g.size + n.index] = 1.0;
+			Rhs[g.first + n.index] = n.p;
+		}
+	}
+
+	for (i = 0; i < (int) Edges.size(); i++) {
+		Edge &e = Edges[i];
+		if (!e.dir)
+			continue;
+
+		double k = dt * e.g;
+		if (e.capped) {
+			// f = g * (P_max - p'out)
+			AddTerm(e.a, e.b, -k);
+			AddTerm(e.b, e.b, k);
+			if (Nodes[e.a].group >= 0 && Nodes[e.a].c > 0)
+				Rhs[Groups[Nodes[e.a].group].first + Nodes[e.a].index] -= k * e.pipe->P_max;
+			if (Nodes[e.b].group >= 0 && Nodes[e.b].c > 0)
+				Rhs[Groups[Nodes[e.b].group].first + Nodes[e.b].index] += k * e.pipe->P_max;
+		} else {
+			// f = g * (p'in - p'out)
+			AddTerm(e.a, e.a, k);
+			AddTerm(e.a, e.b, -k);
+			AddTerm(e.b, e.b, k);
+			AddTerm(e.b, e.a, -k);
+		}
+	}
+
+	for (i = 0; i < (int) Groups.size(); i++) {
+		Group &g = Groups[i];
+		Eliminate(&Matrix[g.matrix], &Rhs[g.first], g.size);
+	}
+
+	//
+	// Now move the mass that flows at the new pressures.
+	//
+	for (i = 0; i < (int) Edges.size(); i++) {
+		Edge &e = Edges[i];
+		if (!e.dir)
+			continue;
+
+		h_Pipe *pipe = e.pipe;
+		double dp = (e.capped ? pipe->P_max : NewPress(e.a)) - NewPress(e.b);
+
+		if (e.dir > 0 && dp > 0)
+			pipe->flow = e.in->FlowTo(e.out, dt * dp, pipe->flowMax * dt) / dt;
+		else if (e.dir < 0 && dp < 0)
+			pipe->flow = -e.out->FlowTo(e.in, -dt * dp) / dt;
+	}
+}
+
+H_system::H_system()
+
+{
+	Implicit = false;
+	Adaptive = false;
+	Network = NULL;
+	FirstPipe = 0;
+}
+
+H_system::~H_system()
+
+{
+	if (Network)
+		delete Network;
+}
+
+void H_system::Refresh(double dt)
+
+{
+	CheckUpdateOrder();
+
+	//
+	// The pipes work with the pressures the tanks before them have just worked out, so
+	// the flows are solved for where the first pipe would have made its own.
+	//
+	for (int i = 0; i <= UpdateCount; i++) {
+		if (Implicit && i == FirstPipe) {
+			if (!Network)
+				Network = new h_PipeNetwork;
+			Network->Solve(UpdateOrder, UpdateCount, dt);
+		}
+		if (i < UpdateCount)
+			UpdateOrder[i]->refresh(dt);
+	}
+}
+
+void H_system::BuildUpdateOrder()
+
+{
+	ship_system::BuildUpdateOrder();
+
+	FirstPipe = UpdateCount;
+	for (int i = UpdateCount - 1; i >= 0; i--)
+		if (dynamic_cast<h_Pipe *>(UpdateOrder[i]))
+			FirstPipe = i;
+
+	if (Network)
+		Network->Invalidate();
+}
+
 void H_system::Save(FILEHANDLE scn) { 
 	
 	ship_object *runner;
@@ -399,6 +1121,17 @@ h_volume h_volume::Break(double vol,int * mask, double maxMass) {
 
 	h_volume temp;
 
+	Transfer(&temp, vol, mask, maxMass);
+	return temp;   //then feed it to the requester
+}
+
+double h_volume::Transfer(h_volume *to, double vol, int *mask, double maxMass) {
+
+	//
+	// Moves the substances in place rather than through an h_volume handed around by
+	// value, but with the very same arithmetic as Break() and operator+= had, so the
+	// results don't change down to the last bit.
+	//
 	double ratio = vol / Volume;
 	// TSCH
 	//if (ratio > 1) ratio = 1.;
@@ -410,12 +1143,37 @@ h_volume h_volume::Break(double vol,int * mask, double maxMass) {
 		}
 	}
 
-	for (int i=0; i<MAX_SUB; i++) {
-		temp += composition[i] * (float) ratio * (float) mask[i];
-		composition[i] -= temp.composition[i];
-		Q -= temp.composition[i].Q;
+	float r = (float) ratio;
+	double moved = 0;
+	double movedQ = 0;
+
+	for (int i = 0; i < MAX_SUB; i++) {
+		h_substance &s = composition[i];
+		float m = (float) mask[i];
+		double d_mass = s.mass * r * m;
+		double d_Q = s.Q * r * m;
+		double d_vapor = s.vapor_mass * r * m;
+
+		s.mass -= d_mass;
+		s.Q -= d_Q;
+		s.vapor_mass -= d_vapor;
+		Q -= d_Q;
+
+		if (to) {
+			h_substance &d = to->composition[i];
+			d.mass += d_mass;
+			d.Q += d_Q;
+			d.vapor_mass += d_vapor;
+		}
+		moved += d_mass;
+		movedQ += d_Q;
 	}
-	return temp;   //then feed it to the requester
+
+	if (to) {
+		to->Q += movedQ;
+		to->GetMaxSub();
+	}
+	return moved;
 }
 
 double h_volume::GetMass() {
@@ -438,6 +1196,23 @@ double h_volume::GetQ() {
 	return q;
 }
 
+static double LiquidDensity(int subst_type, double Temp) {
+
+	// temperature dependency of the density is assumed 1 to 2 g/l
+	double density = L_DENSITY[subst_type];
+	if (subst_type == SUBSTANCE_O2) {
+		// Liquid density is temperature dependend because of cryo tank pressurization with a heater
+		// Correction term is 0 at O2 initial tank temperature (75K), the other factors are "empirical"
+		density += 0.56 * Temp * Temp - 134.0 * Temp + 6900.0;
+
+	} else if (subst_type == SUBSTANCE_H2) {
+		// Liquid density is temperature dependend because of cryo tank pressurization with a heater
+		// Correction term is 0 at H2 boiling point (20K), the other factors are "empirical"
+		density += 0.03333 * Temp * Temp - 4.3333 * Temp + 73.3333;
+	}
+	return density;
+}
+
 void h_volume::ThermalComps(double dt) {
 	//1. averaging temperature, based on Q
 	//2. computing vapor pressure based on new temp, for each subst present
@@ -469,18 +1244,7 @@ void h_volume::ThermalComps(double dt) {
 	for (i = 0; i < MAX_SUB; i++) {
 		m_i += composition[i].vapor_mass / MMASS[composition[i].subst_type];
 
-		// temperature dependency of the density is assumed 1 to 2 g/l
-		double density = L_DENSITY[composition[i].subst_type];
-		if (composition[i].subst_type == SUBSTANCE_O2) {
-			// Liquid density is temperature dependend because of cryo tank pressurization with a heater
-			// Correction term is 0 at O2 initial tank temperature (75K), the other factors are "empirical"
-			density += 0.56 * Temp * Temp - 134.0 * Temp + 6900.0;
-
-		} else if (composition[i].subst_type == SUBSTANCE_H2) {
-			// Liquid density is temperature dependend because of cryo tank pressurization with a heater
-			// Correction term is 0 at H2 boiling point (20K), the other factors are "empirical"
-			density += 0.03333 * Temp * Temp - 4.3333 * Temp + 73.3333;
-		}
+		double density = LiquidDensity(composition[i].subst_type, Temp);
 		tNV = (composition[i].mass - composition[i].vapor_mass) / density;
 		NV += tNV;
 
@@ -510,6 +1274,38 @@ void h_volume::ThermalComps(double dt) {
 	}
 }
 
+double h_volume::GetCompliance() {
+
+	//
+	// ThermalComps() gets Press from P^2*PNV + P*(Volume - LV) + m_i = 0. Adding a fraction e
+	// of the contents scales PNV, LV and m_i by (1 + e), so differentiate that by e.
+	//
+	double m_i = 0;
+	double LV = 0;
+	double PNV = 0;
+	int i;
+
+	for (i = 0; i < MAX_SUB; i++) {
+		m_i += composition[i].vapor_mass / MMASS[composition[i].subst_type];
+		double tNV = (composition[i].mass - composition[i].vapor_mass) / LiquidDensity(composition[i].subst_type, Temp);
+		LV += tNV;
+		PNV += tNV / BULK_MOD[composition[i].subst_type];
+	}
+	m_i = -m_i * R_CONST * Temp;
+
+	double dFdP = 2.0 * Press * PNV + Volume - LV;
+	double dFde = Press * Press * PNV - Press * LV + m_i;
+	double mass = GetMass();
+
+	if (mass > 0 && dFdP > 0 && dFde < 0)
+		return mass * dFdP / -dFde;
+
+	//
+	// Empty, or nothing sensible to go on: take it to be filled with air at room temperature.
+	//
+	return Volume * 29.0 / (R_CONST * 290.0);
+}
+
 void h_volume::Void()
 {
 	for (int i = 0; i < MAX_SUB; i++) {
@@ -593,6 +1389,15 @@ h_volume h_Valve::GetFlow(double dPdT, double maxMass) {
 	return parent->GetFlow(vol, maxMass);
 }
 
+double h_Valve::FlowTo(h_Valve *to, double dPdT, double maxMass) {
+
+	double vol = dPdT * size / 1000.0;		//size= Liters/Pa/second
+
+	if (!open) vol = 0; //no flow obviously
+	//a closed valve at the other end swallows the block, as Flow() does
+	return parent->FlowTo(to->open ? to->parent : NULL, vol, maxMass);
+}
+
 void h_Valve::Refresh(double dt) {
 
 	if (h_open)	{	
@@ -615,6 +1420,17 @@ void h_Valve::Refresh(double dt) {
 	}
 }
 
+void h_Valve::SaveCheckpoint(Checkpoint &cp) {
+
+	CHECKPOINT_RANGE(h_Valve, open, size);
+	cp.PutRange(open, size);
+}
+
+void h_Valve::LoadCheckpoint(Checkpoint &cp) {
+
+	cp.GetRange(open, size);
+}
+
 
 //------------------------------- TANK CLASS ------------------------------------
 
@@ -658,6 +1474,27 @@ int h_Tank::Flow(h_volume block) {	//add the block to the tank
 	return 1;
 }
 
+double h_Tank::FlowTo(h_Tank *to, double volume, double maxMass) {
+
+	double moved;
+	if (to)
+		moved = to->FlowFrom(space, volume, OUT_FLOW_MASK, maxMass);
+	else
+		moved = space.Transfer(NULL, volume, OUT_FLOW_MASK, maxMass);
+
+	mass -= moved;
+	return moved;
+}
+
+double h_Tank::FlowFrom(h_volume &source, double volume, int *mask, double maxMass) {
+
+	double moved = source.Transfer(&space, volume, mask, maxMass);
+	mass += moved;
+	Temp = space.Temp;
+	energy = space.Q;
+	return moved;
+}
+
 void h_Tank::thermic(double _en) {
 
 	if (-_en > space.Q)
@@ -668,6 +1505,29 @@ void h_Tank::thermic(double _en) {
 	energy += _en;
 }
 
+int h_Tank::GetProbeState(double *state) {
+
+	//
+	// The pressure in the small liquid-filled volumes of the coolant and water loops
+	// jumps around from step to step at any sensible step length, so only watch the
+	// temperature of those, and ignore the tiny inlet and outlet volumes altogether.
+	//
+	if (space.Volume < 1.0)
+		return 0;
+
+	state[0] = space.Temp;
+
+	double vapor = 0;
+	for (int i = 0; i < MAX_SUB; i++)
+		vapor += space.composition[i].vapor_mass;
+
+	if (vapor > 0.5 * space.total_mass) {
+		state[1] = space.Press;
+		return 2;
+	}
+	return 1;
+}
+
 void h_Tank::refresh(double dt) {
 
 	/*if (Compare("ACCU", name) || Compare("EVAPOUTLET", name)) {	// TSCH Test
@@ -744,6 +1604,26 @@ void h_Tank::Save(FILEHANDLE scn) {
 	oapiWriteScenario_string(scn, "   </TANK>","");
 }
 
+void h_Tank::SaveCheckpoint(Checkpoint &cp) {
+
+	cp.Put(space);
+	IN_valve.SaveCheckpoint(cp);
+	OUT_valve.SaveCheckpoint(cp);
+	OUT2_valve.SaveCheckpoint(cp);
+	LEAK_valve.SaveCheckpoint(cp);
+	cp.Put(mass);
+}
+
+void h_Tank::LoadCheckpoint(Checkpoint &cp) {
+
+	cp.Get(space);
+	IN_valve.LoadCheckpoint(cp);
+	OUT_valve.LoadCheckpoint(cp);
+	OUT2_valve.LoadCheckpoint(cp);
+	LEAK_valve.LoadCheckpoint(cp);
+	cp.Get(mass);
+}
+
 // These are hacks and should be used only in special cases. Violates energy conservation
 
 void h_Tank::BoilAllAndSetTemp(double _t) {
@@ -774,6 +1654,7 @@ h_Pipe::h_Pipe(char *i_name, h_Valve *i_IN, h_Valve *i_OUT, int i_type, double m
 	open = 0;
 	flow = 0;
 	flowMax = 0;
+	solved = false;
 }
 
 void h_Pipe::BroadcastDemision(ship_object * gonner) {
@@ -790,14 +1671,19 @@ void h_Pipe::refresh(double dt) {
 	*/
 
 	//volume flow bases on press difference
-	flow = 0;
+	bool solvedFlow = solved;
+	solved = false;
+	if (!solvedFlow) flow = 0;
 	if ((!in) || (!out)) return;
 	if (out->open && in->open) {
 
 		double in_p = in->GetPress();
 		double out_p = out->GetPress();
 
-		if (type == 1) {	  //PREG
+		if (solvedFlow) {	//the implicit solver in H_system has made the flow already
+			if (type == 2 && open == 0) return;
+
+		} else if (type == 1) {	  //PREG
 			in_p = (in_p > P_max ? P_max : in_p);
 
 		} else if (type == 2) { //BURST
@@ -824,17 +1710,11 @@ void h_Pipe::refresh(double dt) {
 			return;
 		}
 
-		if (in_p > out_p) {
-			h_volume v = in->GetFlow(dt * (in_p - out_p), flowMax * dt);
-			flow = v.GetMass() / dt; 
-			out->Flow(v);
-		}
+		if (!solvedFlow && in_p > out_p)
+			flow = in->FlowTo(out, dt * (in_p - out_p), flowMax * dt) / dt;
 
-		if ((two_ways) && (out_p > in->GetPress())) {
-			h_volume v = out->GetFlow(dt * (out_p - in_p));
-			flow -= v.GetMass() / dt; 
-			in->Flow(v);
-		}
+		if ((!solvedFlow) && (two_ways) && (out_p > in->GetPress()))
+			flow -= out->FlowTo(in, dt * (out_p - in_p)) / dt;
 
 		//heat transfer is directly prop with deltaT.
 		//all other conductive heat props are ignored.. ie. time for actual
@@ -870,6 +1750,24 @@ void h_Pipe::Save(FILEHANDLE scn) {
 	}
 }
 
+void h_Pipe::SaveCheckpoint(Checkpoint &cp) {
+
+	cp.Put(open);
+	cp.Put(flow);
+	cp.Put(P_max);
+	cp.Put(P_min);
+	cp.Put(flowMax);
+}
+
+void h_Pipe::LoadCheckpoint(Checkpoint &cp) {
+
+	cp.Get(open);
+	cp.Get(flow);
+	cp.Get(P_max);
+	cp.Get(P_min);
+	cp.Get(flowMax);
+}
+
 h_Vent::h_Vent(char *i_name, vector3 i_p) : h_Tank(i_name, i_p, 0.0) {
 	
 	space.Void();
@@ -912,6 +1810,12 @@ int h_Vent::Flow(h_volume block) {
 	return 1;
 }
 
+double h_Vent::FlowFrom(h_volume &source, double volume, int *mask, double maxMass) {
+
+	space.Press = 0;
+	return source.Transfer(NULL, volume, mask, maxMass);
+}
+
 
 h_Radiator::h_Radiator(char *i_name,vector3 i_pi,double i_size,double i_rad) {
 
@@ -945,6 +1849,18 @@ void h_Radiator::Save(FILEHANDLE scn) {
 	oapiWriteScenario_string(scn, "   <RADIATOR>", text);
 }
 
+void h_Radiator::SaveCheckpoint(Checkpoint &cp) {
+
+	cp.Put(rad);
+	cp.Put(size);
+}
+
+void h_Radiator::LoadCheckpoint(Checkpoint &cp) {
+
+	cp.Get(rad);
+	cp.Get(size);
+}
+
 
 h_HeatExchanger::h_HeatExchanger(char *i_name, int i_pump, double i_length, therm_obj *i_source, therm_obj *i_target, double i_tempMin, double i_tempMax) {
 
@@ -999,6 +1915,26 @@ void h_HeatExchanger::Save(FILEHANDLE scn) {
 	oapiWriteScenario_string(scn, "   <HEATEXCHANGER>", text);
 }
 
+void h_HeatExchanger::SaveCheckpoint(Checkpoint &cp) {
+
+	cp.Put(h_pump);
+	cp.Put(length);
+	cp.Put(tempMin);
+	cp.Put(tempMax);
+	cp.Put(power);
+	cp.Put(bypassed);
+}
+
+void h_HeatExchanger::LoadCheckpoint(Checkpoint &cp) {
+
+	cp.Get(h_pump);
+	cp.Get(length);
+	cp.Get(tempMin);
+	cp.Get(tempMax);
+	cp.Get(power);
+	cp.Get(bypassed);
+}
+
 
 h_Evaporator::h_Evaporator(char *i_name, int i_pump, therm_obj *i_target, double i_targetTemp, h_Valve *i_liquidSource, double i_tempTurnOn, therm_obj *i_tempControl) {
 
@@ -1094,6 +2030,26 @@ void h_Evaporator::Save(FILEHANDLE scn) {
 	oapiWriteScenario_string(scn, "   <EVAPORATOR>", text);
 }
 
+void h_Evaporator::SaveCheckpoint(Checkpoint &cp) {
+
+	cp.Put(h_pump);
+	cp.Put(h_valve);
+	cp.Put(throttle);
+	cp.Put(steamPressure);
+	cp.Put(targetTemp);
+	cp.Put(tempTurnOn);
+}
+
+void h_Evaporator::LoadCheckpoint(Checkpoint &cp) {
+
+	cp.Get(h_pump);
+	cp.Get(h_valve);
+	cp.Get(throttle);
+	cp.Get(steamPressure);
+	cp.Get(targetTemp);
+	cp.Get(tempTurnOn);
+}
+
 
 h_MixingPipe::h_MixingPipe(char *i_name, int i_pump, h_Valve *i_in1, h_Valve *i_in2, h_Valve *i_out, double i_targetTemp) {
 
@@ -1137,15 +2093,11 @@ void h_MixingPipe::refresh(double dt) {
 		double in2_p = in2->GetPress();
 		double out_p = out->GetPress();
 
-		if (in1_p > out_p) {
-			h_volume v = in1->GetFlow(ratio * dt * (in1_p - out_p));
-			out->Flow(v);
-		}
+		if (in1_p > out_p)
+			in1->FlowTo(out, ratio * dt * (in1_p - out_p));
 
-		if (in2_p > out_p) {
-			h_volume v = in2->GetFlow((1.0 - ratio) * dt * (in2_p - out_p));
-			out->Flow(v);
-		}
+		if (in2_p > out_p)
+			in2->FlowTo(out, (1.0 - ratio) * dt * (in2_p - out_p));
 	}
 }
 
@@ -1157,6 +2109,20 @@ void h_MixingPipe::Save(FILEHANDLE scn) {
 	oapiWriteScenario_string(scn, "   <MIXINGPIPE>", text);
 }
 
+void h_MixingPipe::SaveCheckpoint(Checkpoint &cp) {
+
+	cp.Put(h_pump);
+	cp.Put(targetTemp);
+	cp.Put(ratio);
+}
+
+void h_MixingPipe::LoadCheckpoint(Checkpoint &cp) {
+
+	cp.Get(h_pump);
+	cp.Get(targetTemp);
+	cp.Get(ratio);
+}
+
 
 h_crew::h_crew(char *i_name, int nr, h_Tank *i_src) {
 	
@@ -1204,3 +2170,13 @@ void h_crew::Save(FILEHANDLE scn) {
 	sprintf(text," %s %i", name, number);
 	oapiWriteScenario_string(scn, "   <CREW>", text);
 }
+
+void h_crew::SaveCheckpoint(Checkpoint &cp) {
+
+	cp.Put(number);
+}
+
+void h_crew::LoadCheckpoint(Checkpoint &cp) {
+
+	cp.Get(number);
+}
@@ -86,6 +86,7 @@ class h_volume
 	void operator+=(h_volume);		//add two volumes together
 	void operator+=(h_substance);	//or simply add some sub. to the volume
 	h_volume Break(double vol, int* mask, double maxMass = 0);		//break 'vol' liters from the volume ..into another volume
+	double Transfer(h_volume *to, double vol, int *mask, double maxMass = 0);	//same, but straight into 'to' (or nowhere if NULL), returns grams moved
 	void GetMaxSub();				//re-computes number of substances present in the volume
 	double GetMass();				//total mass inside the volume
 	double GetQ();
@@ -95,10 +96,12 @@ class h_volume
 	double Temp;					//averaged temp of volume.. (K)
 	double Volume;					//liters
 	void ThermalComps(double dt);			//levels temp troughout all subst...much like stirring a tank,only instanaeously
+	double GetCompliance();			//mass (g) it takes to raise Press by 1 Pa, at the current composition
 	void Void();					//empty all inside the volume
 };
 h_substance _substance(int s_type,double i_mass, double i_Q,float i_vm);
 class H_system;
+class h_PipeNetwork;
 class h_object:public ship_object				//:public therm_obj
 { 
 public:
@@ -120,11 +123,46 @@ class H_system:public ship_system
 	void Create_h_MixingPipe(char *line);
 
 public:
+	H_system();
+	~H_system();
 
 	void Load (FILEHANDLE scn);
 	void Save (FILEHANDLE scn);
 	void Build();
 	void ProcessShip(VESSEL *vessel, PROPELLANT_HANDLE ph);
+	void Refresh(double dt);
+
+	///
+	/// By default each pipe moves mass on its own, in proportion to the pressure
+	/// difference it sees at the start of the timestep. That overshoots unless the
+	/// timestep is short, especially between liquid-filled volumes. The implicit
+	/// solver instead works out the pressures at the end of the timestep for all
+	/// the tanks connected by pipes at once, and moves the mass that flows at those,
+	/// so it stays stable at timesteps of several seconds. Pressure valves (PVALVE)
+	/// and the other hydraulic objects work as before.
+	///
+	/// \brief Use the implicit solver for the pipe flows.
+	///
+	void SetImplicit(bool implicit) { Implicit = implicit; };
+	bool IsImplicit() { return Implicit; };
+
+	///
+	/// By default the PanelSDK runs the systems in fixed slices of up to 0.5 s. With
+	/// adaptive substeps the slices shrink while the tanks or sources change quickly,
+	/// and the hydraulics run less often while they're quiet. See PanelSDK::SimpleTimestep().
+	///
+	/// \brief Use adaptive substeps for the systems timestep.
+	///
+	void SetAdaptive(bool adaptive) { Adaptive = adaptive; };
+	bool IsAdaptive() { return Adaptive; };
+
+protected:
+	void BuildUpdateOrder();
+
+	bool Implicit;
+	bool Adaptive;
+	h_PipeNetwork *Network;		///< Created on the first implicit Refresh()
+	int FirstPipe;				///< Index in UpdateOrder of the first h_Pipe
 };
 
 class h_Tank;
@@ -148,8 +186,11 @@ public:
 	void thermic(double _en);
 	int Flow(h_volume block);//block of substance flowing INTO  the valve
 	h_volume GetFlow(double dPdT, double maxMass = 0);//deltaP * deltaT gives us flow rate OUTOF(in volume)
+	double FlowTo(h_Valve *to, double dPdT, double maxMass = 0);//GetFlow() and to->Flow() in one go, returns grams moved
 	void Refresh(double dt);	//for open/close updating
 	virtual void* GetComponent(char *component_name);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 };
 
 class h_Tank : public h_object, public therm_obj {	//tanks is just a basic receptacle of liquid or gas..
@@ -170,11 +211,16 @@ public:
 	virtual	void refresh(double dt);	//this called at each timestep
 	virtual int Flow(h_volume block);
 	h_volume GetFlow(double volume, double maxMass = 0);	//flow from a tank is defined in volume
+	double FlowTo(h_Tank *to, double volume, double maxMass = 0);	//GetFlow() and to->Flow() in one go, returns grams moved
+	virtual double FlowFrom(h_volume &source, double volume, int *mask, double maxMass);	//the receiving end of FlowTo()
 	virtual void thermic( double _en);  //tank has it's own termic function, to account for the h_volume
 	virtual void Load(FILEHANDLE scn);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	virtual void* GetComponent(char *component_name);
 	virtual therm_obj* GetThermalInterface(){return (therm_obj*)this;};
+	virtual int GetProbeState(double *state);
 
 	void BoilAllAndSetTemp(double _t);	//This is a hack and should be used only in special cases. Violates energy conservation	
 
@@ -193,12 +239,15 @@ public:
 	h_Valve *out;
 	double flow;	// in g/s
 	double flowMax;
+	bool solved;	// flow already made by the implicit solver this timestep
 
 	h_Pipe(char *i_name, h_Valve *i_IN, h_Valve *i_OUT, int i_type, double max, double min, int is_two);
 	virtual	void refresh(double dt);	//this called at each timestep
 	virtual void* GetComponent(char *component_name);
 	void BroadcastDemision(ship_object * gonner);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 };
 
 class h_Vent: public h_Tank
@@ -208,6 +257,7 @@ class h_Vent: public h_Tank
 	void AddVent(vector3 i_pos,vector3 i_dir,double i_size);
 	void ProcessShip(VESSEL *vessel,PROPELLANT_HANDLE ph);
 	virtual int Flow(h_volume block);
+	virtual double FlowFrom(h_volume &source, double volume, int *mask, double maxMass);
 	vector3 pos[4];
 	vector3 dir[4];
 	double size[4];
@@ -228,6 +278,8 @@ public:
 	virtual void* GetComponent(char *component_name);
 	virtual therm_obj* GetThermalInterface(){ return (therm_obj*)this; };
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 };
 
 class h_HeatExchanger : public h_object {
@@ -252,6 +304,8 @@ public:
 	virtual	void refresh(double dt);	//this called at each timestep
 	virtual void* GetComponent(char *component_name);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 };
 
 class h_Evaporator : public h_object {
@@ -276,6 +330,8 @@ public:
 	virtual	void refresh(double dt);	// this called at each timestep
 	virtual void* GetComponent(char *component_name);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 };
 
 class h_MixingPipe : public h_object {
@@ -296,6 +352,8 @@ public:
 	virtual	void refresh(double dt);	//this called at each timestep
 	virtual void* GetComponent(char *component_name);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 };
 
 class h_crew : public h_object {
@@ -307,6 +365,8 @@ public:
 	virtual	void refresh(double dt);	//this called at each timestep
 	virtual void* GetComponent(char *component_name);
 	virtual void Save(FILEHANDLE scn);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 };
 
 #endif
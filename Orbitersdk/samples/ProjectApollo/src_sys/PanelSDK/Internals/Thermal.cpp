@@ -64,6 +64,17 @@ Thermal_engine::Thermal_engine() {
 	InSun = 0;
 	InPlanet = 0;
 
+	Objects = NULL;
+	PosX = PosY = PosZ = NULL;
+	Flux = NULL;
+	ObjectCount = 0;
+	ObjectsValid = false;
+
+	PlanetChecked = NULL;
+	PlanetValid = false;
+	PlanetIsSun = false;
+	PlanetIsEarth = false;
+
 	ObjToDebug = NULL;
 }
 
@@ -72,10 +83,36 @@ void Thermal_engine::Save(FILEHANDLE scn)
 void Thermal_engine::Load(FILEHANDLE scn)
 {};
 
+void Thermal_engine::SaveCheckpoint(Checkpoint &cp)
+{
+	cp.Mark(NumberOfObjects);
+	for (therm_obj *runner = List.next_t; runner; runner = runner->next_t) {
+		cp.Put(runner->energy);
+		cp.Put(runner->Temp);
+	}
+}
+
+void Thermal_engine::LoadCheckpoint(Checkpoint &cp)
+{
+	if (!cp.Check(NumberOfObjects))
+		return;
+	for (therm_obj *runner = List.next_t; runner; runner = runner->next_t) {
+		cp.Get(runner->energy);
+		cp.Get(runner->Temp);
+	}
+}
+
 Thermal_engine::~Thermal_engine() {
 
 	if (distance_matrix) 
 		delete[] distance_matrix;
+	if (Objects) {
+		delete[] Objects;
+		delete[] PosX;
+		delete[] PosY;
+		delete[] PosZ;
+		delete[] Flux;
+	}
 }
 
 therm_obj* Thermal_engine::AddThermalObject(therm_obj *n_obj, bool debug) { 
@@ -89,6 +126,7 @@ therm_obj* Thermal_engine::AddThermalObject(therm_obj *n_obj, bool debug) {
 
 	runner->next_t = n_obj;
 	n_obj->next_t = NULL;
+	ObjectsValid = false;
 
 	if (debug) ObjToDebug = n_obj;
 	return n_obj;
@@ -99,40 +137,89 @@ void Thermal_engine::RemoveThermalObject(therm_obj *n_obj) {
 	therm_obj *runner; //,*gonner;
 	runner = &List;
 	while ((runner)&&(runner->next_t)) { 
-		if (runner->next_t==n_obj)
+		if (runner->next_t==n_obj) {
 			runner->next_t=n_obj->next_t;
+			NumberOfObjects--;
+			ObjectsValid = false;
+		}
 		runner=runner->next_t;
 	}
 }
 
-therm_obj* Thermal_engine::GetElement(int i) {
+void Thermal_engine::CheckObjects() {
 
-	therm_obj *runner;
+	if (ObjectsValid)
+		return;
 
-	runner = &List;
-	while ((i-->-1) && (runner->next_t)) 
+	if (Objects) {
+		delete[] Objects;
+		delete[] PosX;
+		delete[] PosY;
+		delete[] PosZ;
+		delete[] Flux;
+	}
+
+	ObjectCount = 0;
+	therm_obj *runner = List.next_t;
+	while (runner) {
+		ObjectCount++;
+		runner = runner->next_t;
+	}
+
+	//always allocate, so Objects is only NULL before the first call
+	Objects = new therm_obj*[ObjectCount + 1];
+	PosX = new double[ObjectCount + 1];
+	PosY = new double[ObjectCount + 1];
+	PosZ = new double[ObjectCount + 1];
+	Flux = new float[ObjectCount + 1];
+
+	int i = 0;
+	runner = List.next_t;
+	while (runner) {
+		Objects[i] = runner;
+		PosX[i] = runner->pos.x;
+		PosY[i] = runner->pos.y;
+		PosZ[i] = runner->pos.z;
+		i++;
 		runner = runner->next_t;
-	return runner;
+	}
+	ObjectsValid = true;
+}
+
+therm_obj* Thermal_engine::GetElement(int i) {
+
+	CheckObjects();
+
+	if (i < 0 || !ObjectCount)
+		return &List;
+	if (i >= ObjectCount)
+		return Objects[ObjectCount - 1];
+	return Objects[i];
 }
 
 void Thermal_engine::InitThermal()
 {
+	CheckObjects();
 
 	//builds the distance matrix for one thing
-	distance_matrix = new (float[NumberOfObjects*NumberOfObjects]);
-	therm_obj *elm_i,*elm_j;
-	for (int i=0;i<NumberOfObjects;i++)
+	int n = ObjectCount;
+	if (distance_matrix)
+		delete[] distance_matrix;
+	distance_matrix = new float[n*n];
+	for (int i=0;i<n;i++)
 		//get the dists between i and j
-	{	elm_i=GetElement(i);
-		for (int j=i+1;j<NumberOfObjects;j++)
+	{	distance_matrix[i*n+i]=0;
+		for (int j=i+1;j<n;j++)
 		{
-			elm_j=GetElement(j);
-			distance_matrix[i*NumberOfObjects+i]=0;
-			distance_matrix[i*NumberOfObjects+j] = (float) ((elm_i->pos-elm_j->pos).mod());
-			distance_matrix[j*NumberOfObjects+i]=distance_matrix[i*NumberOfObjects+j];
+			distance_matrix[i*n+j] = (float) ((Objects[i]->pos-Objects[j]->pos).mod());
+			distance_matrix[j*n+i]=distance_matrix[i*n+j];
 		}
-		elm_i->pos.selfnormalize();
 	}
+	for (int i=0;i<n;i++)
+		Objects[i]->pos.selfnormalize();
+
+	//the positions have changed
+	ObjectsValid = false;
 }
 
 void Thermal_engine::GetSun() {
@@ -167,14 +254,19 @@ void Thermal_engine::Radiative(double dt) {
 	sun = _vector3(LocalS.x, LocalS.y, LocalS.z);
 	sun.selfnormalize();
 
-	char planetName[1000];
-	bool planetIsSun = false;
-	bool planetIsEarth = false;
+	//the reference body only changes on SOI transitions, so don't look its name up every time
+	if (!PlanetValid || Planet != PlanetChecked) {
+		char planetName[1000];
+		oapiGetObjectName(Planet, planetName, 255);
 
-	oapiGetObjectName(Planet, planetName, 255);
+		PlanetIsSun = !strcmp(planetName, "Sun");
+		PlanetIsEarth = !strcmp(planetName, "Earth");
+		PlanetChecked = Planet;
+		PlanetValid = true;
+	}
 
-	if (!strcmp(planetName, "Sun")) planetIsSun = true;
-	if (!strcmp(planetName, "Earth")) planetIsEarth = true;
+	bool planetIsSun = PlanetIsSun;
+	bool planetIsEarth = PlanetIsEarth;
 
 	if (!planetIsSun) {
 		VECTOR3 LocalR;
@@ -189,34 +281,60 @@ void Thermal_engine::Radiative(double dt) {
 
 	float q = (float) 5.67e-8;//Stefan-Boltzmann
 	float Q = 0, Q0 = 0, Q1 = 0, Q2 = 0, Q3 = 0;
-	therm_obj *runner;
-	runner=List.next_t;
 
-	while (runner) {
-		if (planetIsEarth) {
-			Q = (float) (190.0 * (runner->pos % myr) * PlanetDistanceFactor); //blank radiation from Earth
-		} else {
-			Q = 0;
-		}
-		Q0 = Q;
-		if (Q < 0.0) Q = 0.0;
-		
-		Q1 = 0.0;
-		if (InSun || planetIsSun) Q1 = (float) (1372.0 * (runner->pos % sun));	//we are not behind planet,
-		if (Q1 > 0)	Q += Q1;
+	CheckObjects();
+
+	//
+	// First the incoming flux, which only depends on where each object is. This loop
+	// only touches the position arrays, so the compiler can vectorize it.
+	//
+	bool earth = planetIsEarth;
+	bool sunlit = (InSun || planetIsSun);
+	bool albedo = (!planetIsSun && InPlanet > 0);
+	double rx = myr.x, ry = myr.y, rz = myr.z;
+	double sx = sun.x, sy = sun.y, sz = sun.z;
+	double pdf = PlanetDistanceFactor, inPlanet = InPlanet;
+	int n = ObjectCount;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		double toPlanet = PosX[i] * rx + PosY[i] * ry + PosZ[i] * rz;
+		double toSun = PosX[i] * sx + PosY[i] * sy + PosZ[i] * sz;
 
-		Q2 = 0.0;
-		if (!planetIsSun && InPlanet > 0) Q2 = (float) (300.0 * (runner->pos % myr) * InPlanet);  //300W from planet's albedo
-		if (Q2 > 0) Q += Q2;
+		float f = earth ? (float) (190.0 * toPlanet * pdf) : 0.0f;	//blank radiation from Earth
+		if (f < 0.0f) f = 0.0f;
 
-		Q3 = (float) (q * pow(runner->Temp - 3.0, 4));
-		Q -= Q3;
+		float f1 = sunlit ? (float) (1372.0 * toSun) : 0.0f;			//we are not behind planet,
+		if (f1 > 0.0f) f += f1;
 
-		if (ObjToDebug && runner == ObjToDebug) 
+		float f2 = albedo ? (float) (300.0 * toPlanet * inPlanet) : 0.0f;	//300W from planet's albedo
+		if (f2 > 0.0f) f += f2;
+
+		Flux[i] = f;
+	}
+
+	//
+	// Then what each object radiates away at its current temperature.
+	//
+	for (i = 0; i < n; i++) {
+		therm_obj *runner = Objects[i];
+		double t = runner->Temp - 3.0;
+
+		//
+		// Same as pow(t, 4) to within an ulp of the double, but not always
+		// bit-identical to it, which depends on the library's pow().
+		//
+		Q3 = (float) (q * ((t * t) * (t * t)));
+		Q = Flux[i] - Q3;
+
+		if (ObjToDebug && runner == ObjToDebug) {
+			Q0 = earth ? (float) (190.0 * (runner->pos % myr) * PlanetDistanceFactor) : 0.0f;
+			Q1 = sunlit ? (float) (1372.0 * (runner->pos % sun)) : 0.0f;
+			Q2 = albedo ? (float) (300.0 * (runner->pos % myr) * InPlanet) : 0.0f;
 			sprintf(oapiDebugString(), "Earth %.1f Sun %.1f Albedo %.1f Space %.1f Ges %.1f Temp %.1f", (Q0>0?Q0:0) * runner->Area * runner->isolation, (Q1>0?Q1:0) * runner->Area * runner->isolation, (Q2>0?Q2:0) * runner->Area * runner->isolation, -Q3 * runner->Area * runner->isolation, Q * runner->Area * runner->isolation, runner->GetTemp());
+		}
 
 		runner->thermic(Q * runner->Area * dt * runner->isolation);
-		runner=runner->next_t;
 	}
 }
 
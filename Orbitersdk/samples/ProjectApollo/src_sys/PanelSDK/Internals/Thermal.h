@@ -26,6 +26,7 @@
 #define __THERMAL_H_
 
 #include "../matrix.h"
+#include "../Checkpoint.h"
 // To force orbitersdk.h to use <fstream> in any compiler version
 #pragma include_alias( <fstream.h>, <fstream> )
 #include "orbitersdk.h"
@@ -69,8 +70,30 @@ public:
   void Save(FILEHANDLE scn);
   void Load(FILEHANDLE scn);
 
+  ///
+  /// \brief Save and restore the energy and temperature of every object.
+  ///
+  void SaveCheckpoint(Checkpoint &cp);
+  void LoadCheckpoint(Checkpoint &cp);
+
+  ///
+  /// The objects in List as a contiguous array, with their positions copied out into
+  /// separate arrays so the per-object flux terms in Radiative() can be vectorized.
+  /// Rebuilt when objects are added or removed, or by InitThermal().
+  ///
+  therm_obj **Objects;
+  double *PosX, *PosY, *PosZ;
+  float *Flux;				//incoming flux per object, scratch for Radiative()
+  int ObjectCount;
+  bool ObjectsValid;
+  void CheckObjects();
+
   VESSEL *v;
   OBJHANDLE Planet;
+  OBJHANDLE PlanetChecked;	//planet the two flags below were worked out for
+  bool PlanetValid;			//false until they have been worked out at all
+  bool PlanetIsSun;
+  bool PlanetIsEarth;
   float pl_radius;
   vector3 myr;
   vector3 sun;
@@ -90,7 +113,7 @@ public:
 class ship_object
 { 
 public:
-	ship_object() { name[0] = '\0'; max_stage = 0; next = NULL; deletable = true; };
+	ship_object() { name[0] = '\0'; max_stage = 0; next = NULL; next_name = NULL; deletable = true; };
 
 	///
 	/// \brief object name.
@@ -103,6 +126,11 @@ public:
 	///
 	ship_object *next;
 
+	///
+	/// \brief next object in the same ship_system name index bucket.
+	///
+	ship_object *next_name;
+
 	virtual ~ship_object(){};
 	virtual void refresh(double dt);
 
@@ -124,6 +152,22 @@ public:
 	///
 	virtual void Save(FILEHANDLE scn);
 
+	///
+	/// Unlike Save(), this is for stepping back in time within a session rather than
+	/// for scenarios, so it writes everything the object needs to carry on exactly
+	/// where it was, including values Save() leaves to be worked out again.
+	///
+	/// \brief Save state to an in-memory checkpoint.
+	/// \param cp The checkpoint to write to.
+	///
+	virtual void SaveCheckpoint(Checkpoint &cp) { };
+
+	///
+	/// \brief Restore state saved with SaveCheckpoint().
+	/// \param cp The checkpoint to read from.
+	///
+	virtual void LoadCheckpoint(Checkpoint &cp) { };
+
 	///
 	/// Returns a pointer to a component of the system: for example, a valve in a pipe.
 	///
@@ -135,6 +179,17 @@ public:
 	virtual therm_obj* GetThermalInterface(){return NULL;};
 	virtual void UpdateFlow(double dt) { };
 
+	///
+	/// The adaptive substepping in PanelSDK::Timestep() watches how much these values
+	/// change over a timestep to decide how long the next one can be. Objects with state
+	/// worth watching (tank pressure and temperature, source voltage) override this.
+	///
+	/// \brief Get the state values to watch for substepping.
+	/// \param state Array to fill in, with room for two values.
+	/// \return Number of values written.
+	///
+	virtual int GetProbeState(double *state) { return 0; };
+
 	///
 	/// Specifies whether the object was allocated with new(), in which case it's
 	/// deletable, or allocated statically, in which case it's not.
@@ -147,6 +202,7 @@ public:
 class ship_system
 { public:
 	ship_object List;
+	ship_object *ListTail;	// last object in List, so AddSystem() doesn't have to walk it
 	ship_system();
 	~ship_system();
 
@@ -164,5 +220,78 @@ class ship_system
 	virtual void Load (FILEHANDLE scn)=0;
 	virtual void Save (FILEHANDLE scn)=0;
 	virtual void Build()=0;
+
+	///
+	/// The objects are written in list order, after a count of them; LoadCheckpoint()
+	/// doesn't touch any of them if the count doesn't match.
+	///
+	/// \brief Save and restore the state of every object in the system.
+	///
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
+
+protected:
+	///
+	/// The objects in List, copied into a contiguous array in the order Refresh() updates
+	/// them. It's rebuilt on the next Refresh() whenever objects are added or removed.
+	///
+	/// \brief Flattened update order.
+	///
+	ship_object **UpdateOrder;
+	int UpdateCount;
+	bool UpdateOrderValid;
+
+	///
+	/// \brief Rebuild UpdateOrder from List if it's out of date.
+	///
+	void CheckUpdateOrder();
+
+	///
+	/// The default keeps the load order; systems whose objects depend on each other
+	/// can override this to sort the array.
+	///
+	/// \brief Fill UpdateOrder from List.
+	///
+	virtual void BuildUpdateOrder();
+
+	///
+	/// Hash table of the objects in List keyed on their name, ignoring case, so
+	/// GetSystemByName() doesn't have to walk the list. The buckets are chained
+	/// through ship_object::next_name. AddSystem() keeps it up to date; it's rebuilt
+	/// on the next lookup after objects are removed or the table fills up.
+	///
+	/// \brief Name index.
+	///
+	ship_object **NameIndex;
+	int NameIndexSize;
+	int NameCount;
+	bool NameIndexValid;
+
+	///
+	/// The objects in List sorted by name, ignoring case, so the SetMaxStage() prefix
+	/// matches are a contiguous range. Rebuilt whenever the name index is.
+	///
+	/// \brief Sorted name table.
+	///
+	ship_object **SortedNames;
+	int SortedCount;
+	bool SortedNamesValid;
+
+	void CheckNameIndex();
+	void IndexName(ship_object *object);
+	ship_object* FindIndexedName(char *r_name);
+	void CheckSortedNames();
+
+	///
+	/// \brief Last values from GetProbeState(), two per object in UpdateOrder.
+	///
+	double *ProbeValues;
+	bool ProbesValid;
+
+public:
+	///
+	/// \brief Largest relative change in the objects' probe state since the last call.
+	///
+	double MeasureChange();
 };
 #endif
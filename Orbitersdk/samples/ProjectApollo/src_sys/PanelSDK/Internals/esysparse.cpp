@@ -210,6 +210,8 @@ void E_system::Build() {
 			Create_Boiler(line);
 		else if (Compare(line,"<PUMP>"))
 			Create_Pump(line);
+		else if (Compare(line,"<LOADFLOW>"))
+			SetLoadFlow(true);
 
 		line =ReadConfigLine();
 	}
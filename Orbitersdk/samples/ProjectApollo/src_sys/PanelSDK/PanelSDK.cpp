@@ -52,6 +52,16 @@ PanelSDK::PanelSDK() {
 	CurentStage = 1;
 	lastTime = 0;
 	firstTimestepDone = false;
+
+	Substep = SP_SUBSTEP_MAX;
+	HydraulicRate = 1;
+	HydraulicCount = 0;
+	HydraulicPending = 0;
+	HydraulicChange = 0;
+	SubstepsThisFrame = 0;
+	SubstepsLastFrame = 0;
+	TotalSubsteps = 0;
+	Frames = 0;
 }
 
 PanelSDK::~PanelSDK()
@@ -241,6 +251,24 @@ void PanelSDK::Save(FILEHANDLE scn) {
 	oapiWriteScenario_string (scn, "</INTERNALS>","");
 }
 
+void PanelSDK::SaveCheckpoint(Checkpoint &cp) {
+
+	THERMAL->SaveCheckpoint(cp);
+	HYDRAULIC->SaveCheckpoint(cp);
+	ELECTRIC->SaveCheckpoint(cp);
+	CHECKPOINT_RANGE(PanelSDK, Substep, HydraulicChange);
+	cp.PutRange(Substep, HydraulicChange);
+}
+
+bool PanelSDK::LoadCheckpoint(Checkpoint &cp) {
+
+	THERMAL->LoadCheckpoint(cp);
+	HYDRAULIC->LoadCheckpoint(cp);
+	ELECTRIC->LoadCheckpoint(cp);
+	cp.GetRange(Substep, HydraulicChange);
+	return !cp.Failed();
+}
+
 void PanelSDK::Timestep(double time) 
 
 {
@@ -253,24 +281,102 @@ void PanelSDK::Timestep(double time)
 	double dt = time - lastTime;
 	lastTime = time;
 
-	double mintFactor = __max(dt / 100.0, 0.5);
-	double tFactor = __min(mintFactor, dt);
+	double frame = dt;
+	double tFactor = __min(GetSubstep(frame), dt);
 	while (dt > 0) {
-		THERMAL->Radiative(tFactor);
-		HYDRAULIC->Refresh(tFactor);
-		ELECTRIC->Refresh(tFactor);
+		SimpleTimestep(tFactor);
 
 		dt -= tFactor;
-		tFactor = __min(mintFactor, dt);
+		tFactor = __min(GetSubstep(frame), dt);
 	}
+	EndTimestep();
 }
 
+double PanelSDK::GetSubstep(double frame)
+
+{
+	//
+	// Never split a frame into more than 100 substeps.
+	//
+	return __max(frame / 100.0, Substep);
+}
+
+//
+// One substep of the systems. Unless the config asks for <ADAPTIVE> substeps
+// in its <HYDRAULIC> section, everything runs every substep, and substeps are
+// SP_SUBSTEP_MAX long.
+//
+// With adaptive substeps the substep length follows how fast the tank
+// pressures and temperatures and the source voltages are changing: it shrinks
+// while they change by more than SP_SUBSTEP_TOL per substep, and grows back to
+// SP_SUBSTEP_MAX while they're quiet.
+//
+// When the hydraulics have been quiet for a while they're also run less often,
+// up to every SP_SUBSTEP_MAXRATE substeps with the accumulated time, and go back
+// to every substep as soon as they change noticeably. The accumulated time is
+// never more than SP_SUBSTEP_MAX, as the liquid loops don't take longer steps
+// well and aren't watched. The electrical system always runs every substep, as
+// its power loads are drawn per substep and can't be added up over several of them.
+//
+
 void PanelSDK::SimpleTimestep(double simdt) 
 
 {
-	THERMAL->Radiative(simdt);
-	HYDRAULIC->Refresh(simdt);
+	if (!HYDRAULIC->IsAdaptive()) {
+		THERMAL->Radiative(simdt);
+		HYDRAULIC->Refresh(simdt);
+		ELECTRIC->Refresh(simdt);
+		SubstepsThisFrame++;
+		return;
+	}
+
+	if (HydraulicCount && HydraulicPending + simdt > SP_SUBSTEP_MAX)
+		RunHydraulics();
+
+	HydraulicPending += simdt;
+	if (++HydraulicCount >= HydraulicRate)
+		RunHydraulics();
+
 	ELECTRIC->Refresh(simdt);
+
+	double change = __max(ELECTRIC->MeasureChange(), HydraulicChange);
+	if (change > SP_SUBSTEP_TOL)
+		Substep = __max(Substep * __max(0.25, 0.9 * SP_SUBSTEP_TOL / change), SP_SUBSTEP_MIN);
+	else if (change < 0.5 * SP_SUBSTEP_TOL)
+		Substep = __min(Substep * 1.5, SP_SUBSTEP_MAX);
+
+	SubstepsThisFrame++;
+}
+
+void PanelSDK::RunHydraulics()
+
+{
+	THERMAL->Radiative(HydraulicPending);
+	HYDRAULIC->Refresh(HydraulicPending);
+
+	HydraulicChange = HYDRAULIC->MeasureChange() / HydraulicCount;
+	if (HydraulicChange > 0.5 * SP_SUBSTEP_TOL)
+		HydraulicRate = 1;
+	else if (HydraulicChange < 0.1 * SP_SUBSTEP_TOL && HydraulicRate < SP_SUBSTEP_MAXRATE)
+		HydraulicRate *= 2;
+
+	HydraulicPending = 0;
+	HydraulicCount = 0;
+}
+
+void PanelSDK::EndTimestep()
+
+{
+	//
+	// Catch the hydraulics up, so everything is consistent at the end of the frame.
+	//
+	if (HydraulicCount)
+		RunHydraulics();
+
+	SubstepsLastFrame = SubstepsThisFrame;
+	SubstepsThisFrame = 0;
+	TotalSubsteps += SubstepsLastFrame;
+	Frames++;
 }
 
 void PanelSDK::SetStage(int stage,int load)
@@ -47,6 +47,11 @@
 #define SP_MIN_DCVOLTAGE	20.0
 #define SP_MIN_ACVOLTAGE	100.0
 
+#define SP_SUBSTEP_MIN		 0.05	// shortest adaptive substep (s)
+#define SP_SUBSTEP_MAX		 0.5	// longest adaptive substep (s)
+#define SP_SUBSTEP_TOL		 0.02	// largest relative state change per substep
+#define SP_SUBSTEP_MAXRATE	 4		// hydraulics run at most every this many substeps
+
 class Panel;
 class InstrumentDescriptor;
 class CustomVariable;
@@ -59,6 +64,7 @@ class VesselMgmt;
 class e_object;
 class h_object;
 class therm_obj;
+class Checkpoint;
 
 ///
 /// \ingroup PanelSDK
@@ -86,6 +92,27 @@ public:
 	void MFDEvent(int mfd);
 	void Timestep(double time);
 	void SimpleTimestep(double simdt);
+
+	///
+	/// Vessels that run their own loop around SimpleTimestep() use this to size each
+	/// slice, and call EndTimestep() once the loop is done.
+	///
+	/// \brief Length of the next substep.
+	/// \param frame Total length of the frame being subdivided.
+	///
+	double GetSubstep(double frame);
+	void EndTimestep();
+
+	///
+	/// \brief Number of substeps the last frame was split into.
+	///
+	int GetSubstepsLastFrame() { return SubstepsLastFrame; };
+
+	///
+	/// \brief Average number of substeps per frame since the vessel was created.
+	///
+	double GetAverageSubsteps() { return Frames ? (double) TotalSubsteps / (double) Frames : 0.0; };
+
 	void SetStage(int stage,int load);
 	void AddElectrical(e_object *e, bool can_delete);
 	void AddHydraulic(h_object *h);
@@ -95,6 +122,21 @@ public:
 	void Save(FILEHANDLE scn);
 	void ShutDown();
 
+	///
+	/// The binary counterpart of Save() and Load(), for stepping back in time within
+	/// a session: much quicker, but only good for the vessel that wrote it, with the
+	/// same set of systems.
+	///
+	/// \brief Save the state of all the systems to a checkpoint.
+	///
+	void SaveCheckpoint(Checkpoint &cp);
+
+	///
+	/// \brief Restore the state of all the systems from a checkpoint.
+	/// \return False if the checkpoint doesn't match the systems.
+	///
+	bool LoadCheckpoint(Checkpoint &cp);
+
 	int CurentStage;
 
 private:
@@ -111,6 +153,18 @@ private:
 	double lastTime;
 	bool firstTimestepDone;
 
+	//adaptive substepping, see SimpleTimestep()
+	double Substep;				//current substep length
+	int HydraulicRate;			//hydraulics and thermal run every this many substeps
+	int HydraulicCount;			//substeps since they last ran
+	double HydraulicPending;	//time since they last ran
+	double HydraulicChange;		//relative change per substep the last time they ran
+	int SubstepsThisFrame;
+	int SubstepsLastFrame;
+	long TotalSubsteps;
+	long Frames;
+	void RunHydraulics();
+
 	//loads up the PRD file
 	void PanelResources(char *FileName);
 	//creates a panel from the cfg file
@@ -0,0 +1,210 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  Virtual AGC input queue for the pipelined timestep
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  **************************************************************************/
+
+#if !defined(_PA_AGCINPUT_H)
+#define _PA_AGCINPUT_H
+
+#include <string.h>
+#include <vector>
+#include "yaAGC/agc_engine.h"
+
+#define AGC_INPUT_CHANNEL	0	///< Input channel write, as WriteIO()
+#define AGC_INPUT_INTERRUPT	1	///< Interrupt request
+#define AGC_INPUT_INCREMENT	2	///< Counter increments, as agc_engine_queue_increment()
+#define AGC_INPUT_CH33		3	///< Channel 33 switches, as SetCh33Bits() or SetLMCh33Bits()
+
+///
+/// \ingroup AGC
+/// While the AGC runs pipelined (see ApolloGuidance::StartTimestep()) the systems can't
+/// touch the agc_t, so what they pass to the AGC is queued here instead, and Apply() passes
+/// it on in order once the AGC is done. Until then the systems read the input channels
+/// from a copy taken at the handoff, with their own writes made to it.
+///
+/// Increments are queued at cycles counted from the start of the next yaAGC run, which
+/// isn't known until the current one is done.
+///
+/// So the AGC gets the same input, at the same cycles, whether it runs on its own thread
+/// while the systems are stepped or after them on the main thread.
+/// \brief Queue for the Virtual AGC input.
+///
+class AGCInputQueue
+{
+public:
+	AGCInputQueue() : Ch33Switches(0), LGC(false), Uprupt(false) { memset(Channels, 0, sizeof(Channels)); };
+
+	///
+	/// \brief Start queuing. The AGC must not be running.
+	/// \param vagc The AGC.
+	/// \param lgc True for the LGC, for the channel 33 switches.
+	///
+	void Begin(const agc_t *vagc, bool lgc)
+	{
+		memcpy(Channels, vagc->InputChannel, sizeof(Channels));
+		Ch33Switches = vagc->Ch33Switches;
+		LGC = lgc;
+		Uprupt = IsUPRUPTActive((agc_t *)vagc) != 0;
+		Ops.clear();
+	};
+
+	///
+	/// \brief Input channel value, as the systems have left it.
+	///
+	int16_t GetChannel(int channel) { return Channels[channel]; };
+
+	///
+	/// \brief Channel 33 switches, as the systems have left them.
+	///
+	int16_t GetCh33Switches() { return Ch33Switches; };
+
+	///
+	/// \brief Queue an input channel write.
+	///
+	void WriteChannel(int channel, int val)
+	{
+		if (channel < 0 || channel >= NUM_CHANNELS)
+			return;
+
+		//
+		// The copy changes the way WriteIO() changes the AGC.
+		//
+
+		int16_t data = val & 077777;
+		if (channel == 033) {
+			data = (Channels[033] & 076777) | Ch33Switches;
+			Ch33Switches |= 076000;
+		}
+		else if (channel == 077)
+			data = 0;
+		Channels[channel] = data;
+
+		Queue(AGC_INPUT_CHANNEL, channel, val, 0, 0);
+	};
+
+	///
+	/// \brief Queue an interrupt request.
+	/// \param n Interrupt number, as an index to InterruptRequests.
+	///
+	void Interrupt(int n)
+	{
+		if (n == 7)
+			Uprupt = true;
+		Queue(AGC_INPUT_INTERRUPT, n, 0, 0, 0);
+	};
+
+	///
+	/// \brief Is an UPRUPT requested or running, as of the handoff or queued since?
+	///
+	bool IsUpruptActive() { return Uprupt; };
+
+	///
+	/// \brief Queue counter increments.
+	/// \param cycle Cycle counted from the start of the next yaAGC run, 0 for as soon as possible.
+	///
+	void Increment(int counter, int inctype, int count, uint64_t cycle) { Queue(AGC_INPUT_INCREMENT, counter, inctype, count, cycle); };
+
+	///
+	/// \brief Queue new channel 33 switches.
+	///
+	void SetCh33(int16_t val)
+	{
+		if (LGC) {
+			Ch33Switches = val & 010776;
+			Channels[033] = (Channels[033] & 027001) | Ch33Switches;
+		}
+		else {
+			Ch33Switches = val & 001032;
+			Channels[033] = (Channels[033] & 076745) | Ch33Switches;
+		}
+		Queue(AGC_INPUT_CH33, 033, val, 0, 0);
+	};
+
+	///
+	/// \brief Pass everything on to the AGC, in order. The AGC must not be running, and the
+	/// caller must hold the lock for the increment queue.
+	///
+	void Apply(agc_t *vagc)
+	{
+		uint64_t start = vagc->CycleCounter;
+
+		for (size_t i = 0; i < Ops.size(); i++) {
+			const Op &op = Ops[i];
+
+			switch (op.type) {
+			case AGC_INPUT_CHANNEL:
+				WriteIO(vagc, op.channel, op.val);
+				break;
+
+			case AGC_INPUT_INTERRUPT:
+				vagc->InterruptRequests[op.channel] = 1;
+				break;
+
+			case AGC_INPUT_INCREMENT:
+				if (!agc_engine_queue_increment(vagc, op.channel, op.val, op.count, op.cycle ? start + op.cycle : 0)) {
+					// Queue full, so make them now
+					if (op.val == INC_CDU_SET)
+						vagc->Erasable[0][op.channel] = op.count & 077777;
+					else
+						for (int n = 0; n < op.count; n++)
+							UnprogrammedIncrement(vagc, op.channel, op.val);
+				}
+				break;
+
+			case AGC_INPUT_CH33:
+				if (LGC)
+					SetLMCh33Bits(vagc, (int16_t)op.val);
+				else
+					SetCh33Bits(vagc, (int16_t)op.val);
+				break;
+			}
+		}
+		Ops.clear();
+	};
+
+protected:
+	struct Op {
+		int type;		///< AGC_INPUT_*
+		int channel;	///< Channel, interrupt or counter
+		int val;		///< Channel value, or increment type
+		int count;		///< Increments, or counter value for INC_CDU_SET
+		uint64_t cycle;
+	};
+
+	void Queue(int type, int channel, int val, int count, uint64_t cycle)
+	{
+		Op op;
+		op.type = type;
+		op.channel = channel;
+		op.val = val;
+		op.count = count;
+		op.cycle = cycle;
+		Ops.push_back(op);
+	};
+
+	std::vector<Op> Ops;
+	int16_t Channels[NUM_CHANNELS];
+	int16_t Ch33Switches;
+	bool LGC;
+	bool Uprupt;
+};
+
+#endif // _PA_AGCINPUT_H
@@ -49,7 +49,7 @@ char RegFormat[7] = "XXXXXX";
 // Moved DELTAT definition to avoid INTERNAL COMPILER ERROR
 #define DELTAT 2.0
 
-ApolloGuidance::ApolloGuidance(SoundLib &s, DSKY &display, IMU &im, PanelSDK &p) : soundlib(s), dsky(display), imu(im), DCPower(0, p)
+ApolloGuidance::ApolloGuidance(SoundLib &s, DSKY &display, IMU &im, PanelSDK &p) : soundlib(s), dsky(display), imu(im), DCPower(0, p), timeStepEvent(AGC_WAKEUP_SPIN)
 
 {
 	ProgRunning = VerbRunning = NounRunning = 0;
@@ -82,6 +82,18 @@ ApolloGuidance::ApolloGuidance(SoundLib &s, DSKY &display, IMU &im, PanelSDK &p)
 
 	Yaagc = false;
 
+	//
+	// AGC runs after the systems timestep unless configured otherwise.
+	//
+
+	PipelineMode = AGC_PIPELINE_OFF;
+	PipelineStep = false;
+	PipelineQueuing = false;
+	PipelineBusy = false;
+	PipelineStepTime = 0.0;
+	PipelineSaved = 0.0;
+	PipelineAGCTime = 0.0;
+
 	//
 	// Target attitude.
 	//
@@ -217,17 +229,26 @@ ApolloGuidance::ApolloGuidance(SoundLib &s, DSKY &display, IMU &im, PanelSDK &p)
 	vagc.agc_clientdata = this;
 	agc_engine_init(&vagc, NULL, NULL, 0);
 
+	// Only the scaler ticks of the executive idle loop need to be simulated;
+	// ChannelInput is a no-op here, so the rest can be fast-forwarded.
+	vagc.IdleFastForward = 1;
+
+	agclog.Open(FLIGHTLOG_AGC, "ProjectApollo AGC.log");
+
 #ifdef _DEBUG
-	out_file = fopen("ProjectApollo AGC.log", "wt");
+	out_file = fopen("ProjectApollo yaAGC.log", "wt");
 	vagc.out_file = out_file;
 #endif
 
 	PowerConnected = false;
+	agcQuit = false;
 }
 
 ApolloGuidance::~ApolloGuidance()
 
 {
+	StopThread();
+
 #ifdef _DEBUG
 	fclose(out_file);
 #endif
@@ -236,8 +257,12 @@ ApolloGuidance::~ApolloGuidance()
 void ApolloGuidance::InitVirtualAGC(char *binfile)
 
 {
-
-	(void) agc_load_binfile(&vagc, binfile);
+	int err = agc_load_binfile(&vagc, binfile);
+	if (err != AGC_BINFILE_LOADED) {
+		char buffer[256];
+		sprintf(buffer, "ProjectApollo: cannot load AGC rope %s (error %d)", binfile, err);
+		oapiWriteLog(buffer);
+	}
 
 	// Set channels only once, otherwise this code overwrites the channel values in the scenario
 	if (!PadLoaded) { 
@@ -1160,8 +1185,6 @@ void ApolloGuidance::VirtualAGCCoreDump(char *fileName) {
 bool ApolloGuidance::GenericTimestep(double simt, double simdt)
 {
 //	TRACESETUP("COMPUTER TIMESTEP");
-	int i;
-
 	LastTimestep = CurrentTimestep;
 	CurrentTimestep = simt;
 
@@ -1178,9 +1201,8 @@ bool ApolloGuidance::GenericTimestep(double simt, double simdt)
 		// This resulted in a machine cycle of just over 11.7 microseconds.
 		int cycles = (long) ((simdt) * 1024000 / 12);
 
-		for (i = 0; i < cycles; i++) {
-			agc_engine(&vagc);
-		}
+		while (cycles > 0)
+			cycles -= agc_engine_run(&vagc, cycles);
 
 		return true;
 	}
@@ -1286,6 +1308,152 @@ void ApolloGuidance::SystemTimestep(double simdt)
 	}
 }
 
+//
+// AGC thread. Runs the timesteps handed to it by Timestep() with MultiThread
+// enabled, or by PipelineHandoff().
+//
+
+void ApolloGuidance::Run()
+
+{
+	while (true)
+	{
+		timeStepEvent.Wait();
+		{
+			Lock lock(agcCycleMutex);
+			if (agcQuit)
+				break;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			agcTimestep(thread_simt, thread_simdt);
+			if (PipelineBusy)
+			{
+				PipelineStepTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				PipelineBusy = false;
+				PipelineDone.Raise();
+			}
+		}
+	}
+}
+
+void ApolloGuidance::StopThread()
+
+{
+	{
+		Lock lock(agcCycleMutex);
+		agcQuit = true;
+	}
+	timeStepEvent.Raise();
+	Kill();
+}
+
+void ApolloGuidance::StartTimestep(double simt, double simdt)
+
+{
+	PipelineStep = IsPipelined();
+	Timestep(simt, simdt);
+	PipelineStep = false;
+}
+
+void ApolloGuidance::PipelineHandoff(double simt, double simdt)
+
+{
+	Lock lock(agcCycleMutex);
+	thread_simt = simt;
+	thread_simdt = simdt;
+	PipelineOps.clear();
+	PipelineInput.Begin(&vagc, isLGC);
+	PipelineQueuing = true;
+
+	//
+	// In serial mode the AGC runs in FinishTimestep() instead.
+	//
+
+	if (PipelineMode == AGC_PIPELINE_ON)
+	{
+		PipelineBusy = true;
+		timeStepEvent.Raise();
+	}
+}
+
+void ApolloGuidance::FinishTimestep()
+
+{
+	//
+	// Nothing to do if Timestep() returned before handing the AGC over, e.g. when unpowered.
+	//
+
+	if (!PipelineQueuing)
+		return;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	double agctime;
+
+	if (PipelineMode == AGC_PIPELINE_ON)
+	{
+		PipelineDone.Wait();
+		agctime = PipelineStepTime;
+	}
+	else
+	{
+		Lock lock(agcCycleMutex);
+		agcTimestep(thread_simt, thread_simdt);
+		agctime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	double wait = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	//
+	// The AGC is done, so it can have what the systems gave it meanwhile.
+	//
+
+	{
+		Lock lock(agcCycleMutex);
+		Lock queueLock(agcQueueMutex);
+		PipelineInput.Apply(&vagc);
+	}
+	PipelineQueuing = false;
+
+	//
+	// Now pass the AGC output on, in the order it happened.
+	//
+
+	for (size_t i = 0; i < PipelineOps.size(); i++)
+	{
+		if (PipelineOps[i].channel < 0)
+			PipelineTelemetry(PipelineOps[i].t);
+		else
+			SetOutputChannel(PipelineOps[i].channel, PipelineOps[i].val);
+	}
+	PipelineOps.clear();
+
+	//
+	// Frame time saved is the AGC time we didn't have to wait for. Averaged over
+	// the last 20 frames or so to make it readable.
+	//
+
+	PipelineAGCTime += (agctime - PipelineAGCTime) * 0.05;
+	PipelineSaved += ((agctime - wait) - PipelineSaved) * 0.05;
+}
+
+void ApolloGuidance::QueueOutputChannel(int channel, int val)
+
+{
+	PipelineOp op;
+	op.channel = channel;
+	op.val = val;
+	op.t = 0.0;
+	PipelineOps.push_back(op);
+}
+
+void ApolloGuidance::QueueTelemetry(double t)
+
+{
+	PipelineOp op;
+	op.channel = -1;
+	op.val = 0;
+	op.t = t;
+	PipelineOps.push_back(op);
+}
+
 //
 // Start the specified program running.
 //
@@ -3681,29 +3849,118 @@ void ApolloGuidance::SetErasable(int bank, int address, int value)
 	vagc.Erasable[bank][address] = value;
 }
 
+bool ApolloGuidance::GetNextRunCycle(uint64_t &cycle)
+
+{
+	if (!Yaagc || !IsPowered())
+		return false;
+
+	if (PipelineQueuing)
+	{
+		cycle = 0;
+		return true;
+	}
+
+	//
+	// With MultiThread the AGC thread may be running, and CycleCounter can't be read safely then.
+	//
+
+	if (!agcCycleMutex.TryAcquire())
+		return false;
+
+	cycle = vagc.CycleCounter;
+	agcCycleMutex.Release();
+	return true;
+}
+
+bool ApolloGuidance::QueueIncrement(int counter, int inctype, int count, uint64_t cycle)
+
+{
+	if (count <= 0)
+		return true;
+
+	if (PipelineQueuing)
+	{
+		PipelineInput.Increment(counter, inctype, count, cycle);
+		return true;
+	}
+
+	Lock lock(agcQueueMutex);
+	return agc_engine_queue_increment(&vagc, counter, inctype, count, cycle) != 0;
+}
+
+bool ApolloGuidance::QueueCDU(int RegCDU, int value, uint64_t cycle)
+
+{
+	if (PipelineQueuing)
+	{
+		PipelineInput.Increment(RegCDU, INC_CDU_SET, value & 077777, cycle);
+		return true;
+	}
+
+	Lock lock(agcQueueMutex);
+	return agc_engine_queue_increment(&vagc, RegCDU, INC_CDU_SET, value & 077777, cycle) != 0;
+}
+
+bool ApolloGuidance::SetCDU(int RegCDU, int value)
+
+{
+	//
+	// On the AGC thread, or with the AGC thread idle, set the counter right away. While the
+	// AGC thread is running have it set at its next cycle boundary instead, and only wait
+	// for the thread if the queue is full. While pipelined it's always queued, so it doesn't
+	// depend on whether the AGC thread has started.
+	//
+
+	if (PipelineQueuing)
+	{
+		QueueCDU(RegCDU, value, 0);
+		return false;
+	}
+
+	if (agcCycleMutex.TryAcquire())
+	{
+		vagc.Erasable[0][RegCDU] = value & 077777;
+		agcCycleMutex.Release();
+		return true;
+	}
+
+	if (QueueCDU(RegCDU, value, 0))
+		return false;
+
+	Lock lock(agcCycleMutex);
+	vagc.Erasable[0][RegCDU] = value & 077777;
+	return true;
+}
+
 void ApolloGuidance::PulsePIPA(int RegPIPA, int pulses) 
 
 {
 	int i;
 	//
 	// No pulsing, Don't lock the thread mutex. Locking the mutex here slows time acceleration, like single thread.
-	// There should not be any pulsing during time acceleration anyways. i.e. no thruster firing. Still locking
-	// the mutex in case the agc does small maneuvering during time acceleration.
 	//
 	if (pulses == 0 ) 
 		return;
 
-	Lock lock(agcCycleMutex);
+	//
+	// Normally the pulses go into the engine's increment queue, which agc_engine_run empties at the next
+	// cycle boundary, so we don't have to wait for the AGC thread. If the AGC isn't running or the queue
+	// is full, lock the thread mutex and do them here.
+	//
+	if (IsPowered() && QueueIncrement(RegPIPA, (pulses >= 0) ? INC_PINC : INC_MINC, (pulses >= 0) ? pulses : -pulses, 0))
+		return;
 
+	Lock lock(agcCycleMutex);
 
 	if (pulses >= 0) {
     	for (i = 0; i < pulses; i++) {
-			UnprogrammedIncrement(&vagc, RegPIPA, 0);	// PINC
+			UnprogrammedIncrement(&vagc, RegPIPA, INC_PINC);
 
     	}
 	} else {
     	for (i = 0; i < -pulses; i++) {
-			UnprogrammedIncrement(&vagc, RegPIPA, 2);	// MINC
+			UnprogrammedIncrement(&vagc, RegPIPA, INC_MINC);
     	}
 	}
 
@@ -4263,6 +4520,95 @@ void ApolloGuidance::LoadState(FILEHANDLE scn)
 	}
 }
 
+void ApolloGuidance::SaveCheckpoint(Checkpoint &cp)
+
+{
+	//
+	// The Saturn only saves the AGC where it has finished its timestep, so this doesn't
+	// wait. Anyone else saving it with MultiThread may have to wait for the AGC thread.
+	//
+
+	Lock lock(agcCycleMutex);
+	unsigned i, count;
+
+	cp.Put(vagc.CycleCounter);
+	cp.Put(vagc.Erasable);
+	CHECKPOINT_RANGE(agc_t, InputChannel, DownruptTime);
+	cp.PutRange(vagc.InputChannel, vagc.DownruptTime);
+
+	//
+	// Only the increments still waiting in the queue.
+	//
+
+	count = vagc.IncrementHead - vagc.IncrementTail;
+	cp.Put(count);
+	for (i = vagc.IncrementTail; i != vagc.IncrementHead; i++)
+		cp.Put(vagc.IncrementQueue[i & (INCREMENT_QUEUE_SIZE - 1)]);
+	cp.Put(vagc.OutputChanged);
+
+	cp.Put(NextZ);
+	cp.Put(ScalerCounter);
+	cp.Put(ChannelRoutineCount);
+
+	cp.Put(InputChannel);
+	cp.Put(OutputChannel);
+	cp.Put(LastTimestep);
+	cp.Put(LastCycled);
+	cp.Put(CurrentTimestep);
+	cp.Put(isFirstTimestep);
+	cp.Put(PadLoaded);
+	cp.Put(Standby);
+	cp.Put(Reset);
+	cp.Put(ProgAlarm);
+	cp.Put(GimbalLockAlarm);
+}
+
+void ApolloGuidance::LoadCheckpoint(Checkpoint &cp)
+
+{
+	Lock lock(agcCycleMutex);
+	unsigned i, count;
+
+	cp.Get(vagc.CycleCounter);
+	cp.Get(vagc.Erasable);
+	cp.GetRange(vagc.InputChannel, vagc.DownruptTime);
+
+	cp.Get(count);
+	if (count > INCREMENT_QUEUE_SIZE)
+		cp.Fail();
+	if (cp.Failed())
+		return;
+	Lock queueLock(agcQueueMutex);
+	for (i = 0; i < count; i++)
+		cp.Get(vagc.IncrementQueue[i]);
+	vagc.IncrementTail = 0;
+	vagc.IncrementHead = count;
+	cp.Get(vagc.OutputChanged);
+
+	//
+	// Any idle loop recorded since doesn't start from here.
+	//
+
+	vagc.IdleLoop.Valid = vagc.IdleLoop.Recording = 0;
+	vagc.IdleLoop.NextCheck = vagc.CycleCounter;
+
+	cp.Get(NextZ);
+	cp.Get(ScalerCounter);
+	cp.Get(ChannelRoutineCount);
+
+	cp.Get(InputChannel);
+	cp.Get(OutputChannel);
+	cp.Get(LastTimestep);
+	cp.Get(LastCycled);
+	cp.Get(CurrentTimestep);
+	cp.Get(isFirstTimestep);
+	cp.Get(PadLoaded);
+	cp.Get(Standby);
+	cp.Get(Reset);
+	cp.Get(ProgAlarm);
+	cp.Get(GimbalLockAlarm);
+}
+
 //
 // Power.
 //
@@ -4323,25 +4669,26 @@ void ApolloGuidance::SetInputChannel(int channel, std::bitset<16> val)
 
 	if (Yaagc) {
 
-#ifdef _DEBUG
 	//
 	// Don't print debug for IMU channels or we get a multi-gigabyte log file!
 	//
 	if (!(channel & 0x80))
-		fprintf(out_file, "Wrote %05o to input channel %04o\n", channel, val);
-#endif
+		agclog.Printf("Wrote %05o to input channel %04o\n", val.to_ulong(), channel);
 
 		if (channel & 0x80) {
 			// In this case we're dealing with a counter increment.
-			// So increment the counter.
-			UnprogrammedIncrement (&vagc, channel, val.to_ulong());
+			// So queue it for the engine, or increment the counter if the queue is full.
+			if (!QueueIncrement(channel, val.to_ulong(), 1, 0)) {
+				Lock lock(agcCycleMutex);
+				UnprogrammedIncrement (&vagc, channel, val.to_ulong());
+			}
 		}
 		else {
 			// If this is a keystroke from the DSKY, generate an interrupt req.
 			if (channel == 015){
-				vagc.InterruptRequests[5] = 1;
+				RequestInterrupt(5);
 			}else{ if (channel == 016){ // Secondary DSKY
-				vagc.InterruptRequests[6] = 1;
+				RequestInterrupt(6);
 			}}
 
 			//
@@ -4351,7 +4698,7 @@ void ApolloGuidance::SetInputChannel(int channel, std::bitset<16> val)
 			if (channel >= 030 && channel <= 034){
 				val ^= 077777;
 			}
-			WriteIO(&vagc, channel, val.to_ulong());
+			WriteInputChannel(channel, val.to_ulong());
 		}
 	}
 	else {
@@ -4378,7 +4725,7 @@ void ApolloGuidance::SetInputChannelBit(int channel, int bit, bool val)
 
 	if (Yaagc) {
 
-		data = vagc.InputChannel[channel];
+		data = PipelineQueuing ? PipelineInput.GetChannel(channel) : vagc.InputChannel[channel];
 		//
 		// Channels 030-034 are inverted!
 		//
@@ -4386,9 +4733,7 @@ void ApolloGuidance::SetInputChannelBit(int channel, int bit, bool val)
 		if ((channel >= 030) && (channel <= 034))
 			data ^= 077777;
 
-#ifdef _DEBUG
-		fprintf(out_file, "Set bit %d of input channel %04o to %d\n", bit, channel, val ? 1 : 0); 
-#endif
+		agclog.Printf("Set bit %d of input channel %04o to %d\n", bit, channel, val ? 1 : 0);
 	}
 
 	if (channel < 0 || channel > MAX_INPUT_CHANNELS)
@@ -4431,12 +4776,12 @@ void ApolloGuidance::SetInputChannelBit(int channel, int bit, bool val)
 
 		// If this is a keystroke from the DSKY (Or MARK/MARKREJ), generate an interrupt req.
 		if (channel == 015 && val != 0){
-			vagc.InterruptRequests[5] = 1;
+			RequestInterrupt(5);
 		}else{ if (channel == 016 && val != 0){ // Secondary DSKY
-			vagc.InterruptRequests[6] = 1;
+			RequestInterrupt(6);
 		}}
 
-		WriteIO(&vagc, channel, data);
+		WriteInputChannel(channel, data);
 
 	}
 	else {
@@ -4473,7 +4818,6 @@ void ApolloGuidance::SetOutputChannel(int channel, ChannelValue val)
 
 	OutputChannel[channel] = val.to_ulong();
 
-#ifdef _DEBUG
 	if (Yaagc) {
 		switch (channel) {
 		case 010:
@@ -4484,11 +4828,10 @@ void ApolloGuidance::SetOutputChannel(int channel, ChannelValue val)
 			break;
 
 		default:
-			fprintf(out_file, "AGC write %05o to %04o\n", val, channel);
+			agclog.Printf("AGC write %05o to %04o\n", val.to_ulong(), channel);
 			break;
 		}
 	}
-#endif
 
 	//
 	// Special-case processing.
@@ -4597,36 +4940,59 @@ void ApolloGuidance::ProcessIMUCDUErrorCount(int channel, ChannelValue val){
 }
 
 void ApolloGuidance::GenerateHandrupt() {
-	GenerateHANDRUPT(&vagc);
+	RequestInterrupt(10);
 }
 
 // DS20060402 DOWNRUPT
 void ApolloGuidance::GenerateDownrupt(){
-	GenerateDOWNRUPT(&vagc);
+	RequestInterrupt(8);
 }
 
 void ApolloGuidance::GenerateUprupt(){
-	GenerateUPRUPT(&vagc);
+	RequestInterrupt(7);
 }
 
 void ApolloGuidance::GenerateRadarupt(){
-	GenerateRADARUPT(&vagc);
+	RequestInterrupt(9);
+}
+
+void ApolloGuidance::RequestInterrupt(int n)
+
+{
+	if (PipelineQueuing)
+		PipelineInput.Interrupt(n);
+	else
+		vagc.InterruptRequests[n] = 1;
+}
+
+void ApolloGuidance::WriteInputChannel(int channel, int val)
+
+{
+	if (PipelineQueuing)
+		PipelineInput.WriteChannel(channel, val);
+	else
+		WriteIO(&vagc, channel, val);
 }
 
 bool ApolloGuidance::IsUpruptActive() {
 	if (!Yaagc) return false;
+	if (PipelineQueuing) return PipelineInput.IsUpruptActive();
 	return (IsUPRUPTActive(&vagc) == 1);
 }
 
 // DS200608xx CH33 SWITCHES
 void ApolloGuidance::SetCh33Switches(unsigned int val){
-	if( isLGC)
+	if (PipelineQueuing)
+		PipelineInput.SetCh33(val);
+	else if( isLGC)
 		SetLMCh33Bits(&vagc,val);
 	else 
 		SetCh33Bits(&vagc,val);
 }
 
 unsigned int ApolloGuidance::GetCh33Switches(){
+	if (PipelineQueuing)
+		return PipelineInput.GetCh33Switches();
 	return vagc.Ch33Switches; 
 }
 
@@ -4715,7 +5081,7 @@ unsigned int ApolloGuidance::GetInputChannel(int channel)
 		// 0 = false, 1 = true form.
 		//
 
-		unsigned int val = vagc.InputChannel[channel];
+		unsigned int val = PipelineQueuing ? PipelineInput.GetChannel(channel) : vagc.InputChannel[channel];
 
 		if ((channel >= 030) && (channel <= 034))
 			val ^= 077777;
@@ -5153,6 +5519,14 @@ void ChannelOutput (agc_t * State, int Channel, int Value)
   ApolloGuidance *agc;
 
   agc = (ApolloGuidance *) State->agc_clientdata;
+
+  // While the AGC runs in parallel with the systems timestep, the
+  // hardware gets its output once the AGC is done.
+  if (agc->PipelineQueuing)
+    {
+      agc->QueueOutputChannel(Channel, Value);
+      return;
+    }
   agc->SetOutputChannel(Channel, Value);
 }
 
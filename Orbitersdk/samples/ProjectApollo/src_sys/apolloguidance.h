@@ -34,11 +34,20 @@ class IMU;
 class PanelSDK;
 
 #include <bitset>
+#include <vector>
 #include "powersource.h"
 
 #include "control.h"
 #include "yaAGC/agc_engine.h"
 #include "thread.h"
+#include "flightlog.h"
+#include "agcinput.h"
+
+#define AGC_WAKEUP_SPIN 0.0002
+
+#define AGC_PIPELINE_OFF	0	///< AGC runs after the systems timestep
+#define AGC_PIPELINE_ON		1	///< AGC runs on its own thread during the systems timestep
+#define AGC_PIPELINE_SERIAL	2	///< Same as AGC_PIPELINE_ON, but on the main thread, for debugging
 //
 // Velocity in feet per second or meters per second?
 //
@@ -218,6 +227,56 @@ public:
 	virtual void Timestep(double simt, double simdt) = 0;
 	virtual void SystemTimestep(double simdt); 
 
+	///
+	/// Pipelined timestep. StartTimestep() does what Timestep() does, but the yaAGC run is
+	/// handed to the AGC thread, so the caller can do the systems timestep while it runs.
+	/// Until FinishTimestep() the AGC doesn't touch the spacecraft: its output channel writes
+	/// and telemetry steps are queued, and are done there in order once the AGC is finished.
+	/// Nor do the systems touch the AGC: input channel writes, interrupt requests and counter
+	/// increments go to PipelineInput, and are passed on to the AGC there as well.
+	/// The result doesn't depend on thread timing, and is the same with AGC_PIPELINE_SERIAL.
+	///
+	/// \brief Start the pipelined timestep.
+	/// \param simt Mission time in seconds.
+	/// \param simdt Time since last timestep.
+	///
+	void StartTimestep(double simt, double simdt);
+
+	///
+	/// \brief Wait for the AGC and do its queued channel writes and telemetry steps.
+	///
+	void FinishTimestep();
+
+	///
+	/// \brief Is the pipelined timestep in use?
+	///
+	bool IsPipelined() { return PipelineMode != AGC_PIPELINE_OFF; };
+
+	///
+	/// \brief Queue an output channel write, while the AGC is running pipelined.
+	///
+	void QueueOutputChannel(int channel, int val);
+
+	///
+	/// \brief Pipeline mode, AGC_PIPELINE_*.
+	///
+	int PipelineMode;
+
+	///
+	/// \brief AGC time per frame spent in parallel with the systems, seconds, averaged.
+	///
+	double PipelineSaved;
+
+	///
+	/// \brief AGC time per frame, seconds, averaged.
+	///
+	double PipelineAGCTime;
+
+	///
+	/// \brief True while the AGC output is being queued.
+	///
+	bool PipelineQueuing;
+
 	///
 	/// \brief Pass information about the spacecraft to the AGC.
 	/// \param ISP Main engine ISP.
@@ -375,6 +434,21 @@ public:
 	///
 	void LoadState(FILEHANDLE scn);
 
+	///
+	/// For the Virtual AGC this is the erasable memory, the i/o channels, the CPU state and
+	/// the counter increments waiting to be made: everything that isn't in the rope.
+	///
+	/// \brief Save AGC state to an in-memory checkpoint.
+	/// \param cp Checkpoint to save to.
+	///
+	void SaveCheckpoint(Checkpoint &cp);
+
+	///
+	/// \brief Restore AGC state from an in-memory checkpoint.
+	/// \param cp Checkpoint to restore from.
+	///
+	void LoadCheckpoint(Checkpoint &cp);
+
 	//
 	// I/O channels.
 	//
@@ -520,6 +594,50 @@ public:
 	///
 	void PulsePIPA(int RegPIPA, int pulses);
 
+	///
+	/// Peripherals that know when, within a timestep, their counter increments happened can
+	/// have them made at the matching cycles of the next yaAGC run.
+	///
+	/// \brief Get the cycle the next yaAGC run starts at.
+	/// \param cycle Set to the cycle.
+	/// \return False if this isn't a powered Virtual AGC, or it's running on the AGC thread right
+	/// now, in which case the increments should be made with PulsePIPA() or SetErasable().
+	/// While pipelined the run hasn't started yet, so cycles count from 0 and are queued.
+	///
+	bool GetNextRunCycle(uint64_t &cycle);
+
+	///
+	/// \brief Queue counter increments to be made when the yaAGC reaches a cycle.
+	/// \param counter Counter register.
+	/// \param inctype Increment type, as for UnprogrammedIncrement().
+	/// \param count Number of increments.
+	/// \param cycle Cycle to make them at. Everything queued is made in order, so if an earlier
+	/// call asked for a later cycle, that is when this happens too.
+	/// \return False if the queue is full.
+	///
+	bool QueueIncrement(int counter, int inctype, int count, uint64_t cycle);
+
+	///
+	/// \brief Queue a new value for an IMU CDU counter, to be set when the yaAGC reaches a cycle.
+	/// \param RegCDU CDU counter register.
+	/// \param value The counter value, as the CDU pulses up to that cycle would have left it.
+	/// \param cycle Cycle to set it at. Queued increments are made in order, as for QueueIncrement().
+	/// \return False if the queue is full.
+	///
+	bool QueueCDU(int RegCDU, int value, uint64_t cycle);
+
+	///
+	/// Safe to call from either thread: erasable memory is only written while the AGC thread
+	/// is stopped, or by the AGC thread itself.
+	///
+	/// \brief Set an IMU CDU counter as soon as the yaAGC can take it.
+	/// \param RegCDU CDU counter register.
+	/// \param value The counter value.
+	/// \return True if the counter was set now, false if it was queued for the next cycle boundary
+	/// because the AGC thread is running.
+	///
+	bool SetCDU(int RegCDU, int value);
+
 	///
 	/// \brief Is this a Virtual AGC?
 	/// \return True for Virtual AGC, false for C++ AGC.
@@ -699,6 +817,8 @@ protected:
     public: virtual void GenerateRadarupt();
 	public: virtual bool IsUpruptActive();
 	public: virtual void SetCh33Switches(unsigned int val);
+	protected: void RequestInterrupt(int n);
+	protected: void WriteInputChannel(int channel, int val);
 	public: unsigned int GetCh33Switches();
 	public: virtual int DoPINC(int16_t *Counter);
 	public: virtual int DoPCDU(int16_t *Counter);
@@ -1274,8 +1394,13 @@ protected:
 	///
 	char OtherVesselName[64];
 
+	///
+	/// \brief AGC channel log, FLIGHTLOG_AGC.
+	///
+	FlightLogFile agclog;
+
 #ifdef _DEBUG
-	FILE *out_file;
+	FILE *out_file;		///< yaAGC engine debug output
 #endif
 
 
@@ -1290,10 +1415,71 @@ protected:
 	///
 	agc_t vagc;
 	Mutex agcCycleMutex;
+
+	///
+	/// The engine's increment queue takes a single producer, but increments come from the
+	/// main thread and, through ChannelOutput(), from the AGC thread. This serializes them.
+	/// Take agcCycleMutex first when both are needed.
+	/// \brief Lock for adding to the increment queue.
+	///
+	Mutex agcQueueMutex;
+
+	///
+	/// \brief Wakes the AGC thread for each timestep.
+	///
+	/// At high time acceleration the thread is usually only just done with one timestep
+	/// when the next one arrives, so it spins for AGC_WAKEUP_SPIN seconds before it sleeps.
+	///
 	Event timeStepEvent;
 	double thread_simt;
 	double thread_simdt;
 
+	///
+	/// \brief Run the yaAGC for a timestep.
+	///
+	virtual void agcTimestep(double simt, double simdt) = 0;
+
+	///
+	/// \brief AGC thread.
+	///
+	void Run();
+
+	///
+	/// Derived classes call this from their destructor, so that the thread isn't left
+	/// running a timestep on a computer that is half destroyed.
+	/// \brief Stop the AGC thread and wait for it to finish.
+	///
+	void StopThread();
+	bool agcQuit;							///< Set to make the AGC thread exit
+
+	///
+	/// \brief Hand the yaAGC run to the pipeline, from Timestep() when called by StartTimestep().
+	///
+	void PipelineHandoff(double simt, double simdt);
+
+	///
+	/// \brief Do a telemetry step queued by agcTimestep() while pipelined.
+	///
+	virtual void PipelineTelemetry(double t) {};
+
+	///
+	/// \brief Queue a telemetry step, while the AGC is running pipelined.
+	///
+	void QueueTelemetry(double t);
+
+	struct PipelineOp {
+		int channel;	///< Output channel, or -1 for a telemetry step
+		int val;
+		double t;
+	};
+
+	std::vector<PipelineOp> PipelineOps;	///< Queued output, in AGC order
+	AGCInputQueue PipelineInput;			///< Queued input, passed on by FinishTimestep()
+	bool PipelineStep;						///< Timestep() was called by StartTimestep()
+	bool PipelineBusy;						///< The AGC thread is running a pipelined timestep
+	double PipelineStepTime;				///< How long the AGC thread took, seconds
+	Event PipelineDone;
+
 	///
 	/// \brief alarm flags for CWS
 	///
@@ -193,9 +193,10 @@ void ChecklistController::save(FILEHANDLE scn)
 	for (i = 0; i < action.size(); i++)
 		action[i].save(scn);
 
+	vector<bool> called(groups.size());
 	for (i = 0; i < groups.size(); i++)
-		if (groups[i].called)
-			groups[i].save(scn);
+		called[i] = groups[i].called;
+	saveChecklistFlags(scn, "GROUPSCALLED", called);
 
 	oapiWriteScenario_string(scn,ChecklistControllerEndString,"");
 }
@@ -259,6 +260,16 @@ void ChecklistController::load(FILEHANDLE scn)
 				action.push_back(temp);
 			found = true;
 		}
+		if (!found && !strnicmp(line, "GROUPSCALLED", 12))
+		{
+			vector<bool> called(groups.size());
+			loadChecklistFlags(line + 12, called);
+			for (int i = 0; i < groups.size(); i++)
+				if (called[i])
+					groups[i].called = true;
+			found = true;
+		}
+		// Scenarios saved before GROUPSCALLED have a block for every called group.
 		if (!found && !strnicmp(line,ChecklistGroupStartString,strlen(ChecklistGroupStartString)))
 		{
 			oapiReadScenario_nextline(scn,line);
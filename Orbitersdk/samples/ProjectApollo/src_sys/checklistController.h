@@ -93,6 +93,20 @@ enum RelativeEvent
 	SPLASHDOWN,
 };
 RelativeEvent checkEvent(const char*, bool Group=false);
+/// -------------------------------------------------------------
+/// Compact scenario encoding for a set of flags, used to save
+/// only what differs from the checklist file: one hex digit for
+/// every four flags, the first flag in the lowest bit of the
+/// first digit, with trailing zero digits left out.  Nothing is
+/// written if no flag is set.
+/// -------------------------------------------------------------
+void saveChecklistFlags(FILEHANDLE scn, char *item, const vector<bool> &flags);
+/// -------------------------------------------------------------
+/// Set the flags given in a line written by saveChecklistFlags.
+/// Flags past the end of the vector are ignored, the others are
+/// left as they were.
+/// -------------------------------------------------------------
+void loadChecklistFlags(const char *line, vector<bool> &flags);
 enum Status
 {
 	FAILED = -1,
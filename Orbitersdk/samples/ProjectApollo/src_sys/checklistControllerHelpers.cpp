@@ -75,6 +75,47 @@ RelativeEvent checkEvent(const char* input, bool Group)
 		return TLI;
 	return NO_TIME_DEF;
 }
+// Flag set encoding.
+
+void saveChecklistFlags(FILEHANDLE scn, char *item, const vector<bool> &flags)
+{
+	string hex;
+	size_t used = 0;
+
+	for (size_t i = 0; i < flags.size(); i += 4)
+	{
+		int digit = 0;
+		for (size_t j = 0; j < 4 && i + j < flags.size(); j++)
+		{
+			if (flags[i + j])
+				digit |= 1 << j;
+		}
+		hex += "0123456789abcdef"[digit];
+		if (digit)
+			used = hex.size();
+	}
+	if (used)
+	{
+		hex.resize(used);
+		oapiWriteScenario_string(scn, item, (char *) hex.c_str());
+	}
+}
+
+void loadChecklistFlags(const char *line, vector<bool> &flags)
+{
+	while (*line == ' ')
+		line++;
+	for (size_t i = 0; isxdigit((unsigned char) line[i]); i++)
+	{
+		int c = tolower((unsigned char) line[i]);
+		int digit = (c <= '9') ? c - '0' : c - 'a' + 10;
+		for (size_t j = 0; j < 4; j++)
+		{
+			if ((digit & (1 << j)) && 4 * i + j < flags.size())
+				flags[4 * i + j] = true;
+		}
+	}
+}
 //Checklist Item methods.
 
 ChecklistItem::ChecklistItem() 
@@ -771,11 +812,29 @@ void ChecklistContainer::initSet(const ChecklistGroup &program,vector<ChecklistI
 // Todo: Verify
 void ChecklistContainer::save(FILEHANDLE scn)
 {
+	vector<bool> complete(set.size()), failed(set.size());
+	char buffer[100];
+	int i;
+
 	oapiWriteScenario_string(scn,ChecklistContainerStartString,"");
 	oapiWriteScenario_int(scn,"INDEX",program.group);
-	for (int i = 0; i < set.size(); i++)
+
+	// Only what differs from a freshly loaded checklist: the items that are
+	// no longer pending, and the DSKY steps that have been started.
+	for (i = 0; i < set.size(); i++)
 	{
-		set[i].save(scn);
+		complete[i] = (set[i].status == COMPLETE);
+		failed[i] = (set[i].status == FAILED);
+	}
+	saveChecklistFlags(scn,"ITEMSCOMPLETE",complete);
+	saveChecklistFlags(scn,"ITEMSFAILED",failed);
+	for (i = 0; i < set.size(); i++)
+	{
+		if (set[i].dskyIndex != 0)
+		{
+			sprintf(buffer,"%d %d",i,set[i].dskyIndex);
+			oapiWriteScenario_string(scn,"DSKYINDEX",buffer);
+		}
 	}
 	oapiWriteScenario_int(scn,"SEQUENCE",sequence->index);
 	oapiWriteScenario_float(scn,"TIME",startTime);
@@ -818,6 +877,34 @@ void ChecklistContainer::load(FILEHANDLE scn, ChecklistController &controller)
 			startTime = fcpt;
 			found = true;
 		}
+		if (!found && !strnicmp(line,"ITEMSCOMPLETE",13))
+		{
+			vector<bool> flags(set.size());
+			loadChecklistFlags(line+13,flags);
+			for (int i = 0; i < set.size(); i++)
+				if (flags[i])
+					set[i].status = COMPLETE;
+			found = true;
+		}
+		if (!found && !strnicmp(line,"ITEMSFAILED",11))
+		{
+			vector<bool> flags(set.size());
+			loadChecklistFlags(line+11,flags);
+			for (int i = 0; i < set.size(); i++)
+				if (flags[i])
+					set[i].status = FAILED;
+			found = true;
+		}
+		if (!found && !strnicmp(line,"DSKYINDEX",9))
+		{
+			int dsky = 0;
+			integer = -1;
+			sscanf(line+9,"%d %d",&integer,&dsky);
+			if (integer >= 0 && integer < set.size())
+				set[integer].dskyIndex = dsky;
+			found = true;
+		}
+		// Scenarios saved before ITEMSCOMPLETE have a block for every item.
 		if (!found && !strnicmp(line,ChecklistItemStartString,strlen(ChecklistItemStartString)))
 		{
 			oapiReadScenario_nextline(scn, line);
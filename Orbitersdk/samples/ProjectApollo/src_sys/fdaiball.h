@@ -0,0 +1,364 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  Software renderer for the FDAI ball
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  **************************************************************************/
+
+#if !defined(_PA_FDAIBALL_H)
+#define _PA_FDAIBALL_H
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#define FDAIBALL_SIZE		180			///< Frame width and height, pixels
+#define FDAIBALL_CACHE		16			///< Frames kept by the cache
+#define FDAIBALL_QUANTUM	0.0025		///< Attitude step of cached frames, radians (about 0.14 deg)
+
+///
+/// \ingroup FDAI
+/// \brief The FDAI ball, drawn without OpenGL.
+///
+/// This draws the same scene the FDAI used to build with gluSphere: a textured
+/// ball of radius 12 seen from 35 units with a 45 degree field of view, lit by
+/// the one white directional light. The lighting of a pixel doesn't depend on the
+/// attitude, so it is worked out once; a frame then maps every pixel on the ball
+/// back to the texture with the inverse attitude rotation.
+///
+/// The mapping runs over flat float arrays with no branches, so the compiler can
+/// vectorize it, and only the texture fetch is done a pixel at a time.
+///
+/// Frames are cached by attitude, quantized to FDAIBALL_QUANTUM, so a ball that
+/// stands still or turns slowly costs a copy.
+///
+/// Frames are FDAIBALL_SIZE square, top row first, one 0x00RRGGBB word per pixel.
+///
+class FDAIBall
+{
+public:
+	FDAIBall() : hits(0), misses(0), texW(0), texH(0), clock(0)
+	{
+		const double pi = 3.14159265358979323846;
+		const double tanfov = tan(22.5 / 180.0 * pi);
+		const double dist = 35.0, radius = 12.0;
+
+		// Light direction and half vector for a viewer at infinity, in eye coordinates
+		double l[3] = { -10.0, 10.0, 10.0 }, h[3];
+		Normalize(l);
+		h[0] = l[0]; h[1] = l[1]; h[2] = l[2] + 1.0;
+		Normalize(h);
+
+		for (int j = 0; j < FDAIBALL_SIZE; j++)
+		{
+			for (int i = 0; i < FDAIBALL_SIZE; i++)
+			{
+				// Eye ray through the pixel center, hitting the ball at (0, 0, -dist)
+				double d[3] = { ((i + 0.5) / (FDAIBALL_SIZE / 2) - 1.0) * tanfov, (1.0 - (j + 0.5) / (FDAIBALL_SIZE / 2)) * tanfov, -1.0 };
+				Normalize(d);
+				double b = -d[2] * dist;
+				double disc = b * b - (dist * dist - radius * radius);
+				if (disc < 0)
+					continue;
+
+				double t = b - sqrt(disc);
+				double n[3] = { d[0] * t / radius, d[1] * t / radius, (d[2] * t + dist) / radius };
+
+				// Default material: ambient 0.2 from the light and 0.2 x 0.2 global, diffuse 0.8,
+				// specular 0.5 x 0.5 with shininess 5
+				double ndotl = n[0] * l[0] + n[1] * l[1] + n[2] * l[2];
+				double shade = 0.24;
+				if (ndotl > 0)
+				{
+					double ndoth = n[0] * h[0] + n[1] * h[1] + n[2] * h[2];
+					shade += 0.8 * ndotl + (ndoth > 0 ? 0.25 * pow(ndoth, 5.0) : 0.0);
+				}
+				if (shade > 1.0) shade = 1.0;
+
+				pixel.push_back(j * FDAIBALL_SIZE + i);
+				nx.push_back((float)n[0]);
+				ny.push_back((float)n[1]);
+				nz.push_back((float)n[2]);
+				light.push_back((unsigned short)(shade * 256.0 + 0.5));
+			}
+		}
+		u.resize(pixel.size());
+		v.resize(pixel.size());
+
+		for (int k = 0; k < FDAIBALL_CACHE; k++)
+		{
+			cache[k].used = 0;
+			cache[k].frame.assign(FDAIBALL_SIZE * FDAIBALL_SIZE, 0);
+		}
+	}
+
+	///
+	/// \brief Load the ball texture, a 24 bit BMP whatever its extension.
+	/// \return false if it can't be read, the ball is then drawn white.
+	///
+	bool LoadTexture(const char *filename)
+	{
+		FILE *f = fopen(filename, "rb");
+		if (!f)
+			return false;
+
+		unsigned char hdr[54];
+		bool ok = fread(hdr, 1, 54, f) == 54 && hdr[0] == 'B' && hdr[1] == 'M' && Word(hdr + 28, 2) == 24;
+		int w = ok ? (int)Word(hdr + 18, 4) : 0;
+		int h = ok ? (int)Word(hdr + 22, 4) : 0;
+		if (!ok || w <= 0 || h <= 0 || fseek(f, Word(hdr + 10, 4), SEEK_SET))
+		{
+			fclose(f);
+			return false;
+		}
+
+		// Rows are stored bottom up, which is the texture's t = 0 up. One extra row
+		// and column repeat the first ones, so bilinear filtering never wraps.
+		std::vector<unsigned char> row((w * 3 + 3) & ~3);
+		std::vector<unsigned int> tex((w + 1) * (h + 1));
+		for (int y = 0; y < h && ok; y++)
+		{
+			ok = fread(&row[0], 1, row.size(), f) == row.size();
+			for (int x = 0; x < w; x++)
+			{
+				tex[y * (w + 1) + x] = (row[x * 3 + 2] << 16) | (row[x * 3 + 1] << 8) | row[x * 3];
+			}
+			tex[y * (w + 1) + w] = tex[y * (w + 1)];
+		}
+		fclose(f);
+		if (!ok)
+			return false;
+
+		memcpy(&tex[h * (w + 1)], &tex[0], (w + 1) * sizeof(unsigned int));
+		texture.swap(tex);
+		texW = w;
+		texH = h;
+		Flush();
+		return true;
+	}
+
+	///
+	/// \brief Get the frame for an attitude, from the cache or drawn.
+	/// \param x, y, z Ball rotation in radians, as FDAI::RenderBall used to apply it.
+	/// \return The frame, valid until the next call.
+	///
+	const unsigned int *Frame(double x, double y, double z)
+	{
+		int key[3] = { Quantize(x), Quantize(y), Quantize(z) };
+
+		clock++;
+		Entry *oldest = &cache[0];
+		for (int k = 0; k < FDAIBALL_CACHE; k++)
+		{
+			Entry &e = cache[k];
+			if (e.used && e.key[0] == key[0] && e.key[1] == key[1] && e.key[2] == key[2])
+			{
+				e.used = clock;
+				hits++;
+				return &e.frame[0];
+			}
+			if (e.used < oldest->used)
+				oldest = &e;
+		}
+
+		misses++;
+		memcpy(oldest->key, key, sizeof(key));
+		oldest->used = clock;
+		Render(key[0] * FDAIBALL_QUANTUM, key[1] * FDAIBALL_QUANTUM, key[2] * FDAIBALL_QUANTUM, &oldest->frame[0], false);
+		return &oldest->frame[0];
+	}
+
+	///
+	/// \brief Draw a frame without the cache.
+	/// \param precise Use the library atan2 instead of the fast one, for comparison.
+	///
+	void Render(double x, double y, double z, unsigned int *frame, bool precise = false)
+	{
+		// Eye to ball coordinates: the view takes world (x, y, z) to eye (x, z, -y),
+		// then the inverse of the ball rotation
+		double r[3][3];
+		Rotation(x, y, z, r);
+		float m[3][3];
+		for (int i = 0; i < 3; i++)
+		{
+			m[i][0] = (float)r[0][i];
+			m[i][1] = (float)r[2][i];
+			m[i][2] = (float)-r[1][i];
+		}
+
+		const int n = (int)pixel.size();
+		const float *px = &nx[0], *py = &ny[0], *pz = &nz[0];
+		float *pu = &u[0], *pv = &v[0];
+		const float su = texW ? (float)texW : 1.0f, sv = texH ? (float)texH : 1.0f;
+		const float inv2pi = 0.159154943f, invpi = 0.318309886f;
+
+		if (precise)
+		{
+			for (int k = 0; k < n; k++)
+			{
+				float ox = m[0][0] * px[k] + m[0][1] * py[k] + m[0][2] * pz[k];
+				float oy = m[1][0] * px[k] + m[1][1] * py[k] + m[1][2] * pz[k];
+				float oz = m[2][0] * px[k] + m[2][1] * py[k] + m[2][2] * pz[k];
+				float lon = atan2f(ox, oy), lat = atan2f(sqrtf(ox * ox + oy * oy), oz);
+				pu[k] = (lon < 0 ? lon * inv2pi + 1.0f : lon * inv2pi) * su;
+				pv[k] = (1.0f - lat * invpi) * sv;
+			}
+		}
+		else
+		{
+			for (int k = 0; k < n; k++)
+			{
+				float ox = m[0][0] * px[k] + m[0][1] * py[k] + m[0][2] * pz[k];
+				float oy = m[1][0] * px[k] + m[1][1] * py[k] + m[1][2] * pz[k];
+				float oz = m[2][0] * px[k] + m[2][1] * py[k] + m[2][2] * pz[k];
+				float lon = FastAtan2(ox, oy), lat = FastAtan2(sqrtf(ox * ox + oy * oy), oz);
+				pu[k] = lon * inv2pi * su;
+				pv[k] = (1.0f - lat * invpi) * sv;
+			}
+		}
+
+		memset(frame, 0, FDAIBALL_SIZE * FDAIBALL_SIZE * sizeof(unsigned int));
+		if (!texW)
+		{
+			for (int k = 0; k < n; k++)
+			{
+				unsigned int c = light[k] > 255 ? 255 : light[k];
+				frame[pixel[k]] = (c << 16) | (c << 8) | c;
+			}
+			return;
+		}
+
+		// Bilinear texture fetch with 8 bit weights, modulated by the light
+		const unsigned int *tex = &texture[0];
+		const int stride = texW + 1;
+		for (int k = 0; k < n; k++)
+		{
+			int fu = (int)((pu[k] - 0.5f) * 256.0f) + 2 * 256 * texW;
+			int fv = (int)((pv[k] - 0.5f) * 256.0f) + 2 * 256 * texH;
+			int tu = (fu >> 8) % texW, tv = (fv >> 8) % texH;
+			unsigned int wu = fu & 255, wv = fv & 255;
+			const unsigned int *t = tex + tv * stride + tu;
+
+			unsigned int w00 = (256 - wu) * (256 - wv), w01 = wu * (256 - wv), w10 = (256 - wu) * wv, w11 = wu * wv;
+			unsigned int rb = ((t[0] & 0xFF00FF) * (w00 >> 8) + (t[1] & 0xFF00FF) * (w01 >> 8) +
+				(t[stride] & 0xFF00FF) * (w10 >> 8) + (t[stride + 1] & 0xFF00FF) * (w11 >> 8)) >> 8;
+			unsigned int g = ((t[0] & 0xFF00) * (w00 >> 8) + (t[1] & 0xFF00) * (w01 >> 8) +
+				(t[stride] & 0xFF00) * (w10 >> 8) + (t[stride + 1] & 0xFF00) * (w11 >> 8)) >> 8;
+
+			unsigned int s = light[k];
+			rb = ((rb & 0xFF00FF) * s >> 8) & 0xFF00FF;
+			g = ((g & 0xFF00) * s >> 8) & 0xFF00;
+			frame[pixel[k]] = rb | g;
+		}
+	}
+
+	///
+	/// \brief Drop all cached frames.
+	///
+	void Flush()
+	{
+		for (int k = 0; k < FDAIBALL_CACHE; k++)
+			cache[k].used = 0;
+	}
+
+	unsigned long hits;		///< Frames from the cache
+	unsigned long misses;	///< Frames drawn
+
+protected:
+	struct Entry
+	{
+		int key[3];
+		unsigned long used;		///< Last use, 0 if empty
+		std::vector<unsigned int> frame;
+	};
+
+	static int Quantize(double a)
+	{
+		const double twopi = 6.28318530717958647692;
+		a = fmod(a, twopi);
+		if (a < 0) a += twopi;
+		int q = (int)floor(a / FDAIBALL_QUANTUM + 0.5);
+		return q >= (int)(twopi / FDAIBALL_QUANTUM) ? 0 : q;
+	}
+
+	static unsigned int Word(const unsigned char *p, int n)
+	{
+		unsigned int w = 0;
+		for (int i = n - 1; i >= 0; i--)
+			w = (w << 8) | p[i];
+		return w;
+	}
+
+	static void Normalize(double *v)
+	{
+		double l = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+		v[0] /= l; v[1] /= l; v[2] /= l;
+	}
+
+	///
+	/// Ball rotation, the product of the glRotated calls.
+	///
+	static void Rotation(double x, double y, double z, double r[3][3])
+	{
+		const double pi = 3.14159265358979323846;
+		double cy = cos(pi / 2 + y), sy = sin(pi / 2 + y);
+		double cx = cos(x), sx = sin(x), cz = cos(z), sz = sin(z);
+		double ry[3][3] = { { cy, 0, sy }, { 0, 1, 0 }, { -sy, 0, cy } };
+		double rx[3][3] = { { 1, 0, 0 }, { 0, cx, -sx }, { 0, sx, cx } };
+		double rz[3][3] = { { cz, -sz, 0 }, { sz, cz, 0 }, { 0, 0, 1 } };
+		double t[3][3];
+
+		for (int i = 0; i < 3; i++)
+			for (int j = 0; j < 3; j++)
+				t[i][j] = ry[i][0] * rx[0][j] + ry[i][1] * rx[1][j] + ry[i][2] * rx[2][j];
+		for (int i = 0; i < 3; i++)
+			for (int j = 0; j < 3; j++)
+				r[i][j] = t[i][0] * rz[0][j] + t[i][1] * rz[1][j] + t[i][2] * rz[2][j];
+	}
+
+	///
+	/// atan2 in [0, 2 pi), about 1e-5 radians off, without branches.
+	///
+	static inline float FastAtan2(float y, float x)
+	{
+		float ax = fabsf(x), ay = fabsf(y);
+		float mx = ax > ay ? ax : ay, mn = ax > ay ? ay : ax;
+		float a = mn / (mx + 1e-30f);
+		float s = a * a;
+		float r = ((((-0.0117212f * s + 0.05265332f) * s - 0.11643287f) * s + 0.19354346f) * s - 0.33262348f) * s * a + 0.99997726f * a;
+		r = ay > ax ? 1.57079637f - r : r;
+		r = x < 0 ? 3.14159274f - r : r;
+		return y < 0 ? 6.28318548f - r : r;
+	}
+
+	// Pixels on the ball, with their eye space normal and light, 8.8 fixed point
+	std::vector<int> pixel;
+	std::vector<float> nx, ny, nz;
+	std::vector<unsigned short> light;
+	std::vector<float> u, v;
+
+	std::vector<unsigned int> texture;	///< 0x00RRGGBB, (texW + 1) x (texH + 1)
+	int texW, texH;
+
+	Entry cache[FDAIBALL_CACHE];
+	unsigned long clock;
+};
+
+#endif
@@ -0,0 +1,647 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  Binary flight logger for the LVDC, AGC and IMU logs
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  **************************************************************************/
+
+#if !defined(_PA_FLIGHTLOG_H)
+#define _PA_FLIGHTLOG_H
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+///
+/// \ingroup Logging
+/// Log channels, selectable at runtime with FlightLogSetChannels().
+///
+#define FLIGHTLOG_LVDC		1	///< LVDC guidance log, lvlog.txt
+#define FLIGHTLOG_AGC		2	///< AGC channel log, ProjectApollo AGC.log
+#define FLIGHTLOG_IMU		4	///< IMU log, ProjectApollo IMU.log
+
+///
+/// Not a channel: logs opened while it is set are written as binary .flog files for
+/// FlightLogDecode, instead of the text logs.
+///
+#define FLIGHTLOG_BINARY	8
+
+#ifdef _DEBUG
+#define FLIGHTLOG_DEFAULT	(FLIGHTLOG_LVDC | FLIGHTLOG_AGC | FLIGHTLOG_IMU)
+#else
+#define FLIGHTLOG_DEFAULT	FLIGHTLOG_LVDC
+#endif
+
+#define FLIGHTLOG_MAXFIELDS	12		///< Numeric fields per record
+#define FLIGHTLOG_TEXT		48		///< Bytes for %s fields per record, longer strings are cut
+#define FLIGHTLOG_RING		4096	///< Records per thread, power of two
+#define FLIGHTLOG_FLUSH_MS	20		///< Flusher period
+
+#define FLIGHTLOG_MAGIC		"NFLOG1\n"	///< File header, 8 bytes with the terminator
+
+///
+/// Field types, as stored in the file.
+///
+#define FLIGHTLOG_INT		'i'
+#define FLIGHTLOG_DOUBLE	'd'
+#define FLIGHTLOG_STRING	's'
+
+///
+/// \ingroup Logging
+/// \brief One log line, as the format string and its arguments.
+///
+/// The binary file has a header (FLIGHTLOG_MAGIC, log channel as uint32, uint16 length
+/// and the text log name), then a sequence of entries:
+///
+/// 'F' uint16 id, uint16 length, format string: defines a record id, before its first use.
+///
+/// 'R' uint16 id, double time, int32 timebase, uint8 n, n times (uint8 type, 8 byte value),
+/// uint8 length, text: one record.
+///
+/// 'E' uint32 dropped: the end of the log, with the number of records lost because the
+/// ring of their thread was full.
+///
+struct FlightLogRecord
+{
+	int file;							///< FlightLogFile number
+	const char *fmt;					///< Format string, must be a literal
+	double t;							///< Time of the record
+	int timebase;						///< Timebase of the record
+	unsigned char n;					///< Fields used
+	unsigned char textlen;				///< Text bytes used
+	unsigned char types[FLIGHTLOG_MAXFIELDS];
+	union {
+		double d;
+		long long i;
+	} fields[FLIGHTLOG_MAXFIELDS];
+	char text[FLIGHTLOG_TEXT];
+};
+
+///
+/// \brief Print a record the way fprintf() would have, with the fields in their stored types.
+///
+inline void FlightLogFormat(FILE *out, const char *fmt, const FlightLogRecord &r)
+{
+	int field = 0, textpos = 0;
+	const char *p = fmt;
+	char spec[32];
+
+	while (*p)
+	{
+		if (*p != '%')
+		{
+			fputc(*p++, out);
+			continue;
+		}
+		if (p[1] == '%')
+		{
+			fputc('%', out);
+			p += 2;
+			continue;
+		}
+
+		//
+		// Copy flags, width and precision, drop the length modifier.
+		//
+		size_t len = 0;
+		spec[len++] = *p++;
+		while (*p && strchr("-+ #0123456789.*", *p))
+		{
+			if (len < sizeof(spec) - 4) spec[len++] = *p;
+			p++;
+		}
+		while (*p && strchr("hlLqjzt", *p)) p++;
+		char conv = *p;
+		if (!conv) break;
+		p++;
+
+		if (field >= r.n)
+			continue;
+		int type = r.types[field];
+		double d = (type == FLIGHTLOG_INT) ? (double)r.fields[field].i : r.fields[field].d;
+		long long i = (type == FLIGHTLOG_DOUBLE) ? (long long)r.fields[field].d : r.fields[field].i;
+		field++;
+
+		switch (conv)
+		{
+		case 'd': case 'i': case 'o': case 'x': case 'X': case 'u':
+			spec[len++] = 'l';
+			spec[len++] = 'l';
+			spec[len++] = conv;
+			spec[len] = 0;
+			fprintf(out, spec, i);
+			break;
+
+		case 'c':
+			spec[len++] = 'c';
+			spec[len] = 0;
+			fprintf(out, spec, (int)i);
+			break;
+
+		case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+			spec[len++] = conv;
+			spec[len] = 0;
+			fprintf(out, spec, d);
+			break;
+
+		case 's':
+			spec[len++] = 's';
+			spec[len] = 0;
+			if (textpos < r.textlen)
+			{
+				fprintf(out, spec, r.text + textpos);
+				textpos += (int)strlen(r.text + textpos) + 1;
+			}
+			else
+			{
+				fprintf(out, spec, "");
+			}
+			break;
+
+		default:
+			spec[len] = 0;
+			fputs(spec, out);
+			fputc(conv, out);
+			break;
+		}
+	}
+}
+
+///
+/// \brief Records from one thread. Single producer, and the flusher is the single consumer.
+///
+struct FlightLogRing
+{
+	FlightLogRing() : head(0), tail(0), orphaned(false) {}
+
+	std::atomic<unsigned> head;			///< Next record to write
+	std::atomic<unsigned> tail;			///< Next record to flush
+	std::atomic<bool> orphaned;			///< The thread is gone, free when empty
+	FlightLogRecord records[FLIGHTLOG_RING];
+};
+
+///
+/// \brief Enabled log channels.
+///
+inline std::atomic<int> &FlightLogChannels()
+{
+	static std::atomic<int> channels(FLIGHTLOG_DEFAULT);
+	return channels;
+}
+
+///
+/// \brief Select the log channels to record, FLIGHTLOG_* ORed together.
+///
+inline void FlightLogSetChannels(int channels)
+{
+	FlightLogChannels() = channels;
+}
+
+///
+/// \ingroup Logging
+/// \brief Collects the records of all threads and writes them to the log files.
+///
+/// Writing a record only copies it into the ring of the calling thread. A background
+/// thread writes the rings to the files every FLIGHTLOG_FLUSH_MS, and only runs while
+/// any log file is open. So the text is formatted on that thread, or with FLIGHTLOG_BINARY
+/// not at all, and FlightLogDecode makes the text logs later.
+///
+/// A thread that logs faster than the flusher keeps up with loses the records that don't
+/// fit its ring. The count is written at the end of the log.
+///
+class FlightLog
+{
+public:
+	///
+	/// \brief The logger. Never deleted, as the flusher may still be using it on unload.
+	///
+	static FlightLog &Get()
+	{
+		static FlightLog *log = new FlightLog;
+		return *log;
+	}
+
+	///
+	/// \brief Open a log file.
+	/// \param channel FLIGHTLOG_* channel.
+	/// \param name Name of the text log. The binary log is written to the same name with .flog.
+	/// \return File number, or 0 if it can't be opened.
+	///
+	int Open(int channel, const char *name)
+	{
+		bool binary = (FlightLogChannels() & FLIGHTLOG_BINARY) != 0;
+		FILE *f;
+
+		if (binary)
+		{
+			char binname[256];
+			strncpy(binname, name, sizeof(binname) - 8);
+			binname[sizeof(binname) - 8] = 0;
+			char *ext = strrchr(binname, '.');
+			if (ext) *ext = 0;
+			strcat(binname, ".flog");
+
+			f = fopen(binname, "wb");
+			if (!f) return 0;
+			setvbuf(f, NULL, _IOFBF, 65536);
+
+			unsigned int ch = channel;
+			unsigned short len = (unsigned short)strlen(name);
+			fwrite(FLIGHTLOG_MAGIC, 1, 8, f);
+			fwrite(&ch, sizeof(ch), 1, f);
+			fwrite(&len, sizeof(len), 1, f);
+			fwrite(name, 1, len, f);
+		}
+		else
+		{
+			f = fopen(name, "w");
+			if (!f) return 0;
+			setvbuf(f, NULL, _IOFBF, 65536);
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		int id = nextid++;
+		files[id].f = f;
+		files[id].binary = binary;
+		if (!flushing)
+		{
+			flushing = true;
+			std::thread(&FlightLog::Flusher, this).detach();
+		}
+		return id;
+	}
+
+	///
+	/// \brief Write what's logged so far, and close a log file.
+	/// \param dropped Records that were dropped, for the end of the log.
+	///
+	void Close(int id, unsigned int dropped)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		Drain();
+
+		std::map<int, OpenFile>::iterator it = files.find(id);
+		if (it == files.end()) return;
+		if (it->second.binary)
+		{
+			fputc('E', it->second.f);
+			fwrite(&dropped, sizeof(dropped), 1, it->second.f);
+		}
+		else if (dropped)
+		{
+			fprintf(it->second.f, "*** %u records dropped, the flight log could not keep up ***\n", dropped);
+		}
+		fclose(it->second.f);
+		files.erase(it);
+
+		//
+		// Wait for the flusher to stop with the last file, so the module can be unloaded.
+		//
+		if (files.empty())
+		{
+			wake.notify_all();
+			stopped.wait(lock, [this] { return !flushing; });
+		}
+	}
+
+	///
+	/// \brief Get a record to fill in, in the ring of this thread.
+	/// \return NULL if the ring is full. The record is then dropped, as waiting for the
+	/// flusher would stall the simulation.
+	///
+	FlightLogRecord *Begin()
+	{
+		FlightLogRing *ring = ThreadRing();
+		unsigned head = ring->head.load(std::memory_order_relaxed);
+
+		if (head - ring->tail.load(std::memory_order_acquire) >= FLIGHTLOG_RING)
+		{
+			wake.notify_one();
+			return NULL;
+		}
+		return &ring->records[head & (FLIGHTLOG_RING - 1)];
+	}
+
+	///
+	/// \brief Pass the record from Begin() to the flusher.
+	///
+	void Commit()
+	{
+		FlightLogRing *ring = ThreadRing();
+		ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+protected:
+	FlightLog() : nextid(1), flushing(false) {}
+
+	struct OpenFile {
+		OpenFile() : f(NULL), binary(false) {}
+		FILE *f;
+		bool binary;								///< .flog file, or else the text log
+		std::map<std::string, unsigned short> ids;	///< Record ids of the format strings written so far
+	};
+
+	struct RingOwner {
+		RingOwner() : ring(NULL) {}
+		~RingOwner() { if (ring) ring->orphaned = true; }
+		FlightLogRing *ring;
+	};
+
+	FlightLogRing *ThreadRing()
+	{
+		static thread_local RingOwner owner;
+		if (!owner.ring)
+		{
+			owner.ring = new FlightLogRing;
+			std::unique_lock<std::mutex> lock(mutex);
+			rings.push_back(owner.ring);
+		}
+		return owner.ring;
+	}
+
+	void Flusher()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (!files.empty())
+		{
+			wake.wait_for(lock, std::chrono::milliseconds(FLIGHTLOG_FLUSH_MS));
+			Drain();
+		}
+		flushing = false;
+		stopped.notify_all();
+	}
+
+	///
+	/// \brief Write the records in all rings to their files. Called with the mutex held.
+	///
+	void Drain()
+	{
+		std::map<int, OpenFile>::iterator it;
+
+		for (size_t i = 0; i < rings.size();)
+		{
+			FlightLogRing *ring = rings[i];
+			unsigned head = ring->head.load(std::memory_order_acquire);
+			unsigned tail = ring->tail.load(std::memory_order_relaxed);
+
+			while (tail != head)
+			{
+				FlightLogRecord &r = ring->records[tail & (FLIGHTLOG_RING - 1)];
+				if ((it = files.find(r.file)) != files.end())
+				{
+					Write(it->second, r);
+				}
+				tail++;
+			}
+			ring->tail.store(tail, std::memory_order_release);
+
+			if (ring->orphaned && ring->head.load(std::memory_order_acquire) == tail)
+			{
+				delete ring;
+				rings.erase(rings.begin() + i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		for (it = files.begin(); it != files.end(); ++it)
+		{
+			fflush(it->second.f);
+		}
+	}
+
+	void Write(OpenFile &of, FlightLogRecord &r)
+	{
+		FILE *f = of.f;
+		unsigned short id;
+
+		if (!of.binary)
+		{
+			FlightLogFormat(f, r.fmt, r);
+			return;
+		}
+
+		//
+		// Format strings are told apart by their text, as the same literal can be at
+		// different addresses and an address can be reused by another module.
+		//
+		std::map<std::string, unsigned short>::iterator fmt = of.ids.find(r.fmt);
+		if (fmt == of.ids.end())
+		{
+			id = (unsigned short)of.ids.size();
+			of.ids[r.fmt] = id;
+
+			unsigned short len = (unsigned short)strlen(r.fmt);
+			fputc('F', f);
+			fwrite(&id, sizeof(id), 1, f);
+			fwrite(&len, sizeof(len), 1, f);
+			fwrite(r.fmt, 1, len, f);
+		}
+		else
+		{
+			id = fmt->second;
+		}
+
+		fputc('R', f);
+		fwrite(&id, sizeof(id), 1, f);
+		fwrite(&r.t, sizeof(r.t), 1, f);
+		fwrite(&r.timebase, sizeof(r.timebase), 1, f);
+		fputc(r.n, f);
+		for (int i = 0; i < r.n; i++)
+		{
+			fputc(r.types[i], f);
+			fwrite(&r.fields[i], sizeof(r.fields[i]), 1, f);
+		}
+		fputc(r.textlen, f);
+		fwrite(r.text, 1, r.textlen, f);
+	}
+
+	std::mutex mutex;
+	std::condition_variable wake;			///< Wakes the flusher early
+	std::condition_variable stopped;		///< The flusher is gone
+	std::map<int, OpenFile> files;
+	std::vector<FlightLogRing *> rings;
+	int nextid;
+	bool flushing;							///< The flusher is running
+};
+
+//
+// Record fields. Numbers are stored as they are passed, strings are copied.
+//
+
+template <typename T> inline void FlightLogPut(FlightLogRecord &r, T v)
+{
+	static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Flight log fields must be numbers or strings");
+	if (std::is_floating_point<T>::value)
+	{
+		r.types[r.n] = FLIGHTLOG_DOUBLE;
+		r.fields[r.n++].d = (double)v;
+	}
+	else
+	{
+		r.types[r.n] = FLIGHTLOG_INT;
+		r.fields[r.n++].i = (long long)v;
+	}
+}
+
+inline void FlightLogPut(FlightLogRecord &r, const char *s)
+{
+	size_t room = FLIGHTLOG_TEXT - r.textlen;
+	if (room > 0)
+	{
+		size_t len = strlen(s);
+		if (len > room - 1) len = room - 1;
+		memcpy(r.text + r.textlen, s, len);
+		r.textlen += (unsigned char)len;
+		r.text[r.textlen++] = 0;
+	}
+
+	r.types[r.n] = FLIGHTLOG_STRING;
+	r.fields[r.n++].i = 0;
+}
+
+inline void FlightLogPut(FlightLogRecord &r, char *s)
+{
+	FlightLogPut(r, (const char *)s);
+}
+
+inline void FlightLogPack(FlightLogRecord &) {}
+
+template <typename T, typename... Rest> inline void FlightLogPack(FlightLogRecord &r, T v, Rest... rest)
+{
+	FlightLogPut(r, v);
+	FlightLogPack(r, rest...);
+}
+
+///
+/// \ingroup Logging
+/// \brief A log file, written through the FlightLog.
+///
+/// Printf() takes the same arguments as fprintf(), but only %d, %o, %x, %u, %c, %f, %e, %g
+/// and %s conversions. The format must be a string literal, as it is written to the file
+/// by the flusher later.
+///
+class FlightLogFile
+{
+public:
+	FlightLogFile() : id(0), channel(0), dropped(0), timebase(NULL), time(NULL) { name[0] = 0; }
+	~FlightLogFile() { Close(); }
+
+	///
+	/// \brief Set up the log. The file is created with the first record, so there is none
+	/// while the channel is off.
+	/// \param ch FLIGHTLOG_* channel.
+	/// \param logname Name of the text log.
+	///
+	void Open(int ch, const char *logname)
+	{
+		Close();
+		std::unique_lock<std::mutex> lock(openlock);
+		channel = ch;
+		dropped = 0;
+		strncpy(name, logname, sizeof(name) - 1);
+		name[sizeof(name) - 1] = 0;
+	}
+
+	void Close()
+	{
+		std::unique_lock<std::mutex> lock(openlock);
+		if (id)
+		{
+			FlightLog::Get().Close(id, dropped.exchange(0));
+			id = 0;
+		}
+		name[0] = 0;
+	}
+
+	///
+	/// \brief Record timebase and time from these variables with every record.
+	///
+	void SetClock(const int *tb, const double *t)
+	{
+		timebase = tb;
+		time = t;
+	}
+
+	///
+	/// \brief Records dropped since the log was opened.
+	///
+	unsigned int GetDropped() { return dropped; }
+
+	template <typename... Args> void Printf(const char *fmt, Args... args)
+	{
+		static_assert(sizeof...(Args) <= FLIGHTLOG_MAXFIELDS, "Too many flight log fields");
+
+		if (!(FlightLogChannels().load(std::memory_order_relaxed) & channel))
+			return;
+		if (!id && !Create())
+			return;
+
+		FlightLog &log = FlightLog::Get();
+		FlightLogRecord *r = log.Begin();
+		if (!r)
+		{
+			dropped++;
+			return;
+		}
+		r->file = id;
+		r->fmt = fmt;
+		r->timebase = timebase ? *timebase : 0;
+		r->t = time ? *time : 0.0;
+		r->n = 0;
+		r->textlen = 0;
+		FlightLogPack(*r, args...);
+		log.Commit();
+	}
+
+protected:
+	FlightLogFile(const FlightLogFile &);
+	FlightLogFile &operator=(const FlightLogFile &);
+
+	bool Create()
+	{
+		std::unique_lock<std::mutex> lock(openlock);
+		if (!id && name[0])
+		{
+			id = FlightLog::Get().Open(channel, name);
+			if (!id) name[0] = 0;		// Don't try again
+		}
+		return id != 0;
+	}
+
+	std::atomic<int> id;
+	int channel;
+	std::atomic<unsigned int> dropped;	///< Records lost to a full ring
+	char name[64];
+	std::mutex openlock;
+	const int *timebase;
+	const double *time;
+};
+
+#endif
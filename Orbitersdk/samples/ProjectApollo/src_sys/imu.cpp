@@ -92,6 +92,8 @@ void IMU::Init()
 	LastWeightAcceleration = _V(0, 0, 0);
 	LastGlobalVel = _V(0, 0, 0);
 
+	CDUQueued = 0;
+
 	OurVessel = 0;
 	IMUHeater = 0;
 	PowerSwitch = 0;
@@ -204,9 +206,9 @@ void IMU::ChannelOutput(int address, ChannelValue value)
     
     	if (val12[ZeroIMUCDUs]) {
 			DoZeroIMUCDUs();
-			agc.SetErasable(0, RegCDUX, 0);
-			agc.SetErasable(0, RegCDUY, 0);
-			agc.SetErasable(0, RegCDUZ, 0);
+			agc.SetCDU(RegCDUX, 0);
+			agc.SetCDU(RegCDUY, 0);
+			agc.SetCDU(RegCDUZ, 0);
 		}
 	}
     	 
@@ -330,6 +332,8 @@ void IMU::Timestep(double simt)
 	VESSELSTATUS vs;
 	OurVessel->GetStatus(vs);
 
+	MATRIX3 LastRotation = getOrbiterRotationMatrix(Orbiter.Attitude.X, Orbiter.Attitude.Y, Orbiter.Attitude.Z);
+
 	Orbiter.Attitude.X = vs.arot.x;
 	Orbiter.Attitude.Y = vs.arot.y;
 	Orbiter.Attitude.Z = vs.arot.z;
@@ -357,6 +361,11 @@ void IMU::Timestep(double simt)
 	else {
 		deltaTime = (simt - LastTime);
 
+		// Each frame's values are made in the next yaAGC run, but give it one more in case
+		// the run ends just short of the last one
+		if (CDUQueued > 0)
+			CDUQueued--;
+
 		// Calculate accelerations
 		VECTOR3 w, vel;
 		OurVessel->GetWeightVector(w);
@@ -394,39 +403,51 @@ void IMU::Timestep(double simt)
 
 			TRACE("CHANNEL 12 NORMAL");
 
-			// Gimbals
-			MATRIX3 t = Orbiter.AttitudeReference;
-	  		t = mul(getRotationMatrixX(Orbiter.Attitude.X), t);
-	  		t = mul(getRotationMatrixY(Orbiter.Attitude.Y), t);
-	  		t = mul(getRotationMatrixZ(Orbiter.Attitude.Z), t);
-	  		
-	  		t = mul(getOrbiterLocalToNavigationBaseTransformation(), t);
-	  		
-			// calculate the new gimbal angles
-			VECTOR3 newAngles = getRotationAnglesXZY(t);
-
-			// drive gimbals to new angles		  		  				  		  	 	 	  		  	
-			// CAUTION: gimbal angles are left-handed
-			DriveGimbalX(-newAngles.x - Gimbal.X);
-		  	DriveGimbalY(-newAngles.y - Gimbal.Y);
-		  	DriveGimbalZ(-newAngles.z - Gimbal.Z);
-
 			// PIPAs
 			accel = tmul(Orbiter.AttitudeReference, accel);
 			//sprintf(oapiDebugString(), "accel x %.10f y %.10f z %.10f l %.10f", accel.x, accel.y, accel.z, length(accel));								
 
-			// pulse PIPAs
-			pulses = RemainingPIPA.X + (accel.x * deltaTime / pipaRate);
-			PulsePIPA(RegPIPAX, (int) pulses);
-			RemainingPIPA.X = pulses - (int) pulses;
-
-			pulses = RemainingPIPA.Y + (accel.y * deltaTime / pipaRate);
-			PulsePIPA(RegPIPAY, (int) pulses);
-			RemainingPIPA.Y = pulses - (int) pulses;
+			//
+			// With the Virtual AGC the gimbal motion and PIPA pulses of this frame are spread
+			// over it, and the AGC gets them at the matching cycles of its next run instead of
+			// all at once. Otherwise, or if the AGC thread is busy right now, do them here.
+			//
 
-			pulses = RemainingPIPA.Z + (accel.z * deltaTime / pipaRate);
-			PulsePIPA(RegPIPAZ, (int) pulses);
-			RemainingPIPA.Z = pulses - (int) pulses;			
+			uint64_t cycle;
+			if (deltaTime > 0 && agc.GetNextRunCycle(cycle)) {
+				ScheduleFrame(LastRotation, accel, deltaTime, cycle);
+			}
+			else {
+				// Gimbals
+				MATRIX3 t = Orbiter.AttitudeReference;
+	  			t = mul(getRotationMatrixX(Orbiter.Attitude.X), t);
+	  			t = mul(getRotationMatrixY(Orbiter.Attitude.Y), t);
+	  			t = mul(getRotationMatrixZ(Orbiter.Attitude.Z), t);
+	  		
+	  			t = mul(getOrbiterLocalToNavigationBaseTransformation(), t);
+	  		
+				// calculate the new gimbal angles
+				VECTOR3 newAngles = getRotationAnglesXZY(t);
+
+				// drive gimbals to new angles		  		  				  		  	 	 	  		  	
+				// CAUTION: gimbal angles are left-handed
+				DriveGimbalX(-newAngles.x - Gimbal.X);
+		  		DriveGimbalY(-newAngles.y - Gimbal.Y);
+		  		DriveGimbalZ(-newAngles.z - Gimbal.Z);
+
+				// pulse PIPAs
+				pulses = RemainingPIPA.X + (accel.x * deltaTime / pipaRate);
+				PulsePIPA(RegPIPAX, (int) pulses);
+				RemainingPIPA.X = pulses - (int) pulses;
+
+				pulses = RemainingPIPA.Y + (accel.y * deltaTime / pipaRate);
+				PulsePIPA(RegPIPAY, (int) pulses);
+				RemainingPIPA.Y = pulses - (int) pulses;
+
+				pulses = RemainingPIPA.Z + (accel.z * deltaTime / pipaRate);
+				PulsePIPA(RegPIPAZ, (int) pulses);
+				RemainingPIPA.Z = pulses - (int) pulses;			
+			}
 		}
 		LastTime = simt;
 	}	
@@ -450,6 +471,93 @@ void IMU::PulsePIPA(int RegPIPA, int pulses)
 	agc.PulsePIPA(RegPIPA, pulses);
 }
 
+//
+// Queue this frame's gimbal motion and PIPA pulses for the next run of the yaAGC, which
+// starts at cycle. That run covers the time from now to the next frame, so the gimbals
+// are extrapolated into it at the rotation rate from LastRotation, the attitude of the
+// last frame, to the current one: at constant rate the AGC sees the attitude the
+// spacecraft has at each cycle. Delivering the interpolated motion of this frame instead
+// would be a whole frame late, where handing over the current attitude at the start of
+// the run was half a frame late on average. The PIPA pulses of this frame are spread
+// over the run with the acceleration held constant; the AGC only reads the PIPAs every
+// couple of seconds, so it's their count that matters, not when they arrive.
+//
+
+void IMU::ScheduleFrame(MATRIX3 LastRotation, VECTOR3 accel, double deltaTime, uint64_t cycle)
+
+{
+	static const int RegCDU[3] = { RegCDUX, RegCDUY, RegCDUZ };
+	static const int RegPIPA[3] = { RegPIPAX, RegPIPAY, RegPIPAZ };
+
+	double *Remaining[3] = { &RemainingPIPA.X, &RemainingPIPA.Y, &RemainingPIPA.Z };
+	double accelPulses[3] = { accel.x / pipaRate, accel.y / pipaRate, accel.z / pipaRate };
+	MATRIX3 Rotation = getOrbiterRotationMatrix(Orbiter.Attitude.X, Orbiter.Attitude.Y, Orbiter.Attitude.Z);
+	MATRIX3 nav = getOrbiterLocalToNavigationBaseTransformation();
+	double stepTime, pulses, angles[3];
+	int steps, i, k, n;
+
+	// The IMU itself is where the spacecraft is now
+	GimbalAngles(Rotation, nav, Gimbals);
+
+	steps = (int) ceil(deltaTime / IMU_SUBSTEP);
+	if (steps < 1)
+		steps = 1;
+	if (steps > IMU_MAX_SUBSTEPS)
+		steps = IMU_MAX_SUBSTEPS;
+	stepTime = deltaTime / steps;
+
+	for (k = 1; k <= steps; k++) {
+		uint64_t at = cycle + (uint64_t) (k * stepTime * AGC_PER_SECOND);
+
+		// Gimbals
+		GimbalAngles(slerpRotationMatrix(LastRotation, Rotation, 1.0 + (double) k / steps), nav, angles);
+
+		for (i = 0; i < 3; i++) {
+			// Gyro pulses to CDU pulses. The values are absolute, so if the queue is full
+			// the next sub-step catches up, and after the last one the CDU is set to where
+			// the gimbal is now.
+			n = (int)(((double)radToGyroPulses(angles[i])) / 64.0);
+			if (agc.QueueCDU(RegCDU[i], n, at))
+				CDUQueued = 2;
+			else if (k == steps)
+				agc.SetCDU(RegCDU[i], (int)(((double)radToGyroPulses(Gimbals[i])) / 64.0));
+		}
+
+		// PIPAs
+		for (i = 0; i < 3; i++) {
+			pulses = *Remaining[i] + accelPulses[i] * stepTime;
+			n = (int) pulses;
+			*Remaining[i] = pulses - n;
+
+			if (!agc.QueueIncrement(RegPIPA[i], (n >= 0) ? INC_PINC : INC_MINC, (n >= 0) ? n : -n, at))
+				PulsePIPA(RegPIPA[i], n);
+		}
+	}
+}
+
+//
+// Gimbal angles, 0 to 2 pi, for an Orbiter attitude.
+//
+
+void IMU::GimbalAngles(MATRIX3 Rotation, MATRIX3 nav, double *angles)
+
+{
+	MATRIX3 t = mul(nav, mul(Rotation, Orbiter.AttitudeReference));
+	VECTOR3 newAngles = getRotationAnglesXZY(t);
+
+	// CAUTION: gimbal angles are left-handed
+	angles[0] = -newAngles.x;
+	angles[1] = -newAngles.y;
+	angles[2] = -newAngles.z;
+
+	for (int i = 0; i < 3; i++) {
+		if (angles[i] >= TWO_PI)
+			angles[i] -= TWO_PI;
+		if (angles[i] < 0)
+			angles[i] += TWO_PI;
+	}
+}
+
 void IMU::DriveGimbals(double x, double y, double z) 
 
 {
@@ -501,7 +609,11 @@ void IMU::DriveGimbal(int index, int RegCDU, double angle)
 	
 	// Gyro pulses to CDU pulses
 	pulses = (int)(((double)radToGyroPulses(Gimbals[index])) / 64.0);	
-	agc.SetErasable(0, RegCDU, (pulses & 077777));
+
+	// CDU values ScheduleFrame() has queued are for earlier than this, so if it was set
+	// now have it set again after any the AGC hasn't had yet.
+	if (agc.SetCDU(RegCDU, pulses) && CDUQueued > 0)
+		agc.QueueCDU(RegCDU, pulses, 0);
 
 	char buffers[80];
 	sprintf(buffers,"DRIVE GIMBAL index %o REGCDU %o angle %f pulses %o",index,RegCDU,angle,pulses);
@@ -766,3 +878,20 @@ void IMU::SaveState(FILEHANDLE scn)
 
 	oapiWriteLine(scn, IMU_END_STRING);
 }
+
+void IMU::SaveCheckpoint(Checkpoint &cp)
+
+{
+	CHECKPOINT_RANGE(IMU, Operate, LastGlobalVel);
+	cp.PutRange(Operate, LastGlobalVel);
+	cp.Put(LastTime);
+	cp.Put(CDUQueued);
+}
+
+void IMU::LoadCheckpoint(Checkpoint &cp)
+
+{
+	cp.GetRange(Operate, LastGlobalVel);
+	cp.Get(LastTime);
+	cp.Get(CDUQueued);
+}
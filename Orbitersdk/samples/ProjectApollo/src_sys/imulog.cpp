@@ -40,116 +40,89 @@
 #include "ioChannels.h"
 #include "IMU.h"
 
-static FILE *logFile = NULL;
-static long lastTime = -1;
-
 char *intToBinaryString(char *buffer, int i);
 
+//
+// Wall clock time of the log lines.
+//
+
+#define LOG_TIME(hour, min, sec, ms) \
+	struct _timeb tstruct; \
+	_ftime(&tstruct); \
+	struct tm *now = localtime(&tstruct.time); \
+	int hour = now->tm_hour, min = now->tm_min, sec = now->tm_sec, ms = tstruct.millitm;
 
 void IMU::LogInit() 
 
 {
-#ifdef _DEBUG
-	if (!logFile)
 #ifdef SAT5_LMPKD_EXPORTS
-		logFile = fopen("ProjectApollo LM IMU.log", "w");
+	log.Open(FLIGHTLOG_IMU, "ProjectApollo LM IMU.log");
 #else
-		logFile = fopen("ProjectApollo IMU.log", "w");
-#endif
+	log.Open(FLIGHTLOG_IMU, "ProjectApollo IMU.log");
 #endif
 }
 
 void IMU::LogState(int channel, char *device, int value) 
 
 {
-#ifdef _DEBUG
-	struct _timeb tstruct;
-	char *timeline;
-	char buffer[100];	
+	if (!(FlightLogChannels() & FLIGHTLOG_IMU))
+		return;
+
 	char buffer1[100];
-	
-	_ftime(&tstruct);
-	timeline = ctime(&(tstruct.time));
-	strcpy(buffer, timeline + 11);
-	
+	LOG_TIME(hour, min, sec, ms);
 	intToBinaryString(buffer1, value);
 
-		fprintf(logFile, "%.8s.%03hu Ch %03o %s %s PIPA %o %o %o CDUCMD %o %o %o GYRO %o IMU %.2f %.2f %.2f\n", buffer, tstruct.millitm, channel, device, buffer1,
-		    agc.GetErasable(0, RegPIPAX), 
-		    agc.GetErasable(0, RegPIPAY), 
-			agc.GetErasable(0, RegPIPAZ), 
-			agc.GetErasable(0, RegCDUXCMD),
-			agc.GetErasable(0, RegCDUYCMD),
-			agc.GetErasable(0, RegCDUZCMD),
-			//state->Erasable[0][RegCDUX],
-			//state->Erasable[0][RegCDUY],
-			//state->Erasable[0][RegCDUZ],			
-			agc.GetErasable(0, RegGYROCTR),
-			radToDeg(Gimbal.X),
-			radToDeg(Gimbal.Y),
-			radToDeg(Gimbal.Z));
-			
-	fflush(logFile);
-#endif
+	log.Printf("%02d:%02d:%02d.%03d Ch %03o %s %s PIPA %o %o %o CDUCMD %o %o %o GYRO %o IMU %.2f %.2f %.2f\n", hour, min, sec, ms, channel, device, buffer1,
+		agc.GetErasable(0, RegPIPAX), 
+		agc.GetErasable(0, RegPIPAY), 
+		agc.GetErasable(0, RegPIPAZ), 
+		agc.GetErasable(0, RegCDUXCMD),
+		agc.GetErasable(0, RegCDUYCMD),
+		agc.GetErasable(0, RegCDUZCMD),
+		agc.GetErasable(0, RegGYROCTR),
+		radToDeg(Gimbal.X),
+		radToDeg(Gimbal.Y),
+		radToDeg(Gimbal.Z));
 }
 
 void IMU::LogTimeStep(long simt) 
 
 {
-#ifdef _DEBUG
-	struct _timeb tstruct;
-	char *timeline;
-	char buffer[100];	
-	
-	_ftime(&tstruct);
-	timeline = ctime(&(tstruct.time));
-	strcpy(buffer, timeline + 11);
-		
-	fprintf(logFile, "%.8s.%03hu TimeStep                   Orbiter %.2f %.2f %.2f   IMU %.2f %.2f %.2f\n", buffer, tstruct.millitm, 
-			radToDeg(Orbiter.Attitude.X),
-			radToDeg(Orbiter.Attitude.Y),
-			radToDeg(Orbiter.Attitude.Z),
-			radToDeg(Gimbal.X),
-			radToDeg(Gimbal.Y),
-			radToDeg(Gimbal.Z));
-
-	fflush(logFile);
-#endif
+	if (!(FlightLogChannels() & FLIGHTLOG_IMU))
+		return;
+
+	LOG_TIME(hour, min, sec, ms);
+
+	log.Printf("%02d:%02d:%02d.%03d TimeStep                   Orbiter %.2f %.2f %.2f   IMU %.2f %.2f %.2f\n", hour, min, sec, ms, 
+		radToDeg(Orbiter.Attitude.X),
+		radToDeg(Orbiter.Attitude.Y),
+		radToDeg(Orbiter.Attitude.Z),
+		radToDeg(Gimbal.X),
+		radToDeg(Gimbal.Y),
+		radToDeg(Gimbal.Z));
 }
 
-
 void IMU::LogVector(char* message, VECTOR3 v) 
 
 {
-#ifdef _DEBUG
-	struct _timeb tstruct;
-	char *timeline;
-	char buffer[100];
-	
-	_ftime(&tstruct);
-	timeline = ctime(&(tstruct.time));
-	strcpy(buffer, timeline + 11);
-		
-	fprintf(logFile, "%.8s.%03hu %s Vector %f %f %f\n", buffer, tstruct.millitm, 
-			message, v.x, v.y, v.z);
-#endif
+	if (!(FlightLogChannels() & FLIGHTLOG_IMU))
+		return;
+
+	LOG_TIME(hour, min, sec, ms);
+
+	log.Printf("%02d:%02d:%02d.%03d %s Vector %f %f %f\n", hour, min, sec, ms, 
+		message, v.x, v.y, v.z);
 }
 
 void IMU::LogMessage(char* s) 
 
 {
-#ifdef _DEBUG
-	struct _timeb tstruct;
-	char *timeline;
-	char buffer[100];	
-	
-	_ftime(&tstruct);
-	timeline = ctime(&(tstruct.time));
-	strcpy(buffer, timeline + 11);
-		
-	fprintf(logFile, "%.8s.%03hu Message %s\n", buffer, tstruct.millitm, 
-			s);	
-#endif
+	if (!(FlightLogChannels() & FLIGHTLOG_IMU))
+		return;
+
+	LOG_TIME(hour, min, sec, ms);
+
+	log.Printf("%02d:%02d:%02d.%03d Message %s\n", hour, min, sec, ms, s);
 }
 
 char *intToBinaryString(char *buffer, int i) {
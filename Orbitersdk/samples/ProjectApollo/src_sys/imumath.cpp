@@ -153,6 +153,107 @@ VECTOR3 IMU::getRotationAnglesZYX(MATRIX3 m) {
 	return v;
 }
 
+MATRIX3 IMU::getOrbiterRotationMatrix(double x, double y, double z) {
+	// Returns the rotation for Orbiter's arot angles, as Timestep applies them to the attitude reference
+
+	MATRIX3 m = getRotationMatrixX(x);
+	m = mul(getRotationMatrixY(y), m);
+	m = mul(getRotationMatrixZ(z), m);
+	return m;
+}
+
+//
+// Rotation matrix <-> unit quaternion (w, x, y, z), for slerpRotationMatrix.
+//
+
+static void MatrixToQuaternion(const MATRIX3 &m, double q[4]) {
+
+	double tr = m.m11 + m.m22 + m.m33, s;
+
+	if (tr > 0) {
+		s = sqrt(tr + 1.0) * 2.0;
+		q[0] = 0.25 * s;
+		q[1] = (m.m32 - m.m23) / s;
+		q[2] = (m.m13 - m.m31) / s;
+		q[3] = (m.m21 - m.m12) / s;
+	} else if (m.m11 > m.m22 && m.m11 > m.m33) {
+		s = sqrt(1.0 + m.m11 - m.m22 - m.m33) * 2.0;
+		q[0] = (m.m32 - m.m23) / s;
+		q[1] = 0.25 * s;
+		q[2] = (m.m12 + m.m21) / s;
+		q[3] = (m.m13 + m.m31) / s;
+	} else if (m.m22 > m.m33) {
+		s = sqrt(1.0 + m.m22 - m.m11 - m.m33) * 2.0;
+		q[0] = (m.m13 - m.m31) / s;
+		q[1] = (m.m12 + m.m21) / s;
+		q[2] = 0.25 * s;
+		q[3] = (m.m23 + m.m32) / s;
+	} else {
+		s = sqrt(1.0 + m.m33 - m.m11 - m.m22) * 2.0;
+		q[0] = (m.m21 - m.m12) / s;
+		q[1] = (m.m13 + m.m31) / s;
+		q[2] = (m.m23 + m.m32) / s;
+		q[3] = 0.25 * s;
+	}
+}
+
+static MATRIX3 QuaternionToMatrix(const double q[4]) {
+
+	MATRIX3 m;
+	double w = q[0], x = q[1], y = q[2], z = q[3];
+
+	m.m11 = 1 - 2 * (y * y + z * z);
+	m.m12 = 2 * (x * y - w * z);
+	m.m13 = 2 * (x * z + w * y);
+	m.m21 = 2 * (x * y + w * z);
+	m.m22 = 1 - 2 * (x * x + z * z);
+	m.m23 = 2 * (y * z - w * x);
+	m.m31 = 2 * (x * z - w * y);
+	m.m32 = 2 * (y * z + w * x);
+	m.m33 = 1 - 2 * (x * x + y * y);
+	return m;
+}
+
+MATRIX3 IMU::slerpRotationMatrix(MATRIX3 a, MATRIX3 b, double s) {
+	// Returns the rotation a fraction s of the way from a to b, turning about a fixed axis.
+	// With s above 1 it carries on past b at the same rate.
+
+	double qa[4], qb[4], q[4], d, wa, wb;
+	int i;
+
+	MatrixToQuaternion(a, qa);
+	MatrixToQuaternion(b, qb);
+
+	// Take the short way round
+	d = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3];
+	if (d < 0) {
+		for (i = 0; i < 4; i++)
+			qb[i] = -qb[i];
+		d = -d;
+	}
+
+	if (d > 0.9995) {
+		// Nearly the same rotation, so interpolate linearly
+		wa = 1 - s;
+		wb = s;
+	} else {
+		double theta = acos(d);
+		wa = sin((1 - s) * theta) / sin(theta);
+		wb = sin(s * theta) / sin(theta);
+	}
+
+	d = 0;
+	for (i = 0; i < 4; i++) {
+		q[i] = wa * qa[i] + wb * qb[i];
+		d += q[i] * q[i];
+	}
+	d = sqrt(d);
+	for (i = 0; i < 4; i++)
+		q[i] /= d;
+
+	return QuaternionToMatrix(q);
+}
+
 MATRIX3 IMU::getNavigationBaseToOrbiterLocalTransformation() {
 	
 	MATRIX3 m;
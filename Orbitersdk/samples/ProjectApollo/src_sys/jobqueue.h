@@ -0,0 +1,293 @@
+/***************************************************************************
+  This file is part of Project Apollo - NASSP
+
+  Calculation job queue for the RTCC and MCC
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  See http://nassp.sourceforge.net/license/ for more details.
+
+  **************************************************************************/
+
+#if !defined(_PA_JOBQUEUE_H)
+#define _PA_JOBQUEUE_H
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <deque>
+#include <vector>
+
+///
+/// \ingroup Threads
+/// Job lanes. Each lane has its own worker, so a short PAD calculation
+/// doesn't have to wait for a long targeting search to finish.
+///
+#define JOB_LANE_SHORT	0	///< PADs and other single pass calculations
+#define JOB_LANE_LONG	1	///< Iterative targeting: Lambert, LOI, TEI, entry
+
+///
+/// \ingroup Threads
+/// \brief A calculation run by a JobQueue worker.
+///
+class Job
+{
+public:
+	Job() : cancel(false), progress(0) { id = fcn = type = lane = result = 0; }
+
+	///
+	/// \brief Has the job been cancelled? Long calculations should check this and give up.
+	///
+	bool Cancelled() const { return cancel; }
+
+	int id;							///< Job number, from JobQueue::Submit
+	int fcn;						///< Calculation to run
+	int type;						///< Calculation type, for the caller's use
+	int lane;						///< JOB_LANE_*
+	int result;						///< Return value of run, 0 for success, negative for an error
+
+	std::atomic<bool> cancel;		///< Set to cancel the job
+	std::atomic<int> progress;		///< Progress, as reported by the calculation
+
+	std::function<int(Job &)> run;	///< The calculation, runs on a worker thread
+	std::function<void(Job &)> done;///< Completion callback, runs on the thread calling JobQueue::Poll
+};
+
+///
+/// \brief The job running on this thread, or NULL.
+///
+/// This lets iterations deep inside the calculations check for cancellation
+/// without the job being passed all the way down to them.
+///
+inline Job *&CurrentJob()
+{
+	static thread_local Job *job = NULL;
+	return job;
+}
+
+///
+/// \brief Has the job running on this thread been cancelled? Always false outside a job.
+///
+inline bool JobCancelled()
+{
+	Job *job = CurrentJob();
+	return job != NULL && job->Cancelled();
+}
+
+///
+/// \brief Report progress of the job running on this thread.
+///
+inline void JobProgress(int progress)
+{
+	Job *job = CurrentJob();
+	if (job) job->progress = progress;
+}
+
+///
+/// \ingroup Threads
+/// \brief Queue of calculation jobs, run on worker threads.
+///
+/// Jobs in a lane run one at a time in the order they were submitted, lanes
+/// run in parallel. Workers are only started while a lane has work, so no
+/// threads are left running in the module between calculations. A worker
+/// that ran out of work is joined when its lane gets the next job, or by
+/// the destructor. Completion callbacks are run by Poll(), so they can
+/// safely update the simulation.
+///
+class JobQueue
+{
+public:
+	JobQueue(int nlanes = 2) : lanes(nlanes), running(nlanes, (Job *)NULL), workers(nlanes, false), threads(nlanes)
+	{
+		nextid = 1;
+	}
+
+	~JobQueue()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			// Drop everything queued, and stop what's running at its next check
+			for (size_t i = 0; i < lanes.size(); i++)
+			{
+				while (!lanes[i].empty())
+				{
+					delete lanes[i].front();
+					lanes[i].pop_front();
+				}
+				if (running[i])
+				{
+					running[i]->cancel = true;
+				}
+			}
+		}
+		for (size_t i = 0; i < threads.size(); i++)
+		{
+			if (threads[i].joinable()) threads[i].join();
+		}
+
+		for (size_t i = 0; i < finished.size(); i++)
+		{
+			delete finished[i];
+		}
+	}
+
+	///
+	/// \brief Queue a job.
+	/// \param lane JOB_LANE_* to run it in.
+	/// \param fcn Calculation number. A queued or running job for the same calculation is cancelled.
+	/// \param type Calculation type, for the caller's use.
+	/// \param run The calculation.
+	/// \param done Completion callback, or NULL.
+	/// \return Job number.
+	///
+	int Submit(int lane, int fcn, int type, std::function<int(Job &)> run, std::function<void(Job &)> done)
+	{
+		Job *job = new Job;
+		job->fcn = fcn;
+		job->type = type;
+		job->lane = lane;
+		job->run = run;
+		job->done = done;
+
+		std::unique_lock<std::mutex> lock(mutex);
+		CancelLocked(fcn);
+
+		job->id = nextid++;
+		lanes[lane].push_back(job);
+		if (!workers[lane])
+		{
+			// The previous worker has left its loop, so this doesn't wait for long
+			if (threads[lane].joinable()) threads[lane].join();
+			workers[lane] = true;
+			threads[lane] = std::thread(&JobQueue::Worker, this, lane);
+		}
+		return job->id;
+	}
+
+	///
+	/// \brief Cancel all queued and running jobs for a calculation.
+	///
+	void Cancel(int fcn)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		CancelLocked(fcn);
+	}
+
+	///
+	/// \brief Number of jobs queued or running.
+	///
+	int Pending()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		int n = 0;
+		for (size_t i = 0; i < lanes.size(); i++)
+		{
+			n += (int)lanes[i].size();
+			if (running[i]) n++;
+		}
+		return n;
+	}
+
+	///
+	/// \brief Progress of the running job for a calculation, or -1 if it isn't running.
+	///
+	int Progress(int fcn)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for (size_t i = 0; i < running.size(); i++)
+		{
+			if (running[i] && running[i]->fcn == fcn && !running[i]->Cancelled())
+			{
+				return running[i]->progress;
+			}
+		}
+		return -1;
+	}
+
+	///
+	/// \brief Run the completion callbacks of finished jobs on this thread.
+	///
+	void Poll()
+	{
+		std::vector<Job *> jobs;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobs.swap(finished);
+		}
+		for (size_t i = 0; i < jobs.size(); i++)
+		{
+			if (jobs[i]->done) jobs[i]->done(*jobs[i]);
+			delete jobs[i];
+		}
+	}
+
+protected:
+	void CancelLocked(int fcn)
+	{
+		for (size_t i = 0; i < lanes.size(); i++)
+		{
+			for (std::deque<Job *>::iterator it = lanes[i].begin(); it != lanes[i].end();)
+			{
+				if ((*it)->fcn == fcn)
+				{
+					(*it)->cancel = true;
+					finished.push_back(*it);
+					it = lanes[i].erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+			if (running[i] && running[i]->fcn == fcn)
+			{
+				running[i]->cancel = true;
+			}
+		}
+	}
+
+	void Worker(int lane)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (!lanes[lane].empty())
+		{
+			Job *job = lanes[lane].front();
+			lanes[lane].pop_front();
+			running[lane] = job;
+			lock.unlock();
+
+			CurrentJob() = job;
+			job->result = job->run(*job);
+			CurrentJob() = NULL;
+
+			lock.lock();
+			running[lane] = NULL;
+			finished.push_back(job);
+		}
+		workers[lane] = false;
+	}
+
+	std::mutex mutex;
+	std::vector<std::deque<Job *> > lanes;	///< Queued jobs, per lane
+	std::vector<Job *> running;				///< Running job, per lane
+	std::vector<bool> workers;				///< Lane has a worker thread in its loop
+	std::vector<std::thread> threads;		///< Worker thread, per lane
+	std::vector<Job *> finished;			///< Jobs waiting for Poll()
+	int nextid;
+};
+
+#endif
@@ -156,13 +156,37 @@ double PowerMerge::Current()
 
 void PowerMerge::DrawPower(double watts)
 
+{
+	power_load += watts;
+
+	//
+	// In the load-flow pass the E_system shares it out once per timestep.
+	//
+	if (load_flow)
+		pending_load += watts;
+	else
+		ShareLoad(watts);
+}
+
+bool PowerMerge::PassOnLoad()
+
+{
+	if (pending_load == 0.0)
+		return false;
+
+	double watts = pending_load;
+	pending_load = 0.0;
+	ShareLoad(watts);
+	return true;
+}
+
+void PowerMerge::ShareLoad(double watts)
+
 {
 	double Volts = 0.0;
 	double VoltsA = 0.0;
 	double VoltsB = 0.0;
 
-	power_load += watts;
-
 	if (BusA)
 		VoltsA = BusA->Voltage();
 	if (BusB)
@@ -236,14 +260,35 @@ ThreeWayPowerMerge::ThreeWayPowerMerge(char *i_name, PanelSDK &p) : sdk(p)
 
 void ThreeWayPowerMerge::DrawPower(double watts)
 
+{
+	power_load += watts;
+
+	if (load_flow)
+		pending_load += watts;
+	else
+		ShareLoad(watts);
+}
+
+bool ThreeWayPowerMerge::PassOnLoad()
+
+{
+	if (pending_load == 0.0)
+		return false;
+
+	double watts = pending_load;
+	pending_load = 0.0;
+	ShareLoad(watts);
+	return true;
+}
+
+void ThreeWayPowerMerge::ShareLoad(double watts)
+
 {
 	double Volts = 0.0;
 	double VoltsA = 0.0;
 	double VoltsB = 0.0;
 	double VoltsC = 0.0;
 
-	power_load += watts;
-
 	if (Phase1)
 		VoltsA = Phase1->Voltage();
 	if (Phase2)
@@ -288,12 +333,14 @@ NWayPowerMerge::NWayPowerMerge(char *i_name, PanelSDK &p, int n) : sdk(p)
 
 	nSources = n;
 	sources = new e_object *[nSources];
+	sourceVolts = new double[nSources];
 
 	int i;
 
 	for (i = 0; i < nSources; i++)
 	{
 		sources[i] = 0;
+		sourceVolts[i] = 0.0;
 	}
 
 	//
@@ -311,6 +358,11 @@ NWayPowerMerge::~NWayPowerMerge()
 		delete[] sources;
 		sources = 0;
 	}
+	if (sourceVolts)
+	{
+		delete[] sourceVolts;
+		sourceVolts = 0;
+	}
 }
 
 double NWayPowerMerge::Voltage()
@@ -354,39 +406,56 @@ double NWayPowerMerge::Current()
 
 void NWayPowerMerge::DrawPower(double watts)
 
+{
+	power_load += watts;
+
+	if (load_flow)
+		pending_load += watts;
+	else
+		ShareLoad(watts);
+}
+
+bool NWayPowerMerge::PassOnLoad()
+
+{
+	if (pending_load == 0.0)
+		return false;
+
+	double watts = pending_load;
+	pending_load = 0.0;
+	ShareLoad(watts);
+	return true;
+}
+
+void NWayPowerMerge::ShareLoad(double watts)
+
 {
 	double Volts = 0.0;
 	int i;
 
 	//
-	// Sum the voltage from all sources.
+	// Sum the voltage from all sources, asking each of them only once.
 	//
 	for (i = 0; i < nSources; i++)
 	{
+		sourceVolts[i] = 0.0;
 		if (sources[i])
 		{
-			double VS = fabs(sources[i]->Voltage());
-			if (VS != 0)
-			{
-				Volts += VS;
-			}
+			sourceVolts[i] = fabs(sources[i]->Voltage());
+			Volts += sourceVolts[i];
 		}
 	}
 
-	power_load += watts;
-
 	//
 	// Divide the power drain up across the sources by voltage.
 	//
 	if (Volts > 0.0)
 	{
-		int i;
-
 		for (i = 0; i < nSources; i++)
 		{
 			if (sources[i])
 			{
-				sources[i]->DrawPower(watts * fabs(sources[i]->Voltage()) / Volts);
+				sources[i]->DrawPower(watts * sourceVolts[i] / Volts);
 			}
 		}
 	}
@@ -47,8 +47,12 @@ public:
 	void DrawPower(double watts);
 	void WireToBuses(e_object *a, e_object *b) { BusA = a; BusB = b; };
 	double Current();
+	bool DefersLoad() { return true; };
+	bool PassOnLoad();
 
 protected:
+	void ShareLoad(double watts);
+
 	PanelSDK &sdk;
 
 	e_object *BusA;
@@ -64,8 +68,12 @@ public:
 	void WireToBus(int bus, e_object* e);
 	bool IsBusConnected(int bus);
 	double Current();
+	bool DefersLoad() { return true; };
+	bool PassOnLoad();
 
 protected:
+	void ShareLoad(double watts);
+
 	PanelSDK &sdk;
 
 	e_object *Phase1;
@@ -83,12 +91,17 @@ public:
 	void WireToBus(int bus, e_object* e);
 	bool IsBusConnected(int bus);
 	double Current();
+	bool DefersLoad() { return true; };
+	bool PassOnLoad();
 
 protected:
+	void ShareLoad(double watts);
+
 	PanelSDK &sdk;
 
 	int nSources;
 	e_object **sources;
+	double *sourceVolts;
 };
 
 class PowerBreaker : public PowerSource {
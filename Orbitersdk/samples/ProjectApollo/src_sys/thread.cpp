@@ -36,7 +36,7 @@ Runnable::Runnable ():
 {
 }
 
-DWORD WINAPI Runnable::ThreadEntry (void* arg)
+unsigned long Runnable::ThreadEntry (void* arg)
 {
     Runnable * pRunnable = (Runnable *) arg;
     pRunnable->Run();
@@ -23,34 +23,47 @@
   **************************************************************************/
 #if !defined(_THREAD_H)
 #define _THREAD_H
-#include <windows.h>
-
-
+#if defined(_WIN32)
+#include <windows.h>	// Much of the code still gets windows.h from here
+#endif
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+//
+// Portable versions of the threading primitives. These used to wrap
+// CreateThread, CRITICAL_SECTION and CreateEvent directly; the API is
+// unchanged, but they now build anywhere with a C++11 library.
+//
+
+typedef unsigned long (* ThreadProc) (void* arg);
 
 class Thread
 {
 public:
-    Thread ( DWORD (WINAPI * callback) (void* arg), void* arg)
-    {
-        handle = CreateThread (0,0,callback,arg,CREATE_SUSPENDED,&threadId);
-    }
-    ~Thread ()           { CloseHandle (handle); }
-    void Resume ()       { ResumeThread (handle); }
-    void WaitForDeath () { WaitForSingleObject (handle, INFINITE); }
+    Thread ( ThreadProc callback, void* arg): callback(callback), arg(arg) {}
+
+    // Like a thread created suspended, if nobody waits for it the thread is
+    // just left running when the object goes away.
+    ~Thread ()           { if (handle.joinable ()) handle.detach (); }
+    void Resume ()       { if (!handle.joinable ()) handle = std::thread (callback, arg); }
+    void WaitForDeath () { if (handle.joinable ()) handle.join (); }
 private:
-    HANDLE handle;
-    DWORD  threadId;
+    ThreadProc  callback;
+    void*       arg;
+    std::thread handle;
 };
 
 class Mutex
 {
 public:
-    Mutex () { InitializeCriticalSection (& critSection); }
-    ~Mutex () { DeleteCriticalSection (& critSection); }
-    inline void Acquire () { EnterCriticalSection (& critSection); }
-    inline void Release () { LeaveCriticalSection (& critSection); }
+    inline void Acquire () { mutex.lock (); }
+    inline bool TryAcquire () { return mutex.try_lock (); }
+    inline void Release () { mutex.unlock (); }
 private:
-    CRITICAL_SECTION critSection;
+    std::recursive_mutex mutex;	// A critical section can be entered again by its owner
 };
 
 class Lock
@@ -62,16 +75,107 @@ private:
     Mutex & _mutex;
 };
 
+///
+/// \brief Wakeup latency of an Event, from Raise() to the waiter running.
+///
+struct EventStats
+{
+    unsigned long wakeups;	///< Number of Wait() calls that returned
+    unsigned long spun;		///< Of those, woken while still spinning
+    double total;			///< Total latency in seconds
+    double max;				///< Worst latency in seconds
+};
+
+///
+/// \brief Auto-reset event.
+///
+/// Wait() can spin for a short time before it parks the thread. When the
+/// waiter is usually woken again soon after it starts waiting, like the AGC
+/// thread at high time acceleration, this saves the trip through the
+/// scheduler on every frame.
+///
 class Event
 {
 public:
-    Event ()  { handle = CreateEvent (0, FALSE, FALSE, 0); }
-    ~Event () { CloseHandle (handle); }
+    Event ( double spin = 0.0 ): signaled(false), parked(0), spinTime(spin), raised(0) { ResetStats (); }
+
+    void Raise ()
+    {
+        raised = Now ();
+        signaled = true;
+        if (parked > 0) {
+            std::lock_guard<std::mutex> lock (mutex);
+            wake.notify_one ();
+        }
+    }
+
+    void Wait ()
+    {
+        bool spun = false;
+
+        if (spinTime > 0.0) {
+            long long start = Now ();
+            long long limit = (long long) (spinTime * 1e9);
+            while (Now () - start < limit) {
+                if (signaled && signaled.exchange (false)) {
+                    spun = true;
+                    break;
+                }
+                std::this_thread::yield ();
+            }
+        }
+
+        if (!spun) {
+            std::unique_lock<std::mutex> lock (mutex);
+            parked++;
+            while (!signaled.exchange (false))
+                wake.wait (lock);
+            parked--;
+        }
+
+        Record (spun);
+    }
+
+    void SetSpin ( double spin ) { spinTime = spin; }
+
+    void GetStats ( EventStats & s )
+    {
+        std::lock_guard<std::mutex> lock (statsMutex);
+        s = stats;
+    }
+
+    void ResetStats ()
+    {
+        std::lock_guard<std::mutex> lock (statsMutex);
+        stats.wakeups = stats.spun = 0;
+        stats.total = stats.max = 0.0;
+    }
 
-    void Raise ()  { SetEvent (handle); }
-    void Wait ()   { WaitForSingleObject (handle, INFINITE); }
 private:
-    HANDLE handle;
+    static long long Now ()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+    }
+
+    void Record ( bool spun )
+    {
+        double latency = (double) (Now () - raised) * 1e-9;
+
+        std::lock_guard<std::mutex> lock (statsMutex);
+        stats.wakeups++;
+        if (spun) stats.spun++;
+        stats.total += latency;
+        if (latency > stats.max) stats.max = latency;
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::atomic<bool> signaled;
+    std::atomic<int> parked;
+    double spinTime;				// Seconds to spin before parking
+    std::atomic<long long> raised;	// Time of the last Raise(), ns
+    std::mutex statsMutex;
+    EventStats stats;
 };
 
 
@@ -83,7 +187,7 @@ public:
     void Kill ();
 protected:
     virtual void Run () = 0;
-    static DWORD WINAPI ThreadEntry (void *pArg);
+    static unsigned long ThreadEntry (void *pArg);
     Thread     thread;
 };
 
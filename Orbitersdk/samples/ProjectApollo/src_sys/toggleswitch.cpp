@@ -115,6 +115,24 @@ void PanelSwitchItem::SetState(int value)
 	state = value;
 }
 
+void PanelSwitchItem::SaveCheckpoint(Checkpoint &cp)
+
+{
+	e_object::SaveCheckpoint(cp);
+	cp.Put(state);
+	cp.Put(Failed);
+	cp.Put(FailedState);
+}
+
+void PanelSwitchItem::LoadCheckpoint(Checkpoint &cp)
+
+{
+	e_object::LoadCheckpoint(cp);
+	cp.Get(state);
+	cp.Get(Failed);
+	cp.Get(FailedState);
+}
+
 
 //
 // Generic toggle switch.
@@ -370,6 +388,21 @@ void ToggleSwitch::LoadState(char *line)
 	}
 }
 
+void ToggleSwitch::SaveCheckpoint(Checkpoint &cp)
+{
+	PanelSwitchItem::SaveCheckpoint(cp);
+	cp.Put(GetFlags());
+}
+
+void ToggleSwitch::LoadCheckpoint(Checkpoint &cp)
+{
+	unsigned int f = 0;
+
+	PanelSwitchItem::LoadCheckpoint(cp);
+	if (cp.Get(f))
+		SetFlags(f);
+}
+
 void ToggleSwitch::SetState(int value)
 {
 	if (!delayTime) {
@@ -1358,6 +1391,18 @@ void GuardedToggleSwitch::LoadState(char *line) {
 	}
 }
 
+void GuardedToggleSwitch::SaveCheckpoint(Checkpoint &cp) {
+
+	ToggleSwitch::SaveCheckpoint(cp);
+	cp.Put(guardState);
+}
+
+void GuardedToggleSwitch::LoadCheckpoint(Checkpoint &cp) {
+
+	ToggleSwitch::LoadCheckpoint(cp);
+	cp.Get(guardState);
+}
+
 
 //
 // Guarded push switch.
@@ -1512,6 +1557,20 @@ void GuardedPushSwitch::LoadState(char *line) {
 	}
 }
 
+void GuardedPushSwitch::SaveCheckpoint(Checkpoint &cp) {
+
+	PushSwitch::SaveCheckpoint(cp);
+	cp.Put(guardState);
+	cp.Put(lit);
+}
+
+void GuardedPushSwitch::LoadCheckpoint(Checkpoint &cp) {
+
+	PushSwitch::LoadCheckpoint(cp);
+	cp.Get(guardState);
+	cp.Get(lit);
+}
+
 
 //
 // Guarded three pos switch.
@@ -1647,6 +1706,18 @@ void GuardedThreePosSwitch::LoadState(char *line) {
 	}
 }
 
+void GuardedThreePosSwitch::SaveCheckpoint(Checkpoint &cp) {
+
+	ThreePosSwitch::SaveCheckpoint(cp);
+	cp.Put(guardState);
+}
+
+void GuardedThreePosSwitch::LoadCheckpoint(Checkpoint &cp) {
+
+	ThreePosSwitch::LoadCheckpoint(cp);
+	cp.Get(guardState);
+}
+
 
 //
 // Rotational Switch
@@ -1947,6 +2018,21 @@ void RotationalSwitch::LoadState(char *line) {
 	}
 }
 
+void RotationalSwitch::SaveCheckpoint(Checkpoint &cp) {
+
+	PanelSwitchItem::SaveCheckpoint(cp);
+	cp.Put(GetState());
+}
+
+void RotationalSwitch::LoadCheckpoint(Checkpoint &cp) {
+
+	int val;
+
+	PanelSwitchItem::LoadCheckpoint(cp);
+	if (cp.Get(val))
+		SetValue(val);
+}
+
 void RotationalSwitch::SetState(int value)
 {
 	SwitchTo(value);
@@ -2039,6 +2125,13 @@ void PowerStateRotationalSwitch::LoadState(char *line)
 	CheckPowerState();
 }
 
+void PowerStateRotationalSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	RotationalSwitch::LoadCheckpoint(cp);
+	CheckPowerState();
+}
+
 //
 // Thumbwheel Switch
 //
@@ -2190,6 +2283,18 @@ void ThumbwheelSwitch::LoadState(char *line) {
 	}
 }
 
+void ThumbwheelSwitch::SaveCheckpoint(Checkpoint &cp) {
+
+	PanelSwitchItem::SaveCheckpoint(cp);
+	cp.Put(state);
+}
+
+void ThumbwheelSwitch::LoadCheckpoint(Checkpoint &cp) {
+
+	PanelSwitchItem::LoadCheckpoint(cp);
+	cp.Get(state);
+}
+
 void ThumbwheelSwitch::SetState(int value)
 {
 	SwitchTo(value);
@@ -2248,6 +2353,16 @@ void VolumeThumbwheelSwitch::LoadState(char *line)
 	}
 }
 
+void VolumeThumbwheelSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	ThumbwheelSwitch::LoadCheckpoint(cp);
+
+	if (sl) {
+		sl->SetVolume(volume_class, (int) (state * (100.0 / 9.0)));
+	}
+}
+
 //
 // Indicator Switch
 //
@@ -2363,6 +2478,20 @@ void IndicatorSwitch::LoadState(char *line) {
 	}
 }
 
+void IndicatorSwitch::SaveCheckpoint(Checkpoint &cp) {
+
+	PanelSwitchItem::SaveCheckpoint(cp);
+	cp.Put(state);
+	cp.Put(displayState);
+}
+
+void IndicatorSwitch::LoadCheckpoint(Checkpoint &cp) {
+
+	PanelSwitchItem::LoadCheckpoint(cp);
+	cp.Get(state);
+	cp.Get(displayState);
+}
+
 
 //
 // Meter Switch
@@ -2486,6 +2615,20 @@ void MeterSwitch::LoadState(char *line) {
 	}
 }
 
+void MeterSwitch::SaveCheckpoint(Checkpoint &cp) {
+
+	PanelSwitchItem::SaveCheckpoint(cp);
+	cp.Put(value);
+	cp.Put(displayValue);
+}
+
+void MeterSwitch::LoadCheckpoint(Checkpoint &cp) {
+
+	PanelSwitchItem::LoadCheckpoint(cp);
+	cp.Get(value);
+	cp.Get(displayValue);
+}
+
 void RoundMeter::Init(HPEN p0, HPEN p1, SwitchRow &row)
 
 {
@@ -2629,6 +2772,31 @@ void PanelSwitchScenarioHandler::LoadState(FILEHANDLE scn) {
 	}
 }
 
+void PanelSwitchScenarioHandler::SaveCheckpoint(Checkpoint &cp) {
+
+	int count = 0;
+	PanelSwitchItem *s;
+
+	for (s = switchList; s; s = s->GetNextForScenario())
+		count++;
+	cp.Mark(count);
+	for (s = switchList; s; s = s->GetNextForScenario())
+		s->SaveCheckpoint(cp);
+}
+
+void PanelSwitchScenarioHandler::LoadCheckpoint(Checkpoint &cp) {
+
+	int count = 0;
+	PanelSwitchItem *s;
+
+	for (s = switchList; s; s = s->GetNextForScenario())
+		count++;
+	if (!cp.Check(count))
+		return;
+	for (s = switchList; s && !cp.Failed(); s = s->GetNextForScenario())
+		s->LoadCheckpoint(cp);
+}
+
 PanelSwitchItem* PanelSwitchScenarioHandler::GetSwitch(char *name) {
 
 	PanelSwitchItem *s = switchList;
@@ -2706,6 +2874,13 @@ void ThreeSourceSwitch::LoadState(char *line)
 	UpdateSourceState();
 }
 
+void ThreeSourceSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	ThreePosSwitch::LoadCheckpoint(cp);
+	UpdateSourceState();
+}
+
 /*void ThreeSourceSwitch::SetState(int value)
 {
 	SwitchTo(value);
@@ -2767,6 +2942,13 @@ void TwoSourceSwitch::LoadState(char *line)
 	UpdateSourceState();
 }
 
+void TwoSourceSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	ToggleSwitch::LoadCheckpoint(cp);
+	UpdateSourceState();
+}
+
 /*void TwoSourceSwitch::SetState(int value)
 {
 	SwitchTo(value);
@@ -2826,6 +3008,13 @@ void GuardedTwoSourceSwitch::LoadState(char *line)
 	GuardedToggleSwitch::LoadState(line);
 	UpdateSourceState();
 }
+
+void GuardedTwoSourceSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	GuardedToggleSwitch::LoadCheckpoint(cp);
+	UpdateSourceState();
+}
 //
 // TwoOutputSwitch allows you to connect one of the two outputs to the input based on the position
 // of the switch.
@@ -2887,6 +3076,13 @@ void TwoOutputSwitch::LoadState(char *line)
 	UpdateSourceState();
 }
 
+void TwoOutputSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	ToggleSwitch::LoadCheckpoint(cp);
+	UpdateSourceState();
+}
+
 
 //
 // ThreeOutputSwitch allows you to connect one of the three outputs to the input based on the position
@@ -2943,6 +3139,13 @@ void ThreeOutputSwitch::LoadState(char *line)
 	UpdateSourceState();
 }
 
+void ThreeOutputSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	ThreePosSwitch::LoadCheckpoint(cp);
+	UpdateSourceState();
+}
+
 bool ThreeOutputSwitch::SwitchTo(int newState, bool dontspring)
 
 {
@@ -3018,6 +3221,13 @@ void GuardedTwoOutputSwitch::LoadState(char *line)
 	UpdateSourceState(GetState());
 }
 
+void GuardedTwoOutputSwitch::LoadCheckpoint(Checkpoint &cp)
+
+{
+	GuardedToggleSwitch::LoadCheckpoint(cp);
+	UpdateSourceState(GetState());
+}
+
 void GuardedTwoOutputSwitch::SetState(int value)
 {
 	SwitchTo(value);
@@ -3807,6 +4017,18 @@ void HandcontrollerSwitch::LoadState(char *line) {
 	}
 }
 
+void HandcontrollerSwitch::SaveCheckpoint(Checkpoint &cp) {
+
+	PanelSwitchItem::SaveCheckpoint(cp);
+	cp.Put(state);
+}
+
+void HandcontrollerSwitch::LoadCheckpoint(Checkpoint &cp) {
+
+	PanelSwitchItem::LoadCheckpoint(cp);
+	cp.Get(state);
+}
+
 //
 // Panel interface connector. This is here as it's primarily concerned
 // with handling panel calls.
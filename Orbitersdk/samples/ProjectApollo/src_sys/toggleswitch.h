@@ -133,6 +133,21 @@ public:
 	/// \param line A line from the scenario file, which may or may not be for us.
 	///
 	virtual void LoadState(char *line) = 0;
+
+	///
+	/// Switches that do more than set their state when loaded from a scenario, such as
+	/// rewiring their sources, do the same when restored from a checkpoint.
+	///
+	/// \brief Save the switch state to an in-memory checkpoint.
+	/// \param cp Checkpoint to save to.
+	///
+	virtual void SaveCheckpoint(Checkpoint &cp);
+
+	///
+	/// \brief Restore the switch state from an in-memory checkpoint.
+	/// \param cp Checkpoint to restore from.
+	///
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	virtual void DrawFlash(SURFHANDLE DrawSurface) {};
 
 	///
@@ -308,6 +323,8 @@ public:
 	virtual bool CheckMouseClick(int event, int mx, int my);
 	virtual void SaveState(FILEHANDLE scn);
 	virtual void LoadState(char *line);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	virtual void SetState(int value); //Needed to properly process set states from toggle switches.
 	virtual void timestep(double missionTime);
 
@@ -451,6 +468,7 @@ public:
 	ThreeSourceSwitch() { source1 = source2 = source3 = 0; };
 	void Init(int xp, int yp, int w, int h, SURFHANDLE surf, SURFHANDLE bsurf, SwitchRow &row, e_object *s1, e_object *s2, e_object *s3);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 	virtual bool SwitchTo(int newState, bool dontspring = false);
 
 protected:
@@ -472,6 +490,7 @@ public:
 	void Init(int xp, int yp, int w, int h, SURFHANDLE surf, SURFHANDLE bsurf, SwitchRow &row, e_object *s1, e_object *s2);
 	virtual bool SwitchTo(int newState, bool dontspring = false);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 	//virtual void SetState(int value);
 
 protected:
@@ -491,6 +510,7 @@ public:
 	TwoOutputSwitch() { output1 = output2 = 0; };
 	void Init(int xp, int yp, int w, int h, SURFHANDLE surf, SURFHANDLE bsurf, SwitchRow &row, e_object *o1, e_object *o2);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 	virtual bool SwitchTo(int newState, bool dontspring = false);
 
 protected:
@@ -510,6 +530,7 @@ public:
 	ThreeOutputSwitch() { output1 = output2 = output3 = 0; };
 	void Init(int xp, int yp, int w, int h, SURFHANDLE surf, SURFHANDLE bsurf, SwitchRow &row, e_object *o1, e_object *o2, e_object *o3);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 	virtual bool SwitchTo(int newState, bool dontspring = false);
 
 protected:
@@ -825,6 +846,8 @@ public:
 	bool CheckMouseClick(int event, int mx, int my);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(char *line);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	int GetGuardState() { return guardState; };
 	void SetGuardState(bool s) { guardState = s; };
 	void SetGuardResetsState(bool s) { guardResetsState = s; };
@@ -853,6 +876,7 @@ public:
 	void Init(int xp, int yp, int w, int h, SURFHANDLE surf, SURFHANDLE bsurf, SwitchRow &row, e_object *o1, e_object *o2);
 	virtual bool SwitchTo(int newState, bool dontspring = false);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 	virtual void SetState(int value);
 
 protected:
@@ -873,6 +897,7 @@ public:
 	void Init(int xp, int yp, int w, int h, SURFHANDLE surf, SURFHANDLE bsurf, SwitchRow &row, e_object *s1, e_object *s2);
 	virtual bool SwitchTo(int newState, bool dontspring = false);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 
 protected:
 	virtual void UpdateSourceState();
@@ -930,6 +955,8 @@ public:
 	bool CheckMouseClick(int event, int mx, int my);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(char *line);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	int GetGuardState() { return guardState; };
 	void SetGuardState(bool s) { guardState = s; };
 	void Unguard() { guardState = 1; };
@@ -973,6 +1000,8 @@ public:
 	bool CheckMouseClick(int event, int mx, int my);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(char *line);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	int GetGuardState() { return guardState; };
 	void SetGuardState(bool s) { guardState = s; };
 	void SetGuardResetsState(bool s) { guardResetsState = s; };
@@ -1034,6 +1063,8 @@ public:
 	virtual bool SwitchTo(int newValue);
 	virtual void SaveState(FILEHANDLE scn);
 	virtual void LoadState(char *line);
+	virtual void SaveCheckpoint(Checkpoint &cp);
+	virtual void LoadCheckpoint(Checkpoint &cp);
 	int GetState();
 	operator int();
 	virtual void SetState(int value);
@@ -1066,6 +1097,7 @@ public:
 
 	virtual bool SwitchTo(int newValue);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 	void SetSource(int num, e_object *s);
 	double Current();
 	double Voltage();
@@ -1088,6 +1120,8 @@ public:
 	bool CheckMouseClick(int event, int mx, int my);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(char *line);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	virtual int GetState() { return state; };
 	virtual void SetState(int s) { state = s; };
 
@@ -1120,6 +1154,8 @@ public:
 	bool CheckMouseClick(int event, int mx, int my);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(char *line);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	double GetDisplayValue();
 
 	virtual double QueryValue() = 0;
@@ -1154,6 +1190,8 @@ public:
 	virtual bool SwitchTo(int newState);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(char *line);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	int GetState();
 //	int operator=(const int b);
 //	operator int();
@@ -1187,6 +1225,8 @@ public:
 	bool CheckMouseClick(int event, int mx, int my);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(char *line);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 	int GetState();
 
 protected:
@@ -1211,6 +1251,7 @@ public:
 	void Init(int xp, int yp, int w, int h, SURFHANDLE surf, SURFHANDLE bsurf, SwitchRow &row, int vclass, SoundLib *s);
 	virtual bool SwitchTo(int newState);
 	void LoadState(char *line);
+	void LoadCheckpoint(Checkpoint &cp);
 
 protected:
 	SoundLib *sl;
@@ -1328,6 +1369,8 @@ public:
 	PanelSwitchItem* GetSwitch(char *name);
 	void SaveState(FILEHANDLE scn);
 	void LoadState(FILEHANDLE scn);
+	void SaveCheckpoint(Checkpoint &cp);
+	void LoadCheckpoint(Checkpoint &cp);
 
 protected:
 	PanelSwitchItem *switchList;
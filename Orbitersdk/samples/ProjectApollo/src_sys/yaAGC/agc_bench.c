@@ -0,0 +1,565 @@
+/*
+  This file is part of Project Apollo - NASSP.
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  Filename:	agc_bench.c
+  Purpose:	Headless, batch-mode runner for the yaAGC engine.  Loads one
+		or more rope images, runs them for a given number of
+		simulated seconds with optional scripted DSKY/channel/counter
+		inputs, and reports engine throughput, wall time per
+		simulated second and the executed instruction mix.  The final
+		state hash is printed so that changes to agc_engine can be
+		checked for bit-exact behaviour against a previous build.
+  Compiler:	GNU gcc, or MSVC.
+  Usage:	agc_bench [options] rope.bin [rope.bin ...]
+
+		--seconds=N	Simulated seconds per rope (default 60).
+		--script=F	Input script (see below).
+		--runs=N	Repeat each rope N times, report the best run.
+		--single	Call agc_engine once per cycle instead of
+				running batches through agc_engine_run.
+		--idle		Let agc_engine_run fast-forward through the
+				executive's idle loop.
+		--verify	Run each rope both ways and check that the
+				final states are bit-identical.
+		--mix		Print the instruction mix per opcode class.
+		--quiet		Only print the summary line per rope.
+
+  The script is a plain text file with one event per line; '#' starts a
+  comment.  Times are in simulated seconds since start-up:
+
+		<time> key <k>		DSKY key: 0-9, V, N, E, C, R, K, +, -
+		<time> keys <string>	Key sequence, one key every 0.1 s
+		<time> chan <ch> <val>	Write AGC-format <val> to input channel
+		<time> pinc <ctr> <n>	<n> PINCs into counter <ctr>
+		<time> minc <ctr> <n>	<n> MINCs into counter <ctr>
+
+  Channel, counter and value fields are octal.
+*/
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1300 ) // Microsoft Visual Studio Version 2003 and higher
+#define _CRT_SECURE_NO_DEPRECATE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include "agc_engine.h"
+
+#define MAX_SCRIPT_EVENTS 4096
+#define KEY_INTERVAL 0.1
+
+typedef enum {
+  EV_KEY, EV_CHAN, EV_PINC, EV_MINC
+} EventType_t;
+
+typedef struct {
+  uint64_t Cycle;
+  int Sequence;			// Position in the script, for a stable sort.
+  EventType_t Type;
+  int Channel;
+  int Value;
+} ScriptEvent_t;
+
+static ScriptEvent_t Events[MAX_SCRIPT_EVENTS];
+static int NumEvents = 0;
+
+// Output-channel activity, folded into the state hash and counted.
+static uint64_t OutputHash;
+static uint64_t OutputCount;
+
+static agc_t State;
+
+// Non-zero to step the engine with agc_engine rather than agc_engine_run.
+// In the latter case PINC/MINC events go through the engine's increment
+// queue rather than being made directly.
+static int SingleStep = 0;
+
+// Non-zero to set IdleFastForward (agc_engine_run only).
+static int IdleSkip = 0;
+
+//----------------------------------------------------------------------------
+// Peripheral hooks expected by agc_engine.  These mirror the ones in
+// apolloguidance.cpp, minus the spacecraft.
+
+void
+ChannelOutput (agc_t * State, int Channel, int Value)
+{
+  int i;
+  uint64_t Word;
+  if (Channel == 7)
+    {
+      State->InputChannel[7] = State->OutputChannel7 = (Value & 0160);
+      return;
+    }
+  Word = (State->CycleCounter << 24) | ((Channel & 0777) << 15) | (Value & 077777);
+  for (i = 0; i < 8; i++)
+    {
+      OutputHash ^= (Word >> (8 * i)) & 0xFF;
+      OutputHash *= 0x100000001B3ULL;
+    }
+  OutputCount++;
+}
+
+int
+ChannelInput (agc_t * State)
+{
+  return (0);
+}
+
+void
+ChannelRoutine (agc_t * State)
+{
+}
+
+void
+ShiftToDeda (agc_t * State, int Data)
+{
+}
+
+#ifndef WIN32
+// agc_engine_init unblocks stdin on *NIX; there's no socket layer here.
+void
+UnblockSocket (int SocketNum)
+{
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Timing.
+
+static double
+WallClock (void)
+{
+#ifdef WIN32
+  LARGE_INTEGER Freq, Count;
+  QueryPerformanceFrequency (&Freq);
+  QueryPerformanceCounter (&Count);
+  return ((double) Count.QuadPart / (double) Freq.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (ts.tv_sec + 1e-9 * ts.tv_nsec);
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Script handling.
+
+static int
+DskyKeyCode (char Key)
+{
+  if (Key == '0')
+    return (020);
+  if (Key >= '1' && Key <= '9')
+    return (Key - '0');
+  switch (Key)
+    {
+    case 'V': case 'v': return (021);
+    case 'R': case 'r': return (022);
+    case 'K': case 'k': return (031);
+    case '+': return (032);
+    case '-': return (033);
+    case 'E': case 'e': return (034);
+    case 'C': case 'c': return (036);
+    case 'N': case 'n': return (037);
+    }
+  return (-1);
+}
+
+static int
+AddEvent (double Time, EventType_t Type, int Channel, int Value)
+{
+  if (NumEvents >= MAX_SCRIPT_EVENTS)
+    {
+      fprintf (stderr, "Too many script events.\n");
+      return (1);
+    }
+  Events[NumEvents].Cycle = (uint64_t) (Time * AGC_PER_SECOND);
+  Events[NumEvents].Sequence = NumEvents;
+  Events[NumEvents].Type = Type;
+  Events[NumEvents].Channel = Channel;
+  Events[NumEvents].Value = Value;
+  NumEvents++;
+  return (0);
+}
+
+static int
+CompareEvents (const void *a, const void *b)
+{
+  const ScriptEvent_t *Ea = (const ScriptEvent_t *) a;
+  const ScriptEvent_t *Eb = (const ScriptEvent_t *) b;
+  if (Ea->Cycle < Eb->Cycle)
+    return (-1);
+  if (Ea->Cycle > Eb->Cycle)
+    return (1);
+  // Keep the file order for events in the same cycle.
+  return (Ea->Sequence - Eb->Sequence);
+}
+
+static int
+LoadScript (const char *Filename)
+{
+  FILE *fp;
+  char Line[256], Command[32], Arg[128];
+  int LineNumber = 0, Channel, Value, i, n;
+  double Time;
+
+  fp = fopen (Filename, "r");
+  if (fp == NULL)
+    {
+      fprintf (stderr, "Cannot open script \"%s\".\n", Filename);
+      return (1);
+    }
+  while (NULL != fgets (Line, sizeof (Line), fp))
+    {
+      char *s;
+      LineNumber++;
+      if (NULL != (s = strchr (Line, '#')))
+        *s = 0;
+      n = sscanf (Line, "%lf %31s %127s", &Time, Command, Arg);
+      if (n <= 0)
+        continue;
+      if (n < 3)
+        goto BadLine;
+      if (!strcmp (Command, "key"))
+        {
+	  if (-1 == (Value = DskyKeyCode (Arg[0])) || Arg[1])
+	    goto BadLine;
+	  if (AddEvent (Time, EV_KEY, 015, Value))
+	    goto Abort;
+	}
+      else if (!strcmp (Command, "keys"))
+        {
+	  for (i = 0; Arg[i]; i++)
+	    {
+	      if (-1 == (Value = DskyKeyCode (Arg[i])))
+	        goto BadLine;
+	      if (AddEvent (Time + i * KEY_INTERVAL, EV_KEY, 015, Value))
+	        goto Abort;
+	    }
+	}
+      else if (!strcmp (Command, "chan") || !strcmp (Command, "pinc") ||
+               !strcmp (Command, "minc"))
+        {
+	  if (2 != sscanf (Line, "%*f %*s %o %o", &Channel, &Value))
+	    goto BadLine;
+	  if (Command[0] == 'c')
+	    n = AddEvent (Time, EV_CHAN, Channel, Value);
+	  else
+	    n = AddEvent (Time, (Command[0] == 'p') ? EV_PINC : EV_MINC,
+	                  Channel, Value);
+	  if (n)
+	    goto Abort;
+	}
+      else
+        goto BadLine;
+      continue;
+    BadLine:
+      fprintf (stderr, "%s:%d: cannot parse script line.\n", Filename, LineNumber);
+    Abort:
+      fclose (fp);
+      return (1);
+    }
+  fclose (fp);
+  qsort (Events, NumEvents, sizeof (ScriptEvent_t), CompareEvents);
+  return (0);
+}
+
+static int
+IsIncrement (const ScriptEvent_t *Event)
+{
+  return (Event->Type == EV_PINC || Event->Type == EV_MINC);
+}
+
+static void
+ApplyEvent (const ScriptEvent_t *Event)
+{
+  int i;
+  switch (Event->Type)
+    {
+    case EV_KEY:
+      WriteIO (&State, Event->Channel, Event->Value);
+      State.InterruptRequests[5] = 1;	// KEYRUPT1
+      break;
+    case EV_CHAN:
+      WriteIO (&State, Event->Channel, Event->Value);
+      break;
+    case EV_PINC:
+      for (i = 0; i < Event->Value; i++)
+        UnprogrammedIncrement (&State, Event->Channel, INC_PINC);
+      break;
+    case EV_MINC:
+      for (i = 0; i < Event->Value; i++)
+        UnprogrammedIncrement (&State, Event->Channel, INC_MINC);
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Instruction mix reporting.  The opcode classes follow the decoding switch
+// in agc_engine.
+
+typedef struct {
+  int First, Last;
+  const char *Name;
+} OpcodeClass_t;
+
+static const OpcodeClass_t OpcodeClasses[] = {
+  { 000, 007, "TC" }, { 010, 011, "CCS" }, { 012, 017, "TCF" },
+  { 020, 021, "DAS" }, { 022, 023, "LXCH" }, { 024, 025, "INCR" },
+  { 026, 027, "ADS" }, { 030, 037, "CA" }, { 040, 047, "CS" },
+  { 050, 051, "INDEX" }, { 052, 053, "DXCH" }, { 054, 055, "TS" },
+  { 056, 057, "XCH" }, { 060, 067, "AD" }, { 070, 077, "MASK" },
+  { 0100, 0100, "READ" }, { 0101, 0101, "WRITE" }, { 0102, 0102, "RAND" },
+  { 0103, 0103, "WAND" }, { 0104, 0104, "ROR" }, { 0105, 0105, "WOR" },
+  { 0106, 0106, "RXOR" }, { 0107, 0107, "EDRUPT" }, { 0110, 0111, "DV" },
+  { 0112, 0117, "BZF" }, { 0120, 0121, "MSU" }, { 0122, 0123, "QXCH" },
+  { 0124, 0125, "AUG" }, { 0126, 0127, "DIM" }, { 0130, 0137, "DCA" },
+  { 0140, 0147, "DCS" }, { 0150, 0157, "INDEX*" }, { 0160, 0161, "SU" },
+  { 0162, 0167, "BZMF" }, { 0170, 0177, "MP" }
+};
+
+static void
+PrintInstructionMix (void)
+{
+  int i, j;
+  uint64_t Total = 0, Count;
+  for (i = 0; i < 0200; i++)
+    Total += OpcodeCounts[i];
+  if (Total == 0)
+    return;
+  printf ("  Instruction mix (%llu instructions):\n", (unsigned long long) Total);
+  for (i = 0; i < (int) (sizeof (OpcodeClasses) / sizeof (OpcodeClasses[0])); i++)
+    {
+      for (Count = 0, j = OpcodeClasses[i].First; j <= OpcodeClasses[i].Last; j++)
+        Count += OpcodeCounts[j];
+      if (Count)
+        printf ("    %-8s %12llu  %6.2f%%\n", OpcodeClasses[i].Name,
+	        (unsigned long long) Count, 100.0 * Count / Total);
+    }
+}
+
+//----------------------------------------------------------------------------
+// State hash:  FNV-1a over erasable memory, the i/o channels, the cycle
+// counter and the output-channel activity.
+
+static uint64_t
+StateHash (void)
+{
+  const unsigned char *p;
+  uint64_t Hash = 0xCBF29CE484222325ULL;
+  size_t i;
+  p = (const unsigned char *) State.Erasable;
+  for (i = 0; i < sizeof (State.Erasable); i++)
+    Hash = (Hash ^ p[i]) * 0x100000001B3ULL;
+  p = (const unsigned char *) State.InputChannel;
+  for (i = 0; i < sizeof (State.InputChannel); i++)
+    Hash = (Hash ^ p[i]) * 0x100000001B3ULL;
+  Hash = (Hash ^ State.CycleCounter) * 0x100000001B3ULL;
+  Hash = (Hash ^ OutputHash) * 0x100000001B3ULL;
+  return (Hash);
+}
+
+//----------------------------------------------------------------------------
+// Run one rope for the given number of simulated seconds.
+
+typedef struct {
+  double Wall;
+  double MinSecond, MaxSecond;
+  uint64_t Cycles;
+  uint64_t Skipped;
+  uint64_t Hash;
+} RunResult_t;
+
+static int
+RunRope (const char *RomImage, int Seconds, RunResult_t *Result)
+{
+  int Second, NextEvent = 0, NextQueued = 0, i;
+  uint64_t Cycle, EndCycle;
+  double Start, SecondStart, Now;
+
+  memset (&State, 0, sizeof (State));
+  memset (OpcodeCounts, 0, sizeof (OpcodeCounts));
+  OutputHash = 0xCBF29CE484222325ULL;
+  OutputCount = 0;
+  agc_engine_init (&State, NULL, NULL, 0);
+  agc_engine_reset_timers ();
+  if (AGC_BINFILE_LOADED != (i = agc_load_binfile (&State, RomImage)))
+    {
+      fprintf (stderr, "Cannot load rope \"%s\" (error %d).\n", RomImage, i);
+      return (1);
+    }
+
+  // Same power-up channel defaults as ApolloGuidance::InitVirtualAGC:
+  // temperature in limits, IMU off, CMC MODE FREE, AGC WARNING set.
+  State.InputChannel[030] = 037777;
+  State.InputChannel[031] = 057777;
+  State.InputChannel[032] = 077777;
+  State.InputChannel[033] = 057777;
+  State.IdleFastForward = IdleSkip && !SingleStep;
+
+  Result->MinSecond = 1e30;
+  Result->MaxSecond = 0;
+  Start = WallClock ();
+  for (Cycle = 0, Second = 0; Second < Seconds; Second++)
+    {
+      SecondStart = WallClock ();
+      EndCycle = (uint64_t) (Second + 1) * AGC_PER_SECOND;
+      while (Cycle < EndCycle)
+        {
+	  uint64_t Stop = EndCycle;
+	  if (!SingleStep)
+	    {
+	      // Hand the counter increments to the engine ahead of time, as
+	      // far as the queue allows, and only stop for the other events.
+	      if (NextQueued < NextEvent)
+		NextQueued = NextEvent;
+	      for (; NextQueued < NumEvents; NextQueued++)
+		if (IsIncrement (&Events[NextQueued])
+		    && !agc_engine_queue_increment (&State,
+			  Events[NextQueued].Channel,
+			  Events[NextQueued].Type == EV_PINC ? INC_PINC : INC_MINC,
+			  Events[NextQueued].Value, Events[NextQueued].Cycle))
+		  break;
+	    }
+	  for (;;)
+	    {
+	      while (NextEvent < NextQueued && IsIncrement (&Events[NextEvent]))
+		NextEvent++;
+	      if (NextEvent >= NumEvents || Events[NextEvent].Cycle > Cycle)
+		break;
+	      ApplyEvent (&Events[NextEvent++]);
+	    }
+	  if (NextEvent < NumEvents && Events[NextEvent].Cycle < Stop)
+	    Stop = Events[NextEvent].Cycle;
+	  if (SingleStep)
+	    for (; Cycle < Stop; Cycle++)
+	      agc_engine (&State);
+	  else
+	    Cycle += agc_engine_run (&State, (int) (Stop - Cycle));
+	}
+      Now = WallClock ();
+      if (Now - SecondStart < Result->MinSecond)
+        Result->MinSecond = Now - SecondStart;
+      if (Now - SecondStart > Result->MaxSecond)
+        Result->MaxSecond = Now - SecondStart;
+    }
+  Result->Wall = WallClock () - Start;
+  Result->Cycles = Cycle;
+  Result->Skipped = State.IdleLoop.Skipped;
+  Result->Hash = StateHash ();
+  return (0);
+}
+
+int
+main (int argc, char *argv[])
+{
+  int i, Run, Seconds = 60, Runs = 1, Mix = 0, Quiet = 0, Verify = 0, NumRopes = 0;
+  RunResult_t Result, Best;
+
+  memset (&Best, 0, sizeof (Best));
+  for (i = 1; i < argc; i++)
+    {
+      if (1 == sscanf (argv[i], "--seconds=%d", &Seconds))
+        continue;
+      if (1 == sscanf (argv[i], "--runs=%d", &Runs))
+        continue;
+      if (!strncmp (argv[i], "--script=", 9))
+        {
+	  if (LoadScript (&argv[i][9]))
+	    return (1);
+	}
+      else if (!strcmp (argv[i], "--mix"))
+        Mix = 1;
+      else if (!strcmp (argv[i], "--quiet"))
+        Quiet = 1;
+      else if (!strcmp (argv[i], "--single"))
+        SingleStep = 1;
+      else if (!strcmp (argv[i], "--verify"))
+        Verify = 1;
+      else if (!strcmp (argv[i], "--idle"))
+        IdleSkip = 1;
+      else if (argv[i][0] == '-')
+        {
+	  fprintf (stderr, "Unknown option \"%s\".\n", argv[i]);
+	  return (1);
+	}
+      else
+        NumRopes++;
+    }
+  if (NumRopes == 0 || Seconds <= 0 || Runs <= 0)
+    {
+      fprintf (stderr, "Usage: agc_bench [--seconds=N] [--runs=N] [--script=F] "
+               "[--single] [--idle] [--verify] [--mix] [--quiet] rope.bin ...\n");
+      return (1);
+    }
+  OpcodeStatistics = Mix;
+
+  for (i = 1; i < argc; i++)
+    {
+      if (argv[i][0] == '-')
+        continue;
+      for (Run = 0; Run < Runs; Run++)
+        {
+	  if (RunRope (argv[i], Seconds, &Result))
+	    return (1);
+	  if (Run == 0 || Result.Wall < Best.Wall)
+	    Best = Result;
+	  if (Run > 0 && Result.Hash != Best.Hash)
+	    {
+	      fprintf (stderr, "%s: state hash differs between runs!\n", argv[i]);
+	      return (2);
+	    }
+	}
+      if (Verify)
+        {
+	  uint64_t Hash = Best.Hash;
+	  SingleStep = !SingleStep;
+	  if (RunRope (argv[i], Seconds, &Result))
+	    return (1);
+	  SingleStep = !SingleStep;
+	  if (Result.Hash != Hash)
+	    {
+	      fprintf (stderr, "%s: agc_engine_run and agc_engine disagree "
+	               "(%016llx vs. %016llx)!\n", argv[i],
+		       (unsigned long long) Hash, (unsigned long long) Result.Hash);
+	      return (2);
+	    }
+	}
+      printf ("%s: %d s simulated, %.3f s wall, %.0f cycles/s (%.1fx real time), "
+              "hash %016llx\n", argv[i], Seconds, Best.Wall, Best.Cycles / Best.Wall,
+	      Seconds / Best.Wall, (unsigned long long) Best.Hash);
+      if (!Quiet)
+        {
+	  printf ("  Wall time per simulated second: min %.3f ms, avg %.3f ms, "
+	          "max %.3f ms\n", 1000.0 * Best.MinSecond,
+		  1000.0 * Best.Wall / Seconds, 1000.0 * Best.MaxSecond);
+	  printf ("  Output channel writes: %llu\n", (unsigned long long) OutputCount);
+	  if (Best.Skipped)
+	    printf ("  Idle cycles fast-forwarded: %llu (%.1f%%)\n",
+	            (unsigned long long) Best.Skipped, 100.0 * Best.Skipped / Best.Cycles);
+	}
+      if (Mix)
+        PrintInstructionMix ();
+    }
+  return (0);
+}
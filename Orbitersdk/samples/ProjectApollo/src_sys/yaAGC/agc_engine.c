@@ -308,6 +308,7 @@
 //#include <errno.h>
 //#include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #ifdef WIN32
 typedef unsigned short uint16_t;
 #endif
@@ -350,6 +351,21 @@ typedef unsigned short uint16_t;
 #define AGC_P1 ((int16_t) 1)
 #define AGC_M1 ((int16_t) 077776)
 
+// The per-cycle engine body is force-inlined into both agc_engine (one cycle
+// per call) and agc_engine_run (many cycles per call), so that the batched
+// loop pays no call overhead per machine cycle.
+#if defined(_MSC_VER)
+#define AGC_INLINE static __forceinline
+#elif defined(__GNUC__)
+#define AGC_INLINE static inline __attribute__((always_inline))
+#else
+#define AGC_INLINE static
+#endif
+
+// BacktraceAdd does nothing outside of --debug mode, so don't even call it.
+#define BACKTRACE_ADD(State, Cause) \
+  do { if (SingleStepCounter != -2) BacktraceAdd (State, Cause); } while (0)
+
 // Here are arrays which tell (for each instruction, as determined by the
 // uppermost 5 bits of the instruction) how many extra machine cycles are 
 // needed to execute the instruction.  (In other words, the total number of
@@ -397,9 +413,29 @@ unsigned FixedAccessCounts[40][02000];
 unsigned IoReadCounts[01000];
 unsigned IoWriteCounts[01000];
 
+// Instruction-mix statistics, indexed by the 7-bit extended opcode (the 
+// extracode flag followed by the upper 6 bits of the instruction).  Only
+// updated when OpcodeStatistics != 0, which is what the headless benchmark
+// runner (agc_bench.c) uses for its per-opcode-class report.
+int OpcodeStatistics = 0;
+uint64_t OpcodeCounts[0200];
+
 // For debugging the CDUX,Y,Z inputs.
 FILE *CduLog = NULL;
 
+// Side effects of the current machine cycle that matter to the idle-loop
+// fast-forward (see IdleLoopStep).  Cleared by whoever wants to look at them.
+#define IDLE_SEEN_NEWJOB	0001	// NEWJOB accessed (Night Watchman cleared).
+#define IDLE_SEEN_NONISR	0002	// Non-ISR instruction done (RuptLock cleared).
+#define IDLE_SEEN_TC		0004	// TC or TCF done (NoTC cleared).
+#define IDLE_SEEN_NONTC		0010	// Other instruction done (TCTrap cleared).
+#define IDLE_SEEN_ISR		0020	// ISR instruction done (NoRupt cleared).
+#define IDLE_SEEN_COUNTER	0040	// Editing or counter register accessed.
+#define IDLE_SEEN_IO		0100	// Channel written, or scaler read.
+#define IDLE_SEEN_TICK		0200	// Cycle taken by scaler counter updates.
+#define IDLE_SEEN_WRITE		0400	// Erasable memory changed.
+static unsigned IdleSeen = 0;
+
 //-----------------------------------------------------------------------------
 // Functions for reading or writing from/to i/o channels.  The reason we have
 // to provide a function for this rather than accessing the i/o-channel buffer
@@ -413,6 +449,8 @@ ReadIO (agc_t * State, int Address)
     return (0);
   if (CoverageCounts)
     IoReadCounts[Address]++;
+  if (Address == ChanSCALER1 || Address == ChanSCALER2)
+    IdleSeen |= IDLE_SEEN_IO;
   if (Address == RegL || Address == RegQ)
     return (State->Erasable[0][Address]);
   return (State->InputChannel[Address]);
@@ -465,6 +503,15 @@ void
 CpuWriteIO (agc_t * State, int Address, int Value)
 {
   static int Downlink = 0;
+  // Channel 7 (the superbank bit) is internal to the CPU, and doesn't count
+  // as output.
+  if (Address != ChanS)
+    {
+      IdleSeen |= IDLE_SEEN_IO;
+      if (Address >= 0 && Address < NUM_CHANNELS
+	  && State->InputChannel[Address] != (Value & 077777))
+	State->OutputChanged = 1;
+    }
   WriteIO (State, Address, Value);
   ChannelOutput (State, Address, Value & 077777);
   // 2005-06-25 RSB.  DOWNRUPT stuff.  I assume that the 20 ms. between
@@ -571,7 +618,10 @@ FindMemoryWord (agc_t * State, int Address12)
     {
 	  // Address 67 has been accessed in some way. Clear the Night Watchman.
 	  State->NightWatchman = 0;
+	  IdleSeen |= IDLE_SEEN_NEWJOB;
 	}
+  else if (Address12 >= RegCYR && Address12 <= 060)
+    IdleSeen |= IDLE_SEEN_COUNTER;
 
   // It should be noted as far as unswitched-erasable and common-fixed memory
   // is concerned, that the following rules actually do result in continuous
@@ -739,12 +789,20 @@ Assign (agc_t * State, int Bank, int Offset, int Value)
 	  break;
 	}
       if (Offset >= REG16 || (Offset >= 020 && Offset <= 023))
-	State->Erasable[0][Offset] = Value & 077777;
+	{
+	  if (Offset >= 010 && State->Erasable[0][Offset] != (Value & 077777))
+	    IdleSeen |= IDLE_SEEN_WRITE;
+	  State->Erasable[0][Offset] = Value & 077777;
+	}
       else
 	State->Erasable[0][Offset] = Value & 0177777;
     }
   else
-    State->Erasable[Bank][Offset] = Value & 077777;
+    {
+      if (State->Erasable[Bank][Offset] != (Value & 077777))
+	IdleSeen |= IDLE_SEEN_WRITE;
+      State->Erasable[Bank][Offset] = Value & 077777;
+    }
 }
 
 static void
@@ -1344,7 +1402,7 @@ PushCduFifo (agc_t *State, int Counter, int IncType)
 // each time around (in order to preserve proper cycle counts), so this function 
 // must be called at at least an 6400*NUM_CDU_FIFO cps rate.  Returns 0 if no
 // counter was updated, non-zero if a counter was updated.
-static int
+AGC_INLINE int
 ServiceCduFifo (agc_t *State)
 {
   int Count, RetVal = 0, HighRate, DownCount;
@@ -1484,10 +1542,11 @@ UnprogrammedIncrement (agc_t *State, int Counter, int IncType)
 // Function handles the coarse-alignment output pulses for one IMU CDU drive axis.  
 // It returns non-0 if a non-zero count remains on the axis, 0 otherwise.
             
+static int CountCDUX = 0, CountCDUY = 0, CountCDUZ = 0;  // In target CPU format.
+
 static int
 BurstOutput (agc_t *State, int DriveBitMask, int CounterRegister, int Channel)
 {
-  static int CountCDUX = 0, CountCDUY = 0, CountCDUZ = 0;  // In target CPU format.
   int DriveCount = 0, DriveBit, Direction = 0, Delta, DriveCountSaved;
   if (CounterRegister == RegCDUXCMD)
     DriveCountSaved = CountCDUX;
@@ -1597,8 +1656,36 @@ static unsigned ImuChannel14 = 0;
 ///
 int ChannelRoutineCount = 0;
 
-int
-agc_engine (agc_t * State)
+//-----------------------------------------------------------------------------
+// agc_engine_init only touches agc_t, but the engine also keeps the scaler, 
+// gyro, CDU-drive and CDU FIFO timing in file-scope variables.  Anything that
+// restarts a simulation from scratch within the same process (such as the 
+// headless benchmark runner) calls this to put those back to power-up values
+// as well, so that two runs of the same rope are cycle-for-cycle identical.
+
+void
+agc_engine_reset_timers (void)
+{
+  memset (CduFifos, 0, sizeof (CduFifos));
+  CduChecker = 0;
+  CountCDUX = CountCDUY = CountCDUZ = 0;
+  ScalerCounter = 0;
+  GyroCount = 0;
+  OldChannel14 = 0;
+  GyroTimer = 0;
+  ImuCduCount = 0;
+  ImuChannel14 = 0;
+  ChannelRoutineCount = 0;
+  NextZ = 0;
+  TrapPIPA = 0;
+}
+
+//-----------------------------------------------------------------------------
+// One machine cycle.  agc_engine and agc_engine_run must give bit-identical
+// results, which agc_bench --verify checks.
+
+AGC_INLINE int
+EngineCycle (agc_t * State)
 {
   int i, j;
 
@@ -1606,7 +1693,7 @@ agc_engine (agc_t * State)
   /// static int Count = 0;
 
   uint16_t ProgramCounter, Instruction, OpCode, QuarterCode, sExtraCode;
-  int16_t *WhereWord;
+  int16_t *WhereWord = NULL;
   uint16_t Address12, Address10, Address9;
   int ValueK, KeepExtraCode = 0;
   //int Operand;
@@ -1853,6 +1940,7 @@ agc_engine (agc_t * State)
 		  // Return, so as to account for the time occupied by updating the
 	      // counters and/or GOJAM.
 	      State->ExtraDelay--;
+	      IdleSeen |= IDLE_SEEN_TICK;
 		  return (0);
 	    }
     }
@@ -2053,7 +2141,7 @@ agc_engine (agc_t * State)
 	    {
 	      if (State->InterruptRequests[i] && DebuggerInterruptMasks[i])
 		{
-		  BacktraceAdd (State, i);
+		  BACKTRACE_ADD (State, i);
 		  // Clear the interrupt request.
 		  State->InterruptRequests[i] = 0;
 		  State->InterruptRequests[0] = i;
@@ -2127,6 +2215,8 @@ agc_engine (agc_t * State)
   ExtendedOpcode = Instruction >> 9;	//2;
   if (sExtraCode)
     ExtendedOpcode |= 0100;
+  if (OpcodeStatistics)
+    OpcodeCounts[ExtendedOpcode]++;
   switch (ExtendedOpcode)
     {
     case 000:			// TC.  
@@ -2152,7 +2242,7 @@ agc_engine (agc_t * State)
 	}
       else
 	{
-	  BacktraceAdd (State, 0);
+	  BACKTRACE_ADD (State, 0);
 	  if (ValueK != RegQ)	// If not a RETURN instruction ...
 	    c (RegQ) = 0177777 & NextZ;
 	  NextZ = Address12;
@@ -2206,7 +2296,7 @@ agc_engine (agc_t * State)
     case 015:
     case 016:
     case 017:
-      BacktraceAdd (State, 0);
+      BACKTRACE_ADD (State, 0);
       // TCF instruction (1 MCT).
       NextZ = Address12;
       // THAT was easy ... too easy ...
@@ -2398,9 +2488,9 @@ agc_engine (agc_t * State)
 	{
 	Resume:
 	  if (State->InIsr)
-	    BacktraceAdd (State, 255);
+	    BACKTRACE_ADD (State, 255);
 	  else
-	    BacktraceAdd (State, 0);
+	    BACKTRACE_ADD (State, 0);
 	  NextZ = c(RegZRUPT) - 1;
 	  State->InIsr = 0;
 // Remove ifdef because Luminary131 LM Autopilot code is using that feature
@@ -2614,7 +2704,7 @@ agc_engine (agc_t * State)
       //  State->InterruptRequests[State->InterruptRequests[0]] = 0;
       c (RegZRUPT) = c (RegZ);
       State->InIsr = 1;
-      BacktraceAdd (State, 0);
+      BACKTRACE_ADD (State, 0);
 #if 0
       if (State->InIsr)
         {
@@ -2735,7 +2825,7 @@ agc_engine (agc_t * State)
       //if (Operand16 == AGC_P0 || Operand16 == AGC_M0)
       if (Accumulator == 0 || Accumulator == 0177777)
 	{
-	  BacktraceAdd (State, 0);
+	  BACKTRACE_ADD (State, 0);
 	  NextZ = Address12;
 	}
       break;
@@ -2933,7 +3023,7 @@ agc_engine (agc_t * State)
       //if (Operand16 == AGC_P0 || IsNegativeSP (Operand16))
       if (Accumulator == 0 || 0 != (Accumulator & 0100000))
 	{
-	  BacktraceAdd (State, 0);
+	  BACKTRACE_ADD (State, 0);
 	  NextZ = Address12;
 	}
       break;
@@ -3026,6 +3116,511 @@ AllDone:
 	  // Update TC Trap flags according to the instruction we just executed
 	  if (ExecutedTC) State->NoTC = 0;
 	  else State->TCTrap = 0;
+
+	  IdleSeen |= (State->InIsr ? IDLE_SEEN_ISR : IDLE_SEEN_NONISR) |
+	    (ExecutedTC ? IDLE_SEEN_TC : IDLE_SEEN_NONTC);
     }
   return (0);
 }
+
+int
+agc_engine (agc_t * State)
+{
+  return (EngineCycle (State));
+}
+
+//-----------------------------------------------------------------------------
+// Counter-increment queue.  agc_engine_queue_increment may be called from a
+// different thread than agc_engine_run, as long as there is only one thread
+// on each side.  The barrier keeps the entry writes ahead of the index update
+// that publishes them; x86 keeps stores in order, so on MSVC a compiler
+// barrier is all that's needed.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define QUEUE_BARRIER() _ReadWriteBarrier ()
+#else
+#define QUEUE_BARRIER() __sync_synchronize ()
+#endif
+
+// Returns 1 on success, or 0 if the queue is full, in which case the caller
+// has to make the increments itself with the engine stopped.  Use Cycle 0 to
+// have the increments made at the next cycle boundary.
+
+int
+agc_engine_queue_increment (agc_t * State, int Counter, int IncType,
+			    int Count, uint64_t Cycle)
+{
+  unsigned Head = State->IncrementHead;
+  IncrementEvent_t *Event;
+  if (Head - State->IncrementTail >= INCREMENT_QUEUE_SIZE)
+    return (0);
+  Event = &State->IncrementQueue[Head & (INCREMENT_QUEUE_SIZE - 1)];
+  Event->Cycle = Cycle;
+  Event->Counter = Counter;
+  Event->IncType = IncType;
+  Event->Count = Count;
+  QUEUE_BARRIER ();
+  State->IncrementHead = Head + 1;
+  return (1);
+}
+
+// Make all queued increments that are due by the current cycle, in order.
+// *Seen is set to the queue head that was looked at.  Returns the cycle of
+// the next pending entry, or ~0 if there is none.
+
+static uint64_t
+DeliverIncrements (agc_t * State, unsigned *Seen)
+{
+  unsigned Tail = State->IncrementTail, Head = State->IncrementHead;
+  IncrementEvent_t *Event = NULL;
+  int i;
+  QUEUE_BARRIER ();
+  *Seen = Head;
+  for (; Tail != Head; Tail++)
+    {
+      Event = &State->IncrementQueue[Tail & (INCREMENT_QUEUE_SIZE - 1)];
+      if (Event->Cycle > State->CycleCounter)
+	break;
+      if (Event->IncType == INC_CDU_SET)
+	State->Erasable[0][Event->Counter] = Event->Count & 077777;
+      else
+	for (i = 0; i < Event->Count; i++)
+	  UnprogrammedIncrement (State, Event->Counter, Event->IncType);
+    }
+  QUEUE_BARRIER ();
+  State->IncrementTail = Tail;
+  if (Tail == Head)
+    return (~(uint64_t) 0);
+  return (Event->Cycle);
+}
+
+//-----------------------------------------------------------------------------
+// Idle-loop fast-forward.  When the executive has nothing to do, the CPU goes
+// around a short loop that reads fixed memory and registers and nothing else,
+// until an interrupt comes along.  The only things that really happen in that
+// time are the scaler ticks every 160/3 cycles, which update the timers and
+// may steal a few cycles to do so.
+//
+// agc_engine_run records one pass around the loop (IdleLoop_t), and then runs
+// only the cycles that take a scaler tick, restoring the CPU state the loop
+// has at that point first.  Everything in between is accounted for by
+// IdleAdvance: CycleCounter, the scaler, the CDU FIFO checker and gyro timer
+// that step once per cycle, and the alarm flags the loop's instructions
+// clear.  The result is cycle-for-cycle the same as running every cycle; any
+// cycle whose outcome doesn't match the recording (an interrupt request, a
+// GOJAM, an increment from outside) ends the fast-forward.
+
+#define IDLE_MIN_BACKOFF 16
+#define IDLE_MAX_BACKOFF 4096
+
+// Side effects counted in IdleLoop_t.Totals[1..4].
+static const unsigned IdleTotalsSeen[5] = {
+  0, IDLE_SEEN_NEWJOB, IDLE_SEEN_NONISR, IDLE_SEEN_TC, IDLE_SEEN_NONTC
+};
+
+static void
+IdleCapture (agc_t * State, IdleCycle_t * Cycle)
+{
+  memcpy (Cycle->Regs, State->Erasable[0], sizeof (Cycle->Regs));
+  Cycle->Channel7 = State->InputChannel[7];
+  Cycle->OutputChannel7 = State->OutputChannel7;
+  Cycle->IndexValue = State->IndexValue;
+  Cycle->NextZ = NextZ;
+  Cycle->ExtraCode = State->ExtraCode;
+  Cycle->AllowInterrupt = State->AllowInterrupt;
+  Cycle->SubstituteInstruction = State->SubstituteInstruction;
+  Cycle->PendFlag = State->PendFlag;
+  Cycle->PendDelay = State->PendDelay;
+  Cycle->ExtraDelay = State->ExtraDelay;
+  Cycle->Seen = 0;
+  Cycle->ToTick = 0;
+}
+
+static void
+IdleRestore (agc_t * State, const IdleCycle_t * Cycle)
+{
+  memcpy (State->Erasable[0], Cycle->Regs, sizeof (Cycle->Regs));
+  State->InputChannel[7] = Cycle->Channel7;
+  State->OutputChannel7 = Cycle->OutputChannel7;
+  State->IndexValue = Cycle->IndexValue;
+  NextZ = Cycle->NextZ;
+  State->ExtraCode = Cycle->ExtraCode;
+  State->AllowInterrupt = Cycle->AllowInterrupt;
+  State->SubstituteInstruction = Cycle->SubstituteInstruction;
+  State->PendFlag = Cycle->PendFlag;
+  State->PendDelay = Cycle->PendDelay;
+  State->ExtraDelay = Cycle->ExtraDelay;
+}
+
+static int
+IdleSameCpu (const IdleCycle_t * a, const IdleCycle_t * b)
+{
+  return (!memcmp (a->Regs, b->Regs, sizeof (a->Regs)) &&
+	  a->Channel7 == b->Channel7 &&
+	  a->OutputChannel7 == b->OutputChannel7 &&
+	  a->IndexValue == b->IndexValue && a->NextZ == b->NextZ &&
+	  a->ExtraCode == b->ExtraCode &&
+	  a->AllowInterrupt == b->AllowInterrupt &&
+	  a->SubstituteInstruction == b->SubstituteInstruction &&
+	  a->PendFlag == b->PendFlag && a->PendDelay == b->PendDelay &&
+	  a->ExtraDelay == b->ExtraDelay);
+}
+
+// Non-zero if a scaler tick can be taken at the start of this cycle, i.e.
+// the cycle isn't swallowed by a multi-MCT instruction or an extra delay.
+static int
+IdleTickable (const IdleCycle_t * Cycle)
+{
+  return (Cycle->ExtraDelay == 0 && !(Cycle->PendFlag && Cycle->PendDelay > 0));
+}
+
+// Non-zero if nothing but the CPU needs the cycles: no interrupts pending or
+// in progress, and no CDU, gyro or optics activity.
+static int
+IdleQuiet (agc_t * State)
+{
+  int i;
+#ifdef GYRO_TIMING_SIMULATED
+  return (0);
+#endif
+  if (DedaMonitor || DebugDsky || CoverageCounts || OpcodeStatistics)
+    return (0);
+  if (State->InIsr)
+    return (0);
+  for (i = 1; i <= NUM_INTERRUPT_TYPES; i++)
+    if (State->InterruptRequests[i])
+      return (0);
+  for (i = 0; i < NUM_CDU_FIFOS; i++)
+    if (CduFifos[i].Size > 0)
+      return (0);
+  if (GyroCount ||
+      (0 != (State->InputChannel[014] & 01000) && 0 != State->Erasable[0][RegGYROCTR]))
+    return (0);
+  if (0 != (State->InputChannel[014] & 070000))
+    return (0);
+  if ((State->Erasable[0][054] != 0 && State->Erasable[0][054] != 077777 &&
+       0 != (State->InputChannel[014] & 02000)) ||
+      (State->Erasable[0][053] != 0 && State->Erasable[0][053] != 077777 &&
+       0 != (State->InputChannel[014] & 04000)) ||
+      (State->Erasable[0][055] != 0 && State->Erasable[0][055] != 077777 &&
+       0 != (State->InputChannel[014] & 010)) ||
+      (State->Erasable[0][060] != 0 && State->Erasable[0][060] != 077777 &&
+       0 != (State->InputChannel[014] & 04)))
+    return (0);
+  return (1);
+}
+
+// Compare memory and channels with the recording, leaving out the CPU 
+// registers, the counters (which the loop can't touch), and the scaler, 
+// superbank and alarm channels.
+static int
+IdleMemoryMatches (agc_t * State, IdleLoop_t * Loop)
+{
+  return (!memcmp (&State->Erasable[0][010], &Loop->Erasable[0][010],
+		   (RegCYR - 010) * sizeof (int16_t)) &&
+	  !memcmp (&State->Erasable[0][061], &Loop->Erasable[0][061],
+		   (0400 - 061) * sizeof (int16_t)) &&
+	  !memcmp (State->Erasable[1], Loop->Erasable[1],
+		   7 * 0400 * sizeof (int16_t)) &&
+	  !memcmp (State->InputChannel, Loop->InputChannel,
+		   ChanSCALER2 * sizeof (int16_t)) &&
+	  !memcmp (&State->InputChannel[05], &Loop->InputChannel[05],
+		   2 * sizeof (int16_t)) &&
+	  !memcmp (&State->InputChannel[010], &Loop->InputChannel[010],
+		   (077 - 010) * sizeof (int16_t)) &&
+	  !memcmp (&State->InputChannel[0100], &Loop->InputChannel[0100],
+		   (NUM_CHANNELS - 0100) * sizeof (int16_t)));
+}
+
+// Count cycles with side effect Total over N cycles from loop position K.
+static uint64_t
+IdleTotal (IdleLoop_t * Loop, int Total, int K, int N)
+{
+  int16_t *Totals = Loop->Totals[Total];
+  int Length = Loop->Length, Rest = N % Length;
+  uint64_t Count = (uint64_t) (N / Length) * Totals[Length];
+  if (K + Rest <= Length)
+    return (Count + Totals[K + Rest] - Totals[K]);
+  return (Count + Totals[Length] - Totals[K] + Totals[K + Rest - Length]);
+}
+
+// Wait a while before looking again, a bit longer each time.
+static void
+IdleWait (agc_t * State)
+{
+  IdleLoop_t *Loop = &State->IdleLoop;
+  Loop->NextCheck = State->CycleCounter + Loop->Backoff;
+  Loop->Backoff *= 2;
+  if (Loop->Backoff > IDLE_MAX_BACKOFF)
+    Loop->Backoff = IDLE_MAX_BACKOFF;
+}
+
+static void
+IdleFailed (agc_t * State)
+{
+  State->IdleLoop.Valid = State->IdleLoop.Recording = 0;
+  IdleWait (State);
+}
+
+// Fill in the running totals and tick distances of a complete recording.
+static void
+IdleRecorded (agc_t * State)
+{
+  IdleLoop_t *Loop = &State->IdleLoop;
+  int i, j, k, Length = Loop->Length;
+  for (j = 0; j < 5; j++)
+    Loop->Totals[j][0] = 0;
+  for (k = 0; k < Length; k++)
+    {
+      Loop->Totals[0][k + 1] = Loop->Totals[0][k] + IdleTickable (&Loop->Cycles[k]);
+      for (j = 1; j < 5; j++)
+	Loop->Totals[j][k + 1] = Loop->Totals[j][k] +
+	  (0 != (Loop->Cycles[k].Seen & IdleTotalsSeen[j]));
+    }
+  if (Loop->Totals[0][Length] == 0)
+    {
+      IdleFailed (State);
+      return;
+    }
+  for (k = 0; k < Length; k++)
+    for (i = 0; !IdleTickable (&Loop->Cycles[(k + i) % Length]); i++)
+      Loop->Cycles[k].ToTick = i + 1;
+  Loop->Recording = 0;
+  Loop->Valid = 1;
+  Loop->Backoff = IDLE_MIN_BACKOFF;
+}
+
+// Run one machine cycle as part of a recording.  Returns 0, without running
+// the cycle, if the CPU is back where the recording started.
+static int
+IdleRecordCycle (agc_t * State)
+{
+  IdleLoop_t *Loop = &State->IdleLoop;
+  IdleCycle_t Now;
+  if (Loop->TickCycles > 0)
+    {
+      // Still in the cycles taken by a scaler tick, which aren't part of
+      // the loop.
+      Loop->TickCycles--;
+      EngineCycle (State);
+    }
+  else
+    {
+      IdleCapture (State, &Now);
+      if (Loop->Length > 0 && IdleSameCpu (&Now, &Loop->Cycles[0]))
+	{
+	  if (IdleMemoryMatches (State, Loop))
+	    IdleRecorded (State);
+	  else
+	    IdleFailed (State);
+	  return (0);
+	}
+      if (Loop->Length >= MAX_IDLE_LOOP)
+	{
+	  IdleFailed (State);
+	  return (0);
+	}
+      IdleSeen = 0;
+      EngineCycle (State);
+      if (IdleSeen & IDLE_SEEN_TICK)
+	Loop->TickCycles = State->ExtraDelay;
+      else
+	{
+	  Now.Seen = IdleSeen;
+	  Loop->Cycles[Loop->Length++] = Now;
+	}
+      if (IdleSeen & (IDLE_SEEN_ISR | IDLE_SEEN_COUNTER | IDLE_SEEN_IO | IDLE_SEEN_WRITE))
+	{
+	  IdleFailed (State);
+	  return (1);
+	}
+    }
+  if (!IdleQuiet (State))
+    IdleFailed (State);
+  return (1);
+}
+
+// Account for N cycles of the loop from position K, none of which takes a 
+// scaler tick.
+static void
+IdleAdvance (agc_t * State, int K, int N)
+{
+  IdleLoop_t *Loop = &State->IdleLoop;
+  uint64_t Tickable = IdleTotal (Loop, 0, K, N);
+  State->CycleCounter += N;
+  ScalerCounter += N * SCALER_DIVIDER;
+  ChannelRoutineCount = ((ChannelRoutineCount + N) & 017777);
+  // ServiceCduFifo and the gyro timer see every cycle that could take a tick.
+  CduChecker = (int) ((CduChecker + Tickable) % NUM_CDU_FIFOS);
+  GyroTimer = (unsigned) ((GyroTimer + Tickable * GYRO_DIVIDER) % (GYRO_BURST * GYRO_OVERFLOW));
+  if (State->NightWatchman && IdleTotal (Loop, 1, K, N))
+    State->NightWatchman = 0;
+  if (State->RuptLock && IdleTotal (Loop, 2, K, N))
+    State->RuptLock = 0;
+  if (State->NoTC && IdleTotal (Loop, 3, K, N))
+    State->NoTC = 0;
+  if (State->TCTrap && IdleTotal (Loop, 4, K, N))
+    State->TCTrap = 0;
+  Loop->Skipped += N;
+}
+
+// Fast-forward from loop position K, for at most Cycles cycles and not past
+// CycleCounter == StopCycle.  Returns the number of cycles done.
+static int
+IdleFastForward (agc_t * State, int K, int Cycles, uint64_t StopCycle,
+		 unsigned Seen)
+{
+  IdleLoop_t *Loop = &State->IdleLoop;
+  IdleCycle_t Now;
+  int Done = 0, Length = Loop->Length, Ahead, Limit;
+  for (;;)
+    {
+      // Cycles to the one that takes the next scaler tick: the scaler has
+      // to be due, and the cycle has to be able to take it.
+      if (ScalerCounter + SCALER_DIVIDER >= SCALER_OVERFLOW)
+	Ahead = 0;
+      else
+	Ahead = (SCALER_OVERFLOW - ScalerCounter - 1) / SCALER_DIVIDER;
+      Ahead += Loop->Cycles[(K + Ahead) % Length].ToTick;
+      Limit = Cycles - Done;
+      if (StopCycle - State->CycleCounter < (uint64_t) Limit)
+	Limit = (int) (StopCycle - State->CycleCounter);
+      if (((8192 - ChannelRoutineCount) & 017777) < Limit)
+	Limit = ((8192 - ChannelRoutineCount) & 017777);
+      if (Ahead >= Limit)
+	{
+	  IdleAdvance (State, K, Limit);
+	  IdleRestore (State, &Loop->Cycles[(K + Limit) % Length]);
+	  return (Done + Limit);
+	}
+      IdleAdvance (State, K, Ahead);
+      K = (K + Ahead) % Length;
+      Done += Ahead;
+
+      // Run the tick cycle for real.
+      IdleRestore (State, &Loop->Cycles[K]);
+      IdleSeen = 0;
+      EngineCycle (State);
+      Done++;
+      if (IdleSeen & IDLE_SEEN_TICK)
+	{
+	  // Counter updates took the cycle, and maybe a few more; the loop
+	  // then carries on where it was.
+	  while (State->ExtraDelay)
+	    {
+	      if (Done >= Cycles || State->CycleCounter >= StopCycle)
+		return (Done);
+	      EngineCycle (State);
+	      Done++;
+	    }
+	}
+      else
+	K = (K + 1) % Length;
+      if (Done >= Cycles || !IdleQuiet (State) || State->OutputChanged ||
+	  State->IncrementHead != Seen)
+	return (Done);
+      IdleCapture (State, &Now);
+      if (!IdleSameCpu (&Now, &Loop->Cycles[K]))
+	{
+	  Loop->Valid = 0;
+	  return (Done);
+	}
+    }
+}
+
+// Called by agc_engine_run when IdleLoop.NextCheck is due.  Records the loop
+// the CPU is in, or fast-forwards through it if it has been recorded already.
+// Returns the number of cycles done.
+static int
+IdleLoopStep (agc_t * State, int Cycles, uint64_t StopCycle, unsigned Seen)
+{
+  IdleLoop_t *Loop = &State->IdleLoop;
+  IdleCycle_t Now;
+  int k, n;
+
+  if (Loop->Backoff == 0)
+    Loop->Backoff = IDLE_MIN_BACKOFF;
+  if (Loop->Recording && IdleRecordCycle (State))
+    return (1);
+  if (Loop->Recording || Loop->NextCheck > State->CycleCounter)
+    {
+      EngineCycle (State);
+      return (1);
+    }
+
+  // Only start at an instruction boundary, and with nothing else going on.
+  if (State->PendFlag || State->ExtraDelay)
+    {
+      EngineCycle (State);
+      return (1);
+    }
+  if (!IdleQuiet (State))
+    {
+      IdleWait (State);
+      EngineCycle (State);
+      return (1);
+    }
+
+  if (Loop->Valid && IdleMemoryMatches (State, Loop))
+    {
+      IdleCapture (State, &Now);
+      for (k = 0; k < Loop->Length; k++)
+	if (IdleSameCpu (&Now, &Loop->Cycles[k]))
+	  {
+	    n = IdleFastForward (State, k, Cycles, StopCycle, Seen);
+	    if (n > 0)
+	      {
+		Loop->Backoff = IDLE_MIN_BACKOFF;
+		return (n);
+	      }
+	    EngineCycle (State);
+	    return (1);
+	  }
+    }
+
+  // Start recording from here.
+  Loop->Valid = 0;
+  Loop->Recording = 1;
+  Loop->Length = 0;
+  Loop->TickCycles = 0;
+  memcpy (Loop->Erasable, State->Erasable, sizeof (Loop->Erasable));
+  memcpy (Loop->InputChannel, State->InputChannel, sizeof (Loop->InputChannel));
+  IdleRecordCycle (State);
+  return (1);
+}
+
+//-----------------------------------------------------------------------------
+// Execute up to Cycles machine cycles, making queued counter increments at
+// the cycle boundaries they are due, and fast-forwarding through the idle
+// loop if State->IdleFastForward is set.  Returns early, after the cycle that
+// did it, if the CPU changes an output channel.  Returns the number of cycles
+// executed.
+//
+// Batching by itself saves only the call overhead per cycle, which agc_bench
+// can't tell apart from noise; the speedup comes from the idle fast-forward.
+
+int
+agc_engine_run (agc_t * State, int Cycles)
+{
+  uint64_t NextIncrement = ~(uint64_t) 0;
+  unsigned Seen = State->IncrementTail;
+  int n;
+  State->OutputChanged = 0;
+  for (n = 0; n < Cycles;)
+    {
+      if (State->CycleCounter >= NextIncrement || State->IncrementHead != Seen)
+	NextIncrement = DeliverIncrements (State, &Seen);
+      if (State->IdleFastForward &&
+	  State->CycleCounter >= State->IdleLoop.NextCheck)
+	n += IdleLoopStep (State, Cycles - n, NextIncrement, Seen);
+      else
+	{
+	  EngineCycle (State);
+	  n++;
+	}
+      if (State->OutputChanged)
+	break;
+    }
+  return (n);
+}
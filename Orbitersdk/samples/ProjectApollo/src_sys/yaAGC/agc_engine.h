@@ -108,6 +108,7 @@ extern "C" {
 typedef short int16_t;
 typedef signed char int8_t;
 typedef int int32_t;
+typedef unsigned int uint32_t;
 typedef unsigned __int64 uint64_t;
 typedef __int64 int64_t;
 #ifdef __MINGW32__
@@ -228,6 +229,13 @@ extern long random (void);
 
 #define NUM_INTERRUPT_TYPES 10
 
+// Size of the counter-increment queue feeding agc_engine_run.  Must be a
+// power of 2.
+#define INCREMENT_QUEUE_SIZE 1024
+
+// Longest idle loop, in machine cycles, that agc_engine_run will recognise.
+#define MAX_IDLE_LOOP 128
+
 // Max number of 15-bit words in a downlink-telemetry list.
 #define MAX_DOWNLINK_LIST 260
 
@@ -279,6 +287,63 @@ typedef struct {
   FieldSpec_t FieldSpecs[MAX_DOWNLINK_LIST];
 } DownlinkListSpec_t;
 
+// A counter increment (PINC, MINC, ...) queued by a peripheral for delivery
+// by agc_engine_run.  Count increments are made at the start of the machine
+// cycle at which CycleCounter reaches Cycle, or at the next cycle boundary
+// if that has already passed.  Besides the UnprogrammedIncrement types there
+// is INC_CDU_SET, for simulated IMUs that time the CDU pulses themselves: it
+// sets a CDU counter to Count, where the PCDUs/MCDUs up to that cycle would
+// have left it, bypassing the CDU FIFOs.  Unlike a run of PCDUs or MCDUs it
+// can't leave the counter off for good if an event is lost or overtaken.
+#define INC_PINC 0
+#define INC_PCDU 1
+#define INC_MINC 2
+#define INC_MCDU 3
+#define INC_DINC 4
+#define INC_SHINC 5
+#define INC_SHANC 6
+#define INC_CDU_SET 040
+typedef struct {
+  uint64_t Cycle;
+  int Counter;
+  int IncType;
+  int Count;
+} IncrementEvent_t;
+
+// The executive's idle loop (DUMMYJOB, or the self-check that runs in its
+// place) touches nothing but the CPU registers while it waits for the next
+// interrupt.  agc_engine_run records one pass around such a loop, cycle by
+// cycle, and from then on can skip the loop forward to the next scaler tick,
+// only running the cycles that update timers for real.  IdleCycle_t is the
+// CPU state at the start of one machine cycle of the loop.
+typedef struct {
+  int16_t Regs[8];		// A, L, Q, EB, FB, Z, BB, ZERO.
+  int16_t Channel7, OutputChannel7;
+  int16_t IndexValue;
+  int NextZ;
+  unsigned char ExtraCode, AllowInterrupt, SubstituteInstruction;
+  unsigned char PendFlag, PendDelay, ExtraDelay;
+  unsigned short Seen;		// IDLE_SEEN_xxx side effects of the cycle.
+  unsigned char ToTick;		// Cycles to the next one that can take a tick.
+} IdleCycle_t;
+
+typedef struct {
+  int Valid;			// Cycles[] holds a complete loop.
+  int Recording;		// Cycles[] is being filled in.
+  int Length;			// Loop length in machine cycles.
+  int TickCycles;		// While recording, cycles left in a tick stall.
+  int Backoff;			// Cycles to wait after a failed attempt.
+  uint64_t NextCheck;		// CycleCounter at which to look again.
+  uint64_t Skipped;		// Total cycles fast-forwarded.
+  IdleCycle_t Cycles[MAX_IDLE_LOOP];
+  // Running totals over Cycles[0..n-1] of the cycles that can take a tick
+  // and of the IDLE_SEEN_NEWJOB, _NONISR, _TC and _NONTC side effects.
+  int16_t Totals[5][MAX_IDLE_LOOP + 1];
+  // Memory and i/o channels the loop was recorded with.
+  int16_t Erasable[8][0400];
+  int16_t InputChannel[NUM_CHANNELS];
+} IdleLoop_t;
+
 //--------------------------------------------------------------------------
 // Each instance of the AGC CPU simulation has a data structure of type agc_t
 // that contains the CPU's internal states, the complete memory space, and any
@@ -330,6 +395,20 @@ typedef struct
   // integration squad wants.  The Virtual AGC code proper doesn't use it
   // in any way.
   void *agc_clientdata;
+  // Single-producer/single-consumer queue of counter increments.  The
+  // peripheral side only advances IncrementHead (agc_engine_queue_increment),
+  // the CPU side only advances IncrementTail (agc_engine_run), so no lock
+  // is needed between them.
+  IncrementEvent_t IncrementQueue[INCREMENT_QUEUE_SIZE];
+  volatile unsigned IncrementHead;
+  volatile unsigned IncrementTail;
+  // Set by CpuWriteIO when an output channel changes value.
+  int OutputChanged;
+  // Non-zero to let agc_engine_run fast-forward through the idle loop.  The
+  // cycles skipped don't call ChannelInput, so this is only for hosts where
+  // that does nothing.
+  int IdleFastForward;
+  IdleLoop_t IdleLoop;
 #ifdef _DEBUG
   FILE *out_file;
 #endif
@@ -356,6 +435,10 @@ extern int NumDebugRules;
 extern DebugRule_t DebugRules[MAX_DEBUG_RULES];
 #endif
 
+// Instruction-mix statistics (see agc_engine.c).
+extern int OpcodeStatistics;
+extern uint64_t OpcodeCounts[0200];
+
 // Stuff for --debug mode.
 #define MAX_BACKTRACE_POINTS 100
 #define BACKTRACES_PER_LINE 5
@@ -660,9 +743,14 @@ void DumpFiles (const char *Pattern);
 char *nbfgets (char *Buffer, int Length);
 void nbfgets_ready (const char *);
 int agc_engine (agc_t * State);
+int agc_engine_run (agc_t * State, int Cycles);
+int agc_engine_queue_increment (agc_t * State, int Counter, int IncType,
+				int Count, uint64_t Cycle);
 int agc_engine_init (agc_t * State, const char *RomImage,
 		     const char *CoreDump, int AllOrErasable);
 int agc_load_binfile(agc_t *State, const char *RomImage);
+#define AGC_BINFILE_LOADED 5	// agc_load_binfile's return once the rope is in
+void agc_engine_reset_timers (void);
 int ReadIO (agc_t * State, int Address);
 void WriteIO (agc_t * State, int Address, int Value);
 void CpuWriteIO (agc_t * State, int Address, int Value);
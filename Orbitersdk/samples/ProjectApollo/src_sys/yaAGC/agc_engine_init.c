@@ -75,6 +75,10 @@ FILE *rfopen (const char *Filename, const char *mode);
 //      4 -- agc_t structure not allocated.
 //      5 -- File-read error.
 //      6 -- Core-dump file not found.
+// agc_load_binfile has always returned 5 (AGC_BINFILE_LOADED) once it gets
+// as far as reading the image, and callers check for that.  The file size
+// has been checked by then, so a short read there would need the file to
+// change under us.
 // Normally, on input the CoreDump filename is NULL, in which case all of the 
 // i/o channels, erasable memory, etc., are cleared to their reset values.
 // When the CoreDump is loaded instead, it allows execution to continue precisely
@@ -147,6 +151,8 @@ agc_load_binfile(agc_t *State, const char *RomImage)
 	    Bank++;
 	}
     }
+  // A new rope invalidates any recorded idle loop.
+  State->IdleLoop.Valid = State->IdleLoop.Recording = 0;
 
 Done:
   if (fp != NULL)
@@ -0,0 +1,371 @@
+/*
+  This file is part of Project Apollo - NASSP.
+
+  Project Apollo is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  Project Apollo is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Project Apollo; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+  Filename:	agc_wakeup.cpp
+  Purpose:	Headless version of the multithreaded AGC.  A frame loop
+		hands each timestep to an AGC thread the same way
+		CSMcomputer::Timestep and CSMcomputer::Run do, through
+		thread.h, and the frame-to-AGC wakeup latency is reported
+		with and without spinning before the AGC thread sleeps.
+
+		With --pipeline it checks the pipelined timestep instead.
+		Each frame the AGC runs while a stand-in for the systems
+		timestep keys V35E and V16N36E into the DSKY, reads and
+		writes input channels, raises DOWNRUPTs and queues PIPA
+		increments, all through AGCInputQueue as ApolloGuidance
+		does.  This is done once with the AGC on its own thread
+		(AGC_PIPELINE_ON) and once with it run after the systems on
+		the main thread (AGC_PIPELINE_SERIAL), and the output
+		channel traces of the two runs must be the same.
+  Compiler:	GNU g++, or MSVC.
+  Usage:	agc_wakeup [options] rope.bin
+
+		--frames=N	Frames per run (default 600).
+		--fps=N		Frame rate (default 60).
+		--accel=N	Time acceleration (default 10).
+		--spin=N	Spin time in microseconds for the second
+				run (default 200).  The first run never spins.
+		--pipeline	Check the pipelined timestep, see above.
+*/
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1300 ) // Microsoft Visual Studio Version 2003 and higher
+#define _CRT_SECURE_NO_DEPRECATE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "agc_engine.h"
+#include "../thread.h"
+#include "../agcinput.h"
+
+// Output channel writes, as cycle, channel and value, while a run records them
+static std::vector<uint64_t> *Trace = NULL;
+
+//----------------------------------------------------------------------------
+// Peripheral hooks expected by agc_engine, as in agc_bench.c.
+
+extern "C" {
+
+void
+ChannelOutput (agc_t * State, int Channel, int Value)
+{
+  if (Channel == 7)
+    State->InputChannel[7] = State->OutputChannel7 = (Value & 0160);
+  else if (Trace != NULL)
+    {
+      Trace->push_back (State->CycleCounter);
+      Trace->push_back (Channel);
+      Trace->push_back (Value);
+    }
+}
+
+int
+ChannelInput (agc_t * State)
+{
+  return (0);
+}
+
+void
+ChannelRoutine (agc_t * State)
+{
+}
+
+void
+ShiftToDeda (agc_t * State, int Data)
+{
+}
+
+#ifndef WIN32
+void
+UnblockSocket (int SocketNum)
+{
+}
+#endif
+
+}
+
+//----------------------------------------------------------------------------
+// The AGC thread.  Run() is CSMcomputer::Run, plus a way out.
+
+class AGCThread : public Runnable
+{
+public:
+  AGCThread () : quit (false), simdt (0), cycles (0), pipelined (false), residual (0)
+  {
+    memset (&vagc, 0, sizeof (vagc));
+  }
+
+  void Start () { thread.Resume (); }
+
+  // One timestep of simdt, with agcCycleMutex held
+  void Timestep ()
+  {
+    residual += simdt * AGC_PER_SECOND;
+    int n = (int) residual;
+    residual -= n;
+    // agc_engine_run stops early on output channel changes
+    while (n > 0)
+      {
+	int done = agc_engine_run (&vagc, n);
+	n -= done;
+	cycles += done;
+      }
+  }
+
+  agc_t vagc;
+  Mutex agcCycleMutex;
+  Mutex agcQueueMutex;
+  Event timeStepEvent;
+  Event done;			// Raised after each timestep when pipelined
+  volatile bool quit;
+  double simdt;
+  unsigned long long cycles;
+  bool pipelined;
+
+protected:
+  void Run ()
+  {
+    while (true)
+      {
+	timeStepEvent.Wait ();
+	Lock lock (agcCycleMutex);
+	if (quit)
+	  break;
+	Timestep ();
+	if (pipelined)
+	  done.Raise ();
+      }
+  }
+
+  double residual;
+};
+
+static double
+Now (void)
+{
+  return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+static int
+RunFrames (const char *RomImage, int Frames, int Fps, double Accel, double Spin)
+{
+  AGCThread agc;
+  EventStats s;
+  double Start, Wall;
+  int i;
+
+  agc_engine_init (&agc.vagc, NULL, NULL, 0);
+  if (AGC_BINFILE_LOADED != (i = agc_load_binfile (&agc.vagc, RomImage)))
+    {
+      fprintf (stderr, "Cannot load rope \"%s\" (error %d).\n", RomImage, i);
+      return (1);
+    }
+  agc.vagc.InputChannel[030] = 037777;
+  agc.vagc.InputChannel[031] = 057777;
+  agc.vagc.InputChannel[032] = 077777;
+  agc.vagc.InputChannel[033] = 057777;
+  agc.timeStepEvent.SetSpin (Spin);
+  agc.Start ();
+
+  std::chrono::steady_clock::time_point Frame = std::chrono::steady_clock::now ();
+  std::chrono::nanoseconds Period (1000000000LL / Fps);
+  Start = Now ();
+  for (i = 0; i < Frames; i++)
+    {
+      Frame += Period;
+      std::this_thread::sleep_until (Frame);
+      Lock lock (agc.agcCycleMutex);
+      agc.simdt = Accel / Fps;
+      agc.timeStepEvent.Raise ();
+    }
+  {
+    Lock lock (agc.agcCycleMutex);
+    agc.quit = true;
+    agc.timeStepEvent.Raise ();
+  }
+  agc.Kill ();
+  Wall = Now () - Start;
+
+  agc.timeStepEvent.GetStats (s);
+  printf ("spin %4.0f us: %lu wakeups (%lu spinning), latency avg %7.1f us max %7.1f us, "
+	  "AGC %.2f of %.2f s in %.2f s\n", Spin * 1e6, s.wakeups, s.spun,
+	  s.wakeups ? s.total / s.wakeups * 1e6 : 0.0, s.max * 1e6,
+	  (double) agc.cycles / AGC_PER_SECOND, Frames * Accel / Fps, Wall);
+  return (0);
+}
+
+//----------------------------------------------------------------------------
+// The pipeline check.  Systems() stands in for the systems timestep: it only
+// gets at the AGC through the input queue, as ApolloGuidance does between
+// PipelineHandoff and FinishTimestep.
+
+static void
+Systems (AGCInputQueue &Input, int Frame, double Time, double Simdt)
+{
+  static const char Keys[] = "V35E      V16N36E";
+  static const int Codes[] = { 021, 034, 037, 003, 006, 001 };
+  static const char Names[] = "VEN361";
+  int k = (int) (Time - 5.0) * 2, i;
+
+  // A key every half second from 5 s, as the DSKY would pass them on
+  if (Time >= 5.0 && k >= 0 && k < (int) sizeof (Keys) - 1
+      && (int) ((Time - Simdt - 5.0) * 2) != k && Keys[k] != ' ')
+    for (i = 0; Names[i]; i++)
+      if (Names[i] == Keys[k])
+	{
+	  Input.WriteChannel (015, Codes[i]);
+	  Input.Interrupt (5);
+	}
+
+  // Flip an unused channel 30 bit now and then, from what the systems see
+  if (Frame % 50 == 25)
+    Input.WriteChannel (030, Input.GetChannel (030) ^ 000002);
+
+  // Telemetry and PIPA pulses, spread over the next run
+  Input.Interrupt (8);
+  Input.Increment (037, INC_PINC, 1 + Frame % 5, 0);
+  Input.Increment (040, INC_MINC, 1 + Frame % 3, (uint64_t) (Simdt * AGC_PER_SECOND / 2));
+
+  // Make the thread timing differ from frame to frame
+  std::this_thread::sleep_for (std::chrono::microseconds ((Frame * 7919) % 400));
+}
+
+static int
+RunPipeline (const char *RomImage, int Frames, int Fps, double Accel, bool Threaded, std::vector<uint64_t> &Out)
+{
+  AGCThread agc;
+  AGCInputQueue Input;
+  int i;
+
+  agc_engine_init (&agc.vagc, NULL, NULL, 0);
+  agc_engine_reset_timers ();
+  if (AGC_BINFILE_LOADED != (i = agc_load_binfile (&agc.vagc, RomImage)))
+    {
+      fprintf (stderr, "Cannot load rope \"%s\" (error %d).\n", RomImage, i);
+      return (1);
+    }
+  agc.vagc.InputChannel[030] = 037777;
+  agc.vagc.InputChannel[031] = 057777;
+  agc.vagc.InputChannel[032] = 077777;
+  agc.vagc.InputChannel[033] = 057777;
+  agc.pipelined = true;
+  agc.simdt = Accel / Fps;
+  if (Threaded)
+    agc.Start ();
+
+  Out.clear ();
+  Trace = &Out;
+  for (i = 0; i < Frames; i++)
+    {
+      // PipelineHandoff
+      {
+	Lock lock (agc.agcCycleMutex);
+	Input.Begin (&agc.vagc, false);
+	if (Threaded)
+	  agc.timeStepEvent.Raise ();
+      }
+      Systems (Input, i, i * agc.simdt, agc.simdt);
+      // FinishTimestep
+      if (Threaded)
+	agc.done.Wait ();
+      else
+	{
+	  Lock lock (agc.agcCycleMutex);
+	  agc.Timestep ();
+	}
+      Lock lock (agc.agcCycleMutex);
+      Lock queueLock (agc.agcQueueMutex);
+      Input.Apply (&agc.vagc);
+    }
+  if (Threaded)
+    {
+      {
+	Lock lock (agc.agcCycleMutex);
+	agc.quit = true;
+	agc.timeStepEvent.Raise ();
+      }
+      agc.Kill ();
+    }
+  Trace = NULL;
+  return (0);
+}
+
+static int
+CheckPipeline (const char *RomImage, int Frames, int Fps, double Accel)
+{
+  std::vector<uint64_t> Threaded, Serial;
+  size_t i;
+
+  if (RunPipeline (RomImage, Frames, Fps, Accel, true, Threaded)
+      || RunPipeline (RomImage, Frames, Fps, Accel, false, Serial))
+    return (1);
+  for (i = 0; i < Threaded.size () && i < Serial.size (); i += 3)
+    if (Threaded[i] != Serial[i] || Threaded[i + 1] != Serial[i + 1] || Threaded[i + 2] != Serial[i + 2])
+      break;
+  if (i < Threaded.size () || i < Serial.size ())
+    {
+      printf ("pipeline: channel traces differ at write %lu of %lu/%lu\n", (unsigned long) (i / 3),
+	      (unsigned long) (Threaded.size () / 3), (unsigned long) (Serial.size () / 3));
+      return (1);
+    }
+  printf ("pipeline: threaded and serial channel traces match, %lu writes in %d frames\n",
+	  (unsigned long) (Threaded.size () / 3), Frames);
+  return (0);
+}
+
+int
+main (int argc, char *argv[])
+{
+  int Frames = 600, Fps = 60, i;
+  double Accel = 10, Spin = 200;
+  bool Pipeline = false;
+  const char *Rope = NULL;
+
+  for (i = 1; i < argc; i++)
+    {
+      if (1 == sscanf (argv[i], "--frames=%d", &Frames))
+	;
+      else if (1 == sscanf (argv[i], "--fps=%d", &Fps))
+	;
+      else if (1 == sscanf (argv[i], "--accel=%lf", &Accel))
+	;
+      else if (1 == sscanf (argv[i], "--spin=%lf", &Spin))
+	;
+      else if (!strcmp (argv[i], "--pipeline"))
+	Pipeline = true;
+      else if (argv[i][0] == '-')
+	{
+	  fprintf (stderr, "Unknown option \"%s\".\n", argv[i]);
+	  return (1);
+	}
+      else
+	Rope = argv[i];
+    }
+  if (Rope == NULL || Frames < 1 || Fps < 1)
+    {
+      fprintf (stderr, "Usage: agc_wakeup [--frames=N] [--fps=N] [--accel=N] [--spin=us] [--pipeline] rope.bin\n");
+      return (1);
+    }
+
+  if (Pipeline)
+    return (CheckPipeline (Rope, Frames, Fps, Accel));
+
+  if (RunFrames (Rope, Frames, Fps, Accel, 0.0))
+    return (1);
+  return (RunFrames (Rope, Frames, Fps, Accel, Spin * 1e-6));
+}